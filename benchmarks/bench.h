@@ -0,0 +1,67 @@
+#ifndef RMS_BENCH_H
+#define RMS_BENCH_H
+
+// tiny benchmark harness : every bench_*.cpp registers its cases with RMS_BENCH
+// and `rms_bench [filter]` runs the cases whose name contains the filter
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+struct BenchCase
+{
+    std::string name;
+    std::function<void()> run;
+};
+
+inline std::vector<BenchCase> &benchRegistry()
+{
+    static std::vector<BenchCase> cases;
+    return cases;
+}
+
+struct BenchRegistrar
+{
+    BenchRegistrar(const char *name, std::function<void()> fn)
+    {
+        benchRegistry().push_back({name, std::move(fn)});
+    }
+};
+
+#define RMS_BENCH(name)                                         \
+    static void name();                                         \
+    static BenchRegistrar name##_registrar(#name, name);        \
+    static void name()
+
+class BenchTimer
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    void reset() { start = std::chrono::steady_clock::now(); }
+    double elapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// "<label>  <ops> ops in <ms> ms  (<rate> ops/s)"
+inline void reportRate(const std::string &label, long long ops, double ms)
+{
+    double rate = ms > 0 ? ops * 1000.0 / ms : 0;
+    std::cout << "  " << std::left << std::setw(44) << label
+              << std::right << std::setw(12) << ops << " ops in "
+              << std::fixed << std::setprecision(1) << std::setw(9) << ms << " ms  ("
+              << std::setprecision(0) << rate << " ops/s)\n";
+}
+
+inline void reportValue(const std::string &label, double value, const std::string &unit)
+{
+    std::cout << "  " << std::left << std::setw(44) << label
+              << std::right << std::fixed << std::setprecision(2) << std::setw(14) << value << " " << unit << "\n";
+}
+
+#endif // RMS_BENCH_H
@@ -0,0 +1,99 @@
+#include "bench.h"
+#include "AsyncRMSFacade.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <algorithm>
+
+namespace
+{
+    struct AsyncWorld
+    {
+        InMemoryTicketRepository ticketRepo;
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService{&trainRepo};
+        PassengerService passengerService{&passengerRepo};
+        TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+        RMSFacade facade{&trainService, &ticketService, &passengerService};
+        Executor executor;
+        AsyncRMSFacade async{&facade, &trainService, &ticketService, &executor, 64};
+    };
+
+    Task<void> bookOne(AsyncRMSFacade *async, int trainId, std::string name)
+    {
+        co_await async->bookTicket(trainId, std::move(name));
+    }
+}
+
+// 8 trains x 250 seats , 2,000 bookings : the blocking facade vs one coroutine per booking ,
+// inline and through the booking pipeline . everything is awaited on a single thread
+RMS_BENCH(async_facade_bookings)
+{
+    const int trains = 8, seats = 250, bookings = trains * seats;
+
+    {
+        AsyncWorld world;
+        std::vector<int> trainIds;
+        for (int t = 0; t < trains; t++)
+            trainIds.push_back(world.trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+        BenchTimer timer;
+        for (int i = 0; i < bookings; i++)
+            world.facade.bookTicket(trainIds[i % trains], "P" + std::to_string(i));
+        reportRate("blocking facade", bookings, timer.elapsedMs());
+    }
+
+    for (bool pipeline : {false, true})
+    {
+        AsyncWorld world;
+        if (pipeline)
+            world.facade.enableAsyncBooking();
+        std::vector<int> trainIds;
+        for (int t = 0; t < trains; t++)
+            trainIds.push_back(world.trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+        BenchTimer timer;
+        for (int i = 0; i < bookings; i++)
+            world.executor.spawn(bookOne(&world.async, trainIds[i % trains], "P" + std::to_string(i)));
+        world.executor.run();
+        reportRate(pipeline ? "coroutines , pipeline" : "coroutines , inline", bookings, timer.elapsedMs());
+        reportValue("  resumptions", world.executor.getResumeCount(), "");
+    }
+}
+
+// worst pause seen by a ticking coroutine while another one lists 20,000 trains
+RMS_BENCH(async_facade_listing_latency)
+{
+    for (int chunk : {64, 1024, 1 << 20})
+    {
+        AsyncWorld world;
+        AsyncRMSFacade async(&world.facade, &world.trainService, &world.ticketService, &world.executor, chunk);
+        for (int t = 0; t < 20000; t++)
+            world.trainService.createTrain("T" + std::to_string(t), 4);
+
+        bool done = false;
+        double worstGapMs = 0;
+        auto ticker = [](Executor *ex, bool *finished, double *worst) -> Task<void> {
+            BenchTimer gap;
+            while (!*finished)
+            {
+                gap.reset();
+                co_await ex->yield();
+                *worst = std::max(*worst, gap.elapsedMs());
+            }
+        };
+        auto lister = [](AsyncRMSFacade *a, bool *finished) -> Task<void> {
+            co_await a->listTrains();
+            *finished = true;
+        };
+        BenchTimer timer;
+        world.executor.spawn(ticker(&world.executor, &done, &worstGapMs));
+        world.executor.spawn(lister(&async, &done));
+        world.executor.run();
+        std::string label = chunk == (1 << 20) ? "one page" : "pages of " + std::to_string(chunk);
+        reportValue(label + " , total", timer.elapsedMs(), "ms");
+        reportValue(label + " , worst ticker pause", worstGapMs, "ms");
+    }
+}
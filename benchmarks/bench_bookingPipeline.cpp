@@ -0,0 +1,76 @@
+#include "bench.h"
+#include "Services/BookingPipeline.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+// 32 trains x 250 seats , 8,000 bookings submitted in one burst :
+// synchronous bookTicket vs the pipeline at different batch sizes .
+// every booking loads and saves a full train copy , batching pays that once per batch
+RMS_BENCH(booking_pipeline_batching)
+{
+    const int trains = 32, seats = 250, bookings = trains * seats;
+
+    auto setup = [&](TrainService &trainService, PassengerService &passengerService,
+                     std::vector<int> &trainIds, std::vector<int> &passengers)
+    {
+        for (int t = 0; t < trains; t++)
+            trainIds.push_back(trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+        for (int p = 0; p < seats; p++)
+            passengers.push_back(passengerService.createPassenger("P" + std::to_string(p)).getId());
+    };
+
+    {
+        InMemoryTicketRepository ticketRepo;
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        std::vector<int> trainIds, passengers;
+        setup(trainService, passengerService, trainIds, passengers);
+
+        BenchTimer timer;
+        for (int i = 0; i < bookings; i++)
+            ticketService.bookTicket(trainIds[i % trains], passengers[i / trains]);
+        reportRate("synchronous bookTicket", bookings, timer.elapsedMs());
+    }
+
+    for (int batch : {1, 8, 32, 128})
+    {
+        InMemoryTicketRepository ticketRepo;
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        std::vector<int> trainIds, passengers;
+        setup(trainService, passengerService, trainIds, passengers);
+
+        BookingPipelineOptions options;
+        options.workers = 4;
+        options.maxBatchSize = batch;
+        options.maxBatchDelayMs = 2;
+        BookingPipeline pipeline(&ticketService, options);
+
+        BenchTimer timer;
+        for (int i = 0; i < bookings; i++)
+        {
+            BookingRequest r;
+            r.trainId = trainIds[i % trains];
+            r.passengerId = passengers[i / trains];
+            pipeline.submit(r, nullptr);
+        }
+        pipeline.shutdown();
+        double ms = timer.elapsedMs();
+
+        BookingPipelineStats stats = pipeline.getStats();
+        reportRate("pipeline , batch " + std::to_string(batch), stats.completed, ms);
+        reportValue("  batches", stats.batches, "");
+        reportValue("  average batch fill", stats.averageBatchFill * 100, "%");
+        reportValue("  max queue depth", stats.maxQueueDepth, "requests");
+    }
+}
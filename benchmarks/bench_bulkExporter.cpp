@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "Services/BulkExporter.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+// 1M tickets (10M do not fit the in-memory repositories on this machine) exported to a file and
+// to /dev/null , against the `ticket list` way : copy everything into a vector , then one
+// formatted line and one flush per ticket . /dev/null shows what the formatting alone costs
+RMS_BENCH(bulk_export)
+{
+    const int trains = 10000, seats = 100, passengers = 10000;
+    const int tickets = 1000000;
+    const std::string path = "/tmp/rms_bench_export_" + std::to_string(getpid());
+
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    for (int t = 0; t < trains; t++)
+    {
+        Train train(0, "T" + std::to_string(t), seats);
+        trainRepo.save(train);
+    }
+    std::vector<Passenger> riders;
+    for (int p = 0; p < passengers; p++)
+    {
+        Passenger passenger(0, "Passenger " + std::to_string(p));
+        passengerRepo.save(passenger);
+        riders.push_back(passenger);
+    }
+    for (int from = 0; from < tickets; from += 65536)
+    {
+        vector<Ticket> batch;
+        for (int i = from; i < std::min(tickets, from + 65536); i++)
+            batch.push_back(Ticket(0, i / trains % seats + 1, i % trains + 1, riders[i % passengers]));
+        ticketRepo.saveAll(batch);
+    }
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+    BulkExporter exporter(&trainService, &ticketService);
+
+    {
+        BenchTimer timer;
+        std::ofstream out(path + ".list");
+        for (const auto &ticket : ticketService.getAllTickets())
+            out << ticket.getId() << " " << ticket.getTrainId() << " " << ticket.getSeat() << " "
+                << ticket.getPassenger().getId() << " " << ticket.getPassenger().getName() << " "
+                << (ticket.getStatus() == booked ? "Booked" : "Cancelled") << std::endl;
+        reportRate("copy + endl per ticket (file)", tickets, timer.elapsedMs());
+        std::remove((path + ".list").c_str());
+    }
+
+    struct Case
+    {
+        const char *label;
+        ExportFormat format;
+        const char *extension;
+    };
+    for (const Case &c : {Case{"csv", ExportFormat::Csv, ".csv"}, Case{"jsonl", ExportFormat::JsonLines, ".jsonl"},
+                          Case{"binary", ExportFormat::Binary, ".bin"}})
+    {
+        ExportReport report = exporter.exportFile(c.format, "/dev/null");
+        reportRate(std::string("export ") + c.label + " (/dev/null)", report.records, report.ms);
+        report = exporter.exportFile(c.format, path + c.extension);
+        reportRate(std::string("export ") + c.label + " (file)", report.records, report.ms);
+        reportValue("  written", report.bytes / 1048576.0 / (report.ms / 1000), "MB/s");
+        std::remove((path + c.extension).c_str());
+    }
+
+    ExportOptions manifest;
+    manifest.manifest = true;
+    ExportReport report = exporter.exportFile(ExportFormat::Csv, "/dev/null", manifest);
+    reportRate("manifest csv , every train (/dev/null)", report.records, report.ms);
+}
@@ -0,0 +1,63 @@
+#include "bench.h"
+#include "Services/BulkImporter.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "RMSFacade.h"
+#include <sstream>
+
+// records per second of the bulk importer against the same records added one call at a time
+// through the facade , which parses nothing but copies every record in and out
+RMS_BENCH(bulk_import)
+{
+    const int passengers = 200000, trains = 2000, seats = 100;
+    const int tickets = trains * seats;
+
+    std::string passengerCsv = "name\n", trainJson, ticketCsv = "train_id,passenger_id,date\n";
+    for (int p = 0; p < passengers; p++)
+        passengerCsv += "Passenger " + std::to_string(p) + "\n";
+    for (int t = 0; t < trains; t++)
+        trainJson += "{\"name\": \"Train " + std::to_string(t) + "\", \"seats\": " + std::to_string(seats) + "}\n";
+    for (int i = 0; i < tickets; i++)
+        ticketCsv += std::to_string(i % trains + 1) + "," + std::to_string(i % passengers + 1) + ",\n";
+
+    {
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        InMemoryTicketRepository ticketRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        RMSFacade facade(&trainService, &ticketService, &passengerService);
+        BenchTimer timer;
+        for (int p = 0; p < passengers; p++)
+            facade.addPassenger("Passenger " + std::to_string(p));
+        reportRate("facade addPassenger", passengers, timer.elapsedMs());
+        timer.reset();
+        for (int t = 0; t < trains; t++)
+            facade.addTrain("Train " + std::to_string(t), seats);
+        reportRate("facade addTrain", trains, timer.elapsedMs());
+        timer.reset();
+        for (int i = 0; i < tickets; i++)
+            ticketService.bookTicket(i % trains + 1, i % passengers + 1);
+        reportRate("service bookTicket", tickets, timer.elapsedMs());
+    }
+
+    WorkStealingPool pool;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    InMemoryTicketRepository ticketRepo;
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+    BulkImporter importer(&trainService, &passengerService, &ticketService, &pool);
+
+    std::istringstream passengerIn(passengerCsv), trainIn(trainJson), ticketIn(ticketCsv);
+    ImportReport report = importer.importStream(ImportKind::Passengers, ImportFormat::Csv, passengerIn);
+    reportRate("import passengers (csv)", report.records, report.ms);
+    report = importer.importStream(ImportKind::Trains, ImportFormat::JsonLines, trainIn);
+    reportRate("import trains (jsonl)", report.records, report.ms);
+    report = importer.importStream(ImportKind::Tickets, ImportFormat::Csv, ticketIn);
+    reportRate("import tickets (csv)", report.records, report.ms);
+    reportValue("  tickets rejected", (double)report.rejected, "");
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/SqliteTicketRepository.h"
+#include "Repo/SqliteTrainRepository.h"
+#include "Repo/SqlitePassengerRepository.h"
+#include "Repo/CachedTicketRepository.h"
+#include "Repo/CachedTrainRepository.h"
+#include "Repo/CachedPassengerRepository.h"
+#include <cstdio>
+#include <memory>
+#include <unistd.h>
+
+// SQLite repositories with and without the write-behind cache in front : train lookups (the
+// booking path reads the train for every seat) , bookings through the services and repeated
+// status flips of the same tickets , which the cache folds into one write per flush
+RMS_BENCH(cached_repository)
+{
+    const int trains = 200, seats = 50, passengers = 2000;
+    const int bookings = trains * seats, lookups = 200000, flips = 50000;
+    const std::string path = "/tmp/rms_bench_cache_" + std::to_string(getpid()) + ".db";
+
+    for (bool cached : {false, true})
+    {
+        for (const char *suffix : {"", "-wal", "-shm"})
+            std::remove((path + suffix).c_str());
+        auto database = std::make_unique<SqliteDatabase>(path);
+        std::unique_ptr<ITrainRepository> trainRepo = std::make_unique<SqliteTrainRepository>(database.get());
+        std::unique_ptr<ITicketRepository> ticketRepo = std::make_unique<SqliteTicketRepository>(database.get());
+        std::unique_ptr<IPassengerRepository> passengerRepo = std::make_unique<SqlitePassengerRepository>(database.get());
+        CachedTrainRepository *cache = nullptr;
+        if (cached)
+        {
+            auto wrapped = std::make_unique<CachedTrainRepository>(std::move(trainRepo));
+            cache = wrapped.get();
+            trainRepo = std::move(wrapped);
+            ticketRepo = std::make_unique<CachedTicketRepository>(std::move(ticketRepo));
+            passengerRepo = std::make_unique<CachedPassengerRepository>(std::move(passengerRepo));
+        }
+        {
+            TrainService trainService(trainRepo.get());
+            PassengerService passengerService(passengerRepo.get());
+            TicketService ticketService(ticketRepo.get(), &trainService, &passengerService);
+            const std::string backend = cached ? "sqlite + cache" : "sqlite";
+
+            for (int t = 0; t < trains; t++)
+                trainService.createTrain("T" + std::to_string(t), seats);
+            for (int p = 0; p < passengers; p++)
+                passengerService.createPassenger("Passenger " + std::to_string(p));
+
+            BenchTimer timer;
+            int found = 0;
+            for (int i = 0; i < lookups; i++)
+                found += trainRepo->getTrainById(i % trains + 1).has_value();
+            reportRate(backend + " : getTrainById", lookups, timer.elapsedMs());
+
+            timer.reset();
+            for (int i = 0; i < bookings; i++)
+                ticketService.bookTicket(i % trains + 1, i / trains + 1);
+            reportRate(backend + " : book (service)", bookings, timer.elapsedMs());
+
+            timer.reset();
+            for (int i = 0; i < flips; i++)
+            {
+                Ticket ticket = *ticketRepo->getTicketById(i % 100 + 1);
+                ticket.setStatus(i % 2 ? booked : cancelled);
+                ticketRepo->save(ticket);
+            }
+            reportRate(backend + " : ticket status save , 100 hot ids", flips, timer.elapsedMs());
+            if (found == 0)
+                reportValue("  nothing found", 0, "");
+
+            if (cache)
+            {
+                CacheStats stats = cache->getCacheStats();
+                reportValue("  train cache hit ratio", stats.hitRatio() * 100, "%");
+                reportValue("  train saves per write", stats.flushed ? (double)stats.saves / stats.flushed : 0, "");
+                reportValue("  max flush lag", stats.maxFlushLagMs, "ms");
+            }
+        }
+        // the caches flush into the database before it closes
+        passengerRepo.reset();
+        ticketRepo.reset();
+        trainRepo.reset();
+    }
+    for (const char *suffix : {"", "-wal", "-shm"})
+        std::remove((path + suffix).c_str());
+}
@@ -0,0 +1,71 @@
+#include "bench.h"
+#include "Repo/Checkpointer.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <cstdio>
+#include <memory>
+#include <unistd.h>
+
+// a few hot records updated over and over (buffered log) , then a restart : without checkpoints
+// the restart replays every update , with one every 20k updates it replays the checkpoint log
+// (one record per live row) and at most 20k updates of the write-ahead log
+RMS_BENCH(checkpointer)
+{
+    const int rows = 2000, updates = 400000, every = 20000;
+    const std::string path = "/tmp/rms_bench_checkpoint_" + std::to_string(getpid()) + ".log";
+    WalOptions buffered;
+    buffered.durability = Durability::Buffered;
+
+    for (bool checkpoints : {false, true})
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".checkpoint").c_str());
+        const std::string mode = checkpoints ? "checkpoint every 20k" : "log only";
+        {
+            WriteAheadLog wal(path, buffered), checkpointLog(path + ".checkpoint");
+            DurableTrainRepository trains(std::make_unique<InMemoryTrainRepository>(), &wal);
+            DurableTicketRepository tickets(std::make_unique<InMemoryTicketRepository>(), &wal);
+            DurablePassengerRepository passengers(std::make_unique<InMemoryPassengerRepository>(), &wal);
+            CheckpointOptions options;
+            options.intervalMs = 3600000; // by hand below
+            Checkpointer checkpointer(&trains, &tickets, &passengers, &wal, &checkpointLog, options);
+
+            std::vector<Passenger> riders;
+            for (int i = 0; i < rows; i++)
+            {
+                Passenger rider(0, "Passenger " + std::to_string(i));
+                passengers.save(rider);
+                riders.push_back(rider);
+            }
+            BenchTimer timer;
+            double checkpointMs = 0;
+            for (int i = 0; i < updates; i++)
+            {
+                Passenger &rider = riders[i % 50]; // the hot ones
+                rider.setName("Passenger " + std::to_string(i));
+                passengers.save(rider);
+                if (checkpoints && (i + 1) % every == 0)
+                    checkpointMs += checkpointer.checkpoint().lastMs;
+            }
+            wal.sync();
+            reportRate(mode + " : updates , checkpoints included", updates, timer.elapsedMs());
+            if (checkpoints)
+                reportValue("  time in checkpoints", checkpointMs, "ms");
+            CheckpointStats stats = checkpointer.getStats();
+            reportValue("  write-ahead log", stats.walBytes / 1024.0, "KB");
+            reportValue("  checkpoint log", stats.checkpointBytes / 1024.0, "KB");
+        }
+
+        BenchTimer timer;
+        WriteAheadLog wal(path, buffered), checkpointLog(path + ".checkpoint");
+        DurablePassengerRepository passengers(std::make_unique<InMemoryPassengerRepository>(), &wal);
+        size_t replayed = checkpointLog.replay([&](const WalRecord &record) { passengers.apply(record); });
+        replayed += wal.replay([&](const WalRecord &record) { passengers.apply(record); });
+        double ms = timer.elapsedMs();
+        reportRate(mode + " : recovery , records replayed", (long long)replayed, ms);
+        reportValue("  recovery", ms, "ms");
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".checkpoint").c_str());
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <thread>
+#include <mutex>
+
+// booking throughput from 1 to 32 threads : 256 trains x 64 seats , every thread
+// walks the trains from its own offset so the load is spread over all stripes .
+// the "global mutex" row wraps each booking in one lock , the old behaviour
+RMS_BENCH(concurrent_booking_scaling)
+{
+    const int trains = 256, seats = 64;
+    const int bookings = trains * seats;
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for (bool global : {true, false})
+        for (int threads : {1, 2, 4, 8, 16, 32})
+        {
+            InMemoryTicketRepository ticketRepo;
+            InMemoryTrainRepository trainRepo;
+            InMemoryPassengerRepository passengerRepo;
+            TrainService trainService(&trainRepo);
+            PassengerService passengerService(&passengerRepo);
+            TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+
+            std::vector<int> trainIds;
+            for (int t = 0; t < trains; t++)
+                trainIds.push_back(trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+            std::vector<int> passengers;
+            for (int p = 0; p < seats; p++)
+                passengers.push_back(passengerService.createPassenger("P" + std::to_string(p)).getId());
+
+            std::mutex serial;
+            BenchTimer timer;
+            std::vector<std::thread> pool;
+            for (int th = 0; th < threads; th++)
+                pool.emplace_back([&, th]()
+                {
+                    // thread th owns bookings th , th + threads , ... ; consecutive
+                    // bookings of one thread land on different trains
+                    for (int i = th; i < bookings; i += threads)
+                    {
+                        int train = trainIds[i % trains];
+                        int passenger = passengers[i / trains];
+                        if (global)
+                        {
+                            std::lock_guard<std::mutex> guard(serial);
+                            ticketService.bookTicket(train, passenger);
+                        }
+                        else
+                            ticketService.bookTicket(train, passenger);
+                    }
+                });
+            for (auto &t : pool)
+                t.join();
+            double ms = timer.elapsedMs();
+
+            std::string label = std::string(global ? "global mutex" : "striped locks") + " , " +
+                                std::to_string(threads) + " threads";
+            reportRate(label, bookings, ms);
+            if (ticketService.getAllTickets().size() != (size_t)bookings)
+                std::cout << "  !! lost bookings\n";
+        }
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "models/ConcurrentSeatAllocator.h"
+#include "models/SeatAllocator.h"
+#include <thread>
+#include <mutex>
+#include <sstream>
+
+template <typename Fn>
+static double runThreads(int threads, Fn fn)
+{
+    BenchTimer timer;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back(fn, t);
+    for (auto &th : pool)
+        th.join();
+    return timer.elapsedMs();
+}
+
+// 1 - 64 threads hammering one 2,048 seat train with allocate + free pairs ,
+// lock-free bitmap vs SeatAllocator behind one mutex
+RMS_BENCH(one_train_contention)
+{
+    const int seats = 2048, opsTotal = 1 << 19;
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        int perThread = opsTotal / threads;
+
+        ConcurrentSeatAllocator lockFree(seats);
+        double ms = runThreads(threads, [&](int t)
+        {
+            for (int i = 0; i < perThread; i++)
+            {
+                int seat = lockFree.allocateSeat(t * perThread + i + 1);
+                if (seat > 0)
+                    lockFree.freeSeat(seat);
+            }
+        });
+        reportRate("lock-free , " + std::to_string(threads) + " threads", (long long)perThread * threads, ms);
+
+        SeatAllocator locked(seats);
+        std::mutex mutex;
+        std::streambuf *saved = std::cout.rdbuf(nullptr); // "train full" chatter
+        ms = runThreads(threads, [&](int t)
+        {
+            for (int i = 0; i < perThread; i++)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                int seat = locked.allocateSeat(t * perThread + i + 1);
+                if (seat > 0)
+                    locked.freeSeat(seat);
+            }
+        });
+        std::cout.rdbuf(saved);
+        reportRate("mutex , " + std::to_string(threads) + " threads", (long long)perThread * threads, ms);
+    }
+}
+
+// sale-open : 64 threads , 4x more buyers than seats , then every seat is
+// cancelled and the waiting list drained
+RMS_BENCH(sale_open_rush)
+{
+    const int seats = 50000, threads = 64, buyers = seats * 4;
+    ConcurrentSeatAllocator allocator(seats);
+    std::atomic<int> sold{0};
+    double ms = runThreads(threads, [&](int t)
+    {
+        for (int p = t + 1; p <= buyers; p += threads)
+            if (allocator.allocateSeat(p) > 0)
+                sold++;
+    });
+    reportRate("rush , 64 threads", buyers, ms);
+    reportValue("seats sold", sold.load(), "seats");
+    reportValue("waiting", allocator.getWaitingListSize(), "passengers");
+
+    ms = runThreads(threads, [&](int t)
+    {
+        for (int s = t + 1; s <= seats; s += threads)
+        {
+            allocator.freeSeat(s);
+            allocator.drainWaitingList();
+        }
+    });
+    allocator.drainWaitingList();
+    reportRate("cancel all + drain , 64 threads", seats, ms);
+    reportValue("waiting after drain", allocator.getWaitingListSize(), "passengers");
+}
@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "models/SeatAllocator.h"
+#include <random>
+#include <algorithm>
+
+// 2,000 seats in 20 coaches , filled with flexible bookings then churned with
+// random cancellations and cancel / rebook churn , so the free seats are scattered everywhere
+RMS_BENCH(defragmentation_after_churn)
+{
+    vector<CoachSpec> coaches;
+    for (int c = 0; c < 20; c++)
+        coaches.push_back({"general", 100});
+    SeatAllocator allocator(coaches);
+    SeatRequest flexible;
+    flexible.flexible = true;
+
+    std::mt19937 rng(30);
+    std::uniform_int_distribution<int> pickSeat(1, allocator.getTotalSeats());
+    int passenger = 0;
+    while (allocator.hasAvailableSeats())
+        allocator.allocateSeat(++passenger, flexible);
+    // a fifth cancelled at random , then cancel / rebook pairs at ~80% occupancy
+    while (allocator.getAvailableSeatCount() < 400)
+    {
+        int seat = pickSeat(rng);
+        if (!allocator.isSeatFree(seat))
+            allocator.freeSeat(seat);
+    }
+    for (int i = 0; i < 20000; i++)
+    {
+        int seat = pickSeat(rng);
+        if (allocator.isSeatFree(seat))
+            continue;
+        allocator.freeSeat(seat);
+        allocator.allocateSeat(++passenger, flexible); // reuses the cancelled-seat stack
+    }
+
+    reportValue("free seats", allocator.getAvailableSeatCount(), "seats");
+    reportValue("largest free block before", allocator.getLargestFreeBlock(), "seats");
+
+    const int stepsPerSlice = 64;
+    double worstSliceMs = 0, totalMs = 0;
+    long long moves = 0, slices = 0;
+    while (true)
+    {
+        BenchTimer timer;
+        DefragReport report = allocator.defragment(stepsPerSlice, true);
+        double ms = timer.elapsedMs();
+        worstSliceMs = std::max(worstSliceMs, ms);
+        totalMs += ms;
+        moves += report.moves.size();
+        slices++;
+        if (report.finished)
+            break;
+    }
+    reportRate("seat moves", moves, totalMs);
+    reportValue("slices of 64 steps", slices, "");
+    reportValue("worst slice", worstSliceMs * 1000, "us");
+    reportValue("largest free block after", allocator.getLargestFreeBlock(), "seats");
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "models/Train.h"
+#include <malloc.h>
+#include <random>
+
+// live heap bytes (glibc)
+static double heapMb()
+{
+    return mallinfo2().uordblks / (1024.0 * 1024.0);
+}
+
+// yyyymmdd of day `offset` after 2026-01-01 , 28-day months keep every date valid
+static int dayOf(int offset)
+{
+    return 20260000 + (offset / 28 + 1) * 100 + offset % 28 + 1;
+}
+
+// 1,000 trains sold 120 days ahead with 200 seats each ,
+// ~5% of the dates see any booking and those only a handful of seats
+RMS_BENCH(departures_1000_trains_120_days_sparse)
+{
+    const int trains = 1000, days = 120, seats = 200;
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<int> pickDay(0, days - 1);
+    std::uniform_int_distribution<int> pickCount(1, 8);
+
+    double before = heapMb();
+    std::vector<Train> fleet;
+    fleet.reserve(trains);
+    for (int t = 1; t <= trains; t++)
+        fleet.emplace_back(t, "Train " + std::to_string(t), seats);
+    double empty = heapMb();
+
+    BenchTimer timer;
+    long long bookings = 0;
+    int passenger = 1;
+    for (auto &train : fleet)
+        for (int d = 0; d < days / 20; d++)
+        {
+            SeatAllocator *inventory = train.getSeatAllocator(dayOf(pickDay(rng)));
+            for (int n = pickCount(rng); n > 0; n--, bookings++)
+                inventory->allocateSeat(passenger++);
+        }
+    reportRate("sparse bookings (lazy dates)", bookings, timer.elapsedMs());
+
+    long long materialized = 0;
+    for (const auto &train : fleet)
+        materialized += train.getDepartureCount();
+    double lazy = heapMb();
+    reportValue("materialized departures", materialized, "of 120000");
+    reportValue("trains, undated inventory only", empty - before, "MB");
+    reportValue("lazy per-date inventories", lazy - empty, "MB");
+
+    // eager : every date of a sample of trains created up front , scaled to the fleet
+    const int sample = 50;
+    double eagerBefore = heapMb();
+    std::vector<Train> eager;
+    for (int t = 1; t <= sample; t++)
+    {
+        eager.emplace_back(t, "Eager " + std::to_string(t), seats);
+        for (int d = 0; d < days; d++)
+            eager.back().getSeatAllocator(dayOf(d));
+    }
+    double eagerMb = (heapMb() - eagerBefore) * trains / sample;
+    reportValue("eager 120 inventories per train (scaled)", eagerMb, "MB");
+    reportValue("lazy / eager", (lazy - empty) / eagerMb * 100, "%");
+}
@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "Services/EventBus.h"
+#include "Services/TicketService.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+// what a booking pays for its event : the same bookings without a bus , with a bus nobody
+// listens to and with the JSON-lines log behind it , then raw publishes from 1 and 4 threads
+RMS_BENCH(event_bus)
+{
+    const int trains = 1000, seats = 100, bookings = 100000;
+    const std::string path = "/tmp/rms_bench_events_" + std::to_string(getpid()) + ".jsonl";
+
+    auto book = [&](const char *label, bool withBus, bool withLog) {
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        InMemoryTicketRepository ticketRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        for (int t = 0; t < trains; t++)
+            trainService.createTrain("T" + std::to_string(t), seats);
+        for (int p = 0; p < seats; p++)
+            passengerService.createPassenger("Passenger " + std::to_string(p));
+
+        EventBusOptions options;
+        options.waitWhenFull = true; // count every event , none dropped
+        EventBus bus(options);
+        std::unique_ptr<EventLogSink> sink;
+        if (withBus)
+        {
+            trainService.setEventBus(&bus);
+            ticketService.setEventBus(&bus);
+        }
+        if (withLog)
+            sink = std::make_unique<EventLogSink>(&bus, path);
+
+        BenchTimer timer;
+        for (int i = 0; i < bookings; i++)
+            ticketService.bookTicket(i % trains + 1, i / trains + 1); // every passenger once per train
+        reportRate(label, bookings, timer.elapsedMs());
+        bus.flush();
+        reportRate("  + until delivered", bookings, timer.elapsedMs());
+        std::remove(path.c_str());
+    };
+    book("book , no bus", false, false);
+    book("book , bus without subscribers", true, false);
+    book("book , bus + event log file", true, true);
+
+    const int events = 4000000;
+    for (int threads : {1, 4})
+    {
+        EventBusOptions options;
+        options.waitWhenFull = true;
+        EventBus bus(options);
+        bus.subscribe([](const Event *, size_t) {});
+        BenchTimer timer;
+        std::vector<std::thread> publishers;
+        for (int t = 0; t < threads; t++)
+            publishers.emplace_back([&] {
+                Event event;
+                event.type = EventType::TicketBooked;
+                for (int i = 0; i < events / threads; i++)
+                {
+                    event.ticketId = i;
+                    bus.publish(event);
+                }
+            });
+        for (auto &publisher : publishers)
+            publisher.join();
+        bus.flush();
+        reportRate("publish + deliver , " + std::to_string(threads) + " thread(s)", events, timer.elapsedMs());
+    }
+}
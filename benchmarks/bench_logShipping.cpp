@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "Repo/LogShipper.h"
+#include "Repo/LogReplica.h"
+#include "Repo/DurableTrainRepository.h"
+#include "Repo/DurableTicketRepository.h"
+#include "Repo/DurablePassengerRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+// a primary logging to a write-ahead log (Written) with and without a replica following it over
+// a Unix domain socket : saves per second , then the lag of single saves (commit on the primary
+// to applied on the replica) and how fast the replica catches up after a burst . both run in this
+// process , on one core the replica's applying takes its share of the primary's cpu
+RMS_BENCH(log_shipping)
+{
+    const int rows = 2000, burst = 100000, probes = 1000;
+    const std::string base = "/tmp/rms_bench_ship_" + std::to_string(getpid());
+    WalOptions written;
+    written.durability = Durability::Written;
+
+    for (bool shipped : {false, true})
+    {
+        std::remove((base + ".log").c_str());
+        WriteAheadLog wal(base + ".log", written);
+        DurableTrainRepository trains(std::make_unique<InMemoryTrainRepository>(), &wal);
+        DurableTicketRepository tickets(std::make_unique<InMemoryTicketRepository>(), &wal);
+        DurablePassengerRepository passengers(std::make_unique<InMemoryPassengerRepository>(), &wal);
+        std::vector<Passenger> riders;
+        for (int i = 0; i < rows; i++)
+        {
+            Passenger rider(0, "Passenger " + std::to_string(i));
+            passengers.save(rider);
+            riders.push_back(rider);
+        }
+
+        InMemoryTrainRepository replicaTrains;
+        InMemoryTicketRepository replicaTickets;
+        InMemoryPassengerRepository replicaPassengers;
+        std::unique_ptr<LogShipper> shipper;
+        std::unique_ptr<LogReplica> replica;
+        if (shipped)
+        {
+            shipper = std::make_unique<LogShipper>(&wal, &trains, &tickets, &passengers, base + ".sock");
+            ReplicaOptions options;
+            options.retryMs = 1;
+            replica = std::make_unique<LogReplica>(&replicaTrains, &replicaTickets, &replicaPassengers, base + ".sock", options);
+            replica->waitForPosition(shipper->position(), 10000);
+        }
+        const std::string mode = shipped ? "one replica" : "no replica";
+
+        BenchTimer timer;
+        for (int i = 0; i < burst; i++)
+        {
+            Passenger &rider = riders[i % rows];
+            rider.setName("Passenger " + std::to_string(i));
+            passengers.save(rider);
+        }
+        reportRate(mode + " : saves on the primary", burst, timer.elapsedMs());
+        if (!shipped)
+            continue;
+        replica->waitForPosition(shipper->position(), 60000);
+        reportRate("  replica caught up with the burst", burst, timer.elapsedMs());
+
+        std::vector<double> lags;
+        for (int i = 0; i < probes; i++)
+        {
+            Passenger &rider = riders[i % rows];
+            rider.setName("Probe " + std::to_string(i));
+            timer.reset();
+            passengers.save(rider);
+            replica->waitForPosition(shipper->position(), 10000);
+            lags.push_back(timer.elapsedMs());
+        }
+        std::sort(lags.begin(), lags.end());
+        reportValue("  lag p50 , commit to applied", lags[lags.size() / 2] * 1000, "us");
+        reportValue("  lag p99", lags[lags.size() * 99 / 100] * 1000, "us");
+        ReplicaStats stats = replica->getStats();
+        reportValue("  records applied", (double)stats.records, "");
+        reportValue("  max lag seen by the replica", stats.maxLagMs, "ms");
+    }
+    std::remove((base + ".log").c_str());
+}
@@ -0,0 +1,24 @@
+#include "bench.h"
+
+int main(int argc, char **argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+    int ran = 0;
+    for (const auto &bench : benchRegistry())
+    {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos)
+            continue;
+        std::cout << "[" << bench.name << "]\n";
+        bench.run();
+        std::cout << "\n";
+        ran++;
+    }
+    if (ran == 0)
+    {
+        std::cout << "No benchmark matches '" << filter << "'. Available:\n";
+        for (const auto &bench : benchRegistry())
+            std::cout << "  " << bench.name << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include <thread>
+#include <atomic>
+
+// book + cancel churn with every thread aimed at the same few trains :
+// locking vs optimistic vs seat claims , throughput and the share of attempts that aborted
+RMS_BENCH(optimistic_vs_locking_contention)
+{
+    const int seats = 64, opsPerThread = 400;
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for (ConcurrencyMode mode : {ConcurrencyMode::Locking, ConcurrencyMode::Optimistic, ConcurrencyMode::SeatClaims})
+        for (int trains : {1, 8})
+            for (int threads : {1, 4, 16, 32})
+            {
+                InMemoryTicketRepository ticketRepo;
+                InMemoryTrainRepository trainRepo;
+                InMemoryPassengerRepository passengerRepo;
+                TrainService trainService(&trainRepo);
+                PassengerService passengerService(&passengerRepo);
+                TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+                ticketService.setConcurrencyMode(mode);
+
+                std::vector<int> trainIds;
+                for (int t = 0; t < trains; t++)
+                    trainIds.push_back(trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+                std::vector<int> passengers;
+                for (int p = 0; p < threads * opsPerThread; p++)
+                    passengers.push_back(passengerService.createPassenger("P" + std::to_string(p)).getId());
+
+                std::atomic<long long> operations{0};
+                std::streambuf *saved = std::cout.rdbuf(nullptr);
+                BenchTimer timer;
+                std::vector<std::thread> pool;
+                for (int th = 0; th < threads; th++)
+                    pool.emplace_back([&, th]()
+                    {
+                        // book and cancel in a loop (a cancelled ticket still blocks rebooking ,
+                        // so every operation uses a fresh passenger) : each one rewrites a train
+                        // the other threads are writing too
+                        for (int i = 0; i < opsPerThread; i++)
+                        {
+                            int train = trainIds[(th + i) % trains];
+                            auto ticket = ticketService.bookTicket(train, passengers[th * opsPerThread + i]);
+                            operations++;
+                            if (ticket.has_value())
+                            {
+                                ticketService.cancelTicket(ticket->getId());
+                                operations++;
+                            }
+                        }
+                    });
+                for (auto &t : pool)
+                    t.join();
+                double ms = timer.elapsedMs();
+                std::cout.rdbuf(saved);
+
+                const RetryStats &stats = ticketService.getRetryStats();
+                long long commits = stats.commits.load(), conflicts = stats.conflicts.load();
+                std::string label = std::string(mode == ConcurrencyMode::Locking      ? "locking"
+                                                : mode == ConcurrencyMode::Optimistic ? "optimistic"
+                                                                                      : "claims") +
+                                    " , " + std::to_string(trains) + " train(s) , " + std::to_string(threads) + " thr";
+                // a claims commit covers a whole batch of bookings , so count operations rather than commits
+                reportRate(label, operations.load(), ms);
+                reportValue("  abort rate", commits + conflicts ? 100.0 * conflicts / (commits + conflicts) : 0, "%");
+            }
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "models/SeatAllocator.h"
+#include "Services/HoldScheduler.h"
+#include <random>
+#include <algorithm>
+
+// 1,000,000 concurrent holds : 500 trains x 2,000 seats , every seat held with a
+// 1 - 10 minute ttl , a fifth confirmed before expiry , then the clock sweeps in 1 s ticks
+RMS_BENCH(seat_holds_1m_expiring)
+{
+    const int trains = 500, seatsPerTrain = 2000, batch = 4096;
+    std::mt19937 rng(28);
+    std::uniform_int_distribution<long long> ttl(60000, 600000);
+
+    std::vector<SeatAllocator> allocators(trains, SeatAllocator(seatsPerTrain));
+    HoldScheduler scheduler;
+
+    BenchTimer timer;
+    int holdId = 0;
+    for (int t = 0; t < trains; t++)
+        for (int p = 1; p <= seatsPerTrain; p++)
+        {
+            holdId++;
+            long long expiresAt = ttl(rng);
+            allocators[t].holdSeat(holdId, p, expiresAt);
+            scheduler.schedule(holdId, t, expiresAt);
+        }
+    reportRate("hold + schedule", holdId, timer.elapsedMs());
+
+    timer.reset();
+    int confirmed = 0;
+    for (int id = 5; id <= holdId; id += 5, confirmed++)
+        allocators[(id - 1) / seatsPerTrain].confirmHold(id);
+    reportRate("confirm 20% (timer left stale)", confirmed, timer.elapsedMs());
+
+    timer.reset();
+    long long expired = 0, popped = 0;
+    double worstTickMs = 0;
+    for (long long now = 0; !scheduler.empty(); now += 1000)
+    {
+        BenchTimer tick;
+        while (true)
+        {
+            auto due = scheduler.popDue(now, batch);
+            if (due.empty())
+                break;
+            popped += due.size();
+            for (const auto &timerEntry : due)
+            {
+                SeatAllocator &allocator = allocators[timerEntry.trainId];
+                if (!allocator.hasHold(timerEntry.holdId))
+                    continue;
+                allocator.releaseHold(timerEntry.holdId);
+                expired++;
+            }
+        }
+        worstTickMs = std::max(worstTickMs, tick.elapsedMs());
+    }
+    double ms = timer.elapsedMs();
+    reportRate("expire sweep (released holds)", expired, ms);
+    reportRate("expire sweep (timers popped)", popped, ms);
+    reportValue("worst 1 s tick", worstTickMs, "ms");
+
+    int free = 0;
+    for (const auto &allocator : allocators)
+        free += allocator.getAvailableSeatCount();
+    reportValue("seats back in inventory", free, "seats");
+}
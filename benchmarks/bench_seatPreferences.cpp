@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "models/SeatAllocator.h"
+#include <random>
+
+// 2,000 seats : 20 coaches of 100 , sleeper / first / second
+static SeatAllocator makeTrain()
+{
+    vector<CoachSpec> coaches;
+    for (int c = 0; c < 20; c++)
+        coaches.push_back({c < 6 ? "sleeper" : (c < 10 ? "first" : "second"), 100});
+    SeatAllocator allocator(coaches);
+    for (int c = 0; c < 6; c++) // lower berths : every other pair in the sleepers
+        for (int seat = c * 100 + 1; seat <= c * 100 + 100; seat += 4)
+            allocator.tagSeats(seat, seat + 1, SEAT_LOWER_BERTH);
+    for (int c = 0; c < 20; c++)
+        allocator.tagSeats(c * 100 + 1, c * 100 + 4, SEAT_ACCESSIBLE);
+    return allocator;
+}
+
+// what the bitsets replace : test every seat one by one
+static int scanForSeat(const SeatAllocator &allocator, unsigned wanted)
+{
+    int best = -1, bestMatched = -1;
+    for (int seat = 1; seat <= allocator.getTotalSeats(); seat++)
+    {
+        if (!allocator.isSeatFree(seat))
+            continue;
+        int matched = std::popcount(allocator.getSeatAttributes(seat) & wanted);
+        if (matched > bestMatched)
+        {
+            best = seat;
+            bestMatched = matched;
+        }
+    }
+    return best;
+}
+
+RMS_BENCH(seat_preferences_fill_2000_seat_trains)
+{
+    const int trains = 50;
+    SeatRequest request;
+    request.preferences = SEAT_WINDOW | SEAT_LOWER_BERTH;
+
+    long long ops = 0;
+    double ms = 0;
+    for (int t = 0; t < trains; t++)
+    {
+        SeatAllocator allocator = makeTrain();
+        BenchTimer timer;
+        for (int p = 1; p <= allocator.getTotalSeats(); p++, ops++)
+            allocator.allocateSeat(p, request);
+        ms += timer.elapsedMs();
+    }
+    reportRate("fill with window+lower (bitset)", ops, ms);
+}
+
+RMS_BENCH(seat_preferences_churn_90_percent_full)
+{
+    std::mt19937 rng(42);
+    SeatAllocator allocator = makeTrain();
+    const int total = allocator.getTotalSeats();
+    vector<int> taken;
+    for (int p = 1; p <= total * 9 / 10; p++)
+        taken.push_back(allocator.allocateSeat(p));
+
+    const unsigned masks[] = {SEAT_WINDOW, SEAT_WINDOW | SEAT_LOWER_BERTH, SEAT_AISLE | SEAT_ACCESSIBLE,
+                              SEAT_NEAR_DOOR | SEAT_LOWER_BERTH | SEAT_WINDOW};
+    const int ops = 200000;
+    int nextPassenger = total + 1;
+
+    BenchTimer timer;
+    for (int i = 0; i < ops; i++)
+    {
+        size_t victim = rng() % taken.size();
+        allocator.freeSeat(taken[victim]);
+        SeatRequest request;
+        request.preferences = masks[i % 4];
+        taken[victim] = allocator.allocateSeat(nextPassenger++, request);
+    }
+    reportRate("free + preference allocate (bitset)", ops, timer.elapsedMs());
+
+    timer.reset();
+    long long found = 0;
+    for (int i = 0; i < ops / 20; i++)
+        found += scanForSeat(allocator, masks[i % 4]) > 0;
+    reportRate("preference query (seat-by-seat scan)", ops / 20, timer.elapsedMs());
+}
@@ -0,0 +1,116 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Services/BookingPipeline.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/RepositoryShards.h"
+#include "Repo/ShardedTrainRepository.h"
+#include "Repo/ShardedTicketRepository.h"
+#include <thread>
+
+namespace
+{
+    const int TRAINS = 128, SEATS = 64, BOOKINGS = TRAINS * SEATS;
+
+    // books every seat of every train from `threads` threads , thread th takes every th-th booking
+    double bookFrom(TicketService &ticketService, const std::vector<int> &trainIds,
+                    const std::vector<int> &passengers, int threads)
+    {
+        BenchTimer timer;
+        std::vector<std::thread> pool;
+        for (int th = 0; th < threads; th++)
+            pool.emplace_back([&, th]()
+            {
+                for (int i = th; i < BOOKINGS; i += threads)
+                    ticketService.bookTicket(trainIds[i % TRAINS], passengers[i / TRAINS]);
+            });
+        for (auto &t : pool)
+            t.join();
+        return timer.elapsedMs();
+    }
+
+    void setup(TrainService &trainService, PassengerService &passengerService,
+               std::vector<int> &trainIds, std::vector<int> &passengers)
+    {
+        for (int t = 0; t < TRAINS; t++)
+            trainIds.push_back(trainService.createTrain("T" + std::to_string(t), SEATS).getTrainId());
+        for (int p = 0; p < SEATS; p++)
+            passengers.push_back(passengerService.createPassenger("P" + std::to_string(p)).getId());
+    }
+}
+
+// 128 trains x 64 seats booked from 8 threads : one global map per repository vs the same
+// data split over 4 / 16 shards , each with its own maps and reader / writer locks
+RMS_BENCH(sharded_repository_booking)
+{
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    const int threads = 8;
+    {
+        InMemoryTicketRepository ticketRepo;
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        std::vector<int> trainIds, passengers;
+        setup(trainService, passengerService, trainIds, passengers);
+        reportRate("one map , 8 threads", BOOKINGS, bookFrom(ticketService, trainIds, passengers, threads));
+    }
+    for (int count : {4, 16})
+    {
+        RepositoryShards shards(count);
+        ShardedTicketRepository ticketRepo(&shards);
+        ShardedTrainRepository trainRepo(&shards);
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        std::vector<int> trainIds, passengers;
+        setup(trainService, passengerService, trainIds, passengers);
+        reportRate(std::to_string(count) + " shards , 8 threads", BOOKINGS,
+                   bookFrom(ticketService, trainIds, passengers, threads));
+
+        BenchTimer timer;
+        size_t listed = ticketRepo.getAllTickets().size();
+        reportValue("  merged listing of " + std::to_string(listed) + " tickets", timer.elapsedMs(), "ms");
+    }
+}
+
+// the booking pipeline over 8 shards : workers share one ready queue vs one worker per shard
+RMS_BENCH(sharded_repository_pipeline)
+{
+    const int count = 8;
+    for (bool pinned : {false, true})
+    {
+        RepositoryShards shards(count);
+        ShardedTicketRepository ticketRepo(&shards);
+        ShardedTrainRepository trainRepo(&shards);
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        std::vector<int> trainIds, passengers;
+        setup(trainService, passengerService, trainIds, passengers);
+
+        BookingPipelineOptions options;
+        options.workers = count;
+        if (pinned)
+            options.shardOf = [&shards](int trainId) { return shards.shardOf(trainId); };
+        BookingPipeline pipeline(&ticketService, options);
+
+        BenchTimer timer;
+        for (int i = 0; i < BOOKINGS; i++)
+        {
+            BookingRequest r;
+            r.trainId = trainIds[i % TRAINS];
+            r.passengerId = passengers[i / TRAINS];
+            pipeline.submit(r, nullptr);
+        }
+        pipeline.shutdown();
+        reportRate(pinned ? "thread per shard" : "shared ready queue", pipeline.getStats().completed, timer.elapsedMs());
+        reportValue("  average batch fill", pipeline.getStats().averageBatchFill * 100, "%");
+    }
+}
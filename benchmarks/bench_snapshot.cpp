@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/Snapshot.h"
+#include <thread>
+#include <atomic>
+#include <shared_mutex>
+
+// ticket writes per second into a repository of 200,000 tickets while another thread
+// scans every ticket over and over . "locked scan" holds a shared lock for the whole walk ,
+// as the listings did before snapshots ; "snapshot scan" takes a snapshot and walks it unlocked
+RMS_BENCH(snapshot_writer_with_full_scan)
+{
+    const int existing = 200000, writes = 50000;
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for (int mode = 0; mode < 3; mode++) // 0 no reader , 1 locked scan , 2 snapshot scan
+    {
+        InMemoryTicketRepository repo;
+        Passenger passenger(1, "Omar");
+        for (int i = 0; i < existing; i++)
+        {
+            Ticket t(0, 1, 1 + i % 100, passenger);
+            repo.save(t);
+        }
+
+        std::shared_mutex scanLock; // stands in for the repository lock in the locked mode
+        std::atomic<bool> done{false};
+        std::atomic<long long> scanned{0};
+        std::atomic<int> scans{0};
+        std::thread reader([&] {
+            while (mode != 0 && !done)
+            {
+                long long seen = 0;
+                if (mode == 1)
+                {
+                    std::shared_lock lock(scanLock);
+                    repo.snapshot().forEach([&](const Ticket &) { seen++; });
+                }
+                else
+                    repo.snapshot().forEach([&](const Ticket &) { seen++; });
+                scanned += seen;
+                scans++;
+            }
+        });
+
+        BenchTimer timer;
+        for (int i = 0; i < writes; i++)
+        {
+            Ticket t(0, 1, 1 + i % 100, passenger);
+            if (mode == 1)
+            {
+                std::unique_lock lock(scanLock);
+                repo.save(t);
+            }
+            else
+                repo.save(t);
+        }
+        double ms = timer.elapsedMs();
+        done = true;
+        reader.join();
+
+        const char *label = mode == 0 ? "writes , no reader" : mode == 1 ? "writes , locked scan" : "writes , snapshot scan";
+        reportRate(label, writes, ms);
+        if (mode != 0)
+            reportValue("  full scans finished", scans.load(), "");
+        repo.clear();
+    }
+}
+
+// cost of taking a snapshot as the repository grows : one root pointer copy
+RMS_BENCH(snapshot_take_cost)
+{
+    InMemoryTicketRepository repo;
+    Passenger passenger(1, "Omar");
+    for (int size : {1000, 100000, 400000})
+    {
+        while ((int)repo.snapshot().size() < size)
+        {
+            Ticket t(0, 1, 1, passenger);
+            repo.save(t);
+        }
+        const int takes = 100000;
+        BenchTimer timer;
+        for (int i = 0; i < takes; i++)
+            repo.snapshot();
+        reportRate("snapshot of " + std::to_string(size) + " tickets", takes, timer.elapsedMs());
+    }
+    repo.clear();
+}
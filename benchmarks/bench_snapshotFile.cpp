@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "Repo/SnapshotFile.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include <cstdio>
+#include <unistd.h>
+
+// startup from a snapshot file against rebuilding through bookings . 10k trains and 1M tickets :
+// the in-memory repositories need a few hundred bytes per ticket , so 50M does not fit this
+// machine ; the per-ticket rates below are what a 50M estimate scales from
+RMS_BENCH(snapshot_startup)
+{
+    const int trains = 10000, seats = 100, passengers = 10000;
+    const int tickets = 1000000;
+    const std::string path = "/tmp/rms_bench_snapshot_" + std::to_string(getpid()) + ".snap";
+
+    // the rebuild path : one booking at a time through the service , as loadMockData does
+    {
+        InMemoryTicketRepository ticketRepo;
+        InMemoryTrainRepository trainRepo;
+        InMemoryPassengerRepository passengerRepo;
+        TrainService trainService(&trainRepo);
+        PassengerService passengerService(&passengerRepo);
+        TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+        for (int t = 0; t < 100; t++)
+            trainService.createTrain("T" + std::to_string(t), seats);
+        for (int p = 0; p < seats; p++)
+            passengerService.createPassenger("P" + std::to_string(p));
+        BenchTimer timer;
+        for (int i = 0; i < 100 * seats; i++)
+            ticketService.bookTicket(i % 100 + 1, i / 100 + 1);
+        double ms = timer.elapsedMs();
+        reportRate("rebuild by booking", 100 * seats, ms);
+        reportValue("  estimate for 50M tickets", ms / (100 * seats) * 50e6 / 1000, "s");
+    }
+
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    for (int t = 0; t < trains; t++)
+    {
+        Train train(0, "T" + std::to_string(t), seats);
+        trainRepo.save(train);
+    }
+    std::vector<Passenger> riders;
+    for (int p = 0; p < passengers; p++)
+    {
+        Passenger passenger(0, "Passenger " + std::to_string(p));
+        passengerRepo.save(passenger);
+        riders.push_back(passenger);
+    }
+    for (int from = 0; from < tickets; from += 65536)
+    {
+        vector<Ticket> batch;
+        for (int i = from; i < std::min(tickets, from + 65536); i++)
+            batch.push_back(Ticket(0, i / trains % seats + 1, i % trains + 1, riders[i % passengers]));
+        ticketRepo.saveAll(batch);
+    }
+
+    BenchTimer timer;
+    SnapshotFileStats stats = writeSnapshotFile(path, trainRepo.snapshot(), passengerRepo.getAllPassengers(), ticketRepo.snapshot());
+    reportRate("write snapshot (tickets)", stats.tickets, timer.elapsedMs());
+    reportValue("  file size", stats.bytes / 1048576.0, "MB");
+
+    timer.reset();
+    MappedSnapshot mapped(path);
+    reportValue("map and check header", timer.elapsedMs(), "ms");
+
+    timer.reset();
+    long long seatSum = 0;
+    for (size_t i = 0; i < mapped.ticketCount(); i++)
+        seatSum += mapped.ticketRecord(i).seat;
+    double scanMs = timer.elapsedMs();
+    reportRate("scan ticket records in place", (long long)mapped.ticketCount(), scanMs);
+    if (seatSum == 0)
+        std::cout << "  (no seats)\n";
+
+    timer.reset();
+    {
+        InMemoryTicketRepository restoredTickets;
+        InMemoryTrainRepository restoredTrains;
+        InMemoryPassengerRepository restoredPassengers;
+        mapped.restore(restoredTrains, restoredPassengers, restoredTickets);
+        double ms = timer.elapsedMs();
+        reportRate("restore into repositories (tickets)", (long long)mapped.ticketCount(), ms);
+        reportValue("  estimate for 50M tickets", ms / tickets * 50e6 / 1000, "s");
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,105 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/SqliteTicketRepository.h"
+#include "Repo/SqliteTrainRepository.h"
+#include "Repo/SqlitePassengerRepository.h"
+#include <cstdio>
+#include <memory>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// the same work on the in-memory repositories and on SQLite (WAL journal , synchronous=NORMAL) :
+// bookings through the services (two autocommits each) , a bulk insert through saveAll (one
+// transaction) , point lookups on the (train , passenger) index , name lookups and a full read
+RMS_BENCH(sqlite_repository)
+{
+    const int trains = 200, seats = 50, passengers = 2000;
+    const int bookings = trains * seats, bulk = 200000, lookups = 100000;
+    const std::string path = "/tmp/rms_bench_sqlite_" + std::to_string(getpid()) + ".db";
+
+    for (bool sqlite : {false, true})
+    {
+        for (const char *suffix : {"", "-wal", "-shm"})
+            std::remove((path + suffix).c_str());
+        std::unique_ptr<SqliteDatabase> database;
+        std::unique_ptr<ITrainRepository> trainRepo;
+        std::unique_ptr<ITicketRepository> ticketRepo;
+        std::unique_ptr<IPassengerRepository> passengerRepo;
+        if (sqlite)
+        {
+            database = std::make_unique<SqliteDatabase>(path);
+            trainRepo = std::make_unique<SqliteTrainRepository>(database.get());
+            ticketRepo = std::make_unique<SqliteTicketRepository>(database.get());
+            passengerRepo = std::make_unique<SqlitePassengerRepository>(database.get());
+        }
+        else
+        {
+            trainRepo = std::make_unique<InMemoryTrainRepository>();
+            ticketRepo = std::make_unique<InMemoryTicketRepository>();
+            passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+        }
+        TrainService trainService(trainRepo.get());
+        PassengerService passengerService(passengerRepo.get());
+        TicketService ticketService(ticketRepo.get(), &trainService, &passengerService);
+        const std::string backend = sqlite ? "sqlite" : "memory";
+
+        for (int t = 0; t < trains; t++)
+            trainService.createTrain("T" + std::to_string(t), seats);
+        BenchTimer timer;
+        for (int p = 0; p < passengers; p++)
+            passengerService.createPassenger("Passenger " + std::to_string(p));
+        reportRate(backend + " : create passenger", passengers, timer.elapsedMs());
+
+        timer.reset();
+        for (int i = 0; i < bookings; i++)
+            ticketService.bookTicket(i % trains + 1, i / trains + 1);
+        reportRate(backend + " : book (service)", bookings, timer.elapsedMs());
+
+        std::vector<Passenger> riders;
+        for (int p = 0; p < passengers; p++)
+            riders.push_back(*passengerRepo->getPassenger(p + 1));
+        timer.reset();
+        for (int from = 0; from < bulk; from += 10000)
+        {
+            vector<Ticket> batch;
+            for (int i = from; i < from + 10000; i++)
+                batch.push_back(Ticket(0, i % seats + 1, trains + 1 + i % 1000, riders[i % passengers]));
+            ticketRepo->saveAll(batch);
+        }
+        reportRate(backend + " : saveAll , 10k per batch", bulk, timer.elapsedMs());
+
+        timer.reset();
+        int found = 0;
+        for (int i = 0; i < lookups; i++)
+            found += ticketRepo->getTicketByTrainAndPassenger(i % trains + 1, i % seats + 1).has_value();
+        reportRate(backend + " : ticket by train + passenger", lookups, timer.elapsedMs());
+
+        timer.reset();
+        for (int i = 0; i < lookups / 10; i++)
+            found += passengerService.find_or_create_passenger("Passenger " + std::to_string(i % passengers)).getId() > 0;
+        reportRate(backend + " : passenger by name", lookups / 10, timer.elapsedMs());
+
+        timer.reset();
+        size_t all = ticketService.getAllTickets().size();
+        reportRate(backend + " : getAllTickets", (long long)all, timer.elapsedMs());
+        if (found == 0)
+            reportValue("  nothing found", 0, "");
+
+        if (sqlite)
+        {
+            struct stat info{};
+            long long bytes = 0;
+            for (const char *suffix : {"", "-wal"})
+                if (::stat((path + suffix).c_str(), &info) == 0)
+                    bytes += info.st_size;
+            reportValue("  database + wal size", bytes / 1048576.0, "MB");
+        }
+    }
+    for (const char *suffix : {"", "-wal", "-shm"})
+        std::remove((path + suffix).c_str());
+}
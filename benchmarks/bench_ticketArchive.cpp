@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/TieredTicketRepository.h"
+#include <cstdio>
+#include <memory>
+#include <unistd.h>
+
+// a live tier where three tickets in four are cancelled or departed , before and after
+// archiveTickets : the lookups the booking path makes , a full listing , point reads of archived
+// tickets (decode of at most one 64-row restart) and of ids nobody has (the Bloom filter)
+RMS_BENCH(ticket_archive)
+{
+    const int count = 400000, trains = 400, lookups = 200000;
+    const std::string path = "/tmp/rms_bench_archive_" + std::to_string(getpid()) + ".arc";
+    std::remove(path.c_str());
+    {
+        TicketArchive archive(path);
+        TieredTicketRepository tickets(std::make_unique<InMemoryTicketRepository>(), &archive);
+        for (int from = 0; from < count; from += 10000)
+        {
+            vector<Ticket> batch;
+            for (int i = from; i < from + 10000; i++)
+            {
+                int passengerId = i / trains + 1;
+                Ticket ticket(0, passengerId % 100 + 1, i % trains + 1, Passenger(passengerId, "Passenger " + std::to_string(passengerId)),
+                              i % 4 == 1 ? 20250101 + i % 28 : 20990101);
+                if (i % 4 >= 2)
+                    ticket.setStatus(cancelled);
+                batch.push_back(ticket);
+            }
+            tickets.saveAll(batch);
+        }
+
+        for (bool archived : {false, true})
+        {
+            const std::string tier = archived ? "after archiving" : "all live";
+            if (archived)
+            {
+                BenchTimer timer;
+                size_t moved = tickets.archiveTickets(20261019);
+                reportRate("archiveTickets", (long long)moved, timer.elapsedMs());
+            }
+            BenchTimer timer;
+            int found = 0;
+            for (int i = 0; i < lookups; i++)
+                found += tickets.getTicketByTrainAndPassenger(i % trains + 1, (i * 7) % (count / trains) + 1, 20990101).has_value();
+            reportRate(tier + " : ticket by train + passenger + date", lookups, timer.elapsedMs());
+
+            timer.reset();
+            size_t live = tickets.getAllTickets().size();
+            reportRate(tier + " : getAllTickets", (long long)live, timer.elapsedMs());
+            reportValue("  live tickets", (double)live, "");
+            if (found == 0)
+                reportValue("  nothing found", 0, "");
+        }
+
+        BenchTimer timer;
+        int found = 0;
+        for (int i = 0; i < lookups; i++)
+            found += tickets.getTicketById((i * 4 + 3) % count + 1).has_value(); // cancelled ones , archived
+        reportRate("getTicketById , archived", lookups, timer.elapsedMs());
+        timer.reset();
+        for (int i = 0; i < lookups; i++)
+            found += tickets.getTicketById(count + 1 + i).has_value();
+        reportRate("getTicketById , unknown id", lookups, timer.elapsedMs());
+
+        ArchiveStats stats = archive.getStats();
+        reportValue("  archive size", stats.bytes / 1048576.0, "MB");
+        reportValue("  as fixed-size records", stats.rawBytes / 1048576.0, "MB");
+        reportValue("  bytes per ticket", (double)stats.bytes / (double)stats.tickets, "B");
+        reportValue("  Bloom filter", stats.bloomBytes / 1024.0, "KB");
+        reportValue("  rejected by the Bloom filter", 100.0 * stats.bloomRejects / lookups, "%");
+        if (found == 0)
+            reportValue("  nothing found", 0, "");
+    }
+    std::remove(path.c_str());
+}
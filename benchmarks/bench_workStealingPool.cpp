@@ -0,0 +1,43 @@
+#include "bench.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/Snapshot.h"
+#include "utils/WorkStealingPool.h"
+#include <thread>
+
+// ticket report over 1,000,000 tickets : the old single-threaded walk of the snapshot
+// against Snapshot::reduce on pools of 1 , 2 and one-per-hardware-thread workers .
+// the speedup tracks the core count , on one core the pool only adds its overhead
+RMS_BENCH(work_stealing_ticket_scan)
+{
+    const int tickets = 1000000;
+    std::cout << "  hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    InMemoryTicketRepository repo;
+    Passenger passenger(1, "Omar");
+    for (int i = 0; i < tickets; i++)
+    {
+        Ticket t(0, 1 + i % 500, 1 + i % 100, passenger);
+        repo.save(t);
+    }
+    Snapshot<Ticket> snapshot = repo.snapshot();
+
+    BenchTimer timer;
+    long long bookedCount = 0;
+    snapshot.forEach([&](const Ticket &t) { bookedCount += t.getStatus() == booked; });
+    reportRate("sequential walk", tickets, timer.elapsedMs());
+
+    int hardware = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int threads : {1, 2, hardware})
+    {
+        WorkStealingPool pool(threads);
+        BenchTimer parallel;
+        long long count = snapshot.reduce(pool, 0LL, [](long long acc, const Ticket &t) {
+            return acc + (t.getStatus() == booked);
+        }, [](long long a, long long b) { return a + b; });
+        std::string label = "pool of " + std::to_string(threads);
+        reportRate(label, tickets, parallel.elapsedMs());
+        if (count != bookedCount)
+            std::cout << "  mismatch: " << count << " vs " << bookedCount << "\n";
+        reportValue("  steals", (double)pool.getStats().stolen, "");
+    }
+    repo.clear();
+}
@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/DurableTicketRepository.h"
+#include "Repo/DurableTrainRepository.h"
+#include "Repo/DurablePassengerRepository.h"
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+// bookings per second with every change logged , at each durability level and 1 / 8 threads .
+// a booking commits twice (train , ticket) ; "syncs per booking" under 2 means group commit
+// folded commits of several threads into one fsync . the "memory only" row has no log at all
+RMS_BENCH(wal_booking_durability)
+{
+    const int trains = 16, seats = 32;
+    const int bookings = trains * seats;
+    const std::string path = "/tmp/rms_bench_wal_" + std::to_string(getpid()) + ".log";
+
+    struct Level
+    {
+        const char *name;
+        bool logged;
+        Durability durability;
+    };
+    const Level levels[] = {{"memory only", false, Durability::Buffered},
+                            {"buffered", true, Durability::Buffered},
+                            {"written", true, Durability::Written},
+                            {"synced", true, Durability::Synced}};
+
+    for (const Level &level : levels)
+        for (int threads : {1, 8})
+        {
+            std::remove(path.c_str());
+            WalOptions options;
+            options.durability = level.durability;
+            std::unique_ptr<WriteAheadLog> log;
+            std::unique_ptr<ITrainRepository> trainRepo = std::make_unique<InMemoryTrainRepository>();
+            std::unique_ptr<ITicketRepository> ticketRepo = std::make_unique<InMemoryTicketRepository>();
+            std::unique_ptr<IPassengerRepository> passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+            if (level.logged)
+            {
+                log = std::make_unique<WriteAheadLog>(path, options);
+                trainRepo = std::make_unique<DurableTrainRepository>(std::move(trainRepo), log.get());
+                ticketRepo = std::make_unique<DurableTicketRepository>(std::move(ticketRepo), log.get());
+                passengerRepo = std::make_unique<DurablePassengerRepository>(std::move(passengerRepo), log.get());
+            }
+            TrainService trainService(trainRepo.get());
+            PassengerService passengerService(passengerRepo.get());
+            TicketService ticketService(ticketRepo.get(), &trainService, &passengerService);
+
+            std::vector<int> trainIds;
+            for (int t = 0; t < trains; t++)
+                trainIds.push_back(trainService.createTrain("T" + std::to_string(t), seats).getTrainId());
+            std::vector<int> passengers;
+            for (int p = 0; p < seats; p++)
+                passengers.push_back(passengerService.createPassenger("P" + std::to_string(p)).getId());
+            WalStats before = log ? log->getStats() : WalStats{};
+
+            BenchTimer timer;
+            std::vector<std::thread> pool;
+            for (int th = 0; th < threads; th++)
+                pool.emplace_back([&, th]()
+                {
+                    for (int i = th; i < bookings; i += threads)
+                        ticketService.bookTicket(trainIds[i % trains], passengers[i / trains]);
+                });
+            for (auto &t : pool)
+                t.join();
+            double ms = timer.elapsedMs();
+
+            std::string label = std::string(level.name) + " , " + std::to_string(threads) + " threads";
+            reportRate(label, bookings, ms);
+            if (log)
+            {
+                WalStats after = log->getStats();
+                reportValue("  syncs per booking", (double)(after.syncs - before.syncs) / bookings, "");
+            }
+        }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,45 @@
+#ifndef RMS_ASYNCRMSFACADE_H
+#define RMS_ASYNCRMSFACADE_H
+
+#include "RMSFacade.h"
+#include "utils/Task.h"
+#include "utils/Executor.h"
+#include <string>
+
+// awaitable front end over RMSFacade for callers that must not block :
+//   auto ticket = co_await async.bookTicket(trainId, "omar");
+// every coroutine runs on the executor's thread . bookings go through the booking pipeline
+// when the facade has it enabled (the coroutine is resumed once its batch is booked) ,
+// otherwise they run inline and yield afterwards . long operations yield every chunk so
+// one large listing or waitlist promotion cannot starve the other coroutines
+class AsyncRMSFacade
+{
+private:
+    RMSFacade *facade;
+    TrainService *trainService;
+    TicketService *ticketService;
+    Executor *executor;
+    int chunkSize;
+
+    struct PipelineBooking; // awaiter resumed by the pipeline's completion callback
+
+public:
+    AsyncRMSFacade(RMSFacade *facade, TrainService *ts, TicketService *tks, Executor *executor, int chunkSize = 64);
+
+    Executor &getExecutor();
+    int getChunkSize() const;
+
+    // arguments are taken by value , they must outlive the caller's first suspension .
+    // pass a SeatRequest as a named variable : g++ 12 destroys aggregate temporaries
+    // written inside a co_await expression twice , hence no default for it either
+    Task<std::optional<Ticket>> bookTicket(int trainId, std::string passengerName);
+    Task<std::optional<Ticket>> bookTicket(int trainId, std::string passengerName, SeatRequest request, std::string travelDate = "");
+    Task<void> cancelTicket(int ticketId);
+    // read page by page , yielding between pages
+    Task<vector<Train>> listTrains();
+    Task<vector<Ticket>> listTickets();
+    // like RMSFacade::updateTrain , the promoted waiting passengers are booked a chunk at a time
+    Task<Train> updateTrain(int trainId, std::string name, int seats = 0);
+};
+
+#endif // RMS_ASYNCRMSFACADE_H
@@ -52,5 +52,10 @@ public:
 
     void cancel_ticket(const vector<string> &args);
     void book_ticket(const vector<string> &args);
+
+    // import <trains|passengers|tickets> <file> [errorReport]
+    void import_file(const vector<string> &args);
+    // export tickets <file|-> | export manifest <trainId|all> <file|-> [YYYY-MM-DD]
+    void export_file(const vector<string> &args);
 };
 #endif // RMS_CLICONTROLLER_H
@@ -0,0 +1,101 @@
+#ifndef RMS_LOADGENERATOR_H
+#define RMS_LOADGENERATOR_H
+
+#include "RMSFacade.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+
+enum class LoadOp
+{
+    Book,
+    Cancel,
+    Lookup,
+    List
+};
+constexpr int LOAD_OP_COUNT = 4;
+const char *loadOpName(LoadOp op);
+
+// relative weights of the operations a client picks from
+struct LoadMix
+{
+    int book = 60;
+    int cancel = 10;
+    int lookup = 25; // getTrain
+    int list = 5;    // listTrains
+};
+
+struct LoadOptions
+{
+    int threads = 4;          // closed loop : each client waits for its call before the next
+    int durationMs = 5000;    // measured part of the run
+    int warmupMs = 1000;      // run before it , not recorded
+    LoadMix mix;
+    double zipfSkew = 1.0;    // 0 = every train equally popular
+    int trains = 50;
+    int seatsPerTrain = 500;
+    int passengers = 2000;
+    unsigned seed = 42;
+};
+
+// ranks 1..n with P(k) ~ 1 / k^skew , one binary search over the cumulative weights per draw
+class ZipfDistribution
+{
+private:
+    std::vector<double> cdf;
+
+public:
+    ZipfDistribution(int n, double skew);
+    int operator()(std::mt19937_64 &rng) const;
+};
+
+// latency counts in log-linear buckets : exact below 64 ns , then 32 buckets per power of two
+// (about 3% error) . fixed size , so recording never allocates and merging is a sum
+class LatencyHistogram
+{
+private:
+    std::vector<long long> counts;
+    long long total = 0;
+    long long maxValue = 0;
+
+    static int indexOf(uint64_t ns);
+    static uint64_t upperBoundOf(int index);
+
+public:
+    LatencyHistogram();
+    void record(long long ns);
+    void merge(const LatencyHistogram &other);
+    long long count() const;
+    long long max() const;
+    long long percentile(double q) const; // ns , q in [0 , 1] , 0 when empty
+};
+
+struct LoadOpReport
+{
+    long long completed = 0;  // includes failed
+    long long failed = 0;     // the facade threw (duplicate booking , unknown ticket ...)
+    long long waitlisted = 0; // book only : no seat , passenger went to the waiting list
+    double p50Us = 0, p99Us = 0, p999Us = 0, maxUs = 0;
+};
+
+struct LoadReport
+{
+    double elapsedMs = 0; // measured part only
+    long long completed = 0;
+    LoadOpReport ops[LOAD_OP_COUNT];
+    double throughput() const; // calls per second
+};
+
+// adds the trains and passengers the run books against , ids and names come back
+struct LoadFixture
+{
+    std::vector<int> trainIds;             // by popularity rank , most popular first
+    std::vector<std::string> passengerNames;
+};
+LoadFixture prepareLoad(RMSFacade &facade, const LoadOptions &options);
+
+// runs options.threads clients against the facade until warmup + duration passed
+LoadReport runClosedLoop(RMSFacade &facade, const LoadFixture &fixture, const LoadOptions &options);
+
+#endif // RMS_LOADGENERATOR_H
@@ -11,6 +11,7 @@
 class RMSApp {
     std::unique_ptr<StartupManager> startupManager;
     std::unique_ptr<CLIController> cli;
+    std::string snapshotPath; // written again when the CLI exits
 public:
     RMSApp();
     ~RMSApp()= default;
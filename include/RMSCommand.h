@@ -16,6 +16,8 @@ public:
         TRAIN,
         PASSENGER,
         TICKET,
+        IMPORT,
+        EXPORT,
         SYSTEM,
         UNKNOWN
     };
@@ -10,6 +10,11 @@
 #include "Services/TicketService.h"
 #include "Services/PassengerService.h"
 #include "Services/TrainService.h"
+#include "Services/BookingPipeline.h"
+#include "Services/BulkImporter.h"
+#include "Services/BulkExporter.h"
+#include <memory>
+#include <future>
 
 class RMSFacade
 {
@@ -17,20 +22,32 @@ private:
     TrainService *trainService;
     TicketService *ticketService;
     PassengerService *passengerService;
+    std::unique_ptr<BookingPipeline> bookingPipeline; // created by enableAsyncBooking
+
+    BookingRequest makeBookingRequest(int trainId, const std::string &passengerName, const SeatRequest &request, const std::string &travelDate);
 
 public:
     RMSFacade(TrainService *ts, TicketService *tks, PassengerService *ps);
+    ~RMSFacade(); // drains the booking pipeline while the services are still alive
 
     // train features
     vector<Train> listTrains();
+    std::vector<TrainOccupancy> occupancyReport(); // every train , one snapshot
     Train addTrain(std::string name, int totalSeats);
     Train getTrain(int trainId);
     bool getTrainAvailability(int trainId);
     Train updateTrain(int trainId, const std::string &name, int seats = 0);
+    // updateTrain without the bookings : returns the waiting passengers the added seats went to ,
+    // each still to be booked with TicketService::promoteWaitingPassenger (AsyncRMSFacade spreads them out)
+    std::vector<std::pair<int, int>> resizeTrain(int trainId, const std::string &name, int seats = 0); // travel date , passenger
     Train addSeats(int trainId, int seats = 0);
     Train addSeats(const std::string &name, int seats = 0);
     void deleteTrain(int trainId);
-    void trainStatus(int trainId);
+    void trainStatus(int trainId, const std::string &travelDate = "");
+    int evictPastDepartures();
+    Train setCoachLayout(int trainId, const vector<CoachSpec> &coaches);
+    int getClassAvailability(int trainId, const std::string &seatClass, const std::string &travelDate = "");
+    Train tagSeats(int trainId, int fromSeat, int toSeat, unsigned attributes);
 
     // passenger features
     vector<Passenger> listPassengers();
@@ -41,8 +58,26 @@ public:
 
     // ticket features
     vector<Ticket> listTickets();
+    TicketReport ticketReport(); // counted over a snapshot , booking goes on meanwhile
     Ticket getTicket(int ticketId);
-    std::optional<Ticket> bookTicket(int trainId, const std::string &passengerName);
+    // travelDate is "YYYY-MM-DD" , empty books the train's undated inventory
+    std::optional<Ticket> bookTicket(int trainId, const std::string &passengerName, const SeatRequest &request = SeatRequest{}, const std::string &travelDate = "");
+    // asynchronous booking through a worker pool , same-train requests are booked in batches
+    void enableAsyncBooking(const BookingPipelineOptions &options = BookingPipelineOptions{});
+    std::future<std::optional<Ticket>> bookTicketAsync(int trainId, const std::string &passengerName, const SeatRequest &request = SeatRequest{}, const std::string &travelDate = "");
+    void bookTicketAsync(int trainId, const std::string &passengerName, BookingPipeline::Callback onDone, const SeatRequest &request = SeatRequest{}, const std::string &travelDate = "");
+    bool isAsyncBookingEnabled() const;
+    BookingPipelineStats getBookingPipelineStats() const;
     void cancelTicket(int ticketId);
+    SeatHold holdSeat(int trainId, const std::string &passengerName, int ttlSeconds, const SeatRequest &request = SeatRequest{}, const std::string &travelDate = "");
+    Ticket confirmHold(int holdId);
+    void releaseHold(int holdId);
+    int expireHolds();
+    DefragReport defragmentSeats(int trainId, const std::string &travelDate = "", bool apply = true, int maxSteps = 256);
+
+    // bulk import from a .csv / .jsonl file , validated on the ticket service's pool when it has one
+    ImportReport importFile(ImportKind kind, const std::string &path, const ImportOptions &options = ImportOptions{});
+    // streaming ticket export , format from the extension (.csv , .jsonl , .bin) , "-" is CSV on stdout
+    ExportReport exportTickets(const std::string &path, const ExportOptions &options = ExportOptions{});
 };
 #endif // RMS_RMSFACADE_H
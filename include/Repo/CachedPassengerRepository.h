@@ -0,0 +1,36 @@
+#ifndef RMS_CACHEDPASSENGERREPOSITORY_H
+#define RMS_CACHEDPASSENGERREPOSITORY_H
+
+#include "IPassengerRepository.h"
+#include "RecordCache.h"
+#include <memory>
+
+// passengers through a RecordCache , see CachedTrainRepository . a rename is written through
+// so findPassengerByName (the wrapped repository's name index) sees it at once
+class CachedPassengerRepository : public IPassengerRepository
+{
+private:
+    std::unique_ptr<IPassengerRepository> inner;
+    RecordCache<Passenger> cache; // declared after inner , its last flush still writes there
+
+    bool put(Passenger &passenger, bool checkVersion);
+    bool load(int passengerId);
+
+public:
+    CachedPassengerRepository(std::unique_ptr<IPassengerRepository> inner, const CacheOptions &options = CacheOptions{});
+    ~CachedPassengerRepository() override = default;
+
+    std::optional<Passenger> getPassenger(const int &passengerId) override;
+    bool deletePassenger(const int &passengerId) override;
+    void save(Passenger &passenger) override;
+    bool compareAndSave(Passenger &passenger) override;
+    void saveAll(vector<Passenger> &passengers) override;
+    vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string &name) override;
+    void clear() override;
+
+    void flush(); // writes every pending save now
+    CacheStats getCacheStats() const;
+};
+
+#endif // RMS_CACHEDPASSENGERREPOSITORY_H
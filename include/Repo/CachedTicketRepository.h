@@ -0,0 +1,45 @@
+#ifndef RMS_CACHEDTICKETREPOSITORY_H
+#define RMS_CACHEDTICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "RecordCache.h"
+#include <memory>
+
+// tickets through a RecordCache , see CachedTrainRepository . lookups by train / passenger ask
+// the wrapped repository's indexes and return the cached copies of what they find ; a save that
+// moves a ticket to another train , passenger or date is written through so those indexes stay
+// right . new tickets (saveAll of a booking batch) are inserted right away in one saveAll
+class CachedTicketRepository : public ITicketRepository
+{
+private:
+    std::unique_ptr<ITicketRepository> inner;
+    RecordCache<Ticket> cache; // declared after inner , its last flush still writes there
+
+    bool load(int ticketId);
+    std::optional<Ticket> current(std::optional<Ticket> stored);
+    bool put(Ticket &ticket, bool checkVersion);
+
+public:
+    CachedTicketRepository(std::unique_ptr<ITicketRepository> inner, const CacheOptions &options = CacheOptions{});
+    ~CachedTicketRepository() override = default;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    // the wrapped repository's snapshot after a flush , with its stored versions (see
+    // CachedTrainRepository::snapshot) : reread a ticket by id before a compareAndSave
+    Snapshot<Ticket> snapshot() override;
+    void clear() override;
+
+    void flush(); // writes every pending save now
+    CacheStats getCacheStats() const;
+};
+
+#endif // RMS_CACHEDTICKETREPOSITORY_H
@@ -0,0 +1,44 @@
+#ifndef RMS_CACHEDTRAINREPOSITORY_H
+#define RMS_CACHEDTRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include "RecordCache.h"
+#include <memory>
+
+// decorator keeping the hot trains of a storage-backed repository (SQLite , a log) in memory :
+// getTrainById is served from a RecordCache and saves are written behind , coalesced per train .
+// listings flush first and then read the wrapped repository . a new train is inserted right away
+// so it gets its id . versions are the cache's (see RecordCache) , only compare them with copies
+// read through this decorator
+class CachedTrainRepository : public ITrainRepository
+{
+private:
+    std::unique_ptr<ITrainRepository> inner;
+    mutable RecordCache<Train> cache; // declared after inner , its last flush still writes there
+
+    bool put(Train &train, bool checkVersion);
+    bool load(int trainId) const;
+
+public:
+    CachedTrainRepository(std::unique_ptr<ITrainRepository> inner, const CacheOptions &options = CacheOptions{});
+    ~CachedTrainRepository() override = default;
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    // the wrapped repository's snapshot after a flush . its versions are the stored ones , not
+    // the shifted ones this decorator hands out , so a train taken from it fails compareAndSave :
+    // read it again with getTrainById before changing it . translating every record would cost
+    // a copy of the table , the snapshot is meant for reads
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+
+    void flush(); // writes every pending save now
+    CacheStats getCacheStats() const;
+};
+
+#endif // RMS_CACHEDTRAINREPOSITORY_H
@@ -0,0 +1,75 @@
+#ifndef RMS_CHECKPOINTER_H
+#define RMS_CHECKPOINTER_H
+
+#include "DurableTrainRepository.h"
+#include "DurableTicketRepository.h"
+#include "DurablePassengerRepository.h"
+#include "WriteAheadLog.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+struct CheckpointOptions
+{
+    int intervalMs = 30000;      // between background checkpoints , bounds the log replayed on start
+    double rewriteRatio = 2.0;   // the checkpoint log is rewritten whole once it outgrows its last full size this much
+    long long minRewriteBytes = 1 << 20; // ... and this size
+};
+
+struct CheckpointStats
+{
+    long long checkpoints = 0;
+    long long fullRewrites = 0;
+    long long failures = 0;       // background checkpoints that threw , the next one is a full rewrite
+    long long records = 0;        // appended to the checkpoint log
+    long long walDiscarded = 0;   // bytes dropped from the head of the write-ahead log
+    long long walBytes = 0;       // what a restart replays after the checkpoint log
+    long long checkpointBytes = 0;
+    double lastMs = 0;
+    double maxMs = 0;
+};
+
+// incremental checkpoints of the Durable*Repository tables into a second log , so the
+// write-ahead log only has to keep what happened since the last one . a checkpoint holds the
+// writers back just long enough to take the ids they changed since the last checkpoint and the
+// write-ahead log's end , then appends those records as they are now (or their deletes) to the
+// checkpoint log , syncs it and drops everything before that end from the write-ahead log .
+// records read later than that end are newer , replaying the rest of the log over them lands
+// on the same state because every record is a whole row . once the checkpoint log has grown
+// rewriteRatio times past its last full size it is rewritten whole and its head dropped the same
+// way . recovery replays the checkpoint log , then the write-ahead log
+class Checkpointer
+{
+private:
+    DurableTrainRepository *trains;
+    DurableTicketRepository *tickets;
+    DurablePassengerRepository *passengers;
+    WriteAheadLog *wal;
+    WriteAheadLog *checkpointLog;
+    CheckpointOptions options;
+
+    std::mutex running; // one checkpoint at a time
+    long long fullBytes = 0; // checkpoint log size after the last full rewrite
+    bool rewriteNext = false; // a checkpoint failed , its dirty ids are lost : rewrite everything
+    mutable std::mutex mutex;
+    CheckpointStats stats;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread timer;
+
+    void run();
+
+public:
+    Checkpointer(DurableTrainRepository *trains, DurableTicketRepository *tickets, DurablePassengerRepository *passengers,
+                 WriteAheadLog *wal, WriteAheadLog *checkpointLog, const CheckpointOptions &options = CheckpointOptions{});
+    ~Checkpointer();
+    Checkpointer(const Checkpointer &) = delete;
+    Checkpointer &operator=(const Checkpointer &) = delete;
+
+    // one checkpoint now , throws what the logs throw
+    CheckpointStats checkpoint();
+    CheckpointStats getStats() const;
+};
+
+#endif // RMS_CHECKPOINTER_H
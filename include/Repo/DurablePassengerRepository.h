@@ -0,0 +1,43 @@
+#ifndef RMS_DURABLEPASSENGERREPOSITORY_H
+#define RMS_DURABLEPASSENGERREPOSITORY_H
+
+#include "IPassengerRepository.h"
+#include "WriteAheadLog.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// passengers logged to a WriteAheadLog , see DurableTrainRepository
+class DurablePassengerRepository : public IPassengerRepository
+{
+private:
+    std::unique_ptr<IPassengerRepository> inner;
+    WriteAheadLog *log;
+    std::mutex order;
+    DirtySet dirty; // under order
+
+    void logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                const std::function<void()> &undo);
+    void revert(int passengerId, const std::optional<Passenger> &before, long long written); // holding order
+
+public:
+    DurablePassengerRepository(std::unique_ptr<IPassengerRepository> inner, WriteAheadLog *log);
+    ~DurablePassengerRepository() override = default;
+
+    void apply(const WalRecord &record);
+    std::unique_lock<std::mutex> lockWrites();
+    DirtySet takeDirty(const std::unique_lock<std::mutex> &held);
+    size_t checkpoint(const DirtySet &changed, WriteAheadLog &to);
+    size_t checkpointAll(WriteAheadLog &to);
+
+    std::optional<Passenger> getPassenger(const int &passengerId) override;
+    bool deletePassenger(const int &passengerId) override;
+    void save(Passenger &passenger) override;
+    bool compareAndSave(Passenger &passenger) override;
+    void saveAll(vector<Passenger> &passengers) override;
+    vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string &name) override;
+    void clear() override;
+};
+
+#endif // RMS_DURABLEPASSENGERREPOSITORY_H
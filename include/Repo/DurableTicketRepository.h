@@ -0,0 +1,48 @@
+#ifndef RMS_DURABLETICKETREPOSITORY_H
+#define RMS_DURABLETICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "WriteAheadLog.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// tickets logged to a WriteAheadLog , see DurableTrainRepository . saveAll appends one record
+// per ticket and waits once for the last of them
+class DurableTicketRepository : public ITicketRepository
+{
+private:
+    std::unique_ptr<ITicketRepository> inner;
+    WriteAheadLog *log;
+    std::mutex order;
+    DirtySet dirty; // under order
+
+    void logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                const std::function<void()> &undo);
+    void revert(int ticketId, const std::optional<Ticket> &before, long long written); // holding order
+
+public:
+    DurableTicketRepository(std::unique_ptr<ITicketRepository> inner, WriteAheadLog *log);
+    ~DurableTicketRepository() override = default;
+
+    void apply(const WalRecord &record);
+    std::unique_lock<std::mutex> lockWrites();
+    DirtySet takeDirty(const std::unique_lock<std::mutex> &held);
+    size_t checkpoint(const DirtySet &changed, WriteAheadLog &to);
+    size_t checkpointAll(WriteAheadLog &to);
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override;
+    void clear() override;
+};
+
+#endif // RMS_DURABLETICKETREPOSITORY_H
@@ -0,0 +1,55 @@
+#ifndef RMS_DURABLETRAINREPOSITORY_H
+#define RMS_DURABLETRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include "WriteAheadLog.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// decorator logging every change of the wrapped repository to a WriteAheadLog . the change is
+// applied and its record appended under one lock , so the log holds the changes of one train
+// in the order they were made ; the wait for the disk happens after the lock is released . a
+// change whose record cannot be written is undone before the exception reaches the caller ,
+// its version moves on so copies read before it fail compareAndSave .
+// reads go straight to the wrapped repository
+class DurableTrainRepository : public ITrainRepository
+{
+private:
+    std::unique_ptr<ITrainRepository> inner;
+    WriteAheadLog *log;
+    std::mutex order;
+    DirtySet dirty; // under order
+
+    void logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                const std::function<void()> &undo);
+    void revert(int trainId, const std::optional<Train> &before, long long written); // holding order
+
+public:
+    DurableTrainRepository(std::unique_ptr<ITrainRepository> inner, WriteAheadLog *log);
+    ~DurableTrainRepository() override = default;
+
+    // replays one logged change into the wrapped repository without logging it again
+    void apply(const WalRecord &record);
+
+    // checkpoints (see Checkpointer) : lockWrites holds every change back , takeDirty hands over
+    // the ids changed since the last call ; checkpoint appends those records as they are now (a
+    // delete for the ones gone) to a checkpoint log , checkpointAll every record . both return
+    // how many records they appended
+    std::unique_lock<std::mutex> lockWrites();
+    DirtySet takeDirty(const std::unique_lock<std::mutex> &held);
+    size_t checkpoint(const DirtySet &changed, WriteAheadLog &to);
+    size_t checkpointAll(WriteAheadLog &to);
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+};
+
+#endif // RMS_DURABLETRAINREPOSITORY_H
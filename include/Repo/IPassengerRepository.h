@@ -8,6 +8,7 @@
 #include "../structures/vector.h"
 #include "../models/Passenger.h"
 #include <optional>
+#include <string>
 
 class IPassengerRepository
 {
@@ -15,7 +16,11 @@ public:
     virtual std::optional<Passenger> getPassenger(const int& passengerId) = 0;
     virtual bool deletePassenger(const int& passengerId) = 0;
     virtual void save( Passenger& passenger) = 0;
+    virtual bool compareAndSave(Passenger& passenger) = 0; // false when the stored version moved on
+    virtual void saveAll(vector<Passenger>& passengers) = 0; // one write for a batch , ids assigned like save
     virtual vector<Passenger> getAllPassengers() = 0;
+    // lowest id whose name equals name ignoring case
+    virtual std::optional<Passenger> findPassengerByName(const std::string& name) = 0;
     virtual void clear() = 0;
 
     virtual ~IPassengerRepository() = default;
@@ -9,15 +9,23 @@
 #include <optional>
 
 #include "../models/Ticket.h"
+#include "Snapshot.h"
 
 class ITicketRepository
 {
 public:
     virtual std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) = 0;
+    virtual std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) = 0;
+    virtual vector<Ticket> getTicketsByPassenger(int passengerId) = 0; // every train , id order
     virtual bool deleteTicket(int ticketId) = 0;
     virtual void save(Ticket& ticket) = 0;
+    virtual bool compareAndSave(Ticket& ticket) = 0; // false when the stored version moved on
+    virtual void saveAll(vector<Ticket>& tickets) = 0;   // one write for a batch , ids assigned like save
     virtual vector<Ticket> getAllTickets() = 0;
+    virtual vector<Ticket> getTicketsPage(int afterId, int limit) = 0; // id > afterId , id order
     virtual std::optional<Ticket> getTicketById(int) = 0;
+    // frozen view for long reads , writes continue while it is walked
+    virtual Snapshot<Ticket> snapshot() = 0;
     virtual void clear() = 0;
 
     virtual ~ITicketRepository() = default;
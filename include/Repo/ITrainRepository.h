@@ -3,14 +3,23 @@
 
 #include "../models/Train.h"
 #include "../structures/vector.h"
+#include "Snapshot.h"
 #include <optional>
 
 class ITrainRepository {
 public:
     virtual vector<Train> getAllTrains() const = 0;
+    // at most limit trains with id > afterId in id order , lets large listings be read in pages
+    virtual vector<Train> getTrainsPage(int afterId, int limit) const = 0;
     virtual bool deleteTrain(int) = 0;
     virtual void save(Train&) = 0;
+    // saves only if the stored version still equals train.getVersion() , false on a conflict .
+    // both save flavours write the new version back into the argument
+    virtual bool compareAndSave(Train&) = 0;
+    virtual void saveAll(vector<Train>& trains) = 0; // one write for a batch , ids assigned like save
     virtual std::optional<Train> getTrainById(const int& trainId) const   = 0;
+    // frozen view for long reads , writes continue while it is walked
+    virtual Snapshot<Train> snapshot() const = 0;
     virtual void clear() = 0;
     virtual ~ITrainRepository() = default;
 };
@@ -7,6 +7,9 @@
 
 #include "../structures/vector.h"
 #include <optional>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 
 #include "../models/Passenger.h"
 #include "../structures/map.h"
@@ -16,12 +19,19 @@ class InMemoryPassengerRepository : public IPassengerRepository
 {
 private:
     Map<int, Passenger> passengers;
-    int next_id = 1;
+    std::atomic<int> next_id{1};
+    mutable std::shared_mutex mutex; // many readers , one writer
+
+    void assignId(Passenger& passenger);
+    void store(Passenger& passenger, long long storedVersion); // caller holds the write lock
 public:
     std::optional<Passenger> getPassenger(const int& passengerId) override;
     bool deletePassenger(const int& passengerId) override;
     void save( Passenger& passenger) override;
+    bool compareAndSave(Passenger& passenger) override;
+    void saveAll(vector<Passenger>& batch) override;
     vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string& name) override; // a scan , no name index
     void clear() override;
 };
 #endif // RMS_INMEMORYPASSENGERREPOSITORY_H
@@ -7,25 +7,45 @@
 
 #include "../structures/vector.h"
 #include <optional>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 
-#include "../structures/map.h"
+#include "../structures/persistentMap.h"
+#include "../structures/unordered_map.h"
 #include "ITicketRepository.h"
+#include "Snapshot.h"
 #include "../models/Ticket.h"
 
 class InMemoryTicketRepository : public ITicketRepository
 {
 private:
-    Map<int, Ticket> tickets;
-    int next_id = 1;
+    Snapshot<Ticket>::Map tickets; // persistent , snapshot() shares it instead of copying
+    unordered_map<long long, vector<int>> byTrainPassenger; // (train , passenger) -> ticket ids
+    unordered_map<int, vector<int>> byPassenger;            // passenger -> ticket ids , ascending
+    std::atomic<int> next_id{1};
+    mutable std::shared_mutex mutex; // many readers , one writer
+
+    static long long indexKey(int trainId, int passengerId);
+    void unindex(const Ticket& ticket);
+    void assignId(Ticket& ticket);
+    void store(Ticket& ticket); // caller holds the write lock
 
 public:
     InMemoryTicketRepository() = default;
     ~InMemoryTicketRepository() override = default;
     std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
     bool deleteTicket(int ticketId) override;
     void save(Ticket& ticket) override;
+    bool compareAndSave(Ticket& ticket) override;
+    void saveAll(vector<Ticket>& tickets) override;
     vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
     std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override;
     void clear() override;
+    void discardAll(); // clear without the message , for callers clearing several repositories at once
 };
 #endif // RMS_INMEMORYTICKETREPOSITORY_H
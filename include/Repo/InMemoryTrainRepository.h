@@ -5,23 +5,36 @@
 #include "ITrainRepository.h"
 #include <optional>
 #include <map>
- #include "../structures/map.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include "../structures/persistentMap.h"
+#include "Snapshot.h"
 
 
 class InMemoryTrainRepository : public ITrainRepository {
 private:
-    Map<int, Train> trains;
-    int next_id = 1;
+    Snapshot<Train>::Map trains; // persistent , snapshot() shares it instead of copying
+    std::atomic<int> next_id{1};
+    mutable std::shared_mutex mutex; // many readers , one writer
+
+    void assignId(Train& train);
+    void store(Train& train, long long storedVersion); // caller holds the write lock
 
 public:
     InMemoryTrainRepository() = default;
     ~InMemoryTrainRepository() override = default;
 
     vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
     bool deleteTrain(int trainId) override;
     void  save( Train& newTrain) override;
+    bool compareAndSave(Train& train) override;
+    void saveAll(vector<Train>& batch) override;
     std::optional<Train> getTrainById(const int& trainId) const  override;
+    Snapshot<Train> snapshot() const override;
     void clear() override;
+    void discardAll(); // clear without the message , for callers clearing several repositories at once
 };
 
 #endif
\ No newline at end of file
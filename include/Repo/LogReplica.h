@@ -0,0 +1,85 @@
+#ifndef RMS_LOGREPLICA_H
+#define RMS_LOGREPLICA_H
+
+#include "LogShipper.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+struct ReplicaOptions
+{
+    bool fromFile = false; // path is a file a LogShipper appends to , not its socket
+    int retryMs = 50;      // between connection attempts , and between reads at the end of the file
+};
+
+struct ReplicaStats
+{
+    bool connected = false;
+    bool ready = false;          // the first snapshot is applied , reads see the primary's rows
+    long long connects = 0;
+    long long snapshots = 0;
+    long long records = 0;       // applied
+    long long messages = 0;
+    long long bytes = 0;         // received
+    uint64_t primaryPosition = 0; // the newest position the primary announced
+    uint64_t appliedPosition = 0; // every change the primary shipped before it is applied
+    double lagMs = 0;            // from the primary queueing the last batch to it being applied here
+    double maxLagMs = 0;
+    double stalenessMs = 0;      // since the primary sent the newest message applied : how old the view may be
+    uint64_t behindBytes() const { return primaryPosition > appliedPosition ? primaryPosition - appliedPosition : 0; }
+};
+
+// replica side of log shipping : reads what a LogShipper sends and applies it to its own
+// repositories on a background thread , reads go on meanwhile . a new connection starts with
+// the primary's rows ; they overwrite the replica's and the rows it had that the primary no
+// longer has are deleted after the last one , so reads never see an empty replica while it
+// catches up . a lost connection is retried every retryMs . writes must not reach these
+// repositories from anywhere else , StartupManager hands the services read-only ones
+class LogReplica
+{
+private:
+    ITrainRepository *trains;
+    ITicketRepository *tickets;
+    IPassengerRepository *passengers;
+    std::string path;
+    ReplicaOptions options;
+    int wakeFds[2] = {-1, -1};
+
+    // rows a snapshot carried , the others go at its end
+    bool resyncing = false;
+    std::unordered_set<int> seenTrains, seenTickets, seenPassengers;
+
+    mutable std::mutex mutex;
+    std::condition_variable progressed;
+    ReplicaStats stats;
+    uint64_t lastSentNs = 0;
+    bool stopping = false;
+    std::thread reader;
+
+    void run();
+    int connect();
+    void follow(int fd);
+    size_t handle(const char *data, size_t size);
+    void apply(const WalRecord &record);
+    void endSnapshot();
+    bool pause();
+
+public:
+    // starts following the LogShipper at path , the repositories are the replica's own
+    LogReplica(ITrainRepository *trains, ITicketRepository *tickets, IPassengerRepository *passengers,
+               const std::string &path, const ReplicaOptions &options = ReplicaOptions{});
+    ~LogReplica();
+    LogReplica(const LogReplica &) = delete;
+    LogReplica &operator=(const LogReplica &) = delete;
+
+    // false when timeoutMs passed first
+    bool waitUntilReady(int timeoutMs);
+    // a LogShipper::position , positions only compare within one run of the primary
+    bool waitForPosition(uint64_t position, int timeoutMs);
+    ReplicaStats getStats() const;
+};
+
+#endif // RMS_LOGREPLICA_H
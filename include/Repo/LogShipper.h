@@ -0,0 +1,108 @@
+#ifndef RMS_LOGSHIPPER_H
+#define RMS_LOGSHIPPER_H
+
+#include "ITrainRepository.h"
+#include "ITicketRepository.h"
+#include "IPassengerRepository.h"
+#include "WriteAheadLog.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// what goes down the wire , every message is kind , payload size , the primary's steady clock
+// when it was queued (ns , CLOCK_MONOTONIC on Linux : the same clock in every process of the host)
+// and the primary's position (log bytes shipped so far) , then the payload
+enum class ShipKind : uint8_t
+{
+    SnapshotBegin, // a replica's state starts over , the Put records of every row follow
+    Records,       // write-ahead log frames
+    SnapshotEnd,   // every row was sent , the ones the replica has and did not get are gone
+    Heartbeat      // nothing changed , the replica is current up to position
+};
+
+struct ShippingOptions
+{
+    bool toFile = false;           // path is a file the replica follows , not a Unix domain socket
+    int heartbeatMs = 100;         // how often an idle replica hears from the primary
+    size_t maxBufferBytes = 64 << 20; // a replica this far behind is cut off , it reconnects and starts over
+};
+
+struct ShippingStats
+{
+    long long replicas = 0;    // connected now
+    long long connects = 0;
+    long long dropped = 0;     // cut off for falling behind or going away
+    long long snapshots = 0;   // full states sent
+    long long batches = 0;     // log batches shipped
+    long long bytes = 0;       // sent , every replica counted
+    uint64_t position = 0;     // log bytes shipped so far
+};
+
+// primary side of log shipping : every batch the write-ahead log's flusher writes is passed on to
+// the replicas (LogReplica) listening on a Unix domain socket , or appended to a file one replica
+// follows . a replica that connects first gets the current rows as Put records , taken after it
+// was registered for the log , so whatever changed meanwhile reaches it twice ; every record is a
+// whole row , applying one again changes nothing . one thread does the accepting , the sending
+// (non-blocking) and the heartbeats , the flusher only appends to the replicas' buffers
+class LogShipper
+{
+private:
+    struct Replica
+    {
+        int fd = -1;
+        bool socket = true;
+        bool syncing = true;   // its snapshot is not out yet , the log waits in held
+        bool dropped = false;
+        std::string out;       // queued , under mutex
+        std::string held;
+        std::string writing;   // being sent , io thread only
+        size_t sent = 0;       // of writing
+    };
+
+    WriteAheadLog *wal;
+    ITrainRepository *trains;
+    ITicketRepository *tickets;
+    IPassengerRepository *passengers;
+    std::string path;
+    ShippingOptions options;
+    int listenFd = -1;
+    int wakeFds[2] = {-1, -1};
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Replica>> replicas;
+    ShippingStats stats;
+    bool stopping = false;
+    bool woken = false; // the io thread has a wake up coming
+    std::thread io;
+
+    void ship(const std::string &frames);
+    void run();
+    void wake();
+    void sendSnapshot(Replica &replica);
+    bool send(Replica &replica);
+    void queue(Replica &replica, ShipKind kind, const std::string &payload, uint64_t position);
+
+public:
+    // listens on path (or creates the file) and starts shipping wal's batches , the repositories
+    // are the primary's , read for the snapshot a new replica starts from
+    LogShipper(WriteAheadLog *wal, ITrainRepository *trains, ITicketRepository *tickets,
+               IPassengerRepository *passengers, const std::string &path, const ShippingOptions &options = ShippingOptions{});
+    ~LogShipper();
+    LogShipper(const LogShipper &) = delete;
+    LogShipper &operator=(const LogShipper &) = delete;
+
+    uint64_t position() const; // a replica that reached it has every change flushed so far
+    const std::string &getPath() const;
+    ShippingStats getStats() const;
+};
+
+// the message header , LogShipper writes it and LogReplica reads it
+constexpr size_t SHIP_HEADER = 1 + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+std::string shipHeader(ShipKind kind, uint32_t size, uint64_t sentNs, uint64_t position);
+uint64_t shipClockNs();
+
+#endif // RMS_LOGSHIPPER_H
@@ -0,0 +1,28 @@
+#ifndef RMS_READONLYPASSENGERREPOSITORY_H
+#define RMS_READONLYPASSENGERREPOSITORY_H
+
+#include "IPassengerRepository.h"
+#include <memory>
+
+// a replica's passengers , see ReadOnlyTrainRepository . booking by a new name fails here ,
+// it would create the passenger
+class ReadOnlyPassengerRepository : public IPassengerRepository
+{
+private:
+    std::unique_ptr<IPassengerRepository> inner;
+
+public:
+    explicit ReadOnlyPassengerRepository(std::unique_ptr<IPassengerRepository> inner);
+    ~ReadOnlyPassengerRepository() override = default;
+
+    std::optional<Passenger> getPassenger(const int &passengerId) override;
+    bool deletePassenger(const int &passengerId) override;
+    void save(Passenger &passenger) override;
+    bool compareAndSave(Passenger &passenger) override;
+    void saveAll(vector<Passenger> &passengers) override;
+    vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string &name) override;
+    void clear() override;
+};
+
+#endif // RMS_READONLYPASSENGERREPOSITORY_H
@@ -0,0 +1,31 @@
+#ifndef RMS_READONLYTICKETREPOSITORY_H
+#define RMS_READONLYTICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include <memory>
+
+// a replica's tickets , see ReadOnlyTrainRepository
+class ReadOnlyTicketRepository : public ITicketRepository
+{
+private:
+    std::unique_ptr<ITicketRepository> inner;
+
+public:
+    explicit ReadOnlyTicketRepository(std::unique_ptr<ITicketRepository> inner);
+    ~ReadOnlyTicketRepository() override = default;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override;
+    void clear() override;
+};
+
+#endif // RMS_READONLYTICKETREPOSITORY_H
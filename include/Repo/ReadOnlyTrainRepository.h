@@ -0,0 +1,29 @@
+#ifndef RMS_READONLYTRAINREPOSITORY_H
+#define RMS_READONLYTRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include <memory>
+
+// a replica's trains as the services see them : reads go to the wrapped repository , every
+// write throws std::logic_error . the LogReplica feeding the replica writes to the wrapped one
+class ReadOnlyTrainRepository : public ITrainRepository
+{
+private:
+    std::unique_ptr<ITrainRepository> inner;
+
+public:
+    explicit ReadOnlyTrainRepository(std::unique_ptr<ITrainRepository> inner);
+    ~ReadOnlyTrainRepository() override = default;
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+};
+
+#endif // RMS_READONLYTRAINREPOSITORY_H
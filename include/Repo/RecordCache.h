@@ -0,0 +1,421 @@
+#ifndef RMS_RECORDCACHE_H
+#define RMS_RECORDCACHE_H
+
+#include "../structures/vector.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct CacheOptions
+{
+    size_t capacity = 65536;  // records kept per repository , unflushed ones are never evicted
+    int flushIntervalMs = 20; // how long a save may live in memory only
+    size_t maxDirty = 8192;   // this many unflushed records wake the flusher early
+};
+
+struct CacheStats
+{
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    long long saves = 0;       // saves taken by the cache
+    long long coalesced = 0;   // saves that replaced a record still waiting for its flush
+    long long flushed = 0;     // records written to the wrapped repository
+    long long flushes = 0;     // batches written
+    long long flushErrors = 0; // background batches that threw , they stay dirty and are retried
+    size_t cached = 0;
+    size_t dirty = 0;
+    double oldestDirtyMs = 0;  // how long the oldest unflushed save has waited so far
+    double maxFlushLagMs = 0;  // longest a save waited for its flush
+    double hitRatio() const { return hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0; }
+};
+
+// bounded LRU cache with write-behind in front of a repository (the Cached*Repository
+// decorators) . a save of a cached record only replaces it in memory and marks it dirty ; a
+// flusher thread writes every dirty record every flushIntervalMs in one batch , so repeated
+// saves of one id between flushes reach the wrapped repository once .
+//
+// versions : the wrapped repository bumps its own version once per flush , not per save . the
+// cache hands out storedVersion << versionShift and counts saves up from there , a record read
+// back after its eviction therefore always carries a higher version than any copy handed out
+// before , so a stale copy can never pass compareAndSave . a save that would run into the next
+// stored version is written through instead
+//
+// one writer to the wrapped repository at a time (writeMutex , taken before the cache lock) :
+// flushes , deletes , clears and first inserts never overtake each other
+template <class T>
+class RecordCache
+{
+public:
+    static constexpr int versionShift = 20;
+    using Value = std::shared_ptr<const T>;
+    // saves the batch in the wrapped repository , leaving the stored versions in the records
+    using Writer = std::function<void(vector<T> &records)>;
+    enum class PutResult
+    {
+        Stored,
+        Conflict, // the copy's version is not the cached one
+        NotCached // load the record and try again
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Entry
+    {
+        Value value;
+        long long storedVersion = 0; // version of the record in the wrapped repository
+        bool dirty = false;
+        unsigned long long generation = 0; // bumped by every put , a flush only cleans what it wrote
+        Clock::time_point dirtySince;
+        std::list<int>::iterator position;
+        std::list<int>::iterator dirtyPosition; // in dirtyOrder while dirty
+    };
+
+    CacheOptions options;
+    Writer writer;
+    mutable std::mutex mutex;
+    std::unordered_map<int, Entry> entries;
+    std::list<int> recency; // most recently used first
+    std::list<int> dirtyOrder; // the dirty entries , oldest first : flush and getStats walk only these
+    unsigned long long removals = 0; // evictions and deletes , see fill
+    CacheStats stats;
+
+    std::mutex writeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread flusher;
+
+    static double msSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void touch(Entry &entry)
+    {
+        recency.splice(recency.begin(), recency, entry.position);
+    }
+
+    // caller holds mutex . dirty records in the way are moved to the front instead
+    void evict()
+    {
+        size_t looked = 0;
+        while (entries.size() > options.capacity && looked++ < entries.size())
+        {
+            int id = recency.back();
+            Entry &entry = entries.at(id);
+            if (entry.dirty)
+            {
+                touch(entry);
+                continue;
+            }
+            recency.pop_back();
+            entries.erase(id);
+            stats.evictions++;
+            removals++;
+        }
+    }
+
+    Entry &insert(int id, T stored)
+    {
+        Entry entry;
+        entry.storedVersion = stored.getVersion();
+        stored.setVersion(stored.getVersion() << versionShift);
+        entry.value = std::make_shared<const T>(std::move(stored));
+        recency.push_front(id);
+        entry.position = recency.begin();
+        return entries[id] = std::move(entry);
+    }
+
+    void markDirty(int id, Entry &entry)
+    {
+        entry.dirty = true;
+        entry.dirtySince = Clock::now();
+        entry.dirtyPosition = dirtyOrder.insert(dirtyOrder.end(), id);
+    }
+
+    void markClean(Entry &entry)
+    {
+        entry.dirty = false;
+        dirtyOrder.erase(entry.dirtyPosition);
+    }
+
+    void erase(int id)
+    {
+        auto it = entries.find(id);
+        if (it == entries.end())
+            return;
+        if (it->second.dirty)
+            markClean(it->second);
+        recency.erase(it->second.position);
+        entries.erase(it);
+        removals++;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping)
+        {
+            wake.wait_for(lock, std::chrono::milliseconds(options.flushIntervalMs),
+                          [&] { return stopping || dirtyOrder.size() >= options.maxDirty; });
+            if (dirtyOrder.empty())
+                continue;
+            lock.unlock();
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> count(mutex);
+                stats.flushErrors++; // the records stay dirty , the next round retries them
+            }
+            lock.lock();
+        }
+    }
+
+public:
+    RecordCache(const CacheOptions &options, Writer writer) : options(options), writer(std::move(writer))
+    {
+        if (options.capacity == 0 || options.flushIntervalMs <= 0 || options.maxDirty == 0)
+            throw std::invalid_argument("cache capacity , flush interval and dirty limit must be greater than zero");
+        flusher = std::thread([this] { run(); });
+    }
+
+    // the last flush happens here , the wrapped repository must still be alive
+    ~RecordCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // nowhere left to report it
+        }
+    }
+
+    RecordCache(const RecordCache &) = delete;
+    RecordCache &operator=(const RecordCache &) = delete;
+
+    // nullptr on a miss , token then goes to fill
+    Value find(int id, unsigned long long &token)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it == entries.end())
+        {
+            stats.misses++;
+            token = removals;
+            return nullptr;
+        }
+        stats.hits++;
+        touch(it->second);
+        return it->second.value;
+    }
+
+    // caches a record read from the wrapped repository after a miss and returns it as the cache
+    // hands it out . a record already cached in the meantime wins ; when anything was evicted or
+    // deleted since the miss the read may predate a flush , it is returned but not cached
+    Value fill(int id, T stored, unsigned long long token)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it != entries.end())
+        {
+            touch(it->second);
+            return it->second.value;
+        }
+        if (token != removals)
+        {
+            stored.setVersion(stored.getVersion() << versionShift);
+            return std::make_shared<const T>(std::move(stored));
+        }
+        Value value = insert(id, std::move(stored)).value;
+        evict();
+        return value;
+    }
+
+    // replaces a cached record , value gets its new version . checkVersion : only when
+    // value.getVersion() is the cached one (compareAndSave) . writeThrough(cached , next) true
+    // flushes before returning (a change the wrapped repository's indexes must see)
+    template <class WriteThrough>
+    PutResult put(int id, T &value, bool checkVersion, WriteThrough writeThrough)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it == entries.end())
+            return PutResult::NotCached;
+        Entry &entry = it->second;
+        long long current = entry.value->getVersion();
+        if (checkVersion && value.getVersion() != current)
+            return PutResult::Conflict;
+        long long next = current + 1;
+        bool flushNow = writeThrough(*entry.value, value) || next >= (entry.storedVersion + 1) << versionShift;
+        value.setVersion(next);
+
+        stats.saves++;
+        if (entry.dirty)
+            stats.coalesced++;
+        else
+            markDirty(id, entry);
+        entry.value = std::make_shared<const T>(value);
+        entry.generation++;
+        touch(entry);
+        bool wakeFlusher = dirtyOrder.size() >= options.maxDirty;
+        lock.unlock();
+
+        if (flushNow)
+            flush();
+        else if (wakeFlusher)
+            wake.notify_one();
+        return PutResult::Stored;
+    }
+
+    // records that are not in the wrapped repository yet : store(copies) inserts them there and
+    // assigns their ids / versions , then they are cached clean and values get ids and versions
+    template <class Store>
+    bool create(vector<T> &values, int (*idOf)(const T &), Store store)
+    {
+        std::lock_guard<std::mutex> write(writeMutex);
+        vector<T> copies = values;
+        if (!store(copies))
+            return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < copies.size(); i++)
+        {
+            int id = idOf(copies[i]);
+            erase(id);
+            values[i] = *insert(id, std::move(copies[i])).value;
+        }
+        evict();
+        return true;
+    }
+
+    template <class Store>
+    bool create(T &value, int (*idOf)(const T &), Store store)
+    {
+        vector<T> one;
+        one.push_back(value);
+        bool created = create(one, idOf, [&](vector<T> &copies) { return store(copies[0]); });
+        if (created)
+            value = one[0];
+        return created;
+    }
+
+    // drops the record , then removeStored() deletes it from the wrapped repository ; a flush
+    // can not write it back in between
+    template <class Remove>
+    bool remove(int id, Remove removeStored)
+    {
+        std::lock_guard<std::mutex> write(writeMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            erase(id);
+        }
+        return removeStored();
+    }
+
+    template <class Clear>
+    void clear(Clear clearStored)
+    {
+        std::lock_guard<std::mutex> write(writeMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+            recency.clear();
+            dirtyOrder.clear();
+            removals++;
+        }
+        clearStored();
+    }
+
+    // records read straight from the wrapped repository (listings) as the cache would hand them
+    // out : cached ones are replaced by the cached copy , the others get their version shifted .
+    // nothing is cached , a scan must not push the working set out
+    void translate(vector<T> &records, int (*idOf)(const T &))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            auto it = entries.find(idOf(records[i]));
+            if (it != entries.end())
+                records[i] = *it->second.value;
+            else
+                records[i].setVersion(records[i].getVersion() << versionShift);
+        }
+    }
+
+    // writes every dirty record now , in one batch . throws what the writer throws (the
+    // records stay dirty)
+    void flush()
+    {
+        std::lock_guard<std::mutex> write(writeMutex);
+        vector<T> batch;
+        std::vector<std::pair<int, unsigned long long>> written;
+        Clock::time_point oldest;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (dirtyOrder.empty())
+                return;
+            oldest = entries.at(dirtyOrder.front()).dirtySince;
+            for (int id : dirtyOrder)
+            {
+                const Entry &entry = entries.at(id);
+                batch.push_back(*entry.value);
+                written.emplace_back(id, entry.generation);
+            }
+        }
+
+        writer(batch);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < written.size(); i++)
+        {
+            auto it = entries.find(written[i].first);
+            if (it == entries.end())
+                continue;
+            Entry &entry = it->second;
+            entry.storedVersion = batch[i].getVersion();
+            if (entry.generation == written[i].second)
+                markClean(entry); // saved again meanwhile : stays dirty for the next round
+        }
+        stats.flushed += (long long)written.size();
+        stats.flushes++;
+        stats.maxFlushLagMs = std::max(stats.maxFlushLagMs, msSince(oldest));
+        evict();
+    }
+
+    CacheStats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CacheStats current = stats;
+        current.cached = entries.size();
+        current.dirty = dirtyOrder.size();
+        if (!dirtyOrder.empty())
+            current.oldestDirtyMs = msSince(entries.at(dirtyOrder.front()).dirtySince);
+        return current;
+    }
+
+    const CacheOptions &getOptions() const
+    {
+        return options;
+    }
+};
+
+#endif // RMS_RECORDCACHE_H
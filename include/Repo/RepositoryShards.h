@@ -0,0 +1,64 @@
+#ifndef RMS_REPOSITORYSHARDS_H
+#define RMS_REPOSITORYSHARDS_H
+
+#include "InMemoryTrainRepository.h"
+#include "InMemoryTicketRepository.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+
+// trains and their tickets partitioned by train id : shard k owns every train with
+// shardOf(trainId) == k , the tickets of those trains and the indexes over them , each
+// behind its own locks . ShardedTrainRepository and ShardedTicketRepository are two views
+// of one RepositoryShards , the caller owns it and keeps it alive as long as they are used
+class RepositoryShards
+{
+public:
+    struct Shard
+    {
+        InMemoryTrainRepository trains;
+        InMemoryTicketRepository tickets;
+        std::atomic<int> nextTicketSeq{0}; // ids handed out here are seq * count + index + 1
+    };
+
+private:
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<int> nextTrainId{1};
+
+public:
+    explicit RepositoryShards(int count = 16);
+    RepositoryShards(const RepositoryShards &) = delete;
+    RepositoryShards &operator=(const RepositoryShards &) = delete;
+
+    int count() const;
+    Shard &shard(int index);
+
+    // train ids are handed out in sequence , so the modulo spreads them evenly
+    int shardOf(int trainId) const;
+    // shard that handed the ticket id out , where it lives unless the caller chose the id
+    int homeOfTicket(int ticketId) const;
+
+    int nextTrainIdFor();
+    void reserveTrainId(int trainId); // caller chosen id , later ones skip past it
+    int nextTicketIdFor(int shardIndex);
+    void reserveTicketId(int ticketId);
+    void resetTrainIds();  // after the train view cleared every shard
+    void resetTicketIds(); // after the ticket view cleared every shard
+
+    // one result per shard -> a single list in id order , cut to limit when limit >= 0
+    template <class T, class IdOf>
+    static vector<T> mergeById(std::vector<vector<T>> &parts, IdOf idOf, int limit = -1)
+    {
+        vector<T> merged;
+        for (auto &part : parts)
+            for (auto &item : part)
+                merged.push_back(std::move(item));
+        std::sort(merged.begin(), merged.end(), [&](const T &a, const T &b) { return idOf(a) < idOf(b); });
+        while (limit >= 0 && (int)merged.size() > limit)
+            merged.pop_back();
+        return merged;
+    }
+};
+
+#endif // RMS_REPOSITORYSHARDS_H
@@ -0,0 +1,38 @@
+#ifndef RMS_SHARDEDTICKETREPOSITORY_H
+#define RMS_SHARDEDTICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "RepositoryShards.h"
+
+// tickets live in the shard of their train , next to it . ids are handed out by that
+// shard so an id leads straight back to it ; ids chosen by the caller are found by
+// asking the other shards . passenger lookups and listings merge every shard
+class ShardedTicketRepository : public ITicketRepository
+{
+private:
+    RepositoryShards *shards;
+
+    InMemoryTicketRepository &shardFor(int trainId);
+    int locate(int ticketId); // shard holding the ticket , -1 when none does
+    // id assignment , and the shard the ticket must be written to
+    int prepare(Ticket &ticket);
+
+public:
+    explicit ShardedTicketRepository(RepositoryShards *shards);
+    ~ShardedTicketRepository() override = default;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override;
+    void clear() override;
+};
+
+#endif // RMS_SHARDEDTICKETREPOSITORY_H
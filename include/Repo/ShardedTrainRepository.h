@@ -0,0 +1,32 @@
+#ifndef RMS_SHARDEDTRAINREPOSITORY_H
+#define RMS_SHARDEDTRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include "RepositoryShards.h"
+
+// trains spread over RepositoryShards by id : single-train operations touch one shard ,
+// listings merge every shard in id order
+class ShardedTrainRepository : public ITrainRepository
+{
+private:
+    RepositoryShards *shards;
+
+    InMemoryTrainRepository &shardFor(int trainId);
+    void assignId(Train &train);
+
+public:
+    explicit ShardedTrainRepository(RepositoryShards *shards);
+    ~ShardedTrainRepository() override = default;
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+};
+
+#endif // RMS_SHARDEDTRAINREPOSITORY_H
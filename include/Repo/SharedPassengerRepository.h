@@ -0,0 +1,31 @@
+#ifndef RMS_SHAREDPASSENGERREPOSITORY_H
+#define RMS_SHAREDPASSENGERREPOSITORY_H
+
+#include "IPassengerRepository.h"
+#include "SharedSegment.h"
+
+// passengers in a SharedSegment , ids are handed out by the segment so two processes
+// registering passengers at the same time never give out the same id
+class SharedPassengerRepository : public IPassengerRepository
+{
+private:
+    SharedSegment *segment;
+
+    bool storeLocked(Passenger &passenger, bool checkVersion);
+    bool write(Passenger &passenger, bool checkVersion);
+
+public:
+    explicit SharedPassengerRepository(SharedSegment *segment);
+    ~SharedPassengerRepository() override = default;
+
+    std::optional<Passenger> getPassenger(const int &passengerId) override;
+    bool deletePassenger(const int &passengerId) override;
+    void save(Passenger &passenger) override;
+    bool compareAndSave(Passenger &passenger) override;
+    void saveAll(vector<Passenger> &passengers) override;
+    vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string &name) override; // a scan under the lock
+    void clear() override;
+};
+
+#endif // RMS_SHAREDPASSENGERREPOSITORY_H
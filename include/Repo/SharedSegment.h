@@ -0,0 +1,133 @@
+#ifndef RMS_SHAREDSEGMENT_H
+#define RMS_SHAREDSEGMENT_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <pthread.h>
+
+// sizes fixed when the segment is created , every process opening it later gets the same
+struct SharedSegmentOptions
+{
+    int maxTrains = 4096;        // highest train id
+    int maxTickets = 1 << 18;    // highest ticket id
+    int maxPassengers = 1 << 16; // highest passenger id
+    size_t heapBytes = 64u << 20; // encoded records
+};
+
+enum class SharedTable
+{
+    Trains,
+    Tickets,
+    Passengers
+};
+
+// one POSIX shared-memory object holding the records of the Shared* repositories , mapped by
+// every RMS process on the host . nothing inside holds a pointer : tables are arrays indexed by
+// id , records are ByteWriter bytes in a heap addressed by offsets from the start of the mapping ,
+// so each process may map it at a different address . one process-shared robust mutex guards
+// the whole segment . a process dying while holding it does not wedge the others : the next
+// one to lock finishes the slot write it journaled and rebuilds the free lists and ticket
+// indexes from the slots , or poisons the segment when the slots do not hold up
+class SharedSegment
+{
+public:
+    // one record : where its bytes are and the fields the indexes need without decoding them
+    struct Slot
+    {
+        int32_t used;
+        int32_t trainId;     // tickets only
+        int32_t passengerId; // tickets only
+        int32_t travelDate;  // tickets only
+        int32_t next;        // tickets : next ticket id of the same (train , passenger) , 0 ends
+        int32_t nextOfPassenger; // tickets : next ticket id of the same passenger , 0 ends
+        int64_t version;
+        uint64_t blob;       // heap offset , 0 when empty
+        uint32_t blobSize;
+    };
+
+    // the ticket fields the indexes are built from , written together with the record
+    struct TicketKeys
+    {
+        int32_t trainId;
+        int32_t passengerId;
+        int32_t travelDate;
+    };
+
+    struct Header;
+
+    // the segment lock , held for a whole read or read-modify-write . throws std::runtime_error
+    // when the segment is poisoned
+    class Guard
+    {
+    private:
+        SharedSegment *segment;
+
+    public:
+        explicit Guard(SharedSegment *segment);
+        ~Guard();
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+    };
+
+private:
+    std::string name;
+    void *base = nullptr;
+    size_t mappedSize = 0;
+    bool creator = false;
+
+    Header *header() const;
+    template <class T>
+    T *at(uint64_t offset) const { return reinterpret_cast<T *>(static_cast<char *>(base) + offset); }
+    void initialize(const SharedSegmentOptions &options);
+    uint64_t allocate(size_t bytes);
+    void release(uint64_t offset);
+    void writeSlot(SharedTable table, int id, const Slot &after); // journaled
+    bool recover();
+    struct IndexEntry;
+    IndexEntry *findEntry(int trainId, int passengerId, bool insert);
+    int32_t *passengerHead(int passengerId); // nullptr when the id is outside the passenger table
+    void linkTicket(int ticketId);
+    void unlinkTicket(int ticketId);
+
+public:
+    // opens the segment , creating and laying it out when it does not exist yet
+    explicit SharedSegment(const std::string &name, const SharedSegmentOptions &options = SharedSegmentOptions{});
+    ~SharedSegment();
+    SharedSegment(const SharedSegment &) = delete;
+    SharedSegment &operator=(const SharedSegment &) = delete;
+
+    // removes the name , processes that mapped it keep their mapping
+    static void remove(const std::string &name);
+
+    const std::string &getName() const;
+    bool isCreator() const; // this process created the segment (and should seed it)
+    size_t getHeapUsed() const;
+    long long getRecoveries() const; // locks taken over from a dead holder and repaired
+
+    Guard lock();
+
+    // everything below expects the caller to hold lock()
+    int capacity(SharedTable table) const;
+    Slot *slot(SharedTable table, int id); // nullptr when id is outside the table
+    int highestId(SharedTable table) const; // largest id ever stored , bounds scans
+    int takeNextId(SharedTable table);
+    void reserveId(SharedTable table, int id); // next id moves past an id chosen by the caller
+    void resetTable(SharedTable table);
+
+    // writes bytes as record id with version stored + 1 and returns that version ,
+    // -1 when expectedVersion is not -1 and differs from the stored one (0 = absent) .
+    // a ticket is indexed under keys
+    long long store(SharedTable table, int id, const std::string &bytes, long long expectedVersion = -1,
+                    const TicketKeys &keys = TicketKeys{});
+    bool erase(SharedTable table, int id);
+    std::string readBlob(const Slot &slot) const;
+
+    // tickets by (train , passenger) : a chain through Slot::next in id order
+    int firstTicketOf(int trainId, int passengerId);
+    // tickets by passenger : a chain through Slot::nextOfPassenger in id order ,
+    // -1 when the id is outside the passenger table and so not indexed
+    int firstTicketOfPassenger(int passengerId);
+};
+
+#endif // RMS_SHAREDSEGMENT_H
@@ -0,0 +1,36 @@
+#ifndef RMS_SHAREDTICKETREPOSITORY_H
+#define RMS_SHAREDTICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "SharedSegment.h"
+
+// tickets in a SharedSegment . the (train , passenger) index lives in the segment too , so a
+// booking in one process sees the tickets written by the others
+class SharedTicketRepository : public ITicketRepository
+{
+private:
+    SharedSegment *segment;
+
+    std::optional<Ticket> readLocked(int ticketId);           // caller holds the segment lock
+    bool storeLocked(Ticket &ticket, bool checkVersion);       // same
+    void assignId(Ticket &ticket);
+
+public:
+    explicit SharedTicketRepository(SharedSegment *segment);
+    ~SharedTicketRepository() override = default;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override; // walks the passenger's chain
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override; // copies every record out under the lock
+    void clear() override;
+};
+
+#endif // RMS_SHAREDTICKETREPOSITORY_H
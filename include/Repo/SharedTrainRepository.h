@@ -0,0 +1,35 @@
+#ifndef RMS_SHAREDTRAINREPOSITORY_H
+#define RMS_SHAREDTRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include "SharedSegment.h"
+
+// trains in a SharedSegment , seen and changed by every process mapping it . a save encodes
+// the train outside the segment lock and copies the bytes in under it ; compareAndSave checks
+// the stored version in the same critical section , which is what keeps two processes from
+// selling the same seat : the loser's save fails and TrainService retries on fresh state
+class SharedTrainRepository : public ITrainRepository
+{
+private:
+    SharedSegment *segment;
+
+    bool storeLocked(Train &train, const std::string &bytes, bool checkVersion);
+    bool write(Train &train, bool checkVersion);
+
+public:
+    explicit SharedTrainRepository(SharedSegment *segment);
+    ~SharedTrainRepository() override = default;
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    // copies every record out under the lock , not O(1) like the in-memory snapshot
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+};
+
+#endif // RMS_SHAREDTRAINREPOSITORY_H
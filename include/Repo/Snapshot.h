@@ -0,0 +1,145 @@
+#ifndef RMS_SNAPSHOT_H
+#define RMS_SNAPSHOT_H
+
+#include "../structures/persistentMap.h"
+#include "../structures/vector.h"
+#include "../utils/WorkStealingPool.h"
+#include <memory>
+#include <vector>
+#include <climits>
+
+// frozen read view of a repository : taking one copies a root pointer under the repository
+// lock and nothing else , writes that follow build new versions beside it . a listing or a
+// report walks the snapshot without any lock , so it neither blocks writers nor sees a
+// half-applied write . the data it sees stays alive as long as the snapshot does
+template <class T>
+class Snapshot
+{
+public:
+    using Map = PersistentMap<int, std::shared_ptr<const T>>;
+
+private:
+    std::vector<Map> parts; // one per shard , ids never repeat across parts
+
+    // records with id >= firstId in id order , fn returns false to stop
+    template <class Fn>
+    void walk(int firstId, Fn fn) const
+    {
+        std::vector<typename Map::Iterator> cursors;
+        for (const auto &part : parts)
+            cursors.push_back(part.lowerBound(firstId));
+        while (true)
+        {
+            int next = -1;
+            for (int i = 0; i < (int)cursors.size(); i++)
+                if (!cursors[i].done() && (next == -1 || cursors[i].key() < cursors[next].key()))
+                    next = i;
+            if (next == -1 || !fn(*cursors[next].value()))
+                return;
+            ++cursors[next];
+        }
+    }
+
+public:
+    Snapshot() = default;
+    explicit Snapshot(Map map) { parts.push_back(std::move(map)); }
+    explicit Snapshot(std::vector<Map> maps) : parts(std::move(maps)) {}
+
+    // one view over snapshots of disjoint id sets (the shards of a repository)
+    static Snapshot combine(const std::vector<Snapshot> &snapshots)
+    {
+        Snapshot all;
+        for (const auto &snap : snapshots)
+            for (const auto &part : snap.parts)
+                all.parts.push_back(part);
+        return all;
+    }
+
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &part : parts)
+            total += part.size();
+        return total;
+    }
+
+    // highest id in the snapshot , 0 when it is empty
+    int lastId() const
+    {
+        int last = 0;
+        for (const auto &part : parts)
+            if (!part.empty())
+                last = std::max(last, part.at(part.size() - 1).key());
+        return last;
+    }
+
+    // nullptr when the id is not in the snapshot , valid while the snapshot is
+    const T *find(int id) const
+    {
+        for (const auto &part : parts)
+            if (const auto *found = part.find(id))
+                return found->get();
+        return nullptr;
+    }
+
+    // every record in id order
+    template <class Fn>
+    void forEach(Fn fn) const
+    {
+        walk(INT_MIN, [&](const T &record) {
+            fn(record);
+            return true;
+        });
+    }
+
+    // fold over every record , cut into blocks of grain positions that run on the pool .
+    // step(acc , record) -> acc inside a block , combine(a , b) -> acc across blocks ;
+    // records reach step in no particular order
+    template <class R, class Step, class Combine>
+    R reduce(WorkStealingPool &pool, R identity, Step step, Combine combine, size_t grain = 4096) const
+    {
+        std::vector<size_t> starts; // global position of each part's first record
+        size_t total = 0;
+        for (const auto &part : parts)
+        {
+            starts.push_back(total);
+            total += part.size();
+        }
+        return pool.parallelReduce(0, total, grain, identity, [&](size_t lo, size_t hi) {
+            R acc = identity;
+            for (size_t p = 0; p < parts.size() && lo < hi; p++)
+            {
+                size_t partEnd = starts[p] + parts[p].size();
+                if (lo >= partEnd)
+                    continue;
+                size_t count = std::min(hi, partEnd) - lo;
+                auto it = parts[p].at(lo - starts[p]);
+                for (size_t k = 0; k < count; k++, ++it)
+                    acc = step(std::move(acc), *it.value());
+                lo += count;
+            }
+            return acc;
+        }, combine);
+    }
+
+    vector<T> page(int afterId, int limit) const
+    {
+        vector<T> result;
+        if (limit <= 0)
+            return result;
+        walk(afterId + 1, [&](const T &record) {
+            result.push_back(record);
+            return (int)result.size() < limit;
+        });
+        return result;
+    }
+
+    vector<T> toVector() const
+    {
+        vector<T> result;
+        forEach([&](const T &record) { result.push_back(record); });
+        return result;
+    }
+};
+
+#endif // RMS_SNAPSHOT_H
@@ -0,0 +1,110 @@
+#ifndef RMS_SNAPSHOTFILE_H
+#define RMS_SNAPSHOTFILE_H
+
+#include "ITrainRepository.h"
+#include "ITicketRepository.h"
+#include "IPassengerRepository.h"
+#include "Snapshot.h"
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <future>
+
+// a snapshot file is one header and five 8-byte aligned sections :
+//   tickets     fixed-size SnapshotTicketRecord , id order
+//   passengers  fixed-size SnapshotPassengerRecord , id order
+//   train index fixed-size SnapshotTrainRecord , id order
+//   train blobs Train::encode bytes (seat bitmaps , waiting list , holds , departures)
+//   strings     names , one copy per passenger shared by that passenger's tickets
+// integers are in host byte order , the file is meant to be mapped back on the same machine
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 2; // 2 : seat attributes carry which seats were tagged explicitly
+
+struct SnapshotTicketRecord
+{
+    int32_t id;
+    int32_t trainId;
+    int32_t passengerId;
+    int32_t seat;
+    int32_t travelDate;
+    int32_t status; // Status
+    uint32_t nameOffset; // passenger name in the string section
+    uint32_t nameLength;
+};
+
+struct SnapshotPassengerRecord
+{
+    int32_t id;
+    uint32_t nameLength;
+    uint64_t nameOffset;
+};
+
+struct SnapshotTrainRecord
+{
+    int32_t id;
+    uint32_t size;   // bytes of its blob
+    uint64_t offset; // in the train blob section
+};
+
+struct SnapshotFileHeader; // magic , format version , section table
+
+struct SnapshotFileStats
+{
+    long long trains = 0;
+    long long passengers = 0;
+    long long tickets = 0;
+    long long bytes = 0;
+    double ms = 0;
+};
+
+// writes the three views to path , through path + ".tmp" and a rename so a reader never maps a
+// half-written file . the views are frozen , so the repositories keep taking writes meanwhile
+SnapshotFileStats writeSnapshotFile(const std::string &path, const Snapshot<Train> &trains,
+                                    const vector<Passenger> &passengers, const Snapshot<Ticket> &tickets);
+
+// the same on a background thread , the views are copied into it (O(1) for trains and tickets)
+std::future<SnapshotFileStats> writeSnapshotFileAsync(const std::string &path, Snapshot<Train> trains,
+                                                      vector<Passenger> passengers, Snapshot<Ticket> tickets);
+
+// read-only mapping of a snapshot file . opening it checks the header and the section bounds and
+// nothing else , records are read in place : ticketRecord / passengerRecord cost a pointer
+// offset , only trains are decoded . throws std::runtime_error on a file it cannot use
+class MappedSnapshot
+{
+private:
+    void *base = nullptr;
+    size_t mappedSize = 0;
+
+    const SnapshotFileHeader *header() const;
+    template <class T>
+    const T *section(uint64_t offset) const { return reinterpret_cast<const T *>(static_cast<const char *>(base) + offset); }
+
+public:
+    explicit MappedSnapshot(const std::string &path);
+    ~MappedSnapshot();
+    MappedSnapshot(const MappedSnapshot &) = delete;
+    MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+    uint32_t getFormatVersion() const;
+    size_t getSize() const;
+
+    size_t trainCount() const;
+    const SnapshotTrainRecord &trainRecord(size_t index) const;
+    Train train(size_t index) const;
+
+    size_t passengerCount() const;
+    const SnapshotPassengerRecord &passengerRecord(size_t index) const;
+    Passenger passenger(size_t index) const;
+
+    size_t ticketCount() const;
+    const SnapshotTicketRecord &ticketRecord(size_t index) const;
+    Ticket ticket(size_t index) const;
+
+    // a name in the string section , throws when it runs past the section
+    std::string_view string(uint64_t offset, uint32_t length) const;
+
+    // saves every record into the repositories , ids kept ; tickets go in batches through saveAll
+    void restore(ITrainRepository &trains, IPassengerRepository &passengers, ITicketRepository &tickets) const;
+};
+
+#endif // RMS_SNAPSHOTFILE_H
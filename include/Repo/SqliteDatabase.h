@@ -0,0 +1,93 @@
+#ifndef RMS_SQLITEDATABASE_H
+#define RMS_SQLITEDATABASE_H
+
+#include <mutex>
+#include <string>
+#include <string_view>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+struct SqliteOptions
+{
+    bool fullSync = false;     // false : synchronous=NORMAL , a commit survives a crash of the process but not of the machine
+    int cacheMb = 64;          // page cache of the connection
+    int busyTimeoutMs = 5000;  // another process holding the write lock is waited for this long
+};
+
+// one SQLite connection in WAL journal mode shared by the Sqlite*Repository classes . SQLite
+// serializes writers anyway , so the connection is used by one caller at a time (lock) and
+// every repository keeps its statements prepared for as long as it lives . errors throw
+// std::runtime_error with the SQLite message
+class SqliteDatabase
+{
+private:
+    sqlite3 *db = nullptr;
+    std::string path;
+    std::mutex mutex;
+
+public:
+    // ":memory:" is a private in-memory database
+    explicit SqliteDatabase(const std::string &path, const SqliteOptions &options = SqliteOptions{});
+    ~SqliteDatabase(); // after the repositories , their statements must be finalized first
+    SqliteDatabase(const SqliteDatabase &) = delete;
+    SqliteDatabase &operator=(const SqliteDatabase &) = delete;
+
+    void execute(const char *sql);  // statements without results , schema and pragmas
+    std::unique_lock<std::mutex> lock(); // held around every use of the connection
+    sqlite3 *handle() const;
+    int changes() const; // rows changed by the last statement
+    const std::string &getPath() const;
+    [[noreturn]] void fail(const std::string &what) const;
+
+    // BEGIN IMMEDIATE ... COMMIT , rolled back when it goes out of scope uncommitted . the
+    // caller holds the lock for the whole transaction
+    class Transaction
+    {
+    private:
+        SqliteDatabase &database;
+        bool done = false;
+
+    public:
+        explicit Transaction(SqliteDatabase &database);
+        ~Transaction();
+        void commit();
+    };
+};
+
+// prepared statement , reset (bindings cleared) by each use's Scope so no statement keeps a read
+// transaction open between calls . bind indexes start at 1 , column indexes at 0
+class SqliteStatement
+{
+private:
+    SqliteDatabase *database;
+    sqlite3_stmt *stmt = nullptr;
+
+public:
+    SqliteStatement(SqliteDatabase *database, const char *sql);
+    ~SqliteStatement();
+    SqliteStatement(const SqliteStatement &) = delete;
+    SqliteStatement &operator=(const SqliteStatement &) = delete;
+
+    struct Scope
+    {
+        SqliteStatement &statement;
+        ~Scope() { statement.reset(); }
+    };
+    Scope use() { return Scope{*this}; }
+
+    SqliteStatement &bind(int index, int value);
+    SqliteStatement &bind(int index, long long value);
+    SqliteStatement &bind(int index, std::string_view text);
+    SqliteStatement &bindBlob(int index, std::string_view bytes);
+    SqliteStatement &bindNull(int index);
+    bool step(); // true with a row , false when done
+    void reset();
+
+    int columnInt(int column) const;
+    long long columnLong(int column) const;
+    std::string columnText(int column) const;
+    std::string_view columnBlob(int column) const; // valid until the next step or reset
+};
+
+#endif // RMS_SQLITEDATABASE_H
@@ -0,0 +1,33 @@
+#ifndef RMS_SQLITEPASSENGERREPOSITORY_H
+#define RMS_SQLITEPASSENGERREPOSITORY_H
+
+#include "IPassengerRepository.h"
+#include "SqliteDatabase.h"
+
+// passengers in a SQLite table with a case-insensitive index on the name , so
+// findPassengerByName (booking by name) is an index lookup instead of a scan of everyone
+class SqlitePassengerRepository : public IPassengerRepository
+{
+private:
+    SqliteDatabase *database;
+    SqliteStatement selectById, selectAll, selectByName;
+    SqliteStatement upsert, insertNew, updateIfVersion, remove, removeAll;
+
+    static Passenger read(const SqliteStatement &row); // id , version , name
+    bool write(SqliteStatement &statement, Passenger &passenger, bool conditional);
+
+public:
+    explicit SqlitePassengerRepository(SqliteDatabase *database);
+    ~SqlitePassengerRepository() override = default;
+
+    std::optional<Passenger> getPassenger(const int &passengerId) override;
+    bool deletePassenger(const int &passengerId) override;
+    void save(Passenger &passenger) override;
+    bool compareAndSave(Passenger &passenger) override;
+    void saveAll(vector<Passenger> &passengers) override;
+    vector<Passenger> getAllPassengers() override;
+    std::optional<Passenger> findPassengerByName(const std::string &name) override;
+    void clear() override;
+};
+
+#endif // RMS_SQLITEPASSENGERREPOSITORY_H
@@ -0,0 +1,42 @@
+#ifndef RMS_SQLITETICKETREPOSITORY_H
+#define RMS_SQLITETICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "SqliteDatabase.h"
+
+// tickets in a SQLite table : the columns the lookups filter on (train , passenger , date) are
+// indexed , the ticket itself is its Ticket::encode blob . saveAll writes a batch in one
+// transaction , one commit (one -wal append and sync) for the whole batch
+class SqliteTicketRepository : public ITicketRepository
+{
+private:
+    SqliteDatabase *database;
+    SqliteStatement selectById, selectAll, selectPage, selectByPassenger;
+    SqliteStatement selectByTrainPassenger, selectByTrainPassengerDate;
+    SqliteStatement upsert, insertNew, updateIfVersion, remove, removeAll;
+
+    static Ticket read(const SqliteStatement &row); // id , version , body
+    bool write(SqliteStatement &statement, Ticket &ticket, bool conditional);
+    std::optional<Ticket> first(SqliteStatement &statement);
+    vector<Ticket> all(SqliteStatement &statement);
+
+public:
+    explicit SqliteTicketRepository(SqliteDatabase *database);
+    ~SqliteTicketRepository() override = default;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    // read out of the table into memory , a copy rather than a shared view
+    Snapshot<Ticket> snapshot() override;
+    void clear() override;
+};
+
+#endif // RMS_SQLITETICKETREPOSITORY_H
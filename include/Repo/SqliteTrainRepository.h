@@ -0,0 +1,37 @@
+#ifndef RMS_SQLITETRAINREPOSITORY_H
+#define RMS_SQLITETRAINREPOSITORY_H
+
+#include "ITrainRepository.h"
+#include "SqliteDatabase.h"
+
+// trains in a SQLite table , one row per train : id , name and seat count as columns and the
+// whole inventory (every seat allocator , Train::encode) as one blob , seat state is a bitset
+// there instead of a row per seat . the version column is the one compareAndSave checks ,
+// a conditional UPDATE , so no read is needed before a save
+class SqliteTrainRepository : public ITrainRepository
+{
+private:
+    SqliteDatabase *database;
+    mutable SqliteStatement selectById, selectAll, selectPage;
+    SqliteStatement upsert, insertNew, updateIfVersion, remove, removeAll;
+
+    static Train read(const SqliteStatement &row); // id , version , inventory
+    bool write(SqliteStatement &statement, Train &train, bool conditional);
+
+public:
+    explicit SqliteTrainRepository(SqliteDatabase *database);
+    ~SqliteTrainRepository() override = default;
+
+    vector<Train> getAllTrains() const override;
+    vector<Train> getTrainsPage(int afterId, int limit) const override;
+    bool deleteTrain(int trainId) override;
+    void save(Train &train) override;
+    bool compareAndSave(Train &train) override;
+    void saveAll(vector<Train> &trains) override;
+    std::optional<Train> getTrainById(const int &trainId) const override;
+    // read out of the table into memory , a copy rather than a shared view
+    Snapshot<Train> snapshot() const override;
+    void clear() override;
+};
+
+#endif // RMS_SQLITETRAINREPOSITORY_H
@@ -0,0 +1,92 @@
+#ifndef RMS_TICKETARCHIVE_H
+#define RMS_TICKETARCHIVE_H
+
+#include "../models/Ticket.h"
+#include "../structures/bloomFilter.h"
+#include "../structures/vector.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+struct ArchiveStats
+{
+    long long tickets = 0;   // records in the file , a ticket archived twice counts twice
+    long long segments = 0;
+    long long bytes = 0;     // file size
+    long long rawBytes = 0;  // the same tickets as fixed-size snapshot file records
+    long long lookups = 0;   // find calls
+    long long bloomRejects = 0;   // answered by the Bloom filter alone
+    long long falsePositives = 0; // the filter said maybe , no segment had it
+    size_t bloomBytes = 0;
+};
+
+// cold tier for tickets nobody books against any more (cancelled , departed) : an append-only
+// file of segments , one per append , read back through a read-only shared mapping . a segment
+// holds its tickets in id order , every field a varint delta from the row before it , passenger
+// names once per segment in a dictionary , and a restart every 64 rows (deltas start from zero
+// again) with an index of the restarts at its end , so find decodes at most 64 rows . every
+// segment carries a crc32 , a torn tail left by a crash is cut off when the file is opened .
+// a Bloom filter over the archived ids answers most "not archived" questions without touching
+// the file . integers are in host byte order , the file is meant for the same machine
+class TicketArchive
+{
+private:
+    struct Segment
+    {
+        uint64_t offset; // of its header in the file
+        uint32_t count;
+        int32_t minId;
+        int32_t maxId;
+    };
+
+    std::string path;
+    int fd = -1;
+    const char *base = nullptr; // mapping of the file , mapped past its end and grown by doubling
+    size_t mappedSize = 0;
+    uint64_t fileSize = 0;
+    std::vector<Segment> segments;
+    BloomFilter bloom;
+    long long tickets = 0;
+    long long rawBytes = 0;
+    int highestId = 0;
+    mutable std::atomic<long long> lookups{0}, bloomRejects{0}, falsePositives{0};
+    mutable std::shared_mutex mutex; // find and forEach share it , publishing a segment takes it alone
+    std::mutex writeMutex;           // one append or clear at a time , readers go on while it syncs
+
+    void map(uint64_t size);
+    void unmap();
+    void index(const Segment &segment); // its ids into the Bloom filter
+    void rebuildBloom(size_t expected);
+    std::optional<Ticket> findIn(const Segment &segment, int id) const;
+    template <class Fn>
+    void decode(const Segment &segment, size_t fromRestart, Fn fn) const;
+
+public:
+    // opens or creates the file
+    explicit TicketArchive(const std::string &path);
+    ~TicketArchive();
+    TicketArchive(const TicketArchive &) = delete;
+    TicketArchive &operator=(const TicketArchive &) = delete;
+
+    // writes the tickets as one segment and syncs it , returns its size in bytes . empty -> 0
+    size_t append(const vector<Ticket> &batch);
+    // the newest archived copy of the ticket
+    std::optional<Ticket> find(int ticketId) const;
+    bool mightContain(int ticketId) const; // false : certainly not archived
+    // every archived ticket , segment by segment in the order they were appended
+    void forEach(const std::function<void(const Ticket &)> &fn) const;
+    void clear(); // truncates the file
+
+    size_t size() const;
+    int maxId() const; // highest archived id , 0 when empty
+    const std::string &getPath() const;
+    ArchiveStats getStats() const;
+};
+
+#endif // RMS_TICKETARCHIVE_H
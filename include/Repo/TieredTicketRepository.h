@@ -0,0 +1,72 @@
+#ifndef RMS_TIEREDTICKETREPOSITORY_H
+#define RMS_TIEREDTICKETREPOSITORY_H
+
+#include "ITicketRepository.h"
+#include "TicketArchive.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// tickets in two tiers : the wrapped repository holds the live ones , archiveTickets moves the
+// cancelled ones and those of past departures into a TicketArchive and out of it . getTicketById
+// and the lookups by train / passenger fall back to the archive , so a passenger sees the same
+// tickets before and after archiving (a rename reaches the archived ones too) ; an index of the
+// archived ids per passenger , built when the repository opens , keeps the booking path off the
+// archive for passengers without history . listings and snapshots only see the live tier .
+// archived tickets are history : deleteTicket does not reach them , compareAndSave of one throws
+// std::logic_error and a save of one makes it live again (the live copy wins , the next
+// archiveTickets moves it back). new ids are handed
+// out here , past every archived one , so a wrapped repository rebuilt without the archived
+// tickets never reuses their ids . archiveTickets runs when called , archiveEvery runs it on a
+// timer
+class TieredTicketRepository : public ITicketRepository
+{
+private:
+    std::unique_ptr<ITicketRepository> inner;
+    TicketArchive *archive;
+    std::atomic<int> nextId{1};
+    std::shared_mutex moving; // writes share it , archiveTickets takes it alone to drop what it archived
+    std::shared_mutex archivedMutex;
+    std::unordered_map<int, std::vector<int>> archivedByPassenger; // under archivedMutex
+
+    std::mutex timerMutex;
+    std::condition_variable wake;
+    bool stopping = false; // under timerMutex
+    std::thread timer;
+
+    void assignId(Ticket &ticket);
+    void indexArchived(const Ticket &ticket); // holding archivedMutex alone
+    vector<Ticket> archivedOf(int passengerId); // without a live copy , id order
+
+public:
+    TieredTicketRepository(std::unique_ptr<ITicketRepository> inner, TicketArchive *archive);
+    ~TieredTicketRepository() override; // stops the timer
+
+    // moves every cancelled ticket and every ticket dated before beforeDate (yyyymmdd) into the
+    // archive in one segment , returns how many left the live tier
+    size_t archiveTickets(int beforeDate);
+    // archives the tickets cancelled or dated before today every intervalMs on a background
+    // thread , until the repository goes away . a failed round is retried by the next one
+    void archiveEvery(int intervalMs);
+    TicketArchive *getArchive() const;
+
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId) override;
+    std::optional<Ticket> getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate) override;
+    vector<Ticket> getTicketsByPassenger(int passengerId) override;
+    bool deleteTicket(int ticketId) override;
+    void save(Ticket &ticket) override;
+    bool compareAndSave(Ticket &ticket) override;
+    void saveAll(vector<Ticket> &tickets) override;
+    vector<Ticket> getAllTickets() override;
+    vector<Ticket> getTicketsPage(int afterId, int limit) override;
+    std::optional<Ticket> getTicketById(int ticketId) override;
+    Snapshot<Ticket> snapshot() override;
+    void clear() override; // both tiers
+};
+
+#endif // RMS_TIEREDTICKETREPOSITORY_H
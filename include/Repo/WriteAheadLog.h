@@ -0,0 +1,140 @@
+#ifndef RMS_WRITEAHEADLOG_H
+#define RMS_WRITEAHEADLOG_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <unordered_set>
+
+// how long commit() waits , from fastest to safest
+enum class Durability
+{
+    Buffered, // returns at once , the flusher writes and syncs every flushIntervalMs : a crash loses that much
+    Written,  // returns once the record is in the file : survives the process dying , not the machine
+    Synced    // returns once an fsync covered the record : survives a power cut
+};
+
+struct WalOptions
+{
+    Durability durability = Durability::Synced;
+    int flushIntervalMs = 10; // how often buffered records are written and synced when nobody waits for them
+};
+
+enum class WalTable : uint8_t
+{
+    Trains,
+    Tickets,
+    Passengers
+};
+
+enum class WalOp : uint8_t
+{
+    Put,    // body is the encoded record (utils/BinaryCodec.h)
+    Delete, // body is the id
+    Clear   // body is empty
+};
+
+struct WalRecord
+{
+    WalTable table;
+    WalOp op;
+    std::string body;
+};
+
+struct WalStats
+{
+    long long records = 0; // appended
+    long long writes = 0;  // write calls , one per batch
+    long long syncs = 0;   // fsyncs
+    long long bytes = 0;   // written , framing included
+    long long discarded = 0; // bytes dropped from the head of the file by discardBefore
+    long long size = 0;      // of the file , pending records included
+};
+
+// ids a Durable*Repository changed since its last checkpoint , see Checkpointer
+struct DirtySet
+{
+    std::unordered_set<int> ids; // saved or deleted
+    bool cleared = false;        // clear() ran , the checkpoint starts that table over
+};
+
+// append-only log of repository changes in one local file . append() only copies the record
+// into a buffer under a short lock ; a flusher thread takes the whole buffer , writes it with
+// one call and syncs it with one fsync , so the commits that piled up while the previous fsync
+// ran share the next one (group commit) . each record is framed as size , crc32 , payload , a
+// torn tail left by a crash fails the check and replay cuts the file there
+class WriteAheadLog
+{
+private:
+    std::string path;
+    WalOptions options;
+    int fd = -1;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeFlusher;
+    std::condition_variable flushed;
+    std::string pending;       // framed records not yet written
+    uint64_t fileBytes = 0;    // in the file , changes only under fileMutex and mutex both
+    uint64_t appendedBytes = 0; // in the file , in flight and pending : where the next record starts
+    std::mutex fileMutex;      // held while the flusher writes , discardBefore swaps the file under it
+    std::function<void(const std::string &)> shipper; // under fileMutex
+    uint64_t appended = 0;     // sequence number of the last appended record
+    uint64_t written = 0;      // ... of the last one in the file
+    uint64_t synced = 0;       // ... of the last one an fsync covered
+    uint64_t writeWanted = 0;  // highest record a Written commit waits for
+    uint64_t syncWanted = 0;   // highest record a Synced commit waits for
+    std::string failure;       // set when a write or fsync failed , every later commit throws it
+    bool stopping = false;
+    WalStats stats;
+    std::thread flusher;
+
+    void flushLoop();
+    void writeBytes(const std::string &bytes);
+    void waitFor(std::unique_lock<std::mutex> &lock, const uint64_t &reached, uint64_t lsn);
+
+public:
+    // opens or creates the file , records already in it are read with replay()
+    explicit WriteAheadLog(const std::string &path, const WalOptions &options = WalOptions{});
+    ~WriteAheadLog(); // writes and syncs what is still buffered
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+    // hands every intact record to apply in log order , truncates a torn tail , returns the count .
+    // call it before the first append
+    size_t replay(const std::function<void(const WalRecord &)> &apply);
+
+    // queues the record , returns its sequence number for commit
+    uint64_t append(WalTable table, WalOp op, const std::string &body);
+    // waits until the record is as durable as options.durability asks , throws std::runtime_error
+    // when the log could not be written
+    void commit(uint64_t lsn);
+    // writes and syncs everything appended so far , whatever the durability
+    void sync();
+    // where the next appended record will start , a position for discardBefore
+    uint64_t endOffset() const;
+    // drops every record before offset (an endOffset) from the file : the rest is copied to a new
+    // file that is synced and renamed over the log , so a crash leaves one of the two whole .
+    // appends go on meanwhile , only the flusher waits
+    void discardBefore(uint64_t offset);
+
+    // called by the flusher with every batch of framed records once it is in the file , in log
+    // order (a LogShipper) . it runs on the flusher thread and must not throw , keep it short
+    void setShipper(std::function<void(const std::string &frames)> shipper);
+
+    // one record framed the way append writes it
+    static std::string frame(WalTable table, WalOp op, const std::string &body);
+    // hands the whole records at the front of data to apply and returns the bytes they took , a
+    // record cut short at the end is left for the next call . throws std::runtime_error on a bad one
+    static size_t readFrames(const char *data, size_t size, const std::function<void(const WalRecord &)> &apply);
+
+    const WalOptions &getOptions() const;
+    const std::string &getPath() const;
+    WalStats getStats() const;
+};
+
+#endif // RMS_WRITEAHEADLOG_H
@@ -0,0 +1,97 @@
+#ifndef RMS_BOOKINGPIPELINE_H
+#define RMS_BOOKINGPIPELINE_H
+
+#include "TicketService.h"
+#include "../structures/queue.h"
+#include "../structures/unordered_map.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <functional>
+
+struct BookingPipelineOptions
+{
+    int workers = 4;
+    int maxBatchSize = 32;   // requests applied under one acquisition of a train
+    int maxBatchDelayMs = 2; // how long the first request of a partial batch waits for company
+    // thread per shard : when set , worker k books only the trains with shardOf(trainId) % workers == k
+    // (pass RepositoryShards::shardOf with workers == shard count to pin one worker to each shard)
+    std::function<int(int)> shardOf;
+};
+
+struct BookingPipelineStats
+{
+    long long submitted = 0;
+    long long completed = 0;
+    long long batches = 0;
+    int queueDepth = 0;      // submitted , not yet taken by a worker
+    int maxQueueDepth = 0;
+    int largestBatch = 0;
+    double averageBatchFill = 0; // mean batch size / maxBatchSize , 1 = every batch full
+};
+
+// asynchronous front of TicketService::bookBatch : requests are queued per train ,
+// a worker takes up to maxBatchSize of one train at once (waiting at most
+// maxBatchDelayMs for a partial batch to fill) and books them with one train
+// load / save and one ticket write . one train is only ever in one worker
+class BookingPipeline
+{
+public:
+    using Callback = std::function<void(const std::optional<Ticket>&, std::exception_ptr)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending
+    {
+        BookingRequest request;
+        Callback onDone;
+        Clock::time_point enqueuedAt;
+    };
+    struct TrainQueue
+    {
+        queue<Pending> pending;
+        bool scheduled = false; // in the ready queue
+        bool busy = false;      // a worker owns the train right now
+    };
+
+    TicketService *ticketService;
+    BookingPipelineOptions options;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable batchFilled;
+    unordered_map<int, TrainQueue> trains;
+    std::vector<queue<int>> ready; // trains with pending requests and no worker , FIFO , one per lane
+    std::vector<std::thread> workers;
+    bool stopping = false;
+    BookingPipelineStats stats;
+    long long batchedRequests = 0;
+
+    void enqueue(Pending pending);
+    int laneOf(int trainId) const;
+    void schedule(int trainId); // lock held
+    void workerLoop(int lane);
+    std::vector<Pending> takeBatch(int trainId, std::unique_lock<std::mutex> &lock);
+
+public:
+    explicit BookingPipeline(TicketService *ts, const BookingPipelineOptions &options = BookingPipelineOptions{});
+    ~BookingPipeline();
+    BookingPipeline(const BookingPipeline &) = delete;
+    BookingPipeline &operator=(const BookingPipeline &) = delete;
+
+    // the future holds the ticket , nullopt when waitlisted , or rethrows the booking error
+    std::future<std::optional<Ticket>> submit(const BookingRequest &request);
+    // onDone runs on a worker thread
+    void submit(const BookingRequest &request, Callback onDone);
+
+    // books everything already queued , then stops the workers ; later submits throw
+    void shutdown();
+    BookingPipelineStats getStats() const;
+    const BookingPipelineOptions &getOptions() const;
+};
+
+#endif // RMS_BOOKINGPIPELINE_H
@@ -0,0 +1,57 @@
+#ifndef RMS_BULKEXPORTER_H
+#define RMS_BULKEXPORTER_H
+
+#include "TrainService.h"
+#include "TicketService.h"
+#include <optional>
+#include <ostream>
+#include <string>
+
+enum class ExportFormat
+{
+    Csv,       // header line , then id,train_id,passenger_id,passenger_name,seat,date,status
+    JsonLines, // one object per ticket , keys named like the CSV columns
+    Binary     // "RMSTKX01" , then per ticket a uint32 size and the Ticket::encode bytes
+};
+
+struct ExportOptions
+{
+    // manifest : booked tickets only , ordered by train , date and seat , CSV / JSON rows also
+    // carry the train name
+    bool manifest = false;
+    int trainId = 0;                  // only this train , 0 -> every train
+    std::optional<int> travelDate;    // only this date (yyyymmdd , 0 = undated inventory)
+    size_t bufferBytes = 1u << 20;    // output is written in blocks of this size
+};
+
+struct ExportReport
+{
+    long long records = 0;
+    long long bytes = 0;
+    double ms = 0;
+    double recordsPerSecond() const { return ms > 0 ? records * 1000.0 / ms : 0; }
+};
+
+// streaming export of the tickets : one snapshot of the ticket repository is walked in id order
+// and every ticket is formatted straight into an output buffer , nothing is copied out of the
+// snapshot and the buffer goes out in bufferBytes writes . a manifest has to be sorted , it
+// keeps a sort key and a pointer into the snapshot per selected ticket , not the tickets themselves
+class BulkExporter
+{
+private:
+    TrainService *trainService;
+    TicketService *ticketService;
+
+public:
+    BulkExporter(TrainService *trainService, TicketService *ticketService);
+
+    // path "-" is standard output , any other path is created or truncated (a FIFO works too) .
+    // throws std::runtime_error when it cannot be opened or written
+    ExportReport exportFile(ExportFormat format, const std::string &path, const ExportOptions &options = ExportOptions{});
+    ExportReport exportStream(ExportFormat format, std::ostream &out, const ExportOptions &options = ExportOptions{});
+
+    // from the extension : .csv , .jsonl / .ndjson , .bin ; anything else is CSV
+    static ExportFormat formatFor(const std::string &path);
+};
+
+#endif // RMS_BULKEXPORTER_H
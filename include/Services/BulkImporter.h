@@ -0,0 +1,65 @@
+#ifndef RMS_BULKIMPORTER_H
+#define RMS_BULKIMPORTER_H
+
+#include "TrainService.h"
+#include "PassengerService.h"
+#include "TicketService.h"
+#include "../utils/WorkStealingPool.h"
+#include <istream>
+#include <string>
+
+enum class ImportKind
+{
+    Trains,     // name , seats
+    Passengers, // name
+    Tickets     // train_id , passenger_id [, date YYYY-MM-DD] : booked like bookTicket
+};
+
+enum class ImportFormat
+{
+    Csv,       // header line naming the columns , then one record per line
+    JsonLines  // one flat object per line , keys named like the CSV columns
+};
+
+struct ImportOptions
+{
+    size_t chunkBytes = 256u << 10; // read and validated at a time , small enough that its rows stay in cache
+    std::string errorReportPath;  // rejected records go here as CSV (line , error , record) , empty -> nowhere
+};
+
+struct ImportReport
+{
+    long long records = 0;    // non-blank lines , the CSV header not counted
+    long long imported = 0;   // saved , or for tickets booked or waitlisted
+    long long rejected = 0;
+    long long waitlisted = 0; // tickets only , part of imported
+    double ms = 0;
+    double recordsPerSecond() const { return ms > 0 ? records * 1000.0 / ms : 0; }
+};
+
+// streaming import : the input is read chunkBytes at a time and cut at the last line break ,
+// the lines of a chunk are parsed and validated in parallel on the pool (fields stay views
+// into the chunk) , then the good records go in as batches : trains and passengers straight
+// into the repositories , tickets through TicketService::bookBulk (one train load / save per
+// train and batch) . a bad record never stops the import , it is counted and reported
+class BulkImporter
+{
+private:
+    TrainService *trainService;
+    PassengerService *passengerService;
+    TicketService *ticketService;
+    WorkStealingPool *pool; // sequential when null
+
+public:
+    BulkImporter(TrainService *trainService, PassengerService *passengerService, TicketService *ticketService,
+                 WorkStealingPool *pool = nullptr);
+
+    // format from the extension : .csv , .jsonl or .ndjson . throws std::invalid_argument on an
+    // unknown extension or a CSV header missing a column , std::runtime_error when a file cannot be opened
+    ImportReport importFile(ImportKind kind, const std::string &path, const ImportOptions &options = ImportOptions{});
+    ImportReport importStream(ImportKind kind, ImportFormat format, std::istream &in, const ImportOptions &options = ImportOptions{});
+
+    static ImportKind parseKind(const std::string &text); // "trains" , "passengers" , "tickets"
+};
+
+#endif // RMS_BULKIMPORTER_H
@@ -0,0 +1,139 @@
+#ifndef RMS_EVENTBUS_H
+#define RMS_EVENTBUS_H
+
+#include "../structures/ringBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class EventType : uint8_t
+{
+    TicketBooked,     // ticketId , seat
+    TicketWaitlisted, // the train (date) was full , no ticket
+    TicketCancelled,  // ticketId , seat freed
+    WaitlistPromoted, // a freed / added seat went to the first waiting passenger : ticketId , seat
+    PromotionFailed,  // that booking threw , the passenger is off the waiting list
+    HoldPlaced,       // holdId , seat
+    HoldConfirmed,    // holdId , the new ticketId , seat
+    HoldReleased,     // holdId , seat
+    HoldExpired,      // holdId , seat
+    TrainAdded,       // seats = its seat count
+    TrainDeleted,
+    SeatsAdded        // seats = how many were added
+};
+
+const char *eventTypeName(EventType type);
+
+// one change , plain data so publishing is a copy into a ring slot . fields an event type does
+// not use stay 0
+struct Event
+{
+    uint64_t sequence = 0; // per bus , from 1 in delivery order ; a dropped event takes none
+    long long timeMs = 0;  // wall clock
+    EventType type = EventType::TicketBooked;
+    int trainId = 0;
+    int travelDate = 0;
+    int ticketId = 0;
+    int passengerId = 0;
+    int seat = 0;
+    int holdId = 0;
+    int seats = 0;
+};
+
+struct EventBusOptions
+{
+    size_t capacity = 1u << 16; // ring slots , a power of two
+    size_t maxBatch = 1024;     // events handed to the subscribers per call
+    int drainIntervalMs = 5;    // how long events may wait in the ring before they are delivered
+    bool waitWhenFull = false;  // false : a publish into a full ring is dropped and counted
+};
+
+struct EventBusStats
+{
+    long long published = 0;
+    long long delivered = 0;
+    long long dropped = 0;
+    long long batches = 0;
+};
+
+// change-data-capture bus : services publish into a lock-free ring (RingBuffer) and a dispatcher
+// thread drains it every drainIntervalMs , handing each batch to every subscriber in publish
+// order . publishers never take a lock and never wait for a subscriber , they only wake the
+// dispatcher early once the ring is half full ; a slow subscriber makes the ring fill up , then
+// events are dropped (or the publisher yields , waitWhenFull) . subscribers run on the
+// dispatcher thread , one at a time
+class EventBus
+{
+public:
+    using Subscriber = std::function<void(const Event *events, size_t count)>;
+
+private:
+    EventBusOptions options;
+    RingBuffer<Event> ring;
+    std::atomic<long long> published{0}, delivered{0}, dropped{0}, batches{0};
+
+    std::mutex subscribersMutex; // held by the dispatcher while it delivers , never by publishers
+    std::vector<std::pair<int, Subscriber>> subscribers;
+    int nextSubscriberId = 1;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;    // the dispatcher sleeps here when the ring is empty
+    std::condition_variable drained; // flush waits here
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<int> flushing{0}; // flush calls waiting , they wake the dispatcher early
+    std::thread dispatcher;
+
+    void dispatch();
+
+public:
+    explicit EventBus(const EventBusOptions &options = EventBusOptions{});
+    ~EventBus(); // delivers what is still in the ring , then stops
+    EventBus(const EventBus &) = delete;
+    EventBus &operator=(const EventBus &) = delete;
+
+    // sequence and time are filled in here ; false when the event was dropped
+    bool publish(Event event);
+
+    // not from inside a subscriber . unsubscribe returns once no batch is being delivered to it
+    int subscribe(Subscriber subscriber); // id for unsubscribe
+    void unsubscribe(int subscriberId);
+    // waits until every event published before the call has been delivered
+    void flush();
+
+    EventBusStats getStats() const;
+    const EventBusOptions &getOptions() const;
+};
+
+// subscriber that appends events as JSON lines to a file or a named pipe . the file is opened by
+// the dispatcher on the first batch , so a FIFO without a reader blocks the dispatcher (and
+// then fills the ring) but never a booking . a failed open or write stops the sink , getError
+// tells why
+class EventLogSink
+{
+private:
+    EventBus *bus;
+    std::string path;
+    int fd = -1;
+    int subscriberId = 0;
+    std::string buffer;
+    std::string error; // set by the dispatcher , read after a flush
+
+    void write(const Event *events, size_t count);
+
+public:
+    EventLogSink(EventBus *bus, const std::string &path);
+    ~EventLogSink(); // unsubscribes after a flush , then closes the file
+    EventLogSink(const EventLogSink &) = delete;
+    EventLogSink &operator=(const EventLogSink &) = delete;
+
+    const std::string &getPath() const;
+    std::string getError(); // empty while writing works , flushes the bus first
+};
+
+#endif // RMS_EVENTBUS_H
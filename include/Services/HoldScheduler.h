@@ -0,0 +1,44 @@
+#ifndef RMS_HOLDSCHEDULER_H
+#define RMS_HOLDSCHEDULER_H
+
+#include <vector>
+#include "../structures/minHeap.h"
+#include "../models/SeatAllocator.h"
+
+// expiry timers of seat holds , earliest deadline on top
+// confirmed / released holds are not removed from the heap (that is O(n)) ,
+// their timer just fires later and the caller skips holds that are gone
+class HoldScheduler
+{
+public:
+    struct Timer
+    {
+        long long expiresAt = 0;
+        int holdId = 0;
+        int trainId = 0;
+
+        bool operator<(const Timer &other) const
+        {
+            if (expiresAt != other.expiresAt)
+                return expiresAt < other.expiresAt;
+            return holdId < other.holdId;
+        }
+        bool operator==(const Timer &other) const { return holdId == other.holdId; }
+    };
+
+private:
+    MinHeap<Timer> timers;
+
+public:
+    void schedule(const SeatHold &hold);
+    void schedule(int holdId, int trainId, long long expiresAt);
+
+    // pops at most maxBatch timers due at `now` , earliest first
+    std::vector<Timer> popDue(long long now, int maxBatch);
+
+    long long nextExpiry() const; // -1 when nothing is scheduled
+    size_t size() const;
+    bool empty() const;
+};
+
+#endif // RMS_HOLDSCHEDULER_H
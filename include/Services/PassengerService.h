@@ -8,17 +8,22 @@
 #include "../structures/vector.h"
 #include "../models/Passenger.h"
 #include "../Repo/IPassengerRepository.h"
+#include <mutex>
+#include <vector>
 
 class PassengerService
 {
 private:
     IPassengerRepository *passengerRepository;
+    std::mutex writeMutex; // find-or-create and rename are check-then-act
 
 public:
     PassengerService(IPassengerRepository *repo);
     Passenger getPassenger(const int& passengerId);
     vector<Passenger> getAllPassengers();
     Passenger createPassenger(const std::string& name);
+    // new passengers in one write , a name already stored (or repeated) gets the stored passenger back
+    void importPassengers(std::vector<Passenger>& passengers);
     Passenger updatePassenger(const int passengerId , const std::string& name);
     void deletePassenger(const int& passengerId);
     Passenger find_or_create_passenger(const std::string& name);
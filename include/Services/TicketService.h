@@ -8,7 +8,64 @@
 #include "../Repo/ITicketRepository.h"
 #include "TrainService.h"
 #include "PassengerService.h"
+#include "HoldScheduler.h"
+#include "EventBus.h"
 #include "../structures/vector.h"
+#include "../structures/unordered_map.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <exception>
+
+// Locking  : book / cancel hold the train lock , writers queue up behind each other
+// Optimistic : book / cancel read without any lock and commit with a versioned save ,
+//              retrying the whole read-modify-write only when another writer got there first
+// SeatClaims : bookTicket of "any seat" claims its seat lock-free (ConcurrentSeatAllocator) and
+//              whichever booking of the departure gets to commit first writes every pending claim
+//              with one train save , the others wait for it instead of for the train lock .
+//              everything else books as Locking
+enum class ConcurrencyMode
+{
+    Locking,
+    Optimistic,
+    SeatClaims
+};
+// "locking" , "optimistic" or "claims"
+ConcurrencyMode parseConcurrencyMode(const std::string& name);
+
+struct SeatClaims;  // the lock-free inventory of one departure , TicketService.cpp
+struct PendingClaim;
+
+// one booking as submitted to bookBatch / the booking pipeline
+struct BookingRequest
+{
+    int trainId = 0;
+    int passengerId = 0;
+    SeatRequest request;
+    int travelDate = 0;
+};
+
+// result of one request of a batch : a ticket , or neither ticket nor error when
+// the passenger went to the waiting list , or the exception bookTicket would have thrown
+struct BookingOutcome
+{
+    std::optional<Ticket> ticket;
+    std::exception_ptr error;
+};
+
+// counts over one snapshot of the ticket repository
+struct TicketReport
+{
+    long long total = 0;
+    long long booked = 0;
+    long long cancelled = 0;
+    int trains = 0; // trains with at least one ticket
+};
 
 class TicketService
 {
@@ -16,15 +73,97 @@ private:
     ITicketRepository *ticketRepository;
     TrainService *trainService;
     PassengerService *passengerService;
+    // booking / cancelling lock only the affected train (TrainService::lockTrain) ,
+    // the hold bookkeeping below has its own short lock , always taken after the train lock
+    mutable std::mutex holdsMutex;
+    HoldScheduler holdScheduler;
+    unordered_map<int, SeatHold> activeHolds; // live hold id -> hold (train / date)
+    std::condition_variable holdsChanged;     // a hold scheduled or the expiry thread stopping , under holdsMutex
+    bool stopExpiry = false;                  // under holdsMutex
+    std::thread expiryThread;                 // expireHoldsInBackground
+    std::mutex defragMutex;
+    std::condition_variable defragWake;
+    bool stopDefrag = false;                  // under defragMutex
+    std::thread defragThread;                 // defragmentInBackground
+    std::atomic<int> nextHoldId{1};
+    std::function<long long()> clock;   // ms since epoch
+    ConcurrencyMode mode = ConcurrencyMode::Locking;
+    RetryStats retryStats;
+    WorkStealingPool *pool = nullptr; // reports and bulk booking , sequential when unset
+    EventBus *events = nullptr;       // changes are published here once committed , none when unset
+    // SeatClaims mode : one per (train , date) booked "any seat" , rebuilt from the train when it
+    // turns out to differ from it (a seat taken or freed by the locked paths)
+    mutable std::shared_mutex claimsMutex;
+    unordered_map<long long, std::shared_ptr<SeatClaims>> seatClaims;
 
+    static constexpr int MAX_ATTEMPTS = 64;
+    std::unique_lock<std::recursive_mutex> lockForWrite(const int& trainId); // no lock in optimistic mode
+    bool holdsTicket(const int& trainId, const int& passengerId, const int& travelDate);
+    std::optional<Ticket> bookAttempt(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate);
+    // publishes bookedType (or TicketWaitlisted) before it lets go of the train lock
+    std::optional<Ticket> book(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate,
+                               EventType bookedType = EventType::TicketBooked);
+    void publish(const Event& event);
+    void publishBooking(EventType bookedType, const int& trainId, const int& passengerId, const int& travelDate, const std::optional<Ticket>& ticket);
+    std::shared_ptr<SeatClaims> claimsFor(const int& trainId, const int& travelDate);
+    void dropClaims(const int& trainId, const int& travelDate, const SeatClaims* stale);
+    // nullopt : no seat claimed (or the claim lost to the locked paths) , book the locked way
+    std::optional<Ticket> bookClaimed(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate);
+    void commitClaims(const int& trainId, const int& travelDate, SeatClaims& claims, const std::vector<PendingClaim*>& batch);
+    void releaseClaimedSeat(const int& trainId, const int& travelDate, const int& seatNumber);
+    // the seats of tickets that could not be written go back , waiting passengers get them
+    void releaseSeats(const int& trainId, const vector<Ticket>& unsaved);
+    void runHoldExpiry(int maxBatch);
+    void runDefragmentation(int intervalMs, int maxSteps);
+    SeatHold findActiveHold(const int& holdId);
+    std::optional<SeatHold> takeActiveHold(const int& holdId);
 
 public:
     TicketService(ITicketRepository *repo , TrainService* ts,PassengerService* ps);
+    ~TicketService(); // stops the expiry and defragmentation threads
     Ticket getTicket(const int& ticketId);
     vector<Ticket> getAllTickets();
+    vector<Ticket> getTicketsPage(int afterId, int limit);
+    vector<Ticket> getTicketsByPassenger(int passengerId);
+    // frozen view , walking it takes no lock and does not hold back booking
+    Snapshot<Ticket> snapshotTickets();
+    TicketReport getTicketReport();
     Ticket updateTicket(Ticket &t);
 
-    std::optional<Ticket> bookTicket(const int& trainId, const int& passengerId);
+    // travelDate is yyyymmdd , 0 books the train's undated inventory
+    std::optional<Ticket> bookTicket(const int& trainId, const int& passengerId, const SeatRequest& request = SeatRequest{}, const int& travelDate = 0);
     void cancelTicket(const int& ticketId);
+    // books a passenger just taken off the waiting list ; publishes WaitlistPromoted , or
+    // PromotionFailed instead of throwing
+    void promoteWaitingPassenger(const int& trainId, const int& passengerId, const int& travelDate = 0);
+    // books many requests for one train with a single train load / save and a single
+    // ticket write , a failing request does not affect the others
+    std::vector<BookingOutcome> bookBatch(const int& trainId, const std::vector<BookingRequest>& requests);
+    // requests for any trains : grouped per train , each group one bookBatch , the groups
+    // run on the pool ; outcomes come back in request order
+    std::vector<BookingOutcome> bookBulk(const std::vector<BookingRequest>& requests);
+
+    // seat holds : reserved for ttlSeconds , then released by expireHolds
+    SeatHold holdSeat(const int& trainId, const int& passengerId, const int& ttlSeconds, const SeatRequest& request = SeatRequest{}, const int& travelDate = 0);
+    Ticket confirmHold(const int& holdId);
+    void releaseHold(const int& holdId);
+    int expireHolds(const int& maxBatch = 1024);
+    // a thread that sleeps until the earliest hold deadline and runs expireHolds(maxBatch) ,
+    // a hold placed with an earlier deadline wakes it . after setClock
+    void expireHoldsInBackground(const int& maxBatch = 1024);
+    int getActiveHoldCount() const;
+
+    // one bounded compaction slice over a departure , apply = false only proposes the moves
+    DefragReport defragmentSeats(const int& trainId, const int& travelDate = 0, const int& maxSteps = 256, const bool& apply = true);
+    // a thread that runs one defragmentSeats(maxSteps) slice per train and departure every
+    // intervalMs , each slice goes on where the last one of that departure stopped
+    void defragmentInBackground(const int& intervalMs, const int& maxSteps = 256);
+    void setClock(std::function<long long()> nowMs); // set before the service is shared between threads
+    void setConcurrencyMode(ConcurrencyMode mode);   // same
+    void setThreadPool(WorkStealingPool* pool);      // same , not owned
+    WorkStealingPool* getThreadPool() const;
+    void setEventBus(EventBus* bus);                 // same , not owned
+    ConcurrencyMode getConcurrencyMode() const;
+    const RetryStats& getRetryStats() const;         // commits / conflicts of book and cancel
 };
 #endif // RMS_TICKETSERVICE_H
@@ -6,27 +6,68 @@
 #define RMS_TRAINSERVICE_H
 #include "../structures/vector.h"
 #include "../Repo/ITrainRepository.h"
+#include "../utils/StripedLock.h"
+#include "../utils/OptimisticRetry.h"
+#include "EventBus.h"
 #include <optional>
+#include <functional>
+#include <vector>
+
+// one line of the occupancy report , undated inventory
+struct TrainOccupancy
+{
+    int trainId = 0;
+    std::string name;
+    int totalSeats = 0;
+    int allocatedSeats = 0;
+    int waiting = 0;
+    int departures = 0; // dated inventories materialized
+};
 
 class TrainService{
 private:
     ITrainRepository* trainRepository;
+    StripedLock trainLocks; // read-modify-write of one train , other trains go on in parallel
+    WorkStealingPool* pool = nullptr; // reports , sequential when unset
+    EventBus* events = nullptr;       // TrainAdded / TrainDeleted / SeatsAdded , none when unset
+
+    // load , change , save back ; the whole cycle is repeated on a version conflict
+    Train modifyTrain(int trainId, const std::function<void(Train&)>& change);
+    void publish(EventType type, int trainId, int seats = 0);
 public:
     TrainService(ITrainRepository* repo) ;
     ~TrainService();
+    // held while a train is loaded , changed and saved back
+    std::unique_lock<std::recursive_mutex> lockTrain(int trainId);
     //crud
     Train getTrain(const int&);
     vector<Train> getAllTrains();
+    vector<Train> getTrainsPage(int afterId, int limit);
+    Snapshot<Train> snapshotTrains(); // frozen view for long reads
     Train createTrain(const std::string& name,int seats);
+    void importTrains(std::vector<Train>& trains); // new trains , ids written back , no copies returned
     Train updateTrain(const int& id , const std::string& name,int seats = 0);
     void deleteTrain(int trainId);
 
     //seats
     Train addSeats(const int trainId , const int seats);
     Train addSeats(const std::string name  , const int seats);
+    Train setCoachLayout(const int trainId, const vector<CoachSpec>& coaches);
+    int getClassAvailability(const int trainId, const std::string& seatClass, const int travelDate = 0);
+    Train tagSeats(const int trainId, const int fromSeat, const int toSeat, const unsigned attributes);
+    // takes up to count passengers off every waiting list , the undated one and each departure's ,
+    // and saves the train . the caller books them afterwards on the date they waited for
+    std::vector<std::pair<int, int>> takeWaitingPassengers(int trainId, int count); // travel date , passenger
+    // departures
+    int evictDatesBefore(int travelDate);
     // status
-    void printStatus(int trainId);
+    void printStatus(int trainId, int travelDate = 0);
     bool isAvailbleSeat(int trainId);
+    // every train of one snapshot , in train id order
+    std::vector<TrainOccupancy> getOccupancyReport();
+    void setThreadPool(WorkStealingPool* pool); // set before the service is shared , not owned
+    void setEventBus(EventBus* bus);            // same
+    // versioned : throws ConcurrencyConflict when the train was saved since it was read
     void save(Train & train);
 };
 #endif //RMS_TRAINSERVICE_H
@@ -6,20 +6,129 @@
 #define RMS_STARTUPMANAGER_H
 
 #include "RMSFacade.h"
+#include "utils/WorkStealingPool.h"
+#include "Repo/SharedSegment.h"
+#include "Repo/RepositoryShards.h"
+#include "Repo/WriteAheadLog.h"
+#include "Repo/SnapshotFile.h"
+#include "Repo/SqliteDatabase.h"
+#include "Repo/RecordCache.h"
+#include "Repo/TieredTicketRepository.h"
+#include "Repo/Checkpointer.h"
+#include "Repo/LogShipper.h"
+#include "Repo/LogReplica.h"
+#include "Services/EventBus.h"
+#include <future>
 #include <memory>
+#include <optional>
+#include <string>
 
 class StartupManager {
 private:
+    int workerThreads = 0; // 0 -> one per hardware thread
+    ConcurrencyMode concurrencyMode = ConcurrencyMode::Locking;
+    int holdExpiryBatch = 0;                      // 0 -> holds only expire when expireHolds is called
+    int defragIntervalMs = 0;                     // 0 -> seats are only defragmented on request
+    int defragMaxSteps = 256;
+    std::unique_ptr<WorkStealingPool> workerPool; // declared first , outlives the services using it
+    std::string sharedMemoryName;                 // empty -> private in-memory repositories
+    SharedSegmentOptions sharedMemoryOptions;
+    std::unique_ptr<SharedSegment> sharedSegment; // outlives the repositories mapped on it
+    int shardCount = 0;                           // 0 -> trains and tickets unsharded
+    std::unique_ptr<RepositoryShards> repositoryShards; // outlives the two views over it
+    std::string walPath;                          // empty -> nothing is logged
+    WalOptions walOptions;
+    std::unique_ptr<WriteAheadLog> writeAheadLog; // outlives the repositories logging to it
+    std::optional<CheckpointOptions> checkpointOptions; // empty -> the log is replayed from its start
+    std::unique_ptr<WriteAheadLog> checkpointLog;  // next to the write-ahead log , replayed before it
+    std::string snapshotPath;                     // empty -> start from the mock data
+    std::string sqlitePath;                       // empty -> repositories in memory
+    SqliteOptions sqliteOptions;
+    std::unique_ptr<SqliteDatabase> sqliteDatabase; // outlives the repositories using it
+    std::optional<CacheOptions> cacheOptions;     // empty -> the repositories are used directly
+    std::string archivePath;                      // empty -> every ticket stays live
+    int archiveEveryMs = 0;                       // 0 -> only when archiveTickets is called
+    std::unique_ptr<TicketArchive> ticketArchive; // outlives the ticket repository reading it
+    std::unique_ptr<EventBus> eventBus;           // outlives the services publishing to it
+    std::string eventLogPath;                     // empty -> events are not written anywhere
+    std::unique_ptr<EventLogSink> eventLog;       // unsubscribes before the bus goes
     std::unique_ptr<ITrainRepository> trainRepository;
     std::unique_ptr<ITicketRepository> ticketRepository;
     std::unique_ptr<IPassengerRepository> passengerRepository;
     std::unique_ptr<TrainService> trainService;
     std::unique_ptr<PassengerService> passengerService;
     std::unique_ptr<TicketService> ticketService;
+    TieredTicketRepository* tieredTickets = nullptr; // the ticket repository , when archiving
+    std::unique_ptr<Checkpointer> checkpointer;   // stops before the repositories it reads go
+    std::string shipPath;                         // empty -> the log goes to no replica
+    ShippingOptions shippingOptions;
+    std::unique_ptr<LogShipper> logShipper;       // stops before the repositories and the log it reads go
+    std::string replicaOf;                        // empty -> a primary
+    ReplicaOptions replicaOptions;
+    std::unique_ptr<LogReplica> logReplica;       // stops before the repositories it writes go
 
     std::unique_ptr<RMSFacade> facade;
 public:
     RMSFacade * buildFacade() ;
+    // threads of the pool behind reports and bulk booking , set before buildFacade
+    void setWorkerThreads(int threads);
+    WorkStealingPool* getWorkerPool() const;
+    // how bookings of one train are kept apart (TicketService::setConcurrencyMode) , set before buildFacade
+    void setConcurrencyMode(ConcurrencyMode mode);
+    // lapsed seat holds are released by a background thread , maxBatch per expireHolds call
+    // (TicketService::expireHoldsInBackground) . set before buildFacade
+    void useHoldExpiry(int maxBatch = 1024);
+    // every intervalMs a slice of at most maxSteps seat moves per train and departure
+    // (TicketService::defragmentInBackground) . set before buildFacade
+    void useDefragmentation(int intervalMs, int maxSteps = 256);
+    // repositories in a POSIX shared-memory segment shared with other RMS processes ,
+    // only the process that creates the segment loads the mock data . set before buildFacade
+    void useSharedMemory(const std::string& name, const SharedSegmentOptions& options = SharedSegmentOptions{});
+    // in-memory trains and tickets split by train id over shards , each behind its own locks
+    // (RepositoryShards) . set before buildFacade
+    void useShardedRepositories(int shards);
+    // log every change to a write-ahead log at path and rebuild the repositories from it on start ,
+    // the mock data is only loaded into an empty log . set before buildFacade
+    void useWriteAheadLog(const std::string& path, const WalOptions& options = WalOptions{});
+    WriteAheadLog* getWriteAheadLog() const;
+    // checkpoint the changed records to a second log next to the write-ahead log every
+    // intervalMs and drop what it covers from the write-ahead log , a restart then replays at
+    // most one interval of it . after useWriteAheadLog , before buildFacade
+    void useCheckpoints(const CheckpointOptions& options = CheckpointOptions{});
+    // one checkpoint now
+    CheckpointStats checkpoint();
+    Checkpointer* getCheckpointer() const;
+    // start from the snapshot file at path instead of the mock data , when the file exists .
+    // set before buildFacade
+    void useSnapshot(const std::string& path);
+    // writes the current state to path on a background thread , bookings go on meanwhile
+    std::future<SnapshotFileStats> saveSnapshot(const std::string& path) const;
+    // repositories in the SQLite database at path (created when missing) , the mock data is only
+    // loaded into an empty one . set before buildFacade
+    void useSqlite(const std::string& path, const SqliteOptions& options = SqliteOptions{});
+    // keep the hot records in memory in front of the repositories and write saves behind ,
+    // for a SQLite database or a write-ahead log . set before buildFacade
+    void useCache(const CacheOptions& options = CacheOptions{});
+    // send every logged change to the replicas connecting to the Unix domain socket at path (or
+    // to the file at path , options.toFile) . after useWriteAheadLog , before buildFacade
+    void useLogShipping(const std::string& path, const ShippingOptions& options = ShippingOptions{});
+    LogShipper* getLogShipper() const;
+    // a read-only replica of the primary shipping its log to path : the repositories start empty
+    // and follow the primary , every write through the facade throws std::logic_error .
+    // set before buildFacade
+    void useReplicaOf(const std::string& path, const ReplicaOptions& options = ReplicaOptions{});
+    LogReplica* getLogReplica() const;
+    // move cancelled and departed tickets to the archive file at path with archiveTickets , and
+    // every archiveEveryMs in the background when it is > 0 ; getTicketById and the lookups by
+    // passenger still find them . set before buildFacade
+    void useTicketArchive(const std::string& path, int archiveEveryMs = 0);
+    // archives the tickets cancelled or dated before today , returns how many moved
+    size_t archiveTickets();
+    TicketArchive* getTicketArchive() const;
+    // bus the services publish their changes to , subscribe to it after buildFacade
+    EventBus* getEventBus() const;
+    // append every event as a JSON line to the file or named pipe at path . set before buildFacade
+    void useEventLog(const std::string& path);
 
 };
 #endif //RMS_STARTUPMANAGER_H
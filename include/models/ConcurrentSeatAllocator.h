@@ -0,0 +1,63 @@
+#ifndef RMS_CONCURRENTSEATALLOCATOR_H
+#define RMS_CONCURRENTSEATALLOCATOR_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "../structures/mpscQueue.h"
+#include "../structures/bitset.h"
+
+// lock-free "any seat" inventory for one hot train on sale-open
+// free seats are a bitmap of atomic words claimed with CAS , a free counter
+// is decremented first so a caller that got a unit is guaranteed a bit .
+// no layout , attributes or holds : those stay in SeatAllocator under the train lock .
+// TicketService in ConcurrencyMode::SeatClaims books "any seat" requests through it
+class ConcurrentSeatAllocator
+{
+private:
+    int totalSeats;
+    size_t wordCount;
+    std::unique_ptr<std::atomic<uint64_t>[]> freeWords; // bit per seat number , set = free , bit 0 unused
+    std::unique_ptr<std::atomic<int>[]> owners;         // seat -> passenger , 0 = free
+    std::atomic<int> freeCount;
+    MpscQueue<int> waitingList;
+    std::atomic_flag draining = ATOMIC_FLAG_INIT; // single consumer of the waiting list
+
+    bool reserve();
+    int claim(int passengerId, size_t startWord);
+
+public:
+    explicit ConcurrentSeatAllocator(int totalSeats = 10);
+    // starts from a SeatAllocator's free seats (bit per seat number) , the taken ones have owner -1
+    explicit ConcurrentSeatAllocator(const Bitset &freeSeats);
+    ConcurrentSeatAllocator(const ConcurrentSeatAllocator &) = delete;
+    ConcurrentSeatAllocator &operator=(const ConcurrentSeatAllocator &) = delete;
+
+    // seat number , or -1 when the train is full and the passenger was queued .
+    // threads start scanning at different words (by passenger id) to avoid
+    // fighting over the same cache line , so seats are not handed out lowest-first .
+    // duplicate passengers are not detected , the service layer owns that check
+    int allocateSeat(int passengerId);
+    // same , but a full train returns -1 without queueing the passenger
+    int tryAllocateSeat(int passengerId);
+    // this seat for the passenger , false when it is taken
+    bool claimSeat(int seatNumber, int passengerId);
+    // returns the passenger that held the seat , waiting passengers are only
+    // seated by drainWaitingList
+    int freeSeat(int seatNumber);
+    // seats waiting passengers in FIFO order while seats are free , calls
+    // onSeated(passengerId, seatNumber) for each . returns 0 immediately if another
+    // thread is already draining (it re-checks before leaving so nothing is lost)
+    int drainWaitingList(const std::function<void(int, int)> &onSeated = nullptr);
+
+    int getTotalSeats() const;
+    int getAvailableSeatCount() const;
+    int getAllocatedSeatCount() const;
+    int getWaitingListSize() const;
+    bool isSeatFree(int seatNumber) const;
+    int getSeatOwner(int seatNumber) const; // 0 when free
+};
+
+#endif // RMS_CONCURRENTSEATALLOCATOR_H
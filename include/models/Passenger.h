@@ -5,19 +5,27 @@
 #ifndef RMS_PASSENGER_H
 #define RMS_PASSENGER_H
 #include <string>
+class ByteWriter;
+class ByteReader;
+
 class Passenger{
     std::string name;
     int id;
+    long long version = 0; // bumped by the repository on every save
 public:
     Passenger() = default;
     Passenger(const int id, const std::string& name);
     int getId() const;
-    std::string getName() const;
+    long long getVersion() const;
+    void setVersion(long long version);
+    const std::string &getName() const;
     void setName(const std::string& name);
 
     void setId(const int & passengerId) ;
 
     void print(const std::string& msg) const ;
+    void encode(ByteWriter& out) const;
+    static Passenger decode(ByteReader& in);
 
 };
 #endif //RMS_PASSENGER_H
@@ -10,30 +10,101 @@
 #include "../structures/stack.h"
 #include "../structures/queue.h"
 #include "../structures/unordered_map.h"
+#include "../structures/vector.h"
+#include "../structures/bitset.h"
+#include "SeatLayout.h"
+#include "SeatAttributes.h"
 #include <string>
 #include<memory>
 #include <functional>
 
+// a seat reserved for a passenger until expiresAt (ms since epoch) , then it lapses
+struct SeatHold
+{
+    int holdId = 0;
+    int trainId = 0;
+    int passengerId = 0;
+    int seatNumber = 0;
+    long long expiresAt = 0;
+    int travelDate = 0;
+    bool flexible = false; // stays movable after confirmation
+};
+
+// one reassignment made (or proposed) by defragmentation , holdId is 0 for bookings
+struct SeatMove
+{
+    int fromSeat = 0;
+    int toSeat = 0;
+    int passengerId = 0;
+    int holdId = 0;
+};
+
+class ByteWriter;
+class ByteReader;
+
+struct DefragReport
+{
+    int largestBlockBefore = 0; // longest run of free seats inside one coach
+    int largestBlockAfter = 0;
+    vector<SeatMove> moves;
+    bool finished = false;      // the pass reached the last coach
+};
+
 class SeatAllocator{
-    std::set<int> availableSeats;
+    Bitset freeSeats;                       // bit per seat number , set = free
+    SeatLayout layout;                      // class / coach free counts
+    SeatAttributes attributes;              // window / aisle / ... bitsets
+    vector<Bitset> classSeats;              // seats of each class , for bitwise class filters
     queue<int> waitingList;
     std::set<int> waitingSet;              // prevent duplicate waiting entries
     unordered_map<int, int> allocatedSeats;
-    stack<int> cancelledSeats;
+    unordered_map<int, int> passengerSeats;  // passenger -> seat (allocated or held) , O(1) duplicate check
+    unordered_map<int, SeatHold> holds;      // hold id -> held seat , neither free nor allocated
+    unordered_map<int, int> heldSeats;       // seat -> hold id
+    stack<int> cancelledSeats;              // reuse order hint , entries may be stale
+    Bitset movableSeats;                    // held or flexible seats , defragmentation may move them
+    // where the running defragmentation pass stopped : coach + the two pointers inside it
+    int defragCoach = 1, defragLow = 0, defragHigh = 0;
     int totalSeats ;
+
+    void resetInventory();
+    void rebuildClassMasks();
+    int takeAnySeat();
+    int chooseSeat(const SeatRequest& request);
+    int releaseSeat(int seatNumber);
+    void moveSeat(int fromSeat, int toSeat, SeatMove& move);
+    int findPreferredSeat(const SeatRequest& request) const;
 public:
 
     SeatAllocator( int totalSeats = 10);
+    explicit SeatAllocator(const vector<CoachSpec>& coaches);
     // for copying
     std::unique_ptr<SeatAllocator> clone() const;
+    // same seats , layout and attributes with nothing allocated , held or waiting
+    std::unique_ptr<SeatAllocator> emptyCopy() const;
     SeatAllocator(const SeatAllocator& other);
     SeatAllocator& operator=(const SeatAllocator& other);
+    // flat bytes of the whole inventory (utils/BinaryCodec.h) , decode gives back an equal allocator
+    void encode(ByteWriter& out) const;
+    static std::unique_ptr<SeatAllocator> decode(ByteReader& in);
 
     void addSeats(int seats);
     void changeTotalSeats(int newTotalSeats);
 
     int freeSeat( int seatNumber);
     int allocateSeat( int passengerId);
+    int allocateSeat( int passengerId, const SeatRequest& request);
+    // the seat a lock-free claim picked (ConcurrentSeatAllocator) , -1 when it is no longer free
+    int allocateSeatAt(int passengerId, int seatNumber, bool flexible = false);
+    int holdSeat(int holdId, int passengerId, long long expiresAt, const SeatRequest& request = SeatRequest{});
+    int confirmHold(int holdId);
+    int releaseHold(int holdId);
+    void setLayout(const vector<CoachSpec>& coaches);
+    // one bounded slice of compaction : packs movable seats toward the front of their coach
+    // so free seats gather at the back . maxSteps bounds the work , not the moves
+    DefragReport defragment(int maxSteps, bool apply);
+    void tagSeats(int fromSeat, int toSeat, unsigned attributeMask);
+    void untagSeats(int fromSeat, int toSeat, unsigned attributeMask);
     int processWaitingList(int seatsToAdd, std::function<void(int)> bookCallback)  ;
 
 
@@ -41,6 +112,17 @@ public:
     int getAllocatedSeatCount() const;
     int getTotalSeats() const;
     int getWaitingListSize()const;
+    int getHeldSeatCount() const;
+    bool hasHold(int holdId) const;
+    SeatHold getHold(int holdId) const;
+    int getClassAvailableSeatCount(const std::string& seatClass) const;
+    const SeatLayout& getLayout() const;
+    unsigned getSeatAttributes(int seatNumber) const;
+    bool isSeatFree(int seatNumber) const;
+    const Bitset& getFreeSeats() const; // bit per seat number
+    int getSeatOwner(int seatNumber) const; // passenger holding the allocated seat , 0 otherwise
+    bool isSeatMovable(int seatNumber) const;
+    int getLargestFreeBlock() const;
 
     queue<int> getWaitingList()const;
 
@@ -0,0 +1,48 @@
+#ifndef RMS_SEATATTRIBUTES_H
+#define RMS_SEATATTRIBUTES_H
+
+#include <string>
+#include "../structures/bitset.h"
+
+class SeatLayout;
+
+// seat attributes , combined as a bit mask in SeatRequest::preferences
+enum SeatAttribute : unsigned
+{
+    SEAT_WINDOW = 1u << 0,
+    SEAT_AISLE = 1u << 1,
+    SEAT_LOWER_BERTH = 1u << 2,
+    SEAT_NEAR_DOOR = 1u << 3,
+    SEAT_ACCESSIBLE = 1u << 4
+};
+constexpr int SEAT_ATTRIBUTE_COUNT = 5;
+constexpr unsigned SEAT_ATTRIBUTE_ALL = (1u << SEAT_ATTRIBUTE_COUNT) - 1;
+
+// "window,lower" -> SEAT_WINDOW | SEAT_LOWER_BERTH
+unsigned parseSeatAttributes(const std::string &list);
+std::string seatAttributesToString(unsigned mask);
+
+// one bitset per attribute , indexed by seat number
+class SeatAttributes
+{
+private:
+    Bitset bits[SEAT_ATTRIBUTE_COUNT];
+    Bitset pinned[SEAT_ATTRIBUTE_COUNT]; // set or cleared by tag / untag , the default pattern leaves them alone
+
+public:
+    void resize(int totalSeats);
+    void tag(int fromSeat, int toSeat, unsigned mask);
+    void untag(int fromSeat, int toSeat, unsigned mask);
+    unsigned attributesOf(int seatNumber) const;
+    const Bitset &bitsOf(int attributeIndex) const;
+    const Bitset &pinnedBitsOf(int attributeIndex) const;
+    // decode : one attribute as it was encoded
+    void load(int attributeIndex, const Bitset &seats, const Bitset &pinnedSeats);
+
+    // coaches are laid out 4 abreast : window on the sides , aisle in the middle ,
+    // first and last row next to the doors . berths and accessibility are tagged explicitly ,
+    // and a seat tagged or untagged explicitly keeps that attribute
+    void applyDefaultPattern(const SeatLayout &layout, int fromSeat = 1);
+};
+
+#endif // RMS_SEATATTRIBUTES_H
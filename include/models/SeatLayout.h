@@ -0,0 +1,95 @@
+#ifndef RMS_SEATLAYOUT_H
+#define RMS_SEATLAYOUT_H
+
+#include <string>
+#include "../structures/vector.h"
+#include "../structures/unordered_map.h"
+#include "../structures/fenwickTree.h"
+
+// one coach of a layout description : class name + number of seats
+struct CoachSpec
+{
+    std::string seatClass;
+    int seats = 0;
+};
+
+// what the passenger asks for , empty fields mean "anything"
+struct SeatRequest
+{
+    std::string seatClass; // "" -> any class
+    int coach = 0;         // 0  -> any coach
+    unsigned preferences = 0; // SeatAttribute bits wanted , best effort
+    bool flexible = false;    // passenger accepts being moved inside the coach by defragmentation
+};
+
+// train -> class -> coach -> seats
+// every node keeps its free count so class availability is O(1)
+// and finding a coach with room inside a class is O(log coaches)
+class SeatLayout
+{
+public:
+    struct Coach
+    {
+        int number = 0;    // 1-based in train order
+        int firstSeat = 0; // seats are numbered contiguously across coaches
+        int seatCount = 0;
+        int freeSeats = 0;
+        int classIndex = 0;
+        int slot = 0; // position of the coach inside its class
+    };
+    struct SeatClass
+    {
+        std::string name;
+        int totalSeats = 0;
+        int freeSeats = 0;
+        vector<int> coaches;        // coach indexes in train order
+        FenwickTree<int> coachFree; // free seats per coach slot
+    };
+
+private:
+    vector<Coach> coaches;
+    vector<SeatClass> classes;
+    unordered_map<std::string, int> classLookup; // lower-case name -> class index
+    FenwickTree<int> trainFree;                  // free seats per coach (whole train)
+    int totalSeats = 0;
+    int freeSeats = 0;
+
+    void build(const vector<CoachSpec> &specs);
+    void rebuildIndex();
+    int coachIndexOf(int seatNumber) const;
+    void adjust(int seatNumber, int delta);
+
+public:
+    static const std::string DEFAULT_CLASS;
+
+    explicit SeatLayout(int totalSeats = 10);
+    explicit SeatLayout(const vector<CoachSpec> &specs);
+
+    int getTotalSeats() const;
+    int getFreeSeats() const;
+    int getCoachCount() const;
+    int getClassCount() const;
+    const Coach &getCoach(int coachNumber) const;
+    const SeatClass &getClass(int classIndex) const;
+    vector<CoachSpec> getCoachSpecs() const; // what the layout was built from , after any grow / shrink
+
+    int findClass(const std::string &seatClass) const; // -1 when unknown
+    int getClassFreeSeats(const std::string &seatClass) const;
+    int getClassTotalSeats(const std::string &seatClass) const;
+    int coachOf(int seatNumber) const;
+    std::string classOf(int seatNumber) const;
+
+    // first coach (train order) able to serve the request , nullptr when it is full
+    const Coach *findCoach(const SeatRequest &request) const;
+
+    void markAllocated(int seatNumber);
+    void markFree(int seatNumber);
+
+    void grow(int seats);   // extends the last coach
+    void shrink(int seats); // removes seats from the tail , caller guarantees they are free
+    void resetFree();       // every seat free again , structure kept
+
+    void printStatus() const;
+};
+
+#endif // RMS_SEATLAYOUT_H
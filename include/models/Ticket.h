@@ -12,6 +12,9 @@ enum Status
     booked,
     cancelled
 };
+class ByteWriter;
+class ByteReader;
+
 class Ticket
 {
     int id;
@@ -19,20 +22,28 @@ class Ticket
     int trainId;
     Passenger passenger;
     Status status;
+    int travelDate = 0; // yyyymmdd , 0 for the train's undated inventory
+    long long version = 0; // bumped by the repository on every save
 
 public:
 public:
     Ticket() = default;
-    Ticket(const int id,const int seat, const int trainId, Passenger p);
+    Ticket(const int id,const int seat, const int trainId, Passenger p, const int travelDate = 0);
     int getId() const;
+    long long getVersion() const;
+    void setVersion(long long version);
     int getSeat() const;
+    void setSeat(const int seat);
     Status getStatus() const;
     void setStatus(const Status& s);
     int getTrainId() const;
-    Passenger getPassenger() const;
+    int getTravelDate() const;
+    const Passenger &getPassenger() const;
     void setPassenger(const Passenger &p);
     void setId(const int newId);
     void print(const std::string& msg) const ;
+    void encode(ByteWriter& out) const;
+    static Ticket decode(ByteReader& in);
 
 };
 #endif // RMS_TICKET_H
@@ -3,18 +3,30 @@
 
 #include "SeatAllocator.h"
 #include <string>
+#include <map>
+#include <functional>
+
+class ByteWriter;
+class ByteReader;
 
 class Train {
 private:
     int id;
     std::string name;
     int totalSeats;
-    std::unique_ptr<SeatAllocator> seatAllocator;
+    std::unique_ptr<SeatAllocator> seatAllocator;   // undated inventory , also the template for departures
+    // departure date (yyyymmdd) -> inventory , created on the first booking of that date
+    // so dates nobody booked cost nothing
+    std::map<int, std::unique_ptr<SeatAllocator>> departures;
+    long long version = 0; // bumped by the repository on every save , 0 = never saved
+
+    void forEachInventory(const std::function<void(SeatAllocator&)>& fn);
 
 public:
     // Constructor
     Train() = default;
     Train(const int id, const std::string& name, const int totalSeats = 10);
+    Train(const int id, const std::string& name, const vector<CoachSpec>& coaches);
     ~Train() = default;
 
 
@@ -27,19 +39,35 @@ public:
     Train(Train&&) = default;
     Train& operator=(Train&&) = default;
 
+    // every inventory included , the version too
+    void encode(ByteWriter& out) const;
+    static Train decode(ByteReader& in);
+
     int getTrainId() const;
+    long long getVersion() const;
+    void setVersion(long long version);
     std::string getTrainName() const;
     SeatAllocator* getSeatAllocator() const;
+    SeatAllocator* getSeatAllocator(int travelDate);          // materializes the date
+    SeatAllocator* findSeatAllocator(int travelDate) const;   // nullptr when never booked
+    vector<int> getDepartureDates() const;
+    int getDepartureCount() const;
+    int evictDatesBefore(int travelDate);
 
     void setTrainName(const std::string& name);
     void setTrainId(int trainId);
     void setSeats(int seats);
     void addSeats(int seats);
+    void setCoachLayout(const vector<CoachSpec>& coaches);
+    void tagSeats(int fromSeat, int toSeat, unsigned attributes);
 
     bool hasAvailableSeats() const;
+    int getAvailableSeatCount(int travelDate) const;
 
     int getTotalSeats() const;
+    int getClassAvailability(const std::string& seatClass, int travelDate = 0) const;
     void trainStatus() const ;
+    void trainStatus(int travelDate) const ;
     void print(const std::string& msg) const ;
 
 };
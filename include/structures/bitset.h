@@ -0,0 +1,193 @@
+#ifndef RMS_BITSET_H
+#define RMS_BITSET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+
+// dynamic bitset stored in 64-bit words
+// set algebra is done word by word so "a AND b AND c" + find-first
+// touches 64 seats per instruction instead of one
+class Bitset
+{
+private:
+    std::vector<uint64_t> words;
+    size_t bits = 0;
+
+    static constexpr size_t WORD = 64;
+
+    // mask of the bits of word `w` that fall inside [from, to]
+    static uint64_t rangeMask(size_t w, size_t from, size_t to)
+    {
+        uint64_t mask = ~0ULL;
+        if (w == from / WORD)
+            mask &= ~0ULL << (from % WORD);
+        if (w == to / WORD && (to % WORD) != WORD - 1)
+            mask &= (1ULL << (to % WORD + 1)) - 1;
+        return mask;
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    Bitset() = default;
+    explicit Bitset(size_t size) { resize(size); }
+
+    // new bits start cleared , bits past the new size are dropped
+    void resize(size_t size)
+    {
+        words.resize((size + WORD - 1) / WORD, 0);
+        bits = size;
+        if (bits % WORD != 0 && !words.empty())
+            words.back() &= (1ULL << (bits % WORD)) - 1;
+    }
+
+    size_t size() const { return bits; }
+    size_t wordCount() const { return words.size(); }
+    const uint64_t *data() const { return words.data(); }
+
+    void set(size_t i) { words[i / WORD] |= 1ULL << (i % WORD); }
+    void reset(size_t i) { words[i / WORD] &= ~(1ULL << (i % WORD)); }
+    bool test(size_t i) const { return i < bits && (words[i / WORD] >> (i % WORD)) & 1ULL; }
+
+    void setRange(size_t from, size_t to) // inclusive
+    {
+        for (size_t w = from / WORD; w <= to / WORD; w++)
+            words[w] |= rangeMask(w, from, to);
+    }
+    void resetRange(size_t from, size_t to) // inclusive
+    {
+        for (size_t w = from / WORD; w <= to / WORD; w++)
+            words[w] &= ~rangeMask(w, from, to);
+    }
+    void clear()
+    {
+        for (auto &w : words)
+            w = 0;
+    }
+
+    size_t count() const
+    {
+        size_t total = 0;
+        for (uint64_t w : words)
+            total += std::popcount(w);
+        return total;
+    }
+    bool none() const
+    {
+        for (uint64_t w : words)
+            if (w)
+                return false;
+        return true;
+    }
+
+    // first set bit in [from, size) , npos when none
+    size_t findNext(size_t from) const
+    {
+        if (from >= bits)
+            return npos;
+        return findFirstIn(from, bits - 1);
+    }
+    size_t findFirst() const { return findNext(0); }
+
+    // first set bit in [from, to]
+    size_t findFirstIn(size_t from, size_t to) const
+    {
+        const Bitset *self = this;
+        return findFirstOfAll(&self, 1, from, to);
+    }
+
+    // first clear bit in [from, to] , npos when the range is all set
+    size_t findFirstClearIn(size_t from, size_t to) const
+    {
+        if (from > to || from >= bits)
+            return npos;
+        if (to >= bits)
+            to = bits - 1;
+        for (size_t w = from / WORD; w <= to / WORD; w++)
+        {
+            uint64_t word = ~words[w] & rangeMask(w, from, to);
+            if (word)
+                return w * WORD + std::countr_zero(word);
+        }
+        return npos;
+    }
+
+    // last set bit in [from, to] , npos when none
+    size_t findLastIn(size_t from, size_t to) const
+    {
+        if (from > to || from >= bits)
+            return npos;
+        if (to >= bits)
+            to = bits - 1;
+        for (size_t w = to / WORD + 1; w-- > from / WORD;)
+        {
+            uint64_t word = words[w] & rangeMask(w, from, to);
+            if (word)
+                return w * WORD + (WORD - 1 - std::countl_zero(word));
+        }
+        return npos;
+    }
+
+    // longest run of set bits inside [from, to] , its first index goes to *start
+    size_t longestRunIn(size_t from, size_t to, size_t *start = nullptr) const
+    {
+        size_t best = 0, bestStart = npos;
+        if (to >= bits)
+            to = bits - 1; // npos when empty , the loop below never runs
+        size_t pos = from;
+        while (bits > 0 && pos <= to)
+        {
+            size_t s = findFirstIn(pos, to);
+            if (s == npos || to - s + 1 <= best)
+                break; // nothing left long enough to win
+            size_t e = findFirstClearIn(s, to);
+            if (e == npos)
+                e = to + 1;
+            if (e - s > best)
+            {
+                best = e - s;
+                bestStart = s;
+            }
+            pos = e + 1;
+        }
+        if (start)
+            *start = bestStart;
+        return best;
+    }
+
+    // last set bit , npos when none
+    size_t findLast() const
+    {
+        for (size_t w = words.size(); w-- > 0;)
+            if (words[w])
+                return w * WORD + (WORD - 1 - std::countl_zero(words[w]));
+        return npos;
+    }
+
+    // first index in [from, to] set in every one of `sets`
+    // the sets must have the same size
+    static size_t findFirstOfAll(const Bitset *const *sets, size_t n, size_t from, size_t to)
+    {
+        if (n == 0 || from > to || from >= sets[0]->bits)
+            return npos;
+        if (to >= sets[0]->bits)
+            to = sets[0]->bits - 1;
+
+        for (size_t w = from / WORD; w <= to / WORD; w++)
+        {
+            uint64_t word = sets[0]->words[w];
+            for (size_t k = 1; k < n && word; k++)
+                word &= sets[k]->words[w];
+            word &= rangeMask(w, from, to);
+            if (word)
+                return w * WORD + std::countr_zero(word);
+        }
+        return npos;
+    }
+
+    bool operator==(const Bitset &other) const { return bits == other.bits && words == other.words; }
+};
+
+#endif // RMS_BITSET_H
@@ -0,0 +1,58 @@
+#ifndef RMS_BLOOMFILTER_H
+#define RMS_BLOOMFILTER_H
+
+#include "bitset.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// set membership with false positives and no false negatives : mightContain(key) false means
+// the key was never added . bitsPerKey bits per expected key and ln 2 of that many probes give
+// about 1 % false positives at 10 bits . the probes are double hashing of one 64-bit mix
+class BloomFilter
+{
+private:
+    size_t expected;
+    Bitset bits;
+    int probes;
+    size_t added = 0;
+
+    static uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+public:
+    explicit BloomFilter(size_t expected = 1024, int bitsPerKey = 10)
+        : expected(std::max<size_t>(expected, 1)), bits(this->expected * (size_t)std::max(bitsPerKey, 1)),
+          probes(std::max(1, (int)std::lround(std::max(bitsPerKey, 1) * 0.6931)))
+    {
+    }
+
+    void add(uint64_t key)
+    {
+        uint64_t h = mix(key), step = (h >> 32 | h << 32) | 1;
+        for (int i = 0; i < probes; i++, h += step)
+            bits.set(h % bits.size());
+        added++;
+    }
+
+    bool mightContain(uint64_t key) const
+    {
+        uint64_t h = mix(key), step = (h >> 32 | h << 32) | 1;
+        for (int i = 0; i < probes; i++, h += step)
+            if (!bits.test(h % bits.size()))
+                return false;
+        return true;
+    }
+
+    size_t count() const { return added; } // adds , a key added twice counts twice
+    size_t capacity() const { return expected; } // past it the false positive rate climbs
+    size_t sizeInBytes() const { return bits.wordCount() * sizeof(uint64_t); }
+};
+
+#endif // RMS_BLOOMFILTER_H
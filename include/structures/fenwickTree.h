@@ -0,0 +1,71 @@
+#ifndef RMS_FENWICKTREE_H
+#define RMS_FENWICKTREE_H
+
+#include <vector>
+#include <cstddef>
+
+// binary indexed tree over 0-based positions
+// add / prefix sum / "first position reaching a target" are all O(log n)
+template <typename T>
+class FenwickTree
+{
+private:
+    std::vector<T> tree; // 1-based internally
+    size_t n = 0;
+    size_t highBit = 0; // largest power of two <= n
+
+public:
+    FenwickTree() = default;
+    explicit FenwickTree(size_t size) { assign(size); }
+
+    // reset to `size` zeros
+    void assign(size_t size)
+    {
+        n = size;
+        tree.assign(n + 1, T{});
+        highBit = 1;
+        while (highBit * 2 <= n)
+            highBit *= 2;
+        if (n == 0)
+            highBit = 0;
+    }
+
+    size_t size() const { return n; }
+
+    void add(size_t index, T delta)
+    {
+        for (size_t i = index + 1; i <= n; i += i & (~i + 1))
+            tree[i] += delta;
+    }
+
+    // sum of [0, index]
+    T prefixSum(size_t index) const
+    {
+        T sum{};
+        for (size_t i = index + 1; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    }
+
+    T total() const { return n == 0 ? T{} : prefixSum(n - 1); }
+
+    // smallest position whose prefix sum is >= target, size() if none
+    // values must be non-negative
+    size_t lowerBound(T target) const
+    {
+        if (target <= T{})
+            return 0;
+        size_t pos = 0;
+        for (size_t step = highBit; step > 0; step >>= 1)
+        {
+            if (pos + step <= n && tree[pos + step] < target)
+            {
+                pos += step;
+                target -= tree[pos];
+            }
+        }
+        return pos; // 0-based index of the answer (== n when not reachable)
+    }
+};
+
+#endif // RMS_FENWICKTREE_H
@@ -493,6 +493,17 @@ public:
         return MapIterator<Key, Value>{find(item,root)};
     }
 
+    // first entry whose key is not less than item , end() when there is none
+    [[nodiscard]]MapIterator<Key, Value> lowerBound(const Key& item) const{
+        MapNode<Key, Value>* nodePtr = root;
+        MapNode<Key, Value>* best = nullptr;
+        while(nodePtr != nullptr){
+            if(nodePtr->data.first < item) nodePtr = nodePtr->right; // too small , go right
+            else{ best = nodePtr; nodePtr = nodePtr->left; } // candidate , look for a smaller one
+        }
+        return MapIterator<Key, Value>{best};
+    }
+
     [[nodiscard]]bool empty() const{
         return root == nullptr;
     }
@@ -5,6 +5,8 @@
 #ifndef RMS_MINHEAP_H
 #define RMS_MINHEAP_H
 #include <vector>
+#include <utility>
+#include <cstddef>
 template <class T>
 class MinHeap {
 private:
@@ -14,7 +16,7 @@ private:
         while(i > 0){
             int p = (i-1)/2;
             if(h[i] < h[p]){
-                swap(h[i], h[p]);
+                std::swap(h[i], h[p]);
                 i = p;
             } else break;
         }
@@ -30,7 +32,7 @@ private:
             if(r < n && h[r] < h[s]) s = r;
 
             if(s != i){
-                swap(h[i], h[s]);
+                std::swap(h[i], h[s]);
                 i = s;
             } else break;
         }
@@ -49,7 +51,7 @@ public:
         up(h.size()-1);
     }
 
-    T top(){
+    const T& top() const{
         return h[0];
     }
 
@@ -76,9 +78,13 @@ public:
         return true;
     }
 
-    bool empty(){
+    bool empty() const{
         return h.empty();
     }
+
+    size_t size() const{
+        return h.size();
+    }
 };
 
 #endif //RMS_MINHEAP_H
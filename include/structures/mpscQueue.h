@@ -0,0 +1,70 @@
+#ifndef RMS_MPSCQUEUE_H
+#define RMS_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// multi-producer single-consumer queue (linked , intrusive stub node)
+// push is one atomic exchange and never waits , so any number of threads
+// may push . only one thread at a time may call tryPop
+template <class T>
+class MpscQueue
+{
+private:
+    struct Node
+    {
+        std::atomic<Node *> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node *> head; // last pushed node , producers swap it
+    Node *tail;               // consumer side , always a consumed (or stub) node
+    std::atomic<int> count{0};
+
+public:
+    MpscQueue()
+    {
+        Node *stub = new Node();
+        head.store(stub);
+        tail = stub;
+    }
+    ~MpscQueue()
+    {
+        while (tail)
+        {
+            Node *next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(const T &value)
+    {
+        Node *node = new Node();
+        node->value = value;
+        count.fetch_add(1, std::memory_order_relaxed); // before the link , size never goes negative
+        Node *prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // false when empty , or when a producer is between its exchange and its link
+    bool tryPop(T &out)
+    {
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+        out = std::move(next->value);
+        delete tail;
+        tail = next;
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // counts pushes in flight , exact once producers are quiet
+    int size() const { return count.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+};
+
+#endif // RMS_MPSCQUEUE_H
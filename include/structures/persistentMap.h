@@ -0,0 +1,231 @@
+#ifndef RMS_PERSISTENTMAP_H
+#define RMS_PERSISTENTMAP_H
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// persistent AVL tree : nodes are never changed after they are built , an insert or erase
+// copies only the O(log n) nodes on the path to the key and shares the rest . a PersistentMap
+// is a handle on one root , so copying it is O(1) and the copy is a frozen snapshot that later
+// writes through the original handle never touch . a node is freed with the last handle using it
+template <class Key, class Value>
+class PersistentMap
+{
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        Key key;
+        Value value;
+        NodePtr left, right;
+        int height;
+        size_t size; // nodes in this subtree
+
+        Node(const Key &key, const Value &value, NodePtr left, NodePtr right)
+            : key(key), value(value), left(std::move(left)), right(std::move(right))
+        {
+            height = 1 + std::max(heightOf(this->left), heightOf(this->right));
+            size = 1 + sizeOf(this->left) + sizeOf(this->right);
+        }
+    };
+
+    NodePtr root;
+
+    static int heightOf(const NodePtr &n) { return n ? n->height : 0; }
+    static size_t sizeOf(const NodePtr &n) { return n ? n->size : 0; }
+
+    static NodePtr make(const Key &key, const Value &value, NodePtr left, NodePtr right)
+    {
+        return std::make_shared<const Node>(key, value, std::move(left), std::move(right));
+    }
+
+    // new node for (key , value) over left / right , rotated back into AVL shape
+    static NodePtr balance(const Key &key, const Value &value, NodePtr left, NodePtr right)
+    {
+        int diff = heightOf(left) - heightOf(right);
+        if (diff > 1)
+        {
+            if (heightOf(left->left) >= heightOf(left->right)) // single right rotation
+                return make(left->key, left->value, left->left, make(key, value, left->right, right));
+            const NodePtr &mid = left->right; // left-right
+            return make(mid->key, mid->value, make(left->key, left->value, left->left, mid->left),
+                        make(key, value, mid->right, right));
+        }
+        if (diff < -1)
+        {
+            if (heightOf(right->right) >= heightOf(right->left)) // single left rotation
+                return make(right->key, right->value, make(key, value, left, right->left), right->right);
+            const NodePtr &mid = right->left; // right-left
+            return make(mid->key, mid->value, make(key, value, left, mid->left),
+                        make(right->key, right->value, mid->right, right->right));
+        }
+        return make(key, value, std::move(left), std::move(right));
+    }
+
+    static NodePtr insert(const NodePtr &n, const Key &key, const Value &value)
+    {
+        if (!n)
+            return make(key, value, nullptr, nullptr);
+        if (key < n->key)
+            return balance(n->key, n->value, insert(n->left, key, value), n->right);
+        if (n->key < key)
+            return balance(n->key, n->value, n->left, insert(n->right, key, value));
+        return make(key, value, n->left, n->right); // replace , shape unchanged
+    }
+
+    // removes the smallest node of n , hands it back through min
+    static NodePtr eraseMin(const NodePtr &n, NodePtr &min)
+    {
+        if (!n->left)
+        {
+            min = n;
+            return n->right;
+        }
+        return balance(n->key, n->value, eraseMin(n->left, min), n->right);
+    }
+
+    static NodePtr erase(const NodePtr &n, const Key &key, bool &erased)
+    {
+        if (!n)
+            return nullptr;
+        if (key < n->key)
+        {
+            NodePtr left = erase(n->left, key, erased);
+            return erased ? balance(n->key, n->value, left, n->right) : n;
+        }
+        if (n->key < key)
+        {
+            NodePtr right = erase(n->right, key, erased);
+            return erased ? balance(n->key, n->value, n->left, right) : n;
+        }
+        erased = true;
+        if (!n->left)
+            return n->right;
+        if (!n->right)
+            return n->left;
+        NodePtr successor;
+        NodePtr right = eraseMin(n->right, successor);
+        return balance(successor->key, successor->value, n->left, right);
+    }
+
+public:
+    // in-order walk over one version , a stack of the nodes still to visit .
+    // stays valid while some handle on that version is alive
+    class Iterator
+    {
+    private:
+        std::vector<const Node *> stack;
+
+        void pushLeft(const Node *n)
+        {
+            for (; n; n = n->left.get())
+                stack.push_back(n);
+        }
+
+        friend class PersistentMap;
+
+    public:
+        const Key &key() const { return stack.back()->key; }
+        const Value &value() const { return stack.back()->value; }
+        bool done() const { return stack.empty(); }
+        Iterator &operator++()
+        {
+            const Node *n = stack.back();
+            stack.pop_back();
+            pushLeft(n->right.get());
+            return *this;
+        }
+    };
+
+    PersistentMap() = default;
+
+    size_t size() const { return sizeOf(root); }
+    bool empty() const { return !root; }
+
+    const Value *find(const Key &key) const
+    {
+        const Node *n = root.get();
+        while (n)
+        {
+            if (key < n->key)
+                n = n->left.get();
+            else if (n->key < key)
+                n = n->right.get();
+            else
+                return &n->value;
+        }
+        return nullptr;
+    }
+    bool contains(const Key &key) const { return find(key) != nullptr; }
+
+    // inserts or replaces , this handle moves to the new version
+    void insert(const Key &key, const Value &value) { root = insert(root, key, value); }
+    bool erase(const Key &key)
+    {
+        bool erased = false;
+        root = erase(root, key, erased);
+        return erased;
+    }
+    void clear() { root.reset(); }
+
+    Iterator begin() const
+    {
+        Iterator it;
+        it.pushLeft(root.get());
+        return it;
+    }
+
+    // first entry whose key is not less than key
+    Iterator lowerBound(const Key &key) const
+    {
+        Iterator it;
+        const Node *n = root.get();
+        while (n)
+        {
+            if (n->key < key)
+                n = n->right.get(); // it and its left side are too small
+            else
+            {
+                it.stack.push_back(n);
+                n = n->left.get();
+            }
+        }
+        return it;
+    }
+
+    // entry at in-order position index (0 based) , done() when index >= size .
+    // O(log n) through the subtree sizes , lets a scan be cut into ranges of positions
+    Iterator at(size_t index) const
+    {
+        Iterator it;
+        const Node *n = root.get();
+        while (n)
+        {
+            size_t leftSize = sizeOf(n->left);
+            if (index < leftSize)
+            {
+                it.stack.push_back(n);
+                n = n->left.get();
+            }
+            else if (index == leftSize)
+            {
+                it.stack.push_back(n);
+                break;
+            }
+            else
+            {
+                index -= leftSize + 1;
+                n = n->right.get();
+            }
+        }
+        if (n == nullptr)
+            it.stack.clear(); // ran off the tree , index was past the end
+        return it;
+    }
+};
+
+#endif // RMS_PERSISTENTMAP_H
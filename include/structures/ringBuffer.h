@@ -0,0 +1,110 @@
+#ifndef RMS_RINGBUFFER_H
+#define RMS_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+// bounded lock-free queue on a fixed array (Vyukov) : every slot carries a sequence number that
+// tells producers and consumers whose turn it is , so a push is one CAS on the tail and a
+// release store , nothing is allocated after construction . any number of threads may push and
+// pop ; tryPush fails instead of waiting when the ring is full . capacity is a power of two
+template <class T>
+class RingBuffer
+{
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> tail{0}; // next position to push
+    alignas(64) std::atomic<size_t> head{0}; // next position to pop
+
+    static size_t maskFor(size_t capacity)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument("ring capacity must be a power of two");
+        return capacity - 1;
+    }
+
+public:
+    explicit RingBuffer(size_t capacity) : mask(maskFor(capacity)), slots(new Slot[capacity])
+    {
+        for (size_t i = 0; i < capacity; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    // fill(slot value , position) writes the value in place once a slot is claimed , positions
+    // count pushes from 0 and are handed out in the order values will be popped
+    template <class Fill>
+    bool tryPushWith(Fill fill)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            long long lag = (long long)sequence - (long long)position;
+            if (lag == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    fill(slot.value, position);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+                return false; // the slot still holds the value from one lap ago
+            else
+                position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T &value)
+    {
+        return tryPushWith([&](T &slot, size_t) { slot = value; });
+    }
+
+    bool tryPop(T &out)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            long long lag = (long long)sequence - (long long)(position + 1);
+            if (lag == 0)
+            {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    out = slot.value;
+                    slot.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+                return false; // empty , or the producer of this slot has not finished
+            else
+                position = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+    // approximate while producers and consumers run
+    size_t size() const
+    {
+        size_t pushed = tail.load(std::memory_order_relaxed), popped = head.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+    bool empty() const { return size() == 0; }
+};
+
+#endif // RMS_RINGBUFFER_H
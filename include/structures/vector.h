@@ -5,6 +5,7 @@
 #ifndef RMS_VECTOR_H
 #define RMS_VECTOR_H
 
+#include <utility>
 #include <iostream>
 #include <algorithm> // for std::copy
 #include <stdexcept> // for std::out_of_range
@@ -20,9 +21,9 @@ private:
     void resize(size_t new_capacity){
         //allocate new memory
         T* new_data = new T[new_capacity];
-        //copy elements
+        //move elements , the old buffer is dropped right after
         for(size_t i = 0; i < current_size; i++){
-            new_data[i] = data[i];
+            new_data[i] = std::move(data[i]);
         }
         //delete old memory
         delete[] data;
@@ -95,6 +96,15 @@ public:
         current_size++;
     }
 
+    void push_back(T&& value){
+        if (current_size == current_capacity){
+            size_t new_capacity = (current_capacity == 0) ? 1 : current_capacity * 2;
+            resize(new_capacity);
+        }
+        data[current_size] = std::move(value);
+        current_size++;
+    }
+
     void pop_back(){
         if (current_size > 0) {
             current_size--;
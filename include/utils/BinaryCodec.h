@@ -0,0 +1,157 @@
+#ifndef RMS_BINARYCODEC_H
+#define RMS_BINARYCODEC_H
+
+#include "../structures/bitset.h"
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <bit>
+#include <array>
+
+// flat byte encoding of the models , no pointers inside : what it writes can be copied into
+// shared memory or a file and read back by another process . integers are in host byte order ,
+// the bytes are meant for the same machine , not for exchange
+class ByteWriter
+{
+private:
+    std::string bytes;
+
+    template <class T>
+    void putRaw(T value)
+    {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+public:
+    void putInt(int32_t value) { putRaw(value); }
+    void putLong(int64_t value) { putRaw(value); }
+    void putBool(bool value) { putRaw<uint8_t>(value ? 1 : 0); }
+    void putString(const std::string &value)
+    {
+        putInt((int32_t)value.size());
+        bytes.append(value);
+    }
+    // 7 bits per byte , small numbers take one byte
+    void putVarint(uint64_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            bytes.push_back((char)(value | 0x80));
+        bytes.push_back((char)value);
+    }
+    // zigzag first , so small negative deltas stay small too
+    void putSignedVarint(int64_t value) { putVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63)); }
+    void putBitset(const Bitset &bits)
+    {
+        putLong((int64_t)bits.size());
+        bytes.append(reinterpret_cast<const char *>(bits.data()), bits.wordCount() * sizeof(uint64_t));
+    }
+
+    const std::string &data() const { return bytes; }
+    size_t size() const { return bytes.size(); }
+    std::string take() { return std::move(bytes); }
+    void clear() { bytes.clear(); } // keeps the capacity , one writer can encode many records
+};
+
+// reads what ByteWriter wrote , throws std::runtime_error when the bytes run out
+class ByteReader
+{
+private:
+    const char *cursor;
+    const char *end;
+
+    void need(size_t n) const
+    {
+        if ((size_t)(end - cursor) < n)
+            throw std::runtime_error("Truncated record.\n");
+    }
+
+    template <class T>
+    T getRaw()
+    {
+        need(sizeof(T));
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+public:
+    ByteReader(const char *data, size_t size) : cursor(data), end(data + size) {}
+    explicit ByteReader(const std::string &bytes) : ByteReader(bytes.data(), bytes.size()) {}
+
+    int32_t getInt() { return getRaw<int32_t>(); }
+    int64_t getLong() { return getRaw<int64_t>(); }
+    bool getBool() { return getRaw<uint8_t>() != 0; }
+    std::string getString()
+    {
+        int32_t size = getInt();
+        if (size < 0)
+            throw std::runtime_error("Corrupt record.\n");
+        need((size_t)size);
+        std::string value(cursor, (size_t)size);
+        cursor += size;
+        return value;
+    }
+    uint64_t getVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            need(1);
+            uint8_t byte = (uint8_t)*cursor++;
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        throw std::runtime_error("Corrupt record.\n");
+    }
+    int64_t getSignedVarint()
+    {
+        uint64_t value = getVarint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+    Bitset getBitset()
+    {
+        int64_t size = getLong();
+        if (size < 0)
+            throw std::runtime_error("Corrupt record.\n");
+        Bitset bits((size_t)size);
+        size_t words = ((size_t)size + 63) / 64;
+        need(words * sizeof(uint64_t));
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t word;
+            std::memcpy(&word, cursor + w * sizeof(uint64_t), sizeof(uint64_t));
+            for (; word != 0; word &= word - 1)
+                bits.set(w * 64 + std::countr_zero(word));
+        }
+        cursor += words * sizeof(uint64_t);
+        return bits;
+    }
+
+    bool done() const { return cursor == end; }
+};
+
+// crc32 (IEEE) of the bytes , the checksum of the log frames and archive segments
+inline uint32_t crc32(const char *data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = []
+    {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+#endif // RMS_BINARYCODEC_H
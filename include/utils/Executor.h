@@ -0,0 +1,83 @@
+#ifndef RMS_EXECUTOR_H
+#define RMS_EXECUTOR_H
+
+#include "Task.h"
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <optional>
+
+// single-threaded run loop for Task coroutines : run() resumes ready coroutines
+// one at a time on the calling thread . other threads may only post() (completion
+// of work handed to the booking pipeline) , so coroutines never run concurrently
+class Executor
+{
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::coroutine_handle<>> ready;
+    int external = 0;             // suspended on work running elsewhere , run() waits for them
+    std::exception_ptr failure;   // first exception escaping a spawned task
+    std::atomic<long long> resumed{0}; // read by getResumeCount from any thread
+
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() { return Detached{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; } // frees itself
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); } // detach() catches everything
+        };
+        std::coroutine_handle<promise_type> handle;
+    };
+    static Detached detach(Executor *executor, Task<void> task);
+
+public:
+    struct YieldAwaiter
+    {
+        Executor *executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { executor->post(h); }
+        void await_resume() const noexcept {}
+    };
+
+    // back of the ready queue , lets every other ready coroutine run first
+    YieldAwaiter yield() { return YieldAwaiter{this}; }
+
+    void post(std::coroutine_handle<> h); // thread safe
+    // pairs around work finishing on another thread : begin before handing it off ,
+    // complete (from any thread) posts the coroutine back
+    void beginExternal();
+    void completeExternal(std::coroutine_handle<> h);
+
+    // starts the task on the next run() , its exception is rethrown by run()
+    void spawn(Task<void> task);
+    // resumes coroutines until none is ready and none waits on external work
+    void run();
+    long long getResumeCount() const;
+};
+
+// runs task to completion on executor and returns its value
+template <class T>
+T syncWait(Executor &executor, Task<T> task)
+{
+    std::optional<T> result;
+    executor.spawn([](Task<T> inner, std::optional<T> &out) -> Task<void> {
+        out = co_await inner;
+    }(std::move(task), result));
+    executor.run();
+    return std::move(*result);
+}
+
+inline void syncWait(Executor &executor, Task<void> task)
+{
+    executor.spawn(std::move(task));
+    executor.run();
+}
+
+#endif // RMS_EXECUTOR_H
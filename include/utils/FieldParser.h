@@ -0,0 +1,251 @@
+#ifndef RMS_FIELDPARSER_H
+#define RMS_FIELDPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <utility>
+#include <charconv>
+
+// field parsers for one line of a CSV or JSON-lines file . the fields come back as views into
+// the line , nothing is copied unless a value has escapes to undo ; those copies live in
+// `unescaped` (a list , so growing it never moves the strings the views point at)
+struct ParsedFields
+{
+    std::vector<std::string_view> values;                              // CSV : by column
+    std::vector<std::pair<std::string_view, std::string_view>> members; // JSON : key , value
+    std::list<std::string> unescaped;
+
+    void clear()
+    {
+        values.clear();
+        members.clear();
+        unescaped.clear();
+    }
+
+    // JSON member value by key , empty view and false when the key is missing
+    bool find(std::string_view key, std::string_view &value) const
+    {
+        for (const auto &member : members)
+            if (member.first == key)
+            {
+                value = member.second;
+                return true;
+            }
+        return false;
+    }
+};
+
+// comma separated , a field may be quoted and then holds commas and "" for a quote .
+// one record per line , quoted line breaks are not supported . false and error set on a bad line
+inline bool parseCsvLine(std::string_view line, ParsedFields &out, std::string &error)
+{
+    out.clear();
+    size_t i = 0;
+    while (true)
+    {
+        if (i < line.size() && line[i] == '"')
+        {
+            size_t start = ++i;
+            bool escaped = false;
+            while (true)
+            {
+                size_t quote = line.find('"', i);
+                if (quote == std::string_view::npos)
+                {
+                    error = "unterminated quoted field";
+                    return false;
+                }
+                if (quote + 1 < line.size() && line[quote + 1] == '"')
+                {
+                    escaped = true;
+                    i = quote + 2;
+                    continue;
+                }
+                i = quote + 1;
+                break;
+            }
+            std::string_view raw = line.substr(start, i - 1 - start);
+            if (escaped)
+            {
+                std::string &copy = out.unescaped.emplace_back();
+                for (size_t k = 0; k < raw.size(); k++)
+                {
+                    copy += raw[k];
+                    if (raw[k] == '"')
+                        k++; // "" -> "
+                }
+                raw = copy;
+            }
+            out.values.push_back(raw);
+            if (i < line.size() && line[i] != ',')
+            {
+                error = "text after a quoted field";
+                return false;
+            }
+        }
+        else
+        {
+            size_t comma = line.find(',', i);
+            size_t end = comma == std::string_view::npos ? line.size() : comma;
+            out.values.push_back(line.substr(i, end - i));
+            i = end;
+        }
+        if (i >= line.size())
+            return true;
+        i++; // the comma
+    }
+}
+
+// one flat JSON object per line : string , number , true / false / null values . nested objects
+// and arrays are refused . string values come back without their quotes
+inline bool parseJsonLine(std::string_view line, ParsedFields &out, std::string &error)
+{
+    out.clear();
+    size_t i = 0;
+    auto skipSpace = [&]
+    {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+            i++;
+    };
+    auto readString = [&](std::string_view &value) -> bool
+    {
+        if (i >= line.size() || line[i] != '"')
+        {
+            error = "expected a string";
+            return false;
+        }
+        size_t start = ++i;
+        bool escaped = false;
+        while (i < line.size() && line[i] != '"')
+        {
+            if (line[i] == '\\')
+            {
+                escaped = true;
+                i++;
+            }
+            i++;
+        }
+        if (i >= line.size())
+        {
+            error = "unterminated string";
+            return false;
+        }
+        value = line.substr(start, i - start);
+        i++; // closing quote
+        if (!escaped)
+            return true;
+        std::string &copy = out.unescaped.emplace_back();
+        for (size_t k = 0; k < value.size(); k++)
+        {
+            char c = value[k];
+            if (c != '\\')
+            {
+                copy += c;
+                continue;
+            }
+            switch (value[++k])
+            {
+            case 'n': copy += '\n'; break;
+            case 't': copy += '\t'; break;
+            case 'r': copy += '\r'; break;
+            case 'b': copy += '\b'; break;
+            case 'f': copy += '\f'; break;
+            case 'u':
+            {
+                unsigned code = 0;
+                if (k + 4 >= value.size() ||
+                    std::from_chars(value.data() + k + 1, value.data() + k + 5, code, 16).ptr != value.data() + k + 5 ||
+                    code > 0x7F)
+                {
+                    error = "only ASCII \\u escapes are supported";
+                    return false;
+                }
+                copy += (char)code;
+                k += 4;
+                break;
+            }
+            default: copy += value[k]; // \" \\ \/
+            }
+        }
+        value = copy;
+        return true;
+    };
+
+    skipSpace();
+    if (i >= line.size() || line[i] != '{')
+    {
+        error = "expected an object";
+        return false;
+    }
+    i++;
+    skipSpace();
+    if (i < line.size() && line[i] == '}')
+        return true;
+    while (true)
+    {
+        std::string_view key, value;
+        skipSpace();
+        if (!readString(key))
+            return false;
+        skipSpace();
+        if (i >= line.size() || line[i] != ':')
+        {
+            error = "expected ':'";
+            return false;
+        }
+        i++;
+        skipSpace();
+        if (i < line.size() && line[i] == '"')
+        {
+            if (!readString(value))
+                return false;
+        }
+        else
+        {
+            size_t start = i;
+            while (i < line.size() && line[i] != ',' && line[i] != '}' && line[i] != ' ' && line[i] != '\t')
+                i++;
+            value = line.substr(start, i - start);
+            if (value.empty() || value[0] == '{' || value[0] == '[')
+            {
+                error = "nested or empty values are not supported";
+                return false;
+            }
+        }
+        out.members.emplace_back(key, value);
+        skipSpace();
+        if (i < line.size() && line[i] == ',')
+        {
+            i++;
+            continue;
+        }
+        if (i < line.size() && line[i] == '}')
+        {
+            i++;
+            skipSpace();
+            if (i != line.size())
+            {
+                error = "text after the object";
+                return false;
+            }
+            return true;
+        }
+        error = "expected ',' or '}'";
+        return false;
+    }
+}
+
+// whole field as a base-10 int , no allocation
+inline bool parseIntField(std::string_view text, int &value)
+{
+    while (!text.empty() && text.front() == ' ')
+        text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ')
+        text.remove_suffix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+#endif // RMS_FIELDPARSER_H
@@ -0,0 +1,64 @@
+#ifndef RMS_OPTIMISTICRETRY_H
+#define RMS_OPTIMISTICRETRY_H
+
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+
+// a versioned save lost against a newer write , the whole read-modify-write may be retried
+class ConcurrencyConflict : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct RetryStats
+{
+    std::atomic<long long> commits{0};
+    std::atomic<long long> conflicts{0}; // aborted attempts , a commit may follow several
+};
+
+// runs attempt() until it returns without a ConcurrencyConflict , any other exception
+// goes straight to the caller . backs off (yield , then short sleeps) between attempts
+// and rethrows the conflict after maxAttempts
+template <typename Fn>
+auto retryOnConflict(Fn &&attempt, int maxAttempts = 32, RetryStats *stats = nullptr) -> decltype(attempt())
+{
+    for (int tries = 1;; tries++)
+    {
+        try
+        {
+            if constexpr (std::is_void_v<decltype(attempt())>)
+            {
+                attempt();
+                if (stats)
+                    stats->commits++;
+                return;
+            }
+            else
+            {
+                auto result = attempt();
+                if (stats)
+                    stats->commits++;
+                return result;
+            }
+        }
+        catch (const ConcurrencyConflict &)
+        {
+            if (stats)
+                stats->conflicts++;
+            if (tries >= maxAttempts)
+                throw;
+        }
+        if (tries < 4)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(1 << std::min(tries - 4, 10)));
+    }
+}
+
+#endif // RMS_OPTIMISTICRETRY_H
@@ -0,0 +1,36 @@
+#ifndef RMS_STRIPEDLOCK_H
+#define RMS_STRIPEDLOCK_H
+
+#include <mutex>
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+
+// fixed pool of mutexes , a key always maps to the same stripe
+// so two trains only contend when they share a stripe .
+// recursive because a service re-enters for the same train
+// (cancel -> promote the waiting passenger -> book)
+class StripedLock
+{
+private:
+    std::unique_ptr<std::recursive_mutex[]> stripes;
+    size_t count;
+
+public:
+    explicit StripedLock(size_t stripeCount = 64) : count(stripeCount)
+    {
+        if (stripeCount == 0)
+            throw std::invalid_argument("Stripe count must be greater than zero");
+        stripes = std::make_unique<std::recursive_mutex[]>(stripeCount);
+    }
+
+    size_t stripeOf(int key) const { return static_cast<size_t>(static_cast<unsigned>(key)) % count; }
+    size_t stripeCount() const { return count; }
+
+    std::unique_lock<std::recursive_mutex> lock(int key)
+    {
+        return std::unique_lock<std::recursive_mutex>(stripes[stripeOf(key)]);
+    }
+};
+
+#endif // RMS_STRIPEDLOCK_H
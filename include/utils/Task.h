@@ -0,0 +1,149 @@
+#ifndef RMS_TASK_H
+#define RMS_TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template <class T>
+class Task;
+
+namespace detail
+{
+    // shared by Task<T> and Task<void> : lazy start , resume the awaiting coroutine at the end .
+    // the awaiter runs the task inline and `finished` decides who continues the awaiting side :
+    // a task completing before the awaiter gives up lets it carry on without another resume ,
+    // so a loop of synchronously completing awaits never nests frames (symmetric transfer is
+    // only a tail call in optimized builds)
+    struct TaskPromiseBase
+    {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+        std::atomic<bool> finished{false};
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            template <class Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept
+            {
+                TaskPromiseBase &promise = self.promise();
+                if (promise.finished.exchange(true, std::memory_order_acq_rel))
+                    return promise.continuation; // the awaiter already suspended , wake it
+                return std::noop_coroutine();    // still inside the awaiter , it carries on
+            }
+            void await_resume() noexcept {}
+        };
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+}
+
+// lazily started coroutine producing a T , runs when co_awaited
+// (or when handed to Executor::spawn / syncWait) , exceptions surface at the co_await
+template <class T>
+class Task
+{
+public:
+    struct promise_type : detail::TaskPromiseBase
+    {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_value(T v) { value = std::move(v); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+public:
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return handle.done(); }
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        handle.promise().continuation = awaiting;
+        handle.resume();
+        return !handle.promise().finished.exchange(true, std::memory_order_acq_rel);
+    }
+    T await_resume()
+    {
+        if (handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+        return std::move(*handle.promise().value);
+    }
+};
+
+template <>
+class Task<void>
+{
+public:
+    struct promise_type : detail::TaskPromiseBase
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() {}
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+public:
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return handle.done(); }
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        handle.promise().continuation = awaiting;
+        handle.resume();
+        return !handle.promise().finished.exchange(true, std::memory_order_acq_rel);
+    }
+    void await_resume()
+    {
+        if (handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+    }
+};
+
+#endif // RMS_TASK_H
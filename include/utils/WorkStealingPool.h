@@ -0,0 +1,88 @@
+#ifndef RMS_WORKSTEALINGPOOL_H
+#define RMS_WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <exception>
+
+struct WorkStealingStats
+{
+    long long executed = 0; // tasks run by workers or helping callers
+    long long stolen = 0;   // of those , taken from another worker's deque
+};
+
+// fixed set of workers , each with its own deque : a worker pushes and pops at the back
+// of its deque (newest first , cache warm) and when it runs dry steals the oldest task
+// from the front of another one , so a range split in halves spreads itself over the
+// workers . a thread waiting on parallelFor runs queued tasks while there are any , which
+// keeps nested parallel loops from deadlocking , and sleeps until its loop is done otherwise
+class WorkStealingPool
+{
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // one per worker
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::atomic<unsigned> nextQueue{0}; // round robin for submits from outside the pool
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<long long> executed{0};
+    std::atomic<long long> stolen{0};
+
+    int currentIndex() const; // worker index of the calling thread , -1 outside the pool
+    void push(std::function<void()> task);
+    bool runOne(int self); // pops or steals one task and runs it , false when none was found
+    void workerLoop(int index);
+
+public:
+    explicit WorkStealingPool(int threads = 0); // 0 -> one per hardware thread
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int getThreadCount() const;
+    WorkStealingStats getStats() const;
+
+    // fire and forget , an exception escaping the task is dropped
+    void submit(std::function<void()> task);
+
+    // body(lo , hi) over sub-ranges of [begin , end) no longer than grain , in parallel .
+    // returns when every piece ran , rethrows the first exception thrown by body
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body);
+
+    // map(lo , hi) -> T per block of grain , blocks folded left to right with combine
+    template <class T, class Map, class Combine>
+    T parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map map, Combine combine)
+    {
+        if (grain == 0)
+            grain = 1;
+        size_t blocks = end > begin ? (end - begin + grain - 1) / grain : 0;
+        std::vector<T> partials(blocks, identity);
+        parallelFor(0, blocks, 1, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++)
+            {
+                size_t lo = begin + b * grain;
+                size_t hi = lo + grain < end ? lo + grain : end;
+                partials[b] = map(lo, hi);
+            }
+        });
+        T result = identity;
+        for (auto &partial : partials)
+            result = combine(std::move(result), std::move(partial));
+        return result;
+    }
+};
+
+#endif // RMS_WORKSTEALINGPOOL_H
@@ -5,6 +5,7 @@
 #ifndef RMS_HELPERS_H
 #define RMS_HELPERS_H
 #include <string>
+#include <string_view>
 #include "../structures/vector.h"
 #include "models/Train.h"
 #include "models/Passenger.h"
@@ -13,7 +14,7 @@
 // string validation
 std::string toLowerCase(std::string word);
 std::string trim(const std::string &str);
-bool isValidName(const std::string& name);
+bool isValidName(std::string_view name);
 // string concat
 std::string combineString(const vector<std::string>& args, int start);
 std::string combineString(const vector<std::string>& args, int start , int end);
@@ -21,6 +22,11 @@ bool compareString(const std::string& str1 , const std::string& str2);
 // integer helpers
 bool isInteger(const std::string& str);
 int parseInt(const std::string& arg , const std::string& argName);
+// date helpers , dates are yyyymmdd integers and 0 means "no date"
+bool isValidDate(int date);
+int parseDate(const std::string& date); // "2026-10-19" -> 20261019
+std::string formatDate(int date);       // 20261019 -> "2026-10-19"
+int todayDate();
 
 // print msg
 
@@ -0,0 +1,129 @@
+#include "AsyncRMSFacade.h"
+#include <stdexcept>
+
+struct AsyncRMSFacade::PipelineBooking
+{
+    RMSFacade *facade;
+    Executor *executor;
+    int trainId;
+    const std::string &passengerName;
+    const SeatRequest &request;
+    const std::string &travelDate;
+    std::optional<Ticket> result;
+    std::exception_ptr error;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        // counted before the hand off so run() keeps waiting for the callback
+        executor->beginExternal();
+        try
+        {
+            facade->bookTicketAsync(trainId, passengerName, [this, h](const std::optional<Ticket> &ticket, std::exception_ptr e) {
+                result = ticket;
+                error = e;
+                executor->completeExternal(h); // worker thread , resumed later on the executor
+            }, request, travelDate);
+        }
+        catch (...)
+        {
+            // rejected before reaching the pipeline (validation) , resume with the error
+            error = std::current_exception();
+            executor->completeExternal(h);
+        }
+    }
+    std::optional<Ticket> await_resume()
+    {
+        if (error)
+            std::rethrow_exception(error);
+        return std::move(result);
+    }
+};
+
+AsyncRMSFacade::AsyncRMSFacade(RMSFacade *facade, TrainService *ts, TicketService *tks, Executor *executor, int chunkSize)
+    : facade(facade), trainService(ts), ticketService(tks), executor(executor), chunkSize(chunkSize)
+{
+    if (chunkSize <= 0)
+        throw std::invalid_argument("Chunk size must be greater than 0");
+}
+
+Executor &AsyncRMSFacade::getExecutor()
+{
+    return *executor;
+}
+
+int AsyncRMSFacade::getChunkSize() const
+{
+    return chunkSize;
+}
+
+Task<std::optional<Ticket>> AsyncRMSFacade::bookTicket(int trainId, std::string passengerName)
+{
+    SeatRequest anySeat;
+    return bookTicket(trainId, std::move(passengerName), anySeat);
+}
+
+Task<std::optional<Ticket>> AsyncRMSFacade::bookTicket(int trainId, std::string passengerName, SeatRequest request, std::string travelDate)
+{
+    if (facade->isAsyncBookingEnabled())
+        co_return co_await PipelineBooking{facade, executor, trainId, passengerName, request, travelDate, std::nullopt, nullptr};
+
+    std::optional<Ticket> ticket = facade->bookTicket(trainId, passengerName, request, travelDate);
+    co_await executor->yield();
+    co_return ticket;
+}
+
+Task<void> AsyncRMSFacade::cancelTicket(int ticketId)
+{
+    facade->cancelTicket(ticketId); // promotes at most one waiting passenger , short enough to run inline
+    co_await executor->yield();
+}
+
+Task<vector<Train>> AsyncRMSFacade::listTrains()
+{
+    vector<Train> result;
+    int lastId = 0;
+    while (true)
+    {
+        vector<Train> page = trainService->getTrainsPage(lastId, chunkSize);
+        for (auto &train : page)
+            result.push_back(std::move(train));
+        if ((int)page.size() < chunkSize)
+            break;
+        lastId = page[page.size() - 1].getTrainId();
+        co_await executor->yield();
+    }
+    co_return result;
+}
+
+Task<vector<Ticket>> AsyncRMSFacade::listTickets()
+{
+    vector<Ticket> result;
+    int lastId = 0;
+    while (true)
+    {
+        vector<Ticket> page = ticketService->getTicketsPage(lastId, chunkSize);
+        for (auto &ticket : page)
+            result.push_back(std::move(ticket));
+        if ((int)page.size() < chunkSize)
+            break;
+        lastId = page[page.size() - 1].getId();
+        co_await executor->yield();
+    }
+    co_return result;
+}
+
+Task<Train> AsyncRMSFacade::updateTrain(int trainId, std::string name, int seats)
+{
+    // the train lock is recursive and every coroutine shares this thread , so it is only held
+    // inside resizeTrain : holding it across a suspension would not keep the others out
+    std::vector<std::pair<int, int>> promoted = facade->resizeTrain(trainId, name, seats);
+
+    for (size_t i = 0; i < promoted.size(); i++)
+    {
+        ticketService->promoteWaitingPassenger(trainId, promoted[i].second, promoted[i].first); // publishes the outcome
+        if ((i + 1) % chunkSize == 0)
+            co_await executor->yield();
+    }
+    co_return trainService->getTrain(trainId);
+}
@@ -76,7 +76,7 @@ void CLIController::show_help()
     cout << "   train seats add <id> <count>                   - Increase seat count\n";
     cout << "   train availability <id>                        - Show seat status\n";
     cout << "   train get <id>                                 - Show train details\n\n";
-    cout << "   train status <id>                              - Show full train status\n\n";
+    cout << "   train status <id> [YYYY-MM-DD]                 - Show full train status\n\n";
 
     // ====================== PASSENGER ======================
     cout << "passenger:\n";
@@ -89,10 +89,20 @@ void CLIController::show_help()
     // ======================== TICKET ========================
     cout << "ticket:\n";
     cout << "   ticket list                                    - Show all tickets\n";
-    cout << "   ticket book <trainId> <passengerName>          - Book a ticket\n";
+    cout << "   ticket book <trainId> <passengerName> [date]   - Book a ticket (date YYYY-MM-DD)\n";
     cout << "   ticket cancel <ticketId>                       - Cancel a ticket\n";
     cout << "   ticket get <ticketId>                          - Show ticket details\n\n";
 
+    // ======================== IMPORT ========================
+    cout << "import:\n";
+    cout << "   import <trains|passengers|tickets> <file> [errors.csv]\n";
+    cout << "                                                  - Bulk load a .csv or .jsonl file\n\n";
+
+    // ======================== EXPORT ========================
+    cout << "export:\n";
+    cout << "   export tickets <file|->                        - Dump every ticket (.csv .jsonl .bin)\n";
+    cout << "   export manifest <trainId|all> <file|-> [date]  - Booked seats per train\n\n";
+
     // ========================= SYSTEM ========================
     cout << "system:\n";
     cout << "   help | h | ?                                   - Show help menu\n";
@@ -160,7 +170,7 @@ void CLIController::list_tickets()
          << setw(15) << "passengerId"
          << setw(20) << "passenger_name"
          << setw(15) << "status"
-         << endl;
+         << "\n";
 
     for (auto &ticket : tickets)
     {
@@ -171,8 +181,9 @@ void CLIController::list_tickets()
              << setw(15) << ticket.getPassenger().getId()
              << setw(20) << ticket.getPassenger().getName()
              << setw(15) << ((ticket.getStatus() == booked) ? "Booked" : "Cancelled")
-             << endl;
+             << "\n";
     }
+    cout.flush();
 }
 
 CLIController::CLIController(RMSFacade *facade) : facade(facade)
@@ -339,6 +350,16 @@ void CLIController::run()
             break;
         }
 
+            // ===================== IMPORT =====================
+        case MainCmd::IMPORT:
+            import_file(args);
+            break;
+
+            // ===================== EXPORT =====================
+        case MainCmd::EXPORT:
+            export_file(args);
+            break;
+
             // ===================== SYSTEM =====================
         case MainCmd::SYSTEM:
         {
@@ -449,8 +470,8 @@ void CLIController::add_train(const vector<string> &args)
 void CLIController::book_ticket(const vector<string> &args)
 {
     if (args.size() < 4)
-    { // book ticket <train_id> <passenger_name>
-        cout << "Usage: ticket book  <train_id> <passenger_name>\n";
+    { // book ticket <train_id> <passenger_name> [YYYY-MM-DD]
+        cout << "Usage: ticket book  <train_id> <passenger_name> [YYYY-MM-DD]\n";
         return;
     }
 
@@ -460,9 +481,18 @@ void CLIController::book_ticket(const vector<string> &args)
     try
     {
         int trainId = parseInt(trainIdArg, "train ID");
-        passengerName = combineString(args, 3);
+        // a trailing YYYY-MM-DD is the travel date , not part of the name
+        string travelDate;
+        int nameEnd = args.size();
+        const string &last = args[args.size() - 1];
+        if (args.size() > 4 && last.size() == 10 && last[4] == '-' && last[7] == '-')
+        {
+            travelDate = last;
+            nameEnd--;
+        }
+        passengerName = combineString(args, 3, nameEnd);
 
-        auto t = facade->bookTicket(trainId, passengerName);
+        auto t = facade->bookTicket(trainId, passengerName, SeatRequest{}, travelDate);
         if (t.has_value())
         {
             cout << "\033[32m"; // green
@@ -508,6 +538,84 @@ void CLIController::cancel_ticket(const vector<string> &args)
     }
 }
 
+void CLIController::import_file(const vector<string> &args)
+{
+    if (args.size() < 3)
+    { // import <kind> <file> [errorReport]
+        cout << "Usage: import <trains|passengers|tickets> <file.csv|file.jsonl> [errors.csv]\n";
+        return;
+    }
+
+    try
+    {
+        ImportOptions options;
+        if (args.size() > 3)
+            options.errorReportPath = args[3];
+        ImportReport report = facade->importFile(BulkImporter::parseKind(args[1]), args[2], options);
+
+        cout << "\033[32m"; // green
+        cout << "--- Import Finished ---\n";
+        cout << "Records   : " << report.records << "\n";
+        cout << "Imported  : " << report.imported;
+        if (report.waitlisted > 0)
+            cout << " (" << report.waitlisted << " waitlisted)";
+        cout << "\n";
+        cout << "Rejected  : " << report.rejected << "\n";
+        cout << "Time      : " << std::fixed << std::setprecision(1) << report.ms << " ms , "
+             << std::setprecision(0) << report.recordsPerSecond() << " records/s\n";
+        cout.unsetf(std::ios::floatfield);
+        cout << "-----------------------\n";
+        cout << "\033[0m";
+        if (report.rejected > 0 && !options.errorReportPath.empty())
+            cout << "Rejected records written to " << options.errorReportPath << "\n";
+    }
+    catch (const exception &e)
+    {
+        std::cerr << "\033[31m" << "ERROR: Could not import " << args[2] << "." << "\n";
+        std::cerr << "Details: " << e.what() << "\033[0m" << "\n";
+    }
+}
+
+void CLIController::export_file(const vector<string> &args)
+{
+    bool manifest = args.size() > 1 && toLowerCase(args[1]) == "manifest";
+    if (args.size() < 3 || (manifest && args.size() < 4) || (!manifest && toLowerCase(args[1]) != "tickets"))
+    {
+        cout << "Usage: export tickets <file|->\n";
+        cout << "       export manifest <trainId|all> <file|-> [YYYY-MM-DD]\n";
+        return;
+    }
+
+    const string &path = manifest ? args[3] : args[2];
+    try
+    {
+        ExportOptions options;
+        options.manifest = manifest;
+        if (manifest && toLowerCase(args[2]) != "all")
+            options.trainId = parseInt(args[2], "train ID");
+        if (manifest && args.size() > 4)
+            options.travelDate = parseDate(args[4]);
+        ExportReport report = facade->exportTickets(path, options);
+
+        if (path == "-")
+            return; // the summary would end up in the export
+        cout << "\033[32m"; // green
+        cout << "--- Export Finished ---\n";
+        cout << "Tickets   : " << report.records << "\n";
+        cout << "Bytes     : " << report.bytes << "\n";
+        cout << "Time      : " << std::fixed << std::setprecision(1) << report.ms << " ms , "
+             << std::setprecision(0) << report.recordsPerSecond() << " records/s\n";
+        cout.unsetf(std::ios::floatfield);
+        cout << "-----------------------\n";
+        cout << "\033[0m";
+    }
+    catch (const exception &e)
+    {
+        std::cerr << "\033[31m" << "ERROR: Could not export to " << path << "." << "\n";
+        std::cerr << "Details: " << e.what() << "\033[0m" << "\n";
+    }
+}
+
 void CLIController::update_train(const vector<string> &args)
 {
 
@@ -648,14 +756,14 @@ void CLIController::get_train_status(const vector<string> &args)
 {
     if (args.size() < 3)
     {
-        cout << "Usage: train status  <trainId>\n";
+        cout << "Usage: train status  <trainId> [YYYY-MM-DD]\n";
         return;
     }
     const string &trainArg = args[2];
     try
     {
         int trainId = parseInt(trainArg, "train Id");
-        facade->trainStatus(trainId);
+        facade->trainStatus(trainId, args.size() > 3 ? args[3] : "");
     }
     catch (const exception &e)
     {
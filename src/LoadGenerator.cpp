@@ -0,0 +1,281 @@
+#include "LoadGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+const char *loadOpName(LoadOp op)
+{
+    switch (op)
+    {
+    case LoadOp::Book:
+        return "book";
+    case LoadOp::Cancel:
+        return "cancel";
+    case LoadOp::Lookup:
+        return "lookup";
+    case LoadOp::List:
+        return "list";
+    }
+    return "?";
+}
+
+ZipfDistribution::ZipfDistribution(int n, double skew)
+{
+    if (n <= 0)
+        throw std::invalid_argument("Zipf needs at least one rank");
+    if (skew < 0)
+        throw std::invalid_argument("Zipf skew cannot be negative");
+    double sum = 0;
+    for (int k = 1; k <= n; k++)
+    {
+        sum += 1.0 / std::pow((double)k, skew);
+        cdf.push_back(sum);
+    }
+    for (auto &c : cdf)
+        c /= sum;
+}
+
+int ZipfDistribution::operator()(std::mt19937_64 &rng) const
+{
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    auto it = std::lower_bound(cdf.begin(), cdf.end(), u);
+    return it == cdf.end() ? (int)cdf.size() : (int)(it - cdf.begin()) + 1;
+}
+
+// ---------------- histogram ----------------
+
+static constexpr int EXACT_BUCKETS = 64;
+static constexpr int SUB_BUCKETS = 32;
+static constexpr int BUCKETS = EXACT_BUCKETS + 58 * SUB_BUCKETS;
+
+int LatencyHistogram::indexOf(uint64_t ns)
+{
+    if (ns < EXACT_BUCKETS)
+        return (int)ns;
+    int shift = (int)std::bit_width(ns) - 6; // keeps the top 6 bits , 32..63
+    return EXACT_BUCKETS + (shift - 1) * SUB_BUCKETS + (int)(ns >> shift) - SUB_BUCKETS;
+}
+
+uint64_t LatencyHistogram::upperBoundOf(int index)
+{
+    if (index < EXACT_BUCKETS)
+        return (uint64_t)index;
+    int shift = (index - EXACT_BUCKETS) / SUB_BUCKETS + 1;
+    uint64_t top = (uint64_t)((index - EXACT_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS);
+    return ((top + 1) << shift) - 1;
+}
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKETS, 0) {}
+
+void LatencyHistogram::record(long long ns)
+{
+    if (ns < 0)
+        ns = 0;
+    counts[indexOf((uint64_t)ns)]++;
+    total++;
+    maxValue = std::max(maxValue, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BUCKETS; i++)
+        counts[i] += other.counts[i];
+    total += other.total;
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+long long LatencyHistogram::count() const
+{
+    return total;
+}
+
+long long LatencyHistogram::max() const
+{
+    return maxValue;
+}
+
+long long LatencyHistogram::percentile(double q) const
+{
+    if (total == 0)
+        return 0;
+    long long rank = std::max(1LL, (long long)std::ceil(q * (double)total));
+    long long seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return std::min((long long)upperBoundOf(i), maxValue);
+    }
+    return maxValue;
+}
+
+double LoadReport::throughput() const
+{
+    return elapsedMs > 0 ? completed * 1000.0 / elapsedMs : 0;
+}
+
+// ---------------- run ----------------
+
+LoadFixture prepareLoad(RMSFacade &facade, const LoadOptions &options)
+{
+    if (options.trains <= 0 || options.seatsPerTrain <= 0 || options.passengers <= 0)
+        throw std::invalid_argument("Load needs trains , seats and passengers");
+    LoadFixture fixture;
+    for (int i = 0; i < options.trains; i++)
+        fixture.trainIds.push_back(facade.addTrain("Load " + std::to_string(i + 1), options.seatsPerTrain).getTrainId());
+    for (int i = 0; i < options.passengers; i++)
+        fixture.passengerNames.push_back(facade.addPassenger("Rider " + std::to_string(i + 1)).getName());
+    return fixture;
+}
+
+namespace
+{
+    // what one client thread measured
+    struct ClientResult
+    {
+        LatencyHistogram latency[LOAD_OP_COUNT];
+        LoadOpReport counts[LOAD_OP_COUNT];
+    };
+
+    class Client
+    {
+    private:
+        RMSFacade &facade;
+        const LoadFixture &fixture;
+        const ZipfDistribution &popularity;
+        std::discrete_distribution<int> pickOp;
+        std::mt19937_64 rng;
+        std::vector<int> ownTickets; // booked by this client , candidates for cancel
+
+        int pickTrain() { return fixture.trainIds[popularity(rng) - 1]; }
+
+        // runs one call , false when the facade threw
+        bool call(LoadOp op, bool &waitlisted)
+        {
+            try
+            {
+                switch (op)
+                {
+                case LoadOp::Book:
+                {
+                    const std::string &name = fixture.passengerNames[rng() % fixture.passengerNames.size()];
+                    auto ticket = facade.bookTicket(pickTrain(), name);
+                    if (ticket.has_value())
+                        ownTickets.push_back(ticket->getId());
+                    else
+                        waitlisted = true;
+                    break;
+                }
+                case LoadOp::Cancel:
+                {
+                    size_t pick = rng() % ownTickets.size();
+                    int ticketId = ownTickets[pick];
+                    ownTickets[pick] = ownTickets.back();
+                    ownTickets.pop_back();
+                    facade.cancelTicket(ticketId);
+                    break;
+                }
+                case LoadOp::Lookup:
+                    facade.getTrain(pickTrain());
+                    break;
+                case LoadOp::List:
+                    facade.listTrains();
+                    break;
+                }
+                return true;
+            }
+            catch (const std::exception &)
+            {
+                return false;
+            }
+        }
+
+    public:
+        Client(RMSFacade &facade, const LoadFixture &fixture, const ZipfDistribution &popularity, const LoadMix &mix, unsigned seed)
+            : facade(facade), fixture(fixture), popularity(popularity),
+              pickOp({(double)mix.book, (double)mix.cancel, (double)mix.lookup, (double)mix.list}), rng(seed) {}
+
+        void run(const std::atomic<bool> &go, std::chrono::steady_clock::time_point &measureFrom,
+                 std::chrono::steady_clock::time_point &stopAt, ClientResult &result)
+        {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            while (true)
+            {
+                auto start = std::chrono::steady_clock::now();
+                if (start >= stopAt)
+                    return;
+                LoadOp op = (LoadOp)pickOp(rng);
+                if (op == LoadOp::Cancel && ownTickets.empty())
+                    op = LoadOp::Book; // nothing of ours to cancel yet
+                bool waitlisted = false;
+                bool ok = call(op, waitlisted);
+                auto end = std::chrono::steady_clock::now();
+                if (start < measureFrom)
+                    continue; // warmup
+                int i = (int)op;
+                result.latency[i].record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                result.counts[i].completed++;
+                result.counts[i].failed += ok ? 0 : 1;
+                result.counts[i].waitlisted += waitlisted ? 1 : 0;
+            }
+        }
+    };
+}
+
+LoadReport runClosedLoop(RMSFacade &facade, const LoadFixture &fixture, const LoadOptions &options)
+{
+    const LoadMix &mix = options.mix;
+    if (options.threads <= 0 || options.durationMs <= 0 || options.warmupMs < 0)
+        throw std::invalid_argument("Load needs threads and a duration");
+    if (mix.book < 0 || mix.cancel < 0 || mix.lookup < 0 || mix.list < 0 || mix.book + mix.cancel + mix.lookup + mix.list == 0)
+        throw std::invalid_argument("Operation mix needs a positive weight");
+    if (fixture.trainIds.empty() || fixture.passengerNames.empty())
+        throw std::invalid_argument("Load fixture is empty");
+
+    ZipfDistribution popularity((int)fixture.trainIds.size(), options.zipfSkew);
+    std::vector<Client> clients;
+    for (int t = 0; t < options.threads; t++)
+        clients.emplace_back(facade, fixture, popularity, mix, options.seed + (unsigned)t);
+    std::vector<ClientResult> results(options.threads);
+
+    std::atomic<bool> go{false};
+    std::chrono::steady_clock::time_point measureFrom, stopAt;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++)
+        threads.emplace_back([&, t] { clients[t].run(go, measureFrom, stopAt, results[t]); });
+
+    // every client starts together , the clock starts with them
+    measureFrom = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.warmupMs);
+    stopAt = measureFrom + std::chrono::milliseconds(options.durationMs);
+    go.store(true, std::memory_order_release);
+    for (auto &thread : threads)
+        thread.join();
+    auto finished = std::chrono::steady_clock::now();
+
+    LoadReport report;
+    // the last calls may end after stopAt , count the time they really took
+    report.elapsedMs = std::chrono::duration<double, std::milli>(std::max(finished, stopAt) - measureFrom).count();
+    for (int i = 0; i < LOAD_OP_COUNT; i++)
+    {
+        LatencyHistogram merged;
+        LoadOpReport &op = report.ops[i];
+        for (const auto &result : results)
+        {
+            merged.merge(result.latency[i]);
+            op.completed += result.counts[i].completed;
+            op.failed += result.counts[i].failed;
+            op.waitlisted += result.counts[i].waitlisted;
+        }
+        op.p50Us = merged.percentile(0.50) / 1000.0;
+        op.p99Us = merged.percentile(0.99) / 1000.0;
+        op.p999Us = merged.percentile(0.999) / 1000.0;
+        op.maxUs = merged.max() / 1000.0;
+        report.completed += op.completed;
+    }
+    return report;
+}
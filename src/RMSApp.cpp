@@ -3,15 +3,111 @@
 //
 
 #include "RMSApp.h"
+#include <cstdlib>
+#include <iostream>
 
 RMSApp::RMSApp() {
     startupManager = std::make_unique<StartupManager>();
+    // RMS_SHARED_MEMORY=/name : every rms_app started with the same name books one inventory
+    if (const char *shared = std::getenv("RMS_SHARED_MEMORY"))
+        startupManager->useSharedMemory(shared);
+    // RMS_WAL=path : bookings survive a restart , the log at path is replayed on start
+    else if (const char *wal = std::getenv("RMS_WAL"))
+        startupManager->useWriteAheadLog(wal);
+    // RMS_REPLICA_OF=path : a read-only replica of the primary shipping its log to the socket
+    // (or file:path) , for reports that should not compete with bookings
+    else if (const char *primary = std::getenv("RMS_REPLICA_OF")) {
+        std::string path = primary;
+        ReplicaOptions options;
+        options.fromFile = path.rfind("file:", 0) == 0;
+        startupManager->useReplicaOf(options.fromFile ? path.substr(5) : path, options);
+    }
+    // RMS_SQLITE=path : the repositories live in the SQLite database at path
+    else if (const char *sqlite = std::getenv("RMS_SQLITE"))
+        startupManager->useSqlite(sqlite);
+    // RMS_SNAPSHOT=path : start from the snapshot file at path when there is one , save it on exit
+    else if (const char *snapshot = std::getenv("RMS_SNAPSHOT")) {
+        snapshotPath = snapshot;
+        startupManager->useSnapshot(snapshotPath);
+    }
+
+    // RMS_SHARDS=count : in memory (or with RMS_SNAPSHOT) , trains and tickets split over count
+    // shards so bookings of different trains do not share a lock
+    if (const char *shards = std::getenv("RMS_SHARDS"))
+        startupManager->useShardedRepositories(std::atoi(shards));
+
+    // RMS_CHECKPOINT_MS=interval : with RMS_WAL , checkpoint every interval ms and keep the log short
+    if (const char *checkpoints = std::getenv("RMS_CHECKPOINT_MS")) {
+        CheckpointOptions options;
+        options.intervalMs = std::atoi(checkpoints);
+        startupManager->useCheckpoints(options);
+    }
+
+    // RMS_SHIP=path : with RMS_WAL , ship the log to replicas connecting to the socket at path
+    // (or appending to file:path)
+    if (const char *ship = std::getenv("RMS_SHIP")) {
+        std::string path = ship;
+        ShippingOptions options;
+        options.toFile = path.rfind("file:", 0) == 0;
+        startupManager->useLogShipping(options.toFile ? path.substr(5) : path, options);
+    }
+
+    // RMS_CACHE=records : keep that many records per repository in memory , saves written behind
+    if (const char *cache = std::getenv("RMS_CACHE")) {
+        CacheOptions options;
+        options.capacity = std::strtoul(cache, nullptr, 10);
+        startupManager->useCache(options);
+    }
+
+    // RMS_ARCHIVE=path : cancelled and departed tickets move to the archive file at path on start ,
+    // and every RMS_ARCHIVE_MS milliseconds when that is set
+    if (const char *archive = std::getenv("RMS_ARCHIVE")) {
+        const char *every = std::getenv("RMS_ARCHIVE_MS");
+        startupManager->useTicketArchive(archive, every != nullptr ? std::atoi(every) : 0);
+    }
+
+    // RMS_CONCURRENCY=locking|optimistic|claims : how bookings of one train are kept apart ,
+    // claims books "any seat" lock-free for hot trains
+    if (const char *concurrency = std::getenv("RMS_CONCURRENCY"))
+        startupManager->setConcurrencyMode(parseConcurrencyMode(concurrency));
+
+    // RMS_EVENTS=path : every change is appended to path as a JSON line (a named pipe works too)
+    if (const char *events = std::getenv("RMS_EVENTS"))
+        startupManager->useEventLog(events);
+
+    // RMS_DEFRAG_MS=interval : compact the seats of flexible bookings every interval ms , a bounded
+    // slice per train and departure
+    if (const char *defrag = std::getenv("RMS_DEFRAG_MS"))
+        startupManager->useDefragmentation(std::atoi(defrag));
+
+    // seat holds lapse on their own , nobody has to call expireHolds
+    startupManager->useHoldExpiry();
 
     auto facade = startupManager->buildFacade(); // build the app with startup manager
+    if (startupManager->getTicketArchive() != nullptr)
+        startupManager->archiveTickets();
+    if (LogReplica *replica = startupManager->getLogReplica()) {
+        if (!replica->waitUntilReady(5000))
+            std::cout << "Primary not reachable yet , the replica fills in once it is\n";
+        ReplicaStats stats = replica->getStats();
+        std::cout << "Read-only replica : " << stats.records << " records applied , "
+                  << stats.behindBytes() << " bytes behind , lag " << stats.lagMs << " ms\n";
+    }
+
+    // the seat allocator used to print this itself , now the CLI listens for it
+    startupManager->getEventBus()->subscribe([](const Event *events, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            if (events[i].type == EventType::WaitlistPromoted)
+                std::cout << "\nSeat " << events[i].seat << " freed and assigned to waiting passenger "
+                          << events[i].passengerId << "\n";
+        std::cout.flush();
+    });
 
     cli = std::make_unique<CLIController>(facade);// pass facade to startup manager
 }
 
 void RMSApp::run() {
     cli->run();
+    if (!snapshotPath.empty())
+        startupManager->saveSnapshot(snapshotPath).get();
 }
@@ -9,6 +9,8 @@ RMSCommand::MainCmd RMSCommand::getMainCmd(const string &cmd)
         {"train", MainCmd::TRAIN},
         {"passenger", MainCmd::PASSENGER},
         {"ticket", MainCmd::TICKET},
+        {"import", MainCmd::IMPORT},
+        {"export", MainCmd::EXPORT},
         {"help", MainCmd::SYSTEM},
         {"h", MainCmd::SYSTEM},
         {"?", MainCmd::SYSTEM},
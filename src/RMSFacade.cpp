@@ -3,7 +3,7 @@
 //
 #include "RMSFacade.h"
 #include <stdexcept> //for run time exception
-#include <iostream>
+#include <vector>
 #include "utils/helpers.h"
 
 RMSFacade::RMSFacade(TrainService *ts, TicketService *tks, PassengerService *ps)
@@ -13,18 +13,29 @@ RMSFacade::RMSFacade(TrainService *ts, TicketService *tks, PassengerService *ps)
     this->passengerService = ps;
 }
 
+RMSFacade::~RMSFacade()
+{
+    if (bookingPipeline)
+        bookingPipeline->shutdown();
+}
+
 // ============ Trains =============
 vector<Train> RMSFacade::listTrains()
 {
     return trainService->getAllTrains();
 }
 
+std::vector<TrainOccupancy> RMSFacade::occupancyReport()
+{
+    return trainService->getOccupancyReport();
+}
+
 Train RMSFacade::addTrain(std::string name, int totalSeats)
 {
     name = trim(name);
-    if (name.empty())
+    if (!isValidName(name)) // the rule BulkImporter applies to train rows too
     {
-        throw std::invalid_argument("Train name cannot be empty");
+        throw std::invalid_argument("Train name is not valid");
     }
 
     if (totalSeats <= 0)
@@ -60,6 +71,11 @@ vector<Ticket> RMSFacade::listTickets()
     return ticketService->getAllTickets();
 }
 
+TicketReport RMSFacade::ticketReport()
+{
+    return ticketService->getTicketReport();
+}
+
 Ticket RMSFacade::getTicket(int ticketId)
 {
     return ticketService->getTicket(ticketId);
@@ -71,9 +87,21 @@ vector<Passenger> RMSFacade::listPassengers()
 }
 
 // ============ Tickets =============
-std::optional<Ticket> RMSFacade::bookTicket(int trainId, const std::string &passengerName)
+// "" -> 0 (undated) , otherwise YYYY-MM-DD
+static int parseTravelDate(const std::string &travelDate)
+{
+    return trim(travelDate).empty() ? 0 : parseDate(travelDate);
+}
+
+std::optional<Ticket> RMSFacade::bookTicket(int trainId, const std::string &passengerName, const SeatRequest &request, const std::string &travelDate)
+{
+    BookingRequest booking = makeBookingRequest(trainId, passengerName, request, travelDate);
+    return ticketService->bookTicket(booking.trainId, booking.passengerId, booking.request, booking.travelDate);
+}
+
+// input validation shared by the synchronous and asynchronous booking
+BookingRequest RMSFacade::makeBookingRequest(int trainId, const std::string &passengerName, const SeatRequest &request, const std::string &travelDate)
 {
-    // input validation
     if (trainId <= 0)
         throw std::invalid_argument("Train ID must be greater than 0");
     std::string trimmedName = trim(passengerName);
@@ -81,8 +109,43 @@ std::optional<Ticket> RMSFacade::bookTicket(int trainId, const std::string &pass
     if (!isValidName(trimmedName))
         throw std::invalid_argument("Passenger name cannot be empty");
 
-    Passenger ps = passengerService->find_or_create_passenger(trimmedName);
-    return ticketService->bookTicket(trainId, ps.getId());
+    BookingRequest booking;
+    booking.trainId = trainId;
+    booking.travelDate = parseTravelDate(travelDate);
+    booking.request = request;
+    booking.passengerId = passengerService->find_or_create_passenger(trimmedName).getId();
+    return booking;
+}
+
+void RMSFacade::enableAsyncBooking(const BookingPipelineOptions &options)
+{
+    if (bookingPipeline)
+        bookingPipeline->shutdown(); // finish what the old pool already accepted
+    bookingPipeline = std::make_unique<BookingPipeline>(ticketService, options);
+}
+
+std::future<std::optional<Ticket>> RMSFacade::bookTicketAsync(int trainId, const std::string &passengerName, const SeatRequest &request, const std::string &travelDate)
+{
+    if (!bookingPipeline)
+        throw std::runtime_error("asynchronous booking is not enabled");
+    return bookingPipeline->submit(makeBookingRequest(trainId, passengerName, request, travelDate));
+}
+
+void RMSFacade::bookTicketAsync(int trainId, const std::string &passengerName, BookingPipeline::Callback onDone, const SeatRequest &request, const std::string &travelDate)
+{
+    if (!bookingPipeline)
+        throw std::runtime_error("asynchronous booking is not enabled");
+    bookingPipeline->submit(makeBookingRequest(trainId, passengerName, request, travelDate), std::move(onDone));
+}
+
+bool RMSFacade::isAsyncBookingEnabled() const
+{
+    return bookingPipeline != nullptr;
+}
+
+BookingPipelineStats RMSFacade::getBookingPipelineStats() const
+{
+    return bookingPipeline ? bookingPipeline->getStats() : BookingPipelineStats{};
 }
 
 void RMSFacade::cancelTicket(int ticketId)
@@ -95,12 +158,82 @@ void RMSFacade::cancelTicket(int ticketId)
     ticketService->cancelTicket(ticketId);
 }
 
+SeatHold RMSFacade::holdSeat(int trainId, const std::string &passengerName, int ttlSeconds, const SeatRequest &request, const std::string &travelDate)
+{
+    // input validation
+    if (trainId <= 0)
+        throw std::invalid_argument("Train ID must be greater than 0");
+    if (ttlSeconds <= 0)
+        throw std::invalid_argument("Hold time must be greater than 0");
+    std::string trimmedName = trim(passengerName);
+
+    if (!isValidName(trimmedName))
+        throw std::invalid_argument("Passenger name cannot be empty");
+
+    int date = parseTravelDate(travelDate);
+
+    Passenger ps = passengerService->find_or_create_passenger(trimmedName);
+    return ticketService->holdSeat(trainId, ps.getId(), ttlSeconds, request, date);
+}
+
+Ticket RMSFacade::confirmHold(int holdId)
+{
+    if (holdId <= 0)
+        throw std::invalid_argument("Hold ID must be greater than 0");
+    return ticketService->confirmHold(holdId);
+}
+
+void RMSFacade::releaseHold(int holdId)
+{
+    if (holdId <= 0)
+        throw std::invalid_argument("Hold ID must be greater than 0");
+    ticketService->releaseHold(holdId);
+}
+
+int RMSFacade::expireHolds()
+{
+    return ticketService->expireHolds();
+}
+
+DefragReport RMSFacade::defragmentSeats(int trainId, const std::string &travelDate, bool apply, int maxSteps)
+{
+    if (trainId <= 0)
+        throw std::invalid_argument("Train ID must be greater than 0");
+    if (maxSteps <= 0)
+        throw std::invalid_argument("Steps must be greater than 0");
+    return ticketService->defragmentSeats(trainId, parseTravelDate(travelDate), maxSteps, apply);
+}
+
+ImportReport RMSFacade::importFile(ImportKind kind, const std::string &path, const ImportOptions &options)
+{
+    BulkImporter importer(trainService, passengerService, ticketService, ticketService->getThreadPool());
+    return importer.importFile(kind, path, options);
+}
+
+ExportReport RMSFacade::exportTickets(const std::string &path, const ExportOptions &options)
+{
+    BulkExporter exporter(trainService, ticketService);
+    return exporter.exportFile(BulkExporter::formatFor(path), path, options);
+}
+
 bool RMSFacade::getTrainAvailability(int trainId)
 {
     return trainService->isAvailbleSeat(trainId);
 }
 
 Train RMSFacade::updateTrain(int trainId, const std::string &name, int seats)
+{
+    // the waiting list below is processed on the updated copy , keep the train to ourselves
+    auto guard = trainService->lockTrain(trainId);
+
+    // every booking reads the train saved just before it so none overwrites another
+    for (const auto &waiting : resizeTrain(trainId, name, seats))
+        ticketService->promoteWaitingPassenger(trainId, waiting.second, waiting.first); // publishes the outcome
+
+    return trainService->getTrain(trainId);
+}
+
+std::vector<std::pair<int, int>> RMSFacade::resizeTrain(int trainId, const std::string &name, int seats)
 {
     // validation
     if (trainId <= 0)
@@ -111,29 +244,19 @@ Train RMSFacade::updateTrain(int trainId, const std::string &name, int seats)
     if (seats < 0)
         throw std::invalid_argument("Seats cannot be negative");
 
-    // current Train
-    auto currentTrain = trainService->getTrain(trainId);
+    auto guard = trainService->lockTrain(trainId);
 
-    int currentSeats = currentTrain.getTotalSeats();
+    // current Train
+    int currentSeats = trainService->getTrain(trainId).getTotalSeats();
 
     // update train
-    Train updatedTrain = trainService->updateTrain(trainId, trimmedName, seats);
+    trainService->updateTrain(trainId, trimmedName, seats);
 
-    // process waiting
+    // take the first passengers off the waiting list and save that , the caller books them
     int seatsAdded = seats - currentSeats;
     if (seatsAdded > 0)
-    {
-        auto cb = [this, &updatedTrain, trainId](int passengerId) { // access to this object& trainId + passengerId as argument
-            trainService->save(updatedTrain);
-            ticketService->bookTicket(trainId, passengerId);
-        };
-        updatedTrain.getSeatAllocator()->processWaitingList(seatsAdded, cb);
-
-        // Save updated train after processing waiting list
-        trainService->save(updatedTrain);
-    }
-
-    return updatedTrain;
+        return trainService->takeWaitingPassengers(trainId, seatsAdded);
+    return {};
 }
 
 Train RMSFacade::addSeats(int trainId, int seats)
@@ -149,18 +272,15 @@ Train RMSFacade::addSeats(const std::string &name, int seats)
 Passenger RMSFacade::updatePassenger(int passengerId, const std::string &name)
 {
 
-    auto passenger = passengerService->getPassenger(passengerId);
+    passengerService->getPassenger(passengerId); // throws when unknown
     // update passenger
     auto newPassenger = passengerService->updatePassenger(passengerId, name);
     // update tickets with this id
-    auto tickets = ticketService->getAllTickets();
+    auto tickets = ticketService->getTicketsByPassenger(passengerId);
     for (auto &t : tickets)
     {
-        if (compareString(t.getPassenger().getName(), passenger.getName()))
-        {
-            t.setPassenger(newPassenger);
-            ticketService->updateTicket(t);
-        }
+        t.setPassenger(newPassenger);
+        ticketService->updateTicket(t);
     }
 
     return newPassenger;
@@ -180,7 +300,37 @@ void RMSFacade::deletePassenger(int passengerId)
     passengerService->deletePassenger(passengerId);
 }
 
-void RMSFacade::trainStatus(int trainId)
+void RMSFacade::trainStatus(int trainId, const std::string &travelDate)
+{
+    trainService->printStatus(trainId, parseTravelDate(travelDate));
+}
+
+int RMSFacade::evictPastDepartures()
+{
+    return trainService->evictDatesBefore(todayDate());
+}
+
+Train RMSFacade::setCoachLayout(int trainId, const vector<CoachSpec> &coaches)
 {
-    trainService->printStatus(trainId);
+    if (trainId <= 0)
+        throw std::invalid_argument("Train ID must be > 0");
+    if (coaches.empty())
+        throw std::invalid_argument("Coach layout cannot be empty");
+    return trainService->setCoachLayout(trainId, coaches);
+}
+
+int RMSFacade::getClassAvailability(int trainId, const std::string &seatClass, const std::string &travelDate)
+{
+    if (trainId <= 0)
+        throw std::invalid_argument("Train ID must be > 0");
+    return trainService->getClassAvailability(trainId, seatClass, parseTravelDate(travelDate));
+}
+
+Train RMSFacade::tagSeats(int trainId, int fromSeat, int toSeat, unsigned attributes)
+{
+    if (trainId <= 0)
+        throw std::invalid_argument("Train ID must be > 0");
+    if (attributes == 0 || (attributes & ~SEAT_ATTRIBUTE_ALL))
+        throw std::invalid_argument("Invalid seat attributes");
+    return trainService->tagSeats(trainId, fromSeat, toSeat, attributes);
 }
@@ -0,0 +1,141 @@
+#include "Repo/CachedPassengerRepository.h"
+#include <stdexcept>
+
+static int passengerIdOf(const Passenger &passenger)
+{
+    return passenger.getId();
+}
+
+static bool renames(const Passenger &cached, const Passenger &next)
+{
+    return cached.getName() != next.getName();
+}
+
+static IPassengerRepository *checked(IPassengerRepository *inner)
+{
+    if (inner == nullptr)
+        throw std::invalid_argument("Cached repository needs a repository");
+    return inner;
+}
+
+CachedPassengerRepository::CachedPassengerRepository(std::unique_ptr<IPassengerRepository> inner, const CacheOptions &options)
+    : inner(std::move(inner)),
+      cache(options, [repository = checked(this->inner.get())](vector<Passenger> &passengers) {
+          repository->saveAll(passengers); // one write for the whole flush
+      })
+{
+}
+
+bool CachedPassengerRepository::load(int passengerId)
+{
+    unsigned long long token;
+    if (cache.find(passengerId, token) != nullptr)
+        return true;
+    auto stored = inner->getPassenger(passengerId);
+    if (!stored)
+        return false;
+    cache.fill(passengerId, std::move(*stored), token);
+    return true;
+}
+
+std::optional<Passenger> CachedPassengerRepository::getPassenger(const int &passengerId)
+{
+    unsigned long long token;
+    if (auto cached = cache.find(passengerId, token))
+        return *cached;
+    auto stored = inner->getPassenger(passengerId);
+    if (!stored)
+        return std::nullopt; // not found
+    return *cache.fill(passengerId, std::move(*stored), token);
+}
+
+std::optional<Passenger> CachedPassengerRepository::findPassengerByName(const std::string &name)
+{
+    auto stored = inner->findPassengerByName(name);
+    if (!stored)
+        return std::nullopt;
+    vector<Passenger> one;
+    one.push_back(std::move(*stored));
+    cache.translate(one, passengerIdOf);
+    return one[0];
+}
+
+// stores into the cached record , false when there is none under the id or its version moved on
+bool CachedPassengerRepository::put(Passenger &passenger, bool checkVersion)
+{
+    while (true)
+    {
+        auto result = cache.put(passenger.getId(), passenger, checkVersion, renames);
+        if (result != RecordCache<Passenger>::PutResult::NotCached)
+            return result == RecordCache<Passenger>::PutResult::Stored;
+        if (!load(passenger.getId()))
+            return false;
+    }
+}
+
+void CachedPassengerRepository::save(Passenger &passenger)
+{
+    if (passenger.getId() != 0 && put(passenger, false))
+        return;
+    cache.create(passenger, passengerIdOf, [&](Passenger &copy) {
+        inner->save(copy);
+        return true;
+    });
+}
+
+bool CachedPassengerRepository::compareAndSave(Passenger &passenger)
+{
+    if (passenger.getVersion() == 0)
+        return cache.create(passenger, passengerIdOf, [&](Passenger &copy) { return inner->compareAndSave(copy); });
+    return put(passenger, true);
+}
+
+// records already stored are updated in the cache , the new ones reach inner in one saveAll
+void CachedPassengerRepository::saveAll(vector<Passenger> &passengers)
+{
+    vector<Passenger> fresh;
+    vector<size_t> freshAt;
+    for (size_t i = 0; i < passengers.size(); i++)
+    {
+        if (passengers[i].getId() != 0 && put(passengers[i], false))
+            continue;
+        fresh.push_back(passengers[i]);
+        freshAt.push_back(i);
+    }
+    if (fresh.size() == 0)
+        return;
+    cache.create(fresh, passengerIdOf, [&](vector<Passenger> &copies) {
+        inner->saveAll(copies);
+        return true;
+    });
+    for (size_t i = 0; i < fresh.size(); i++)
+        passengers[freshAt[i]] = fresh[i];
+}
+
+bool CachedPassengerRepository::deletePassenger(const int &passengerId)
+{
+    return cache.remove(passengerId, [&] { return inner->deletePassenger(passengerId); });
+}
+
+vector<Passenger> CachedPassengerRepository::getAllPassengers()
+{
+    cache.flush();
+    vector<Passenger> passengers = inner->getAllPassengers();
+    cache.translate(passengers, passengerIdOf);
+    return passengers;
+}
+
+void CachedPassengerRepository::clear()
+{
+    cache.clear([&] { inner->clear(); });
+}
+
+void CachedPassengerRepository::flush()
+{
+    cache.flush();
+}
+
+CacheStats CachedPassengerRepository::getCacheStats() const
+{
+    return cache.getStats();
+}
@@ -0,0 +1,172 @@
+#include "Repo/CachedTicketRepository.h"
+#include <stdexcept>
+
+static int ticketIdOf(const Ticket &ticket)
+{
+    return ticket.getId();
+}
+
+// the wrapped repository finds tickets by these , a change of them can not wait for a flush
+static bool movesTicket(const Ticket &cached, const Ticket &next)
+{
+    return cached.getTrainId() != next.getTrainId() || cached.getTravelDate() != next.getTravelDate() ||
+           cached.getPassenger().getId() != next.getPassenger().getId();
+}
+
+static ITicketRepository *checked(ITicketRepository *inner)
+{
+    if (inner == nullptr)
+        throw std::invalid_argument("Cached repository needs a repository");
+    return inner;
+}
+
+CachedTicketRepository::CachedTicketRepository(std::unique_ptr<ITicketRepository> inner, const CacheOptions &options)
+    : inner(std::move(inner)),
+      cache(options, [repository = checked(this->inner.get())](vector<Ticket> &tickets) {
+          repository->saveAll(tickets); // one write for the whole flush
+      })
+{
+}
+
+bool CachedTicketRepository::load(int ticketId)
+{
+    unsigned long long token;
+    if (cache.find(ticketId, token) != nullptr)
+        return true;
+    auto stored = inner->getTicketById(ticketId);
+    if (!stored)
+        return false;
+    cache.fill(ticketId, std::move(*stored), token);
+    return true;
+}
+
+std::optional<Ticket> CachedTicketRepository::current(std::optional<Ticket> stored)
+{
+    if (!stored)
+        return std::nullopt;
+    vector<Ticket> one;
+    one.push_back(std::move(*stored));
+    cache.translate(one, ticketIdOf);
+    return one[0];
+}
+
+// false when the ticket is not stored under its id
+bool CachedTicketRepository::put(Ticket &ticket, bool checkVersion)
+{
+    while (true)
+    {
+        auto result = cache.put(ticket.getId(), ticket, checkVersion, movesTicket);
+        if (result != RecordCache<Ticket>::PutResult::NotCached)
+            return result == RecordCache<Ticket>::PutResult::Stored;
+        if (!load(ticket.getId()))
+            return false;
+    }
+}
+
+std::optional<Ticket> CachedTicketRepository::getTicketById(int ticketId)
+{
+    unsigned long long token;
+    if (auto cached = cache.find(ticketId, token))
+        return *cached;
+    auto stored = inner->getTicketById(ticketId);
+    if (!stored)
+        return std::nullopt; // not found
+    return *cache.fill(ticketId, std::move(*stored), token);
+}
+
+std::optional<Ticket> CachedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    return current(inner->getTicketByTrainAndPassenger(trainId, passengerId));
+}
+
+std::optional<Ticket> CachedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    return current(inner->getTicketByTrainAndPassenger(trainId, passengerId, travelDate));
+}
+
+vector<Ticket> CachedTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    vector<Ticket> tickets = inner->getTicketsByPassenger(passengerId);
+    cache.translate(tickets, ticketIdOf);
+    return tickets;
+}
+
+void CachedTicketRepository::save(Ticket &ticket)
+{
+    if (ticket.getId() != 0 && put(ticket, false))
+        return;
+    cache.create(ticket, ticketIdOf, [&](Ticket &copy) {
+        inner->save(copy);
+        return true;
+    });
+}
+
+bool CachedTicketRepository::compareAndSave(Ticket &ticket)
+{
+    if (ticket.getVersion() == 0)
+        return cache.create(ticket, ticketIdOf, [&](Ticket &copy) { return inner->compareAndSave(copy); });
+    return put(ticket, true);
+}
+
+void CachedTicketRepository::saveAll(vector<Ticket> &tickets)
+{
+    vector<Ticket> fresh;
+    vector<size_t> freshAt;
+    for (size_t i = 0; i < tickets.size(); i++)
+    {
+        if (tickets[i].getId() != 0 && put(tickets[i], false))
+            continue;
+        fresh.push_back(tickets[i]);
+        freshAt.push_back(i);
+    }
+    if (fresh.size() == 0)
+        return;
+    cache.create(fresh, ticketIdOf, [&](vector<Ticket> &copies) {
+        inner->saveAll(copies);
+        return true;
+    });
+    for (size_t i = 0; i < fresh.size(); i++)
+        tickets[freshAt[i]] = fresh[i];
+}
+
+bool CachedTicketRepository::deleteTicket(int ticketId)
+{
+    return cache.remove(ticketId, [&] { return inner->deleteTicket(ticketId); });
+}
+
+vector<Ticket> CachedTicketRepository::getAllTickets()
+{
+    cache.flush();
+    vector<Ticket> tickets = inner->getAllTickets();
+    cache.translate(tickets, ticketIdOf);
+    return tickets;
+}
+
+vector<Ticket> CachedTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    cache.flush();
+    vector<Ticket> tickets = inner->getTicketsPage(afterId, limit);
+    cache.translate(tickets, ticketIdOf);
+    return tickets;
+}
+
+Snapshot<Ticket> CachedTicketRepository::snapshot()
+{
+    cache.flush();
+    return inner->snapshot();
+}
+
+void CachedTicketRepository::clear()
+{
+    cache.clear([&] { inner->clear(); });
+}
+
+void CachedTicketRepository::flush()
+{
+    cache.flush();
+}
+
+CacheStats CachedTicketRepository::getCacheStats() const
+{
+    return cache.getStats();
+}
@@ -0,0 +1,140 @@
+#include "Repo/CachedTrainRepository.h"
+#include <stdexcept>
+
+static int trainIdOf(const Train &train)
+{
+    return train.getTrainId();
+}
+
+static ITrainRepository *checked(ITrainRepository *inner)
+{
+    if (inner == nullptr)
+        throw std::invalid_argument("Cached repository needs a repository");
+    return inner;
+}
+
+CachedTrainRepository::CachedTrainRepository(std::unique_ptr<ITrainRepository> inner, const CacheOptions &options)
+    : inner(std::move(inner)),
+      cache(options, [repository = checked(this->inner.get())](vector<Train> &trains) {
+          repository->saveAll(trains); // one write for the whole flush
+      })
+{
+}
+
+bool CachedTrainRepository::load(int trainId) const
+{
+    unsigned long long token;
+    if (cache.find(trainId, token) != nullptr)
+        return true;
+    auto stored = inner->getTrainById(trainId);
+    if (!stored)
+        return false;
+    cache.fill(trainId, std::move(*stored), token);
+    return true;
+}
+
+std::optional<Train> CachedTrainRepository::getTrainById(const int &trainId) const
+{
+    unsigned long long token;
+    if (auto cached = cache.find(trainId, token))
+        return *cached;
+    auto stored = inner->getTrainById(trainId);
+    if (!stored)
+        return std::nullopt; // not found
+    return *cache.fill(trainId, std::move(*stored), token);
+}
+
+// stores into the cached record , false when there is none under the id or its version moved on
+bool CachedTrainRepository::put(Train &train, bool checkVersion)
+{
+    auto never = [](const Train &, const Train &) { return false; };
+    while (true)
+    {
+        auto result = cache.put(train.getTrainId(), train, checkVersion, never);
+        if (result != RecordCache<Train>::PutResult::NotCached)
+            return result == RecordCache<Train>::PutResult::Stored;
+        if (!load(train.getTrainId()))
+            return false;
+    }
+}
+
+void CachedTrainRepository::save(Train &train)
+{
+    if (train.getTrainId() != 0 && put(train, false))
+        return;
+    cache.create(train, trainIdOf, [&](Train &copy) {
+        inner->save(copy);
+        return true;
+    });
+}
+
+bool CachedTrainRepository::compareAndSave(Train &train)
+{
+    if (train.getVersion() == 0)
+        return cache.create(train, trainIdOf, [&](Train &copy) { return inner->compareAndSave(copy); });
+    return put(train, true);
+}
+
+// records already stored are updated in the cache , the new ones reach inner in one saveAll
+void CachedTrainRepository::saveAll(vector<Train> &trains)
+{
+    vector<Train> fresh;
+    vector<size_t> freshAt;
+    for (size_t i = 0; i < trains.size(); i++)
+    {
+        if (trains[i].getTrainId() != 0 && put(trains[i], false))
+            continue;
+        fresh.push_back(trains[i]);
+        freshAt.push_back(i);
+    }
+    if (fresh.size() == 0)
+        return;
+    cache.create(fresh, trainIdOf, [&](vector<Train> &copies) {
+        inner->saveAll(copies);
+        return true;
+    });
+    for (size_t i = 0; i < fresh.size(); i++)
+        trains[freshAt[i]] = fresh[i];
+}
+
+bool CachedTrainRepository::deleteTrain(int trainId)
+{
+    return cache.remove(trainId, [&] { return inner->deleteTrain(trainId); });
+}
+
+vector<Train> CachedTrainRepository::getAllTrains() const
+{
+    cache.flush();
+    vector<Train> trains = inner->getAllTrains();
+    cache.translate(trains, trainIdOf);
+    return trains;
+}
+
+vector<Train> CachedTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    cache.flush();
+    vector<Train> trains = inner->getTrainsPage(afterId, limit);
+    cache.translate(trains, trainIdOf);
+    return trains;
+}
+
+Snapshot<Train> CachedTrainRepository::snapshot() const
+{
+    cache.flush();
+    return inner->snapshot();
+}
+
+void CachedTrainRepository::clear()
+{
+    cache.clear([&] { inner->clear(); });
+}
+
+void CachedTrainRepository::flush()
+{
+    cache.flush();
+}
+
+CacheStats CachedTrainRepository::getCacheStats() const
+{
+    return cache.getStats();
+}
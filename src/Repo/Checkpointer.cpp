@@ -0,0 +1,110 @@
+#include "Repo/Checkpointer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+Checkpointer::Checkpointer(DurableTrainRepository *trains, DurableTicketRepository *tickets,
+                           DurablePassengerRepository *passengers, WriteAheadLog *wal, WriteAheadLog *checkpointLog,
+                           const CheckpointOptions &options)
+    : trains(trains), tickets(tickets), passengers(passengers), wal(wal), checkpointLog(checkpointLog), options(options)
+{
+    if (trains == nullptr || tickets == nullptr || passengers == nullptr || wal == nullptr || checkpointLog == nullptr)
+        throw std::invalid_argument("Checkpointer needs the three durable repositories and both logs");
+    if (options.intervalMs <= 0 || options.rewriteRatio <= 1)
+        throw std::invalid_argument("Checkpoint interval must be greater than zero and the rewrite ratio greater than one");
+    fullBytes = checkpointLog->getStats().size;
+    timer = std::thread([this] { run(); });
+}
+
+Checkpointer::~Checkpointer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    timer.join();
+}
+
+void Checkpointer::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        if (wake.wait_for(lock, std::chrono::milliseconds(options.intervalMs), [&] { return stopping; }))
+            return;
+        lock.unlock();
+        try
+        {
+            checkpoint();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> count(mutex);
+            stats.failures++;
+        }
+        lock.lock();
+    }
+}
+
+CheckpointStats Checkpointer::checkpoint()
+{
+    std::lock_guard<std::mutex> one(running);
+    auto start = std::chrono::steady_clock::now();
+
+    // the ids changed up to walEnd , taken while no writer is between its change and its record
+    DirtySet changedTrains, changedTickets, changedPassengers;
+    uint64_t walEnd;
+    {
+        auto trainWrites = trains->lockWrites();
+        auto ticketWrites = tickets->lockWrites();
+        auto passengerWrites = passengers->lockWrites();
+        changedTrains = trains->takeDirty(trainWrites);
+        changedTickets = tickets->takeDirty(ticketWrites);
+        changedPassengers = passengers->takeDirty(passengerWrites);
+        walEnd = wal->endOffset();
+    }
+
+    bool full = rewriteNext ||
+                checkpointLog->getStats().size > std::max<long long>(options.minRewriteBytes, (long long)(fullBytes * options.rewriteRatio));
+    rewriteNext = true; // until this one made it to the disk
+    uint64_t fullFrom = checkpointLog->endOffset();
+    size_t records = 0;
+    if (full)
+        records = trains->checkpointAll(*checkpointLog) + tickets->checkpointAll(*checkpointLog) +
+                  passengers->checkpointAll(*checkpointLog);
+    else
+        records = trains->checkpoint(changedTrains, *checkpointLog) + tickets->checkpoint(changedTickets, *checkpointLog) +
+                  passengers->checkpoint(changedPassengers, *checkpointLog);
+    checkpointLog->sync();
+    if (full)
+    {
+        checkpointLog->discardBefore(fullFrom);
+        fullBytes = checkpointLog->getStats().size;
+    }
+    long long walBefore = wal->getStats().discarded;
+    wal->discardBefore(walEnd);
+    rewriteNext = false;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.checkpoints++;
+    stats.fullRewrites += full ? 1 : 0;
+    stats.records += (long long)records;
+    stats.walDiscarded += wal->getStats().discarded - walBefore;
+    stats.lastMs = ms;
+    stats.maxMs = std::max(stats.maxMs, ms);
+    CheckpointStats current = stats;
+    current.walBytes = wal->getStats().size;
+    current.checkpointBytes = checkpointLog->getStats().size;
+    return current;
+}
+
+CheckpointStats Checkpointer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    CheckpointStats current = stats;
+    current.walBytes = wal->getStats().size;
+    current.checkpointBytes = checkpointLog->getStats().size;
+    return current;
+}
@@ -0,0 +1,243 @@
+#include "Repo/DurablePassengerRepository.h"
+#include "utils/BinaryCodec.h"
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+DurablePassengerRepository::DurablePassengerRepository(std::unique_ptr<IPassengerRepository> inner, WriteAheadLog *log)
+    : inner(std::move(inner)), log(log)
+{
+    if (this->inner == nullptr || log == nullptr)
+        throw std::invalid_argument("Durable repository needs a repository and a log");
+}
+
+static std::string encodePassenger(const Passenger &passenger)
+{
+    ByteWriter out;
+    passenger.encode(out);
+    return out.take();
+}
+
+void DurablePassengerRepository::apply(const WalRecord &record)
+{
+    ByteReader in(record.body);
+    std::lock_guard<std::mutex> lock(order);
+    switch (record.op)
+    {
+    case WalOp::Put:
+    {
+        Passenger passenger = Passenger::decode(in);
+        inner->save(passenger);
+        dirty.ids.insert(passenger.getId());
+        break;
+    }
+    case WalOp::Delete:
+    {
+        int id = in.getInt();
+        inner->deletePassenger(id);
+        dirty.ids.insert(id);
+        break;
+    }
+    case WalOp::Clear:
+        inner->clear();
+        dirty = DirtySet{};
+        dirty.cleared = true;
+        break;
+    }
+}
+
+// see DurableTrainRepository::logged
+void DurablePassengerRepository::logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                   const std::function<void()> &undo)
+{
+    uint64_t lsn;
+    try
+    {
+        lsn = append();
+    }
+    catch (...)
+    {
+        undo();
+        throw;
+    }
+    lock.unlock();
+    try
+    {
+        log->commit(lsn);
+    }
+    catch (...)
+    {
+        lock.lock();
+        undo();
+        throw;
+    }
+}
+
+void DurablePassengerRepository::revert(int passengerId, const std::optional<Passenger> &before, long long written)
+{
+    std::optional<Passenger> now = inner->getPassenger(passengerId);
+    if ((now ? now->getVersion() : 0) != written)
+        return;
+    if (before)
+    {
+        Passenger copy = *before;
+        inner->save(copy);
+    }
+    else
+        inner->deletePassenger(passengerId);
+    dirty.ids.insert(passengerId);
+}
+
+void DurablePassengerRepository::save(Passenger &passenger)
+{
+    const Passenger original = passenger;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Passenger> before;
+    if (passenger.getId() != 0)
+        before = inner->getPassenger(passenger.getId());
+    inner->save(passenger);
+    dirty.ids.insert(passenger.getId());
+    logged(lock, [&] { return log->append(WalTable::Passengers, WalOp::Put, encodePassenger(passenger)); },
+           [&]
+           {
+               revert(passenger.getId(), before, passenger.getVersion());
+               passenger = original;
+           });
+}
+
+bool DurablePassengerRepository::compareAndSave(Passenger &passenger)
+{
+    const Passenger original = passenger;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Passenger> before;
+    if (passenger.getId() != 0)
+        before = inner->getPassenger(passenger.getId());
+    if (!inner->compareAndSave(passenger))
+        return false;
+    dirty.ids.insert(passenger.getId());
+    logged(lock, [&] { return log->append(WalTable::Passengers, WalOp::Put, encodePassenger(passenger)); },
+           [&]
+           {
+               revert(passenger.getId(), before, passenger.getVersion());
+               passenger = original;
+           });
+    return true;
+}
+
+void DurablePassengerRepository::saveAll(vector<Passenger> &passengers)
+{
+    if (passengers.size() == 0)
+        return;
+    const vector<Passenger> originals = passengers;
+    std::unique_lock<std::mutex> lock(order);
+    vector<std::optional<Passenger>> before;
+    for (size_t i = 0; i < passengers.size(); i++)
+        before.push_back(passengers[i].getId() != 0 ? inner->getPassenger(passengers[i].getId()) : std::nullopt);
+    inner->saveAll(passengers);
+    for (size_t i = 0; i < passengers.size(); i++)
+        dirty.ids.insert(passengers[i].getId());
+    // the batch is durable once its last record is
+    logged(lock,
+           [&]
+           {
+               uint64_t lsn = 0;
+               for (size_t i = 0; i < passengers.size(); i++)
+                   lsn = log->append(WalTable::Passengers, WalOp::Put, encodePassenger(passengers[i]));
+               return lsn;
+           },
+           [&]
+           {
+               for (size_t i = passengers.size(); i-- > 0;)
+                   revert(passengers[i].getId(), before[i], passengers[i].getVersion());
+               passengers = originals;
+           });
+}
+
+bool DurablePassengerRepository::deletePassenger(const int &passengerId)
+{
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Passenger> before = inner->getPassenger(passengerId);
+    if (!inner->deletePassenger(passengerId))
+        return false;
+    dirty.ids.insert(passengerId);
+    ByteWriter out;
+    out.putInt(passengerId);
+    logged(lock, [&] { return log->append(WalTable::Passengers, WalOp::Delete, out.data()); },
+           [&] { revert(passengerId, before, 0); });
+    return true;
+}
+
+void DurablePassengerRepository::clear()
+{
+    std::unique_lock<std::mutex> lock(order);
+    vector<Passenger> before = inner->getAllPassengers();
+    inner->clear();
+    dirty = DirtySet{};
+    dirty.cleared = true;
+    logged(lock, [&] { return log->append(WalTable::Passengers, WalOp::Clear, ""); },
+           [&]
+           {
+               for (size_t i = 0; i < before.size(); i++)
+                   revert(before[i].getId(), before[i], 0);
+           });
+}
+
+std::optional<Passenger> DurablePassengerRepository::getPassenger(const int &passengerId)
+{
+    return inner->getPassenger(passengerId);
+}
+
+vector<Passenger> DurablePassengerRepository::getAllPassengers()
+{
+    return inner->getAllPassengers();
+}
+
+std::optional<Passenger> DurablePassengerRepository::findPassengerByName(const std::string &name)
+{
+    return inner->findPassengerByName(name);
+}
+
+std::unique_lock<std::mutex> DurablePassengerRepository::lockWrites()
+{
+    return std::unique_lock<std::mutex>(order);
+}
+
+DirtySet DurablePassengerRepository::takeDirty(const std::unique_lock<std::mutex> &held)
+{
+    if (held.mutex() != &order || !held.owns_lock())
+        throw std::logic_error("takeDirty needs the lock from lockWrites");
+    return std::exchange(dirty, DirtySet{});
+}
+
+size_t DurablePassengerRepository::checkpoint(const DirtySet &changed, WriteAheadLog &to)
+{
+    size_t records = 0;
+    if (changed.cleared)
+    {
+        to.append(WalTable::Passengers, WalOp::Clear, "");
+        records++;
+    }
+    for (int id : changed.ids)
+    {
+        if (auto passenger = inner->getPassenger(id))
+            to.append(WalTable::Passengers, WalOp::Put, encodePassenger(*passenger));
+        else
+        {
+            ByteWriter out;
+            out.putInt(id);
+            to.append(WalTable::Passengers, WalOp::Delete, out.data());
+        }
+        records++;
+    }
+    return records;
+}
+
+size_t DurablePassengerRepository::checkpointAll(WriteAheadLog &to)
+{
+    size_t records = 0;
+    vector<Passenger> passengers = inner->getAllPassengers();
+    for (size_t i = 0; i < passengers.size(); i++)
+        to.append(WalTable::Passengers, WalOp::Put, encodePassenger(passengers[i]));
+    records += passengers.size();
+    return records;
+}
@@ -0,0 +1,263 @@
+#include "Repo/DurableTicketRepository.h"
+#include "utils/BinaryCodec.h"
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+DurableTicketRepository::DurableTicketRepository(std::unique_ptr<ITicketRepository> inner, WriteAheadLog *log)
+    : inner(std::move(inner)), log(log)
+{
+    if (this->inner == nullptr || log == nullptr)
+        throw std::invalid_argument("Durable repository needs a repository and a log");
+}
+
+static std::string encodeTicket(const Ticket &ticket)
+{
+    ByteWriter out;
+    ticket.encode(out);
+    return out.take();
+}
+
+void DurableTicketRepository::apply(const WalRecord &record)
+{
+    ByteReader in(record.body);
+    std::lock_guard<std::mutex> lock(order);
+    switch (record.op)
+    {
+    case WalOp::Put:
+    {
+        Ticket ticket = Ticket::decode(in);
+        inner->save(ticket);
+        dirty.ids.insert(ticket.getId());
+        break;
+    }
+    case WalOp::Delete:
+    {
+        int id = in.getInt();
+        inner->deleteTicket(id);
+        dirty.ids.insert(id);
+        break;
+    }
+    case WalOp::Clear:
+        inner->clear();
+        dirty = DirtySet{};
+        dirty.cleared = true;
+        break;
+    }
+}
+
+// see DurableTrainRepository::logged
+void DurableTicketRepository::logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                   const std::function<void()> &undo)
+{
+    uint64_t lsn;
+    try
+    {
+        lsn = append();
+    }
+    catch (...)
+    {
+        undo();
+        throw;
+    }
+    lock.unlock();
+    try
+    {
+        log->commit(lsn);
+    }
+    catch (...)
+    {
+        lock.lock();
+        undo();
+        throw;
+    }
+}
+
+void DurableTicketRepository::revert(int ticketId, const std::optional<Ticket> &before, long long written)
+{
+    std::optional<Ticket> now = inner->getTicketById(ticketId);
+    if ((now ? now->getVersion() : 0) != written)
+        return;
+    if (before)
+    {
+        Ticket copy = *before;
+        inner->save(copy);
+    }
+    else
+        inner->deleteTicket(ticketId);
+    dirty.ids.insert(ticketId);
+}
+
+void DurableTicketRepository::save(Ticket &ticket)
+{
+    const Ticket original = ticket;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Ticket> before;
+    if (ticket.getId() != 0)
+        before = inner->getTicketById(ticket.getId());
+    inner->save(ticket);
+    dirty.ids.insert(ticket.getId());
+    logged(lock, [&] { return log->append(WalTable::Tickets, WalOp::Put, encodeTicket(ticket)); },
+           [&]
+           {
+               revert(ticket.getId(), before, ticket.getVersion());
+               ticket = original;
+           });
+}
+
+bool DurableTicketRepository::compareAndSave(Ticket &ticket)
+{
+    const Ticket original = ticket;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Ticket> before;
+    if (ticket.getId() != 0)
+        before = inner->getTicketById(ticket.getId());
+    if (!inner->compareAndSave(ticket))
+        return false;
+    dirty.ids.insert(ticket.getId());
+    logged(lock, [&] { return log->append(WalTable::Tickets, WalOp::Put, encodeTicket(ticket)); },
+           [&]
+           {
+               revert(ticket.getId(), before, ticket.getVersion());
+               ticket = original;
+           });
+    return true;
+}
+
+void DurableTicketRepository::saveAll(vector<Ticket> &tickets)
+{
+    if (tickets.size() == 0)
+        return;
+    const vector<Ticket> originals = tickets;
+    std::unique_lock<std::mutex> lock(order);
+    vector<std::optional<Ticket>> before;
+    for (size_t i = 0; i < tickets.size(); i++)
+        before.push_back(tickets[i].getId() != 0 ? inner->getTicketById(tickets[i].getId()) : std::nullopt);
+    inner->saveAll(tickets);
+    for (size_t i = 0; i < tickets.size(); i++)
+        dirty.ids.insert(tickets[i].getId());
+    // the batch is durable once its last record is
+    logged(lock,
+           [&]
+           {
+               uint64_t lsn = 0;
+               for (size_t i = 0; i < tickets.size(); i++)
+                   lsn = log->append(WalTable::Tickets, WalOp::Put, encodeTicket(tickets[i]));
+               return lsn;
+           },
+           [&]
+           {
+               for (size_t i = tickets.size(); i-- > 0;)
+                   revert(tickets[i].getId(), before[i], tickets[i].getVersion());
+               tickets = originals;
+           });
+}
+
+bool DurableTicketRepository::deleteTicket(int ticketId)
+{
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Ticket> before = inner->getTicketById(ticketId);
+    if (!inner->deleteTicket(ticketId))
+        return false;
+    dirty.ids.insert(ticketId);
+    ByteWriter out;
+    out.putInt(ticketId);
+    logged(lock, [&] { return log->append(WalTable::Tickets, WalOp::Delete, out.data()); },
+           [&] { revert(ticketId, before, 0); });
+    return true;
+}
+
+void DurableTicketRepository::clear()
+{
+    std::unique_lock<std::mutex> lock(order);
+    vector<Ticket> before = inner->getAllTickets();
+    inner->clear();
+    dirty = DirtySet{};
+    dirty.cleared = true;
+    logged(lock, [&] { return log->append(WalTable::Tickets, WalOp::Clear, ""); },
+           [&]
+           {
+               for (size_t i = 0; i < before.size(); i++)
+                   revert(before[i].getId(), before[i], 0);
+           });
+}
+
+std::optional<Ticket> DurableTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    return inner->getTicketByTrainAndPassenger(trainId, passengerId);
+}
+
+std::optional<Ticket> DurableTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    return inner->getTicketByTrainAndPassenger(trainId, passengerId, travelDate);
+}
+
+vector<Ticket> DurableTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    return inner->getTicketsByPassenger(passengerId);
+}
+
+vector<Ticket> DurableTicketRepository::getAllTickets()
+{
+    return inner->getAllTickets();
+}
+
+vector<Ticket> DurableTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return inner->getTicketsPage(afterId, limit);
+}
+
+std::optional<Ticket> DurableTicketRepository::getTicketById(int ticketId)
+{
+    return inner->getTicketById(ticketId);
+}
+
+Snapshot<Ticket> DurableTicketRepository::snapshot()
+{
+    return inner->snapshot();
+}
+
+std::unique_lock<std::mutex> DurableTicketRepository::lockWrites()
+{
+    return std::unique_lock<std::mutex>(order);
+}
+
+DirtySet DurableTicketRepository::takeDirty(const std::unique_lock<std::mutex> &held)
+{
+    if (held.mutex() != &order || !held.owns_lock())
+        throw std::logic_error("takeDirty needs the lock from lockWrites");
+    return std::exchange(dirty, DirtySet{});
+}
+
+size_t DurableTicketRepository::checkpoint(const DirtySet &changed, WriteAheadLog &to)
+{
+    size_t records = 0;
+    if (changed.cleared)
+    {
+        to.append(WalTable::Tickets, WalOp::Clear, "");
+        records++;
+    }
+    for (int id : changed.ids)
+    {
+        if (auto ticket = inner->getTicketById(id))
+            to.append(WalTable::Tickets, WalOp::Put, encodeTicket(*ticket));
+        else
+        {
+            ByteWriter out;
+            out.putInt(id);
+            to.append(WalTable::Tickets, WalOp::Delete, out.data());
+        }
+        records++;
+    }
+    return records;
+}
+
+size_t DurableTicketRepository::checkpointAll(WriteAheadLog &to)
+{
+    size_t records = 0;
+    inner->snapshot().forEach([&](const Ticket &ticket) {
+        to.append(WalTable::Tickets, WalOp::Put, encodeTicket(ticket));
+        records++;
+    });
+    return records;
+}
@@ -0,0 +1,252 @@
+#include "Repo/DurableTrainRepository.h"
+#include "utils/BinaryCodec.h"
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+DurableTrainRepository::DurableTrainRepository(std::unique_ptr<ITrainRepository> inner, WriteAheadLog *log)
+    : inner(std::move(inner)), log(log)
+{
+    if (this->inner == nullptr || log == nullptr)
+        throw std::invalid_argument("Durable repository needs a repository and a log");
+}
+
+static std::string encodeTrain(const Train &train)
+{
+    ByteWriter out;
+    train.encode(out);
+    return out.take();
+}
+
+void DurableTrainRepository::apply(const WalRecord &record)
+{
+    ByteReader in(record.body);
+    std::lock_guard<std::mutex> lock(order);
+    switch (record.op)
+    {
+    case WalOp::Put:
+    {
+        Train train = Train::decode(in);
+        inner->save(train); // same saves in the same order , so the versions come out the same
+        dirty.ids.insert(train.getTrainId());
+        break;
+    }
+    case WalOp::Delete:
+    {
+        int id = in.getInt();
+        inner->deleteTrain(id);
+        dirty.ids.insert(id);
+        break;
+    }
+    case WalOp::Clear:
+        inner->clear();
+        dirty = DirtySet{};
+        dirty.cleared = true;
+        break;
+    }
+}
+
+// appends the record of a change already made to inner and waits for it . when the log fails the
+// change is undone and the exception passed on , so a write that throws left nothing behind . lock
+// holds order , it is released for the wait and taken again to undo
+void DurableTrainRepository::logged(std::unique_lock<std::mutex> &lock, const std::function<uint64_t()> &append,
+                   const std::function<void()> &undo)
+{
+    uint64_t lsn;
+    try
+    {
+        lsn = append();
+    }
+    catch (...)
+    {
+        undo();
+        throw;
+    }
+    lock.unlock();
+    try
+    {
+        log->commit(lsn);
+    }
+    catch (...)
+    {
+        lock.lock();
+        undo();
+        throw;
+    }
+}
+
+// puts back what a failed change replaced ( before , nothing for a new record ) as long as the
+// record is still the one it wrote ( written , 0 for a delete ) ; a change made after it is left alone
+void DurableTrainRepository::revert(int trainId, const std::optional<Train> &before, long long written)
+{
+    std::optional<Train> now = inner->getTrainById(trainId);
+    if ((now ? now->getVersion() : 0) != written)
+        return;
+    if (before)
+    {
+        Train copy = *before;
+        inner->save(copy);
+    }
+    else
+        inner->deleteTrain(trainId);
+    dirty.ids.insert(trainId);
+}
+
+void DurableTrainRepository::save(Train &train)
+{
+    const Train original = train;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Train> before;
+    if (train.getTrainId() != 0)
+        before = inner->getTrainById(train.getTrainId());
+    inner->save(train);
+    dirty.ids.insert(train.getTrainId());
+    logged(lock, [&] { return log->append(WalTable::Trains, WalOp::Put, encodeTrain(train)); },
+           [&]
+           {
+               revert(train.getTrainId(), before, train.getVersion());
+               train = original;
+           });
+}
+
+bool DurableTrainRepository::compareAndSave(Train &train)
+{
+    const Train original = train;
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Train> before;
+    if (train.getTrainId() != 0)
+        before = inner->getTrainById(train.getTrainId());
+    if (!inner->compareAndSave(train))
+        return false;
+    dirty.ids.insert(train.getTrainId());
+    logged(lock, [&] { return log->append(WalTable::Trains, WalOp::Put, encodeTrain(train)); },
+           [&]
+           {
+               revert(train.getTrainId(), before, train.getVersion());
+               train = original;
+           });
+    return true;
+}
+
+void DurableTrainRepository::saveAll(vector<Train> &trains)
+{
+    if (trains.size() == 0)
+        return;
+    const vector<Train> originals = trains;
+    std::unique_lock<std::mutex> lock(order);
+    vector<std::optional<Train>> before;
+    for (size_t i = 0; i < trains.size(); i++)
+        before.push_back(trains[i].getTrainId() != 0 ? inner->getTrainById(trains[i].getTrainId()) : std::nullopt);
+    inner->saveAll(trains);
+    for (size_t i = 0; i < trains.size(); i++)
+        dirty.ids.insert(trains[i].getTrainId());
+    // the batch is durable once its last record is
+    logged(lock,
+           [&]
+           {
+               uint64_t lsn = 0;
+               for (size_t i = 0; i < trains.size(); i++)
+                   lsn = log->append(WalTable::Trains, WalOp::Put, encodeTrain(trains[i]));
+               return lsn;
+           },
+           [&]
+           {
+               for (size_t i = trains.size(); i-- > 0;)
+                   revert(trains[i].getTrainId(), before[i], trains[i].getVersion());
+               trains = originals;
+           });
+}
+
+bool DurableTrainRepository::deleteTrain(int trainId)
+{
+    std::unique_lock<std::mutex> lock(order);
+    std::optional<Train> before = inner->getTrainById(trainId);
+    if (!inner->deleteTrain(trainId))
+        return false;
+    dirty.ids.insert(trainId);
+    ByteWriter out;
+    out.putInt(trainId);
+    logged(lock, [&] { return log->append(WalTable::Trains, WalOp::Delete, out.data()); },
+           [&] { revert(trainId, before, 0); });
+    return true;
+}
+
+void DurableTrainRepository::clear()
+{
+    std::unique_lock<std::mutex> lock(order);
+    vector<Train> before = inner->getAllTrains();
+    inner->clear();
+    dirty = DirtySet{};
+    dirty.cleared = true;
+    logged(lock, [&] { return log->append(WalTable::Trains, WalOp::Clear, ""); },
+           [&]
+           {
+               for (size_t i = 0; i < before.size(); i++)
+                   revert(before[i].getTrainId(), before[i], 0);
+           });
+}
+
+vector<Train> DurableTrainRepository::getAllTrains() const
+{
+    return inner->getAllTrains();
+}
+
+vector<Train> DurableTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    return inner->getTrainsPage(afterId, limit);
+}
+
+std::optional<Train> DurableTrainRepository::getTrainById(const int &trainId) const
+{
+    return inner->getTrainById(trainId);
+}
+
+Snapshot<Train> DurableTrainRepository::snapshot() const
+{
+    return inner->snapshot();
+}
+
+std::unique_lock<std::mutex> DurableTrainRepository::lockWrites()
+{
+    return std::unique_lock<std::mutex>(order);
+}
+
+DirtySet DurableTrainRepository::takeDirty(const std::unique_lock<std::mutex> &held)
+{
+    if (held.mutex() != &order || !held.owns_lock())
+        throw std::logic_error("takeDirty needs the lock from lockWrites");
+    return std::exchange(dirty, DirtySet{});
+}
+
+size_t DurableTrainRepository::checkpoint(const DirtySet &changed, WriteAheadLog &to)
+{
+    size_t records = 0;
+    if (changed.cleared)
+    {
+        to.append(WalTable::Trains, WalOp::Clear, "");
+        records++;
+    }
+    for (int id : changed.ids)
+    {
+        if (auto train = inner->getTrainById(id))
+            to.append(WalTable::Trains, WalOp::Put, encodeTrain(*train));
+        else
+        {
+            ByteWriter out;
+            out.putInt(id);
+            to.append(WalTable::Trains, WalOp::Delete, out.data());
+        }
+        records++;
+    }
+    return records;
+}
+
+size_t DurableTrainRepository::checkpointAll(WriteAheadLog &to)
+{
+    size_t records = 0;
+    inner->snapshot().forEach([&](const Train &train) {
+        to.append(WalTable::Trains, WalOp::Put, encodeTrain(train));
+        records++;
+    });
+    return records;
+}
@@ -6,8 +6,10 @@
 #include <iostream>
 #include <optional>
 #include "Repo/InMemoryPassengerRepository.h"
+#include "utils/helpers.h"
 
 std::optional<Passenger> InMemoryPassengerRepository::getPassenger(const int &passengerId) {
+    std::shared_lock lock(mutex);
     auto  result = passengers.find(passengerId);
     if(result != passengers.end()){
         return result->second;
@@ -16,6 +18,7 @@ std::optional<Passenger> InMemoryPassengerRepository::getPassenger(const int &pa
 }
 
 vector<Passenger> InMemoryPassengerRepository::getAllPassengers() {
+    std::shared_lock lock(mutex);
     vector<Passenger> results ;
     for(const auto & ps : passengers){
         results.push_back(ps.second);
@@ -23,25 +26,70 @@ vector<Passenger> InMemoryPassengerRepository::getAllPassengers() {
     return results;
 }
 
-void InMemoryPassengerRepository::save(Passenger &passenger) {
+std::optional<Passenger> InMemoryPassengerRepository::findPassengerByName(const std::string &name) {
+    const std::string wanted = toLowerCase(name);
+    std::shared_lock lock(mutex);
+    const Passenger *found = nullptr;
+    for (const auto &ps : passengers) {
+        if ((found == nullptr || ps.second.getId() < found->getId()) && toLowerCase(ps.second.getName()) == wanted)
+            found = &ps.second;
+    }
+    if (found == nullptr)
+        return std::nullopt;
+    return *found;
+}
+
+void InMemoryPassengerRepository::assignId(Passenger &passenger) {
     if(passenger.getId() == 0 ){
-        passenger.setId(next_id++);
-    }else if(passenger.getId() >= next_id){
-        next_id =passenger.getId() + 1;
+        passenger.setId(next_id.fetch_add(1));
+    }else{
+        int current = next_id.load();
+        while(passenger.getId() >= current && !next_id.compare_exchange_weak(current, passenger.getId() + 1)){
+        }
     }
-    const int id =passenger.getId();
-    auto res = passengers.emplace(id,passenger);
+}
+
+void InMemoryPassengerRepository::store(Passenger &passenger, long long storedVersion) {
+    passenger.setVersion(storedVersion + 1);
+    auto res = passengers.emplace(passenger.getId(),passenger);
 
     // If the key is found it's already updated
 
      if(!res.second){ //update
          res.first->second = passenger;
      }
+}
+
+void InMemoryPassengerRepository::save(Passenger &passenger) {
+    assignId(passenger);
+    std::unique_lock lock(mutex);
+    auto it = passengers.find(passenger.getId());
+    store(passenger, it != passengers.end() ? it->second.getVersion() : 0);
+}
 
+void InMemoryPassengerRepository::saveAll(vector<Passenger> &batch) {
+    for (size_t i = 0; i < batch.size(); i++)
+        assignId(batch[i]);
+    std::unique_lock lock(mutex);
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto it = passengers.find(batch[i].getId());
+        store(batch[i], it != passengers.end() ? it->second.getVersion() : 0);
+    }
+}
 
+bool InMemoryPassengerRepository::compareAndSave(Passenger &passenger) {
+    assignId(passenger);
+    std::unique_lock lock(mutex);
+    auto it = passengers.find(passenger.getId());
+    long long storedVersion = it != passengers.end() ? it->second.getVersion() : 0;
+    if(storedVersion != passenger.getVersion())
+        return false;
+    store(passenger, storedVersion);
+    return true;
 }
 
 bool InMemoryPassengerRepository::deletePassenger(const int &passengerId) {
+    std::unique_lock lock(mutex);
     auto it = passengers.find(passengerId);
     if (it != passengers.end()) {
         passengers.erase(it);
@@ -51,6 +99,7 @@ bool InMemoryPassengerRepository::deletePassenger(const int &passengerId) {
 }
 
 void InMemoryPassengerRepository::clear() {
+    std::unique_lock lock(mutex);
     passengers.clear();
     next_id= 1;
     std::cout << "All passengers destroyed\n";
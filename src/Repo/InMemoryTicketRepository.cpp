@@ -2,76 +2,202 @@
 #include <stdexcept>
 #include <iostream>
 
-std::optional<Ticket> InMemoryTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+// the index buckets by key modulo a power of two , so the train id in the high half would never
+// pick a bucket : every ticket of one passenger would share one . multiplying by an odd constant
+// is a bijection on 64 bits , keys stay unique and the train id reaches the low bits
+long long InMemoryTicketRepository::indexKey(int trainId, int passengerId)
+{
+    uint64_t packed = ((uint64_t)(unsigned)trainId << 32) | (unsigned)passengerId;
+    return (long long)(packed * 0x9E3779B97F4A7C15ull);
+}
+
+static void removeId(vector<int> &ids, int id)
 {
-    for (const auto &p : tickets)
+    for (size_t i = 0; i < ids.size(); i++)
     {
-        const Ticket &t = p.second;
-        if (t.getTrainId() == trainId && t.getPassenger().getId() == passengerId)
+        if (ids[i] == id)
         {
-            return t;
+            ids.erase(i);
+            break;
         }
     }
+}
+
+// keeps the list ascending , ids are usually handed out in order so this appends
+static void insertId(vector<int> &ids, int id)
+{
+    size_t pos = ids.size();
+    while (pos > 0 && ids[pos - 1] > id)
+        pos--;
+    ids.insert(pos, id);
+}
+
+void InMemoryTicketRepository::unindex(const Ticket &ticket)
+{
+    auto it = byTrainPassenger.find(indexKey(ticket.getTrainId(), ticket.getPassenger().getId()));
+    if (it != byTrainPassenger.end())
+        removeId((*it).second, ticket.getId());
+    auto byP = byPassenger.find(ticket.getPassenger().getId());
+    if (byP != byPassenger.end())
+        removeId((*byP).second, ticket.getId());
+}
+
+std::optional<Ticket> InMemoryTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    std::shared_lock lock(mutex);
+    auto it = byTrainPassenger.find(indexKey(trainId, passengerId));
+    if (it == byTrainPassenger.end() || (*it).second.empty())
+        return std::nullopt;//not found
+    return **tickets.find((*it).second[0]);
+}
+
+std::optional<Ticket> InMemoryTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    std::shared_lock lock(mutex);
+    auto it = byTrainPassenger.find(indexKey(trainId, passengerId));
+    if (it == byTrainPassenger.end())
+        return std::nullopt;//not found
+    for (size_t i = 0; i < (*it).second.size(); i++)
+    {
+        const Ticket &t = **tickets.find((*it).second[i]);
+        if (t.getTravelDate() == travelDate)
+            return t;
+    }
     return std::nullopt;//not found
 }
 
+vector<Ticket> InMemoryTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    std::shared_lock lock(mutex);
+    vector<Ticket> results;
+    auto it = byPassenger.find(passengerId);
+    if (it == byPassenger.end())
+        return results;
+    for (size_t i = 0; i < (*it).second.size(); i++)
+        results.push_back(**tickets.find((*it).second[i]));
+    return results;
+}
+
 bool InMemoryTicketRepository::deleteTicket(int ticketId)
 {
-    auto it = tickets.find(ticketId);
-    if (it != tickets.end())
+    std::unique_lock lock(mutex);
+    auto found = tickets.find(ticketId);
+    if (found != nullptr)
     {
-        tickets.erase(it);
+        unindex(**found);
+        tickets.erase(ticketId);
         return true;
     }
     return false;
 }
 
-void InMemoryTicketRepository::save( Ticket& ticket)
+void InMemoryTicketRepository::assignId(Ticket &ticket)
 {
-    // later
     if (ticket.getId() == 0)
     {
-        ticket.setId(next_id++);
+        ticket.setId(next_id.fetch_add(1));
     }
-    else if (ticket.getId() >= next_id)
+    else
     {
-        next_id = ticket.getId() + 1;
+        int current = next_id.load();
+        while (ticket.getId() >= current && !next_id.compare_exchange_weak(current, ticket.getId() + 1))
+        {
+        }
     }
+}
 
+void InMemoryTicketRepository::store(Ticket &ticket)
+{
     int id = ticket.getId();
-
-    auto result = tickets.emplace(id, ticket);
-    if (!result.second)
+    long long key = indexKey(ticket.getTrainId(), ticket.getPassenger().getId());
+    auto existing = tickets.find(id);
+    bool indexed = false;
+    long long storedVersion = 0;
+    if (existing != nullptr)
+    {
+        const Ticket &old = **existing;
+        storedVersion = old.getVersion();
+        indexed = indexKey(old.getTrainId(), old.getPassenger().getId()) == key;
+        if (!indexed)
+            unindex(old); // moved to another passenger
+    }
+    ticket.setVersion(storedVersion + 1);
+    tickets.insert(id, std::make_shared<const Ticket>(ticket)); // inserts or updates
+    if (!indexed)
     {
-        result.first->second = ticket; // update existing
+        byTrainPassenger[key].push_back(id);
+        insertId(byPassenger[ticket.getPassenger().getId()], id);
     }
+}
 
+void InMemoryTicketRepository::save( Ticket& ticket)
+{
+    assignId(ticket);
+    std::unique_lock lock(mutex);
+    store(ticket);
 }
 
+void InMemoryTicketRepository::saveAll(vector<Ticket> &batch)
+{
+    for (size_t i = 0; i < batch.size(); i++)
+        assignId(batch[i]);
+    std::unique_lock lock(mutex);
+    for (size_t i = 0; i < batch.size(); i++)
+        store(batch[i]);
+}
+
+bool InMemoryTicketRepository::compareAndSave(Ticket &ticket)
+{
+    assignId(ticket);
+    std::unique_lock lock(mutex);
+    auto existing = tickets.find(ticket.getId());
+    long long storedVersion = existing != nullptr ? (*existing)->getVersion() : 0;
+    if (storedVersion != ticket.getVersion())
+        return false; // someone saved since this copy was read
+    store(ticket);
+    return true;
+}
+
+// listings walk a snapshot , the lock is only held to take it
 vector<Ticket> InMemoryTicketRepository::getAllTickets()
 {
-    vector<Ticket> results;
-    for (const auto &p : tickets)
-    {
-        results.push_back(p.second);
-    }
-    return results;
+    return snapshot().toVector();
+}
+
+vector<Ticket> InMemoryTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return snapshot().page(afterId, limit);
 }
 
 std::optional<Ticket> InMemoryTicketRepository::getTicketById(int ticketId)
 {
-    auto it = tickets.find(ticketId);
-    if (it != tickets.end())
+    std::shared_lock lock(mutex);
+    auto found = tickets.find(ticketId);
+    if (found != nullptr)
     {
-        return it->second;
+        return **found;
     }
     return std::nullopt; // not found
 }
 
+Snapshot<Ticket> InMemoryTicketRepository::snapshot()
+{
+    std::shared_lock lock(mutex);
+    return Snapshot<Ticket>(tickets);
+}
+
 void InMemoryTicketRepository::clear()
 {
-    tickets.clear();
-    next_id= 1;
+    discardAll();
     std::cout << "All tickets destroyed\n";
 
 }
+
+void InMemoryTicketRepository::discardAll()
+{
+    std::unique_lock lock(mutex);
+    tickets.clear();
+    byTrainPassenger.clear();
+    byPassenger.clear();
+    next_id= 1;
+}
@@ -2,52 +2,93 @@
 #include <iostream>
 #include <stdexcept>
 
+// raise next_id past an id chosen by the caller
+static void bumpNextId(std::atomic<int>& next_id, int id)
+{
+    int current = next_id.load();
+    while (id >= current && !next_id.compare_exchange_weak(current, id + 1)) {
+    }
+}
+
+// listings walk a snapshot , the lock is only held to take it
 vector<Train> InMemoryTrainRepository::getAllTrains() const {
-    vector<Train> result;
-    for (const auto& train : trains) {
-        result.push_back(train.second);
+    return snapshot().toVector();
+}
+
+vector<Train> InMemoryTrainRepository::getTrainsPage(int afterId, int limit) const {
+    return snapshot().page(afterId, limit);
+}
+
+Snapshot<Train> InMemoryTrainRepository::snapshot() const {
+    std::shared_lock lock(mutex);
+    return Snapshot<Train>(trains);
+}
+
+void InMemoryTrainRepository::assignId(Train &train) {
+    if (train.getTrainId() == 0) {
+        train.setTrainId(next_id.fetch_add(1));
+    }else {
+        bumpNextId(next_id, train.getTrainId());
     }
-    return result;
+}
+
+void InMemoryTrainRepository::store(Train &train, long long storedVersion) {
+    train.setVersion(storedVersion + 1);
+    trains.insert(train.getTrainId(), std::make_shared<const Train>(train)); // inserts or updates
 }
 
 void InMemoryTrainRepository::save(Train & newTrain) {
     // assign id if needed
-    if (newTrain.getTrainId() == 0) {
-        newTrain.setTrainId(next_id++);
-    }else if(newTrain.getTrainId() >= next_id){
-        next_id = newTrain.getTrainId() + 1;
-    }
-
-    int trainId = newTrain.getTrainId();
+    assignId(newTrain);
 
-    auto result = trains.emplace(trainId, newTrain);
+    std::unique_lock lock(mutex);
+    auto stored = trains.find(newTrain.getTrainId());
+    store(newTrain, stored != nullptr ? (*stored)->getVersion() : 0);
+}
 
-    // If trainId already existed, update it
-    if (!result.second) {
-        result.first->second = newTrain;
+void InMemoryTrainRepository::saveAll(vector<Train> &batch) {
+    for (size_t i = 0; i < batch.size(); i++)
+        assignId(batch[i]);
+    std::unique_lock lock(mutex);
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto stored = trains.find(batch[i].getTrainId());
+        store(batch[i], stored != nullptr ? (*stored)->getVersion() : 0);
     }
+}
+
+bool InMemoryTrainRepository::compareAndSave(Train &train) {
+    assignId(train);
 
+    std::unique_lock lock(mutex);
+    auto stored = trains.find(train.getTrainId());
+    long long storedVersion = stored != nullptr ? (*stored)->getVersion() : 0;
+    if (storedVersion != train.getVersion())
+        return false; // someone saved since this copy was read
+    store(train, storedVersion);
+    return true;
 }
 
 bool InMemoryTrainRepository::deleteTrain(int trainId) {
-    auto it = trains.find(trainId);
-    if (it != trains.end()) {
-        trains.erase(it);
-        return true;
-    }
-    return false;
+    std::unique_lock lock(mutex);
+    return trains.erase(trainId);
 }
 
 std::optional<Train>   InMemoryTrainRepository::getTrainById(const int& trainId) const {
-    auto it = trains.find(trainId);
-    if (it != trains.end()) {
-        return it->second;
+    std::shared_lock lock(mutex);
+    auto stored = trains.find(trainId);
+    if (stored != nullptr) {
+        return **stored;
     }
     return std::nullopt; // not found
 }
 
 void InMemoryTrainRepository::clear() {
+    discardAll();
+    std::cout << "All trains destroyed\n";
+}
+
+void InMemoryTrainRepository::discardAll() {
+    std::unique_lock lock(mutex);
     trains.clear();
     next_id= 1;
-    std::cout << "All trains destroyed\n";
 }
@@ -0,0 +1,315 @@
+#include "Repo/LogReplica.h"
+#include "utils/BinaryCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+LogReplica::LogReplica(ITrainRepository *trains, ITicketRepository *tickets, IPassengerRepository *passengers,
+                       const std::string &path, const ReplicaOptions &options)
+    : trains(trains), tickets(tickets), passengers(passengers), path(path), options(options)
+{
+    if (trains == nullptr || tickets == nullptr || passengers == nullptr)
+        throw std::invalid_argument("Replica needs the three repositories");
+    if (path.empty())
+        throw std::invalid_argument("Replica path cannot be empty");
+    if (options.retryMs <= 0)
+        throw std::invalid_argument("Replica retry interval must be greater than zero");
+    if (!options.fromFile && path.size() >= sizeof(sockaddr_un{}.sun_path))
+        throw std::invalid_argument("Socket path is too long: " + path);
+    if (::pipe2(wakeFds, O_NONBLOCK | O_CLOEXEC) != 0)
+        throw std::runtime_error("Cannot create pipe for replica of " + path + ": " + std::strerror(errno) + "\n");
+    reader = std::thread([this] { run(); });
+}
+
+LogReplica::~LogReplica()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    progressed.notify_all();
+    char byte = 1;
+    ssize_t ignored = ::write(wakeFds[1], &byte, 1);
+    (void)ignored;
+    reader.join();
+    ::close(wakeFds[0]);
+    ::close(wakeFds[1]);
+}
+
+// false : stopping
+bool LogReplica::pause()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return !progressed.wait_for(lock, std::chrono::milliseconds(options.retryMs), [&] { return stopping; });
+}
+
+int LogReplica::connect()
+{
+    if (options.fromFile)
+        return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    if (::connect(fd, (sockaddr *)&address, sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void LogReplica::run()
+{
+    while (true)
+    {
+        int fd = connect();
+        if (fd >= 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.connected = true;
+                stats.connects++;
+            }
+            try
+            {
+                follow(fd);
+            }
+            catch (...)
+            {
+                // a bad message : start over from a new snapshot
+            }
+            ::close(fd);
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.connected = false;
+            stats.appliedPosition = 0; // positions start over with the next primary
+            resyncing = false;
+        }
+        if (!pause())
+            return;
+    }
+}
+
+// until the primary goes away (or the file is replaced) or the replica stops
+void LogReplica::follow(int fd)
+{
+    std::string buffer;
+    std::vector<char> chunk(1 << 16);
+    off_t offset = 0;
+    struct stat opened{};
+    if (options.fromFile)
+        ::fstat(fd, &opened);
+    while (true)
+    {
+        pollfd fds[2] = {{fd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+        if (!options.fromFile)
+            ::poll(fds, 2, -1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+                return;
+        }
+        ssize_t n = ::read(fd, chunk.data(), chunk.size());
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (n < 0 || (n == 0 && !options.fromFile))
+            return;
+        if (n == 0)
+        {
+            // the end of the file for now . a primary that started again truncated or replaced it
+            struct stat now{};
+            if (::stat(path.c_str(), &now) != 0 || now.st_ino != opened.st_ino || now.st_size < offset)
+                return;
+            ::poll(&fds[1], 1, options.retryMs);
+            continue;
+        }
+        offset += n;
+        buffer.append(chunk.data(), (size_t)n);
+        buffer.erase(0, handle(buffer.data(), buffer.size()));
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.bytes += n;
+    }
+}
+
+// the whole messages at the front of data , returns the bytes they took
+size_t LogReplica::handle(const char *data, size_t size)
+{
+    size_t used = 0;
+    while (size - used >= SHIP_HEADER)
+    {
+        uint8_t kind = (uint8_t)data[used];
+        uint32_t length;
+        uint64_t sentNs, position;
+        std::memcpy(&length, data + used + 1, sizeof(length));
+        std::memcpy(&sentNs, data + used + 1 + sizeof(length), sizeof(sentNs));
+        std::memcpy(&position, data + used + 1 + sizeof(length) + sizeof(sentNs), sizeof(position));
+        if (size - used - SHIP_HEADER < length)
+            break;
+        const char *payload = data + used + SHIP_HEADER;
+        long long records = 0;
+        switch ((ShipKind)kind)
+        {
+        case ShipKind::SnapshotBegin:
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            resyncing = true;
+            stats.appliedPosition = 0; // not current until the snapshot ends
+            stats.primaryPosition = position;
+            break;
+        }
+        case ShipKind::Records:
+            if (WriteAheadLog::readFrames(payload, length, [&](const WalRecord &record) {
+                    apply(record);
+                    records++;
+                }) != length)
+                throw std::runtime_error("Bad replication message\n");
+            break;
+        case ShipKind::SnapshotEnd:
+            endSnapshot();
+            break;
+        case ShipKind::Heartbeat:
+            break;
+        default:
+            throw std::runtime_error("Bad replication message\n");
+        }
+        used += SHIP_HEADER + length;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.messages++;
+            stats.records += records;
+            stats.primaryPosition = std::max(stats.primaryPosition, position);
+            if (!resyncing)
+            {
+                // in order : everything the primary shipped before this message is applied
+                stats.appliedPosition = std::max(stats.appliedPosition, position);
+                lastSentNs = sentNs;
+                uint64_t now = shipClockNs();
+                if ((ShipKind)kind == ShipKind::Records)
+                {
+                    stats.lagMs = now > sentNs ? (double)(now - sentNs) / 1e6 : 0;
+                    stats.maxLagMs = std::max(stats.maxLagMs, stats.lagMs);
+                }
+            }
+        }
+        progressed.notify_all();
+    }
+    return used;
+}
+
+void LogReplica::apply(const WalRecord &record)
+{
+    ByteReader in(record.body);
+    switch (record.table)
+    {
+    case WalTable::Trains:
+        if (record.op == WalOp::Put)
+        {
+            Train train = Train::decode(in);
+            trains->save(train);
+            if (resyncing)
+                seenTrains.insert(train.getTrainId());
+        }
+        else if (record.op == WalOp::Delete)
+            trains->deleteTrain(in.getInt());
+        else
+            trains->clear();
+        break;
+    case WalTable::Tickets:
+        if (record.op == WalOp::Put)
+        {
+            Ticket ticket = Ticket::decode(in);
+            tickets->save(ticket);
+            if (resyncing)
+                seenTickets.insert(ticket.getId());
+        }
+        else if (record.op == WalOp::Delete)
+            tickets->deleteTicket(in.getInt());
+        else
+            tickets->clear();
+        break;
+    case WalTable::Passengers:
+        if (record.op == WalOp::Put)
+        {
+            Passenger passenger = Passenger::decode(in);
+            passengers->save(passenger);
+            if (resyncing)
+                seenPassengers.insert(passenger.getId());
+        }
+        else if (record.op == WalOp::Delete)
+            passengers->deletePassenger(in.getInt());
+        else
+            passengers->clear();
+        break;
+    }
+}
+
+// the rows the replica kept from before that the primary no longer has
+void LogReplica::endSnapshot()
+{
+    std::vector<int> gone;
+    trains->snapshot().forEach([&](const Train &train) {
+        if (!seenTrains.count(train.getTrainId()))
+            gone.push_back(train.getTrainId());
+    });
+    for (int id : gone)
+        trains->deleteTrain(id);
+    gone.clear();
+    tickets->snapshot().forEach([&](const Ticket &ticket) {
+        if (!seenTickets.count(ticket.getId()))
+            gone.push_back(ticket.getId());
+    });
+    for (int id : gone)
+        tickets->deleteTicket(id);
+    gone.clear();
+    for (const Passenger &passenger : passengers->getAllPassengers())
+        if (!seenPassengers.count(passenger.getId()))
+            gone.push_back(passenger.getId());
+    for (int id : gone)
+        passengers->deletePassenger(id);
+    seenTrains.clear();
+    seenTickets.clear();
+    seenPassengers.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    resyncing = false;
+    stats.ready = true;
+    stats.snapshots++;
+}
+
+bool LogReplica::waitUntilReady(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return progressed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return stats.ready || stopping; }) &&
+           stats.ready;
+}
+
+bool LogReplica::waitForPosition(uint64_t position, int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return progressed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] {
+               return (stats.ready && !resyncing && stats.appliedPosition >= position) || stopping;
+           }) &&
+           stats.appliedPosition >= position && !resyncing;
+}
+
+ReplicaStats LogReplica::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ReplicaStats current = stats;
+    uint64_t now = shipClockNs();
+    if (lastSentNs != 0 && now > lastSentNs)
+        current.stalenessMs = (double)(now - lastSentNs) / 1e6;
+    return current;
+}
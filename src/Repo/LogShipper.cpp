@@ -0,0 +1,359 @@
+#include "Repo/LogShipper.h"
+#include "utils/BinaryCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static constexpr size_t CHUNK = 1 << 20; // snapshot records per message
+
+static std::runtime_error systemError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno) + "\n");
+}
+
+uint64_t shipClockNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string shipHeader(ShipKind kind, uint32_t size, uint64_t sentNs, uint64_t position)
+{
+    std::string header(SHIP_HEADER, '\0');
+    header[0] = (char)kind;
+    std::memcpy(&header[1], &size, sizeof(size));
+    std::memcpy(&header[1 + sizeof(size)], &sentNs, sizeof(sentNs));
+    std::memcpy(&header[1 + sizeof(size) + sizeof(sentNs)], &position, sizeof(position));
+    return header;
+}
+
+LogShipper::LogShipper(WriteAheadLog *wal, ITrainRepository *trains, ITicketRepository *tickets,
+                       IPassengerRepository *passengers, const std::string &path, const ShippingOptions &options)
+    : wal(wal), trains(trains), tickets(tickets), passengers(passengers), path(path), options(options)
+{
+    if (wal == nullptr || trains == nullptr || tickets == nullptr || passengers == nullptr)
+        throw std::invalid_argument("Log shipping needs the write-ahead log and the three repositories");
+    if (path.empty())
+        throw std::invalid_argument("Log shipping path cannot be empty");
+    if (options.heartbeatMs <= 0 || options.maxBufferBytes == 0)
+        throw std::invalid_argument("Heartbeat interval and replica buffer must be greater than zero");
+
+    if (options.toFile)
+    {
+        auto replica = std::make_unique<Replica>();
+        replica->socket = false;
+        replica->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (replica->fd < 0)
+            throw systemError("Cannot create shipping file", path);
+        replicas.push_back(std::move(replica));
+        stats.connects++;
+    }
+    else
+    {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Socket path is too long: " + path);
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        // a socket left behind by a primary that died is in the way , anything else is not ours
+        struct stat info{};
+        if (::lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+            ::unlink(path.c_str());
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0)
+            throw systemError("Cannot create socket", path);
+        if (::bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || ::listen(listenFd, 16) != 0)
+        {
+            std::runtime_error error = systemError("Cannot listen on", path);
+            ::close(listenFd);
+            throw error;
+        }
+    }
+    if (::pipe2(wakeFds, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        std::runtime_error error = systemError("Cannot create pipe for", path);
+        if (listenFd >= 0)
+            ::close(listenFd);
+        for (auto &replica : replicas)
+            ::close(replica->fd);
+        throw error;
+    }
+
+    wal->setShipper([this](const std::string &frames) { ship(frames); });
+    io = std::thread([this] { run(); });
+}
+
+LogShipper::~LogShipper()
+{
+    wal->setShipper(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake();
+    io.join();
+    for (auto &replica : replicas)
+        ::close(replica->fd);
+    if (listenFd >= 0)
+    {
+        ::close(listenFd);
+        ::unlink(path.c_str());
+    }
+    ::close(wakeFds[0]);
+    ::close(wakeFds[1]);
+}
+
+void LogShipper::wake()
+{
+    char byte = 1;
+    ssize_t ignored = ::write(wakeFds[1], &byte, 1); // full pipe : it is awake already
+    (void)ignored;
+}
+
+// caller holds mutex
+void LogShipper::queue(Replica &replica, ShipKind kind, const std::string &payload, uint64_t position)
+{
+    std::string &to = replica.syncing ? replica.held : replica.out;
+    to += shipHeader(kind, (uint32_t)payload.size(), shipClockNs(), position);
+    to += payload;
+    if (replica.socket && replica.out.size() + replica.held.size() > options.maxBufferBytes)
+    {
+        replica.dropped = true;
+        replica.out.clear();
+        replica.held.clear();
+    }
+}
+
+void LogShipper::ship(const std::string &frames)
+{
+    bool wakeIo;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.position += frames.size();
+        stats.batches++;
+        for (auto &replica : replicas)
+            if (!replica->dropped)
+                queue(*replica, ShipKind::Records, frames, stats.position);
+        wakeIo = !woken && !replicas.empty(); // one wake up per round of the io thread
+        woken = woken || wakeIo;
+    }
+    if (wakeIo)
+        wake();
+}
+
+// every row as it is now , then what the log shipped since the replica was registered
+void LogShipper::sendSnapshot(Replica &replica)
+{
+    uint64_t from;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        from = stats.position;
+    }
+    std::string messages = shipHeader(ShipKind::SnapshotBegin, 0, shipClockNs(), from);
+    std::string chunk;
+    auto flush = [&]
+    {
+        messages += shipHeader(ShipKind::Records, (uint32_t)chunk.size(), shipClockNs(), from);
+        messages += chunk;
+        chunk.clear();
+    };
+    auto put = [&](WalTable table, const auto &record)
+    {
+        ByteWriter out;
+        record.encode(out);
+        chunk += WriteAheadLog::frame(table, WalOp::Put, out.take());
+        if (chunk.size() >= CHUNK)
+            flush();
+    };
+    trains->snapshot().forEach([&](const Train &train) { put(WalTable::Trains, train); });
+    for (const Passenger &passenger : passengers->getAllPassengers())
+        put(WalTable::Passengers, passenger);
+    tickets->snapshot().forEach([&](const Ticket &ticket) { put(WalTable::Tickets, ticket); });
+    if (!chunk.empty())
+        flush();
+    messages += shipHeader(ShipKind::SnapshotEnd, 0, shipClockNs(), from);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    replica.out = std::move(messages) + replica.held;
+    replica.held.clear();
+    replica.syncing = false;
+    stats.snapshots++;
+}
+
+// false : the replica is gone
+bool LogShipper::send(Replica &replica)
+{
+    long long bytes = 0;
+    bool alive = true;
+    while (replica.sent < replica.writing.size())
+    {
+        const char *data = replica.writing.data() + replica.sent;
+        size_t left = replica.writing.size() - replica.sent;
+        ssize_t n = replica.socket ? ::send(replica.fd, data, left, MSG_NOSIGNAL) : ::write(replica.fd, data, left);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n <= 0)
+        {
+            alive = false;
+            break;
+        }
+        replica.sent += (size_t)n;
+        bytes += n;
+    }
+    if (replica.sent == replica.writing.size())
+    {
+        replica.writing.clear();
+        replica.sent = 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.bytes += bytes;
+    return alive;
+}
+
+void LogShipper::run()
+{
+    const auto heartbeat = std::chrono::milliseconds(options.heartbeatMs);
+    auto nextBeat = std::chrono::steady_clock::now() + heartbeat;
+    std::vector<Replica *> current;
+    std::vector<pollfd> fds;
+    bool last = false;
+    while (true)
+    {
+        std::vector<Replica *> syncing;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = stopping;
+            woken = false;
+            current.clear();
+            for (auto &replica : replicas)
+            {
+                current.push_back(replica.get());
+                if (replica->syncing && !replica->dropped)
+                    syncing.push_back(replica.get());
+            }
+            if (!last && std::chrono::steady_clock::now() >= nextBeat)
+            {
+                for (Replica *replica : current)
+                    if (!replica->syncing && !replica->dropped && replica->out.empty() && replica->writing.empty())
+                        queue(*replica, ShipKind::Heartbeat, "", stats.position);
+                nextBeat = std::chrono::steady_clock::now() + heartbeat;
+            }
+        }
+        if (!last)
+            for (Replica *replica : syncing)
+            {
+                try
+                {
+                    sendSnapshot(*replica);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    replica->dropped = true; // it reconnects and asks again
+                }
+            }
+
+        for (Replica *replica : current)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (replica->dropped)
+                    continue;
+                if (replica->writing.empty())
+                    replica->writing.swap(replica->out);
+            }
+            if (!replica->writing.empty() && !send(*replica))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                replica->dropped = true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < replicas.size();)
+            {
+                if (!replicas[i]->dropped)
+                {
+                    i++;
+                    continue;
+                }
+                ::close(replicas[i]->fd);
+                replicas.erase(replicas.begin() + (long)i);
+                stats.dropped++;
+            }
+            stats.replicas = (long long)replicas.size();
+            current.clear();
+            for (auto &replica : replicas)
+                current.push_back(replica.get());
+        }
+        if (last)
+            return; // what did not go out in this last round is lost , the replicas resync
+
+        fds.clear();
+        fds.push_back({wakeFds[0], POLLIN, 0});
+        if (listenFd >= 0)
+            fds.push_back({listenFd, POLLIN, 0});
+        size_t first = fds.size();
+        for (Replica *replica : current)
+            fds.push_back({replica->fd, (short)((replica->socket ? POLLIN : 0) | (replica->writing.empty() ? 0 : POLLOUT)), 0});
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextBeat - std::chrono::steady_clock::now());
+        ::poll(fds.data(), fds.size(), (int)std::max<long long>(0, wait.count()));
+
+        char drain[64];
+        while (::read(wakeFds[0], drain, sizeof(drain)) > 0)
+        {
+        }
+        if (listenFd >= 0 && (fds[1].revents & POLLIN))
+            while (true)
+            {
+                int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                    break;
+                auto replica = std::make_unique<Replica>();
+                replica->fd = fd;
+                std::lock_guard<std::mutex> lock(mutex);
+                replicas.push_back(std::move(replica));
+                stats.connects++;
+            }
+        // a replica never writes , readable means it hung up
+        for (size_t i = first; i < fds.size(); i++)
+        {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            char byte;
+            ssize_t n = ::recv(fds[i].fd, &byte, 1, MSG_DONTWAIT);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current[i - first]->dropped = true;
+            }
+        }
+    }
+}
+
+uint64_t LogShipper::position() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats.position;
+}
+
+const std::string &LogShipper::getPath() const
+{
+    return path;
+}
+
+ShippingStats LogShipper::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
@@ -0,0 +1,54 @@
+#include "Repo/ReadOnlyPassengerRepository.h"
+#include <stdexcept>
+
+static std::logic_error readOnly()
+{
+    return std::logic_error("This is a read-only replica , change passengers on the primary");
+}
+
+ReadOnlyPassengerRepository::ReadOnlyPassengerRepository(std::unique_ptr<IPassengerRepository> inner)
+    : inner(std::move(inner))
+{
+    if (this->inner == nullptr)
+        throw std::invalid_argument("Read-only repository needs a repository");
+}
+
+std::optional<Passenger> ReadOnlyPassengerRepository::getPassenger(const int &passengerId)
+{
+    return inner->getPassenger(passengerId);
+}
+
+bool ReadOnlyPassengerRepository::deletePassenger(const int &)
+{
+    throw readOnly();
+}
+
+void ReadOnlyPassengerRepository::save(Passenger &)
+{
+    throw readOnly();
+}
+
+void ReadOnlyPassengerRepository::saveAll(vector<Passenger> &)
+{
+    throw readOnly();
+}
+
+bool ReadOnlyPassengerRepository::compareAndSave(Passenger &)
+{
+    throw readOnly();
+}
+
+vector<Passenger> ReadOnlyPassengerRepository::getAllPassengers()
+{
+    return inner->getAllPassengers();
+}
+
+std::optional<Passenger> ReadOnlyPassengerRepository::findPassengerByName(const std::string &name)
+{
+    return inner->findPassengerByName(name);
+}
+
+void ReadOnlyPassengerRepository::clear()
+{
+    throw readOnly();
+}
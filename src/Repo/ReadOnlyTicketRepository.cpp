@@ -0,0 +1,73 @@
+#include "Repo/ReadOnlyTicketRepository.h"
+#include <stdexcept>
+
+static std::logic_error readOnly()
+{
+    return std::logic_error("This is a read-only replica , book and cancel on the primary");
+}
+
+ReadOnlyTicketRepository::ReadOnlyTicketRepository(std::unique_ptr<ITicketRepository> inner) : inner(std::move(inner))
+{
+    if (this->inner == nullptr)
+        throw std::invalid_argument("Read-only repository needs a repository");
+}
+
+std::optional<Ticket> ReadOnlyTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    return inner->getTicketByTrainAndPassenger(trainId, passengerId);
+}
+
+std::optional<Ticket> ReadOnlyTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    return inner->getTicketByTrainAndPassenger(trainId, passengerId, travelDate);
+}
+
+vector<Ticket> ReadOnlyTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    return inner->getTicketsByPassenger(passengerId);
+}
+
+bool ReadOnlyTicketRepository::deleteTicket(int)
+{
+    throw readOnly();
+}
+
+void ReadOnlyTicketRepository::save(Ticket &)
+{
+    throw readOnly();
+}
+
+bool ReadOnlyTicketRepository::compareAndSave(Ticket &)
+{
+    throw readOnly();
+}
+
+void ReadOnlyTicketRepository::saveAll(vector<Ticket> &)
+{
+    throw readOnly();
+}
+
+vector<Ticket> ReadOnlyTicketRepository::getAllTickets()
+{
+    return inner->getAllTickets();
+}
+
+vector<Ticket> ReadOnlyTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return inner->getTicketsPage(afterId, limit);
+}
+
+std::optional<Ticket> ReadOnlyTicketRepository::getTicketById(int ticketId)
+{
+    return inner->getTicketById(ticketId);
+}
+
+Snapshot<Ticket> ReadOnlyTicketRepository::snapshot()
+{
+    return inner->snapshot();
+}
+
+void ReadOnlyTicketRepository::clear()
+{
+    throw readOnly();
+}
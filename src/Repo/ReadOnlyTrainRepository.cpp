@@ -0,0 +1,58 @@
+#include "Repo/ReadOnlyTrainRepository.h"
+#include <stdexcept>
+
+static std::logic_error readOnly()
+{
+    return std::logic_error("This is a read-only replica , change trains on the primary");
+}
+
+ReadOnlyTrainRepository::ReadOnlyTrainRepository(std::unique_ptr<ITrainRepository> inner) : inner(std::move(inner))
+{
+    if (this->inner == nullptr)
+        throw std::invalid_argument("Read-only repository needs a repository");
+}
+
+vector<Train> ReadOnlyTrainRepository::getAllTrains() const
+{
+    return inner->getAllTrains();
+}
+
+vector<Train> ReadOnlyTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    return inner->getTrainsPage(afterId, limit);
+}
+
+bool ReadOnlyTrainRepository::deleteTrain(int)
+{
+    throw readOnly();
+}
+
+void ReadOnlyTrainRepository::save(Train &)
+{
+    throw readOnly();
+}
+
+void ReadOnlyTrainRepository::saveAll(vector<Train> &)
+{
+    throw readOnly();
+}
+
+bool ReadOnlyTrainRepository::compareAndSave(Train &)
+{
+    throw readOnly();
+}
+
+std::optional<Train> ReadOnlyTrainRepository::getTrainById(const int &trainId) const
+{
+    return inner->getTrainById(trainId);
+}
+
+Snapshot<Train> ReadOnlyTrainRepository::snapshot() const
+{
+    return inner->snapshot();
+}
+
+void ReadOnlyTrainRepository::clear()
+{
+    throw readOnly();
+}
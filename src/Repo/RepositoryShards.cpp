@@ -0,0 +1,72 @@
+#include "Repo/RepositoryShards.h"
+#include <stdexcept>
+
+// raise counter past value
+static void bumpPast(std::atomic<int> &counter, int value)
+{
+    int current = counter.load();
+    while (value >= current && !counter.compare_exchange_weak(current, value + 1))
+    {
+    }
+}
+
+RepositoryShards::RepositoryShards(int count)
+{
+    if (count <= 0)
+        throw std::invalid_argument("Shard count must be greater than 0");
+    for (int i = 0; i < count; i++)
+        shards.push_back(std::make_unique<Shard>());
+}
+
+int RepositoryShards::count() const
+{
+    return (int)shards.size();
+}
+
+RepositoryShards::Shard &RepositoryShards::shard(int index)
+{
+    return *shards[index];
+}
+
+int RepositoryShards::shardOf(int trainId) const
+{
+    return (int)((unsigned)trainId % shards.size());
+}
+
+int RepositoryShards::homeOfTicket(int ticketId) const
+{
+    return (int)((unsigned)(ticketId - 1) % shards.size());
+}
+
+int RepositoryShards::nextTrainIdFor()
+{
+    return nextTrainId.fetch_add(1);
+}
+
+void RepositoryShards::reserveTrainId(int trainId)
+{
+    bumpPast(nextTrainId, trainId);
+}
+
+int RepositoryShards::nextTicketIdFor(int shardIndex)
+{
+    return shards[shardIndex]->nextTicketSeq.fetch_add(1) * count() + shardIndex + 1;
+}
+
+void RepositoryShards::reserveTicketId(int ticketId)
+{
+    if (ticketId <= 0)
+        return;
+    bumpPast(shards[homeOfTicket(ticketId)]->nextTicketSeq, (ticketId - 1) / count());
+}
+
+void RepositoryShards::resetTrainIds()
+{
+    nextTrainId = 1;
+}
+
+void RepositoryShards::resetTicketIds()
+{
+    for (auto &s : shards)
+        s->nextTicketSeq = 0;
+}
@@ -0,0 +1,141 @@
+#include "Repo/ShardedTicketRepository.h"
+#include <stdexcept>
+#include <iostream>
+
+static int ticketIdOf(const Ticket &ticket)
+{
+    return ticket.getId();
+}
+
+ShardedTicketRepository::ShardedTicketRepository(RepositoryShards *shards) : shards(shards)
+{
+    if (shards == nullptr)
+        throw std::invalid_argument("Sharded repository needs its shards");
+}
+
+InMemoryTicketRepository &ShardedTicketRepository::shardFor(int trainId)
+{
+    return shards->shard(shards->shardOf(trainId)).tickets;
+}
+
+int ShardedTicketRepository::locate(int ticketId)
+{
+    if (ticketId <= 0)
+        return -1;
+    int home = shards->homeOfTicket(ticketId);
+    if (shards->shard(home).tickets.getTicketById(ticketId).has_value())
+        return home;
+    for (int i = 0; i < shards->count(); i++)
+        if (i != home && shards->shard(i).tickets.getTicketById(ticketId).has_value())
+            return i;
+    return -1;
+}
+
+int ShardedTicketRepository::prepare(Ticket &ticket)
+{
+    int target = shards->shardOf(ticket.getTrainId());
+    if (ticket.getId() == 0)
+    {
+        ticket.setId(shards->nextTicketIdFor(target));
+        return target;
+    }
+    shards->reserveTicketId(ticket.getId());
+    int current = locate(ticket.getId());
+    if (current != -1 && current != target)
+        throw std::invalid_argument("Ticket cannot move to another train.\n");
+    return target;
+}
+
+std::optional<Ticket> ShardedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    return shardFor(trainId).getTicketByTrainAndPassenger(trainId, passengerId);
+}
+
+std::optional<Ticket> ShardedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    return shardFor(trainId).getTicketByTrainAndPassenger(trainId, passengerId, travelDate);
+}
+
+vector<Ticket> ShardedTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    std::vector<vector<Ticket>> parts;
+    for (int i = 0; i < shards->count(); i++)
+        parts.push_back(shards->shard(i).tickets.getTicketsByPassenger(passengerId));
+    return RepositoryShards::mergeById(parts, ticketIdOf);
+}
+
+bool ShardedTicketRepository::deleteTicket(int ticketId)
+{
+    int at = locate(ticketId);
+    return at != -1 && shards->shard(at).tickets.deleteTicket(ticketId);
+}
+
+void ShardedTicketRepository::save(Ticket &ticket)
+{
+    int target = prepare(ticket);
+    shards->shard(target).tickets.save(ticket);
+}
+
+bool ShardedTicketRepository::compareAndSave(Ticket &ticket)
+{
+    int target = prepare(ticket);
+    return shards->shard(target).tickets.compareAndSave(ticket);
+}
+
+void ShardedTicketRepository::saveAll(vector<Ticket> &batch)
+{
+    if (batch.empty())
+        return;
+    // a batch comes from one train (TicketService::bookBatch) : one shard , one write .
+    // mixed batches are split per shard
+    int first = shards->shardOf(batch[0].getTrainId());
+    bool oneShard = true;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        prepare(batch[i]);
+        oneShard = oneShard && shards->shardOf(batch[i].getTrainId()) == first;
+    }
+    if (oneShard)
+    {
+        shards->shard(first).tickets.saveAll(batch);
+        return;
+    }
+    for (size_t i = 0; i < batch.size(); i++)
+        shardFor(batch[i].getTrainId()).save(batch[i]);
+}
+
+// listings walk one snapshot per shard , merged in id order
+vector<Ticket> ShardedTicketRepository::getAllTickets()
+{
+    return snapshot().toVector();
+}
+
+vector<Ticket> ShardedTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return snapshot().page(afterId, limit);
+}
+
+// taken shard by shard , a booking never writes to two shards
+Snapshot<Ticket> ShardedTicketRepository::snapshot()
+{
+    std::vector<Snapshot<Ticket>> parts;
+    for (int i = 0; i < shards->count(); i++)
+        parts.push_back(shards->shard(i).tickets.snapshot());
+    return Snapshot<Ticket>::combine(parts);
+}
+
+std::optional<Ticket> ShardedTicketRepository::getTicketById(int ticketId)
+{
+    int at = locate(ticketId);
+    if (at == -1)
+        return std::nullopt; // not found
+    return shards->shard(at).tickets.getTicketById(ticketId);
+}
+
+void ShardedTicketRepository::clear()
+{
+    for (int i = 0; i < shards->count(); i++)
+        shards->shard(i).tickets.discardAll();
+    shards->resetTicketIds();
+    std::cout << "All tickets destroyed\n";
+}
@@ -0,0 +1,95 @@
+#include "Repo/ShardedTrainRepository.h"
+#include <stdexcept>
+#include <iostream>
+
+ShardedTrainRepository::ShardedTrainRepository(RepositoryShards *shards) : shards(shards)
+{
+    if (shards == nullptr)
+        throw std::invalid_argument("Sharded repository needs its shards");
+}
+
+InMemoryTrainRepository &ShardedTrainRepository::shardFor(int trainId)
+{
+    return shards->shard(shards->shardOf(trainId)).trains;
+}
+
+void ShardedTrainRepository::assignId(Train &train)
+{
+    if (train.getTrainId() == 0)
+        train.setTrainId(shards->nextTrainIdFor());
+    else
+        shards->reserveTrainId(train.getTrainId());
+}
+
+// listings walk one snapshot per shard , merged in id order
+vector<Train> ShardedTrainRepository::getAllTrains() const
+{
+    return snapshot().toVector();
+}
+
+vector<Train> ShardedTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    return snapshot().page(afterId, limit);
+}
+
+// shards are taken one after another : no write spans two shards , so the
+// combined view is still a state the repository could have been in
+Snapshot<Train> ShardedTrainRepository::snapshot() const
+{
+    std::vector<Snapshot<Train>> parts;
+    for (int i = 0; i < shards->count(); i++)
+        parts.push_back(shards->shard(i).trains.snapshot());
+    return Snapshot<Train>::combine(parts);
+}
+
+bool ShardedTrainRepository::deleteTrain(int trainId)
+{
+    return shardFor(trainId).deleteTrain(trainId);
+}
+
+void ShardedTrainRepository::save(Train &train)
+{
+    assignId(train);
+    shardFor(train.getTrainId()).save(train);
+}
+
+// new trains spread over every shard : the batch is split , one write per shard
+void ShardedTrainRepository::saveAll(vector<Train> &trains)
+{
+    std::vector<vector<Train>> parts(shards->count());
+    std::vector<std::vector<size_t>> partAt(shards->count());
+    for (size_t i = 0; i < trains.size(); i++)
+    {
+        assignId(trains[i]);
+        int shard = shards->shardOf(trains[i].getTrainId());
+        parts[shard].push_back(trains[i]);
+        partAt[shard].push_back(i);
+    }
+    for (int shard = 0; shard < shards->count(); shard++)
+    {
+        if (parts[shard].size() == 0)
+            continue;
+        shards->shard(shard).trains.saveAll(parts[shard]);
+        for (size_t i = 0; i < parts[shard].size(); i++)
+            trains[partAt[shard][i]] = parts[shard][i];
+    }
+}
+
+bool ShardedTrainRepository::compareAndSave(Train &train)
+{
+    assignId(train);
+    return shardFor(train.getTrainId()).compareAndSave(train);
+}
+
+std::optional<Train> ShardedTrainRepository::getTrainById(const int &trainId) const
+{
+    return shards->shard(shards->shardOf(trainId)).trains.getTrainById(trainId);
+}
+
+void ShardedTrainRepository::clear()
+{
+    for (int i = 0; i < shards->count(); i++)
+        shards->shard(i).trains.discardAll();
+    shards->resetTrainIds();
+    std::cout << "All trains destroyed\n";
+}
@@ -0,0 +1,112 @@
+#include "Repo/SharedPassengerRepository.h"
+#include "utils/BinaryCodec.h"
+#include "utils/helpers.h"
+#include <iostream>
+#include <stdexcept>
+
+SharedPassengerRepository::SharedPassengerRepository(SharedSegment *segment) : segment(segment)
+{
+    if (segment == nullptr)
+        throw std::invalid_argument("Shared repository needs its segment");
+}
+
+static Passenger decodePassenger(const SharedSegment &segment, const SharedSegment::Slot &slot)
+{
+    std::string bytes = segment.readBlob(slot);
+    ByteReader in(bytes);
+    Passenger passenger = Passenger::decode(in);
+    passenger.setVersion(slot.version);
+    return passenger;
+}
+
+// holding the segment lock
+bool SharedPassengerRepository::storeLocked(Passenger &passenger, bool checkVersion)
+{
+    if (passenger.getId() == 0)
+        passenger.setId(segment->takeNextId(SharedTable::Passengers));
+    ByteWriter out;
+    passenger.encode(out);
+    long long version = segment->store(SharedTable::Passengers, passenger.getId(), out.data(),
+                                       checkVersion ? passenger.getVersion() : -1);
+    if (version == -1)
+        return false;
+    passenger.setVersion(version);
+    return true;
+}
+
+bool SharedPassengerRepository::write(Passenger &passenger, bool checkVersion)
+{
+    auto guard = segment->lock();
+    return storeLocked(passenger, checkVersion);
+}
+
+void SharedPassengerRepository::save(Passenger &passenger)
+{
+    write(passenger, false);
+}
+
+void SharedPassengerRepository::saveAll(vector<Passenger> &passengers)
+{
+    auto guard = segment->lock();
+    for (size_t i = 0; i < passengers.size(); i++)
+        storeLocked(passengers[i], false);
+}
+
+bool SharedPassengerRepository::compareAndSave(Passenger &passenger)
+{
+    return write(passenger, true);
+}
+
+std::optional<Passenger> SharedPassengerRepository::getPassenger(const int &passengerId)
+{
+    auto guard = segment->lock();
+    SharedSegment::Slot *slot = segment->slot(SharedTable::Passengers, passengerId);
+    if (slot == nullptr || !slot->used)
+        return std::nullopt; // not found
+    return decodePassenger(*segment, *slot);
+}
+
+vector<Passenger> SharedPassengerRepository::getAllPassengers()
+{
+    vector<Passenger> results;
+    auto guard = segment->lock();
+    for (int id = 1; id <= segment->highestId(SharedTable::Passengers); id++)
+    {
+        SharedSegment::Slot *slot = segment->slot(SharedTable::Passengers, id);
+        if (slot->used)
+            results.push_back(decodePassenger(*segment, *slot));
+    }
+    return results;
+}
+
+std::optional<Passenger> SharedPassengerRepository::findPassengerByName(const std::string &name)
+{
+    const std::string wanted = toLowerCase(name);
+    auto guard = segment->lock();
+    for (int id = 1; id <= segment->highestId(SharedTable::Passengers); id++)
+    {
+        SharedSegment::Slot *slot = segment->slot(SharedTable::Passengers, id);
+        if (!slot->used)
+            continue;
+        Passenger passenger = decodePassenger(*segment, *slot);
+        if (toLowerCase(passenger.getName()) == wanted)
+            return passenger;
+    }
+    return std::nullopt;
+}
+
+bool SharedPassengerRepository::deletePassenger(const int &passengerId)
+{
+    auto guard = segment->lock();
+    return segment->erase(SharedTable::Passengers, passengerId);
+}
+
+// empties the table for every process
+void SharedPassengerRepository::clear()
+{
+    {
+        auto guard = segment->lock();
+        segment->resetTable(SharedTable::Passengers);
+    }
+    std::cout << "All passengers destroyed\n";
+}
@@ -0,0 +1,633 @@
+#include "Repo/SharedSegment.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr uint64_t SEGMENT_MAGIC = 0x524d535348415244ULL; // "RMSSHARD"
+static constexpr int MIN_BLOCK_CLASS = 5;                         // 32 byte blocks
+static constexpr int BLOCK_CLASSES = 48;
+
+struct SharedSegment::IndexEntry
+{
+    int32_t trainId; // 0 = empty entry
+    int32_t passengerId;
+    int32_t head;    // first ticket id of the chain , 0 once every ticket left
+};
+
+struct SharedSegment::Header
+{
+    uint64_t magic;
+    std::atomic<uint32_t> ready; // set by the creator once the layout is written
+    pthread_mutex_t mutex;
+    uint64_t size;
+
+    struct Table
+    {
+        uint64_t slots; // offset of Slot[capacity + 1] , slot 0 unused
+        int32_t capacity;
+        int32_t nextId;
+        int32_t highest;
+    } tables[3];
+
+    uint64_t index; // offset of IndexEntry[indexCapacity] , open addressing
+    uint32_t indexCapacity; // power of two
+    uint32_t indexUsed;
+    uint64_t passengerHeads; // offset of int32_t[passenger capacity + 1] , first ticket id per passenger
+
+    uint64_t heapStart, heapTop, heapEnd;
+    uint64_t freeLists[BLOCK_CLASSES]; // block offsets by size class , chained through the payload
+
+    // the slot being written : after is complete before active is set , so a holder dying
+    // with active set has its write finished by the next one to lock
+    struct Journal
+    {
+        std::atomic<uint32_t> active;
+        int32_t table;
+        int32_t id;
+        Slot after;
+    } journal;
+    std::atomic<uint64_t> recoveries;
+};
+
+static uint64_t alignUp(uint64_t value)
+{
+    return (value + 63) & ~uint64_t(63);
+}
+
+static void fail(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+SharedSegment::Guard::Guard(SharedSegment *segment) : segment(segment)
+{
+    pthread_mutex_t *mutex = &segment->header()->mutex;
+    int rc = pthread_mutex_lock(mutex);
+    if (rc == EOWNERDEAD)
+    {
+        // the holder died , maybe half way through a write : repair before anyone reads
+        bool repaired = false;
+        try
+        {
+            repaired = segment->recover();
+        }
+        catch (const std::exception &)
+        {
+        }
+        if (!repaired)
+        {
+            // unlocked without pthread_mutex_consistent , every later lock gets ENOTRECOVERABLE
+            pthread_mutex_unlock(mutex);
+            throw std::runtime_error("shared segment " + segment->name + " was left damaged by a dead process , it is poisoned");
+        }
+        pthread_mutex_consistent(mutex);
+    }
+    else if (rc == ENOTRECOVERABLE)
+        throw std::runtime_error("shared segment " + segment->name + " is poisoned , recreate it");
+    else if (rc != 0)
+        throw std::runtime_error("shared segment lock failed");
+}
+
+SharedSegment::Guard::~Guard()
+{
+    pthread_mutex_unlock(&segment->header()->mutex);
+}
+
+SharedSegment::SharedSegment(const std::string &name, const SharedSegmentOptions &options) : name(name)
+{
+    if (options.maxTrains <= 0 || options.maxTickets <= 0 || options.maxPassengers <= 0 || options.heapBytes == 0)
+        throw std::invalid_argument("Shared segment sizes must be greater than zero");
+
+    // the layout , computed the same way by every process so the creator's size matches
+    uint64_t size = alignUp(sizeof(Header));
+    size += alignUp((uint64_t)(options.maxTrains + 1) * sizeof(Slot));
+    size += alignUp((uint64_t)(options.maxTickets + 1) * sizeof(Slot));
+    size += alignUp((uint64_t)(options.maxPassengers + 1) * sizeof(Slot));
+    size += alignUp(std::bit_ceil((uint64_t)(options.maxTickets + 1) * 2) * sizeof(IndexEntry));
+    size += alignUp((uint64_t)(options.maxPassengers + 1) * sizeof(int32_t));
+    size += alignUp(options.heapBytes);
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+    {
+        creator = true;
+        if (ftruncate(fd, (off_t)size) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            fail("cannot size shared memory " + name);
+        }
+    }
+    else
+    {
+        if (errno != EEXIST)
+            fail("cannot open shared memory " + name);
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+            fail("cannot open shared memory " + name);
+        // the creator may not have sized it yet
+        struct stat info{};
+        for (int waited = 0; fstat(fd, &info) == 0 && info.st_size == 0; waited++)
+        {
+            if (waited == 5000)
+            {
+                close(fd);
+                throw std::runtime_error("shared memory " + name + " was never initialized");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        size = (uint64_t)info.st_size; // the creator's sizes win
+    }
+
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        base = nullptr;
+        fail("cannot map shared memory " + name);
+    }
+    mappedSize = size;
+
+    if (creator)
+    {
+        initialize(options);
+        header()->ready.store(1, std::memory_order_release);
+        return;
+    }
+    for (int waited = 0; header()->ready.load(std::memory_order_acquire) == 0; waited++)
+    {
+        if (waited == 5000)
+        {
+            munmap(base, mappedSize);
+            throw std::runtime_error("shared memory " + name + " was never initialized");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header()->magic != SEGMENT_MAGIC || header()->size != mappedSize)
+    {
+        munmap(base, mappedSize);
+        throw std::runtime_error("shared memory " + name + " is not an RMS segment");
+    }
+}
+
+SharedSegment::~SharedSegment()
+{
+    if (base != nullptr)
+        munmap(base, mappedSize);
+}
+
+void SharedSegment::remove(const std::string &name)
+{
+    shm_unlink(name.c_str());
+}
+
+// the object is fresh from ftruncate , so every byte is already zero
+void SharedSegment::initialize(const SharedSegmentOptions &options)
+{
+    Header *h = header();
+    h->magic = SEGMENT_MAGIC;
+    h->size = mappedSize;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&h->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    uint64_t offset = alignUp(sizeof(Header));
+    int capacities[3] = {options.maxTrains, options.maxTickets, options.maxPassengers};
+    for (int t = 0; t < 3; t++)
+    {
+        h->tables[t].slots = offset;
+        h->tables[t].capacity = capacities[t];
+        h->tables[t].nextId = 1;
+        h->tables[t].highest = 0;
+        offset += alignUp((uint64_t)(capacities[t] + 1) * sizeof(Slot));
+    }
+    h->index = offset;
+    h->indexCapacity = (uint32_t)std::bit_ceil((uint64_t)(options.maxTickets + 1) * 2);
+    offset += alignUp((uint64_t)h->indexCapacity * sizeof(IndexEntry));
+    h->passengerHeads = offset;
+    offset += alignUp((uint64_t)(options.maxPassengers + 1) * sizeof(int32_t));
+    h->heapStart = h->heapTop = offset;
+    h->heapEnd = mappedSize;
+}
+
+SharedSegment::Header *SharedSegment::header() const
+{
+    return static_cast<Header *>(base);
+}
+
+const std::string &SharedSegment::getName() const
+{
+    return name;
+}
+
+bool SharedSegment::isCreator() const
+{
+    return creator;
+}
+
+size_t SharedSegment::getHeapUsed() const
+{
+    return header()->heapTop - header()->heapStart;
+}
+
+long long SharedSegment::getRecoveries() const
+{
+    return (long long)header()->recoveries.load();
+}
+
+SharedSegment::Guard SharedSegment::lock()
+{
+    return Guard(this);
+}
+
+int SharedSegment::capacity(SharedTable table) const
+{
+    return header()->tables[(int)table].capacity;
+}
+
+SharedSegment::Slot *SharedSegment::slot(SharedTable table, int id)
+{
+    const Header::Table &t = header()->tables[(int)table];
+    if (id <= 0 || id > t.capacity)
+        return nullptr;
+    return at<Slot>(t.slots) + id;
+}
+
+int SharedSegment::highestId(SharedTable table) const
+{
+    return header()->tables[(int)table].highest;
+}
+
+int SharedSegment::takeNextId(SharedTable table)
+{
+    Header::Table &t = header()->tables[(int)table];
+    if (t.nextId > t.capacity)
+        throw std::length_error("Shared segment " + name + " has no free ids left");
+    int id = t.nextId++;
+    if (id > t.highest)
+        t.highest = id;
+    return id;
+}
+
+void SharedSegment::reserveId(SharedTable table, int id)
+{
+    Header::Table &t = header()->tables[(int)table];
+    if (id <= 0 || id > t.capacity)
+        throw std::length_error("Id " + std::to_string(id) + " is outside shared segment " + name);
+    if (id >= t.nextId)
+        t.nextId = id + 1;
+    if (id > t.highest)
+        t.highest = id;
+}
+
+void SharedSegment::resetTable(SharedTable table)
+{
+    Header::Table &t = header()->tables[(int)table];
+    if (table == SharedTable::Tickets)
+    {
+        // the chains go with the index , no need to unlink ticket by ticket
+        std::memset(at<IndexEntry>(header()->index), 0, (size_t)header()->indexCapacity * sizeof(IndexEntry));
+        header()->indexUsed = 0;
+        std::memset(at<int32_t>(header()->passengerHeads), 0, (size_t)(capacity(SharedTable::Passengers) + 1) * sizeof(int32_t));
+    }
+    for (int id = 1; id <= t.highest; id++)
+    {
+        Slot *s = slot(table, id);
+        if (!s->used)
+            continue;
+        uint64_t blob = s->blob;
+        writeSlot(table, id, Slot{});
+        if (blob != 0)
+            release(blob);
+    }
+    t.nextId = 1;
+    t.highest = 0;
+}
+
+// power of two blocks with an 8 byte class header , freed blocks go on a list per class
+uint64_t SharedSegment::allocate(size_t bytes)
+{
+    Header *h = header();
+    int blockClass = std::max(MIN_BLOCK_CLASS, (int)std::bit_width(bytes + 8 - 1));
+    if (blockClass >= BLOCK_CLASSES)
+        throw std::length_error("Record too large for shared segment " + name);
+    uint64_t block = h->freeLists[blockClass];
+    if (block != 0)
+        h->freeLists[blockClass] = *at<uint64_t>(block + 8);
+    else
+    {
+        uint64_t blockSize = uint64_t(1) << blockClass;
+        if (h->heapTop + blockSize > h->heapEnd)
+            throw std::length_error("Shared segment " + name + " is out of record space");
+        block = h->heapTop;
+        // class first : recover() walks the heap up to heapTop by these headers
+        *at<uint64_t>(block) = (uint64_t)blockClass;
+        std::atomic_signal_fence(std::memory_order_release);
+        h->heapTop += blockSize;
+    }
+    *at<uint64_t>(block) = (uint64_t)blockClass;
+    return block + 8;
+}
+
+void SharedSegment::release(uint64_t offset)
+{
+    uint64_t block = offset - 8;
+    uint64_t blockClass = *at<uint64_t>(block);
+    *at<uint64_t>(offset) = header()->freeLists[blockClass];
+    header()->freeLists[blockClass] = block;
+}
+
+// one slot in one go as far as another process can tell : a holder dying half way leaves the
+// journal behind and recover() writes the slot again from it
+void SharedSegment::writeSlot(SharedTable table, int id, const Slot &after)
+{
+    Header::Journal &journal = header()->journal;
+    journal.table = (int32_t)table;
+    journal.id = id;
+    journal.after = after;
+    journal.active.store(1, std::memory_order_release);
+    *slot(table, id) = after;
+    journal.active.store(0, std::memory_order_release);
+}
+
+// the slot write is the only step that must not be seen half done : the new bytes sit in a block
+// nothing points at until then , and the free lists and indexes are rebuilt by recover()
+long long SharedSegment::store(SharedTable table, int id, const std::string &bytes, long long expectedVersion,
+                               const TicketKeys &keys)
+{
+    Slot *s = slot(table, id);
+    if (s == nullptr)
+        throw std::length_error("Id " + std::to_string(id) + " is outside shared segment " + name);
+    long long storedVersion = s->used ? s->version : 0;
+    if (expectedVersion != -1 && expectedVersion != storedVersion)
+        return -1;
+    uint64_t blob = allocate(bytes.size()); // first , a full heap leaves the old record in place
+    std::memcpy(at<char>(blob), bytes.data(), bytes.size());
+    reserveId(table, id);
+
+    bool relink = false;
+    if (table == SharedTable::Tickets)
+    {
+        relink = !s->used || s->trainId != keys.trainId || s->passengerId != keys.passengerId;
+        if (relink && s->used)
+            unlinkTicket(id); // was indexed under another (train , passenger)
+    }
+    Slot after = *s;
+    uint64_t old = s->blob;
+    after.blob = blob;
+    after.blobSize = (uint32_t)bytes.size();
+    after.used = 1;
+    after.version = storedVersion + 1;
+    if (table == SharedTable::Tickets)
+    {
+        after.trainId = keys.trainId;
+        after.passengerId = keys.passengerId;
+        after.travelDate = keys.travelDate;
+    }
+    writeSlot(table, id, after);
+    if (relink)
+        linkTicket(id);
+    if (old != 0)
+        release(old);
+    return after.version;
+}
+
+bool SharedSegment::erase(SharedTable table, int id)
+{
+    Slot *s = slot(table, id);
+    if (s == nullptr || !s->used)
+        return false;
+    if (table == SharedTable::Tickets)
+        unlinkTicket(id);
+    uint64_t blob = s->blob;
+    writeSlot(table, id, Slot{});
+    if (blob != 0)
+        release(blob);
+    return true;
+}
+
+// the holder died with the lock . the slots are the truth : the journaled write is finished ,
+// every slot must point at a whole block of the heap , and the rest is derived again from them
+bool SharedSegment::recover()
+{
+    Header *h = header();
+    if (h->magic != SEGMENT_MAGIC || h->heapStart > h->heapTop || h->heapTop > h->heapEnd)
+        return false;
+    for (auto &t : h->tables)
+        if (t.highest < 0 || t.highest > t.capacity || t.nextId < 1 || t.nextId > t.capacity + 1)
+            return false;
+
+    if (h->journal.active.load(std::memory_order_acquire))
+    {
+        if (h->journal.table < 0 || h->journal.table > 2)
+            return false;
+        SharedTable table = (SharedTable)h->journal.table;
+        Slot *s = slot(table, h->journal.id);
+        if (s == nullptr)
+            return false;
+        reserveId(table, h->journal.id);
+        *s = h->journal.after;
+        h->journal.active.store(0, std::memory_order_release);
+    }
+
+    // blocks the records point at , each a whole block inside the heap and no two records sharing one
+    std::vector<uint64_t> referenced;
+    for (int t = 0; t < 3; t++)
+        for (int id = 1; id <= h->tables[t].highest; id++)
+        {
+            const Slot &s = *slot((SharedTable)t, id);
+            if (!s.used)
+                continue;
+            if (s.blob < h->heapStart + 8 || s.blob >= h->heapTop)
+                return false;
+            uint64_t blockClass = *at<uint64_t>(s.blob - 8);
+            if (blockClass < MIN_BLOCK_CLASS || blockClass >= BLOCK_CLASSES ||
+                s.blob - 8 + (uint64_t(1) << blockClass) > h->heapTop || s.blobSize > (uint64_t(1) << blockClass) - 8)
+                return false;
+            referenced.push_back(s.blob - 8);
+        }
+    std::sort(referenced.begin(), referenced.end());
+    if (std::adjacent_find(referenced.begin(), referenced.end()) != referenced.end())
+        return false;
+
+    // the free lists : every block of the heap nobody points at
+    std::fill(std::begin(h->freeLists), std::end(h->freeLists), 0);
+    size_t next = 0;
+    for (uint64_t block = h->heapStart; block < h->heapTop;)
+    {
+        uint64_t blockClass = *at<uint64_t>(block);
+        if (blockClass < MIN_BLOCK_CLASS || blockClass >= BLOCK_CLASSES || block + (uint64_t(1) << blockClass) > h->heapTop)
+        {
+            if (next < referenced.size())
+                return false; // records live past a block that makes no sense
+            h->heapTop = block;
+            break;
+        }
+        if (next < referenced.size() && referenced[next] == block)
+            next++;
+        else
+        {
+            *at<uint64_t>(block + 8) = h->freeLists[blockClass];
+            h->freeLists[blockClass] = block;
+        }
+        block += uint64_t(1) << blockClass;
+    }
+    if (next != referenced.size())
+        return false; // a record points into the middle of a block
+
+    // the ticket indexes , linked again in id order
+    std::memset(at<IndexEntry>(h->index), 0, (size_t)h->indexCapacity * sizeof(IndexEntry));
+    h->indexUsed = 0;
+    std::memset(at<int32_t>(h->passengerHeads), 0, (size_t)(capacity(SharedTable::Passengers) + 1) * sizeof(int32_t));
+    Header::Table &tickets = h->tables[(int)SharedTable::Tickets];
+    for (int id = 1; id <= tickets.highest; id++)
+    {
+        Slot *s = slot(SharedTable::Tickets, id);
+        s->next = 0;
+        s->nextOfPassenger = 0;
+        if (s->used)
+            linkTicket(id);
+    }
+    h->recoveries++;
+    return true;
+}
+
+std::string SharedSegment::readBlob(const Slot &slot) const
+{
+    return std::string(at<char>(slot.blob), slot.blobSize);
+}
+
+SharedSegment::IndexEntry *SharedSegment::findEntry(int trainId, int passengerId, bool insert)
+{
+    Header *h = header();
+    IndexEntry *entries = at<IndexEntry>(h->index);
+    uint64_t key = ((uint64_t)(uint32_t)trainId << 32) | (uint32_t)passengerId;
+    uint64_t mask = h->indexCapacity - 1;
+    for (uint64_t i = (key * 0x9E3779B97F4A7C15ULL) >> 20 & mask;; i = (i + 1) & mask)
+    {
+        IndexEntry &e = entries[i];
+        if (e.trainId == trainId && e.passengerId == passengerId)
+            return &e;
+        if (e.trainId != 0)
+            continue;
+        if (!insert)
+            return nullptr;
+        // keys are never removed (an empty chain stays) , keep probes short
+        if ((uint64_t)h->indexUsed * 4 >= (uint64_t)h->indexCapacity * 3)
+            throw std::length_error("Ticket index of shared segment " + name + " is full");
+        h->indexUsed++;
+        e.trainId = trainId;
+        e.passengerId = passengerId;
+        e.head = 0;
+        return &e;
+    }
+}
+
+int SharedSegment::firstTicketOf(int trainId, int passengerId)
+{
+    IndexEntry *e = findEntry(trainId, passengerId, false);
+    return e != nullptr ? e->head : 0;
+}
+
+int32_t *SharedSegment::passengerHead(int passengerId)
+{
+    if (passengerId <= 0 || passengerId > capacity(SharedTable::Passengers))
+        return nullptr;
+    return at<int32_t>(header()->passengerHeads) + passengerId;
+}
+
+int SharedSegment::firstTicketOfPassenger(int passengerId)
+{
+    int32_t *head = passengerHead(passengerId);
+    return head != nullptr ? *head : -1;
+}
+
+void SharedSegment::linkTicket(int ticketId)
+{
+    Slot *s = slot(SharedTable::Tickets, ticketId);
+    if (int32_t *head = passengerHead(s->passengerId))
+    {
+        if (*head == 0 || *head > ticketId)
+        {
+            s->nextOfPassenger = *head;
+            *head = ticketId;
+        }
+        else
+        {
+            Slot *prev = slot(SharedTable::Tickets, *head);
+            while (prev->nextOfPassenger != 0 && prev->nextOfPassenger < ticketId)
+                prev = slot(SharedTable::Tickets, prev->nextOfPassenger);
+            s->nextOfPassenger = prev->nextOfPassenger;
+            prev->nextOfPassenger = ticketId;
+        }
+    }
+
+    IndexEntry *e = findEntry(s->trainId, s->passengerId, true);
+    if (e->head == 0 || e->head > ticketId)
+    {
+        s->next = e->head;
+        e->head = ticketId;
+        return;
+    }
+    Slot *prev = slot(SharedTable::Tickets, e->head);
+    while (prev->next != 0 && prev->next < ticketId)
+        prev = slot(SharedTable::Tickets, prev->next);
+    s->next = prev->next;
+    prev->next = ticketId;
+}
+
+void SharedSegment::unlinkTicket(int ticketId)
+{
+    Slot *s = slot(SharedTable::Tickets, ticketId);
+    if (int32_t *head = passengerHead(s->passengerId))
+    {
+        if (*head == ticketId)
+            *head = s->nextOfPassenger;
+        else
+            for (int id = *head; id != 0;)
+            {
+                Slot *prev = slot(SharedTable::Tickets, id);
+                if (prev->nextOfPassenger == ticketId)
+                {
+                    prev->nextOfPassenger = s->nextOfPassenger;
+                    break;
+                }
+                id = prev->nextOfPassenger;
+            }
+        s->nextOfPassenger = 0;
+    }
+
+    IndexEntry *e = findEntry(s->trainId, s->passengerId, false);
+    if (e == nullptr)
+        return;
+    if (e->head == ticketId)
+        e->head = s->next;
+    else
+    {
+        for (int id = e->head; id != 0;)
+        {
+            Slot *prev = slot(SharedTable::Tickets, id);
+            if (prev->next == ticketId)
+            {
+                prev->next = s->next;
+                break;
+            }
+            id = prev->next;
+        }
+    }
+    s->next = 0;
+}
@@ -0,0 +1,156 @@
+#include "Repo/SharedTicketRepository.h"
+#include "utils/BinaryCodec.h"
+#include <iostream>
+#include <stdexcept>
+
+SharedTicketRepository::SharedTicketRepository(SharedSegment *segment) : segment(segment)
+{
+    if (segment == nullptr)
+        throw std::invalid_argument("Shared repository needs its segment");
+}
+
+// tickets are small , they are encoded and decoded inside the lock
+std::optional<Ticket> SharedTicketRepository::readLocked(int ticketId)
+{
+    SharedSegment::Slot *slot = segment->slot(SharedTable::Tickets, ticketId);
+    if (slot == nullptr || !slot->used)
+        return std::nullopt;
+    std::string bytes = segment->readBlob(*slot);
+    ByteReader in(bytes);
+    Ticket ticket = Ticket::decode(in);
+    ticket.setVersion(slot->version);
+    return ticket;
+}
+
+void SharedTicketRepository::assignId(Ticket &ticket)
+{
+    if (ticket.getId() == 0)
+        ticket.setId(segment->takeNextId(SharedTable::Tickets));
+}
+
+bool SharedTicketRepository::storeLocked(Ticket &ticket, bool checkVersion)
+{
+    assignId(ticket);
+    if (segment->slot(SharedTable::Tickets, ticket.getId()) == nullptr)
+        throw std::length_error("Ticket id " + std::to_string(ticket.getId()) + " is outside the shared segment");
+
+    ByteWriter out;
+    ticket.encode(out);
+    // the segment indexes the ticket under its keys in the same write
+    SharedSegment::TicketKeys keys{};
+    keys.trainId = ticket.getTrainId();
+    keys.passengerId = ticket.getPassenger().getId();
+    keys.travelDate = ticket.getTravelDate();
+    long long version = segment->store(SharedTable::Tickets, ticket.getId(), out.data(), checkVersion ? ticket.getVersion() : -1, keys);
+    if (version == -1)
+        return false; // someone saved since this copy was read
+    ticket.setVersion(version);
+    return true;
+}
+
+std::optional<Ticket> SharedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    auto guard = segment->lock();
+    int first = segment->firstTicketOf(trainId, passengerId);
+    if (first == 0)
+        return std::nullopt; // not found
+    return readLocked(first);
+}
+
+std::optional<Ticket> SharedTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    auto guard = segment->lock();
+    for (int id = segment->firstTicketOf(trainId, passengerId); id != 0;)
+    {
+        SharedSegment::Slot *slot = segment->slot(SharedTable::Tickets, id);
+        if (slot->travelDate == travelDate)
+            return readLocked(id);
+        id = slot->next;
+    }
+    return std::nullopt; // not found
+}
+
+vector<Ticket> SharedTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    vector<Ticket> results;
+    auto guard = segment->lock();
+    int first = segment->firstTicketOfPassenger(passengerId);
+    if (first != -1)
+    {
+        for (int id = first; id != 0; id = segment->slot(SharedTable::Tickets, id)->nextOfPassenger)
+            results.push_back(*readLocked(id));
+        return results;
+    }
+    // an id outside the passenger table is not indexed
+    for (int id = 1; id <= segment->highestId(SharedTable::Tickets); id++)
+    {
+        SharedSegment::Slot *slot = segment->slot(SharedTable::Tickets, id);
+        if (slot->used && slot->passengerId == passengerId)
+            results.push_back(*readLocked(id));
+    }
+    return results;
+}
+
+bool SharedTicketRepository::deleteTicket(int ticketId)
+{
+    auto guard = segment->lock();
+    SharedSegment::Slot *slot = segment->slot(SharedTable::Tickets, ticketId);
+    if (slot == nullptr || !slot->used)
+        return false;
+    return segment->erase(SharedTable::Tickets, ticketId); // unindexes it too
+}
+
+void SharedTicketRepository::save(Ticket &ticket)
+{
+    auto guard = segment->lock();
+    storeLocked(ticket, false);
+}
+
+bool SharedTicketRepository::compareAndSave(Ticket &ticket)
+{
+    auto guard = segment->lock();
+    return storeLocked(ticket, true);
+}
+
+void SharedTicketRepository::saveAll(vector<Ticket> &tickets)
+{
+    auto guard = segment->lock();
+    for (size_t i = 0; i < tickets.size(); i++)
+        storeLocked(tickets[i], false);
+}
+
+vector<Ticket> SharedTicketRepository::getAllTickets()
+{
+    return snapshot().toVector();
+}
+
+vector<Ticket> SharedTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return snapshot().page(afterId, limit);
+}
+
+std::optional<Ticket> SharedTicketRepository::getTicketById(int ticketId)
+{
+    auto guard = segment->lock();
+    return readLocked(ticketId);
+}
+
+Snapshot<Ticket> SharedTicketRepository::snapshot()
+{
+    Snapshot<Ticket>::Map tickets;
+    auto guard = segment->lock();
+    for (int id = 1; id <= segment->highestId(SharedTable::Tickets); id++)
+        if (auto ticket = readLocked(id))
+            tickets.insert(id, std::make_shared<const Ticket>(*ticket));
+    return Snapshot<Ticket>(tickets);
+}
+
+// empties the table for every process
+void SharedTicketRepository::clear()
+{
+    {
+        auto guard = segment->lock();
+        segment->resetTable(SharedTable::Tickets);
+    }
+    std::cout << "All tickets destroyed\n";
+}
@@ -0,0 +1,136 @@
+#include "Repo/SharedTrainRepository.h"
+#include "utils/BinaryCodec.h"
+#include <iostream>
+#include <stdexcept>
+
+SharedTrainRepository::SharedTrainRepository(SharedSegment *segment) : segment(segment)
+{
+    if (segment == nullptr)
+        throw std::invalid_argument("Shared repository needs its segment");
+}
+
+static Train decodeTrain(const std::string &bytes, long long version)
+{
+    ByteReader in(bytes);
+    Train train = Train::decode(in);
+    train.setVersion(version); // the slot's version is the authority , the bytes carry the old one
+    return train;
+}
+
+// holding the segment lock , train has its id
+bool SharedTrainRepository::storeLocked(Train &train, const std::string &bytes, bool checkVersion)
+{
+    long long version = segment->store(SharedTable::Trains, train.getTrainId(), bytes,
+                                       checkVersion ? train.getVersion() : -1);
+    if (version == -1)
+        return false; // another process saved since this copy was read
+    train.setVersion(version);
+    return true;
+}
+
+bool SharedTrainRepository::write(Train &train, bool checkVersion)
+{
+    if (train.getTrainId() == 0)
+    {
+        auto guard = segment->lock();
+        train.setTrainId(segment->takeNextId(SharedTable::Trains));
+    }
+    ByteWriter out;
+    train.encode(out);
+
+    auto guard = segment->lock();
+    return storeLocked(train, out.data(), checkVersion);
+}
+
+void SharedTrainRepository::save(Train &train)
+{
+    write(train, false);
+}
+
+void SharedTrainRepository::saveAll(vector<Train> &trains)
+{
+    {
+        auto guard = segment->lock();
+        for (size_t i = 0; i < trains.size(); i++)
+            if (trains[i].getTrainId() == 0)
+                trains[i].setTrainId(segment->takeNextId(SharedTable::Trains));
+    }
+    std::vector<std::string> bytes;
+    for (size_t i = 0; i < trains.size(); i++)
+    {
+        ByteWriter out;
+        trains[i].encode(out);
+        bytes.push_back(out.take());
+    }
+
+    auto guard = segment->lock();
+    for (size_t i = 0; i < trains.size(); i++)
+        storeLocked(trains[i], bytes[i], false);
+}
+
+bool SharedTrainRepository::compareAndSave(Train &train)
+{
+    return write(train, true);
+}
+
+std::optional<Train> SharedTrainRepository::getTrainById(const int &trainId) const
+{
+    std::string bytes;
+    long long version;
+    {
+        auto guard = segment->lock();
+        SharedSegment::Slot *slot = segment->slot(SharedTable::Trains, trainId);
+        if (slot == nullptr || !slot->used)
+            return std::nullopt; // not found
+        bytes = segment->readBlob(*slot);
+        version = slot->version;
+    }
+    return decodeTrain(bytes, version);
+}
+
+vector<Train> SharedTrainRepository::getAllTrains() const
+{
+    return snapshot().toVector();
+}
+
+vector<Train> SharedTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    return snapshot().page(afterId, limit);
+}
+
+Snapshot<Train> SharedTrainRepository::snapshot() const
+{
+    std::vector<std::pair<long long, std::string>> records; // (version , bytes) by id
+    std::vector<int> ids;
+    {
+        auto guard = segment->lock();
+        for (int id = 1; id <= segment->highestId(SharedTable::Trains); id++)
+        {
+            SharedSegment::Slot *slot = segment->slot(SharedTable::Trains, id);
+            if (!slot->used)
+                continue;
+            ids.push_back(id);
+            records.emplace_back(slot->version, segment->readBlob(*slot));
+        }
+    }
+    Snapshot<Train>::Map trains;
+    for (size_t i = 0; i < ids.size(); i++)
+        trains.insert(ids[i], std::make_shared<const Train>(decodeTrain(records[i].second, records[i].first)));
+    return Snapshot<Train>(trains);
+}
+
+bool SharedTrainRepository::deleteTrain(int trainId)
+{
+    auto guard = segment->lock();
+    return segment->erase(SharedTable::Trains, trainId);
+}
+
+// empties the table for every process
+void SharedTrainRepository::clear()
+{
+    {
+        auto guard = segment->lock();
+        segment->resetTable(SharedTable::Trains);
+    }
+    std::cout << "All trains destroyed\n";
+}
@@ -0,0 +1,375 @@
+#include "Repo/SnapshotFile.h"
+#include "utils/BinaryCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'R', 'M', 'S', 'S', 'N', 'A', 'P', '\0'};
+
+struct SnapshotFileHeader
+{
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t headerSize;
+    uint64_t fileSize;
+    uint64_t ticketCount, ticketOffset;
+    uint64_t passengerCount, passengerOffset;
+    uint64_t trainCount, trainIndexOffset, trainBlobOffset, trainBlobBytes;
+    uint64_t stringOffset, stringBytes;
+};
+
+static uint64_t align8(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+static std::runtime_error systemError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno) + "\n");
+}
+
+namespace
+{
+    // sequential writes through one large buffer , tracks the offset for the section table
+    class FileOut
+    {
+    private:
+        int fd;
+        std::string path;
+        std::string buffer;
+        uint64_t offset = 0;
+
+    public:
+        FileOut(const std::string &path) : path(path)
+        {
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0)
+                throw systemError("Cannot create snapshot", path);
+            buffer.reserve(1 << 20);
+        }
+        ~FileOut()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        uint64_t position() const { return offset; }
+
+        void put(const void *data, size_t size)
+        {
+            buffer.append(static_cast<const char *>(data), size);
+            offset += size;
+            if (buffer.size() >= (1 << 20))
+                flush();
+        }
+
+        void pad()
+        {
+            static const char zeros[8] = {};
+            put(zeros, align8(offset) - offset);
+        }
+
+        void flush()
+        {
+            size_t done = 0;
+            while (done < buffer.size())
+            {
+                ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw systemError("Cannot write snapshot", path);
+                done += (size_t)n;
+            }
+            buffer.clear();
+        }
+
+        // header goes in last , over the zeros reserved for it at the start
+        void finish(const void *header, size_t size)
+        {
+            flush();
+            if (::pwrite(fd, header, size, 0) != (ssize_t)size || ::fsync(fd) != 0)
+                throw systemError("Cannot write snapshot", path);
+            ::close(fd);
+            fd = -1;
+        }
+    };
+}
+
+SnapshotFileStats writeSnapshotFile(const std::string &path, const Snapshot<Train> &trains,
+                                    const vector<Passenger> &passengers, const Snapshot<Ticket> &tickets)
+{
+    auto started = std::chrono::steady_clock::now();
+    // names first : every ticket of a passenger points at that passenger's copy
+    std::string strings;
+    std::unordered_map<int, std::pair<uint64_t, uint32_t>> nameOf;
+    std::vector<SnapshotPassengerRecord> passengerRecords;
+    passengerRecords.reserve(passengers.size());
+    for (size_t i = 0; i < passengers.size(); i++)
+    {
+        const Passenger &p = passengers[i];
+        std::string name = p.getName();
+        SnapshotPassengerRecord record{p.getId(), (uint32_t)name.size(), strings.size()};
+        nameOf[p.getId()] = {record.nameOffset, record.nameLength};
+        strings += name;
+        passengerRecords.push_back(record);
+    }
+
+    std::string tmp = path + ".tmp";
+    FileOut out(tmp);
+    SnapshotFileHeader header{};
+    out.put(&header, sizeof(header)); // zeros for now , finish writes the real one
+    out.pad();
+
+    header.ticketOffset = out.position();
+    tickets.forEach([&](const Ticket &t)
+    {
+        const Passenger &p = t.getPassenger();
+        auto known = nameOf.find(p.getId());
+        std::string name = p.getName();
+        if (known == nameOf.end() || known->second.second != name.size() ||
+            strings.compare(known->second.first, name.size(), name) != 0)
+        {
+            // passenger deleted or renamed since , the ticket keeps the name it was booked under
+            known = nameOf.insert_or_assign(p.getId(), std::make_pair((uint64_t)strings.size(), (uint32_t)name.size())).first;
+            strings += name;
+        }
+        if (known->second.first > UINT32_MAX)
+            throw std::runtime_error("Snapshot string section is over 4 GB.\n");
+        SnapshotTicketRecord record{t.getId(), t.getTrainId(), p.getId(), t.getSeat(), t.getTravelDate(),
+                                    (int32_t)t.getStatus(), (uint32_t)known->second.first, known->second.second};
+        out.put(&record, sizeof(record));
+        header.ticketCount++;
+    });
+
+    out.pad();
+    header.passengerOffset = out.position();
+    header.passengerCount = passengerRecords.size();
+    out.put(passengerRecords.data(), passengerRecords.size() * sizeof(SnapshotPassengerRecord));
+
+    // trains are encoded up front so the index , which comes first , knows every blob's offset
+    std::vector<std::string> blobs;
+    std::vector<SnapshotTrainRecord> trainRecords;
+    uint64_t blobOffset = 0;
+    trains.forEach([&](const Train &train)
+    {
+        ByteWriter writer;
+        train.encode(writer);
+        blobs.push_back(writer.take());
+        trainRecords.push_back({train.getTrainId(), (uint32_t)blobs.back().size(), blobOffset});
+        blobOffset += blobs.back().size();
+    });
+    out.pad();
+    header.trainIndexOffset = out.position();
+    header.trainCount = trainRecords.size();
+    out.put(trainRecords.data(), trainRecords.size() * sizeof(SnapshotTrainRecord));
+    out.pad();
+    header.trainBlobOffset = out.position();
+    header.trainBlobBytes = blobOffset;
+    for (const auto &blob : blobs)
+        out.put(blob.data(), blob.size());
+
+    out.pad();
+    header.stringOffset = out.position();
+    header.stringBytes = strings.size();
+    out.put(strings.data(), strings.size());
+    out.pad();
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.formatVersion = SNAPSHOT_FORMAT_VERSION;
+    header.headerSize = sizeof(header);
+    header.fileSize = out.position();
+    out.finish(&header, sizeof(header));
+
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw systemError("Cannot replace snapshot", path);
+
+    SnapshotFileStats stats;
+    stats.trains = (long long)header.trainCount;
+    stats.passengers = (long long)header.passengerCount;
+    stats.tickets = (long long)header.ticketCount;
+    stats.bytes = (long long)header.fileSize;
+    stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return stats;
+}
+
+std::future<SnapshotFileStats> writeSnapshotFileAsync(const std::string &path, Snapshot<Train> trains,
+                                                      vector<Passenger> passengers, Snapshot<Ticket> tickets)
+{
+    return std::async(std::launch::async, [path, trains = std::move(trains), passengers = std::move(passengers),
+                                           tickets = std::move(tickets)]
+                      { return writeSnapshotFile(path, trains, passengers, tickets); });
+}
+
+// ---------------- reading ----------------
+
+MappedSnapshot::MappedSnapshot(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw systemError("Cannot open snapshot", path);
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw systemError("Cannot stat snapshot", path);
+    }
+    mappedSize = (size_t)info.st_size;
+    if (mappedSize < sizeof(SnapshotFileHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("Not a snapshot: " + path + "\n");
+    }
+    base = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file
+    if (base == MAP_FAILED)
+    {
+        base = nullptr;
+        throw systemError("Cannot map snapshot", path);
+    }
+    ::madvise(base, mappedSize, MADV_SEQUENTIAL);
+
+    const SnapshotFileHeader *h = header();
+    auto fits = [&](uint64_t offset, uint64_t count, uint64_t size)
+    {
+        return offset % 8 == 0 && offset <= h->fileSize && count <= (h->fileSize - offset) / (size ? size : 1);
+    };
+    std::string problem;
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0)
+        problem = "Not a snapshot: ";
+    else if (h->formatVersion != SNAPSHOT_FORMAT_VERSION || h->headerSize != sizeof(SnapshotFileHeader))
+        problem = "Unsupported snapshot format version " + std::to_string(h->formatVersion) + ": ";
+    else if (h->fileSize != mappedSize || !fits(h->ticketOffset, h->ticketCount, sizeof(SnapshotTicketRecord)) ||
+             !fits(h->passengerOffset, h->passengerCount, sizeof(SnapshotPassengerRecord)) ||
+             !fits(h->trainIndexOffset, h->trainCount, sizeof(SnapshotTrainRecord)) ||
+             !fits(h->trainBlobOffset, h->trainBlobBytes, 1) || !fits(h->stringOffset, h->stringBytes, 1))
+        problem = "Truncated snapshot: ";
+    if (!problem.empty())
+    {
+        ::munmap(base, mappedSize);
+        base = nullptr;
+        throw std::runtime_error(problem + path + "\n");
+    }
+}
+
+MappedSnapshot::~MappedSnapshot()
+{
+    if (base != nullptr)
+        ::munmap(base, mappedSize);
+}
+
+const SnapshotFileHeader *MappedSnapshot::header() const
+{
+    return static_cast<const SnapshotFileHeader *>(base);
+}
+
+uint32_t MappedSnapshot::getFormatVersion() const
+{
+    return header()->formatVersion;
+}
+
+size_t MappedSnapshot::getSize() const
+{
+    return mappedSize;
+}
+
+size_t MappedSnapshot::trainCount() const
+{
+    return (size_t)header()->trainCount;
+}
+
+const SnapshotTrainRecord &MappedSnapshot::trainRecord(size_t index) const
+{
+    if (index >= trainCount())
+        throw std::out_of_range("Snapshot train index out of range");
+    return section<SnapshotTrainRecord>(header()->trainIndexOffset)[index];
+}
+
+Train MappedSnapshot::train(size_t index) const
+{
+    const SnapshotTrainRecord &record = trainRecord(index);
+    if (record.offset > header()->trainBlobBytes || record.size > header()->trainBlobBytes - record.offset)
+        throw std::runtime_error("Corrupt snapshot train record.\n");
+    ByteReader in(section<char>(header()->trainBlobOffset) + record.offset, record.size);
+    return Train::decode(in);
+}
+
+size_t MappedSnapshot::passengerCount() const
+{
+    return (size_t)header()->passengerCount;
+}
+
+const SnapshotPassengerRecord &MappedSnapshot::passengerRecord(size_t index) const
+{
+    if (index >= passengerCount())
+        throw std::out_of_range("Snapshot passenger index out of range");
+    return section<SnapshotPassengerRecord>(header()->passengerOffset)[index];
+}
+
+Passenger MappedSnapshot::passenger(size_t index) const
+{
+    const SnapshotPassengerRecord &record = passengerRecord(index);
+    return Passenger(record.id, std::string(string(record.nameOffset, record.nameLength)));
+}
+
+size_t MappedSnapshot::ticketCount() const
+{
+    return (size_t)header()->ticketCount;
+}
+
+const SnapshotTicketRecord &MappedSnapshot::ticketRecord(size_t index) const
+{
+    if (index >= ticketCount())
+        throw std::out_of_range("Snapshot ticket index out of range");
+    return section<SnapshotTicketRecord>(header()->ticketOffset)[index];
+}
+
+Ticket MappedSnapshot::ticket(size_t index) const
+{
+    const SnapshotTicketRecord &record = ticketRecord(index);
+    Ticket ticket(record.id, record.seat, record.trainId,
+                  Passenger(record.passengerId, std::string(string(record.nameOffset, record.nameLength))),
+                  record.travelDate);
+    ticket.setStatus(record.status == cancelled ? cancelled : booked);
+    return ticket;
+}
+
+std::string_view MappedSnapshot::string(uint64_t offset, uint32_t length) const
+{
+    if (offset > header()->stringBytes || length > header()->stringBytes - offset)
+        throw std::runtime_error("Corrupt snapshot string.\n");
+    return std::string_view(section<char>(header()->stringOffset) + offset, length);
+}
+
+void MappedSnapshot::restore(ITrainRepository &trains, IPassengerRepository &passengers, ITicketRepository &tickets) const
+{
+    for (size_t i = 0; i < trainCount(); i++)
+    {
+        Train t = train(i);
+        trains.save(t);
+    }
+    for (size_t i = 0; i < passengerCount(); i++)
+    {
+        Passenger p = passenger(i);
+        passengers.save(p);
+    }
+    // one repository lock per batch instead of one per ticket
+    const size_t batchSize = 65536;
+    for (size_t from = 0; from < ticketCount(); from += batchSize)
+    {
+        vector<Ticket> batch;
+        size_t to = std::min(ticketCount(), from + batchSize);
+        for (size_t i = from; i < to; i++)
+            batch.push_back(ticket(i));
+        tickets.saveAll(batch);
+    }
+}
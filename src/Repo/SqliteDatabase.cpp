@@ -0,0 +1,175 @@
+#include "Repo/SqliteDatabase.h"
+#include <sqlite3.h>
+#include <stdexcept>
+
+SqliteDatabase::SqliteDatabase(const std::string &path, const SqliteOptions &options) : path(path)
+{
+    if (path.empty())
+        throw std::invalid_argument("database path cannot be empty");
+    // the connection is serialized by our own lock , SQLite's would only be taken twice
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(path.c_str(), &db, flags, nullptr) != SQLITE_OK)
+    {
+        std::string message = db != nullptr ? sqlite3_errmsg(db) : "out of memory";
+        sqlite3_close(db);
+        db = nullptr;
+        throw std::runtime_error("Cannot open database " + path + ": " + message + "\n");
+    }
+    sqlite3_busy_timeout(db, options.busyTimeoutMs);
+    try
+    {
+        // readers do not block the writer and a commit is one append to the -wal file
+        execute("PRAGMA journal_mode=WAL");
+        execute(options.fullSync ? "PRAGMA synchronous=FULL" : "PRAGMA synchronous=NORMAL");
+        execute(("PRAGMA cache_size=-" + std::to_string(options.cacheMb * 1024)).c_str());
+        execute("PRAGMA temp_store=MEMORY");
+    }
+    catch (...)
+    {
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+SqliteDatabase::~SqliteDatabase()
+{
+    sqlite3_close_v2(db);
+}
+
+void SqliteDatabase::execute(const char *sql)
+{
+    char *error = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK)
+    {
+        std::string message = error != nullptr ? error : sqlite3_errmsg(db);
+        sqlite3_free(error);
+        throw std::runtime_error("SQLite error on " + path + ": " + message + "\n");
+    }
+}
+
+std::unique_lock<std::mutex> SqliteDatabase::lock()
+{
+    return std::unique_lock<std::mutex>(mutex);
+}
+
+sqlite3 *SqliteDatabase::handle() const
+{
+    return db;
+}
+
+int SqliteDatabase::changes() const
+{
+    return sqlite3_changes(db);
+}
+
+const std::string &SqliteDatabase::getPath() const
+{
+    return path;
+}
+
+void SqliteDatabase::fail(const std::string &what) const
+{
+    throw std::runtime_error("SQLite error on " + path + " (" + what + "): " + sqlite3_errmsg(db) + "\n");
+}
+
+SqliteDatabase::Transaction::Transaction(SqliteDatabase &database) : database(database)
+{
+    database.execute("BEGIN IMMEDIATE");
+}
+
+SqliteDatabase::Transaction::~Transaction()
+{
+    if (!done)
+        sqlite3_exec(database.db, "ROLLBACK", nullptr, nullptr, nullptr);
+}
+
+void SqliteDatabase::Transaction::commit()
+{
+    database.execute("COMMIT");
+    done = true;
+}
+
+SqliteStatement::SqliteStatement(SqliteDatabase *database, const char *sql) : database(database)
+{
+    if (sqlite3_prepare_v3(database->handle(), sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+        database->fail(std::string("prepare ") + sql);
+}
+
+SqliteStatement::~SqliteStatement()
+{
+    sqlite3_finalize(stmt);
+}
+
+SqliteStatement &SqliteStatement::bind(int index, int value)
+{
+    if (sqlite3_bind_int(stmt, index, value) != SQLITE_OK)
+        database->fail("bind");
+    return *this;
+}
+
+SqliteStatement &SqliteStatement::bind(int index, long long value)
+{
+    if (sqlite3_bind_int64(stmt, index, value) != SQLITE_OK)
+        database->fail("bind");
+    return *this;
+}
+
+SqliteStatement &SqliteStatement::bind(int index, std::string_view text)
+{
+    if (sqlite3_bind_text(stmt, index, text.data(), (int)text.size(), SQLITE_TRANSIENT) != SQLITE_OK)
+        database->fail("bind");
+    return *this;
+}
+
+SqliteStatement &SqliteStatement::bindBlob(int index, std::string_view bytes)
+{
+    // static : the caller keeps the bytes alive until the statement has run
+    if (sqlite3_bind_blob(stmt, index, bytes.data(), (int)bytes.size(), SQLITE_STATIC) != SQLITE_OK)
+        database->fail("bind");
+    return *this;
+}
+
+SqliteStatement &SqliteStatement::bindNull(int index)
+{
+    if (sqlite3_bind_null(stmt, index) != SQLITE_OK)
+        database->fail("bind");
+    return *this;
+}
+
+bool SqliteStatement::step()
+{
+    int result = sqlite3_step(stmt);
+    if (result == SQLITE_ROW)
+        return true;
+    if (result == SQLITE_DONE)
+        return false;
+    database->fail(sqlite3_sql(stmt));
+}
+
+void SqliteStatement::reset()
+{
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+}
+
+int SqliteStatement::columnInt(int column) const
+{
+    return sqlite3_column_int(stmt, column);
+}
+
+long long SqliteStatement::columnLong(int column) const
+{
+    return sqlite3_column_int64(stmt, column);
+}
+
+std::string SqliteStatement::columnText(int column) const
+{
+    auto text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, column));
+    return std::string(text != nullptr ? text : "", sqlite3_column_bytes(stmt, column));
+}
+
+std::string_view SqliteStatement::columnBlob(int column) const
+{
+    auto bytes = static_cast<const char *>(sqlite3_column_blob(stmt, column));
+    return std::string_view(bytes, sqlite3_column_bytes(stmt, column));
+}
@@ -0,0 +1,132 @@
+#include "Repo/SqlitePassengerRepository.h"
+#include <iostream>
+#include <stdexcept>
+
+// the table and its index have to exist before the statements are prepared
+static SqliteDatabase *withPassengersTable(SqliteDatabase *database)
+{
+    if (database == nullptr)
+        throw std::invalid_argument("Sqlite repository needs a database");
+    // AUTOINCREMENT : like the tickets , the id of a deleted passenger is never handed out again
+    database->execute("CREATE TABLE IF NOT EXISTS passengers("
+                      "id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL, version INTEGER NOT NULL)");
+    database->execute("CREATE INDEX IF NOT EXISTS passengers_name ON passengers(name COLLATE NOCASE)");
+    return database;
+}
+
+SqlitePassengerRepository::SqlitePassengerRepository(SqliteDatabase *database)
+    : database(withPassengersTable(database)),
+      selectById(database, "SELECT id, version, name FROM passengers WHERE id = ?1"),
+      selectAll(database, "SELECT id, version, name FROM passengers ORDER BY id"),
+      // the index keeps equal names in id order , so the first row is the lowest id
+      selectByName(database, "SELECT id, version, name FROM passengers WHERE name = ?1 COLLATE NOCASE "
+                             "ORDER BY name COLLATE NOCASE, id LIMIT 1"),
+      upsert(database, "INSERT INTO passengers(id, name, version) VALUES(?1, ?2, 1) "
+                       "ON CONFLICT(id) DO UPDATE SET name = excluded.name, version = passengers.version + 1 "
+                       "RETURNING id, version"),
+      insertNew(database, "INSERT INTO passengers(id, name, version) VALUES(?1, ?2, 1) "
+                          "ON CONFLICT(id) DO NOTHING RETURNING id, version"),
+      updateIfVersion(database, "UPDATE passengers SET name = ?2, version = version + 1 "
+                                "WHERE id = ?1 AND version = ?3 RETURNING id, version"),
+      remove(database, "DELETE FROM passengers WHERE id = ?1"),
+      removeAll(database, "DELETE FROM passengers")
+{
+}
+
+Passenger SqlitePassengerRepository::read(const SqliteStatement &row)
+{
+    Passenger passenger(row.columnInt(0), row.columnText(2));
+    passenger.setVersion(row.columnLong(1));
+    return passenger;
+}
+
+bool SqlitePassengerRepository::write(SqliteStatement &statement, Passenger &passenger, bool conditional)
+{
+    auto scope = statement.use();
+    if (passenger.getId() == 0)
+        statement.bindNull(1);
+    else
+        statement.bind(1, passenger.getId());
+    statement.bind(2, std::string_view(passenger.getName()));
+    if (conditional)
+        statement.bind(3, passenger.getVersion());
+    if (!statement.step())
+        return false; // the stored version moved on
+    passenger.setId(statement.columnInt(0));
+    passenger.setVersion(statement.columnLong(1));
+    statement.step(); // runs the statement to its end
+    return true;
+}
+
+void SqlitePassengerRepository::save(Passenger &passenger)
+{
+    auto lock = database->lock();
+    write(upsert, passenger, false);
+}
+
+void SqlitePassengerRepository::saveAll(vector<Passenger> &passengers)
+{
+    if (passengers.size() == 0)
+        return;
+    auto lock = database->lock();
+    SqliteDatabase::Transaction transaction(*database);
+    for (size_t i = 0; i < passengers.size(); i++)
+        write(upsert, passengers[i], false);
+    transaction.commit();
+}
+
+bool SqlitePassengerRepository::compareAndSave(Passenger &passenger)
+{
+    auto lock = database->lock();
+    if (passenger.getVersion() == 0)
+        return write(insertNew, passenger, false);
+    return write(updateIfVersion, passenger, true);
+}
+
+std::optional<Passenger> SqlitePassengerRepository::getPassenger(const int &passengerId)
+{
+    auto lock = database->lock();
+    auto scope = selectById.use();
+    selectById.bind(1, passengerId);
+    if (!selectById.step())
+        return std::nullopt; // not found
+    return read(selectById);
+}
+
+std::optional<Passenger> SqlitePassengerRepository::findPassengerByName(const std::string &name)
+{
+    auto lock = database->lock();
+    auto scope = selectByName.use();
+    selectByName.bind(1, std::string_view(name));
+    if (!selectByName.step())
+        return std::nullopt; // not found
+    return read(selectByName);
+}
+
+vector<Passenger> SqlitePassengerRepository::getAllPassengers()
+{
+    auto lock = database->lock();
+    auto scope = selectAll.use();
+    vector<Passenger> passengers;
+    while (selectAll.step())
+        passengers.push_back(read(selectAll));
+    return passengers;
+}
+
+bool SqlitePassengerRepository::deletePassenger(const int &passengerId)
+{
+    auto lock = database->lock();
+    auto scope = remove.use();
+    remove.bind(1, passengerId).step();
+    return database->changes() > 0;
+}
+
+void SqlitePassengerRepository::clear()
+{
+    {
+        auto lock = database->lock();
+        auto scope = removeAll.use();
+        removeAll.step();
+    }
+    std::cout << "All passengers destroyed\n";
+}
@@ -0,0 +1,200 @@
+#include "Repo/SqliteTicketRepository.h"
+#include "utils/BinaryCodec.h"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// the table and its indexes have to exist before the statements are prepared
+static SqliteDatabase *withTicketsTable(SqliteDatabase *database)
+{
+    if (database == nullptr)
+        throw std::invalid_argument("Sqlite repository needs a database");
+    // AUTOINCREMENT : without it sqlite hands the id of the highest deleted ticket out again ,
+    // and a ticket id must stay unique for good (archives , exports , the cache keep old ones)
+    database->execute("CREATE TABLE IF NOT EXISTS tickets("
+                      "id INTEGER PRIMARY KEY AUTOINCREMENT, train_id INTEGER NOT NULL, passenger_id INTEGER NOT NULL,"
+                      "travel_date INTEGER NOT NULL, seat INTEGER NOT NULL, status INTEGER NOT NULL,"
+                      "version INTEGER NOT NULL, body BLOB NOT NULL)");
+    // every booking asks whether the passenger already holds a ticket on the train (and date)
+    database->execute("CREATE INDEX IF NOT EXISTS tickets_train_passenger ON tickets(train_id, passenger_id, travel_date)");
+    database->execute("CREATE INDEX IF NOT EXISTS tickets_passenger ON tickets(passenger_id)");
+    return database;
+}
+
+SqliteTicketRepository::SqliteTicketRepository(SqliteDatabase *database)
+    : database(withTicketsTable(database)),
+      selectById(database, "SELECT id, version, body FROM tickets WHERE id = ?1"),
+      selectAll(database, "SELECT id, version, body FROM tickets ORDER BY id"),
+      selectPage(database, "SELECT id, version, body FROM tickets WHERE id > ?1 ORDER BY id LIMIT ?2"),
+      selectByPassenger(database, "SELECT id, version, body FROM tickets WHERE passenger_id = ?1 ORDER BY id"),
+      selectByTrainPassenger(database, "SELECT id, version, body FROM tickets "
+                                       "WHERE train_id = ?1 AND passenger_id = ?2 ORDER BY id LIMIT 1"),
+      selectByTrainPassengerDate(database, "SELECT id, version, body FROM tickets "
+                                           "WHERE train_id = ?1 AND passenger_id = ?2 AND travel_date = ?3 "
+                                           "ORDER BY id LIMIT 1"),
+      upsert(database, "INSERT INTO tickets(id, train_id, passenger_id, travel_date, seat, status, version, body) "
+                       "VALUES(?1, ?2, ?3, ?4, ?5, ?6, 1, ?7) ON CONFLICT(id) DO UPDATE SET "
+                       "train_id = excluded.train_id, passenger_id = excluded.passenger_id,"
+                       " travel_date = excluded.travel_date, seat = excluded.seat, status = excluded.status,"
+                       " version = tickets.version + 1, body = excluded.body RETURNING id, version"),
+      insertNew(database, "INSERT INTO tickets(id, train_id, passenger_id, travel_date, seat, status, version, body) "
+                          "VALUES(?1, ?2, ?3, ?4, ?5, ?6, 1, ?7) ON CONFLICT(id) DO NOTHING RETURNING id, version"),
+      updateIfVersion(database, "UPDATE tickets SET train_id = ?2, passenger_id = ?3, travel_date = ?4, seat = ?5,"
+                                " status = ?6, version = version + 1, body = ?7 "
+                                "WHERE id = ?1 AND version = ?8 RETURNING id, version"),
+      remove(database, "DELETE FROM tickets WHERE id = ?1"),
+      removeAll(database, "DELETE FROM tickets")
+{
+}
+
+Ticket SqliteTicketRepository::read(const SqliteStatement &row)
+{
+    std::string_view body = row.columnBlob(2);
+    ByteReader in(body.data(), body.size());
+    Ticket ticket = Ticket::decode(in);
+    // the columns are authoritative , the blob was encoded before the row got its id / version
+    ticket.setId(row.columnInt(0));
+    ticket.setVersion(row.columnLong(1));
+    return ticket;
+}
+
+bool SqliteTicketRepository::write(SqliteStatement &statement, Ticket &ticket, bool conditional)
+{
+    ByteWriter out;
+    ticket.encode(out);
+
+    auto scope = statement.use();
+    if (ticket.getId() == 0)
+        statement.bindNull(1);
+    else
+        statement.bind(1, ticket.getId());
+    statement.bind(2, ticket.getTrainId())
+        .bind(3, ticket.getPassenger().getId())
+        .bind(4, ticket.getTravelDate())
+        .bind(5, ticket.getSeat())
+        .bind(6, (int)ticket.getStatus())
+        .bindBlob(7, out.data());
+    if (conditional)
+        statement.bind(8, ticket.getVersion());
+    if (!statement.step())
+        return false; // the stored version moved on
+    ticket.setId(statement.columnInt(0));
+    ticket.setVersion(statement.columnLong(1));
+    statement.step(); // runs the statement to its end
+    return true;
+}
+
+std::optional<Ticket> SqliteTicketRepository::first(SqliteStatement &statement)
+{
+    if (!statement.step())
+        return std::nullopt; // not found
+    return read(statement);
+}
+
+vector<Ticket> SqliteTicketRepository::all(SqliteStatement &statement)
+{
+    vector<Ticket> tickets;
+    while (statement.step())
+        tickets.push_back(read(statement));
+    return tickets;
+}
+
+void SqliteTicketRepository::save(Ticket &ticket)
+{
+    auto lock = database->lock();
+    write(upsert, ticket, false);
+}
+
+bool SqliteTicketRepository::compareAndSave(Ticket &ticket)
+{
+    auto lock = database->lock();
+    if (ticket.getVersion() == 0)
+        return write(insertNew, ticket, false);
+    return write(updateIfVersion, ticket, true);
+}
+
+void SqliteTicketRepository::saveAll(vector<Ticket> &tickets)
+{
+    if (tickets.size() == 0)
+        return;
+    auto lock = database->lock();
+    SqliteDatabase::Transaction transaction(*database);
+    for (size_t i = 0; i < tickets.size(); i++)
+        write(upsert, tickets[i], false);
+    transaction.commit();
+}
+
+std::optional<Ticket> SqliteTicketRepository::getTicketById(int ticketId)
+{
+    auto lock = database->lock();
+    auto scope = selectById.use();
+    selectById.bind(1, ticketId);
+    return first(selectById);
+}
+
+std::optional<Ticket> SqliteTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    auto lock = database->lock();
+    auto scope = selectByTrainPassenger.use();
+    selectByTrainPassenger.bind(1, trainId).bind(2, passengerId);
+    return first(selectByTrainPassenger);
+}
+
+std::optional<Ticket> SqliteTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    auto lock = database->lock();
+    auto scope = selectByTrainPassengerDate.use();
+    selectByTrainPassengerDate.bind(1, trainId).bind(2, passengerId).bind(3, travelDate);
+    return first(selectByTrainPassengerDate);
+}
+
+vector<Ticket> SqliteTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    auto lock = database->lock();
+    auto scope = selectByPassenger.use();
+    selectByPassenger.bind(1, passengerId);
+    return all(selectByPassenger);
+}
+
+vector<Ticket> SqliteTicketRepository::getAllTickets()
+{
+    auto lock = database->lock();
+    auto scope = selectAll.use();
+    return all(selectAll);
+}
+
+vector<Ticket> SqliteTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    auto lock = database->lock();
+    auto scope = selectPage.use();
+    selectPage.bind(1, afterId).bind(2, limit);
+    return all(selectPage);
+}
+
+Snapshot<Ticket> SqliteTicketRepository::snapshot()
+{
+    auto lock = database->lock();
+    auto scope = selectAll.use();
+    Snapshot<Ticket>::Map tickets;
+    while (selectAll.step())
+        tickets.insert(selectAll.columnInt(0), std::make_shared<const Ticket>(read(selectAll)));
+    return Snapshot<Ticket>(std::move(tickets));
+}
+
+bool SqliteTicketRepository::deleteTicket(int ticketId)
+{
+    auto lock = database->lock();
+    auto scope = remove.use();
+    remove.bind(1, ticketId).step();
+    return database->changes() > 0;
+}
+
+void SqliteTicketRepository::clear()
+{
+    {
+        auto lock = database->lock();
+        auto scope = removeAll.use();
+        removeAll.step();
+    }
+    std::cout << "All tickets destroyed\n";
+}
@@ -0,0 +1,152 @@
+#include "Repo/SqliteTrainRepository.h"
+#include "utils/BinaryCodec.h"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// the table has to exist before the statements are prepared
+static SqliteDatabase *withTrainsTable(SqliteDatabase *database)
+{
+    if (database == nullptr)
+        throw std::invalid_argument("Sqlite repository needs a database");
+    // AUTOINCREMENT : like the tickets , the id of a deleted train is never handed out again
+    database->execute("CREATE TABLE IF NOT EXISTS trains("
+                      "id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL, seats INTEGER NOT NULL,"
+                      "version INTEGER NOT NULL, inventory BLOB NOT NULL)");
+    return database;
+}
+
+SqliteTrainRepository::SqliteTrainRepository(SqliteDatabase *database)
+    : database(withTrainsTable(database)),
+      selectById(database, "SELECT id, version, inventory FROM trains WHERE id = ?1"),
+      selectAll(database, "SELECT id, version, inventory FROM trains ORDER BY id"),
+      selectPage(database, "SELECT id, version, inventory FROM trains WHERE id > ?1 ORDER BY id LIMIT ?2"),
+      // a NULL id takes the next id AUTOINCREMENT hands out , past every id the table ever had
+      upsert(database, "INSERT INTO trains(id, name, seats, version, inventory) VALUES(?1, ?2, ?3, 1, ?4) "
+                       "ON CONFLICT(id) DO UPDATE SET name = excluded.name, seats = excluded.seats,"
+                       " version = trains.version + 1, inventory = excluded.inventory RETURNING id, version"),
+      insertNew(database, "INSERT INTO trains(id, name, seats, version, inventory) VALUES(?1, ?2, ?3, 1, ?4) "
+                          "ON CONFLICT(id) DO NOTHING RETURNING id, version"),
+      updateIfVersion(database, "UPDATE trains SET name = ?2, seats = ?3, version = version + 1, inventory = ?4 "
+                                "WHERE id = ?1 AND version = ?5 RETURNING id, version"),
+      remove(database, "DELETE FROM trains WHERE id = ?1"),
+      removeAll(database, "DELETE FROM trains")
+{
+}
+
+Train SqliteTrainRepository::read(const SqliteStatement &row)
+{
+    std::string_view inventory = row.columnBlob(2);
+    ByteReader in(inventory.data(), inventory.size());
+    Train train = Train::decode(in);
+    // the columns are authoritative , the blob was encoded before the row got its id / version
+    train.setTrainId(row.columnInt(0));
+    train.setVersion(row.columnLong(1));
+    return train;
+}
+
+bool SqliteTrainRepository::write(SqliteStatement &statement, Train &train, bool conditional)
+{
+    ByteWriter out;
+    train.encode(out);
+    std::string name = train.getTrainName();
+
+    auto scope = statement.use();
+    if (train.getTrainId() == 0)
+        statement.bindNull(1);
+    else
+        statement.bind(1, train.getTrainId());
+    statement.bind(2, std::string_view(name)).bind(3, train.getTotalSeats()).bindBlob(4, out.data());
+    if (conditional)
+        statement.bind(5, train.getVersion());
+    if (!statement.step())
+        return false; // the stored version moved on
+    train.setTrainId(statement.columnInt(0));
+    train.setVersion(statement.columnLong(1));
+    statement.step(); // runs the statement to its end
+    return true;
+}
+
+void SqliteTrainRepository::save(Train &train)
+{
+    auto lock = database->lock();
+    write(upsert, train, false);
+}
+
+void SqliteTrainRepository::saveAll(vector<Train> &trains)
+{
+    if (trains.size() == 0)
+        return;
+    auto lock = database->lock();
+    SqliteDatabase::Transaction transaction(*database);
+    for (size_t i = 0; i < trains.size(); i++)
+        write(upsert, trains[i], false);
+    transaction.commit();
+}
+
+bool SqliteTrainRepository::compareAndSave(Train &train)
+{
+    auto lock = database->lock();
+    if (train.getVersion() == 0)
+        return write(insertNew, train, false); // never saved : only if nobody took the id
+    return write(updateIfVersion, train, true);
+}
+
+std::optional<Train> SqliteTrainRepository::getTrainById(const int &trainId) const
+{
+    auto lock = database->lock();
+    auto scope = selectById.use();
+    selectById.bind(1, trainId);
+    if (!selectById.step())
+        return std::nullopt; // not found
+    return read(selectById);
+}
+
+vector<Train> SqliteTrainRepository::getAllTrains() const
+{
+    auto lock = database->lock();
+    auto scope = selectAll.use();
+    vector<Train> trains;
+    while (selectAll.step())
+        trains.push_back(read(selectAll));
+    return trains;
+}
+
+vector<Train> SqliteTrainRepository::getTrainsPage(int afterId, int limit) const
+{
+    auto lock = database->lock();
+    auto scope = selectPage.use();
+    selectPage.bind(1, afterId).bind(2, limit);
+    vector<Train> trains;
+    while (selectPage.step())
+        trains.push_back(read(selectPage));
+    return trains;
+}
+
+Snapshot<Train> SqliteTrainRepository::snapshot() const
+{
+    auto lock = database->lock();
+    auto scope = selectAll.use();
+    Snapshot<Train>::Map trains;
+    while (selectAll.step())
+        trains.insert(selectAll.columnInt(0), std::make_shared<const Train>(read(selectAll)));
+    return Snapshot<Train>(std::move(trains));
+}
+
+bool SqliteTrainRepository::deleteTrain(int trainId)
+{
+    auto lock = database->lock();
+    auto scope = remove.use();
+    remove.bind(1, trainId).step();
+    return database->changes() > 0;
+}
+
+void SqliteTrainRepository::clear()
+{
+    {
+        auto lock = database->lock();
+        auto scope = removeAll.use();
+        removeAll.step();
+    }
+    std::cout << "All trains destroyed\n";
+}
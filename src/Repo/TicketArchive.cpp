@@ -0,0 +1,423 @@
+#include "Repo/TicketArchive.h"
+#include "Repo/SnapshotFile.h"
+#include "utils/BinaryCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'R', 'M', 'S', 'A', 'R', 'C', '0', '1'};
+static constexpr uint32_t SEGMENT_MAGIC = 0x53475341; // "ASGS"
+static constexpr size_t RESTART_EVERY = 64;
+static constexpr size_t MIN_MAPPING = 1 << 20;
+
+// segment : header , then the body
+//   rows        varint deltas , restarting every RESTART_EVERY rows
+//   name bytes  the distinct passenger names back to back
+//   name table  names x {uint32 offset , uint32 length} into the name bytes
+//   restarts    restarts x {int32 first id , uint32 offset} into the rows
+struct SegmentHeader
+{
+    uint32_t magic;
+    uint32_t count;
+    int32_t minId;
+    int32_t maxId;
+    uint32_t rowBytes;
+    uint32_t nameBytes;
+    uint32_t names;
+    uint32_t restarts;
+    uint32_t bodySize;
+    uint32_t crc; // of the body
+};
+
+struct SegmentSlot
+{
+    uint32_t first; // offset , or the first id of a restart
+    uint32_t second;
+};
+
+static std::runtime_error systemError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno) + "\n");
+}
+
+static SegmentHeader readHeader(const char *at)
+{
+    SegmentHeader header;
+    std::memcpy(&header, at, sizeof(header));
+    return header;
+}
+
+static SegmentSlot readSlot(const char *table, size_t index)
+{
+    SegmentSlot slot;
+    std::memcpy(&slot, table + index * sizeof(SegmentSlot), sizeof(slot));
+    return slot;
+}
+
+static bool wellFormed(const SegmentHeader &h)
+{
+    uint64_t tables = ((uint64_t)h.names + h.restarts) * sizeof(SegmentSlot);
+    return h.magic == SEGMENT_MAGIC && h.count > 0 && h.minId <= h.maxId &&
+           h.restarts == (h.count + RESTART_EVERY - 1) / RESTART_EVERY &&
+           (uint64_t)h.rowBytes + h.nameBytes + tables == h.bodySize;
+}
+
+TicketArchive::TicketArchive(const std::string &path) : path(path)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw systemError("Cannot open ticket archive", path);
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw systemError("Cannot stat ticket archive", path);
+    }
+    fileSize = (uint64_t)info.st_size;
+    if (fileSize == 0)
+    {
+        if (::write(fd, MAGIC, sizeof(MAGIC)) != (ssize_t)sizeof(MAGIC) || ::fdatasync(fd) != 0)
+        {
+            ::close(fd);
+            throw systemError("Cannot write ticket archive", path);
+        }
+        fileSize = sizeof(MAGIC);
+    }
+    char magic[sizeof(MAGIC)];
+    if (::pread(fd, magic, sizeof(MAGIC), 0) != (ssize_t)sizeof(MAGIC) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Not a ticket archive: " + path + "\n");
+    }
+    try
+    {
+        map(fileSize);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+
+    // every intact segment , a torn tail ends the file
+    uint64_t at = sizeof(MAGIC);
+    while (at + sizeof(SegmentHeader) <= fileSize)
+    {
+        SegmentHeader h = readHeader(base + at);
+        const char *body = base + at + sizeof(SegmentHeader);
+        if (!wellFormed(h) || h.bodySize > fileSize - at - sizeof(SegmentHeader) || crc32(body, h.bodySize) != h.crc)
+            break;
+        segments.push_back(Segment{at, h.count, h.minId, h.maxId});
+        tickets += h.count;
+        rawBytes += (long long)h.count * (long long)sizeof(SnapshotTicketRecord);
+        highestId = std::max(highestId, h.maxId);
+        at += sizeof(SegmentHeader) + h.bodySize;
+    }
+    if (at < fileSize)
+    {
+        if (::ftruncate(fd, (off_t)at) != 0)
+        {
+            unmap();
+            ::close(fd);
+            throw systemError("Cannot truncate ticket archive", path);
+        }
+        fileSize = at;
+    }
+    rebuildBloom((size_t)tickets * 2);
+}
+
+TicketArchive::~TicketArchive()
+{
+    unmap();
+    if (fd >= 0)
+        ::close(fd);
+}
+
+// the mapping reaches past the end of the file , pages the file grows into show up in it ; only
+// bytes below fileSize are ever read
+void TicketArchive::map(uint64_t size)
+{
+    if (size <= mappedSize)
+        return;
+    size_t capacity = MIN_MAPPING;
+    while (capacity < size * 2)
+        capacity *= 2;
+    void *mapped = ::mmap(nullptr, capacity, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+        throw systemError("Cannot map ticket archive", path);
+    unmap();
+    base = static_cast<const char *>(mapped);
+    mappedSize = capacity;
+}
+
+void TicketArchive::unmap()
+{
+    if (base != nullptr)
+        ::munmap(const_cast<char *>(base), mappedSize);
+    base = nullptr;
+    mappedSize = 0;
+}
+
+// fn(ticket) for the rows from the restart on , until it returns false
+template <class Fn>
+void TicketArchive::decode(const Segment &segment, size_t fromRestart, Fn fn) const
+{
+    SegmentHeader h = readHeader(base + segment.offset);
+    const char *body = base + segment.offset + sizeof(SegmentHeader);
+    const char *nameBytes = body + h.rowBytes;
+    const char *nameTable = nameBytes + h.nameBytes;
+    const char *restartTable = nameTable + (size_t)h.names * sizeof(SegmentSlot);
+
+    uint32_t start = readSlot(restartTable, fromRestart).second;
+    ByteReader in(body + start, h.rowBytes - start);
+    int id = 0, trainId = 0, passengerId = 0, travelDate = 0;
+    for (size_t row = fromRestart * RESTART_EVERY; row < h.count; row++)
+    {
+        if (row % RESTART_EVERY == 0)
+            id = trainId = passengerId = travelDate = 0;
+        id += (int)in.getVarint();
+        trainId += (int)in.getSignedVarint();
+        passengerId += (int)in.getSignedVarint();
+        int seat = (int)in.getVarint();
+        travelDate += (int)in.getSignedVarint();
+        Status status = (Status)in.getVarint();
+        long long version = (long long)in.getVarint();
+        uint64_t nameIndex = in.getVarint();
+        if (nameIndex >= h.names)
+            throw std::runtime_error("Corrupt ticket archive: " + path + "\n");
+        SegmentSlot name = readSlot(nameTable, nameIndex);
+
+        Ticket ticket(id, seat, trainId, Passenger(passengerId, std::string(nameBytes + name.first, name.second)), travelDate);
+        ticket.setStatus(status);
+        ticket.setVersion(version);
+        if (!fn(ticket))
+            return;
+    }
+}
+
+void TicketArchive::index(const Segment &segment)
+{
+    SegmentHeader h = readHeader(base + segment.offset);
+    const char *body = base + segment.offset + sizeof(SegmentHeader);
+    ByteReader in(body, h.rowBytes);
+    int id = 0;
+    for (size_t row = 0; row < h.count; row++)
+    {
+        if (row % RESTART_EVERY == 0)
+            id = 0;
+        id += (int)in.getVarint();
+        bloom.add((uint64_t)id);
+        for (int field = 0; field < 7; field++) // the rest of the row
+            in.getVarint();
+    }
+}
+
+void TicketArchive::rebuildBloom(size_t expected)
+{
+    bloom = BloomFilter(std::max<size_t>(expected, 1024));
+    for (const Segment &segment : segments)
+        index(segment);
+}
+
+size_t TicketArchive::append(const vector<Ticket> &batch)
+{
+    if (batch.size() == 0)
+        return 0;
+    std::vector<const Ticket *> rows;
+    for (size_t i = 0; i < batch.size(); i++)
+        rows.push_back(&batch[i]);
+    std::stable_sort(rows.begin(), rows.end(), [](const Ticket *a, const Ticket *b) { return a->getId() < b->getId(); });
+
+    ByteWriter body;
+    std::string nameBytes;
+    std::vector<SegmentSlot> nameTable, restarts;
+    std::unordered_map<std::string_view, uint32_t> nameIndex; // views into the tickets
+    int id = 0, trainId = 0, passengerId = 0, travelDate = 0;
+    for (size_t row = 0; row < rows.size(); row++)
+    {
+        const Ticket &ticket = *rows[row];
+        if (ticket.getId() <= 0)
+            throw std::invalid_argument("Only saved tickets can be archived");
+        if (row % RESTART_EVERY == 0)
+        {
+            id = trainId = passengerId = travelDate = 0;
+            restarts.push_back(SegmentSlot{(uint32_t)ticket.getId(), (uint32_t)body.size()});
+        }
+        const std::string &name = ticket.getPassenger().getName();
+        auto known = nameIndex.try_emplace(name, (uint32_t)nameTable.size());
+        if (known.second)
+        {
+            nameTable.push_back(SegmentSlot{(uint32_t)nameBytes.size(), (uint32_t)name.size()});
+            nameBytes.append(name);
+        }
+        body.putVarint((uint64_t)(ticket.getId() - id));
+        body.putSignedVarint(ticket.getTrainId() - trainId);
+        body.putSignedVarint(ticket.getPassenger().getId() - passengerId);
+        body.putVarint((uint64_t)ticket.getSeat());
+        body.putSignedVarint(ticket.getTravelDate() - travelDate);
+        body.putVarint((uint64_t)ticket.getStatus());
+        body.putVarint((uint64_t)ticket.getVersion());
+        body.putVarint(known.first->second);
+        id = ticket.getId();
+        trainId = ticket.getTrainId();
+        passengerId = ticket.getPassenger().getId();
+        travelDate = ticket.getTravelDate();
+    }
+
+    SegmentHeader h{};
+    h.magic = SEGMENT_MAGIC;
+    h.count = (uint32_t)rows.size();
+    h.minId = rows.front()->getId();
+    h.maxId = rows.back()->getId();
+    h.rowBytes = (uint32_t)body.size();
+    h.nameBytes = (uint32_t)nameBytes.size();
+    h.names = (uint32_t)nameTable.size();
+    h.restarts = (uint32_t)restarts.size();
+    std::string bytes = body.take();
+    bytes.append(nameBytes);
+    bytes.append(reinterpret_cast<const char *>(nameTable.data()), nameTable.size() * sizeof(SegmentSlot));
+    bytes.append(reinterpret_cast<const char *>(restarts.data()), restarts.size() * sizeof(SegmentSlot));
+    h.bodySize = (uint32_t)bytes.size();
+    h.crc = crc32(bytes.data(), bytes.size());
+    bytes.insert(0, reinterpret_cast<const char *>(&h), sizeof(h));
+
+    std::lock_guard<std::mutex> write(writeMutex);
+    uint64_t at = fileSize;
+    for (size_t done = 0; done < bytes.size();)
+    {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            ::ftruncate(fd, (off_t)at); // nothing half-written stays behind
+            throw systemError("Cannot write ticket archive", path);
+        }
+        done += (size_t)n;
+    }
+    if (::fdatasync(fd) != 0)
+        throw systemError("Cannot sync ticket archive", path);
+
+    std::unique_lock lock(mutex);
+    map(at + bytes.size());
+    fileSize = at + bytes.size();
+    segments.push_back(Segment{at, h.count, h.minId, h.maxId});
+    tickets += h.count;
+    rawBytes += (long long)h.count * (long long)sizeof(SnapshotTicketRecord);
+    highestId = std::max(highestId, h.maxId);
+    if ((size_t)tickets > bloom.capacity())
+        rebuildBloom((size_t)tickets * 2);
+    else
+        index(segments.back());
+    return bytes.size();
+}
+
+std::optional<Ticket> TicketArchive::findIn(const Segment &segment, int id) const
+{
+    if (id < segment.minId || id > segment.maxId)
+        return std::nullopt;
+    SegmentHeader h = readHeader(base + segment.offset);
+    const char *restartTable = base + segment.offset + sizeof(SegmentHeader) + h.bodySize - (size_t)h.restarts * sizeof(SegmentSlot);
+    // the last restart whose first id is not past id
+    size_t lo = 0, hi = h.restarts;
+    while (hi - lo > 1)
+    {
+        size_t mid = (lo + hi) / 2;
+        if ((int)readSlot(restartTable, mid).first <= id)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    std::optional<Ticket> found;
+    size_t rows = 0;
+    decode(segment, lo, [&](const Ticket &ticket) {
+        if (ticket.getId() == id)
+            found = ticket;
+        return ticket.getId() < id && ++rows < RESTART_EVERY;
+    });
+    return found;
+}
+
+std::optional<Ticket> TicketArchive::find(int ticketId) const
+{
+    lookups++;
+    std::shared_lock lock(mutex);
+    if (!bloom.mightContain((uint64_t)ticketId))
+    {
+        bloomRejects++;
+        return std::nullopt;
+    }
+    for (size_t i = segments.size(); i-- > 0;)
+        if (auto ticket = findIn(segments[i], ticketId))
+            return ticket;
+    falsePositives++;
+    return std::nullopt;
+}
+
+bool TicketArchive::mightContain(int ticketId) const
+{
+    std::shared_lock lock(mutex);
+    return bloom.mightContain((uint64_t)ticketId);
+}
+
+void TicketArchive::forEach(const std::function<void(const Ticket &)> &fn) const
+{
+    std::shared_lock lock(mutex);
+    for (const Segment &segment : segments)
+        decode(segment, 0, [&](const Ticket &ticket) {
+            fn(ticket);
+            return true;
+        });
+}
+
+void TicketArchive::clear()
+{
+    std::lock_guard<std::mutex> write(writeMutex);
+    std::unique_lock lock(mutex);
+    if (::ftruncate(fd, sizeof(MAGIC)) != 0 || ::fdatasync(fd) != 0)
+        throw systemError("Cannot truncate ticket archive", path);
+    fileSize = sizeof(MAGIC);
+    segments.clear();
+    tickets = rawBytes = 0;
+    highestId = 0;
+    rebuildBloom(0);
+}
+
+size_t TicketArchive::size() const
+{
+    std::shared_lock lock(mutex);
+    return (size_t)tickets;
+}
+
+int TicketArchive::maxId() const
+{
+    std::shared_lock lock(mutex);
+    return highestId;
+}
+
+const std::string &TicketArchive::getPath() const
+{
+    return path;
+}
+
+ArchiveStats TicketArchive::getStats() const
+{
+    std::shared_lock lock(mutex);
+    ArchiveStats stats;
+    stats.tickets = tickets;
+    stats.segments = (long long)segments.size();
+    stats.bytes = (long long)fileSize;
+    stats.rawBytes = rawBytes;
+    stats.lookups = lookups.load();
+    stats.bloomRejects = bloomRejects.load();
+    stats.falsePositives = falsePositives.load();
+    stats.bloomBytes = bloom.sizeInBytes();
+    return stats;
+}
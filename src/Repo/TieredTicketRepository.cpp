@@ -0,0 +1,235 @@
+#include "Repo/TieredTicketRepository.h"
+#include "utils/helpers.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+
+TieredTicketRepository::TieredTicketRepository(std::unique_ptr<ITicketRepository> inner, TicketArchive *archive)
+    : inner(std::move(inner)), archive(archive)
+{
+    if (this->inner == nullptr || archive == nullptr)
+        throw std::invalid_argument("Tiered repository needs a repository and an archive");
+    nextId = std::max(archive->maxId(), this->inner->snapshot().lastId()) + 1;
+    archive->forEach([&](const Ticket &ticket) { indexArchived(ticket); });
+}
+
+TieredTicketRepository::~TieredTicketRepository()
+{
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (timer.joinable())
+        timer.join();
+}
+
+void TieredTicketRepository::archiveEvery(int intervalMs)
+{
+    if (intervalMs <= 0)
+        throw std::invalid_argument("archive interval must be greater than zero");
+    if (timer.joinable())
+        throw std::logic_error("archiving already runs on a timer");
+    timer = std::thread([this, intervalMs] {
+        std::unique_lock<std::mutex> lock(timerMutex);
+        while (!wake.wait_for(lock, std::chrono::milliseconds(intervalMs), [&] { return stopping; }))
+        {
+            lock.unlock();
+            try
+            {
+                archiveTickets(todayDate());
+            }
+            catch (...)
+            {
+                // the tickets stay live , the next round tries again
+            }
+            lock.lock();
+        }
+    });
+}
+
+void TieredTicketRepository::indexArchived(const Ticket &ticket)
+{
+    std::vector<int> &ids = archivedByPassenger[ticket.getPassenger().getId()];
+    if (std::find(ids.begin(), ids.end(), ticket.getId()) == ids.end())
+        ids.push_back(ticket.getId()); // archived again after it went live once
+}
+
+vector<Ticket> TieredTicketRepository::archivedOf(int passengerId)
+{
+    std::vector<int> ids;
+    {
+        std::shared_lock lock(archivedMutex);
+        auto it = archivedByPassenger.find(passengerId);
+        if (it == archivedByPassenger.end())
+            return vector<Ticket>();
+        ids = it->second;
+    }
+    std::sort(ids.begin(), ids.end());
+    vector<Ticket> found;
+    for (int id : ids)
+    {
+        if (inner->getTicketById(id))
+            continue; // the live copy wins
+        auto ticket = archive->find(id);
+        // the newest archived copy may belong to another passenger by now
+        if (ticket && ticket->getPassenger().getId() == passengerId)
+            found.push_back(*ticket);
+    }
+    return found;
+}
+
+void TieredTicketRepository::assignId(Ticket &ticket)
+{
+    if (ticket.getId() == 0)
+    {
+        ticket.setId(nextId.fetch_add(1));
+        return;
+    }
+    int current = nextId.load();
+    while (ticket.getId() >= current && !nextId.compare_exchange_weak(current, ticket.getId() + 1))
+    {
+    }
+}
+
+size_t TieredTicketRepository::archiveTickets(int beforeDate)
+{
+    vector<Ticket> cold;
+    inner->snapshot().forEach([&](const Ticket &ticket) {
+        if (ticket.getStatus() == cancelled || (ticket.getTravelDate() != 0 && ticket.getTravelDate() < beforeDate))
+            cold.push_back(ticket);
+    });
+    if (cold.size() == 0)
+        return 0;
+    archive->append(cold); // synced before anything leaves the live tier
+    {
+        std::unique_lock lock(archivedMutex);
+        for (size_t i = 0; i < cold.size(); i++)
+            indexArchived(cold[i]);
+    }
+
+    // a ticket saved again since the walk stays live , its archived copy is shadowed
+    std::unique_lock lock(moving);
+    size_t moved = 0;
+    for (size_t i = 0; i < cold.size(); i++)
+    {
+        auto current = inner->getTicketById(cold[i].getId());
+        if (current && current->getVersion() == cold[i].getVersion() && inner->deleteTicket(cold[i].getId()))
+            moved++;
+    }
+    return moved;
+}
+
+TicketArchive *TieredTicketRepository::getArchive() const
+{
+    return archive;
+}
+
+std::optional<Ticket> TieredTicketRepository::getTicketById(int ticketId)
+{
+    if (auto ticket = inner->getTicketById(ticketId))
+        return ticket;
+    return archive->find(ticketId);
+}
+
+std::optional<Ticket> TieredTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId)
+{
+    if (auto ticket = inner->getTicketByTrainAndPassenger(trainId, passengerId))
+        return ticket;
+    vector<Ticket> archived = archivedOf(passengerId);
+    for (size_t i = 0; i < archived.size(); i++)
+        if (archived[i].getTrainId() == trainId)
+            return archived[i];
+    return std::nullopt;
+}
+
+std::optional<Ticket> TieredTicketRepository::getTicketByTrainAndPassenger(int trainId, int passengerId, int travelDate)
+{
+    if (auto ticket = inner->getTicketByTrainAndPassenger(trainId, passengerId, travelDate))
+        return ticket;
+    vector<Ticket> archived = archivedOf(passengerId);
+    for (size_t i = 0; i < archived.size(); i++)
+        if (archived[i].getTrainId() == trainId && archived[i].getTravelDate() == travelDate)
+            return archived[i];
+    return std::nullopt;
+}
+
+// both tiers merged in id order
+vector<Ticket> TieredTicketRepository::getTicketsByPassenger(int passengerId)
+{
+    vector<Ticket> live = inner->getTicketsByPassenger(passengerId);
+    vector<Ticket> archived = archivedOf(passengerId);
+    if (archived.size() == 0)
+        return live;
+    vector<Ticket> all;
+    size_t l = 0, a = 0;
+    while (l < live.size() || a < archived.size())
+    {
+        if (a == archived.size() || (l < live.size() && live[l].getId() < archived[a].getId()))
+            all.push_back(live[l++]);
+        else
+            all.push_back(archived[a++]);
+    }
+    return all;
+}
+
+bool TieredTicketRepository::deleteTicket(int ticketId)
+{
+    std::shared_lock lock(moving);
+    return inner->deleteTicket(ticketId);
+}
+
+void TieredTicketRepository::save(Ticket &ticket)
+{
+    std::shared_lock lock(moving);
+    assignId(ticket);
+    inner->save(ticket);
+}
+
+bool TieredTicketRepository::compareAndSave(Ticket &ticket)
+{
+    std::shared_lock lock(moving);
+    assignId(ticket);
+    if (inner->compareAndSave(ticket))
+        return true;
+    // an archived copy has no live version to compare with , rereading it would never help
+    if (ticket.getVersion() != 0 && !inner->getTicketById(ticket.getId()) && archive->find(ticket.getId()))
+        throw std::logic_error("ticket with id : " + std::to_string(ticket.getId()) + " is archived , it can not be changed");
+    return false;
+}
+
+void TieredTicketRepository::saveAll(vector<Ticket> &tickets)
+{
+    std::shared_lock lock(moving);
+    for (size_t i = 0; i < tickets.size(); i++)
+        assignId(tickets[i]);
+    inner->saveAll(tickets);
+}
+
+vector<Ticket> TieredTicketRepository::getAllTickets()
+{
+    return inner->getAllTickets();
+}
+
+vector<Ticket> TieredTicketRepository::getTicketsPage(int afterId, int limit)
+{
+    return inner->getTicketsPage(afterId, limit);
+}
+
+Snapshot<Ticket> TieredTicketRepository::snapshot()
+{
+    return inner->snapshot();
+}
+
+void TieredTicketRepository::clear()
+{
+    std::unique_lock lock(moving);
+    archive->clear();
+    {
+        std::unique_lock index(archivedMutex);
+        archivedByPassenger.clear();
+    }
+    inner->clear();
+    nextId = 1;
+}
@@ -0,0 +1,382 @@
+#include "Repo/WriteAheadLog.h"
+#include "utils/BinaryCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'R', 'M', 'S', 'W', 'A', 'L', '0', '1'};
+static constexpr size_t FRAME = 2 * sizeof(uint32_t); // size , crc32
+static constexpr size_t HEADER = sizeof(MAGIC);
+
+static std::runtime_error systemError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno) + "\n");
+}
+
+WriteAheadLog::WriteAheadLog(const std::string &path, const WalOptions &options) : path(path), options(options)
+{
+    if (options.flushIntervalMs <= 0)
+        throw std::invalid_argument("Flush interval must be greater than zero");
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw systemError("Cannot open write-ahead log", path);
+
+    struct stat info{};
+    char magic[HEADER];
+    bool fresh = ::fstat(fd, &info) == 0 && info.st_size == 0;
+    if (fresh)
+    {
+        writeBytes(std::string(MAGIC, HEADER));
+        ::fdatasync(fd);
+        info.st_size = HEADER;
+    }
+    else if (::pread(fd, magic, HEADER, 0) != (ssize_t)HEADER || std::memcmp(magic, MAGIC, HEADER) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Not a write-ahead log: " + path + "\n");
+    }
+    fileBytes = appendedBytes = (uint64_t)info.st_size;
+    flusher = std::thread([this] { flushLoop(); });
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeFlusher.notify_one();
+    flusher.join();
+    ::close(fd);
+}
+
+void WriteAheadLog::writeBytes(const std::string &bytes)
+{
+    size_t done = 0;
+    while (done < bytes.size())
+    {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            throw systemError("Cannot write write-ahead log", path);
+        done += (size_t)n;
+    }
+}
+
+size_t WriteAheadLog::replay(const std::function<void(const WalRecord &)> &apply)
+{
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+        throw systemError("Cannot stat write-ahead log", path);
+    const off_t end = info.st_size;
+
+    // read in large chunks , a record may straddle two of them
+    std::string buffer;
+    size_t used = 0;
+    off_t readAt = HEADER, good = HEADER;
+    size_t count = 0;
+    auto fill = [&](size_t need) -> bool
+    {
+        if (buffer.size() - used >= need)
+            return true;
+        buffer.erase(0, used);
+        used = 0;
+        while (buffer.size() < need && readAt < end)
+        {
+            size_t chunk = std::max(need - buffer.size(), (size_t)1 << 20);
+            size_t old = buffer.size();
+            buffer.resize(old + chunk);
+            ssize_t n = ::pread(fd, buffer.data() + old, chunk, readAt);
+            if (n < 0)
+                throw systemError("Cannot read write-ahead log", path);
+            buffer.resize(old + (size_t)n);
+            readAt += n;
+            if (n == 0)
+                break;
+        }
+        return buffer.size() >= need;
+    };
+
+    while (fill(FRAME))
+    {
+        uint32_t size, crc;
+        std::memcpy(&size, buffer.data() + used, sizeof(uint32_t));
+        std::memcpy(&crc, buffer.data() + used + sizeof(uint32_t), sizeof(uint32_t));
+        if (size < 2 || (off_t)size > end - good || !fill(FRAME + size))
+            break; // torn tail
+        const char *payload = buffer.data() + used + FRAME;
+        if (crc32(payload, size) != crc || (uint8_t)payload[0] > (uint8_t)WalTable::Passengers ||
+            (uint8_t)payload[1] > (uint8_t)WalOp::Clear)
+            break;
+        WalRecord record{(WalTable)payload[0], (WalOp)payload[1], std::string(payload + 2, size - 2)};
+        apply(record);
+        used += FRAME + size;
+        good += (off_t)(FRAME + size);
+        count++;
+    }
+    // whatever follows the last intact record was cut short by a crash , later appends go after it
+    if (good < end && ::ftruncate(fd, good) != 0)
+        throw systemError("Cannot truncate write-ahead log", path);
+    std::lock_guard<std::mutex> file(fileMutex);
+    std::lock_guard<std::mutex> lock(mutex);
+    fileBytes = appendedBytes = (uint64_t)good;
+    return count;
+}
+
+std::string WriteAheadLog::frame(WalTable table, WalOp op, const std::string &body)
+{
+    std::string record(FRAME + 2 + body.size(), '\0');
+    char *payload = record.data() + FRAME;
+    payload[0] = (char)table;
+    payload[1] = (char)op;
+    std::memcpy(payload + 2, body.data(), body.size());
+    uint32_t size = (uint32_t)(2 + body.size());
+    uint32_t crc = crc32(payload, size);
+    std::memcpy(record.data(), &size, sizeof(uint32_t));
+    std::memcpy(record.data() + sizeof(uint32_t), &crc, sizeof(uint32_t));
+    return record;
+}
+
+size_t WriteAheadLog::readFrames(const char *data, size_t size, const std::function<void(const WalRecord &)> &apply)
+{
+    size_t used = 0;
+    while (size - used >= FRAME)
+    {
+        uint32_t length, crc;
+        std::memcpy(&length, data + used, sizeof(uint32_t));
+        std::memcpy(&crc, data + used + sizeof(uint32_t), sizeof(uint32_t));
+        if (length < 2)
+            throw std::runtime_error("Bad write-ahead log record\n");
+        if (size - used - FRAME < length)
+            break;
+        const char *payload = data + used + FRAME;
+        if (crc32(payload, length) != crc || (uint8_t)payload[0] > (uint8_t)WalTable::Passengers ||
+            (uint8_t)payload[1] > (uint8_t)WalOp::Clear)
+            throw std::runtime_error("Bad write-ahead log record\n");
+        apply(WalRecord{(WalTable)payload[0], (WalOp)payload[1], std::string(payload + 2, length - 2)});
+        used += FRAME + length;
+    }
+    return used;
+}
+
+uint64_t WriteAheadLog::append(WalTable table, WalOp op, const std::string &body)
+{
+    // framed outside the lock , the lock only covers the copy into the buffer
+    std::string record = frame(table, op, body);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failure.empty())
+        throw std::runtime_error(failure);
+    pending += record;
+    appendedBytes += record.size();
+    stats.records++;
+    return ++appended;
+}
+
+void WriteAheadLog::waitFor(std::unique_lock<std::mutex> &lock, const uint64_t &reached, uint64_t lsn)
+{
+    flushed.wait(lock, [&] { return reached >= lsn || !failure.empty(); });
+    if (reached < lsn)
+        throw std::runtime_error(failure);
+}
+
+void WriteAheadLog::commit(uint64_t lsn)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    switch (options.durability)
+    {
+    case Durability::Buffered:
+        if (!failure.empty())
+            throw std::runtime_error(failure);
+        return;
+    case Durability::Written:
+        writeWanted = std::max(writeWanted, lsn);
+        wakeFlusher.notify_one();
+        waitFor(lock, written, lsn);
+        return;
+    case Durability::Synced:
+        syncWanted = std::max(syncWanted, lsn);
+        wakeFlusher.notify_one();
+        waitFor(lock, synced, lsn);
+        return;
+    }
+}
+
+void WriteAheadLog::sync()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t lsn = appended;
+    syncWanted = std::max(syncWanted, lsn);
+    wakeFlusher.notify_one();
+    waitFor(lock, synced, lsn);
+}
+
+void WriteAheadLog::flushLoop()
+{
+    const auto interval = std::chrono::milliseconds(options.flushIntervalMs);
+    std::unique_lock<std::mutex> lock(mutex);
+    auto nextSync = std::chrono::steady_clock::now() + interval;
+    while (true)
+    {
+        wakeFlusher.wait_until(lock, nextSync, [&]
+                               { return stopping || writeWanted > written || syncWanted > synced; });
+        bool due = stopping || std::chrono::steady_clock::now() >= nextSync;
+        bool mustSync = due || syncWanted > synced;
+        if (pending.empty() && !(mustSync && written > synced))
+        {
+            if (stopping)
+                return;
+            if (due)
+                nextSync = std::chrono::steady_clock::now() + interval;
+            continue;
+        }
+
+        // everything buffered so far goes out in one write , the commits that queue up
+        // behind it are the next batch
+        std::string batch;
+        batch.swap(pending);
+        uint64_t upto = appended;
+        lock.unlock();
+        std::string error;
+        std::unique_lock<std::mutex> file(fileMutex);
+        try
+        {
+            if (!batch.empty())
+                writeBytes(batch);
+            if (mustSync && ::fdatasync(fd) != 0)
+                throw systemError("Cannot sync write-ahead log", path);
+            if (shipper && !batch.empty())
+                shipper(batch);
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+        }
+        // fileBytes moves with the file under fileMutex , or discardBefore copies a range
+        // without this batch and the rename drops it
+        lock.lock();
+
+        if (!error.empty())
+        {
+            failure = error;
+            flushed.notify_all();
+            return; // the file is in an unknown state , nothing more is written
+        }
+        written = upto;
+        fileBytes += batch.size();
+        file.unlock();
+        stats.writes += batch.empty() ? 0 : 1;
+        stats.bytes += (long long)batch.size();
+        if (mustSync)
+        {
+            synced = upto;
+            stats.syncs++;
+            nextSync = std::chrono::steady_clock::now() + interval;
+        }
+        flushed.notify_all();
+    }
+}
+
+void WriteAheadLog::setShipper(std::function<void(const std::string &frames)> shipper)
+{
+    std::lock_guard<std::mutex> file(fileMutex);
+    this->shipper = std::move(shipper);
+}
+
+uint64_t WriteAheadLog::endOffset() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendedBytes;
+}
+
+void WriteAheadLog::discardBefore(uint64_t offset)
+{
+    sync(); // everything before offset is in the file
+    std::lock_guard<std::mutex> file(fileMutex);
+    uint64_t end;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        end = fileBytes;
+    }
+    if (offset <= HEADER)
+        return;
+    if (offset > end)
+        throw std::invalid_argument("Cannot discard past the end of the write-ahead log");
+
+    // header and the records from offset on , into a new file that takes the log's name
+    std::string tmpPath = path + ".tmp";
+    int tmp = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (tmp < 0)
+        throw systemError("Cannot create", tmpPath);
+    try
+    {
+        std::string chunk(MAGIC, HEADER);
+        for (uint64_t at = offset; true;)
+        {
+            for (size_t done = 0; done < chunk.size();)
+            {
+                ssize_t n = ::write(tmp, chunk.data() + done, chunk.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw systemError("Cannot write", tmpPath);
+                done += (size_t)n;
+            }
+            if (at >= end)
+                break;
+            chunk.resize((size_t)std::min<uint64_t>(end - at, 1 << 20));
+            ssize_t n = ::pread(fd, chunk.data(), chunk.size(), (off_t)at);
+            if (n <= 0)
+                throw systemError("Cannot read write-ahead log", path);
+            chunk.resize((size_t)n);
+            at += (uint64_t)n;
+        }
+        if (::fdatasync(tmp) != 0 || ::rename(tmpPath.c_str(), path.c_str()) != 0)
+            throw systemError("Cannot replace write-ahead log", path);
+    }
+    catch (...)
+    {
+        ::close(tmp);
+        ::unlink(tmpPath.c_str());
+        throw;
+    }
+    // the rename itself survives a crash once the directory is synced
+    std::string dir = path.find('/') == std::string::npos ? "." : path.substr(0, path.rfind('/') + 1);
+    int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ::close(fd);
+    fd = tmp;
+    uint64_t removed = offset - HEADER;
+    fileBytes -= removed;
+    appendedBytes -= removed;
+    stats.discarded += (long long)removed;
+}
+
+const WalOptions &WriteAheadLog::getOptions() const
+{
+    return options;
+}
+
+const std::string &WriteAheadLog::getPath() const
+{
+    return path;
+}
+
+WalStats WriteAheadLog::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    WalStats current = stats;
+    current.size = (long long)appendedBytes;
+    return current;
+}
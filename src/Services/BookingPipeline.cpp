@@ -0,0 +1,185 @@
+#include "Services/BookingPipeline.h"
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+
+BookingPipeline::BookingPipeline(TicketService *ts, const BookingPipelineOptions &options)
+    : ticketService(ts), options(options)
+{
+    if (options.workers <= 0)
+        throw std::invalid_argument("worker count must be greater than zero");
+    if (options.maxBatchSize <= 0)
+        throw std::invalid_argument("batch size must be greater than zero");
+    if (options.maxBatchDelayMs < 0)
+        throw std::invalid_argument("batch delay cannot be negative");
+
+    ready.resize(options.shardOf ? options.workers : 1);
+    for (int i = 0; i < options.workers; i++)
+        workers.emplace_back(&BookingPipeline::workerLoop, this, options.shardOf ? i : 0);
+}
+
+int BookingPipeline::laneOf(int trainId) const
+{
+    if (!options.shardOf)
+        return 0; // one lane shared by every worker
+    return (int)((unsigned)options.shardOf(trainId) % ready.size());
+}
+
+void BookingPipeline::schedule(int trainId)
+{
+    trains[trainId].scheduled = true;
+    ready[laneOf(trainId)].push(trainId);
+    if (options.shardOf)
+        workAvailable.notify_all(); // only the lane's own worker may take it
+    else
+        workAvailable.notify_one();
+}
+
+BookingPipeline::~BookingPipeline()
+{
+    shutdown();
+}
+
+std::future<std::optional<Ticket>> BookingPipeline::submit(const BookingRequest &request)
+{
+    auto promise = std::make_shared<std::promise<std::optional<Ticket>>>();
+    auto future = promise->get_future();
+    submit(request, [promise](const std::optional<Ticket> &ticket, std::exception_ptr error) {
+        if (error)
+            promise->set_exception(error);
+        else
+            promise->set_value(ticket);
+    });
+    return future;
+}
+
+void BookingPipeline::submit(const BookingRequest &request, Callback onDone)
+{
+    enqueue(Pending{request, std::move(onDone), Clock::now()});
+}
+
+void BookingPipeline::enqueue(Pending pending)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping)
+        throw std::runtime_error("booking pipeline is shut down");
+
+    int trainId = pending.request.trainId;
+    TrainQueue &q = trains[trainId];
+    q.pending.push(pending);
+    stats.submitted++;
+    stats.queueDepth++;
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, stats.queueDepth);
+
+    if (!q.busy && !q.scheduled)
+        schedule(trainId);
+    else if (q.busy && q.pending.size() >= options.maxBatchSize)
+        batchFilled.notify_all(); // the worker holding this train stops waiting for company
+}
+
+// called with the lock held and the train marked busy , may wait (releasing the lock)
+// until the batch is full or its oldest request reached the latency bound
+std::vector<BookingPipeline::Pending> BookingPipeline::takeBatch(int trainId, std::unique_lock<std::mutex> &lock)
+{
+    Clock::time_point deadline = trains[trainId].pending.front().enqueuedAt +
+                                 std::chrono::milliseconds(options.maxBatchDelayMs);
+    batchFilled.wait_until(lock, deadline, [&] {
+        return stopping || trains[trainId].pending.size() >= options.maxBatchSize;
+    });
+
+    TrainQueue &q = trains[trainId]; // looked up again , the map may have grown meanwhile
+    std::vector<Pending> batch;
+    while (!q.pending.empty() && (int)batch.size() < options.maxBatchSize)
+    {
+        batch.push_back(q.pending.front());
+        q.pending.pop();
+    }
+    stats.queueDepth -= batch.size();
+    stats.batches++;
+    stats.largestBatch = std::max(stats.largestBatch, (int)batch.size());
+    batchedRequests += batch.size();
+    return batch;
+}
+
+void BookingPipeline::workerLoop(int lane)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        workAvailable.wait(lock, [&] { return stopping || !ready[lane].empty(); });
+        if (ready[lane].empty())
+            return; // stopping and everything queued is booked
+
+        int trainId = ready[lane].front();
+        ready[lane].pop();
+        trains[trainId].scheduled = false;
+        trains[trainId].busy = true;
+        std::vector<Pending> batch = takeBatch(trainId, lock);
+
+        lock.unlock();
+        std::vector<BookingRequest> requests;
+        requests.reserve(batch.size());
+        for (const auto &p : batch)
+            requests.push_back(p.request);
+        std::vector<BookingOutcome> outcomes = ticketService->bookBatch(trainId, requests);
+        {
+            // counted before the callbacks so a resolved future already sees it
+            std::lock_guard<std::mutex> statsGuard(mutex);
+            stats.completed += batch.size();
+        }
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            if (!batch[i].onDone)
+                continue;
+            try
+            {
+                batch[i].onDone(outcomes[i].ticket, outcomes[i].error);
+            }
+            catch (...)
+            {
+                // a throwing callback must not take the worker down
+            }
+        }
+        lock.lock();
+
+        TrainQueue &q = trains[trainId];
+        q.busy = false;
+        if (!q.pending.empty())
+        {
+            // more arrived while we were booking , back of the line so other trains get a turn
+            schedule(trainId);
+        }
+        else
+            trains.erase(trainId);
+    }
+}
+
+void BookingPipeline::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping && workers.empty())
+            return;
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    batchFilled.notify_all();
+    for (auto &worker : workers)
+        if (worker.joinable())
+            worker.join();
+    workers.clear();
+}
+
+BookingPipelineStats BookingPipeline::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    BookingPipelineStats snapshot = stats;
+    if (stats.batches > 0)
+        snapshot.averageBatchFill = (double)batchedRequests / stats.batches / options.maxBatchSize;
+    return snapshot;
+}
+
+const BookingPipelineOptions &BookingPipeline::getOptions() const
+{
+    return options;
+}
@@ -0,0 +1,382 @@
+#include "Services/BulkExporter.h"
+#include "utils/BinaryCodec.h"
+#include "utils/helpers.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'R', 'M', 'S', 'T', 'K', 'X', '0', '1'};
+
+static std::runtime_error systemError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno) + "\n");
+}
+
+namespace
+{
+    // formats straight into one buffer and hands it to the sink whenever it passes the limit
+    class Output
+    {
+    private:
+        std::string buffer;
+        size_t limit;
+        std::function<void(const char *, size_t)> sink;
+        long long written = 0;
+
+    public:
+        Output(size_t limit, std::function<void(const char *, size_t)> sink) : limit(limit), sink(std::move(sink))
+        {
+            buffer.reserve(limit + 4096);
+        }
+
+        void endRecord()
+        {
+            if (buffer.size() >= limit)
+                flush();
+        }
+
+        void flush()
+        {
+            if (buffer.empty())
+                return;
+            sink(buffer.data(), buffer.size());
+            written += (long long)buffer.size();
+            buffer.clear();
+        }
+
+        long long bytes() const { return written; }
+
+        void put(char c) { buffer += c; }
+        void put(std::string_view text) { buffer.append(text); }
+        void putRaw(const void *data, size_t size) { buffer.append(static_cast<const char *>(data), size); }
+
+        void putInt(long long value)
+        {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer.append(digits, result.ptr);
+        }
+
+        // yyyymmdd as YYYY-MM-DD , nothing for 0 (the undated inventory)
+        void putDate(int date)
+        {
+            if (date == 0)
+                return;
+            char text[10] = {'0', '0', '0', '0', '-', '0', '0', '-', '0', '0'};
+            int year = date / 10000, month = date / 100 % 100, day = date % 100;
+            for (int i = 3; i >= 0; i--, year /= 10)
+                text[i] = char('0' + year % 10);
+            text[5] = char('0' + month / 10);
+            text[6] = char('0' + month % 10);
+            text[8] = char('0' + day / 10);
+            text[9] = char('0' + day % 10);
+            buffer.append(text, sizeof(text));
+        }
+
+        // quoted only when it has to be
+        void putCsv(std::string_view text)
+        {
+            if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                buffer.append(text);
+                return;
+            }
+            buffer += '"';
+            for (char c : text)
+            {
+                buffer += c;
+                if (c == '"')
+                    buffer += '"';
+            }
+            buffer += '"';
+        }
+
+        void putJson(std::string_view text)
+        {
+            buffer += '"';
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '"': buffer.append("\\\""); break;
+                case '\\': buffer.append("\\\\"); break;
+                case '\n': buffer.append("\\n"); break;
+                case '\r': buffer.append("\\r"); break;
+                case '\t': buffer.append("\\t"); break;
+                default:
+                    if ((unsigned char)c < 0x20)
+                    {
+                        const char *hex = "0123456789abcdef";
+                        buffer.append("\\u00");
+                        buffer += hex[c >> 4];
+                        buffer += hex[c & 15];
+                    }
+                    else
+                        buffer += c;
+                }
+            }
+            buffer += '"';
+        }
+    };
+
+    class Export
+    {
+    private:
+        ExportFormat format;
+        const ExportOptions &options;
+        Output &out;
+        Snapshot<Train> trains; // manifest only , for the names
+        int namedTrain = 0;
+        std::string trainName; // of namedTrain , copied once per train
+        ByteWriter scratch; // binary records , reused
+
+        bool selected(const Ticket &ticket) const
+        {
+            if (options.trainId != 0 && ticket.getTrainId() != options.trainId)
+                return false;
+            if (options.travelDate && ticket.getTravelDate() != *options.travelDate)
+                return false;
+            return !options.manifest || ticket.getStatus() == booked;
+        }
+
+        const std::string &nameOf(int trainId)
+        {
+            if (trainId != namedTrain)
+            {
+                const Train *train = trains.find(trainId);
+                trainName = train != nullptr ? train->getTrainName() : "";
+                namedTrain = trainId;
+            }
+            return trainName;
+        }
+
+        void header()
+        {
+            if (format == ExportFormat::Binary)
+                out.putRaw(MAGIC, sizeof(MAGIC));
+            else if (format == ExportFormat::Csv)
+                out.put(options.manifest ? "train_id,train_name,date,seat,ticket_id,passenger_id,passenger_name\n"
+                                         : "id,train_id,passenger_id,passenger_name,seat,date,status\n");
+        }
+
+        void write(const Ticket &ticket)
+        {
+            const Passenger &passenger = ticket.getPassenger();
+            switch (format)
+            {
+            case ExportFormat::Binary:
+            {
+                scratch.clear();
+                ticket.encode(scratch);
+                uint32_t size = (uint32_t)scratch.size();
+                out.putRaw(&size, sizeof(size));
+                out.put(scratch.data());
+                break;
+            }
+            case ExportFormat::Csv:
+                if (options.manifest)
+                {
+                    out.putInt(ticket.getTrainId());
+                    out.put(',');
+                    out.putCsv(nameOf(ticket.getTrainId()));
+                    out.put(',');
+                    out.putDate(ticket.getTravelDate());
+                    out.put(',');
+                    out.putInt(ticket.getSeat());
+                    out.put(',');
+                    out.putInt(ticket.getId());
+                    out.put(',');
+                    out.putInt(passenger.getId());
+                    out.put(',');
+                    out.putCsv(passenger.getName());
+                }
+                else
+                {
+                    out.putInt(ticket.getId());
+                    out.put(',');
+                    out.putInt(ticket.getTrainId());
+                    out.put(',');
+                    out.putInt(passenger.getId());
+                    out.put(',');
+                    out.putCsv(passenger.getName());
+                    out.put(',');
+                    out.putInt(ticket.getSeat());
+                    out.put(',');
+                    out.putDate(ticket.getTravelDate());
+                    out.put(',');
+                    out.put(ticket.getStatus() == booked ? "booked" : "cancelled");
+                }
+                out.put('\n');
+                break;
+            case ExportFormat::JsonLines:
+                if (options.manifest)
+                {
+                    out.put("{\"train_id\":");
+                    out.putInt(ticket.getTrainId());
+                    out.put(",\"train_name\":");
+                    out.putJson(nameOf(ticket.getTrainId()));
+                    out.put(",\"date\":\"");
+                    out.putDate(ticket.getTravelDate());
+                    out.put("\",\"seat\":");
+                    out.putInt(ticket.getSeat());
+                    out.put(",\"ticket_id\":");
+                    out.putInt(ticket.getId());
+                }
+                else
+                {
+                    out.put("{\"id\":");
+                    out.putInt(ticket.getId());
+                    out.put(",\"train_id\":");
+                    out.putInt(ticket.getTrainId());
+                    out.put(",\"seat\":");
+                    out.putInt(ticket.getSeat());
+                    out.put(",\"date\":\"");
+                    out.putDate(ticket.getTravelDate());
+                    out.put("\",\"status\":\"");
+                    out.put(ticket.getStatus() == booked ? "booked" : "cancelled");
+                    out.put('"');
+                }
+                out.put(",\"passenger_id\":");
+                out.putInt(passenger.getId());
+                out.put(",\"passenger_name\":");
+                out.putJson(passenger.getName());
+                out.put("}\n");
+                break;
+            }
+            out.endRecord();
+        }
+
+    public:
+        Export(ExportFormat format, const ExportOptions &options, Output &out) : format(format), options(options), out(out)
+        {
+        }
+
+        ExportReport run(TrainService *trainService, TicketService *ticketService)
+        {
+            auto started = std::chrono::steady_clock::now();
+            ExportReport report;
+            Snapshot<Ticket> tickets = ticketService->snapshotTickets();
+            header();
+            if (!options.manifest)
+            {
+                tickets.forEach([&](const Ticket &ticket) {
+                    if (!selected(ticket))
+                        return;
+                    write(ticket);
+                    report.records++;
+                });
+            }
+            else
+            {
+                trains = trainService->snapshotTrains();
+                // sort keys copied beside the pointer , comparing them touches no ticket
+                struct Entry
+                {
+                    int trainId, travelDate, seat;
+                    const Ticket *ticket; // into the snapshot , alive as long as it is
+                };
+                std::vector<Entry> order;
+                tickets.forEach([&](const Ticket &ticket) {
+                    if (selected(ticket))
+                        order.push_back({ticket.getTrainId(), ticket.getTravelDate(), ticket.getSeat(), &ticket});
+                });
+                std::sort(order.begin(), order.end(), [](const Entry &a, const Entry &b) {
+                    if (a.trainId != b.trainId)
+                        return a.trainId < b.trainId;
+                    if (a.travelDate != b.travelDate)
+                        return a.travelDate < b.travelDate;
+                    return a.seat < b.seat;
+                });
+                for (const Entry &entry : order)
+                    write(*entry.ticket);
+                report.records = (long long)order.size();
+            }
+            out.flush();
+            report.bytes = out.bytes();
+            report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+            return report;
+        }
+    };
+}
+
+BulkExporter::BulkExporter(TrainService *trainService, TicketService *ticketService)
+    : trainService(trainService), ticketService(ticketService)
+{
+    if (trainService == nullptr || ticketService == nullptr)
+        throw std::invalid_argument("Exporter needs the train and ticket services");
+}
+
+ExportReport BulkExporter::exportStream(ExportFormat format, std::ostream &stream, const ExportOptions &options)
+{
+    if (options.bufferBytes == 0)
+        throw std::invalid_argument("buffer size must be greater than zero");
+    Output out(options.bufferBytes, [&](const char *data, size_t size) {
+        if (!stream.write(data, (std::streamsize)size))
+            throw std::runtime_error("Cannot write the export stream\n");
+    });
+    Export job(format, options, out);
+    ExportReport report = job.run(trainService, ticketService);
+    stream.flush();
+    return report;
+}
+
+ExportReport BulkExporter::exportFile(ExportFormat format, const std::string &path, const ExportOptions &options)
+{
+    if (options.bufferBytes == 0)
+        throw std::invalid_argument("buffer size must be greater than zero");
+    bool standardOutput = path == "-";
+    if (standardOutput)
+        std::fflush(stdout); // what the CLI printed before goes first
+    int fd = standardOutput ? STDOUT_FILENO : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw systemError("Cannot open export file", path);
+
+    Output out(options.bufferBytes, [&](const char *data, size_t size) {
+        size_t done = 0;
+        while (done < size)
+        {
+            ssize_t n = ::write(fd, data + done, size - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw systemError("Cannot write export file", path);
+            done += (size_t)n;
+        }
+    });
+    ExportReport report;
+    try
+    {
+        Export job(format, options, out);
+        report = job.run(trainService, ticketService);
+    }
+    catch (...)
+    {
+        if (!standardOutput)
+            ::close(fd);
+        throw;
+    }
+    if (!standardOutput && ::close(fd) != 0)
+        throw systemError("Cannot close export file", path);
+    return report;
+}
+
+ExportFormat BulkExporter::formatFor(const std::string &path)
+{
+    auto endsWith = [&](const std::string &suffix)
+    {
+        return path.size() >= suffix.size() && toLowerCase(path.substr(path.size() - suffix.size())) == suffix;
+    };
+    if (endsWith(".jsonl") || endsWith(".ndjson"))
+        return ExportFormat::JsonLines;
+    if (endsWith(".bin"))
+        return ExportFormat::Binary;
+    return ExportFormat::Csv;
+}
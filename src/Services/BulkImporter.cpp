@@ -0,0 +1,376 @@
+#include "Services/BulkImporter.h"
+#include "utils/FieldParser.h"
+#include "utils/helpers.h"
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+    // one record of the chunk being imported , its fields are views into the chunk
+    struct Row
+    {
+        size_t line = 0;
+        std::string_view text;
+        std::string error; // empty while the record is good
+        std::optional<Train> train;
+        std::optional<Passenger> passenger;
+        BookingRequest booking;
+    };
+
+    // CSV column positions of the fields a kind needs , -1 when absent
+    struct Columns
+    {
+        int name = -1, seats = -1, trainId = -1, passengerId = -1, date = -1;
+    };
+
+    std::string_view trimView(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    std::string csvQuote(std::string_view text)
+    {
+        std::string quoted = "\"";
+        for (char c : text)
+        {
+            quoted += c;
+            if (c == '"')
+                quoted += '"';
+        }
+        return quoted + "\"";
+    }
+
+    class Import
+    {
+    private:
+        ImportKind kind;
+        ImportFormat format;
+        const ImportOptions &options;
+        TrainService *trainService;
+        PassengerService *passengerService;
+        TicketService *ticketService;
+        WorkStealingPool *pool;
+        std::ofstream errors;
+        Columns columns;
+        bool headerRead = false;
+        size_t lineNumber = 0;
+        ImportReport report;
+
+        void readHeader(std::string_view line)
+        {
+            ParsedFields fields;
+            std::string error;
+            if (!parseCsvLine(line, fields, error))
+                throw std::invalid_argument("bad CSV header: " + error);
+            for (size_t i = 0; i < fields.values.size(); i++)
+            {
+                std::string name = toLowerCase(std::string(trimView(fields.values[i])));
+                int at = (int)i;
+                if (name == "name")
+                    columns.name = at;
+                else if (name == "seats")
+                    columns.seats = at;
+                else if (name == "train_id")
+                    columns.trainId = at;
+                else if (name == "passenger_id")
+                    columns.passengerId = at;
+                else if (name == "date")
+                    columns.date = at;
+            }
+            auto need = [](int column, const char *name)
+            {
+                if (column < 0)
+                    throw std::invalid_argument(std::string("CSV header has no ") + name + " column");
+            };
+            switch (kind)
+            {
+            case ImportKind::Trains:
+                need(columns.name, "name");
+                need(columns.seats, "seats");
+                break;
+            case ImportKind::Passengers:
+                need(columns.name, "name");
+                break;
+            case ImportKind::Tickets:
+                need(columns.trainId, "train_id");
+                need(columns.passengerId, "passenger_id");
+                break;
+            }
+            headerRead = true;
+        }
+
+        // value of one field , by CSV column or JSON key ; false when the record lacks it
+        bool field(const ParsedFields &fields, int column, const char *key, std::string_view &value) const
+        {
+            if (format == ImportFormat::JsonLines)
+                return fields.find(key, value);
+            if (column < 0 || column >= (int)fields.values.size())
+                return false;
+            value = fields.values[column];
+            return true;
+        }
+
+        // parse and validate , runs on the pool : touches only its own row
+        void check(Row &row, ParsedFields &fields) const
+        {
+            std::string error;
+            bool parsed = format == ImportFormat::Csv ? parseCsvLine(row.text, fields, error)
+                                                      : parseJsonLine(row.text, fields, error);
+            if (!parsed)
+            {
+                row.error = error;
+                return;
+            }
+            std::string_view name, seats, trainId, passengerId, date;
+            try
+            {
+                switch (kind)
+                {
+                case ImportKind::Trains:
+                {
+                    int count = 0;
+                    if (!field(fields, columns.name, "name", name) || !isValidName(trimView(name)))
+                        row.error = "invalid or missing name";
+                    else if (!field(fields, columns.seats, "seats", seats) || !parseIntField(seats, count) || count <= 0)
+                        row.error = "seats must be a positive number";
+                    else
+                        row.train.emplace(0, std::string(trimView(name)), count);
+                    break;
+                }
+                case ImportKind::Passengers:
+                    if (!field(fields, columns.name, "name", name) || !isValidName(trimView(name)))
+                        row.error = "invalid or missing name";
+                    else
+                        row.passenger.emplace(0, std::string(trimView(name)));
+                    break;
+                case ImportKind::Tickets:
+                    if (!field(fields, columns.trainId, "train_id", trainId) || !parseIntField(trainId, row.booking.trainId) ||
+                        row.booking.trainId <= 0)
+                        row.error = "train_id must be a positive number";
+                    else if (!field(fields, columns.passengerId, "passenger_id", passengerId) ||
+                             !parseIntField(passengerId, row.booking.passengerId) || row.booking.passengerId <= 0)
+                        row.error = "passenger_id must be a positive number";
+                    else if (field(fields, columns.date, "date", date) && !trimView(date).empty())
+                        row.booking.travelDate = parseDate(std::string(date));
+                    break;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                row.error = e.what();
+            }
+        }
+
+        void insert(std::vector<Row> &rows)
+        {
+            switch (kind)
+            {
+            case ImportKind::Trains:
+            {
+                std::vector<Train> batch;
+                for (auto &row : rows)
+                    if (row.train)
+                        batch.push_back(std::move(*row.train));
+                trainService->importTrains(batch);
+                report.imported += (long long)batch.size();
+                break;
+            }
+            case ImportKind::Passengers:
+            {
+                std::vector<Passenger> batch;
+                for (auto &row : rows)
+                    if (row.passenger)
+                        batch.push_back(std::move(*row.passenger));
+                passengerService->importPassengers(batch);
+                report.imported += (long long)batch.size();
+                break;
+            }
+            case ImportKind::Tickets:
+            {
+                std::vector<BookingRequest> batch;
+                std::vector<Row *> owners;
+                for (auto &row : rows)
+                    if (row.error.empty())
+                    {
+                        batch.push_back(row.booking);
+                        owners.push_back(&row);
+                    }
+                std::vector<BookingOutcome> outcomes = ticketService->bookBulk(batch);
+                for (size_t i = 0; i < outcomes.size(); i++)
+                {
+                    if (outcomes[i].error)
+                    {
+                        try
+                        {
+                            std::rethrow_exception(outcomes[i].error);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            owners[i]->error = trimView(e.what());
+                        }
+                        continue;
+                    }
+                    report.imported++;
+                    if (!outcomes[i].ticket)
+                        report.waitlisted++;
+                }
+                break;
+            }
+            }
+        }
+
+        void process(std::string_view chunk)
+        {
+            std::vector<Row> rows;
+            size_t start = 0;
+            while (start < chunk.size())
+            {
+                size_t end = chunk.find('\n', start);
+                if (end == std::string_view::npos)
+                    end = chunk.size();
+                std::string_view line = chunk.substr(start, end - start);
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                start = end + 1;
+                lineNumber++;
+                if (trimView(line).empty())
+                    continue;
+                if (format == ImportFormat::Csv && !headerRead)
+                {
+                    readHeader(line);
+                    continue;
+                }
+                Row &row = rows.emplace_back();
+                row.line = lineNumber;
+                row.text = line;
+            }
+            report.records += (long long)rows.size();
+
+            auto checkRange = [&](size_t lo, size_t hi)
+            {
+                ParsedFields fields; // reused by every row of the block
+                for (size_t i = lo; i < hi; i++)
+                    check(rows[i], fields);
+            };
+            if (pool != nullptr)
+                pool->parallelFor(0, rows.size(), 1024, checkRange);
+            else
+                checkRange(0, rows.size());
+
+            insert(rows);
+            for (const auto &row : rows)
+            {
+                if (row.error.empty())
+                    continue;
+                report.rejected++;
+                if (errors.is_open())
+                    errors << row.line << "," << csvQuote(row.error) << "," << csvQuote(row.text) << "\n";
+            }
+        }
+
+    public:
+        Import(ImportKind kind, ImportFormat format, const ImportOptions &options, TrainService *trainService,
+               PassengerService *passengerService, TicketService *ticketService, WorkStealingPool *pool)
+            : kind(kind), format(format), options(options), trainService(trainService),
+              passengerService(passengerService), ticketService(ticketService), pool(pool)
+        {
+            if (options.chunkBytes == 0)
+                throw std::invalid_argument("chunk size must be greater than zero");
+            if (!options.errorReportPath.empty())
+            {
+                errors.open(options.errorReportPath, std::ios::trunc);
+                if (!errors)
+                    throw std::runtime_error("Cannot write error report " + options.errorReportPath + "\n");
+                errors << "line,error,record\n";
+            }
+        }
+
+        ImportReport run(std::istream &in)
+        {
+            auto started = std::chrono::steady_clock::now();
+            std::string chunk, carry;
+            while (true)
+            {
+                // the unfinished last line of the previous chunk goes first
+                chunk.swap(carry);
+                size_t kept = chunk.size();
+                chunk.resize(kept + options.chunkBytes);
+                in.read(chunk.data() + kept, (std::streamsize)options.chunkBytes);
+                chunk.resize(kept + (size_t)in.gcount());
+                bool last = !in;
+
+                size_t cut = chunk.size();
+                if (!last)
+                {
+                    size_t newline = chunk.rfind('\n');
+                    if (newline == std::string::npos)
+                    {
+                        carry.swap(chunk); // one line longer than a chunk , read on
+                        continue;
+                    }
+                    cut = newline + 1;
+                }
+                carry.assign(chunk, cut, std::string::npos);
+                process(std::string_view(chunk.data(), cut));
+                if (last)
+                    break;
+            }
+            if (format == ImportFormat::Csv && !headerRead)
+                throw std::invalid_argument("CSV input has no header line");
+            report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+            return report;
+        }
+    };
+}
+
+BulkImporter::BulkImporter(TrainService *trainService, PassengerService *passengerService, TicketService *ticketService,
+                           WorkStealingPool *pool)
+    : trainService(trainService), passengerService(passengerService), ticketService(ticketService), pool(pool)
+{
+    if (trainService == nullptr || passengerService == nullptr || ticketService == nullptr)
+        throw std::invalid_argument("Importer needs the train , passenger and ticket services");
+}
+
+ImportReport BulkImporter::importStream(ImportKind kind, ImportFormat format, std::istream &in, const ImportOptions &options)
+{
+    Import import(kind, format, options, trainService, passengerService, ticketService, pool);
+    return import.run(in);
+}
+
+ImportReport BulkImporter::importFile(ImportKind kind, const std::string &path, const ImportOptions &options)
+{
+    auto endsWith = [&](const std::string &suffix)
+    {
+        return path.size() >= suffix.size() && toLowerCase(path.substr(path.size() - suffix.size())) == suffix;
+    };
+    ImportFormat format;
+    if (endsWith(".csv"))
+        format = ImportFormat::Csv;
+    else if (endsWith(".jsonl") || endsWith(".ndjson"))
+        format = ImportFormat::JsonLines;
+    else
+        throw std::invalid_argument("import files must end in .csv , .jsonl or .ndjson");
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Cannot open " + path + "\n");
+    return importStream(kind, format, in, options);
+}
+
+ImportKind BulkImporter::parseKind(const std::string &text)
+{
+    std::string kind = toLowerCase(trim(text));
+    if (kind == "trains" || kind == "train")
+        return ImportKind::Trains;
+    if (kind == "passengers" || kind == "passenger")
+        return ImportKind::Passengers;
+    if (kind == "tickets" || kind == "ticket")
+        return ImportKind::Tickets;
+    throw std::invalid_argument("import kind must be trains , passengers or tickets");
+}
@@ -0,0 +1,264 @@
+#include "Services/EventBus.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+const char *eventTypeName(EventType type)
+{
+    switch (type)
+    {
+    case EventType::TicketBooked: return "TicketBooked";
+    case EventType::TicketWaitlisted: return "TicketWaitlisted";
+    case EventType::TicketCancelled: return "TicketCancelled";
+    case EventType::WaitlistPromoted: return "WaitlistPromoted";
+    case EventType::PromotionFailed: return "PromotionFailed";
+    case EventType::HoldPlaced: return "HoldPlaced";
+    case EventType::HoldConfirmed: return "HoldConfirmed";
+    case EventType::HoldReleased: return "HoldReleased";
+    case EventType::HoldExpired: return "HoldExpired";
+    case EventType::TrainAdded: return "TrainAdded";
+    case EventType::TrainDeleted: return "TrainDeleted";
+    case EventType::SeatsAdded: return "SeatsAdded";
+    }
+    return "Unknown";
+}
+
+EventBus::EventBus(const EventBusOptions &options) : options(options), ring(options.capacity)
+{
+    if (options.maxBatch == 0)
+        throw std::invalid_argument("event batch size must be greater than zero");
+    if (options.drainIntervalMs <= 0)
+        throw std::invalid_argument("event drain interval must be greater than zero");
+    dispatcher = std::thread([this] { dispatch(); });
+}
+
+EventBus::~EventBus()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wake.notify_one();
+    dispatcher.join();
+}
+
+bool EventBus::publish(Event event)
+{
+    event.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+    auto fill = [&](Event &slot, size_t position) {
+        slot = event;
+        slot.sequence = position + 1;
+    };
+    while (!ring.tryPushWith(fill))
+    {
+        if (!options.waitWhenFull)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    published.fetch_add(1, std::memory_order_relaxed);
+
+    // waking the dispatcher per event would cost a context switch per booking , it drains on
+    // its own interval unless the ring is filling up
+    if (ring.size() >= ring.capacity() / 2 && sleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+    return true;
+}
+
+void EventBus::dispatch()
+{
+    // a sink writing to a FIFO whose reader went away gets EPIPE instead of killing the process
+    sigset_t pipeSignal;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+
+    std::vector<Event> batch;
+    batch.reserve(options.maxBatch);
+    while (true)
+    {
+        batch.clear();
+        Event event;
+        while (batch.size() < options.maxBatch && ring.tryPop(event))
+            batch.push_back(event);
+
+        if (batch.empty())
+        {
+            if (stopping.load() && ring.empty())
+                return;
+            sleeping.store(true, std::memory_order_relaxed);
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait_for(lock, std::chrono::milliseconds(options.drainIntervalMs), [&] {
+                    return stopping.load() || (flushing.load() > 0 && !ring.empty()) ||
+                           ring.size() >= ring.capacity() / 2;
+                });
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex);
+            for (auto &subscriber : subscribers)
+            {
+                try
+                {
+                    subscriber.second(batch.data(), batch.size());
+                }
+                catch (...)
+                {
+                    // a failing subscriber must not stop the others
+                }
+            }
+        }
+        batches.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            delivered.fetch_add((long long)batch.size());
+        }
+        drained.notify_all();
+    }
+}
+
+int EventBus::subscribe(Subscriber subscriber)
+{
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    int id = nextSubscriberId++;
+    subscribers.emplace_back(id, std::move(subscriber));
+    return id;
+}
+
+void EventBus::unsubscribe(int subscriberId)
+{
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                     [&](const auto &subscriber) { return subscriber.first == subscriberId; }),
+                      subscribers.end());
+}
+
+void EventBus::flush()
+{
+    long long target = published.load();
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    flushing.fetch_add(1);
+    wake.notify_one();
+    drained.wait(lock, [&] { return delivered.load() >= target; });
+    flushing.fetch_sub(1);
+}
+
+EventBusStats EventBus::getStats() const
+{
+    EventBusStats stats;
+    stats.published = published.load();
+    stats.delivered = delivered.load();
+    stats.dropped = dropped.load();
+    stats.batches = batches.load();
+    return stats;
+}
+
+const EventBusOptions &EventBus::getOptions() const
+{
+    return options;
+}
+
+EventLogSink::EventLogSink(EventBus *bus, const std::string &path) : bus(bus), path(path)
+{
+    if (bus == nullptr)
+        throw std::invalid_argument("event log needs a bus");
+    subscriberId = bus->subscribe([this](const Event *events, size_t count) { write(events, count); });
+}
+
+EventLogSink::~EventLogSink()
+{
+    bus->flush();
+    bus->unsubscribe(subscriberId);
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void EventLogSink::write(const Event *events, size_t count)
+{
+    if (!error.empty())
+        return;
+    if (fd < 0)
+    {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            error = "Cannot open event log " + path + ": " + std::strerror(errno) + "\n";
+            return;
+        }
+    }
+
+    buffer.clear();
+    auto number = [&](const char *key, long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer += ",\"";
+        buffer += key;
+        buffer += "\":";
+        buffer.append(digits, result.ptr);
+    };
+    for (size_t i = 0; i < count; i++)
+    {
+        const Event &e = events[i];
+        buffer += "{\"type\":\"";
+        buffer += eventTypeName(e.type);
+        buffer += '"';
+        number("seq", (long long)e.sequence);
+        number("time", e.timeMs);
+        number("train_id", e.trainId);
+        if (e.travelDate != 0)
+            number("date", e.travelDate);
+        if (e.ticketId != 0)
+            number("ticket_id", e.ticketId);
+        if (e.passengerId != 0)
+            number("passenger_id", e.passengerId);
+        if (e.seat != 0)
+            number("seat", e.seat);
+        if (e.holdId != 0)
+            number("hold_id", e.holdId);
+        if (e.seats != 0)
+            number("seats", e.seats);
+        buffer += "}\n";
+    }
+
+    size_t done = 0;
+    while (done < buffer.size())
+    {
+        ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            error = "Cannot write event log " + path + ": " + std::strerror(errno) + "\n";
+            return;
+        }
+        done += (size_t)n;
+    }
+}
+
+const std::string &EventLogSink::getPath() const
+{
+    return path;
+}
+
+std::string EventLogSink::getError()
+{
+    bus->flush(); // the dispatcher wrote error before it counted the batch as delivered
+    return error;
+}
@@ -0,0 +1,38 @@
+#include "Services/HoldScheduler.h"
+#include <stdexcept>
+
+void HoldScheduler::schedule(const SeatHold &hold)
+{
+    schedule(hold.holdId, hold.trainId, hold.expiresAt);
+}
+
+void HoldScheduler::schedule(int holdId, int trainId, long long expiresAt)
+{
+    timers.push(Timer{expiresAt, holdId, trainId});
+}
+
+std::vector<HoldScheduler::Timer> HoldScheduler::popDue(long long now, int maxBatch)
+{
+    if (maxBatch <= 0)
+        throw std::invalid_argument("Batch size must be greater than zero.\n");
+
+    std::vector<Timer> due;
+    while (!timers.empty() && (int)due.size() < maxBatch && timers.top().expiresAt <= now)
+        due.push_back(timers.pop());
+    return due;
+}
+
+long long HoldScheduler::nextExpiry() const
+{
+    return timers.empty() ? -1 : timers.top().expiresAt;
+}
+
+size_t HoldScheduler::size() const
+{
+    return timers.size();
+}
+
+bool HoldScheduler::empty() const
+{
+    return timers.empty();
+}
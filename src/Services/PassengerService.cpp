@@ -2,8 +2,10 @@
 // Created by Omar on 11/24/2025.
 //
 #include <stdexcept>
+#include <unordered_map>
 #include "Services/PassengerService.h"
 #include "utils/helpers.h"
+#include "utils/OptimisticRetry.h"
 PassengerService::PassengerService(IPassengerRepository *repo) {
     this->passengerRepository =repo;
 }
@@ -31,19 +33,55 @@ Passenger PassengerService::createPassenger(const std::string& name) {
     passengerRepository->save(p);
     return p;
 }
+void PassengerService::importPassengers(std::vector<Passenger> &passengers) {
+    std::lock_guard<std::mutex> guard(writeMutex);
+    // find-or-create for a whole batch : a name already stored , or met earlier in the batch ,
+    // gets that passenger back , the others are written with one saveAll
+    std::unordered_map<std::string, size_t> firstWithName;
+    std::vector<size_t> sameAs(passengers.size(), passengers.size());
+    vector<Passenger> fresh;
+    std::vector<size_t> freshAt;
+    for (size_t i = 0; i < passengers.size(); i++) {
+        const std::string key = toLowerCase(passengers[i].getName());
+        auto seen = firstWithName.emplace(key, i);
+        if (!seen.second) {
+            sameAs[i] = seen.first->second;
+            continue;
+        }
+        if (auto existing = passengerRepository->findPassengerByName(passengers[i].getName())) {
+            passengers[i] = *existing;
+            continue;
+        }
+        fresh.push_back(passengers[i]);
+        freshAt.push_back(i);
+    }
+    if (fresh.size() != 0)
+        passengerRepository->saveAll(fresh);
+    for (size_t i = 0; i < fresh.size(); i++)
+        passengers[freshAt[i]] = fresh[i];
+    for (size_t i = 0; i < passengers.size(); i++)
+        if (sameAs[i] != passengers.size())
+            passengers[i] = passengers[sameAs[i]];
+}
+
 Passenger PassengerService::updatePassenger(const int passengerId , const std::string& name) {
-    auto passenger = this->getPassenger(passengerId);
-    passenger.setName(name); //update name
-    passengerRepository->save(passenger);
-    return passenger;
+    std::lock_guard<std::mutex> guard(writeMutex);
+    // the mutex only covers this process , another one sharing the repository may write the
+    // same passenger (SharedPassengerRepository) , so save against the version that was read
+    return retryOnConflict([&] {
+        auto passenger = this->getPassenger(passengerId);
+        passenger.setName(name); //update name
+        if(!passengerRepository->compareAndSave(passenger))
+            throw ConcurrencyConflict("passenger " + std::to_string(passengerId) + " changed while renaming");
+        return passenger;
+    });
 }
 
 Passenger PassengerService::find_or_create_passenger(const std::string &name) {
-    const vector<Passenger> passengers = passengerRepository->getAllPassengers();
+    std::lock_guard<std::mutex> guard(writeMutex);
     // search if it is existed
-    for(const auto & p : passengers)
-        if(toLowerCase(p.getName()) == toLowerCase(name))
-            return   p;
+    if(auto existing = passengerRepository->findPassengerByName(name))
+        return *existing;
     //else  create passenger
     Passenger p(0,name);
     passengerRepository->save(p);
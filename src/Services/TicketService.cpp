@@ -1,9 +1,107 @@
 #include "Services/TicketService.h"
+#include "utils/helpers.h"
+#include "models/ConcurrentSeatAllocator.h"
 #include <stdexcept> //for run time exception
-#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
 
-TicketService::TicketService(ITicketRepository *repo, TrainService *ts, PassengerService *ps):ticketRepository(repo),trainService(ts),passengerService(ps) {
+static long long systemNowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// the fields every ticket event carries
+static Event ticketEvent(EventType type, const Ticket& ticket)
+{
+    Event event;
+    event.type = type;
+    event.trainId = ticket.getTrainId();
+    event.travelDate = ticket.getTravelDate();
+    event.ticketId = ticket.getId();
+    event.passengerId = ticket.getPassenger().getId();
+    event.seat = ticket.getSeat();
+    return event;
+}
 
+static Event holdEvent(EventType type, const SeatHold& hold)
+{
+    Event event;
+    event.type = type;
+    event.trainId = hold.trainId;
+    event.travelDate = hold.travelDate;
+    event.passengerId = hold.passengerId;
+    event.seat = hold.seatNumber;
+    event.holdId = hold.holdId;
+    return event;
+}
+
+// one any-seat booking waiting for its claim to be committed
+struct PendingClaim
+{
+    int passengerId = 0;
+    int seat = 0;
+    bool flexible = false;
+    bool lost = false;  // the locked paths had taken the seat , the claims were out of date
+    bool done = false;  // under SeatClaims::mutex
+    std::optional<Ticket> ticket;
+    std::exception_ptr error;
+};
+
+struct SeatClaims
+{
+    ConcurrentSeatAllocator seats;
+    std::mutex mutex;                   // pending and the done flags , held for a push or a swap
+    std::condition_variable committed;
+    std::vector<PendingClaim*> pending;
+    bool committing = false;
+
+    explicit SeatClaims(const Bitset& freeSeats) : seats(freeSeats) {}
+};
+
+static long long claimsKey(int trainId, int travelDate)
+{
+    return ((long long)trainId << 32) | (unsigned)travelDate;
+}
+
+static bool isAnySeat(const SeatRequest& request)
+{
+    return request.seatClass.empty() && request.coach == 0 && request.preferences == 0;
+}
+
+ConcurrencyMode parseConcurrencyMode(const std::string& name)
+{
+    std::string mode = toLowerCase(trim(name));
+    if(mode == "locking")
+        return ConcurrencyMode::Locking;
+    if(mode == "optimistic")
+        return ConcurrencyMode::Optimistic;
+    if(mode == "claims")
+        return ConcurrencyMode::SeatClaims;
+    throw std::invalid_argument("unknown concurrency mode " + name);
+}
+
+TicketService::TicketService(ITicketRepository *repo, TrainService *ts, PassengerService *ps):ticketRepository(repo),trainService(ts),passengerService(ps),clock(systemNowMs) {
+
+}
+
+TicketService::~TicketService()
+{
+    {
+        std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+        stopExpiry = true;
+    }
+    holdsChanged.notify_one();
+    if(expiryThread.joinable())
+        expiryThread.join();
+    {
+        std::lock_guard<std::mutex> lock(defragMutex);
+        stopDefrag = true;
+    }
+    defragWake.notify_one();
+    if(defragThread.joinable())
+        defragThread.join();
 }
 
 
@@ -21,11 +119,137 @@ vector<Ticket> TicketService::getAllTickets()
     return ticketRepository->getAllTickets();
 }
 
+vector<Ticket> TicketService::getTicketsPage(int afterId, int limit)
+{
+    return ticketRepository->getTicketsPage(afterId, limit);
+}
+
+vector<Ticket> TicketService::getTicketsByPassenger(int passengerId)
+{
+    return ticketRepository->getTicketsByPassenger(passengerId);
+}
+
+Snapshot<Ticket> TicketService::snapshotTickets()
+{
+    return ticketRepository->snapshot();
+}
+
+TicketReport TicketService::getTicketReport()
+{
+    // counts plus the trains seen , one per block of the scan , merged at the end
+    struct Partial
+    {
+        TicketReport report;
+        std::vector<char> seenTrains; // indexed by train id
+    };
+    auto step = [](Partial acc, const Ticket &ticket) {
+        acc.report.total++;
+        if (ticket.getStatus() == booked)
+            acc.report.booked++;
+        else
+            acc.report.cancelled++;
+        size_t trainId = (size_t)ticket.getTrainId();
+        if (trainId >= acc.seenTrains.size())
+            acc.seenTrains.resize(trainId + 1, 0);
+        acc.seenTrains[trainId] = 1;
+        return acc;
+    };
+
+    Snapshot<Ticket> snapshot = ticketRepository->snapshot();
+    Partial all;
+    if (pool)
+    {
+        all = snapshot.reduce(*pool, Partial{}, step, [](Partial a, Partial b) {
+            a.report.total += b.report.total;
+            a.report.booked += b.report.booked;
+            a.report.cancelled += b.report.cancelled;
+            if (b.seenTrains.size() > a.seenTrains.size())
+                a.seenTrains.resize(b.seenTrains.size(), 0);
+            for (size_t i = 0; i < b.seenTrains.size(); i++)
+                a.seenTrains[i] |= b.seenTrains[i];
+            return a;
+        });
+    }
+    else
+        snapshot.forEach([&](const Ticket &ticket) { all = step(std::move(all), ticket); });
+
+    all.report.trains = (int)std::count(all.seenTrains.begin(), all.seenTrains.end(), 1);
+    return all.report;
+}
+
 
 
-std::optional<Ticket> TicketService::bookTicket(const int& trainId, const int& passengerId)
+std::unique_lock<std::recursive_mutex> TicketService::lockForWrite(const int& trainId)
 {
+    if(mode == ConcurrencyMode::Optimistic)
+        return {};
+    return trainService->lockTrain(trainId);
+}
+
+std::optional<Ticket> TicketService::bookTicket(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate)
+{
+    std::optional<Ticket> ticket;
+    if(mode == ConcurrencyMode::SeatClaims && isAnySeat(request)){
+        ticket = bookClaimed(trainId, passengerId, request, travelDate);
+        if(!ticket.has_value()){
+            ticket = book(trainId, passengerId, request, travelDate);
+            if(ticket.has_value()) // the claims had no seat left but the train had , they are out of date
+                dropClaims(trainId, travelDate, nullptr);
+        }
+    }
+    else
+        ticket = book(trainId, passengerId, request, travelDate);
+    return ticket;
+}
+
+std::optional<Ticket> TicketService::book(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate, EventType bookedType)
+{
+    if(travelDate != 0 && !isValidDate(travelDate))
+        throw std::invalid_argument("invalid travel date");
+
+    // everything below is a read-modify-write of this train only
+    auto guard = lockForWrite(trainId);
+    auto ticket = retryOnConflict([&] {
+        return bookAttempt(trainId, passengerId, request, travelDate);
+    }, MAX_ATTEMPTS, &retryStats);
+    // still under the train lock , subscribers see the bookings of a train in commit order
+    publishBooking(bookedType, trainId, passengerId, travelDate, ticket);
+    return ticket;
+}
+
+void TicketService::publishBooking(EventType bookedType, const int& trainId, const int& passengerId, const int& travelDate, const std::optional<Ticket>& ticket)
+{
+    if(ticket.has_value()){
+        publish(ticketEvent(bookedType, *ticket));
+        return;
+    }
+    Event event;
+    event.type = EventType::TicketWaitlisted;
+    event.trainId = trainId;
+    event.travelDate = travelDate;
+    event.passengerId = passengerId;
+    publish(event);
+}
 
+// a ticket the passenger still holds on that train and date , a cancelled one does not count .
+// the index answers with the first ticket it has , only when that one is cancelled are the
+// passenger's other tickets looked through
+bool TicketService::holdsTicket(const int& trainId, const int& passengerId, const int& travelDate)
+{
+    auto found = ticketRepository->getTicketByTrainAndPassenger(trainId, passengerId, travelDate);
+    if(!found.has_value())
+        return false;
+    if(found->getStatus() != cancelled)
+        return true;
+    for(const Ticket& ticket : ticketRepository->getTicketsByPassenger(passengerId))
+        if(ticket.getTrainId() == trainId && ticket.getTravelDate() == travelDate && ticket.getStatus() != cancelled)
+            return true;
+    return false;
+}
+
+// one read-modify-write of the train , ConcurrencyConflict when another writer saved it first
+std::optional<Ticket> TicketService::bookAttempt(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate)
+{
     // 1) get train by id if exist
     auto train = trainService->getTrain(trainId);
 
@@ -33,62 +257,374 @@ std::optional<Ticket> TicketService::bookTicket(const int& trainId, const int& p
     // 2) get passenger by id if exist
     auto  passenger = passengerService->getPassenger(passengerId);
 
-    // 3) check if passenger has already ticket for this train
-    auto  existTicket = ticketRepository->getTicketByTrainAndPassenger(trainId,passengerId);
-    if(existTicket.has_value()){//  found
+    // 3) check if passenger has already ticket for this train on that date
+    if(holdsTicket(trainId,passengerId,travelDate)){//  found
         throw std::runtime_error("cannot allocate more than one ticket for the same passenger in the same train\n");
     }
 
-    // 4) assign seat to passenger if avialble
-    int seat_number=train.getSeatAllocator()->allocateSeat(passengerId);
-    trainService->save(train);
+    // 4) assign seat to passenger if avialble (in the requested class / coach if any)
+    //    the date's inventory is created here on its first booking
+    int seat_number=train.getSeatAllocator(travelDate)->allocateSeat(passengerId, request);
+    trainService->save(train); // versioned , nothing below runs if we lost the race
     if(seat_number == -1) // added to waiting list
         return std::nullopt;
     // 5)  create ticket if available
-    Ticket t(0,seat_number,trainId , passenger);
+    Ticket t(0,seat_number,trainId , passenger, travelDate);
     ticketRepository->save(t);
     return t;
 }
 
-void TicketService::cancelTicket(const int& ticketId)
+std::shared_ptr<SeatClaims> TicketService::claimsFor(const int& trainId, const int& travelDate)
+{
+    long long key = claimsKey(trainId, travelDate);
+    {
+        std::shared_lock<std::shared_mutex> lock(claimsMutex);
+        auto it = seatClaims.find(key);
+        if(it != seatClaims.end())
+            return (*it).second;
+    }
+    // from the saved train , under its lock so no locked writer is half way through it
+    std::shared_ptr<SeatClaims> built;
+    {
+        auto guard = lockForWrite(trainId);
+        auto train = trainService->getTrain(trainId);
+        built = std::make_shared<SeatClaims>(train.getSeatAllocator(travelDate)->getFreeSeats());
+    }
+    std::unique_lock<std::shared_mutex> lock(claimsMutex);
+    auto it = seatClaims.find(key);
+    if(it != seatClaims.end())
+        return (*it).second; // another booking built them first
+    seatClaims[key] = built;
+    return built;
+}
+
+// stale == nullptr drops whatever is there
+void TicketService::dropClaims(const int& trainId, const int& travelDate, const SeatClaims* stale)
+{
+    std::unique_lock<std::shared_mutex> lock(claimsMutex);
+    auto it = seatClaims.find(claimsKey(trainId, travelDate));
+    if(it != seatClaims.end() && (stale == nullptr || (*it).second.get() == stale))
+        seatClaims.erase(it);
+}
+
+void TicketService::releaseClaimedSeat(const int& trainId, const int& travelDate, const int& seatNumber)
+{
+    std::shared_ptr<SeatClaims> claims;
+    {
+        std::shared_lock<std::shared_mutex> lock(claimsMutex);
+        auto it = seatClaims.find(claimsKey(trainId, travelDate));
+        if(it == seatClaims.end())
+            return;
+        claims = (*it).second;
+    }
+    try {
+        claims->seats.freeSeat(seatNumber);
+    } catch (const std::exception&) {
+        dropClaims(trainId, travelDate, claims.get()); // the claims never had it taken
+    }
+}
+
+std::optional<Ticket> TicketService::bookClaimed(const int& trainId, const int& passengerId, const SeatRequest& request, const int& travelDate)
 {
+    if(travelDate != 0 && !isValidDate(travelDate))
+        throw std::invalid_argument("invalid travel date");
 
-    // get ticket
-    auto ticket =this->getTicket(ticketId);
+    std::shared_ptr<SeatClaims> claims = claimsFor(trainId, travelDate);
+    PendingClaim claim;
+    claim.passengerId = passengerId;
+    claim.flexible = request.flexible;
+    claim.seat = claims->seats.tryAllocateSeat(passengerId);
+    if(claim.seat == -1)
+        return std::nullopt; // no seat as far as the claims know , the locked path waitlists
 
+    // the first booking in commits every pending claim , the others wait for that commit
+    // instead of queueing on the train lock one by one
+    std::unique_lock<std::mutex> lock(claims->mutex);
+    claims->pending.push_back(&claim);
+    while(!claim.done){
+        if(claims->committing){
+            claims->committed.wait(lock);
+            continue;
+        }
+        std::vector<PendingClaim*> batch;
+        batch.swap(claims->pending);
+        claims->committing = true;
+        lock.unlock();
+        commitClaims(trainId, travelDate, *claims, batch);
+        lock.lock();
+        for(PendingClaim* committed : batch)
+            committed->done = true;
+        claims->committing = false;
+        claims->committed.notify_all();
+    }
+    lock.unlock();
 
-    // return error if it is already cancelled
-    if(ticket.getStatus() == cancelled){
-        throw std::runtime_error("ticket with id : " +  std::to_string(ticketId) + " is already cancelled");
+    if(claim.error)
+        std::rethrow_exception(claim.error);
+    if(claim.lost){
+        dropClaims(trainId, travelDate, claims.get());
+        return std::nullopt;
     }
+    return claim.ticket;
+}
 
-    //find train
-    auto train = trainService->getTrain(ticket.getTrainId());
-    if(train.getSeatAllocator() == nullptr){
-        throw std::runtime_error("train  not has seat allocator");
+// every claim of the batch with one train load / save and one ticket write , the outcome of
+// each goes into its PendingClaim
+void TicketService::commitClaims(const int& trainId, const int& travelDate, SeatClaims& claims, const std::vector<PendingClaim*>& batch)
+{
+    std::vector<Passenger> passengers(batch.size());
+    std::vector<char> allocated(batch.size(), 0);
+    auto guard = lockForWrite(trainId);
+    try {
+        retryOnConflict([&] {
+            auto train = trainService->getTrain(trainId);
+            SeatAllocator* inventory = train.getSeatAllocator(travelDate);
+            for(size_t i = 0; i < batch.size(); i++){
+                PendingClaim& claim = *batch[i];
+                claim.error = nullptr;
+                claim.lost = false;
+                allocated[i] = 0;
+                try {
+                    passengers[i] = passengerService->getPassenger(claim.passengerId);
+                    if(holdsTicket(trainId, claim.passengerId, travelDate))
+                        throw std::runtime_error("cannot allocate more than one ticket for the same passenger in the same train\n");
+                    // a seat past the end was cut off by setSeats or a new layout , the claims are out of date like for a taken one
+                    if(claim.seat <= inventory->getTotalSeats())
+                        allocated[i] = inventory->allocateSeatAt(claim.passengerId, claim.seat, claim.flexible) != -1;
+                    claim.lost = !allocated[i];
+                } catch (...) {
+                    claim.error = std::current_exception();
+                }
+            }
+            trainService->save(train);
+        }, MAX_ATTEMPTS, &retryStats);
+    } catch (...) {
+        // the train is gone (or kept losing the race) , no claim was committed
+        for(size_t i = 0; i < batch.size(); i++){
+            batch[i]->error = std::current_exception();
+            batch[i]->lost = false;
+            allocated[i] = 0;
+        }
     }
 
-    // pass seat to waiting list
-    auto waitingPassengerId  = train.getSeatAllocator()->freeSeat(ticket.getSeat());
-    if(waitingPassengerId  == -1)
-        throw std::runtime_error("fail to free the seat \n");
-    trainService->save(train);
-    // book seat to another passenger from waiting list if available
-    if (waitingPassengerId > 0)   // >0 means there was a waiting passenger
+    vector<Ticket> tickets;
+    std::vector<size_t> owners;
+    for(size_t i = 0; i < batch.size(); i++){
+        if(!allocated[i])
+            continue;
+        tickets.push_back(Ticket(0, batch[i]->seat, trainId, passengers[i], travelDate));
+        owners.push_back(i);
+    }
+    try {
+        if(!tickets.empty())
+            ticketRepository->saveAll(tickets);
+        for(size_t k = 0; k < owners.size(); k++){
+            batch[owners[k]]->ticket = tickets[k];
+            publish(ticketEvent(EventType::TicketBooked, tickets[k])); // under the train lock , like book
+        }
+    } catch (...) {
+        for(size_t i : owners)
+            batch[i]->error = std::current_exception();
         try {
-            auto t = bookTicket(train.getTrainId(), waitingPassengerId);
-            if(t.has_value())
-                t->print("======Ticket booked to passenger " + std::to_string(waitingPassengerId) + " Successfully ========== \n" );
-        } catch (const std::exception &e) {
-            // Log error and continue with cancellation
-            std::cerr << "Failed to book ticket for waiting passenger "
-                      << waitingPassengerId << ": " << e.what() << "\n";
+            releaseSeats(trainId, tickets);
+        } catch (...) {
+            // the seats stay taken in the train , the next claims rebuilt from it agree
         }
+    }
+
+    // a claim that did not book gives its seat back , a lost one was taken already
+    for(PendingClaim* claim : batch)
+        if(claim->error)
+            claims.seats.freeSeat(claim->seat);
+}
+
+void TicketService::releaseSeats(const int& trainId, const vector<Ticket>& unsaved)
+{
+    if(unsaved.empty())
+        return;
+    auto guard = lockForWrite(trainId);
+    std::vector<std::pair<int, int>> promoted; // travel date , waiting passenger
+    retryOnConflict([&] {
+        promoted.clear();
+        auto train = trainService->getTrain(trainId);
+        for(const Ticket& ticket : unsaved){
+            SeatAllocator* inventory = train.findSeatAllocator(ticket.getTravelDate());
+            if(inventory == nullptr || inventory->getSeatOwner(ticket.getSeat()) != ticket.getPassenger().getId())
+                continue;
+            int waitingPassengerId = inventory->freeSeat(ticket.getSeat());
+            if(waitingPassengerId > 0)
+                promoted.push_back({ticket.getTravelDate(), waitingPassengerId});
+        }
+        trainService->save(train);
+    }, MAX_ATTEMPTS, &retryStats);
+    for(const auto& p : promoted)
+        promoteWaitingPassenger(trainId, p.second, p.first);
+}
+
+std::vector<BookingOutcome> TicketService::bookBatch(const int& trainId, const std::vector<BookingRequest>& requests)
+{
+    std::vector<BookingOutcome> outcomes(requests.size());
+    std::vector<Passenger> passengers(requests.size());
+    std::vector<int> seats(requests.size(), -1);
+
+    auto guard = lockForWrite(trainId);
+    try {
+        retryOnConflict([&] {
+            auto train = trainService->getTrain(trainId);
+            for(size_t i = 0; i < requests.size(); i++){
+                const BookingRequest& r = requests[i];
+                outcomes[i] = BookingOutcome{};
+                seats[i] = -1;
+                try {
+                    if(r.trainId != trainId)
+                        throw std::invalid_argument("request for train " + std::to_string(r.trainId) + " in a batch of train " + std::to_string(trainId));
+                    if(r.travelDate != 0 && !isValidDate(r.travelDate))
+                        throw std::invalid_argument("invalid travel date");
+                    passengers[i] = passengerService->getPassenger(r.passengerId);
+                    if(holdsTicket(trainId, r.passengerId, r.travelDate))
+                        throw std::runtime_error("cannot allocate more than one ticket for the same passenger in the same train\n");
+                    // a second request of the same passenger in this batch is refused by the allocator
+                    seats[i] = train.getSeatAllocator(r.travelDate)->allocateSeat(r.passengerId, r.request);
+                } catch (...) {
+                    outcomes[i].error = std::current_exception();
+                }
+            }
+            trainService->save(train);
+        }, MAX_ATTEMPTS, &retryStats);
+    } catch (...) {
+        // the train itself is missing (or kept losing the race) , the whole batch fails
+        for(auto& outcome : outcomes)
+            outcome.error = std::current_exception();
+        return outcomes;
+    }
+
+    vector<Ticket> tickets;
+    std::vector<size_t> owners; // request index of each ticket
+    for(size_t i = 0; i < requests.size(); i++){
+        if(outcomes[i].error || seats[i] == -1)
+            continue;
+        tickets.push_back(Ticket(0, seats[i], trainId, passengers[i], requests[i].travelDate));
+        owners.push_back(i);
+    }
+    try {
+        ticketRepository->saveAll(tickets);
+    } catch (...) {
+        // the pipeline workers call this , nothing may escape : every booking of the batch fails
+        // and its seat goes back . waitlisted requests stay waitlisted , the train save kept them
+        for(size_t i : owners)
+            outcomes[i].error = std::current_exception();
+        try {
+            releaseSeats(trainId, tickets);
+        } catch (...) {
+            // the seats stay taken in the train , the repository is failing anyway
+        }
+        return outcomes;
+    }
+    for(size_t k = 0; k < owners.size(); k++)
+        outcomes[owners[k]].ticket = tickets[k];
+    if(events){
+        for(size_t i = 0; i < requests.size(); i++)
+            if(!outcomes[i].error)
+                publishBooking(EventType::TicketBooked, trainId, requests[i].passengerId, requests[i].travelDate, outcomes[i].ticket);
+    }
+    return outcomes;
+}
 
+std::vector<BookingOutcome> TicketService::bookBulk(const std::vector<BookingRequest>& requests)
+{
+    // request indexes per train , trains in order of first appearance
+    std::vector<int> trains;
+    unordered_map<int, int> groupOf;
+    std::vector<std::vector<size_t>> groups;
+    for(size_t i = 0; i < requests.size(); i++){
+        int trainId = requests[i].trainId;
+        if(!groupOf.count(trainId)){
+            groupOf[trainId] = (int)groups.size();
+            trains.push_back(trainId);
+            groups.emplace_back();
+        }
+        groups[groupOf[trainId]].push_back(i);
+    }
 
-    // cancel ticket
-    ticket.setStatus(cancelled);
-    ticketRepository->save(ticket);
+    std::vector<BookingOutcome> outcomes(requests.size());
+    // different trains touch different locks and allocators , so the groups are independent
+    auto runGroups = [&](size_t g0, size_t g1) {
+        for(size_t g = g0; g < g1; g++){
+            std::vector<BookingRequest> batch;
+            for(size_t i : groups[g])
+                batch.push_back(requests[i]);
+            auto results = bookBatch(trains[g], batch);
+            for(size_t k = 0; k < results.size(); k++)
+                outcomes[groups[g][k]] = std::move(results[k]);
+        }
+    };
+    if(pool)
+        pool->parallelFor(0, groups.size(), 1, runGroups);
+    else
+        runGroups(0, groups.size());
+    return outcomes;
+}
+
+void TicketService::cancelTicket(const int& ticketId)
+{
+
+    // get ticket , an already cancelled one fails here before any train work
+    Ticket ticket = this->getTicket(ticketId);
+    auto guard = lockForWrite(ticket.getTrainId());
+
+    // claim the cancellation on the ticket first : of two racing cancels only one passes
+    // compareAndSave , the other reads it again and finds it cancelled
+    for (;;) {
+        if(ticket.getStatus() == cancelled){
+            throw std::runtime_error("ticket with id : " +  std::to_string(ticketId) + " is already cancelled");
+        }
+        Ticket claimed = ticket;
+        claimed.setStatus(cancelled);
+        if(ticketRepository->compareAndSave(claimed)){
+            ticket = claimed;
+            break;
+        }
+        Ticket again = this->getTicket(ticketId);
+        if(again.getVersion() == ticket.getVersion()) // nothing moved on , another try fails the same way
+            throw ConcurrencyConflict("ticket with id : " + std::to_string(ticketId) + " can not be claimed for cancelling");
+        ticket = again;
+    }
+
+    int waitingPassengerId = 0;
+    try {
+        retryOnConflict([&] {
+            ticket = this->getTicket(ticketId);
+
+            //find train
+            auto train = trainService->getTrain(ticket.getTrainId());
+            SeatAllocator* inventory = train.findSeatAllocator(ticket.getTravelDate());
+            if(inventory == nullptr){
+                throw std::runtime_error("train has no inventory for " + formatDate(ticket.getTravelDate()) + " (already departed)");
+            }
+            // without the lock a defragmentation may have moved the seat , its ticket update
+            // follows shortly , read again
+            if(inventory->getSeatOwner(ticket.getSeat()) != ticket.getPassenger().getId())
+                throw ConcurrencyConflict("seat of ticket " + std::to_string(ticketId) + " changed hands");
+
+            // pass seat to waiting list
+            waitingPassengerId  = inventory->freeSeat(ticket.getSeat());
+            if(waitingPassengerId  == -1)
+                throw std::runtime_error("fail to free the seat \n");
+            trainService->save(train);
+        }, MAX_ATTEMPTS, &retryStats);
+    } catch (...) {
+        // the seat was not freed , the ticket stays booked
+        ticket.setStatus(booked);
+        ticketRepository->save(ticket);
+        throw;
+    }
+    publish(ticketEvent(EventType::TicketCancelled, ticket));
+
+    // book seat to another passenger from waiting list if available
+    if (waitingPassengerId > 0)   // >0 means there was a waiting passenger
+        promoteWaitingPassenger(ticket.getTrainId(), waitingPassengerId, ticket.getTravelDate());
+    else if (mode == ConcurrencyMode::SeatClaims)
+        releaseClaimedSeat(ticket.getTrainId(), ticket.getTravelDate(), ticket.getSeat());
 }
 
 Ticket TicketService::updateTicket(Ticket &t) {
@@ -97,3 +633,342 @@ Ticket TicketService::updateTicket(Ticket &t) {
 
 }
 
+
+void TicketService::promoteWaitingPassenger(const int& trainId, const int& passengerId, const int& travelDate)
+{
+    try {
+        // WaitlistPromoted , or TicketWaitlisted when the seat went to someone else first
+        book(trainId, passengerId, SeatRequest{}, travelDate, EventType::WaitlistPromoted);
+    } catch (const std::exception &) {
+        // the passenger is off the waiting list either way , subscribers decide what to tell them
+        Event event;
+        event.type = EventType::PromotionFailed;
+        event.trainId = trainId;
+        event.travelDate = travelDate;
+        event.passengerId = passengerId;
+        publish(event);
+    }
+}
+
+SeatHold TicketService::holdSeat(const int& trainId, const int& passengerId, const int& ttlSeconds, const SeatRequest& request, const int& travelDate)
+{
+    if(ttlSeconds <= 0)
+        throw std::invalid_argument("hold time must be greater than zero");
+    if(travelDate != 0 && !isValidDate(travelDate))
+        throw std::invalid_argument("invalid travel date");
+
+    auto guard = trainService->lockTrain(trainId);
+    auto train = trainService->getTrain(trainId);
+    passengerService->getPassenger(passengerId);
+
+    if(holdsTicket(trainId,passengerId,travelDate))
+        throw std::runtime_error("cannot allocate more than one ticket for the same passenger in the same train\n");
+
+    SeatHold hold;
+    hold.holdId = nextHoldId++;
+    hold.trainId = trainId;
+    hold.passengerId = passengerId;
+    hold.travelDate = travelDate;
+    hold.expiresAt = clock() + (long long)ttlSeconds * 1000;
+    // optimistic bookings do not take the lock , a conflict means one saved in between
+    hold.seatNumber = retryOnConflict([&] {
+        train = trainService->getTrain(trainId);
+        int seat = train.getSeatAllocator(travelDate)->holdSeat(hold.holdId, passengerId, hold.expiresAt, request);
+        trainService->save(train);
+        return seat;
+    });
+
+    {
+        std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+        activeHolds[hold.holdId] = hold;
+        holdScheduler.schedule(hold);
+    }
+    holdsChanged.notify_one(); // the expiry thread may be sleeping past this deadline
+    publish(holdEvent(EventType::HoldPlaced, hold));
+    return hold;
+}
+
+SeatHold TicketService::findActiveHold(const int& holdId)
+{
+    std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+    auto it = activeHolds.find(holdId);
+    if(it == activeHolds.end())
+        throw std::out_of_range("hold with id : " + std::to_string(holdId) + " does not exit");
+    return (*it).second;
+}
+
+std::optional<SeatHold> TicketService::takeActiveHold(const int& holdId)
+{
+    std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+    auto it = activeHolds.find(holdId);
+    if(it == activeHolds.end())
+        return std::nullopt;
+    SeatHold hold = (*it).second;
+    activeHolds.erase(holdId);
+    return hold;
+}
+
+Ticket TicketService::confirmHold(const int& holdId)
+{
+    auto guard = trainService->lockTrain(findActiveHold(holdId).trainId);
+    SeatHold hold = findActiveHold(holdId); // again under the lock , expiry may have taken it
+
+    // the scheduler may not have run yet , a lapsed hold is never confirmed
+    if(clock() >= hold.expiresAt){
+        releaseHold(holdId);
+        throw std::runtime_error("hold with id : " + std::to_string(holdId) + " has expired");
+    }
+
+    auto passenger = passengerService->getPassenger(hold.passengerId);
+    int seat_number = retryOnConflict([&] {
+        auto train = trainService->getTrain(hold.trainId);
+        int seat = train.getSeatAllocator(hold.travelDate)->confirmHold(holdId);
+        trainService->save(train);
+        return seat;
+    });
+    takeActiveHold(holdId);
+
+    Ticket t(0,seat_number,hold.trainId , passenger, hold.travelDate);
+    ticketRepository->save(t);
+    Event event = holdEvent(EventType::HoldConfirmed, hold);
+    event.ticketId = t.getId();
+    publish(event);
+    return t;
+}
+
+void TicketService::releaseHold(const int& holdId)
+{
+    auto guard = trainService->lockTrain(findActiveHold(holdId).trainId);
+    SeatHold hold = findActiveHold(holdId);
+
+    int waitingPassengerId = retryOnConflict([&] {
+        auto train = trainService->getTrain(hold.trainId);
+        int waiting = train.getSeatAllocator(hold.travelDate)->releaseHold(holdId);
+        trainService->save(train);
+        return waiting;
+    });
+    takeActiveHold(holdId);
+    publish(holdEvent(EventType::HoldReleased, hold));
+
+    if (waitingPassengerId > 0)
+        promoteWaitingPassenger(hold.trainId, waitingPassengerId, hold.travelDate);
+}
+
+int TicketService::expireHolds(const int& maxBatch)
+{
+    std::vector<HoldScheduler::Timer> due;
+    {
+        std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+        due = holdScheduler.popDue(clock(), maxBatch);
+    }
+
+    // one load / save per train for the whole batch
+    std::sort(due.begin(), due.end(), [](const HoldScheduler::Timer& a, const HoldScheduler::Timer& b) {
+        return a.trainId < b.trainId;
+    });
+
+    int expired = 0;
+    size_t i = 0;
+    while(i < due.size()){
+        int trainId = due[i].trainId;
+        size_t end = i;
+        while(end < due.size() && due[end].trainId == trainId)
+            end++;
+
+        auto guard = trainService->lockTrain(trainId);
+        std::vector<SeatHold> lapsed;
+        for(; i < end; i++){
+            // confirmed / released holds leave a stale timer behind
+            auto taken = takeActiveHold(due[i].holdId);
+            if(taken.has_value())
+                lapsed.push_back(taken.value());
+        }
+
+        std::vector<SeatHold> promoted; // released seats handed to a waiting passenger (passengerId)
+        std::vector<SeatHold> released;
+        try {
+            expired += retryOnConflict([&] {
+                auto train = trainService->getTrain(trainId);
+                promoted.clear();
+                released.clear();
+                for(SeatHold hold : lapsed){
+                    SeatAllocator* inventory = train.findSeatAllocator(hold.travelDate);
+                    if(inventory == nullptr || !inventory->hasHold(hold.holdId))
+                        continue; // date evicted meanwhile
+                    released.push_back(hold);
+                    int waitingPassengerId = inventory->releaseHold(hold.holdId);
+                    if(waitingPassengerId > 0){
+                        hold.passengerId = waitingPassengerId;
+                        promoted.push_back(hold);
+                    }
+                }
+                trainService->save(train);
+                return (int)released.size();
+            });
+        } catch (const std::out_of_range&) {
+            // train deleted meanwhile , its holds went with it
+            released.clear();
+        }
+
+        for(const auto& hold : released)
+            publish(holdEvent(EventType::HoldExpired, hold));
+        for(const auto& p : promoted)
+            promoteWaitingPassenger(trainId, p.passengerId, p.travelDate);
+        i = end;
+    }
+    return expired;
+}
+
+void TicketService::expireHoldsInBackground(const int& maxBatch)
+{
+    if(maxBatch <= 0)
+        throw std::invalid_argument("hold expiry batch must be greater than zero");
+    std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+    if(expiryThread.joinable())
+        throw std::logic_error("holds already expire in the background");
+    expiryThread = std::thread([this, batch = maxBatch] { runHoldExpiry(batch); });
+}
+
+void TicketService::runHoldExpiry(int maxBatch)
+{
+    std::unique_lock<std::mutex> holdsGuard(holdsMutex);
+    while(!stopExpiry){
+        long long next = holdScheduler.nextExpiry();
+        if(next == -1){
+            holdsChanged.wait(holdsGuard); // nothing held , the next holdSeat wakes us
+            continue;
+        }
+        long long wait = next - clock();
+        if(wait > 0){
+            holdsChanged.wait_for(holdsGuard, std::chrono::milliseconds(wait));
+            continue;
+        }
+        holdsGuard.unlock();
+        try {
+            expireHolds(maxBatch);
+        } catch (const std::exception&) {
+            // a train that could not be saved , its lapsed holds are off the heap and the thread goes on
+        }
+        holdsGuard.lock();
+    }
+}
+
+void TicketService::defragmentInBackground(const int& intervalMs, const int& maxSteps)
+{
+    if(intervalMs <= 0 || maxSteps <= 0)
+        throw std::invalid_argument("defragmentation interval and steps must be greater than zero");
+    std::lock_guard<std::mutex> lock(defragMutex);
+    if(defragThread.joinable())
+        throw std::logic_error("seats are already defragmented in the background");
+    defragThread = std::thread([this, intervalMs = intervalMs, maxSteps = maxSteps] { runDefragmentation(intervalMs, maxSteps); });
+}
+
+void TicketService::runDefragmentation(int intervalMs, int maxSteps)
+{
+    std::unique_lock<std::mutex> lock(defragMutex);
+    while(!defragWake.wait_for(lock, std::chrono::milliseconds(intervalMs), [&] { return stopDefrag; })){
+        lock.unlock();
+        // a slice holds one train lock for at most maxSteps moves , bookings go on in between
+        for(const Train& train : trainService->getAllTrains()){
+            vector<int> dates = train.getDepartureDates();
+            dates.push_back(0);
+            for(size_t i = 0; i < dates.size(); i++){
+                try {
+                    defragmentSeats(train.getTrainId(), dates[i], maxSteps);
+                } catch (const std::exception&) {
+                    // the train was deleted (or could not be saved) meanwhile , the next slice tries again
+                }
+            }
+            std::lock_guard<std::mutex> stopping(defragMutex);
+            if(stopDefrag)
+                return;
+        }
+        lock.lock();
+    }
+}
+
+DefragReport TicketService::defragmentSeats(const int& trainId, const int& travelDate, const int& maxSteps, const bool& apply)
+{
+    auto guard = trainService->lockTrain(trainId);
+    DefragReport report = retryOnConflict([&] {
+        auto train = trainService->getTrain(trainId);
+        SeatAllocator* inventory = train.findSeatAllocator(travelDate);
+        if(inventory == nullptr)
+            return DefragReport{}; // nothing booked on that date
+
+        DefragReport slice = inventory->defragment(maxSteps, apply);
+        if(apply && !slice.moves.empty())
+            trainService->save(train);
+        return slice;
+    });
+    if(!apply || report.moves.empty())
+        return report;
+
+    // follow the moved passengers : tickets get their new seat , holds their new seat number
+    for(const auto& move : report.moves){
+        if(move.holdId != 0){
+            std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+            auto it = activeHolds.find(move.holdId);
+            if(it != activeHolds.end())
+                (*it).second.seatNumber = move.toSeat;
+            continue;
+        }
+        // the booked ticket on that seat , a cancelled one of the same passenger and date keeps its old seat
+        for(Ticket ticket : ticketRepository->getTicketsByPassenger(move.passengerId)){
+            if(ticket.getTrainId() != trainId || ticket.getTravelDate() != travelDate ||
+               ticket.getStatus() != booked || ticket.getSeat() != move.fromSeat)
+                continue;
+            ticket.setSeat(move.toSeat);
+            ticketRepository->save(ticket);
+            break;
+        }
+    }
+    return report;
+}
+
+int TicketService::getActiveHoldCount() const
+{
+    std::lock_guard<std::mutex> holdsGuard(holdsMutex);
+    return activeHolds.size();
+}
+
+void TicketService::setClock(std::function<long long()> nowMs)
+{
+    clock = std::move(nowMs);
+}
+
+void TicketService::setConcurrencyMode(ConcurrencyMode mode)
+{
+    this->mode = mode;
+}
+
+void TicketService::setThreadPool(WorkStealingPool* pool)
+{
+    this->pool = pool;
+}
+
+WorkStealingPool* TicketService::getThreadPool() const
+{
+    return pool;
+}
+
+void TicketService::setEventBus(EventBus* bus)
+{
+    events = bus;
+}
+
+void TicketService::publish(const Event& event)
+{
+    if(events)
+        events->publish(event);
+}
+
+ConcurrencyMode TicketService::getConcurrencyMode() const
+{
+    return mode;
+}
+
+const RetryStats& TicketService::getRetryStats() const
+{
+    return retryStats;
+}
@@ -5,6 +5,7 @@
 #include "Services/TrainService.h"
 #include "utils/helpers.h"
 #include <stdexcept> //for run time exception
+#include <algorithm>
 
 Train TrainService::getTrain(const int& trainId) {
     auto t =  trainRepository->getTrainById(trainId);
@@ -18,6 +19,10 @@ TrainService::TrainService(ITrainRepository *repo) {
     this->trainRepository = repo;
 }
 
+std::unique_lock<std::recursive_mutex> TrainService::lockTrain(int trainId) {
+    return trainLocks.lock(trainId);
+}
+
 TrainService::~TrainService() {
     // do not delete repo because service is not owning the  repo it just use it
 }
@@ -26,16 +31,83 @@ vector<Train> TrainService::getAllTrains() {
     return trainRepository->getAllTrains();
 }
 
+vector<Train> TrainService::getTrainsPage(int afterId, int limit) {
+    return trainRepository->getTrainsPage(afterId, limit);
+}
+
+Snapshot<Train> TrainService::snapshotTrains() {
+    return trainRepository->snapshot();
+}
+
+std::vector<TrainOccupancy> TrainService::getOccupancyReport() {
+    auto line = [](std::vector<TrainOccupancy> acc, const Train& train) {
+        SeatAllocator* seats = train.getSeatAllocator();
+        acc.push_back(TrainOccupancy{train.getTrainId(), train.getTrainName(), seats->getTotalSeats(),
+                                     seats->getAllocatedSeatCount(), seats->getWaitingListSize(),
+                                     train.getDepartureCount()});
+        return acc;
+    };
+    Snapshot<Train> snapshot = trainRepository->snapshot();
+    std::vector<TrainOccupancy> report;
+    if (pool) {
+        report = snapshot.reduce(*pool, std::vector<TrainOccupancy>{}, line,
+                                 [](std::vector<TrainOccupancy> a, std::vector<TrainOccupancy> b) {
+                                     for (auto& entry : b)
+                                         a.push_back(std::move(entry));
+                                     return a;
+                                 }, 256);
+        // blocks come back in order within a shard but shards follow each other
+        std::sort(report.begin(), report.end(), [](const TrainOccupancy& a, const TrainOccupancy& b) {
+            return a.trainId < b.trainId;
+        });
+    }
+    else
+        snapshot.forEach([&](const Train& train) { report = line(std::move(report), train); });
+    return report;
+}
+
+void TrainService::setThreadPool(WorkStealingPool* pool) {
+    this->pool = pool;
+}
+
+void TrainService::setEventBus(EventBus* bus) {
+    this->events = bus;
+}
+
+void TrainService::publish(EventType type, int trainId, int seats) {
+    if(!events)
+        return;
+    Event event;
+    event.type = type;
+    event.trainId = trainId;
+    event.seats = seats;
+    events->publish(event);
+}
+
 Train TrainService::createTrain(const std::string& name,int seats) {
     Train t(0,name ,seats);
     trainRepository->save(t); // save the train  and give id by the repo
+    publish(EventType::TrainAdded, t.getTrainId(), t.getTotalSeats());
     return t;
 }
 
+void TrainService::importTrains(std::vector<Train> &trains) {
+    vector<Train> batch;
+    for (auto &train : trains)
+        batch.push_back(train);
+    trainRepository->saveAll(batch); // one write for the batch
+    for (size_t i = 0; i < batch.size(); i++) {
+        trains[i] = batch[i];
+        publish(EventType::TrainAdded, trains[i].getTrainId(), trains[i].getTotalSeats());
+    }
+}
+
 void TrainService::deleteTrain(int trainId) {
+    auto guard = lockTrain(trainId);
     bool deleted = trainRepository->deleteTrain(trainId);
     if (!deleted)
         throw std::out_of_range("failed to delete train with id : " + std::to_string(trainId));
+    publish(EventType::TrainDeleted, trainId);
 }
 
 bool TrainService::isAvailbleSeat(int trainId) {
@@ -44,31 +116,43 @@ bool TrainService::isAvailbleSeat(int trainId) {
 }
 
 void TrainService::save(Train &train) {
-    trainRepository->save(train);
+    if(!trainRepository->compareAndSave(train))
+        throw ConcurrencyConflict("train with id : " + std::to_string(train.getTrainId()) + " was changed by another writer");
 }
 
-Train TrainService::updateTrain(const int &trainId, const std::string &name, int seats) {
-    auto train = this->getTrain(trainId);
-
-    // update name
-    if(!name.empty())
-        train.setTrainName(name);
-    // update seats
-    if(seats != 0)
-        train.setSeats(seats);
+Train TrainService::modifyTrain(int trainId, const std::function<void(Train&)>& change) {
+    auto guard = lockTrain(trainId);
+    return retryOnConflict([&] {
+        auto train = this->getTrain(trainId);
+        change(train);
+        save(train);
+        return train;
+    });
+}
 
-    auto& updated =train;
-    trainRepository->save(updated);
+Train TrainService::updateTrain(const int &trainId, const std::string &name, int seats) {
+    int added = 0;
+    Train updated = modifyTrain(trainId, [&](Train& train) {
+        int before = train.getTotalSeats();
+        // update name
+        if(!name.empty())
+            train.setTrainName(name);
+        // update seats
+        if(seats != 0)
+            train.setSeats(seats);
+        added = train.getTotalSeats() - before;
+    });
+    if(added > 0)
+        publish(EventType::SeatsAdded, trainId, added);
     return updated;
 }
 
 Train TrainService::addSeats(const int trainId, const int seats) {
-    auto train =this->getTrain(trainId);;
-
-    train.addSeats(seats);
-    trainRepository->save(train);
-
-    return train;
+    Train updated = modifyTrain(trainId, [&](Train& train) {
+        train.addSeats(seats);
+    });
+    publish(EventType::SeatsAdded, trainId, seats);
+    return updated;
 }
 
 Train TrainService::addSeats(const std::string name, const int seats) {
@@ -87,8 +171,62 @@ Train TrainService::addSeats(const std::string name, const int seats) {
 
 }
 
-void TrainService::printStatus(int trainId) {
+Train TrainService::setCoachLayout(const int trainId, const vector<CoachSpec>& coaches) {
+    return modifyTrain(trainId, [&](Train& train) {
+        train.setCoachLayout(coaches);
+    });
+}
+
+std::vector<std::pair<int, int>> TrainService::takeWaitingPassengers(int trainId, int count) {
+    std::vector<std::pair<int, int>> taken;
+    modifyTrain(trainId, [&](Train& train) {
+        taken.clear(); // a retry starts over from the stored lists
+        auto take = [&](int travelDate, SeatAllocator* inventory) {
+            inventory->processWaitingList(count, [&](int passengerId) { taken.push_back({travelDate, passengerId}); });
+        };
+        // every inventory gained the seats , each one's waiting list gets its share
+        take(0, train.getSeatAllocator());
+        for(int travelDate : train.getDepartureDates())
+            take(travelDate, train.findSeatAllocator(travelDate));
+    });
+    return taken;
+}
+
+int TrainService::getClassAvailability(const int trainId, const std::string& seatClass, const int travelDate) {
     auto train = this->getTrain(trainId);
+    return train.getClassAvailability(seatClass, travelDate);
+}
 
-    train.trainStatus();
+Train TrainService::tagSeats(const int trainId, const int fromSeat, const int toSeat, const unsigned attributes) {
+    return modifyTrain(trainId, [&](Train& train) {
+        train.tagSeats(fromSeat, toSeat, attributes);
+    });
+}
+
+void TrainService::printStatus(int trainId, int travelDate) {
+    auto train = this->getTrain(trainId);
+
+    train.trainStatus(travelDate);
+}
+
+int TrainService::evictDatesBefore(int travelDate) {
+    if(!isValidDate(travelDate))
+        throw std::invalid_argument("invalid date");
+
+    int evicted = 0;
+    for(auto &snapshot : trainRepository->getAllTrains()){
+        if(snapshot.getDepartureCount() == 0)
+            continue;
+        auto guard = lockTrain(snapshot.getTrainId());
+        evicted += retryOnConflict([&] {
+            auto current = trainRepository->getTrainById(snapshot.getTrainId()); // fresh copy under the lock
+            if(!current.has_value())
+                return 0;
+            int count = current->evictDatesBefore(travelDate);
+            if(count > 0)
+                save(current.value());
+            return count;
+        });
+    }
+    return evicted;
 }
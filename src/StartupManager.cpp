@@ -5,6 +5,27 @@
 #include "Repo/InMemoryTrainRepository.h"
 #include "Repo/InMemoryTicketRepository.h"
 #include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/SharedTrainRepository.h"
+#include "Repo/SharedTicketRepository.h"
+#include "Repo/SharedPassengerRepository.h"
+#include "Repo/ShardedTrainRepository.h"
+#include "Repo/ShardedTicketRepository.h"
+#include "Repo/DurableTrainRepository.h"
+#include "Repo/DurableTicketRepository.h"
+#include "Repo/DurablePassengerRepository.h"
+#include "Repo/SqliteTrainRepository.h"
+#include "Repo/SqliteTicketRepository.h"
+#include "Repo/SqlitePassengerRepository.h"
+#include "Repo/CachedTrainRepository.h"
+#include "Repo/CachedTicketRepository.h"
+#include "Repo/CachedPassengerRepository.h"
+#include "Repo/TieredTicketRepository.h"
+#include "Repo/ReadOnlyTrainRepository.h"
+#include "Repo/ReadOnlyTicketRepository.h"
+#include "Repo/ReadOnlyPassengerRepository.h"
+#include "utils/helpers.h"
+#include <stdexcept>
+#include <sys/stat.h>
 void loadMockData(RMSFacade* facade) {
     // ---- Add Trains ----
     facade->addTrain("Alex NightLine", 30);
@@ -44,21 +65,386 @@ RMSFacade *StartupManager::buildFacade() {
 
     // build repos
     // liskov principle
-    this->trainRepository= std::make_unique<InMemoryTrainRepository>();
-    this->ticketRepository= std::make_unique<InMemoryTicketRepository>();
-    this->passengerRepository= std::make_unique<InMemoryPassengerRepository>();
+    bool seed = true;
+    if (!replicaOf.empty()) {
+        auto trains = std::make_unique<InMemoryTrainRepository>();
+        auto tickets = std::make_unique<InMemoryTicketRepository>();
+        auto passengers = std::make_unique<InMemoryPassengerRepository>();
+        // the replica writes below the read-only layer the services get
+        this->logReplica = std::make_unique<LogReplica>(trains.get(), tickets.get(), passengers.get(), replicaOf, replicaOptions);
+        this->trainRepository = std::make_unique<ReadOnlyTrainRepository>(std::move(trains));
+        this->ticketRepository = std::make_unique<ReadOnlyTicketRepository>(std::move(tickets));
+        this->passengerRepository = std::make_unique<ReadOnlyPassengerRepository>(std::move(passengers));
+        seed = false; // the primary's rows arrive instead
+    } else if (!sharedMemoryName.empty()) {
+        this->sharedSegment = std::make_unique<SharedSegment>(sharedMemoryName, sharedMemoryOptions);
+        this->trainRepository = std::make_unique<SharedTrainRepository>(sharedSegment.get());
+        this->ticketRepository = std::make_unique<SharedTicketRepository>(sharedSegment.get());
+        this->passengerRepository = std::make_unique<SharedPassengerRepository>(sharedSegment.get());
+        seed = sharedSegment->isCreator(); // the others join the inventory as it is
+    } else if (!walPath.empty()) {
+        this->writeAheadLog = std::make_unique<WriteAheadLog>(walPath, walOptions);
+        auto trains = std::make_unique<DurableTrainRepository>(std::make_unique<InMemoryTrainRepository>(), writeAheadLog.get());
+        auto tickets = std::make_unique<DurableTicketRepository>(std::make_unique<InMemoryTicketRepository>(), writeAheadLog.get());
+        auto passengers = std::make_unique<DurablePassengerRepository>(std::make_unique<InMemoryPassengerRepository>(), writeAheadLog.get());
+        auto apply = [&](const WalRecord& record) {
+            switch (record.table) {
+            case WalTable::Trains: trains->apply(record); break;
+            case WalTable::Tickets: tickets->apply(record); break;
+            case WalTable::Passengers: passengers->apply(record); break;
+            }
+        };
+        // rebuild the state the logs describe , the last checkpoint first , then log from there on
+        size_t replayed = 0;
+        if (checkpointOptions) {
+            this->checkpointLog = std::make_unique<WriteAheadLog>(walPath + ".checkpoint");
+            replayed += checkpointLog->replay(apply);
+            // already checkpointed , only what the write-ahead log replays is new to the next one
+            trains->takeDirty(trains->lockWrites());
+            tickets->takeDirty(tickets->lockWrites());
+            passengers->takeDirty(passengers->lockWrites());
+        }
+        replayed += writeAheadLog->replay(apply);
+        if (checkpointOptions)
+            this->checkpointer = std::make_unique<Checkpointer>(trains.get(), tickets.get(), passengers.get(),
+                                                                writeAheadLog.get(), checkpointLog.get(), *checkpointOptions);
+        this->trainRepository = std::move(trains);
+        this->ticketRepository = std::move(tickets);
+        this->passengerRepository = std::move(passengers);
+        seed = replayed == 0;
+    } else if (!sqlitePath.empty()) {
+        this->sqliteDatabase = std::make_unique<SqliteDatabase>(sqlitePath, sqliteOptions);
+        this->trainRepository = std::make_unique<SqliteTrainRepository>(sqliteDatabase.get());
+        this->ticketRepository = std::make_unique<SqliteTicketRepository>(sqliteDatabase.get());
+        this->passengerRepository = std::make_unique<SqlitePassengerRepository>(sqliteDatabase.get());
+        seed = trainRepository->getTrainsPage(0, 1).size() == 0 && passengerRepository->getAllPassengers().size() == 0;
+    } else {
+        if (shardCount > 0) {
+            this->repositoryShards = std::make_unique<RepositoryShards>(shardCount);
+            this->trainRepository = std::make_unique<ShardedTrainRepository>(repositoryShards.get());
+            this->ticketRepository = std::make_unique<ShardedTicketRepository>(repositoryShards.get());
+        } else {
+            this->trainRepository= std::make_unique<InMemoryTrainRepository>();
+            this->ticketRepository= std::make_unique<InMemoryTicketRepository>();
+        }
+        this->passengerRepository= std::make_unique<InMemoryPassengerRepository>();
+        struct stat info{};
+        if (!snapshotPath.empty() && ::stat(snapshotPath.c_str(), &info) == 0) {
+            MappedSnapshot(snapshotPath).restore(*trainRepository, *passengerRepository, *ticketRepository);
+            seed = false;
+        }
+    }
+    if (cacheOptions) {
+        this->trainRepository = std::make_unique<CachedTrainRepository>(std::move(trainRepository), *cacheOptions);
+        this->ticketRepository = std::make_unique<CachedTicketRepository>(std::move(ticketRepository), *cacheOptions);
+        this->passengerRepository = std::make_unique<CachedPassengerRepository>(std::move(passengerRepository), *cacheOptions);
+    }
+    if (!archivePath.empty()) {
+        this->ticketArchive = std::make_unique<TicketArchive>(archivePath);
+        auto tiered = std::make_unique<TieredTicketRepository>(std::move(ticketRepository), ticketArchive.get());
+        this->tieredTickets = tiered.get();
+        if (archiveEveryMs > 0)
+            tiered->archiveEvery(archiveEveryMs);
+        this->ticketRepository = std::move(tiered);
+    }
+    if (!shipPath.empty())
+        this->logShipper = std::make_unique<LogShipper>(writeAheadLog.get(), trainRepository.get(), ticketRepository.get(),
+                                                        passengerRepository.get(), shipPath, shippingOptions);
 
     // build services
     //dependancy injection  + giving access (only not the ownership) to the services
     this->trainService = std::make_unique<TrainService>(trainRepository.get());
     this->passengerService = std::make_unique<PassengerService>(passengerRepository.get());
     this->ticketService = std::make_unique<TicketService>(ticketRepository.get(),trainService.get(),passengerService.get());
+    ticketService->setConcurrencyMode(concurrencyMode);
+    if (holdExpiryBatch > 0)
+        ticketService->expireHoldsInBackground(holdExpiryBatch);
+    if (defragIntervalMs > 0)
+        ticketService->defragmentInBackground(defragIntervalMs, defragMaxSteps);
+
+    // one pool shared by the services for scans , reports and bulk booking
+    this->workerPool = std::make_unique<WorkStealingPool>(workerThreads);
+    trainService->setThreadPool(workerPool.get());
+    ticketService->setThreadPool(workerPool.get());
+
+    // changes go out on the bus , the log (if any) subscribes before the mock data is loaded
+    this->eventBus = std::make_unique<EventBus>();
+    trainService->setEventBus(eventBus.get());
+    ticketService->setEventBus(eventBus.get());
+    if (!eventLogPath.empty())
+        this->eventLog = std::make_unique<EventLogSink>(eventBus.get(), eventLogPath);
 
     // build facade + dependancy injection
     // give facade access to the services
     this->facade = std::make_unique<RMSFacade>(trainService.get(),ticketService.get(),passengerService.get());
-    loadMockData(facade.get());
+    if (seed)
+        loadMockData(facade.get());
 
     // allow acces to facade
     return facade.get();
 }
+
+void StartupManager::setWorkerThreads(int threads) {
+    if (threads < 0)
+        throw std::invalid_argument("worker threads cannot be negative");
+    if (facade)
+        throw std::logic_error("worker threads must be set before buildFacade");
+    this->workerThreads = threads;
+}
+
+void StartupManager::useHoldExpiry(int maxBatch) {
+    if (maxBatch <= 0)
+        throw std::invalid_argument("hold expiry batch must be greater than zero");
+    if (facade)
+        throw std::logic_error("hold expiry must be chosen before buildFacade");
+    this->holdExpiryBatch = maxBatch;
+}
+
+void StartupManager::useDefragmentation(int intervalMs, int maxSteps) {
+    if (intervalMs <= 0 || maxSteps <= 0)
+        throw std::invalid_argument("defragmentation interval and steps must be greater than zero");
+    if (facade)
+        throw std::logic_error("defragmentation must be chosen before buildFacade");
+    this->defragIntervalMs = intervalMs;
+    this->defragMaxSteps = maxSteps;
+}
+
+WorkStealingPool *StartupManager::getWorkerPool() const {
+    return workerPool.get();
+}
+
+void StartupManager::setConcurrencyMode(ConcurrencyMode mode) {
+    if (facade)
+        throw std::logic_error("concurrency mode must be set before buildFacade");
+    this->concurrencyMode = mode;
+}
+
+void StartupManager::useSharedMemory(const std::string &name, const SharedSegmentOptions &options) {
+    if (name.empty())
+        throw std::invalid_argument("shared memory name cannot be empty");
+    if (facade)
+        throw std::logic_error("shared memory must be chosen before buildFacade");
+    if (!walPath.empty())
+        throw std::logic_error("shared memory and a write-ahead log cannot be combined");
+    if (!snapshotPath.empty())
+        throw std::logic_error("shared memory and a snapshot cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("shared memory and a SQLite database cannot be combined");
+    if (cacheOptions)
+        throw std::logic_error("shared memory and a cache cannot be combined");
+    if (!archivePath.empty())
+        throw std::logic_error("shared memory and a ticket archive cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("shared memory and a replica cannot be combined");
+    if (shardCount > 0)
+        throw std::logic_error("shared memory and sharded repositories cannot be combined");
+    this->sharedMemoryName = name;
+    this->sharedMemoryOptions = options;
+}
+
+void StartupManager::useShardedRepositories(int shards) {
+    if (shards <= 0)
+        throw std::invalid_argument("Shard count must be greater than zero");
+    if (facade)
+        throw std::logic_error("sharded repositories must be chosen before buildFacade");
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and sharded repositories cannot be combined");
+    if (!walPath.empty())
+        throw std::logic_error("a write-ahead log and sharded repositories cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("a SQLite database and sharded repositories cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and sharded repositories cannot be combined");
+    this->shardCount = shards;
+}
+
+void StartupManager::useWriteAheadLog(const std::string &path, const WalOptions &options) {
+    if (path.empty())
+        throw std::invalid_argument("write-ahead log path cannot be empty");
+    if (facade)
+        throw std::logic_error("write-ahead log must be chosen before buildFacade");
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a write-ahead log cannot be combined");
+    if (!snapshotPath.empty())
+        throw std::logic_error("a snapshot and a write-ahead log cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("a SQLite database and a write-ahead log cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and a write-ahead log cannot be combined");
+    if (shardCount > 0)
+        throw std::logic_error("a write-ahead log and sharded repositories cannot be combined");
+    this->walPath = path;
+    this->walOptions = options;
+}
+
+WriteAheadLog *StartupManager::getWriteAheadLog() const {
+    return writeAheadLog.get();
+}
+
+void StartupManager::useCheckpoints(const CheckpointOptions &options) {
+    if (options.intervalMs <= 0 || options.rewriteRatio <= 1)
+        throw std::invalid_argument("Checkpoint interval must be greater than zero and the rewrite ratio greater than one");
+    if (facade)
+        throw std::logic_error("checkpoints must be chosen before buildFacade");
+    if (walPath.empty())
+        throw std::logic_error("checkpoints need a write-ahead log , choose it first");
+    this->checkpointOptions = options;
+}
+
+CheckpointStats StartupManager::checkpoint() {
+    if (!checkpointer)
+        throw std::logic_error("no checkpoints , choose them with useCheckpoints before buildFacade");
+    return checkpointer->checkpoint();
+}
+
+Checkpointer *StartupManager::getCheckpointer() const {
+    return checkpointer.get();
+}
+
+void StartupManager::useSnapshot(const std::string &path) {
+    if (path.empty())
+        throw std::invalid_argument("snapshot path cannot be empty");
+    if (facade)
+        throw std::logic_error("snapshot must be chosen before buildFacade");
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a snapshot cannot be combined");
+    if (!walPath.empty())
+        throw std::logic_error("a snapshot and a write-ahead log cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("a SQLite database and a snapshot cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and a snapshot cannot be combined");
+    this->snapshotPath = path;
+}
+
+std::future<SnapshotFileStats> StartupManager::saveSnapshot(const std::string &path) const {
+    if (!facade)
+        throw std::logic_error("nothing to snapshot before buildFacade");
+    // three views taken one after the other , not one cut : tickets go first so a booking racing
+    // with them can at worst leave a seat taken without its ticket , never a ticket without its seat
+    Snapshot<Ticket> tickets = ticketRepository->snapshot();
+    vector<Passenger> passengers = passengerRepository->getAllPassengers();
+    Snapshot<Train> trains = trainRepository->snapshot();
+    return writeSnapshotFileAsync(path, std::move(trains), std::move(passengers), std::move(tickets));
+}
+
+void StartupManager::useSqlite(const std::string &path, const SqliteOptions &options) {
+    if (path.empty())
+        throw std::invalid_argument("SQLite database path cannot be empty");
+    if (facade)
+        throw std::logic_error("SQLite database must be chosen before buildFacade");
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a SQLite database cannot be combined");
+    if (!walPath.empty())
+        throw std::logic_error("a SQLite database and a write-ahead log cannot be combined");
+    if (!snapshotPath.empty())
+        throw std::logic_error("a SQLite database and a snapshot cannot be combined");
+    if (!archivePath.empty())
+        throw std::logic_error("a SQLite database and a ticket archive cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and a SQLite database cannot be combined");
+    if (shardCount > 0)
+        throw std::logic_error("a SQLite database and sharded repositories cannot be combined");
+    this->sqlitePath = path;
+    this->sqliteOptions = options;
+}
+
+void StartupManager::useCache(const CacheOptions &options) {
+    if (options.capacity == 0 || options.flushIntervalMs <= 0 || options.maxDirty == 0)
+        throw std::invalid_argument("cache capacity , flush interval and dirty limit must be greater than zero");
+    if (facade)
+        throw std::logic_error("cache must be chosen before buildFacade");
+    // other processes write the segment directly , a private copy of their records goes stale
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a cache cannot be combined");
+    // the replica writes below it
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and a cache cannot be combined");
+    this->cacheOptions = options;
+}
+
+void StartupManager::useTicketArchive(const std::string &path, int archiveEveryMs) {
+    if (path.empty())
+        throw std::invalid_argument("ticket archive path cannot be empty");
+    if (archiveEveryMs < 0)
+        throw std::invalid_argument("archive interval cannot be negative");
+    if (facade)
+        throw std::logic_error("ticket archive must be chosen before buildFacade");
+    // other processes read the segment's tickets , a SQLite database keeps cold rows on disk already
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a ticket archive cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("a SQLite database and a ticket archive cannot be combined");
+    if (!replicaOf.empty())
+        throw std::logic_error("a replica and a ticket archive cannot be combined");
+    this->archivePath = path;
+    this->archiveEveryMs = archiveEveryMs;
+}
+
+void StartupManager::useLogShipping(const std::string &path, const ShippingOptions &options) {
+    if (path.empty())
+        throw std::invalid_argument("log shipping path cannot be empty");
+    if (options.heartbeatMs <= 0 || options.maxBufferBytes == 0)
+        throw std::invalid_argument("heartbeat interval and replica buffer must be greater than zero");
+    if (facade)
+        throw std::logic_error("log shipping must be chosen before buildFacade");
+    if (walPath.empty())
+        throw std::logic_error("log shipping needs a write-ahead log , choose it first");
+    this->shipPath = path;
+    this->shippingOptions = options;
+}
+
+LogShipper *StartupManager::getLogShipper() const {
+    return logShipper.get();
+}
+
+void StartupManager::useReplicaOf(const std::string &path, const ReplicaOptions &options) {
+    if (path.empty())
+        throw std::invalid_argument("replica path cannot be empty");
+    if (options.retryMs <= 0)
+        throw std::invalid_argument("replica retry interval must be greater than zero");
+    if (facade)
+        throw std::logic_error("replica must be chosen before buildFacade");
+    if (!sharedMemoryName.empty())
+        throw std::logic_error("shared memory and a replica cannot be combined");
+    if (!walPath.empty())
+        throw std::logic_error("a replica and a write-ahead log cannot be combined");
+    if (!snapshotPath.empty())
+        throw std::logic_error("a replica and a snapshot cannot be combined");
+    if (!sqlitePath.empty())
+        throw std::logic_error("a replica and a SQLite database cannot be combined");
+    if (cacheOptions)
+        throw std::logic_error("a replica and a cache cannot be combined");
+    if (!archivePath.empty())
+        throw std::logic_error("a replica and a ticket archive cannot be combined");
+    if (shardCount > 0)
+        throw std::logic_error("a replica and sharded repositories cannot be combined");
+    this->replicaOf = path;
+    this->replicaOptions = options;
+}
+
+LogReplica *StartupManager::getLogReplica() const {
+    return logReplica.get();
+}
+
+size_t StartupManager::archiveTickets() {
+    if (tieredTickets == nullptr)
+        throw std::logic_error("no ticket archive , choose one with useTicketArchive before buildFacade");
+    return tieredTickets->archiveTickets(todayDate());
+}
+
+TicketArchive *StartupManager::getTicketArchive() const {
+    return ticketArchive.get();
+}
+
+EventBus *StartupManager::getEventBus() const {
+    return eventBus.get();
+}
+
+void StartupManager::useEventLog(const std::string &path) {
+    if (path.empty())
+        throw std::invalid_argument("event log path cannot be empty");
+    if (facade)
+        throw std::logic_error("event log must be chosen before buildFacade");
+    this->eventLogPath = path;
+}
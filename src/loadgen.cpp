@@ -0,0 +1,134 @@
+// rms_loadgen : closed-loop load against a system built by StartupManager
+//
+//   rms_loadgen [--threads=N] [--duration=ms] [--warmup=ms] [--mix=book:60,cancel:10,lookup:25,list:5]
+//               [--zipf=S] [--trains=N] [--seats=N] [--passengers=N] [--seed=N] [--workers=N]
+//               [--concurrency=locking|optimistic|claims]
+
+#include "StartupManager.h"
+#include "LoadGenerator.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+static void usage()
+{
+    std::cout << "usage: rms_loadgen [--threads=N] [--duration=ms] [--warmup=ms]\n"
+                 "                   [--mix=book:60,cancel:10,lookup:25,list:5] [--zipf=S]\n"
+                 "                   [--trains=N] [--seats=N] [--passengers=N] [--seed=N] [--workers=N]\n"
+                 "                   [--concurrency=locking|optimistic|claims]\n";
+}
+
+// "book:60,cancel:10" , operations left out get weight 0
+static LoadMix parseMix(const std::string &text)
+{
+    LoadMix mix{0, 0, 0, 0};
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos)
+            throw std::invalid_argument("mix entry needs op:weight , got " + item);
+        std::string op = item.substr(0, colon);
+        int weight = std::stoi(item.substr(colon + 1));
+        if (op == "book")
+            mix.book = weight;
+        else if (op == "cancel")
+            mix.cancel = weight;
+        else if (op == "lookup")
+            mix.lookup = weight;
+        else if (op == "list")
+            mix.list = weight;
+        else
+            throw std::invalid_argument("unknown operation in mix: " + op);
+    }
+    return mix;
+}
+
+static void printReport(const LoadOptions &options, const LoadReport &report)
+{
+    std::cout << "\n" << options.threads << " clients , " << options.trains << " trains x " << options.seatsPerTrain
+              << " seats , " << options.passengers << " passengers , zipf " << options.zipfSkew << "\n";
+    std::cout << std::fixed << std::setprecision(1)
+              << "measured " << report.elapsedMs << " ms , " << report.completed << " calls , "
+              << std::setprecision(0) << report.throughput() << " calls/s\n\n";
+    std::cout << std::left << std::setw(8) << "op" << std::right
+              << std::setw(10) << "calls" << std::setw(10) << "failed" << std::setw(12) << "waitlisted"
+              << std::setw(12) << "calls/s" << std::setw(11) << "p50 us" << std::setw(11) << "p99 us"
+              << std::setw(11) << "p999 us" << std::setw(11) << "max us" << "\n";
+    for (int i = 0; i < LOAD_OP_COUNT; i++)
+    {
+        const LoadOpReport &op = report.ops[i];
+        double rate = report.elapsedMs > 0 ? op.completed * 1000.0 / report.elapsedMs : 0;
+        std::cout << std::left << std::setw(8) << loadOpName((LoadOp)i) << std::right
+                  << std::setw(10) << op.completed << std::setw(10) << op.failed << std::setw(12) << op.waitlisted
+                  << std::setprecision(0) << std::setw(12) << rate << std::setprecision(1)
+                  << std::setw(11) << op.p50Us << std::setw(11) << op.p99Us
+                  << std::setw(11) << op.p999Us << std::setw(11) << op.maxUs << "\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    int workers = 0;
+    ConcurrencyMode concurrency = ConcurrencyMode::Locking;
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            std::string key = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            if (key == "--help")
+            {
+                usage();
+                return 0;
+            }
+            if (value.empty())
+                throw std::invalid_argument("missing value for " + key);
+            if (key == "--threads")
+                options.threads = std::stoi(value);
+            else if (key == "--duration")
+                options.durationMs = std::stoi(value);
+            else if (key == "--warmup")
+                options.warmupMs = std::stoi(value);
+            else if (key == "--mix")
+                options.mix = parseMix(value);
+            else if (key == "--zipf")
+                options.zipfSkew = std::stod(value);
+            else if (key == "--trains")
+                options.trains = std::stoi(value);
+            else if (key == "--seats")
+                options.seatsPerTrain = std::stoi(value);
+            else if (key == "--passengers")
+                options.passengers = std::stoi(value);
+            else if (key == "--seed")
+                options.seed = (unsigned)std::stoul(value);
+            else if (key == "--workers")
+                workers = std::stoi(value);
+            else if (key == "--concurrency")
+                concurrency = parseConcurrencyMode(value);
+            else
+                throw std::invalid_argument("unknown option " + key);
+        }
+
+        StartupManager manager;
+        manager.setWorkerThreads(workers);
+        manager.setConcurrencyMode(concurrency);
+        RMSFacade *facade = manager.buildFacade();
+        LoadFixture fixture = prepareLoad(*facade, options);
+        std::cout << "warming up " << options.warmupMs << " ms , measuring " << options.durationMs << " ms\n";
+        printReport(options, runClosedLoop(*facade, fixture, options));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "rms_loadgen: " << e.what() << "\n";
+        usage();
+        return 1;
+    }
+    return 0;
+}
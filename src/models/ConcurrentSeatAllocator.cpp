@@ -0,0 +1,197 @@
+#include "models/ConcurrentSeatAllocator.h"
+#include <stdexcept>
+#include <string>
+#include <bit>
+
+static constexpr size_t WORD = 64;
+
+ConcurrentSeatAllocator::ConcurrentSeatAllocator(int totalSeats)
+{
+    this->totalSeats = totalSeats <= 0 ? 10 : totalSeats; // same default as SeatAllocator
+    wordCount = (this->totalSeats + 1 + WORD - 1) / WORD;
+    freeWords = std::make_unique<std::atomic<uint64_t>[]>(wordCount);
+    owners = std::make_unique<std::atomic<int>[]>(this->totalSeats + 1);
+    for (size_t w = 0; w < wordCount; w++)
+    {
+        uint64_t word = ~0ULL;
+        if (w == 0)
+            word &= ~1ULL; // seat 0 does not exist
+        size_t last = (size_t)this->totalSeats;
+        if (w == last / WORD && last % WORD != WORD - 1)
+            word &= (1ULL << (last % WORD + 1)) - 1;
+        freeWords[w].store(word, std::memory_order_relaxed);
+    }
+    for (int seat = 0; seat <= this->totalSeats; seat++)
+        owners[seat].store(0, std::memory_order_relaxed);
+    freeCount.store(this->totalSeats, std::memory_order_release);
+}
+
+ConcurrentSeatAllocator::ConcurrentSeatAllocator(const Bitset &freeSeats)
+    : ConcurrentSeatAllocator(freeSeats.size() > 1 ? (int)freeSeats.size() - 1 : 0)
+{
+    if (freeSeats.size() < 2)
+        throw std::invalid_argument("Seat bitmap cannot be empty.\n");
+    int taken = 0;
+    for (int seat = 1; seat <= totalSeats; seat++)
+    {
+        if (freeSeats.test(seat))
+            continue;
+        freeWords[seat / WORD].fetch_and(~(1ULL << (seat % WORD)), std::memory_order_relaxed);
+        owners[seat].store(-1, std::memory_order_relaxed);
+        taken++;
+    }
+    freeCount.store(totalSeats - taken, std::memory_order_release);
+}
+
+// takes one unit of the free counter , false when the train is full
+bool ConcurrentSeatAllocator::reserve()
+{
+    int current = freeCount.load(std::memory_order_acquire);
+    while (current > 0)
+        if (freeCount.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel))
+            return true;
+    return false;
+}
+
+// the caller holds a reservation : set bits >= free counter at all times
+// (free sets the bit before it bumps the counter) so a bit is always there to win
+int ConcurrentSeatAllocator::claim(int passengerId, size_t startWord)
+{
+    while (true)
+    {
+        for (size_t k = 0; k < wordCount; k++)
+        {
+            size_t w = (startWord + k) % wordCount;
+            uint64_t word = freeWords[w].load(std::memory_order_acquire);
+            while (word)
+            {
+                uint64_t bit = word & (~word + 1); // lowest set bit
+                if (freeWords[w].compare_exchange_weak(word, word & ~bit, std::memory_order_acq_rel))
+                {
+                    int seatNumber = (int)(w * WORD + std::countr_zero(bit));
+                    owners[seatNumber].store(passengerId, std::memory_order_release);
+                    return seatNumber;
+                }
+                // word was reloaded by the failed CAS , try its next free bit
+            }
+        }
+        // every word looked full : the bit of our reservation was freed behind the scan
+    }
+}
+
+int ConcurrentSeatAllocator::allocateSeat(int passengerId)
+{
+    int seatNumber = tryAllocateSeat(passengerId);
+    if (seatNumber == -1)
+        waitingList.push(passengerId);
+    return seatNumber;
+}
+
+int ConcurrentSeatAllocator::tryAllocateSeat(int passengerId)
+{
+    if (passengerId <= 0)
+        throw std::invalid_argument("Invalid passenger id.\n");
+    if (!reserve())
+        return -1;
+    size_t start = (size_t)((unsigned)passengerId * 2654435761u) % wordCount;
+    return claim(passengerId, start);
+}
+
+bool ConcurrentSeatAllocator::claimSeat(int seatNumber, int passengerId)
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+    if (passengerId == 0)
+        throw std::invalid_argument("Invalid passenger id.\n");
+    if (!reserve())
+        return false;
+    // the unit is taken before the bit , like claim , so scanners holding one still find a bit
+    uint64_t bit = 1ULL << (seatNumber % WORD);
+    if (!(freeWords[seatNumber / WORD].fetch_and(~bit, std::memory_order_acq_rel) & bit))
+    {
+        freeCount.fetch_add(1, std::memory_order_release);
+        return false;
+    }
+    owners[seatNumber].store(passengerId, std::memory_order_release);
+    return true;
+}
+
+int ConcurrentSeatAllocator::freeSeat(int seatNumber)
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+
+    // only one of two racing frees sees the owner
+    int passengerId = owners[seatNumber].exchange(0, std::memory_order_acq_rel);
+    if (passengerId == 0)
+        throw std::out_of_range("Seat " + std::to_string(seatNumber) + " is not allocated.\n");
+
+    freeWords[seatNumber / WORD].fetch_or(1ULL << (seatNumber % WORD), std::memory_order_release);
+    freeCount.fetch_add(1, std::memory_order_release);
+    return passengerId;
+}
+
+int ConcurrentSeatAllocator::drainWaitingList(const std::function<void(int, int)> &onSeated)
+{
+    int seated = 0;
+    while (true)
+    {
+        if (draining.test_and_set(std::memory_order_acquire))
+            return seated; // the current drainer re-checks after it lets go
+
+        int passengerId;
+        while (!waitingList.empty() && reserve())
+        {
+            if (!waitingList.tryPop(passengerId))
+            {
+                // producer still linking its node , give the unit back and retry below
+                freeCount.fetch_add(1, std::memory_order_release);
+                break;
+            }
+            int seatNumber = claim(passengerId, 0);
+            seated++;
+            if (onSeated)
+                onSeated(passengerId, seatNumber);
+        }
+        draining.clear(std::memory_order_release);
+
+        // a seat freed (or a passenger queued) while we held the flag may have
+        // lost its own drain attempt to us
+        if (waitingList.empty() || freeCount.load(std::memory_order_acquire) <= 0)
+            return seated;
+    }
+}
+
+int ConcurrentSeatAllocator::getTotalSeats() const
+{
+    return totalSeats;
+}
+
+int ConcurrentSeatAllocator::getAvailableSeatCount() const
+{
+    return freeCount.load(std::memory_order_acquire);
+}
+
+int ConcurrentSeatAllocator::getAllocatedSeatCount() const
+{
+    return totalSeats - getAvailableSeatCount();
+}
+
+int ConcurrentSeatAllocator::getWaitingListSize() const
+{
+    return waitingList.size();
+}
+
+bool ConcurrentSeatAllocator::isSeatFree(int seatNumber) const
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        return false;
+    return (freeWords[seatNumber / WORD].load(std::memory_order_acquire) >> (seatNumber % WORD)) & 1ULL;
+}
+
+int ConcurrentSeatAllocator::getSeatOwner(int seatNumber) const
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+    return owners[seatNumber].load(std::memory_order_acquire);
+}
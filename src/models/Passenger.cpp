@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include "models/Passenger.h"
 #include "utils/helpers.h"
+#include "utils/BinaryCodec.h"
 
 #include <iostream>
 using std::cout;
@@ -23,7 +24,15 @@ int Passenger::getId() const {
     return this->id;
 }
 
-std::string Passenger::getName() const {
+long long Passenger::getVersion() const {
+    return this->version;
+}
+
+void Passenger::setVersion(long long version) {
+    this->version = version;
+}
+
+const std::string &Passenger::getName() const {
     return this->name;
 }
 
@@ -47,3 +56,16 @@ void Passenger::print(const std::string &msg) const {
 
 
 
+void Passenger::encode(ByteWriter &out) const {
+    out.putInt(id);
+    out.putLong(version);
+    out.putString(name);
+}
+
+Passenger Passenger::decode(ByteReader &in) {
+    Passenger p;
+    p.id = in.getInt();
+    p.version = in.getLong();
+    p.name = in.getString();
+    return p;
+}
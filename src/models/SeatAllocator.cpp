@@ -3,29 +3,159 @@
 //
 
 #include "models/SeatAllocator.h"
+#include "utils/BinaryCodec.h"
 #include <iostream>
 #include <functional>
+#include <bit>
 
-SeatAllocator::SeatAllocator(int totalSeats)
+SeatAllocator::SeatAllocator(int totalSeats) : layout(totalSeats)
 {
     if (totalSeats <= 0)
         this->totalSeats = 10;
     else
         this->totalSeats = totalSeats;
-    //    add the seats to the set
-    for (int seat = 1; seat <= this->totalSeats; seat++)
-        availableSeats.insert(seat);
+    resetInventory();
 }
 
-int SeatAllocator::allocateSeat(int passengerId)
+SeatAllocator::SeatAllocator(const vector<CoachSpec> &coaches) : layout(coaches)
 {
-    // prevent duplicate passenger allocation
-    for (const auto &p : allocatedSeats)
+    totalSeats = layout.getTotalSeats();
+    resetInventory();
+}
+
+// every seat free , attributes from the default coach pattern
+void SeatAllocator::resetInventory()
+{
+    freeSeats = Bitset(totalSeats + 1); // bit index == seat number , bit 0 unused
+    freeSeats.setRange(1, totalSeats);
+    movableSeats = Bitset(totalSeats + 1);
+    defragCoach = 1;
+    defragLow = defragHigh = 0;
+    attributes = SeatAttributes();
+    attributes.resize(totalSeats);
+    attributes.applyDefaultPattern(layout);
+    rebuildClassMasks();
+}
+
+void SeatAllocator::rebuildClassMasks()
+{
+    classSeats.clear();
+    for (int i = 0; i < layout.getClassCount(); i++)
+        classSeats.push_back(Bitset(totalSeats + 1));
+    for (int number = 1; number <= layout.getCoachCount(); number++)
+    {
+        const SeatLayout::Coach &coach = layout.getCoach(number);
+        classSeats[coach.classIndex].setRange(coach.firstSeat, coach.firstSeat + coach.seatCount - 1);
+    }
+}
+
+void SeatAllocator::setLayout(const vector<CoachSpec> &coaches)
+{
+    if (!allocatedSeats.empty() || !holds.empty() || !waitingList.empty())
+        throw std::runtime_error("Cannot change the coach layout while seats are allocated.\n");
+
+    layout = SeatLayout(coaches);
+    totalSeats = layout.getTotalSeats();
+    resetInventory();
+    cancelledSeats = stack<int>();
+}
+
+void SeatAllocator::tagSeats(int fromSeat, int toSeat, unsigned attributeMask)
+{
+    attributes.tag(fromSeat, toSeat, attributeMask);
+}
+
+void SeatAllocator::untagSeats(int fromSeat, int toSeat, unsigned attributeMask)
+{
+    attributes.untag(fromSeat, toSeat, attributeMask);
+}
+
+int SeatAllocator::takeAnySeat()
+{
+    // prefer reusing cancelled seats first , skip entries already taken by a class/coach request
+    while (!cancelledSeats.empty())
     {
-        if (p.second == passengerId)
-            throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already has a seat.\n");
+        int seatNumber = cancelledSeats.top();
+        cancelledSeats.pop();
+        if (freeSeats.test(seatNumber))
+            return seatNumber;
     }
 
+    // smallest free seat
+    return (int)freeSeats.findFirst();
+}
+
+// free AND class AND every wanted attribute , restricted to the coach range , then find-first
+// when nothing matches exactly , drop preferences : seats matching more of them rank first ,
+// ties go to the lowest seat number
+int SeatAllocator::findPreferredSeat(const SeatRequest &request) const
+{
+    size_t from = 1, to = totalSeats;
+    if (request.coach != 0)
+    {
+        const SeatLayout::Coach &coach = layout.getCoach(request.coach);
+        from = coach.firstSeat;
+        to = coach.firstSeat + coach.seatCount - 1;
+    }
+
+    const Bitset *sets[2 + SEAT_ATTRIBUTE_COUNT];
+    size_t base = 0;
+    sets[base++] = &freeSeats;
+    if (!request.seatClass.empty())
+        sets[base++] = &classSeats[layout.findClass(request.seatClass)];
+
+    unsigned wanted = request.preferences & SEAT_ATTRIBUTE_ALL;
+    for (int matched = std::popcount(wanted); matched >= 0; matched--)
+    {
+        size_t best = Bitset::npos;
+        // every subset of the wanted attributes with exactly `matched` bits
+        for (unsigned subset = wanted;; subset = (subset - 1) & wanted)
+        {
+            if (std::popcount(subset) == matched)
+            {
+                size_t n = base;
+                for (int a = 0; a < SEAT_ATTRIBUTE_COUNT; a++)
+                    if (subset & (1u << a))
+                        sets[n++] = &attributes.bitsOf(a);
+                size_t seat = Bitset::findFirstOfAll(sets, n, from, to);
+                if (seat < best)
+                    best = seat;
+            }
+            if (subset == 0)
+                break;
+        }
+        if (best != Bitset::npos)
+            return (int)best;
+    }
+    return -1;
+}
+
+// picks a free seat for the request , the caller checked the train is not full
+int SeatAllocator::chooseSeat(const SeatRequest &request)
+{
+    if (request.seatClass.empty() && request.coach == 0 && request.preferences == 0)
+        return takeAnySeat();
+
+    // walk down the layout to a coach with room (also validates class / coach)
+    const SeatLayout::Coach *coach = layout.findCoach(request);
+    if (coach == nullptr)
+        throw std::runtime_error("No seats available for the requested class/coach.\n");
+    if (request.preferences == 0)
+        return (int)freeSeats.findNext(coach->firstSeat); // lowest free seat of that coach
+    return findPreferredSeat(request);
+}
+
+int SeatAllocator::allocateSeat(int passengerId)
+{
+    return allocateSeat(passengerId, SeatRequest{});
+}
+
+int SeatAllocator::allocateSeat(int passengerId, const SeatRequest &request)
+{
+    // prevent duplicate passenger allocation
+    if (passengerSeats.count(passengerId))
+        throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already has a seat.\n");
+
     // prevent duplicate waiting list insertion
     if (waitingSet.count(passengerId))
         throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already in waiting list.\n");
@@ -35,26 +165,39 @@ int SeatAllocator::allocateSeat(int passengerId)
     {
         waitingList.push(passengerId);
         waitingSet.insert(passengerId);
-        std::cout << "Train full, passenger added to waiting list.\n";
         return -1;
     }
 
-    int seatNumber;
+    int seatNumber = chooseSeat(request);
+    freeSeats.reset(seatNumber);
+    layout.markAllocated(seatNumber);
+    if (request.flexible)
+        movableSeats.set(seatNumber);
+    allocatedSeats[seatNumber] = passengerId;
+    passengerSeats[passengerId] = seatNumber;
+    return seatNumber;
+}
 
-    // prefer reusing cancelled seats first
-    if (!cancelledSeats.empty())
-    {
-        seatNumber = cancelledSeats.top();
-        cancelledSeats.pop();
-    }
-    else
-    {
-        // smallest seat in the set
-        seatNumber = *availableSeats.begin();
-        availableSeats.erase(availableSeats.begin());
-    }
+int SeatAllocator::allocateSeatAt(int passengerId, int seatNumber, bool flexible)
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+    if (passengerSeats.count(passengerId))
+        throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already has a seat.\n");
+    if (waitingSet.count(passengerId))
+        throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already in waiting list.\n");
+    if (!freeSeats.test(seatNumber))
+        return -1;
 
+    freeSeats.reset(seatNumber);
+    layout.markAllocated(seatNumber);
+    if (flexible)
+        movableSeats.set(seatNumber);
     allocatedSeats[seatNumber] = passengerId;
+    passengerSeats[passengerId] = seatNumber;
+    // a claim usually takes the seat just cancelled , drop it from the hint stack like takeAnySeat would
+    while (!cancelledSeats.empty() && !freeSeats.test(cancelledSeats.top()))
+        cancelledSeats.pop();
     return seatNumber;
 }
 
@@ -68,8 +211,36 @@ int SeatAllocator::freeSeat(int seatNumber)
         throw std::out_of_range("Invalid seat number.\n");
 
     // delete from the hash map and add to the stack
+    passengerSeats.erase((*it).second);
     allocatedSeats.erase(seatNumber);
+    return releaseSeat(seatNumber);
+}
+
+// back to inventory , returns the waiting passenger to book or 0
+int SeatAllocator::releaseSeat(int seatNumber)
+{
+    freeSeats.set(seatNumber);
+    movableSeats.reset(seatNumber);
     cancelledSeats.push(seatNumber);
+    // seats taken by number (class , coach or claimed requests) leave stale entries behind ,
+    // once they outnumber the seats keep only the free ones , first occurrence , same order
+    if ((int)cancelledSeats.size() > totalSeats)
+    {
+        vector<int> live;
+        Bitset seen(totalSeats + 1);
+        for (; !cancelledSeats.empty(); cancelledSeats.pop())
+        {
+            int seat = cancelledSeats.top();
+            if (freeSeats.test(seat) && !seen.test(seat))
+            {
+                seen.set(seat);
+                live.push_back(seat);
+            }
+        }
+        for (int i = (int)live.size() - 1; i >= 0; i--)
+            cancelledSeats.push(live[i]);
+    }
+    layout.markFree(seatNumber);
 
     // assign to waiting passenger if any
     if (!waitingList.empty())
@@ -77,17 +248,190 @@ int SeatAllocator::freeSeat(int seatNumber)
         int firstPassenger = waitingList.front();
         waitingList.pop();
         waitingSet.erase(firstPassenger);
-        std::cout << "\n";
-        std::cout << "Seat " << seatNumber
-                  << " freed and assigned to waiting passenger "
-                  << firstPassenger << "\n";
-
-        return firstPassenger;
+        return firstPassenger; // the service books it and publishes WaitlistPromoted
     }
 
     return 0; // no waiting passengers
 }
 
+int SeatAllocator::holdSeat(int holdId, int passengerId, long long expiresAt, const SeatRequest &request)
+{
+    if (holds.count(holdId))
+        throw std::invalid_argument("Hold " + std::to_string(holdId) + " already exists.\n");
+    if (passengerSeats.count(passengerId))
+        throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already has a seat.\n");
+    if (waitingSet.count(passengerId))
+        throw std::runtime_error("Passenger " + std::to_string(passengerId) + " already in waiting list.\n");
+
+    // a hold is never waitlisted , checkout has to know right away
+    if (!hasAvailableSeats())
+        throw std::runtime_error("No seats available to hold.\n");
+
+    int seatNumber = chooseSeat(request);
+
+    freeSeats.reset(seatNumber);
+    layout.markAllocated(seatNumber);
+    movableSeats.set(seatNumber); // unconfirmed , always movable
+    holds[holdId] = SeatHold{holdId, 0, passengerId, seatNumber, expiresAt, 0, request.flexible};
+    heldSeats[seatNumber] = holdId;
+    passengerSeats[passengerId] = seatNumber;
+    return seatNumber;
+}
+
+int SeatAllocator::confirmHold(int holdId)
+{
+    auto it = holds.find(holdId);
+    if (it == holds.end())
+        throw std::out_of_range("Invalid hold id.\n");
+
+    SeatHold hold = (*it).second;
+    holds.erase(holdId);
+    heldSeats.erase(hold.seatNumber);
+    allocatedSeats[hold.seatNumber] = hold.passengerId;
+    if (!hold.flexible)
+        movableSeats.reset(hold.seatNumber);
+    return hold.seatNumber;
+}
+
+int SeatAllocator::releaseHold(int holdId)
+{
+    auto it = holds.find(holdId);
+    if (it == holds.end())
+        throw std::out_of_range("Invalid hold id.\n");
+
+    SeatHold hold = (*it).second;
+    holds.erase(holdId);
+    heldSeats.erase(hold.seatNumber);
+    passengerSeats.erase(hold.passengerId);
+    return releaseSeat(hold.seatNumber);
+}
+
+// same coach , so the layout counts do not change
+void SeatAllocator::moveSeat(int fromSeat, int toSeat, SeatMove &move)
+{
+    freeSeats.set(fromSeat);
+    freeSeats.reset(toSeat);
+    movableSeats.reset(fromSeat);
+    movableSeats.set(toSeat);
+
+    auto booked = allocatedSeats.find(fromSeat);
+    if (booked != allocatedSeats.end())
+    {
+        move.passengerId = (*booked).second;
+        allocatedSeats.erase(fromSeat);
+        allocatedSeats[toSeat] = move.passengerId;
+    }
+    else
+    {
+        move.holdId = heldSeats.at(fromSeat);
+        SeatHold &hold = holds.at(move.holdId);
+        move.passengerId = hold.passengerId;
+        hold.seatNumber = toSeat;
+        heldSeats.erase(fromSeat);
+        heldSeats[toSeat] = move.holdId;
+    }
+    passengerSeats[move.passengerId] = toSeat;
+}
+
+DefragReport SeatAllocator::defragment(int maxSteps, bool apply)
+{
+    if (maxSteps <= 0)
+        throw std::invalid_argument("Steps must be greater than zero.\n");
+
+    DefragReport report;
+    report.largestBlockBefore = getLargestFreeBlock();
+
+    // a proposal runs on scratch copies and leaves the cursor where it was
+    Bitset scratchFree, scratchMovable;
+    if (!apply)
+    {
+        scratchFree = freeSeats;
+        scratchMovable = movableSeats;
+    }
+    Bitset &free = apply ? freeSeats : scratchFree;
+    Bitset &movable = apply ? movableSeats : scratchMovable;
+    int coachNumber = defragCoach, low = defragLow, high = defragHigh;
+
+    for (int steps = 0; steps < maxSteps; steps++)
+    {
+        if (coachNumber > layout.getCoachCount())
+        {
+            report.finished = true;
+            coachNumber = 1;
+            low = high = 0;
+            break;
+        }
+        const SeatLayout::Coach &coach = layout.getCoach(coachNumber);
+        int first = coach.firstSeat, last = coach.firstSeat + coach.seatCount - 1;
+        if (low < first || low > last || high > last)
+        {
+            low = first;
+            high = last;
+        }
+
+        // lowest hole against the highest movable passenger of the coach
+        size_t hole = free.findFirstIn(low, high);
+        size_t mover = movable.findLastIn(low, high);
+        if (hole == Bitset::npos || mover == Bitset::npos || hole > mover)
+        {
+            coachNumber++;
+            low = high = 0;
+            continue;
+        }
+
+        SeatMove move;
+        move.fromSeat = (int)mover;
+        move.toSeat = (int)hole;
+        if (apply)
+        {
+            moveSeat(move.fromSeat, move.toSeat, move);
+        }
+        else
+        {
+            free.set(mover);
+            free.reset(hole);
+            movable.reset(mover);
+            movable.set(hole);
+        }
+        report.moves.push_back(move);
+        low = (int)hole + 1;
+        high = (int)mover - 1;
+    }
+
+    if (apply)
+    {
+        defragCoach = coachNumber;
+        defragLow = low;
+        defragHigh = high;
+        report.largestBlockAfter = getLargestFreeBlock();
+    }
+    else
+    {
+        // proposal : measure the scratch inventory
+        size_t best = 0;
+        for (int number = 1; number <= layout.getCoachCount(); number++)
+        {
+            const SeatLayout::Coach &coach = layout.getCoach(number);
+            best = std::max(best, scratchFree.longestRunIn(coach.firstSeat, coach.firstSeat + coach.seatCount - 1));
+        }
+        report.largestBlockAfter = (int)best;
+        for (auto &move : report.moves)
+        {
+            auto booked = allocatedSeats.find(move.fromSeat);
+            if (booked != allocatedSeats.end())
+            {
+                move.passengerId = (*booked).second;
+            }
+            else
+            {
+                move.holdId = heldSeats.at(move.fromSeat);
+                move.passengerId = holds.at(move.holdId).passengerId;
+            }
+        }
+    }
+    return report;
+}
+
 void SeatAllocator::addSeats(int seats)
 {
     if (seats <= 0)
@@ -96,37 +440,43 @@ void SeatAllocator::addSeats(int seats)
     int oldTotal = totalSeats;
     totalSeats += seats;
 
-    for (int i = oldTotal + 1; i <= totalSeats; i++)
-        availableSeats.insert(i);
+    freeSeats.resize(totalSeats + 1);
+    freeSeats.setRange(oldTotal + 1, totalSeats);
+    movableSeats.resize(totalSeats + 1);
+    layout.grow(seats);
+    // the old last row is no longer next to the door
+    attributes.resize(totalSeats);
+    attributes.applyDefaultPattern(layout, std::max(1, oldTotal - 3));
+    rebuildClassMasks();
 }
 
 void SeatAllocator::changeTotalSeats(int newTotalSeats)
 {
-    if (newTotalSeats < getAllocatedSeatCount())
+    if (newTotalSeats < getAllocatedSeatCount() + getHeldSeatCount())
         throw std::out_of_range("Cannot shrink below allocated count.\n");
 
     if (newTotalSeats > totalSeats)
     {
         // expand
-        for (int i = totalSeats + 1; i <= newTotalSeats; i++)
-            availableSeats.insert(i);
+        addSeats(newTotalSeats - totalSeats);
+        return;
     }
-    else
+    else if (newTotalSeats < totalSeats)
     {
-        // shrink
-        int seatsToRemove = totalSeats - newTotalSeats;
-
-        if (availableSeats.size() < seatsToRemove)
-            throw std::runtime_error("Cannot shrink: not enough free seats.\n");
-
-        while (seatsToRemove-- > 0)
-        {
-            auto it = std::prev(availableSeats.end());
-            availableSeats.erase(it);
-        }
+        // shrink , the removed seats are the tail of the last coaches so they must be free
+        for (int seat = newTotalSeats + 1; seat <= totalSeats; seat++)
+            if (!freeSeats.test(seat))
+                throw std::runtime_error("Cannot shrink: seat " + std::to_string(seat) + " is allocated.\n");
+
+        freeSeats.resize(newTotalSeats + 1);
+        movableSeats.resize(newTotalSeats + 1);
+        layout.shrink(totalSeats - newTotalSeats);
+        attributes.resize(newTotalSeats);
+        attributes.applyDefaultPattern(layout, std::max(1, newTotalSeats - 3));
     }
 
     totalSeats = newTotalSeats;
+    rebuildClassMasks();
 }
 
 void SeatAllocator::printStatus() const
@@ -135,8 +485,11 @@ void SeatAllocator::printStatus() const
 
     std::cout << "Total Seats          : " << totalSeats << "\n";
     std::cout << "Allocated Seat Count : " << getAllocatedSeatCount() << "\n";
+    std::cout << "Held Seat Count      : " << getHeldSeatCount() << "\n";
     std::cout << "Available Seat Count : " << getAvailableSeatCount() << "\n\n";
 
+    layout.printStatus();
+
     // ---- Allocated Seats ----
     std::cout << "--- Allocated Seats (Seat -> Passenger ID) ---\n";
     if (allocatedSeats.empty())
@@ -153,15 +506,25 @@ void SeatAllocator::printStatus() const
     }
     std::cout << "\n";
 
+    // ---- Held Seats ----
+    if (!holds.empty())
+    {
+        std::cout << "--- Held Seats (Seat -> Passenger ID) ---\n";
+        for (const auto &h : holds)
+            std::cout << "Seat " << h.second.seatNumber << " -> Passenger " << h.second.passengerId
+                      << " (hold " << h.first << ")\n";
+        std::cout << "\n";
+    }
+
     // ---- Available Seats ----
     std::cout << "--- Available Seats ---\n";
-    if (availableSeats.empty())
+    if (!hasAvailableSeats())
     {
         std::cout << "No free seats.\n";
     }
     else
     {
-        for (int s : availableSeats)
+        for (size_t s = freeSeats.findFirst(); s != Bitset::npos; s = freeSeats.findNext(s + 1))
             std::cout << s << " ";
         std::cout << "\n";
     }
@@ -178,7 +541,8 @@ void SeatAllocator::printStatus() const
         stack<int> temp = cancelledSeats;
         while (!temp.empty())
         {
-            std::cout << temp.top() << " ";
+            if (freeSeats.test(temp.top()))
+                std::cout << temp.top() << " ";
             temp.pop();
         }
         std::cout << "\n";
@@ -207,47 +571,148 @@ void SeatAllocator::printStatus() const
 
 bool SeatAllocator::hasAvailableSeats() const
 {
-    // if the is seat in cancelled tickets or minHeap
-    //   return avaiable(true) if availableSeats or cancelledSeats is not  empty
-    return !availableSeats.empty() || !cancelledSeats.empty();
+    // cancelled seats are returned to the bitset too , so the layout count alone answers
+    return layout.getFreeSeats() > 0;
 }
 int SeatAllocator::getAvailableSeatCount() const
 {
-    //    return the numbers of seats in the heap and the cancelled seats
-    return availableSeats.size() + cancelledSeats.size();
+    return layout.getFreeSeats();
+}
+
+bool SeatAllocator::isSeatFree(int seatNumber) const
+{
+    return seatNumber > 0 && seatNumber <= totalSeats && freeSeats.test(seatNumber);
+}
+
+const Bitset &SeatAllocator::getFreeSeats() const
+{
+    return freeSeats;
+}
+
+unsigned SeatAllocator::getSeatAttributes(int seatNumber) const
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+    return attributes.attributesOf(seatNumber);
+}
+
+bool SeatAllocator::isSeatMovable(int seatNumber) const
+{
+    return seatNumber > 0 && seatNumber <= totalSeats && movableSeats.test(seatNumber);
+}
+
+int SeatAllocator::getLargestFreeBlock() const
+{
+    size_t best = 0;
+    for (int number = 1; number <= layout.getCoachCount(); number++)
+    {
+        const SeatLayout::Coach &coach = layout.getCoach(number);
+        if ((size_t)coach.freeSeats <= best)
+            continue; // cannot beat the current best
+        best = std::max(best, freeSeats.longestRunIn(coach.firstSeat, coach.firstSeat + coach.seatCount - 1));
+    }
+    return (int)best;
+}
+
+int SeatAllocator::getClassAvailableSeatCount(const std::string &seatClass) const
+{
+    return layout.getClassFreeSeats(seatClass);
+}
+
+const SeatLayout &SeatAllocator::getLayout() const
+{
+    return layout;
 }
 std::unique_ptr<SeatAllocator> SeatAllocator::clone() const
 {
     return std::make_unique<SeatAllocator>(*this);
 }
 
+std::unique_ptr<SeatAllocator> SeatAllocator::emptyCopy() const
+{
+    auto copy = std::make_unique<SeatAllocator>(1);
+    copy->totalSeats = totalSeats;
+    copy->layout = layout;
+    copy->layout.resetFree();
+    copy->attributes = attributes;
+    copy->classSeats = classSeats;
+    copy->freeSeats = Bitset(totalSeats + 1);
+    copy->freeSeats.setRange(1, totalSeats);
+    copy->movableSeats = Bitset(totalSeats + 1);
+    return copy;
+}
+
 SeatAllocator::SeatAllocator(const SeatAllocator &other)
-    : availableSeats(other.availableSeats),
+    : freeSeats(other.freeSeats),
+      layout(other.layout),
+      attributes(other.attributes),
+      classSeats(other.classSeats),
       waitingList(other.waitingList),
+      waitingSet(other.waitingSet),
       allocatedSeats(other.allocatedSeats),
+      passengerSeats(other.passengerSeats),
+      holds(other.holds),
+      heldSeats(other.heldSeats),
       cancelledSeats(other.cancelledSeats),
-      waitingSet(other.waitingSet),
+      movableSeats(other.movableSeats),
+      defragCoach(other.defragCoach),
+      defragLow(other.defragLow),
+      defragHigh(other.defragHigh),
       totalSeats(other.totalSeats) {}
 
 SeatAllocator &SeatAllocator::operator=(const SeatAllocator &other)
 {
     if (this != &other)
     {
-        availableSeats = other.availableSeats;
+        freeSeats = other.freeSeats;
+        layout = other.layout;
+        attributes = other.attributes;
+        classSeats = other.classSeats;
         waitingList = other.waitingList;
         allocatedSeats = other.allocatedSeats;
+        passengerSeats = other.passengerSeats;
+        holds = other.holds;
+        heldSeats = other.heldSeats;
         cancelledSeats = other.cancelledSeats;
+        movableSeats = other.movableSeats;
+        defragCoach = other.defragCoach;
+        defragLow = other.defragLow;
+        defragHigh = other.defragHigh;
         waitingSet = other.waitingSet;
         totalSeats = other.totalSeats;
     }
     return *this;
 }
 
+int SeatAllocator::getSeatOwner(int seatNumber) const
+{
+    auto it = allocatedSeats.find(seatNumber);
+    return it == allocatedSeats.end() ? 0 : (*it).second;
+}
+
 int SeatAllocator::getAllocatedSeatCount() const
 {
     return allocatedSeats.size();
 }
 
+int SeatAllocator::getHeldSeatCount() const
+{
+    return holds.size();
+}
+
+bool SeatAllocator::hasHold(int holdId) const
+{
+    return holds.count(holdId) > 0;
+}
+
+SeatHold SeatAllocator::getHold(int holdId) const
+{
+    auto it = holds.find(holdId);
+    if (it == holds.end())
+        throw std::out_of_range("Invalid hold id.\n");
+    return (*it).second;
+}
+
 queue<int> SeatAllocator::getWaitingList() const
 {
     return waitingList;
@@ -285,10 +750,8 @@ int SeatAllocator::processWaitingList(int seatsToAdd, std::function<void(int)> b
                 processed++;
                 continue; // do NOT add to new list
             }
-            catch (const std::exception &e)
+            catch (const std::exception &)
             {
-                std::cerr << "\033[31m" << "Failed to book ticket for waiting passenger "
-                          << passengerId << ": " << e.what() << "\033[0m" << "\n";
                 // Booking failed , keep in waiting list
             }
         }
@@ -303,3 +766,120 @@ int SeatAllocator::processWaitingList(int seatsToAdd, std::function<void(int)> b
 
     return processed;
 }
+
+// layout as coach specs , then the seat state bitsets , then the per-passenger tables .
+// class masks , free counts and the reverse lookups are rebuilt on decode
+void SeatAllocator::encode(ByteWriter &out) const
+{
+    vector<CoachSpec> specs = layout.getCoachSpecs();
+    out.putInt((int)specs.size());
+    for (size_t i = 0; i < specs.size(); i++)
+    {
+        out.putString(specs[i].seatClass);
+        out.putInt(specs[i].seats);
+    }
+    out.putInt(totalSeats);
+    out.putBitset(freeSeats);
+    out.putBitset(movableSeats);
+    for (int a = 0; a < SEAT_ATTRIBUTE_COUNT; a++)
+    {
+        out.putBitset(attributes.bitsOf(a));
+        out.putBitset(attributes.pinnedBitsOf(a));
+    }
+
+    out.putInt(waitingList.size());
+    for (int passengerId : waitingList)
+        out.putInt(passengerId);
+    out.putInt((int)allocatedSeats.size());
+    for (const auto &entry : allocatedSeats)
+    {
+        out.putInt(entry.first);  // seat
+        out.putInt(entry.second); // passenger
+    }
+    out.putInt((int)holds.size());
+    for (const auto &entry : holds)
+    {
+        const SeatHold &hold = entry.second;
+        out.putInt(hold.holdId);
+        out.putInt(hold.trainId);
+        out.putInt(hold.passengerId);
+        out.putInt(hold.seatNumber);
+        out.putLong(hold.expiresAt);
+        out.putInt(hold.travelDate);
+        out.putBool(hold.flexible);
+    }
+    stack<int> cancelled = cancelledSeats; // top first
+    out.putInt(cancelled.size());
+    for (; !cancelled.empty(); cancelled.pop())
+        out.putInt(cancelled.top());
+    out.putInt(defragCoach);
+    out.putInt(defragLow);
+    out.putInt(defragHigh);
+}
+
+std::unique_ptr<SeatAllocator> SeatAllocator::decode(ByteReader &in)
+{
+    vector<CoachSpec> specs;
+    int coaches = in.getInt();
+    for (int i = 0; i < coaches; i++)
+    {
+        std::string seatClass = in.getString();
+        specs.push_back(CoachSpec{seatClass, in.getInt()});
+    }
+    auto seats = std::make_unique<SeatAllocator>(specs);
+    if (in.getInt() != seats->totalSeats)
+        throw std::runtime_error("Corrupt record.\n");
+    seats->freeSeats = in.getBitset();
+    seats->movableSeats = in.getBitset();
+    seats->attributes = SeatAttributes();
+    seats->attributes.resize(seats->totalSeats);
+    for (int a = 0; a < SEAT_ATTRIBUTE_COUNT; a++)
+    {
+        Bitset bits = in.getBitset();
+        Bitset pinned = in.getBitset();
+        seats->attributes.load(a, bits, pinned);
+    }
+    for (int seat = 1; seat <= seats->totalSeats; seat++)
+        if (!seats->freeSeats.test(seat))
+            seats->layout.markAllocated(seat);
+
+    int waiting = in.getInt();
+    for (int i = 0; i < waiting; i++)
+    {
+        int passengerId = in.getInt();
+        seats->waitingList.push(passengerId);
+        seats->waitingSet.insert(passengerId);
+    }
+    int allocated = in.getInt();
+    for (int i = 0; i < allocated; i++)
+    {
+        int seat = in.getInt();
+        int passengerId = in.getInt();
+        seats->allocatedSeats[seat] = passengerId;
+        seats->passengerSeats[passengerId] = seat;
+    }
+    int holdCount = in.getInt();
+    for (int i = 0; i < holdCount; i++)
+    {
+        SeatHold hold;
+        hold.holdId = in.getInt();
+        hold.trainId = in.getInt();
+        hold.passengerId = in.getInt();
+        hold.seatNumber = in.getInt();
+        hold.expiresAt = in.getLong();
+        hold.travelDate = in.getInt();
+        hold.flexible = in.getBool();
+        seats->holds[hold.holdId] = hold;
+        seats->heldSeats[hold.seatNumber] = hold.holdId;
+        seats->passengerSeats[hold.passengerId] = hold.seatNumber;
+    }
+    vector<int> cancelled;
+    for (int count = in.getInt(); count > 0; count--)
+        cancelled.push_back(in.getInt());
+    for (size_t i = cancelled.size(); i > 0; i--) // bottom first
+        seats->cancelledSeats.push(cancelled[i - 1]);
+    seats->defragCoach = in.getInt();
+    seats->defragLow = in.getInt();
+    seats->defragHigh = in.getInt();
+    return seats;
+}
@@ -0,0 +1,143 @@
+#include "models/SeatAttributes.h"
+#include "models/SeatLayout.h"
+#include "utils/helpers.h"
+#include <stdexcept>
+#include <sstream>
+
+static const char *ATTRIBUTE_NAMES[SEAT_ATTRIBUTE_COUNT] = {"window", "aisle", "lower", "door", "accessible"};
+
+unsigned parseSeatAttributes(const std::string &list)
+{
+    unsigned mask = 0;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        item = toLowerCase(trim(item));
+        if (item.empty())
+            continue;
+        bool found = false;
+        for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+        {
+            if (item == ATTRIBUTE_NAMES[i])
+            {
+                mask |= 1u << i;
+                found = true;
+            }
+        }
+        if (!found)
+            throw std::invalid_argument("Unknown seat attribute " + item);
+    }
+    return mask;
+}
+
+std::string seatAttributesToString(unsigned mask)
+{
+    std::string text;
+    for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+    {
+        if (mask & (1u << i))
+        {
+            if (!text.empty())
+                text += ",";
+            text += ATTRIBUTE_NAMES[i];
+        }
+    }
+    return text.empty() ? "-" : text;
+}
+
+void SeatAttributes::resize(int totalSeats)
+{
+    for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+    {
+        bits[i].resize(totalSeats + 1); // bit index == seat number
+        pinned[i].resize(totalSeats + 1);
+    }
+}
+
+void SeatAttributes::tag(int fromSeat, int toSeat, unsigned mask)
+{
+    if (fromSeat <= 0 || toSeat < fromSeat || toSeat >= (int)bits[0].size())
+        throw std::invalid_argument("Invalid seat range.\n");
+    for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+        if (mask & (1u << i))
+        {
+            bits[i].setRange(fromSeat, toSeat);
+            pinned[i].setRange(fromSeat, toSeat);
+        }
+}
+
+void SeatAttributes::untag(int fromSeat, int toSeat, unsigned mask)
+{
+    if (fromSeat <= 0 || toSeat < fromSeat || toSeat >= (int)bits[0].size())
+        throw std::invalid_argument("Invalid seat range.\n");
+    for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+        if (mask & (1u << i))
+        {
+            bits[i].resetRange(fromSeat, toSeat);
+            pinned[i].setRange(fromSeat, toSeat);
+        }
+}
+
+unsigned SeatAttributes::attributesOf(int seatNumber) const
+{
+    unsigned mask = 0;
+    for (int i = 0; i < SEAT_ATTRIBUTE_COUNT; i++)
+        if (bits[i].test(seatNumber))
+            mask |= 1u << i;
+    return mask;
+}
+
+const Bitset &SeatAttributes::bitsOf(int attributeIndex) const
+{
+    if (attributeIndex < 0 || attributeIndex >= SEAT_ATTRIBUTE_COUNT)
+        throw std::out_of_range("Invalid attribute index.\n");
+    return bits[attributeIndex];
+}
+
+const Bitset &SeatAttributes::pinnedBitsOf(int attributeIndex) const
+{
+    if (attributeIndex < 0 || attributeIndex >= SEAT_ATTRIBUTE_COUNT)
+        throw std::out_of_range("Invalid attribute index.\n");
+    return pinned[attributeIndex];
+}
+
+void SeatAttributes::load(int attributeIndex, const Bitset &seats, const Bitset &pinnedSeats)
+{
+    if (attributeIndex < 0 || attributeIndex >= SEAT_ATTRIBUTE_COUNT)
+        throw std::out_of_range("Invalid attribute index.\n");
+    if (seats.size() != bits[attributeIndex].size() || pinnedSeats.size() != bits[attributeIndex].size())
+        throw std::runtime_error("Corrupt record.\n");
+    bits[attributeIndex] = seats;
+    pinned[attributeIndex] = pinnedSeats;
+}
+
+void SeatAttributes::applyDefaultPattern(const SeatLayout &layout, int fromSeat)
+{
+    const int window = 0, aisle = 1, door = 3;
+    auto derive = [&](int attribute, int seat, bool on)
+    {
+        if (pinned[attribute].test(seat))
+            return;
+        if (on)
+            bits[attribute].set(seat);
+        else
+            bits[attribute].reset(seat);
+    };
+    for (int number = 1; number <= layout.getCoachCount(); number++)
+    {
+        const SeatLayout::Coach &coach = layout.getCoach(number);
+        int last = coach.firstSeat + coach.seatCount - 1;
+        if (last < fromSeat)
+            continue;
+        for (int seat = std::max(coach.firstSeat, fromSeat); seat <= last; seat++)
+        {
+            int offset = seat - coach.firstSeat;
+            int column = offset % 4;
+            // re-derive the geometry bits , explicit tags are kept
+            derive(window, seat, column == 0 || column == 3);
+            derive(aisle, seat, column == 1 || column == 2);
+            derive(door, seat, offset < 4 || offset >= coach.seatCount - 4);
+        }
+    }
+}
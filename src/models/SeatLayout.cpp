@@ -0,0 +1,328 @@
+#include "models/SeatLayout.h"
+#include "utils/helpers.h"
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+
+const std::string SeatLayout::DEFAULT_CLASS = "general";
+
+SeatLayout::SeatLayout(int totalSeats)
+{
+    if (totalSeats <= 0)
+        totalSeats = 10;
+    build({{DEFAULT_CLASS, totalSeats}});
+}
+
+SeatLayout::SeatLayout(const vector<CoachSpec> &specs)
+{
+    build(specs);
+}
+
+void SeatLayout::build(const vector<CoachSpec> &specs)
+{
+    if (specs.empty())
+        throw std::invalid_argument("Layout needs at least one coach.\n");
+
+    coaches.clear();
+    totalSeats = 0;
+    int nextSeat = 1;
+    vector<std::string> classNames; // first appearance order
+    for (const auto &spec : specs)
+    {
+        if (spec.seats <= 0)
+            throw std::invalid_argument("Coach seats must be greater than zero.\n");
+        std::string name = trim(spec.seatClass);
+        if (!isValidName(name))
+            throw std::invalid_argument("Invalid seat class name.\n");
+
+        int classIndex = -1;
+        for (size_t i = 0; i < classNames.size(); i++)
+            if (compareString(classNames[i], name))
+                classIndex = (int)i;
+        if (classIndex == -1)
+        {
+            classIndex = (int)classNames.size();
+            classNames.push_back(name);
+        }
+
+        Coach coach;
+        coach.number = (int)coaches.size() + 1;
+        coach.firstSeat = nextSeat;
+        coach.seatCount = spec.seats;
+        coach.freeSeats = spec.seats;
+        coach.classIndex = classIndex;
+        coaches.push_back(coach);
+
+        nextSeat += spec.seats;
+        totalSeats += spec.seats;
+    }
+    freeSeats = totalSeats;
+
+    classes.clear();
+    for (const auto &name : classNames)
+    {
+        SeatClass c;
+        c.name = name;
+        classes.push_back(c);
+    }
+    rebuildIndex();
+}
+
+// recompute every per-class index from the coach list
+// only runs when the structure changes (build / shrink) so O(coaches) is fine
+void SeatLayout::rebuildIndex()
+{
+    vector<SeatClass> rebuilt;
+    vector<int> remap;
+    for (size_t i = 0; i < classes.size(); i++)
+        remap.push_back(-1);
+    for (auto &coach : coaches)
+    {
+        int old = coach.classIndex;
+        if (remap[old] == -1)
+        {
+            remap[old] = (int)rebuilt.size();
+            SeatClass c;
+            c.name = classes[old].name;
+            rebuilt.push_back(c);
+        }
+        coach.classIndex = remap[old];
+        SeatClass &c = rebuilt[coach.classIndex];
+        coach.slot = (int)c.coaches.size();
+        c.coaches.push_back(coach.number - 1);
+        c.totalSeats += coach.seatCount;
+        c.freeSeats += coach.freeSeats;
+    }
+
+    classLookup.clear();
+    for (size_t i = 0; i < rebuilt.size(); i++)
+    {
+        SeatClass &c = rebuilt[i];
+        c.coachFree.assign(c.coaches.size());
+        for (size_t slot = 0; slot < c.coaches.size(); slot++)
+            c.coachFree.add(slot, coaches[c.coaches[slot]].freeSeats);
+        classLookup[toLowerCase(c.name)] = (int)i;
+    }
+    classes = std::move(rebuilt);
+
+    trainFree.assign(coaches.size());
+    for (size_t i = 0; i < coaches.size(); i++)
+        trainFree.add(i, coaches[i].freeSeats);
+}
+
+int SeatLayout::getTotalSeats() const
+{
+    return totalSeats;
+}
+
+int SeatLayout::getFreeSeats() const
+{
+    return freeSeats;
+}
+
+int SeatLayout::getCoachCount() const
+{
+    return (int)coaches.size();
+}
+
+int SeatLayout::getClassCount() const
+{
+    return (int)classes.size();
+}
+
+const SeatLayout::Coach &SeatLayout::getCoach(int coachNumber) const
+{
+    if (coachNumber <= 0 || coachNumber > (int)coaches.size())
+        throw std::out_of_range("Invalid coach number.\n");
+    return coaches[coachNumber - 1];
+}
+
+const SeatLayout::SeatClass &SeatLayout::getClass(int classIndex) const
+{
+    if (classIndex < 0 || classIndex >= (int)classes.size())
+        throw std::out_of_range("Invalid class index.\n");
+    return classes[classIndex];
+}
+
+vector<CoachSpec> SeatLayout::getCoachSpecs() const
+{
+    vector<CoachSpec> specs;
+    for (const auto &coach : coaches)
+        specs.push_back(CoachSpec{classes[coach.classIndex].name, coach.seatCount});
+    return specs;
+}
+
+int SeatLayout::findClass(const std::string &seatClass) const
+{
+    auto it = classLookup.find(toLowerCase(trim(seatClass)));
+    return (it != classLookup.end()) ? (*it).second : -1;
+}
+
+int SeatLayout::getClassFreeSeats(const std::string &seatClass) const
+{
+    int index = findClass(seatClass);
+    if (index == -1)
+        throw std::invalid_argument("Unknown seat class " + seatClass + ".\n");
+    return classes[index].freeSeats;
+}
+
+int SeatLayout::getClassTotalSeats(const std::string &seatClass) const
+{
+    int index = findClass(seatClass);
+    if (index == -1)
+        throw std::invalid_argument("Unknown seat class " + seatClass + ".\n");
+    return classes[index].totalSeats;
+}
+
+int SeatLayout::coachIndexOf(int seatNumber) const
+{
+    if (seatNumber <= 0 || seatNumber > totalSeats)
+        throw std::invalid_argument("Invalid seat number.\n");
+    // binary search on the first seat of each coach
+    int lo = 0, hi = (int)coaches.size() - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (coaches[mid].firstSeat <= seatNumber)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+int SeatLayout::coachOf(int seatNumber) const
+{
+    return coaches[coachIndexOf(seatNumber)].number;
+}
+
+std::string SeatLayout::classOf(int seatNumber) const
+{
+    return classes[coaches[coachIndexOf(seatNumber)].classIndex].name;
+}
+
+const SeatLayout::Coach *SeatLayout::findCoach(const SeatRequest &request) const
+{
+    int classIndex = -1;
+    if (!trim(request.seatClass).empty())
+    {
+        classIndex = findClass(request.seatClass);
+        if (classIndex == -1)
+            throw std::invalid_argument("Unknown seat class " + request.seatClass + ".\n");
+    }
+
+    // a specific coach
+    if (request.coach != 0)
+    {
+        const Coach &coach = getCoach(request.coach);
+        if (classIndex != -1 && coach.classIndex != classIndex)
+            throw std::invalid_argument("Coach " + std::to_string(request.coach) + " is not in class " + request.seatClass + ".\n");
+        return coach.freeSeats > 0 ? &coach : nullptr;
+    }
+
+    // any coach of a class
+    if (classIndex != -1)
+    {
+        const SeatClass &c = classes[classIndex];
+        if (c.freeSeats == 0)
+            return nullptr;
+        size_t slot = c.coachFree.lowerBound(1);
+        return &coaches[c.coaches[slot]];
+    }
+
+    // anywhere in the train
+    if (freeSeats == 0)
+        return nullptr;
+    return &coaches[trainFree.lowerBound(1)];
+}
+
+void SeatLayout::adjust(int seatNumber, int delta)
+{
+    int index = coachIndexOf(seatNumber);
+    Coach &coach = coaches[index];
+    SeatClass &c = classes[coach.classIndex];
+
+    coach.freeSeats += delta;
+    c.freeSeats += delta;
+    c.coachFree.add(coach.slot, delta);
+    trainFree.add(index, delta);
+    freeSeats += delta;
+}
+
+void SeatLayout::markAllocated(int seatNumber)
+{
+    adjust(seatNumber, -1);
+}
+
+void SeatLayout::markFree(int seatNumber)
+{
+    adjust(seatNumber, +1);
+}
+
+void SeatLayout::grow(int seats)
+{
+    if (seats <= 0)
+        throw std::invalid_argument("Seats must be greater than zero.\n");
+
+    Coach &last = coaches.back();
+    SeatClass &c = classes[last.classIndex];
+    last.seatCount += seats;
+    last.freeSeats += seats;
+    c.totalSeats += seats;
+    c.freeSeats += seats;
+    c.coachFree.add(last.slot, seats);
+    trainFree.add(coaches.size() - 1, seats);
+    totalSeats += seats;
+    freeSeats += seats;
+}
+
+void SeatLayout::shrink(int seats)
+{
+    if (seats <= 0)
+        return;
+    if (seats >= totalSeats)
+        throw std::out_of_range("Cannot shrink the layout to zero seats.\n");
+
+    while (seats > 0)
+    {
+        Coach &last = coaches.back();
+        int removed = std::min(seats, last.seatCount);
+        last.seatCount -= removed;
+        last.freeSeats -= removed;
+        totalSeats -= removed;
+        freeSeats -= removed;
+        seats -= removed;
+        if (last.seatCount == 0)
+            coaches.pop_back();
+    }
+    rebuildIndex();
+}
+
+void SeatLayout::resetFree()
+{
+    for (auto &coach : coaches)
+        coach.freeSeats = coach.seatCount;
+    freeSeats = totalSeats;
+    rebuildIndex();
+}
+
+void SeatLayout::printStatus() const
+{
+    std::cout << "--- Classes (free / total) ---\n";
+    for (const auto &c : classes)
+    {
+        std::cout << std::left << std::setw(14) << c.name
+                  << ": " << c.freeSeats << " / " << c.totalSeats << "\n";
+    }
+    std::cout << "\n";
+
+    std::cout << "--- Coaches ---\n";
+    for (const auto &coach : coaches)
+    {
+        std::cout << "Coach " << std::left << std::setw(4) << coach.number
+                  << "[" << classes[coach.classIndex].name << "] seats "
+                  << coach.firstSeat << "-" << coach.firstSeat + coach.seatCount - 1
+                  << " : " << coach.freeSeats << " free\n";
+    }
+    std::cout << "\n";
+}
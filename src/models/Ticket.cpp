@@ -2,13 +2,16 @@
 #include <iostream>
 #include <utility>
 #include "models/Ticket.h"
+#include "utils/helpers.h"
+#include "utils/BinaryCodec.h"
 using std::cout;
 using std::endl;
 
-Ticket::Ticket(const int id, const int seat, const int trainId, Passenger  p)
-        :passenger(std::move(p)), status(booked){
+Ticket::Ticket(const int id, const int seat, const int trainId, Passenger  p, const int travelDate)
+        :passenger(std::move(p)), status(booked), travelDate(travelDate){
     if(id <0 || trainId <= 0 ) throw std::invalid_argument("Invalid id");
     if(seat<=0) throw std::invalid_argument("Invalid seat");
+    if(travelDate != 0 && !isValidDate(travelDate)) throw std::invalid_argument("Invalid travel date");
     this->id = id;
     this->ticketSeat = seat;
     this->trainId = trainId;
@@ -18,11 +21,27 @@ int Ticket::getId() const
     return id;
 }
 
+long long Ticket::getVersion() const
+{
+    return version;
+}
+
+void Ticket::setVersion(long long version)
+{
+    this->version = version;
+}
+
 int Ticket::getSeat() const
 {
     return this->ticketSeat;
 }
 
+void Ticket::setSeat(const int seat)
+{
+    if(seat<=0) throw std::invalid_argument("Invalid seat");
+    this->ticketSeat = seat;
+}
+
 Status Ticket::getStatus() const
 {
     return status;
@@ -38,7 +57,12 @@ int Ticket::getTrainId() const
     return trainId;
 }
 
-Passenger Ticket::getPassenger() const
+int Ticket::getTravelDate() const
+{
+    return travelDate;
+}
+
+const Passenger &Ticket::getPassenger() const
 {
     return passenger;
 }
@@ -55,6 +79,8 @@ void Ticket::print(const std::string &msg) const {
     cout << "Ticket ID: " << id << "\n";
     cout << "Seat: " << ticketSeat<< "\n";
     cout << "Train ID: " << trainId << "\n";
+    if(travelDate != 0)
+        cout << "Date: " << formatDate(travelDate) << "\n";
     cout << "Passenger: " << passenger.getName() << "\n";
     cout << "Status : " << ((status == Status::booked) ? "Booked" : "Cancelled") << "\n";
     cout << "--------------------------------------------------\n";
@@ -65,3 +91,25 @@ void Ticket::setPassenger(const Passenger &p) {
 
 }
 
+void Ticket::encode(ByteWriter &out) const {
+    out.putInt(id);
+    out.putInt(ticketSeat);
+    out.putInt(trainId);
+    out.putInt(status);
+    out.putInt(travelDate);
+    out.putLong(version);
+    passenger.encode(out);
+}
+
+// fields are taken as stored , they were validated when the ticket was first built
+Ticket Ticket::decode(ByteReader &in) {
+    Ticket t;
+    t.id = in.getInt();
+    t.ticketSeat = in.getInt();
+    t.trainId = in.getInt();
+    t.status = in.getInt() == cancelled ? cancelled : booked;
+    t.travelDate = in.getInt();
+    t.version = in.getLong();
+    t.passenger = Passenger::decode(in);
+    return t;
+}
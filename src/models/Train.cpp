@@ -1,5 +1,6 @@
 #include "models/Train.h"
 #include "utils/helpers.h"
+#include "utils/BinaryCodec.h"
 
 #include <iostream>
 using std::cout;
@@ -16,10 +17,27 @@ Train::Train(const int id, const std::string& name, const int totalSeats ){
 
 }
 
+Train::Train(const int id, const std::string& name, const vector<CoachSpec>& coaches){
+    if(id < 0 ) throw std::invalid_argument("Invalid  negative id");
+    if(!isValidName(name)) throw std::invalid_argument("Invalid input name");
+    this->id = id;
+    this->name = trim(name);
+    this->seatAllocator = std::make_unique<SeatAllocator>(coaches);
+    this->totalSeats = seatAllocator->getTotalSeats();
+}
+
 int Train::getTrainId() const {
     return id;
 }
 
+long long Train::getVersion() const {
+    return version;
+}
+
+void Train::setVersion(long long version) {
+    this->version = version;
+}
+
 std::string Train::getTrainName() const {
     return name;
 }
@@ -49,17 +67,16 @@ int Train::getTotalSeats() const {
 
 std::unique_ptr<Train> Train::clone() const {
 
-        auto newTrain = std::make_unique<Train>(id, name, totalSeats);
-        if (seatAllocator) {
-            newTrain->seatAllocator = seatAllocator->clone();
-        }
-        return newTrain;
+        return std::make_unique<Train>(*this);
 
 }
 
 Train::Train(const Train &other)
         : id(other.id), name(other.name), totalSeats(other.totalSeats),
-          seatAllocator(other.seatAllocator ? other.seatAllocator->clone() : nullptr) {}
+          seatAllocator(other.seatAllocator ? other.seatAllocator->clone() : nullptr), version(other.version) {
+    for (const auto &d : other.departures)
+        departures[d.first] = d.second->clone();
+}
 
 Train &Train::operator=(const Train &other) {
 
@@ -67,24 +84,94 @@ Train &Train::operator=(const Train &other) {
             id = other.id;
             name = other.name;
             totalSeats = other.totalSeats;
+            version = other.version;
             seatAllocator = other.seatAllocator ? other.seatAllocator->clone() : nullptr;
+            departures.clear();
+            for (const auto &d : other.departures)
+                departures[d.first] = d.second->clone();
         }
         return *this;
 
 }
 
+void Train::forEachInventory(const std::function<void(SeatAllocator&)>& fn) {
+    fn(*seatAllocator);
+    for (auto &d : departures)
+        fn(*d.second);
+}
+
+SeatAllocator* Train::getSeatAllocator(int travelDate) {
+    if (travelDate == 0)
+        return seatAllocator.get();
+    if (!isValidDate(travelDate))
+        throw std::invalid_argument("Invalid travel date");
+
+    auto it = departures.find(travelDate);
+    if (it == departures.end())
+        it = departures.emplace(travelDate, seatAllocator->emptyCopy()).first;
+    return it->second.get();
+}
+
+SeatAllocator* Train::findSeatAllocator(int travelDate) const {
+    if (travelDate == 0)
+        return seatAllocator.get();
+    auto it = departures.find(travelDate);
+    return it == departures.end() ? nullptr : it->second.get();
+}
+
+vector<int> Train::getDepartureDates() const {
+    vector<int> dates;
+    for (const auto &d : departures)
+        dates.push_back(d.first);
+    return dates;
+}
+
+int Train::getDepartureCount() const {
+    return departures.size();
+}
+
+// drops the inventories of dates already departed , their tickets stay in the ticket repository
+int Train::evictDatesBefore(int travelDate) {
+    auto end = departures.lower_bound(travelDate);
+    int evicted = std::distance(departures.begin(), end);
+    departures.erase(departures.begin(), end);
+    return evicted;
+}
+
+int Train::getAvailableSeatCount(int travelDate) const {
+    const SeatAllocator* inventory = findSeatAllocator(travelDate);
+    // an untouched date is as free as the empty template
+    return inventory ? inventory->getAvailableSeatCount() : totalSeats;
+}
+
 void Train::addSeats(int seats) {
     if(seats <= 0 )
         throw std::invalid_argument("Seats must be greater than zero");
-    seatAllocator->addSeats(seats);
+    forEachInventory([seats](SeatAllocator& inventory) { inventory.addSeats(seats); });
 
     this->totalSeats = seatAllocator->getTotalSeats();
 }
 
+void Train::setCoachLayout(const vector<CoachSpec>& coaches) {
+    forEachInventory([&coaches](SeatAllocator& inventory) { inventory.setLayout(coaches); });
+
+    totalSeats = seatAllocator->getTotalSeats();
+}
+
+void Train::tagSeats(int fromSeat, int toSeat, unsigned attributes) {
+    forEachInventory([=](SeatAllocator& inventory) { inventory.tagSeats(fromSeat, toSeat, attributes); });
+}
+
+int Train::getClassAvailability(const std::string& seatClass, int travelDate) const {
+    const SeatAllocator* inventory = findSeatAllocator(travelDate);
+    // an untouched date is as free as the empty template
+    return inventory ? inventory->getClassAvailableSeatCount(seatClass) : seatAllocator->getLayout().getClassTotalSeats(seatClass);
+}
+
 void Train::setSeats(int seats) {
     if(seats <= 0)
         throw std::invalid_argument("Seats must be greater than zero");
-    seatAllocator->changeTotalSeats(seats);
+    forEachInventory([seats](SeatAllocator& inventory) { inventory.changeTotalSeats(seats); });
 
     totalSeats =seatAllocator->getTotalSeats();
 }
@@ -100,13 +187,39 @@ void Train::trainStatus()const {
     cout << "Train ID      : " << id << "\n";
     cout << "Train Name    : " << name << "\n";
     cout << "Total Seats   : " << totalSeats << "\n";
+    cout << "Classes       : " << seatAllocator->getLayout().getClassCount() << "\n";
+    cout << "Coaches       : " << seatAllocator->getLayout().getCoachCount() << "\n";
     cout << "Waiting List  : " << waitingSize << "\n";
+    cout << "Departures    : " << departures.size() << "\n";
     cout << "====================================\n\n";
 
     seatAllocator->printStatus();
 
 }
 
+void Train::trainStatus(int travelDate) const {
+    if (travelDate == 0) {
+        trainStatus();
+        return;
+    }
+
+    const SeatAllocator* inventory = findSeatAllocator(travelDate);
+    cout << "\n=========== Train Status ===========\n";
+    cout << "Train ID      : " << id << "\n";
+    cout << "Train Name    : " << name << "\n";
+    cout << "Date          : " << formatDate(travelDate) << "\n";
+    cout << "Total Seats   : " << totalSeats << "\n";
+    if (!inventory) {
+        cout << "No bookings for this date , " << totalSeats << " seats available\n";
+        cout << "====================================\n\n";
+        return;
+    }
+    cout << "Waiting List  : " << inventory->getWaitingListSize() << "\n";
+    cout << "====================================\n\n";
+
+    inventory->printStatus();
+}
+
 void Train::print(const std::string& msg) const{
     cout << "--------------------------------------------------\n";
     cout << msg << endl;
@@ -117,3 +230,30 @@ void Train::print(const std::string& msg) const{
     cout << "--------------------------------------------------\n";
 }
 
+void Train::encode(ByteWriter &out) const {
+    out.putInt(id);
+    out.putString(name);
+    out.putInt(totalSeats);
+    out.putLong(version);
+    seatAllocator->encode(out);
+    out.putInt((int)departures.size());
+    for (const auto &d : departures) {
+        out.putInt(d.first);
+        d.second->encode(out);
+    }
+}
+
+Train Train::decode(ByteReader &in) {
+    Train t;
+    t.id = in.getInt();
+    t.name = in.getString();
+    t.totalSeats = in.getInt();
+    t.version = in.getLong();
+    t.seatAllocator = SeatAllocator::decode(in);
+    int dates = in.getInt();
+    for (int i = 0; i < dates; i++) {
+        int date = in.getInt();
+        t.departures[date] = SeatAllocator::decode(in);
+    }
+    return t;
+}
@@ -0,0 +1,73 @@
+#include "utils/Executor.h"
+
+Executor::Detached Executor::detach(Executor *executor, Task<void> task)
+{
+    try
+    {
+        co_await task;
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(executor->mutex);
+        if (!executor->failure)
+            executor->failure = std::current_exception();
+    }
+}
+
+void Executor::post(std::coroutine_handle<> h)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(h);
+    }
+    wake.notify_one();
+}
+
+void Executor::beginExternal()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    external++;
+}
+
+void Executor::completeExternal(std::coroutine_handle<> h)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(h);
+        external--; // same critical section , run() never sees neither
+    }
+    wake.notify_one();
+}
+
+void Executor::spawn(Task<void> task)
+{
+    post(detach(this, std::move(task)).handle);
+}
+
+void Executor::run()
+{
+    while (true)
+    {
+        std::coroutine_handle<> next;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return !ready.empty() || external == 0 || failure; });
+            if (failure)
+            {
+                std::exception_ptr error = std::exchange(failure, nullptr);
+                std::rethrow_exception(error);
+            }
+            if (ready.empty())
+                return; // nothing ready , nothing pending elsewhere
+            next = ready.front();
+            ready.pop_front();
+            resumed++;
+        }
+        next.resume();
+    }
+}
+
+long long Executor::getResumeCount() const
+{
+    return resumed.load();
+}
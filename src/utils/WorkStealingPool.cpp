@@ -0,0 +1,194 @@
+#include "utils/WorkStealingPool.h"
+#include <stdexcept>
+#include <algorithm>
+
+// which pool / worker the current thread belongs to
+static thread_local const WorkStealingPool *workerPool = nullptr;
+static thread_local int workerIndex = -1;
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    if (threads < 0)
+        throw std::invalid_argument("Thread count cannot be negative");
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+int WorkStealingPool::getThreadCount() const
+{
+    return (int)workers.size();
+}
+
+WorkStealingStats WorkStealingPool::getStats() const
+{
+    return WorkStealingStats{executed.load(), stolen.load()};
+}
+
+int WorkStealingPool::currentIndex() const
+{
+    return workerPool == this ? workerIndex : -1;
+}
+
+void WorkStealingPool::push(std::function<void()> task)
+{
+    int self = currentIndex();
+    int target = self != -1 ? self : (int)(nextQueue.fetch_add(1) % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    queued++;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex); // pairs with the sleeper's check
+    }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::runOne(int self)
+{
+    std::function<void()> task;
+    int n = (int)queues.size();
+    if (self != -1)
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty())
+        {
+            task = std::move(queues[self]->tasks.back()); // newest , its data is still warm
+            queues[self]->tasks.pop_back();
+        }
+    }
+    if (!task)
+    {
+        int start = self != -1 ? self + 1 : (int)(nextQueue.load() % n);
+        for (int k = 0; k < n && !task; k++)
+        {
+            int victim = (start + k) % n;
+            if (victim == self)
+                continue;
+            std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+            if (!queues[victim]->tasks.empty())
+            {
+                task = std::move(queues[victim]->tasks.front()); // oldest , usually the biggest piece
+                queues[victim]->tasks.pop_front();
+                stolen++;
+            }
+        }
+    }
+    if (!task)
+        return false;
+    queued--;
+    executed++;
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    workerPool = this;
+    workerIndex = index;
+    while (true)
+    {
+        if (runOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    push([task = std::move(task)] {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            // nobody waits on a submitted task , a throw must not take the worker down
+        }
+    });
+}
+
+namespace
+{
+    struct ForJob
+    {
+        const std::function<void(size_t, size_t)> *body;
+        size_t grain;
+        std::atomic<size_t> pending{1};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+}
+
+void WorkStealingPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body)
+{
+    if (begin >= end)
+        return;
+    if (grain == 0)
+        grain = 1;
+    auto job = std::make_shared<ForJob>();
+    job->body = &body;
+    job->grain = grain;
+
+    // keeps the lower half , hands the upper half to the deque , until the piece is small
+    std::function<void(size_t, size_t)> split = [this, job, &split](size_t lo, size_t hi) {
+        while (hi - lo > job->grain)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            job->pending++;
+            push([&split, mid, hi] { split(mid, hi); });
+            hi = mid;
+        }
+        try
+        {
+            (*job->body)(lo, hi);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(job->errorMutex);
+            if (!job->error)
+                job->error = std::current_exception();
+        }
+        // the caller may return and destroy this lambda once pending reaches 0 , keep the pool
+        WorkStealingPool *pool = this;
+        if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            {
+                std::lock_guard<std::mutex> lock(pool->sleepMutex); // pairs with the caller's check
+            }
+            pool->wake.notify_all();
+        }
+    };
+
+    split(begin, end);
+    int self = currentIndex();
+    while (job->pending.load(std::memory_order_acquire) > 0)
+    {
+        if (runOne(self))
+            continue;
+        // the rest is running on other threads : sleep until the last piece is done , or until
+        // new work is queued to help with (a nested loop of a blocked worker may need us)
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return job->pending.load(std::memory_order_acquire) == 0 || queued.load() > 0; });
+    }
+    if (job->error)
+        std::rethrow_exception(job->error);
+}
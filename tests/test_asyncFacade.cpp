@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include "AsyncRMSFacade.h"
+#include "utils/Task.h"
+#include "utils/Executor.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class AsyncFacadeTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+    std::unique_ptr<RMSFacade> facade;
+    Executor executor;
+    std::unique_ptr<AsyncRMSFacade> async;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+        facade = std::make_unique<RMSFacade>(trainService.get(), ticketService.get(), passengerService.get());
+        async = std::make_unique<AsyncRMSFacade>(facade.get(), trainService.get(), ticketService.get(), &executor, 16);
+    }
+
+    void TearDown() override {
+        async.reset();
+        facade.reset(); // drains the pipeline before the services go away
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+
+    // books every passenger , counts how many bookings were in flight at the same time
+    Task<void> bookAll(int trainId, std::vector<std::string> names, int *booked, int *inFlight, int *maxInFlight) {
+        for (const auto &name : names) {
+            ++*inFlight;
+            *maxInFlight = std::max(*maxInFlight, *inFlight);
+            auto ticket = co_await async->bookTicket(trainId, name);
+            --*inFlight;
+            if (ticket)
+                ++*booked;
+        }
+    }
+
+    void bookConcurrently(int trains, int seats, int coroutines) {
+        std::vector<int> trainIds;
+        for (int t = 0; t < trains; t++)
+            trainIds.push_back(trainService->createTrain("T" + std::to_string(t), seats).getTrainId());
+
+        int booked = 0, inFlight = 0, maxInFlight = 0;
+        for (int c = 0; c < coroutines; c++)
+            executor.spawn(bookAll(trainIds[c % trains], {"P" + std::to_string(c)}, &booked, &inFlight, &maxInFlight));
+        executor.run();
+
+        EXPECT_EQ(booked, coroutines);
+        EXPECT_EQ(inFlight, 0);
+        EXPECT_GT(maxInFlight, 1); // the coroutines really interleaved
+        EXPECT_EQ((int)ticketService->getAllTickets().size(), coroutines);
+        for (int id : trainIds)
+            EXPECT_EQ(trainService->getTrain(id).getSeatAllocator()->getAllocatedSeatCount(), coroutines / trains);
+    }
+};
+
+// ===================== Task / Executor =====================
+
+static Task<int> answer() { co_return 42; }
+static Task<int> addOne(Task<int> inner) { co_return co_await inner + 1; }
+static Task<int> failing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+TEST_F(AsyncFacadeTest, TaskIsLazyAndComposes) {
+    bool started = false;
+    auto task = [](bool *flag) -> Task<int> { *flag = true; co_return 1; }(&started);
+    EXPECT_FALSE(started);
+    EXPECT_EQ(syncWait(executor, std::move(task)), 1);
+    EXPECT_TRUE(started);
+    EXPECT_EQ(syncWait(executor, addOne(answer())), 43);
+}
+
+TEST_F(AsyncFacadeTest, ExceptionsSurfaceAtTheAwait) {
+    auto caught = [](Task<int> inner) -> Task<bool> {
+        try { co_await inner; } catch (const std::runtime_error &) { co_return true; }
+        co_return false;
+    };
+    EXPECT_TRUE(syncWait(executor, caught(failing())));
+    EXPECT_THROW(syncWait(executor, failing()), std::runtime_error);
+}
+
+TEST_F(AsyncFacadeTest, YieldRoundRobinsSpawnedTasks) {
+    std::string order;
+    auto worker = [](Executor *ex, std::string *out, char name) -> Task<void> {
+        for (int i = 0; i < 3; i++) {
+            out->push_back(name);
+            co_await ex->yield();
+        }
+    };
+    executor.spawn(worker(&executor, &order, 'a'));
+    executor.spawn(worker(&executor, &order, 'b'));
+    executor.run();
+    EXPECT_EQ(order, "ababab");
+}
+
+TEST_F(AsyncFacadeTest, LongAwaitChainsDoNotGrowTheStack) {
+    auto chain = [](int n) -> Task<int> {
+        int sum = 0;
+        for (int i = 0; i < n; i++)
+            sum += co_await answer(); // completes synchronously every time
+        co_return sum;
+    };
+    EXPECT_EQ(syncWait(executor, chain(100000)), 4200000);
+}
+
+// ===================== bookings =====================
+
+TEST_F(AsyncFacadeTest, ThousandsOfInlineBookingsOnOneThread) {
+    bookConcurrently(20, 100, 2000);
+}
+
+TEST_F(AsyncFacadeTest, ThousandsOfPipelineBookingsOnOneThread) {
+    facade->enableAsyncBooking();
+    bookConcurrently(20, 100, 2000);
+    EXPECT_EQ(facade->getBookingPipelineStats().completed, 2000);
+}
+
+TEST_F(AsyncFacadeTest, OverbookingGoesToTheWaitingList) {
+    facade->enableAsyncBooking();
+    Train train = trainService->createTrain("Express", 5);
+    int booked = 0, inFlight = 0, maxInFlight = 0;
+    for (int c = 0; c < 8; c++)
+        executor.spawn(bookAll(train.getTrainId(), {"P" + std::to_string(c)}, &booked, &inFlight, &maxInFlight));
+    executor.run();
+    EXPECT_EQ(booked, 5);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getWaitingListSize(), 3);
+}
+
+TEST_F(AsyncFacadeTest, BookingErrorsPropagateInBothModes) {
+    EXPECT_THROW(syncWait(executor, async->bookTicket(0, "omar")), std::invalid_argument);
+    EXPECT_THROW(syncWait(executor, async->bookTicket(77, "omar")), std::out_of_range);
+    facade->enableAsyncBooking();
+    EXPECT_THROW(syncWait(executor, async->bookTicket(0, "omar")), std::invalid_argument);
+    EXPECT_THROW(syncWait(executor, async->bookTicket(77, "omar")), std::out_of_range);
+}
+
+TEST_F(AsyncFacadeTest, DatedBookingWithSeatRequest) {
+    facade->enableAsyncBooking();
+    Train train = facade->addTrain("Express", 8);
+    facade->setCoachLayout(train.getTrainId(), vector<CoachSpec>{{"second", 4}, {"first", 4}});
+    SeatRequest first;
+    first.seatClass = "first";
+    auto ticket = syncWait(executor, async->bookTicket(train.getTrainId(), "omar", first, "2026-11-01"));
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_GE(ticket->getSeat(), 5);
+    EXPECT_EQ(ticket->getTravelDate(), 20261101);
+}
+
+TEST_F(AsyncFacadeTest, CancelPromotesTheWaitingPassenger) {
+    Train train = trainService->createTrain("Express", 1);
+    auto first = syncWait(executor, async->bookTicket(train.getTrainId(), "first"));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(syncWait(executor, async->bookTicket(train.getTrainId(), "second")).has_value());
+
+    syncWait(executor, async->cancelTicket(first->getId()));
+    auto tickets = facade->listTickets();
+    int active = 0;
+    for (const auto &t : tickets)
+        if (t.getStatus() == booked)
+            active++;
+    EXPECT_EQ(active, 1);
+    EXPECT_THROW(syncWait(executor, async->cancelTicket(first->getId())), std::exception);
+}
+
+// ===================== cooperative long operations =====================
+
+TEST_F(AsyncFacadeTest, ListingsArePagedAndYield) {
+    for (int t = 0; t < 50; t++)
+        trainService->createTrain("T" + std::to_string(t), 1);
+
+    int ticks = 0;
+    bool listingDone = false;
+    auto ticker = [](Executor *ex, int *count, bool *done) -> Task<void> {
+        while (!*done) {
+            ++*count;
+            co_await ex->yield();
+        }
+    };
+    auto lister = [](AsyncRMSFacade *a, bool *done) -> Task<void> {
+        vector<Train> trains = co_await a->listTrains();
+        EXPECT_EQ(trains.size(), 50);
+        for (size_t i = 1; i < trains.size(); i++)
+            EXPECT_LT(trains[i - 1].getTrainId(), trains[i].getTrainId());
+        *done = true;
+    };
+    executor.spawn(lister(async.get(), &listingDone));
+    executor.spawn(ticker(&executor, &ticks, &listingDone));
+    executor.run();
+    EXPECT_GE(ticks, 3); // 50 trains in pages of 16 : the ticker ran between pages
+}
+
+TEST_F(AsyncFacadeTest, ListingAfterDeletesKeepsPaging) {
+    for (int t = 0; t < 40; t++)
+        trainService->createTrain("T" + std::to_string(t), 1);
+    for (int id = 2; id <= 40; id += 2)
+        trainService->deleteTrain(id);
+    EXPECT_EQ(syncWait(executor, async->listTrains()).size(), 20);
+    EXPECT_EQ(syncWait(executor, async->listTickets()).size(), 0);
+}
+
+TEST_F(AsyncFacadeTest, BulkWaitlistPromotionYieldsAndBooksEveryone) {
+    Train train = trainService->createTrain("Express", 1);
+    for (int p = 0; p < 61; p++)
+        syncWait(executor, async->bookTicket(train.getTrainId(), "P" + std::to_string(p)));
+    ASSERT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getWaitingListSize(), 60);
+
+    int ticks = 0;
+    bool done = false;
+    auto ticker = [](Executor *ex, int *count, bool *finished) -> Task<void> {
+        while (!*finished) {
+            ++*count;
+            co_await ex->yield();
+        }
+    };
+    auto grow = [](AsyncRMSFacade *a, int id, bool *finished) -> Task<void> {
+        Train updated = co_await a->updateTrain(id, "Express", 61);
+        EXPECT_EQ(updated.getSeatAllocator()->getAllocatedSeatCount(), 61);
+        EXPECT_EQ(updated.getSeatAllocator()->getWaitingListSize(), 0);
+        *finished = true;
+    };
+    executor.spawn(grow(async.get(), train.getTrainId(), &done));
+    executor.spawn(ticker(&executor, &ticks, &done));
+    executor.run();
+    EXPECT_GE(ticks, 3); // 60 promotions in chunks of 16
+    EXPECT_EQ(ticketService->getAllTickets().size(), 61u);
+}
+
+TEST_F(AsyncFacadeTest, UpdateTrainValidatesInput) {
+    EXPECT_THROW(syncWait(executor, async->updateTrain(0, "x", 1)), std::invalid_argument);
+    EXPECT_THROW(syncWait(executor, async->updateTrain(1, "  ", 1)), std::invalid_argument);
+    EXPECT_THROW(AsyncRMSFacade(facade.get(), trainService.get(), ticketService.get(), &executor, 0), std::invalid_argument);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <atomic>
+#include "RMSFacade.h"
+#include "Services/BookingPipeline.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class BookingPipelineTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+
+    vector<int> makePassengers(int count) {
+        vector<int> ids;
+        for (int i = 0; i < count; i++)
+            ids.push_back(passengerService->createPassenger("P" + std::to_string(i)).getId());
+        return ids;
+    }
+
+    static BookingRequest booking(int trainId, int passengerId, int travelDate = 0) {
+        BookingRequest r;
+        r.trainId = trainId;
+        r.passengerId = passengerId;
+        r.travelDate = travelDate;
+        return r;
+    }
+};
+
+// ===================== bookBatch =====================
+
+TEST_F(BookingPipelineTest, BatchBooksWithOneTrainWrite) {
+    Train train = trainService->createTrain("Express", 3);
+    vector<int> passengers = makePassengers(4);
+    long long versionBefore = trainService->getTrain(train.getTrainId()).getVersion();
+
+    std::vector<BookingRequest> requests;
+    for (int p : passengers)
+        requests.push_back(booking(train.getTrainId(), p));
+    requests.push_back(booking(train.getTrainId(), 999)); // unknown passenger
+
+    auto outcomes = ticketService->bookBatch(train.getTrainId(), requests);
+    ASSERT_EQ(outcomes.size(), 5u);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(outcomes[i].ticket.has_value());
+        EXPECT_FALSE(outcomes[i].error);
+    }
+    EXPECT_FALSE(outcomes[3].ticket.has_value()); // waiting list
+    EXPECT_FALSE(outcomes[3].error);
+    EXPECT_TRUE(outcomes[4].error);
+    EXPECT_THROW(std::rethrow_exception(outcomes[4].error), std::out_of_range);
+
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getVersion(), versionBefore + 1);
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), 3);
+    EXPECT_EQ(stored.getSeatAllocator()->getWaitingListSize(), 1);
+    EXPECT_EQ(ticketService->getAllTickets().size(), 3u);
+}
+
+TEST_F(BookingPipelineTest, BatchRefusesDuplicatesInsideTheBatch) {
+    Train train = trainService->createTrain("Express", 5);
+    vector<int> passengers = makePassengers(1);
+    auto outcomes = ticketService->bookBatch(train.getTrainId(),
+                                             {booking(train.getTrainId(), passengers[0]), booking(train.getTrainId(), passengers[0])});
+    EXPECT_TRUE(outcomes[0].ticket.has_value());
+    EXPECT_TRUE(outcomes[1].error);
+}
+
+TEST_F(BookingPipelineTest, BatchForMissingTrainFailsEveryRequest) {
+    vector<int> passengers = makePassengers(2);
+    auto outcomes = ticketService->bookBatch(42, {booking(42, passengers[0]), booking(42, passengers[1])});
+    for (const auto &outcome : outcomes)
+        EXPECT_THROW(std::rethrow_exception(outcome.error), std::out_of_range);
+}
+
+// the batch write fails , single saves still work
+class FailingBatchTicketRepository : public InMemoryTicketRepository {
+public:
+    void saveAll(vector<Ticket> &) override { throw std::runtime_error("disk full"); }
+};
+
+TEST_F(BookingPipelineTest, FailedBatchWriteGivesTheSeatsBack) {
+    FailingBatchTicketRepository failing;
+    TicketService service(&failing, trainService.get(), passengerService.get());
+    Train train = trainService->createTrain("Express", 2);
+    vector<int> passengers = makePassengers(3);
+
+    auto outcomes = service.bookBatch(train.getTrainId(), {booking(train.getTrainId(), passengers[0]),
+                                                           booking(train.getTrainId(), passengers[1]),
+                                                           booking(train.getTrainId(), passengers[2])});
+    for (int i = 0; i < 2; i++) {
+        EXPECT_FALSE(outcomes[i].ticket.has_value());
+        EXPECT_THROW(std::rethrow_exception(outcomes[i].error), std::runtime_error);
+    }
+    EXPECT_FALSE(outcomes[2].error); // waitlisted , then promoted into a freed seat
+
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), 1);
+    EXPECT_EQ(stored.getSeatAllocator()->getWaitingListSize(), 0);
+    ASSERT_EQ(failing.getAllTickets().size(), 1u);
+    EXPECT_EQ(failing.getAllTickets()[0].getPassenger().getId(), passengers[2]);
+}
+
+// ===================== pipeline =====================
+
+TEST_F(BookingPipelineTest, FuturesResolveToTickets) {
+    Train train = trainService->createTrain("Express", 2);
+    vector<int> passengers = makePassengers(3);
+    BookingPipeline pipeline(ticketService.get());
+
+    std::vector<std::future<std::optional<Ticket>>> futures;
+    for (int p : passengers)
+        futures.push_back(pipeline.submit(booking(train.getTrainId(), p)));
+
+    int tickets = 0, waiting = 0;
+    for (auto &f : futures)
+        (f.get().has_value() ? tickets : waiting)++;
+    EXPECT_EQ(tickets, 2);
+    EXPECT_EQ(waiting, 1);
+}
+
+TEST_F(BookingPipelineTest, ErrorsReachTheFuture) {
+    Train train = trainService->createTrain("Express", 2);
+    BookingPipeline pipeline(ticketService.get());
+    auto future = pipeline.submit(booking(train.getTrainId(), 77));
+    EXPECT_THROW(future.get(), std::out_of_range);
+    auto badDate = pipeline.submit(booking(train.getTrainId(), 77, 20261345));
+    EXPECT_THROW(badDate.get(), std::invalid_argument);
+}
+
+TEST_F(BookingPipelineTest, SameTrainRequestsAreCoalesced) {
+    Train train = trainService->createTrain("Express", 100);
+    vector<int> passengers = makePassengers(40);
+    BookingPipelineOptions options;
+    options.workers = 2;
+    options.maxBatchSize = 16;
+    options.maxBatchDelayMs = 50; // long enough for all submits to land
+    BookingPipeline pipeline(ticketService.get(), options);
+
+    std::atomic<int> done{0};
+    for (int p : passengers)
+        pipeline.submit(booking(train.getTrainId(), p), [&](const std::optional<Ticket> &t, std::exception_ptr e) {
+            if (t.has_value() && !e)
+                done++;
+        });
+    pipeline.shutdown();
+
+    BookingPipelineStats stats = pipeline.getStats();
+    EXPECT_EQ(done.load(), 40);
+    EXPECT_EQ(stats.completed, 40);
+    EXPECT_EQ(stats.queueDepth, 0);
+    EXPECT_LE(stats.largestBatch, 16);
+    EXPECT_LE(stats.batches, 4); // 16 + 16 + 8 , a slow scheduler may split one more
+    EXPECT_GT(stats.averageBatchFill, 0.5);
+    EXPECT_GE(stats.maxQueueDepth, 16); // a full batch may leave before the rest is submitted
+
+    std::set<int> seats;
+    for (const auto &t : ticketService->getAllTickets())
+        seats.insert(t.getSeat());
+    EXPECT_EQ(seats.size(), 40u);
+}
+
+TEST_F(BookingPipelineTest, ShutdownDrainsAndRefusesNewWork) {
+    vector<int> trains;
+    for (int t = 0; t < 4; t++)
+        trains.push_back(trainService->createTrain("T" + std::to_string(t), 10).getTrainId());
+    vector<int> passengers = makePassengers(10);
+    BookingPipeline pipeline(ticketService.get());
+
+    std::vector<std::future<std::optional<Ticket>>> futures;
+    for (int t : trains)
+        for (int p : passengers)
+            futures.push_back(pipeline.submit(booking(t, p)));
+    pipeline.shutdown();
+
+    for (auto &f : futures)
+        EXPECT_TRUE(f.get().has_value());
+    EXPECT_EQ(ticketService->getAllTickets().size(), 40u);
+    EXPECT_THROW(pipeline.submit(booking(trains[0], passengers[0])), std::runtime_error);
+}
+
+TEST_F(BookingPipelineTest, InvalidOptionsThrow) {
+    BookingPipelineOptions options;
+    options.workers = 0;
+    EXPECT_THROW(BookingPipeline(ticketService.get(), options), std::invalid_argument);
+    options.workers = 1;
+    options.maxBatchSize = 0;
+    EXPECT_THROW(BookingPipeline(ticketService.get(), options), std::invalid_argument);
+}
+
+TEST_F(BookingPipelineTest, FacadeBooksAsynchronously) {
+    RMSFacade facade(trainService.get(), ticketService.get(), passengerService.get());
+    Train train = facade.addTrain("Express", 2);
+    EXPECT_THROW(facade.bookTicketAsync(train.getTrainId(), "Alice"), std::runtime_error);
+
+    facade.enableAsyncBooking();
+    auto alice = facade.bookTicketAsync(train.getTrainId(), "Alice", SeatRequest{}, "2026-12-01");
+    std::promise<bool> called;
+    facade.bookTicketAsync(train.getTrainId(), "Bob", [&](const std::optional<Ticket> &t, std::exception_ptr) {
+        called.set_value(t.has_value());
+    });
+
+    auto ticket = alice.get();
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(ticket->getTravelDate(), 20261201);
+    EXPECT_TRUE(called.get_future().get());
+    EXPECT_THROW(facade.bookTicketAsync(train.getTrainId(), ""), std::invalid_argument);
+    EXPECT_EQ(facade.getBookingPipelineStats().completed, 2);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "Services/BulkExporter.h"
+#include "Services/BulkImporter.h"
+#include "utils/BinaryCodec.h"
+#include "utils/FieldParser.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class BulkExporterTest : public ::testing::Test {
+protected:
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    InMemoryTicketRepository ticketRepo;
+    TrainService trainService{&trainRepo};
+    PassengerService passengerService{&passengerRepo};
+    TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+    BulkExporter exporter{&trainService, &ticketService};
+    int express = 0, local = 0;
+
+    void SetUp() override {
+        express = trainService.createTrain("Nile Express", 3).getTrainId();
+        local = trainService.createTrain("Delta Local", 3).getTrainId();
+        for (const char *name : {"Omar", "Sara Ali", "Karim", "Mona"})
+            passengerService.createPassenger(name);
+        ticketService.bookTicket(local, 1);   // ticket 1
+        ticketService.bookTicket(express, 2); // ticket 2
+        ticketService.bookTicket(express, 3); // ticket 3
+        ticketService.bookTicket(local, 4);   // ticket 4
+        ticketService.cancelTicket(1);
+    }
+
+    std::string exportText(ExportFormat format, const ExportOptions &options = ExportOptions{}) {
+        std::ostringstream out;
+        ExportReport report = exporter.exportStream(format, out, options);
+        EXPECT_EQ(report.bytes, (long long)out.str().size());
+        return out.str();
+    }
+
+    static std::vector<std::string> lines(const std::string &text) {
+        std::vector<std::string> result;
+        std::istringstream in(text);
+        for (std::string line; std::getline(in, line);)
+            result.push_back(line);
+        return result;
+    }
+};
+
+TEST_F(BulkExporterTest, WritesEveryTicketAsCsvInIdOrder) {
+    auto rows = lines(exportText(ExportFormat::Csv));
+    ASSERT_EQ(rows.size(), 5u);
+    EXPECT_EQ(rows[0], "id,train_id,passenger_id,passenger_name,seat,date,status");
+    EXPECT_EQ(rows[1].rfind("1," + std::to_string(local) + ",1,Omar,", 0), 0u);
+    EXPECT_NE(rows[1].find(",cancelled"), std::string::npos);
+    EXPECT_EQ(rows[2].rfind("2," + std::to_string(express) + ",2,Sara Ali,", 0), 0u);
+    EXPECT_NE(rows[4].find(",booked"), std::string::npos);
+}
+
+TEST_F(BulkExporterTest, JsonLinesParseBack) {
+    auto rows = lines(exportText(ExportFormat::JsonLines));
+    ASSERT_EQ(rows.size(), 4u);
+    ParsedFields fields;
+    std::string error;
+    std::string_view value;
+    ASSERT_TRUE(parseJsonLine(rows[1], fields, error)) << error;
+    ASSERT_TRUE(fields.find("passenger_name", value));
+    EXPECT_EQ(value, "Sara Ali");
+    ASSERT_TRUE(fields.find("status", value));
+    EXPECT_EQ(value, "booked");
+    ASSERT_TRUE(fields.find("date", value));
+    EXPECT_EQ(value, ""); // undated inventory
+}
+
+TEST_F(BulkExporterTest, BinaryRecordsDecodeToTheSameTickets) {
+    std::string bytes = exportText(ExportFormat::Binary);
+    ASSERT_GE(bytes.size(), 8u);
+    EXPECT_EQ(bytes.substr(0, 8), "RMSTKX01");
+    auto expected = ticketService.getAllTickets();
+    size_t at = 8, count = 0;
+    while (at < bytes.size()) {
+        uint32_t size;
+        std::memcpy(&size, bytes.data() + at, sizeof(size));
+        ByteReader reader(bytes.data() + at + sizeof(size), size);
+        Ticket ticket = Ticket::decode(reader);
+        ASSERT_LT(count, expected.size());
+        EXPECT_EQ(ticket.getId(), expected[count].getId());
+        EXPECT_EQ(ticket.getSeat(), expected[count].getSeat());
+        EXPECT_EQ(ticket.getPassenger().getName(), expected[count].getPassenger().getName());
+        EXPECT_EQ(ticket.getStatus(), expected[count].getStatus());
+        at += sizeof(size) + size;
+        count++;
+    }
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST_F(BulkExporterTest, ManifestListsBookedSeatsPerTrain) {
+    ExportOptions options;
+    options.manifest = true;
+    auto rows = lines(exportText(ExportFormat::Csv, options));
+    ASSERT_EQ(rows.size(), 4u); // header , two express seats , one local seat (ticket 1 was cancelled)
+    EXPECT_EQ(rows[0], "train_id,train_name,date,seat,ticket_id,passenger_id,passenger_name");
+    EXPECT_EQ(rows[1].rfind(std::to_string(express) + ",Nile Express,,", 0), 0u);
+    EXPECT_NE(rows[1].find(",Sara Ali"), std::string::npos);
+    EXPECT_NE(rows[2].find(",Karim"), std::string::npos);
+    EXPECT_EQ(rows[3].rfind(std::to_string(local) + ",Delta Local,,", 0), 0u);
+
+    options.trainId = local;
+    options.travelDate = 0;
+    rows = lines(exportText(ExportFormat::Csv, options));
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_NE(rows[1].find(",Mona"), std::string::npos);
+
+    options.travelDate = 20261019; // no dated bookings
+    EXPECT_EQ(lines(exportText(ExportFormat::Csv, options)).size(), 1u);
+}
+
+TEST_F(BulkExporterTest, SmallBuffersAndFilesGiveTheSameBytes) {
+    std::string whole = exportText(ExportFormat::JsonLines);
+    ExportOptions options;
+    options.bufferBytes = 16; // a write after almost every record
+    EXPECT_EQ(exportText(ExportFormat::JsonLines, options), whole);
+
+    std::string path = "/tmp/rms_export_test_" + std::to_string(getpid()) + ".jsonl";
+    ASSERT_EQ(BulkExporter::formatFor(path), ExportFormat::JsonLines);
+    ExportReport report = exporter.exportFile(ExportFormat::JsonLines, path, options);
+    EXPECT_EQ(report.records, 4);
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    EXPECT_EQ(contents.str(), whole);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(exporter.exportFile(ExportFormat::Csv, "/tmp/rms_no_such_dir/out.csv"), std::runtime_error);
+    options.bufferBytes = 0;
+    EXPECT_THROW(exportText(ExportFormat::Csv, options), std::invalid_argument);
+}
+
+TEST_F(BulkExporterTest, CsvExportImportsBackAsBookings) {
+    std::string csv = exportText(ExportFormat::Csv);
+    InMemoryTrainRepository otherTrains;
+    InMemoryPassengerRepository otherPassengers;
+    InMemoryTicketRepository otherTickets;
+    TrainService trains(&otherTrains);
+    PassengerService passengers(&otherPassengers);
+    TicketService tickets(&otherTickets, &trains, &passengers);
+    trains.createTrain("Nile Express", 3);
+    trains.createTrain("Delta Local", 3);
+    for (const char *name : {"Omar", "Sara Ali", "Karim", "Mona"})
+        passengers.createPassenger(name);
+    BulkImporter importer(&trains, &passengers, &tickets);
+    std::istringstream in(csv);
+    ImportReport report = importer.importStream(ImportKind::Tickets, ImportFormat::Csv, in);
+    EXPECT_EQ(report.imported, 4);
+    EXPECT_EQ(report.rejected, 0);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "Services/BulkImporter.h"
+#include "utils/FieldParser.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class BulkImporterTest : public ::testing::Test {
+protected:
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    InMemoryTicketRepository ticketRepo;
+    TrainService trainService{&trainRepo};
+    PassengerService passengerService{&passengerRepo};
+    TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+    std::string errorPath;
+
+    void SetUp() override {
+        static int counter = 0;
+        errorPath = "/tmp/rms_import_errors_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".csv";
+        std::remove(errorPath.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(errorPath.c_str());
+    }
+
+    ImportReport import(ImportKind kind, ImportFormat format, const std::string &text,
+                        const ImportOptions &options = ImportOptions{}, WorkStealingPool *pool = nullptr) {
+        BulkImporter importer(&trainService, &passengerService, &ticketService, pool);
+        std::istringstream in(text);
+        return importer.importStream(kind, format, in, options);
+    }
+};
+
+TEST(FieldParserTest, SplitsCsvWithQuotes) {
+    ParsedFields fields;
+    std::string error;
+    ASSERT_TRUE(parseCsvLine("1,\"Cairo, Express\",\"say \"\"hi\"\"\",", fields, error));
+    ASSERT_EQ(fields.values.size(), 4u);
+    EXPECT_EQ(fields.values[0], "1");
+    EXPECT_EQ(fields.values[1], "Cairo, Express");
+    EXPECT_EQ(fields.values[2], "say \"hi\"");
+    EXPECT_EQ(fields.values[3], "");
+    EXPECT_FALSE(parseCsvLine("\"open", fields, error));
+    EXPECT_FALSE(parseCsvLine("\"a\"b", fields, error));
+}
+
+TEST(FieldParserTest, ReadsFlatJsonObjects) {
+    ParsedFields fields;
+    std::string error;
+    std::string_view value;
+    ASSERT_TRUE(parseJsonLine(R"({"name": "A\"bA", "seats": 12 , "x": null})", fields, error));
+    ASSERT_TRUE(fields.find("name", value));
+    EXPECT_EQ(value, "A\"bA");
+    ASSERT_TRUE(fields.find("seats", value));
+    int seats = 0;
+    EXPECT_TRUE(parseIntField(value, seats));
+    EXPECT_EQ(seats, 12);
+    EXPECT_FALSE(fields.find("missing", value));
+    EXPECT_FALSE(parseJsonLine(R"({"a": {"b": 1}})", fields, error));
+    EXPECT_FALSE(parseJsonLine(R"({"a": 1} trailing)", fields, error));
+    EXPECT_FALSE(parseIntField("12x", seats));
+}
+
+TEST_F(BulkImporterTest, ImportsTrainsFromCsvAndReportsBadRows) {
+    ImportOptions options;
+    options.errorReportPath = errorPath;
+    ImportReport report = import(ImportKind::Trains, ImportFormat::Csv,
+                                 "Seats, Name\r\n100,Nile Express\r\n\r\n0,Zero\r\nabc,Bad Seats\r\n50,\"Delta Line\"\r\n",
+                                 options);
+    EXPECT_EQ(report.records, 4);
+    EXPECT_EQ(report.imported, 2);
+    EXPECT_EQ(report.rejected, 2);
+
+    auto trains = trainService.getAllTrains();
+    ASSERT_EQ(trains.size(), 2u);
+    EXPECT_EQ(trains[0].getTrainName(), "Nile Express");
+    EXPECT_EQ(trains[1].getTrainName(), "Delta Line");
+    EXPECT_GT(trains[1].getTrainId(), trains[0].getTrainId());
+
+    std::ifstream errors(errorPath);
+    std::string header, first, second, extra;
+    std::getline(errors, header);
+    std::getline(errors, first);
+    std::getline(errors, second);
+    EXPECT_EQ(header, "line,error,record");
+    EXPECT_EQ(first.rfind("4,", 0), 0u); // blank line 3 still counted
+    EXPECT_NE(first.find("\"0,Zero\""), std::string::npos);
+    EXPECT_EQ(second.rfind("5,", 0), 0u);
+    EXPECT_FALSE(std::getline(errors, extra));
+}
+
+TEST_F(BulkImporterTest, ImportsPassengersFromJsonLines) {
+    ImportReport report = import(ImportKind::Passengers, ImportFormat::JsonLines,
+                                 "{\"name\": \"Omar\"}\n{\"name\": \"Sara Ali\", \"extra\": 1}\n{\"name\": \"\"}\nnot json\n");
+    EXPECT_EQ(report.records, 4);
+    EXPECT_EQ(report.imported, 2);
+    EXPECT_EQ(report.rejected, 2);
+    auto passengers = passengerService.getAllPassengers();
+    ASSERT_EQ(passengers.size(), 2u);
+    EXPECT_EQ(passengers[1].getName(), "Sara Ali");
+}
+
+TEST_F(BulkImporterTest, ImportedPassengersReuseStoredNames) {
+    Passenger omar = passengerService.createPassenger("Omar");
+    ImportReport report = import(ImportKind::Passengers, ImportFormat::Csv,
+                                 "name\nomar\nSara\nSARA\nAli\n");
+    EXPECT_EQ(report.imported, 4);
+    auto passengers = passengerService.getAllPassengers();
+    ASSERT_EQ(passengers.size(), 3u); // Omar , Sara , Ali
+    EXPECT_EQ(passengerService.find_or_create_passenger("OMAR").getId(), omar.getId());
+
+    std::vector<Passenger> batch{Passenger(0, "Sara"), Passenger(0, "Mona"), Passenger(0, "mona")};
+    passengerService.importPassengers(batch);
+    EXPECT_EQ(batch[0].getId(), passengerService.find_or_create_passenger("sara").getId());
+    EXPECT_NE(batch[1].getId(), 0);
+    EXPECT_EQ(batch[2].getId(), batch[1].getId());
+    EXPECT_EQ(passengerService.getAllPassengers().size(), 4u);
+}
+
+TEST_F(BulkImporterTest, BooksTicketsAndWaitlistsTheOverflow) {
+    int trainId = trainService.createTrain("Small", 2).getTrainId();
+    for (const char *name : {"A", "B", "C"})
+        passengerService.createPassenger(name);
+    std::ostringstream csv;
+    csv << "train_id,passenger_id,date\n";
+    csv << trainId << ",1,\n" << trainId << ",2,\n" << trainId << ",3,\n";
+    csv << trainId << ",99,\n";       // no such passenger
+    csv << "777,1,\n";                // no such train
+    csv << trainId << ",1,2026-13-01\n"; // bad date
+    ImportOptions options;
+    options.errorReportPath = errorPath;
+    ImportReport report = import(ImportKind::Tickets, ImportFormat::Csv, csv.str(), options);
+    EXPECT_EQ(report.records, 6);
+    EXPECT_EQ(report.imported, 3);
+    EXPECT_EQ(report.waitlisted, 1);
+    EXPECT_EQ(report.rejected, 3);
+    EXPECT_EQ(ticketService.getAllTickets().size(), 2u);
+}
+
+TEST_F(BulkImporterTest, LinesSplitAcrossChunksAreCarriedOver) {
+    std::string text = "name,seats\n";
+    for (int i = 0; i < 200; i++)
+        text += "Train number " + std::to_string(i) + "," + std::to_string(i % 50 + 1) + "\n";
+    text += "Last Train,5"; // no final line break
+    ImportOptions options;
+    options.chunkBytes = 7; // shorter than most lines
+    WorkStealingPool pool(2);
+    ImportReport report = import(ImportKind::Trains, ImportFormat::Csv, text, options, &pool);
+    EXPECT_EQ(report.records, 201);
+    EXPECT_EQ(report.imported, 201);
+    EXPECT_EQ(report.rejected, 0);
+    auto trains = trainService.getAllTrains();
+    ASSERT_EQ(trains.size(), 201u);
+    EXPECT_EQ(trains[0].getTrainName(), "Train number 0");
+    EXPECT_EQ(trains[200].getTrainName(), "Last Train");
+}
+
+TEST_F(BulkImporterTest, RejectsUnusableInput) {
+    EXPECT_THROW(import(ImportKind::Trains, ImportFormat::Csv, "name\nA\n"), std::invalid_argument);
+    EXPECT_THROW(import(ImportKind::Tickets, ImportFormat::Csv, ""), std::invalid_argument);
+    BulkImporter importer(&trainService, &passengerService, &ticketService);
+    EXPECT_THROW(importer.importFile(ImportKind::Trains, "/tmp/trains.txt"), std::invalid_argument);
+    EXPECT_THROW(importer.importFile(ImportKind::Trains, "/tmp/rms_no_such_dir/trains.csv"), std::runtime_error);
+    EXPECT_EQ(BulkImporter::parseKind(" Tickets "), ImportKind::Tickets);
+    EXPECT_THROW(BulkImporter::parseKind("seats"), std::invalid_argument);
+    EXPECT_TRUE(trainService.getAllTrains().empty());
+}
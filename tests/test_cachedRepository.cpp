@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "Repo/CachedTrainRepository.h"
+#include "Repo/CachedTicketRepository.h"
+#include "Repo/CachedPassengerRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "StartupManager.h"
+
+class CachedRepositoryTest : public ::testing::Test {
+protected:
+    InMemoryTrainRepository *storedTrains = nullptr;
+    std::unique_ptr<CachedTrainRepository> trains;
+
+    // the flusher stays idle unless a test asks for it
+    void SetUp() override {
+        CacheOptions options;
+        options.flushIntervalMs = 60000;
+        useTrains(options);
+    }
+
+    void useTrains(const CacheOptions &options) {
+        trains.reset();
+        auto inner = std::make_unique<InMemoryTrainRepository>();
+        storedTrains = inner.get();
+        trains = std::make_unique<CachedTrainRepository>(std::move(inner), options);
+    }
+};
+
+TEST_F(CachedRepositoryTest, RepeatedReadsAreServedFromMemory) {
+    Train train(0, "Nile Express", 10);
+    trains->save(train);
+    EXPECT_EQ(train.getTrainId(), 1);
+    ASSERT_TRUE(storedTrains->getTrainById(1).has_value()); // inserted right away
+
+    for (int i = 0; i < 9; i++)
+        EXPECT_EQ(trains->getTrainById(1)->getTrainName(), "Nile Express");
+    EXPECT_FALSE(trains->getTrainById(2).has_value());
+
+    CacheStats stats = trains->getCacheStats();
+    EXPECT_EQ(stats.hits, 9);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_DOUBLE_EQ(stats.hitRatio(), 0.9);
+    EXPECT_EQ(stats.cached, 1u);
+}
+
+TEST_F(CachedRepositoryTest, RepeatedSavesReachTheRepositoryOnce) {
+    Train train(0, "Nile Express", 10);
+    trains->save(train);
+    for (int seat = 1; seat <= 5; seat++) {
+        train.getSeatAllocator()->allocateSeat(seat);
+        trains->save(train);
+    }
+    EXPECT_EQ(storedTrains->getTrainById(1)->getVersion(), 1); // nothing written yet
+    EXPECT_EQ(trains->getTrainById(1)->getSeatAllocator()->getAllocatedSeatCount(), 5);
+    EXPECT_EQ(trains->getCacheStats().dirty, 1u);
+
+    trains->flush();
+    auto stored = storedTrains->getTrainById(1);
+    EXPECT_EQ(stored->getVersion(), 2);
+    EXPECT_EQ(stored->getSeatAllocator()->getAllocatedSeatCount(), 5);
+
+    CacheStats stats = trains->getCacheStats();
+    EXPECT_EQ(stats.saves, 5);
+    EXPECT_EQ(stats.coalesced, 4);
+    EXPECT_EQ(stats.flushed, 1);
+    EXPECT_EQ(stats.dirty, 0u);
+}
+
+TEST_F(CachedRepositoryTest, StaleCopiesStayStaleAcrossEviction) {
+    CacheOptions options;
+    options.capacity = 1;
+    options.flushIntervalMs = 60000;
+    useTrains(options);
+    Train a(0, "Nile Express", 10), b(0, "Delta Local", 4);
+    trains->save(a);
+    trains->save(b); // a is evicted
+
+    Train stale = *trains->getTrainById(a.getTrainId());
+    Train fresh = stale;
+    fresh.setTrainName("Nile Express II");
+    ASSERT_TRUE(trains->compareAndSave(fresh));
+    trains->flush();
+    trains->getTrainById(b.getTrainId()); // a goes again , read back with the stored version
+
+    Train reloaded = *trains->getTrainById(a.getTrainId());
+    EXPECT_EQ(reloaded.getTrainName(), "Nile Express II");
+    EXPECT_GT(reloaded.getVersion(), fresh.getVersion());
+    stale.setTrainName("Lost Update");
+    EXPECT_FALSE(trains->compareAndSave(stale));
+    EXPECT_TRUE(trains->compareAndSave(reloaded));
+    EXPECT_GE(trains->getCacheStats().evictions, 2);
+}
+
+TEST_F(CachedRepositoryTest, DeletedRecordsAreNotWrittenBack) {
+    Train train(0, "Nile Express", 10);
+    trains->save(train);
+    train.setTrainName("Renamed");
+    trains->save(train); // dirty
+    EXPECT_TRUE(trains->deleteTrain(train.getTrainId()));
+    trains->flush();
+    EXPECT_FALSE(storedTrains->getTrainById(train.getTrainId()).has_value());
+    EXPECT_FALSE(trains->getTrainById(train.getTrainId()).has_value());
+    EXPECT_FALSE(trains->compareAndSave(train));
+}
+
+TEST_F(CachedRepositoryTest, ListingsSeeUnflushedSaves) {
+    Train a(0, "Nile Express", 10), b(0, "Delta Local", 4);
+    trains->save(a);
+    trains->save(b);
+    b.setTrainName("Delta Express");
+    trains->save(b);
+
+    auto all = trains->getAllTrains();
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[1].getTrainName(), "Delta Express");
+    EXPECT_EQ(all[1].getVersion(), b.getVersion()); // the version handed out by the cache
+    EXPECT_EQ(trains->snapshot().find(b.getTrainId())->getTrainName(), "Delta Express");
+    EXPECT_EQ(trains->getTrainsPage(1, 10)[0].getTrainId(), b.getTrainId());
+
+    Train fromSnapshot = *trains->snapshot().find(b.getTrainId()); // stored version , see snapshot()
+    fromSnapshot.setTrainName("Delta Night");
+    EXPECT_FALSE(trains->compareAndSave(fromSnapshot));
+    Train reread = *trains->getTrainById(b.getTrainId());
+    reread.setTrainName("Delta Night");
+    EXPECT_TRUE(trains->compareAndSave(reread));
+}
+
+TEST_F(CachedRepositoryTest, OnlyDirtyRecordsAreFlushed) {
+    vector<Train> created;
+    for (int i = 0; i < 5; i++)
+        created.push_back(Train(0, "Train " + std::to_string(i), 4));
+    trains->saveAll(created);
+    EXPECT_EQ(trains->getCacheStats().dirty, 0u); // inserted right away
+
+    created[3].setTrainName("Renamed");
+    trains->save(created[3]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    created[1].setTrainName("Renamed");
+    trains->save(created[1]);
+    created[4].setTrainName("Gone");
+    trains->save(created[4]);
+    ASSERT_TRUE(trains->deleteTrain(created[4].getTrainId()));
+    CacheStats stats = trains->getCacheStats();
+    EXPECT_EQ(stats.dirty, 2u);
+    EXPECT_GE(stats.oldestDirtyMs, 2); // the first of them
+
+    trains->flush();
+    stats = trains->getCacheStats();
+    EXPECT_EQ(stats.flushed, 2);
+    EXPECT_EQ(stats.dirty, 0u);
+    EXPECT_EQ(stats.oldestDirtyMs, 0);
+    EXPECT_EQ(storedTrains->getTrainById(created[1].getTrainId())->getTrainName(), "Renamed");
+    EXPECT_FALSE(storedTrains->getTrainById(created[4].getTrainId()).has_value());
+}
+
+TEST_F(CachedRepositoryTest, TheFlusherWritesBehindAndReportsItsLag) {
+    CacheOptions options;
+    options.flushIntervalMs = 5;
+    useTrains(options);
+    Train train(0, "Nile Express", 10);
+    trains->save(train);
+    train.setTrainName("Renamed");
+    trains->save(train);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (trains->getCacheStats().flushed == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CacheStats stats = trains->getCacheStats();
+    EXPECT_EQ(stats.flushed, 1);
+    EXPECT_EQ(stats.dirty, 0u);
+    EXPECT_GT(stats.maxFlushLagMs, 0);
+    EXPECT_EQ(stats.oldestDirtyMs, 0);
+    EXPECT_EQ(storedTrains->getTrainById(1)->getTrainName(), "Renamed");
+
+    EXPECT_THROW(CachedTrainRepository(nullptr), std::invalid_argument);
+    options.capacity = 0;
+    EXPECT_THROW(CachedTrainRepository(std::make_unique<InMemoryTrainRepository>(), options), std::invalid_argument);
+}
+
+TEST_F(CachedRepositoryTest, TicketIndexesSeeMovesAtOnce) {
+    auto inner = std::make_unique<InMemoryTicketRepository>();
+    InMemoryTicketRepository *stored = inner.get();
+    CacheOptions options;
+    options.flushIntervalMs = 60000;
+    CachedTicketRepository tickets(std::move(inner), options);
+    Passenger omar(1, "Omar"), sara(2, "Sara");
+
+    vector<Ticket> batch;
+    batch.push_back(Ticket(0, 1, 1, omar));
+    batch.push_back(Ticket(0, 2, 1, sara));
+    tickets.saveAll(batch);
+    EXPECT_EQ(batch[1].getId(), 2);
+    ASSERT_TRUE(stored->getTicketById(2).has_value());
+
+    Ticket ticket = *tickets.getTicketByTrainAndPassenger(1, 1);
+    ticket.setStatus(cancelled);
+    ASSERT_TRUE(tickets.compareAndSave(ticket)); // stays in memory
+    EXPECT_EQ(stored->getTicketById(1)->getStatus(), booked);
+    EXPECT_EQ(tickets.getTicketByTrainAndPassenger(1, 1)->getStatus(), cancelled);
+    EXPECT_EQ(tickets.getTicketsByPassenger(1)[0].getStatus(), cancelled);
+
+    Passenger karim(3, "Karim");
+    ticket.setPassenger(karim);
+    tickets.save(ticket); // a new key is written through
+    EXPECT_EQ(stored->getTicketByTrainAndPassenger(1, 3)->getStatus(), cancelled);
+    EXPECT_FALSE(tickets.getTicketByTrainAndPassenger(1, 1).has_value());
+    EXPECT_EQ(tickets.getTicketByTrainAndPassenger(1, 3)->getVersion(), ticket.getVersion());
+
+    // updates and inserts in one batch
+    Ticket seat = *tickets.getTicketById(2);
+    seat.setSeat(4);
+    vector<Ticket> mixed;
+    mixed.push_back(seat);
+    mixed.push_back(Ticket(0, 3, 1, omar));
+    tickets.saveAll(mixed);
+    EXPECT_EQ(mixed[1].getId(), 3);
+    EXPECT_EQ(tickets.getAllTickets().size(), 3u);
+    EXPECT_EQ(stored->getTicketById(2)->getSeat(), 4); // listed after a flush
+}
+
+TEST_F(CachedRepositoryTest, RenamedPassengersAreFoundByTheirNewName) {
+    CacheOptions options;
+    options.flushIntervalMs = 60000;
+    CachedPassengerRepository passengers(std::make_unique<InMemoryPassengerRepository>(), options);
+    Passenger omar(0, "Omar");
+    passengers.save(omar);
+    ASSERT_EQ(omar.getId(), 1);
+    EXPECT_EQ(passengers.findPassengerByName("omar")->getId(), 1);
+
+    Passenger renamed = *passengers.getPassenger(1);
+    renamed.setName("Omar Khaled");
+    ASSERT_TRUE(passengers.compareAndSave(renamed));
+    EXPECT_FALSE(passengers.findPassengerByName("Omar").has_value());
+    EXPECT_EQ(passengers.findPassengerByName("omar khaled")->getVersion(), renamed.getVersion());
+    EXPECT_FALSE(passengers.compareAndSave(omar));
+    EXPECT_TRUE(passengers.deletePassenger(1));
+    EXPECT_EQ(passengers.getAllPassengers().size(), 0u);
+}
+
+TEST_F(CachedRepositoryTest, StartupManagerCachesTheDatabase) {
+    std::string path = "/tmp/rms_cache_test_" + std::to_string(getpid()) + ".db";
+    for (const char *suffix : {"", "-wal", "-shm"})
+        std::remove((path + suffix).c_str());
+    int trainId, ticketId;
+    {
+        StartupManager manager;
+        manager.useSqlite(path);
+        manager.useCache();
+        RMSFacade *facade = manager.buildFacade();
+        trainId = facade->addTrain("Cached Express", 2).getTrainId();
+        ticketId = facade->bookTicket(trainId, "Omar")->getId();
+        facade->bookTicket(trainId, "Sara");
+        facade->cancelTicket(ticketId);
+    } // pending saves are flushed here
+    {
+        StartupManager manager;
+        manager.useSqlite(path);
+        RMSFacade *facade = manager.buildFacade();
+        EXPECT_EQ(facade->getTicket(ticketId).getStatus(), cancelled);
+        EXPECT_EQ(facade->getTrain(trainId).getSeatAllocator()->getAllocatedSeatCount(), 1);
+    }
+    for (const char *suffix : {"", "-wal", "-shm"})
+        std::remove((path + suffix).c_str());
+
+    StartupManager shared;
+    shared.useSharedMemory("/rms_cache_test");
+    EXPECT_THROW(shared.useCache(), std::logic_error);
+    StartupManager cached;
+    cached.useCache();
+    EXPECT_THROW(cached.useSharedMemory("/rms_cache_test"), std::logic_error);
+    CacheOptions none;
+    none.capacity = 0;
+    EXPECT_THROW(cached.useCache(none), std::invalid_argument);
+}
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Repo/Checkpointer.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "StartupManager.h"
+
+class CheckpointerTest : public ::testing::Test {
+protected:
+    std::string path;
+    std::unique_ptr<WriteAheadLog> wal, checkpointLog;
+    std::unique_ptr<DurableTrainRepository> trains;
+    std::unique_ptr<DurableTicketRepository> tickets;
+    std::unique_ptr<DurablePassengerRepository> passengers;
+    std::unique_ptr<Checkpointer> checkpointer;
+
+    void SetUp() override {
+        static int counter = 0;
+        path = "/tmp/rms_checkpoint_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".log";
+        removeFiles();
+    }
+
+    void TearDown() override {
+        close();
+        removeFiles();
+    }
+
+    void removeFiles() {
+        std::remove(path.c_str());
+        std::remove((path + ".checkpoint").c_str());
+    }
+
+    // what StartupManager does : the checkpoint log , then the write-ahead log . the timer stays idle
+    void open(CheckpointOptions options = CheckpointOptions{}) {
+        close();
+        if (options.intervalMs == CheckpointOptions{}.intervalMs)
+            options.intervalMs = 600000;
+        wal = std::make_unique<WriteAheadLog>(path);
+        checkpointLog = std::make_unique<WriteAheadLog>(path + ".checkpoint");
+        trains = std::make_unique<DurableTrainRepository>(std::make_unique<InMemoryTrainRepository>(), wal.get());
+        tickets = std::make_unique<DurableTicketRepository>(std::make_unique<InMemoryTicketRepository>(), wal.get());
+        passengers = std::make_unique<DurablePassengerRepository>(std::make_unique<InMemoryPassengerRepository>(), wal.get());
+        auto apply = [&](const WalRecord &record) {
+            switch (record.table) {
+            case WalTable::Trains: trains->apply(record); break;
+            case WalTable::Tickets: tickets->apply(record); break;
+            case WalTable::Passengers: passengers->apply(record); break;
+            }
+        };
+        checkpointLog->replay(apply);
+        trains->takeDirty(trains->lockWrites());
+        tickets->takeDirty(tickets->lockWrites());
+        passengers->takeDirty(passengers->lockWrites());
+        wal->replay(apply);
+        checkpointer = std::make_unique<Checkpointer>(trains.get(), tickets.get(), passengers.get(), wal.get(),
+                                                      checkpointLog.get(), options);
+    }
+
+    void close() {
+        checkpointer.reset();
+        trains.reset();
+        tickets.reset();
+        passengers.reset();
+        checkpointLog.reset();
+        wal.reset();
+    }
+
+    Train addTrain(const std::string &name) {
+        Train train(0, name, 10);
+        trains->save(train);
+        return train;
+    }
+};
+
+TEST_F(CheckpointerTest, OnlyChangedRecordsAreCheckpointed) {
+    open();
+    std::vector<Train> added;
+    for (int i = 0; i < 100; i++)
+        added.push_back(addTrain("T" + std::to_string(i)));
+    Passenger omar(0, "Omar");
+    passengers->save(omar);
+    CheckpointStats first = checkpointer->checkpoint();
+    EXPECT_EQ(first.records, 101);
+    EXPECT_GT(first.walDiscarded, 0);
+
+    for (int i = 0; i < 3; i++) {
+        added[i].setTrainName("Renamed " + std::to_string(i));
+        trains->save(added[i]);
+        trains->save(added[i]); // twice , checkpointed once
+    }
+    CheckpointStats second = checkpointer->checkpoint();
+    EXPECT_EQ(second.records - first.records, 3);
+    EXPECT_EQ(second.checkpoints, 2);
+    EXPECT_EQ(second.fullRewrites, 0);
+
+    CheckpointStats idle = checkpointer->checkpoint();
+    EXPECT_EQ(idle.records, second.records);
+    EXPECT_LT(idle.walBytes, 64); // the header , nothing left to replay
+}
+
+TEST_F(CheckpointerTest, RecoveryReplaysTheCheckpointThenTheLogTail) {
+    open();
+    Train kept = addTrain("Kept"), dropped = addTrain("Dropped");
+    Passenger sara(0, "Sara");
+    passengers->save(sara);
+    Ticket ticket(0, 1, kept.getTrainId(), sara);
+    tickets->save(ticket);
+    checkpointer->checkpoint();
+
+    // after the checkpoint : only in the write-ahead log
+    ASSERT_TRUE(trains->deleteTrain(dropped.getTrainId()));
+    kept.setTrainName("Kept 2");
+    trains->save(kept);
+    Train late = addTrain("Late");
+    long long walBefore = wal->getStats().size;
+    open();
+    EXPECT_EQ(wal->getStats().size, walBefore);
+
+    auto all = trains->getAllTrains();
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(trains->getTrainById(kept.getTrainId())->getTrainName(), "Kept 2");
+    EXPECT_FALSE(trains->getTrainById(dropped.getTrainId()).has_value());
+    EXPECT_TRUE(trains->getTrainById(late.getTrainId()).has_value());
+    EXPECT_EQ(tickets->getTicketById(ticket.getId())->getPassenger().getName(), "Sara");
+    EXPECT_TRUE(passengers->findPassengerByName("Sara").has_value());
+
+    // the replayed tail is the next checkpoint's , the one after it starts from an empty log
+    CheckpointStats stats = checkpointer->checkpoint();
+    EXPECT_EQ(stats.records, 3); // the delete , Kept 2 and Late
+    open();
+    EXPECT_EQ(trains->getAllTrains().size(), 2u);
+    EXPECT_FALSE(trains->getTrainById(dropped.getTrainId()).has_value());
+}
+
+TEST_F(CheckpointerTest, ClearsAndDeletesReachTheCheckpoint) {
+    open();
+    Passenger ali(0, "Ali");
+    passengers->save(ali);
+    Train train = addTrain("Cleared");
+    for (int seat = 1; seat <= 3; seat++) {
+        Ticket ticket(0, seat, train.getTrainId(), ali);
+        tickets->save(ticket);
+    }
+    checkpointer->checkpoint();
+    tickets->clear();
+    Ticket after(0, 4, train.getTrainId(), ali);
+    tickets->save(after);
+    ASSERT_TRUE(passengers->deletePassenger(ali.getId()));
+    checkpointer->checkpoint();
+    EXPECT_LT(wal->getStats().size, 64);
+
+    open();
+    auto left = tickets->getAllTickets();
+    ASSERT_EQ(left.size(), 1u);
+    EXPECT_EQ(left[0].getSeat(), 4);
+    EXPECT_EQ(passengers->getAllPassengers().size(), 0u);
+    EXPECT_EQ(trains->getAllTrains().size(), 1u);
+}
+
+TEST_F(CheckpointerTest, CheckpointLogIsRewrittenWhenItOutgrowsItself) {
+    CheckpointOptions options;
+    options.rewriteRatio = 2;
+    options.minRewriteBytes = 1;
+    open(options);
+    for (int i = 0; i < 10; i++)
+        addTrain("T" + std::to_string(i));
+    checkpointer->checkpoint();
+    long long full = checkpointLog->getStats().size;
+
+    Train hot = *trains->getTrainById(1);
+    for (int round = 0; round < 50; round++) {
+        hot.setTrainName("Hot " + std::to_string(round));
+        trains->save(hot);
+        checkpointer->checkpoint();
+        EXPECT_LE(checkpointLog->getStats().size, 2 * full + 200);
+    }
+    CheckpointStats stats = checkpointer->getStats();
+    EXPECT_GT(stats.fullRewrites, 0);
+    EXPECT_GT(checkpointLog->getStats().discarded, 0);
+
+    open(options);
+    EXPECT_EQ(trains->getAllTrains().size(), 10u);
+    EXPECT_EQ(trains->getTrainById(1)->getTrainName(), "Hot 49");
+}
+
+TEST_F(CheckpointerTest, TimerCheckpointsInTheBackground) {
+    CheckpointOptions options;
+    options.intervalMs = 5;
+    open(options);
+    addTrain("Background");
+    for (int i = 0; i < 400 && checkpointer->getStats().checkpoints == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_GT(checkpointer->getStats().checkpoints, 0);
+    EXPECT_EQ(checkpointer->getStats().failures, 0);
+}
+
+TEST_F(CheckpointerTest, DiscardBeforeKeepsTheRecordsFromTheOffsetOn) {
+    {
+        WriteAheadLog log(path);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, "first"));
+        uint64_t mark = log.endOffset();
+        log.commit(log.append(WalTable::Trains, WalOp::Put, "second"));
+        EXPECT_THROW(log.discardBefore(log.endOffset() + 1), std::invalid_argument);
+        log.discardBefore(mark);
+        EXPECT_GT(log.getStats().discarded, 0);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, "third")); // goes on in the new file
+        EXPECT_EQ(log.endOffset(), (uint64_t)log.getStats().size);
+    }
+    WriteAheadLog log(path);
+    std::vector<std::string> bodies;
+    log.replay([&](const WalRecord &record) { bodies.push_back(record.body); });
+    EXPECT_EQ(bodies, (std::vector<std::string>{"second", "third"}));
+}
+
+TEST_F(CheckpointerTest, CompactionWhileAppendingLosesNoAcknowledgedWrite) {
+    CheckpointOptions options;
+    options.intervalMs = 1;
+    open(options);
+    const int writers = 4, perWriter = 300;
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; w++)
+        threads.emplace_back([&, w] {
+            for (int i = 0; i < perWriter; i++)
+                addTrain("W" + std::to_string(w) + "-" + std::to_string(i));
+        });
+    // the timer compacts in the background , these compact in between
+    for (int i = 0; i < 50; i++)
+        checkpointer->checkpoint();
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_GT(checkpointer->getStats().checkpoints, 50);
+    EXPECT_EQ(checkpointer->getStats().failures, 0);
+
+    open();
+    EXPECT_EQ(trains->getAllTrains().size(), (size_t)(writers * perWriter));
+}
+
+TEST_F(CheckpointerTest, StartupManagerRecoversFromTheCheckpoint) {
+    int trainId, ticketId;
+    size_t ticketCount;
+    {
+        StartupManager manager;
+        manager.useWriteAheadLog(path);
+        CheckpointOptions options;
+        options.intervalMs = 600000;
+        manager.useCheckpoints(options);
+        RMSFacade *facade = manager.buildFacade();
+        trainId = facade->addTrain("Checkpointed", 5).getTrainId();
+        ticketId = facade->bookTicket(trainId, "Omar")->getId();
+        EXPECT_GT(manager.checkpoint().records, 0);
+        facade->cancelTicket(ticketId); // after the checkpoint
+        facade->bookTicket(trainId, "Sara");
+        ticketCount = facade->listTickets().size();
+    }
+    StartupManager manager;
+    manager.useWriteAheadLog(path);
+    manager.useCheckpoints();
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 6u); // the mock data is not loaded again
+    EXPECT_EQ(facade->listTickets().size(), ticketCount);
+    EXPECT_EQ(facade->getTicket(ticketId).getStatus(), cancelled);
+    EXPECT_EQ(facade->getTrain(trainId).getSeatAllocator()->getAllocatedSeatCount(), 1);
+    EXPECT_GT(facade->bookTicket(trainId, "Ali")->getId(), ticketId);
+    EXPECT_NE(manager.getCheckpointer(), nullptr);
+}
+
+TEST_F(CheckpointerTest, OptionsAreChecked) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useCheckpoints(), std::logic_error); // no write-ahead log yet
+    manager.useWriteAheadLog(path);
+    CheckpointOptions bad;
+    bad.intervalMs = 0;
+    EXPECT_THROW(manager.useCheckpoints(bad), std::invalid_argument);
+    bad = CheckpointOptions{};
+    bad.rewriteRatio = 1;
+    EXPECT_THROW(manager.useCheckpoints(bad), std::invalid_argument);
+    manager.buildFacade();
+    EXPECT_THROW(manager.checkpoint(), std::logic_error);
+    EXPECT_EQ(manager.getCheckpointer(), nullptr);
+    EXPECT_THROW(manager.useCheckpoints(), std::logic_error);
+
+    WriteAheadLog log(path + ".other");
+    EXPECT_THROW(Checkpointer(nullptr, nullptr, nullptr, &log, &log), std::invalid_argument);
+    std::remove((path + ".other").c_str());
+}
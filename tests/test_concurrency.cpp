@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <set>
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "utils/StripedLock.h"
+
+class ConcurrencyTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+
+    vector<int> makePassengers(int count) {
+        vector<int> ids;
+        for (int i = 0; i < count; i++)
+            ids.push_back(passengerService->createPassenger("P" + std::to_string(i)).getId());
+        return ids;
+    }
+
+    template <typename Fn>
+    static void runThreads(int threads, Fn fn) {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++)
+            pool.emplace_back(fn, t);
+        for (auto &th : pool)
+            th.join();
+    }
+};
+
+TEST_F(ConcurrencyTest, StripedLockMapsKeysToStripes) {
+    StripedLock locks(8);
+    EXPECT_EQ(locks.stripeOf(3), locks.stripeOf(11));
+    EXPECT_NE(locks.stripeOf(3), locks.stripeOf(4));
+    auto first = locks.lock(3);
+    auto again = locks.lock(11); // same stripe , same thread
+    EXPECT_TRUE(again.owns_lock());
+}
+
+TEST_F(ConcurrencyTest, OneTrainNeverSellsASeatTwice) {
+    const int seats = 40, threads = 8, perThread = 10;
+    Train train = trainService->createTrain("Express", seats);
+    vector<int> passengers = makePassengers(threads * perThread);
+
+    std::atomic<int> booked{0}, waiting{0};
+    runThreads(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++) {
+            auto ticket = ticketService->bookTicket(train.getTrainId(), passengers[t * perThread + i]);
+            (ticket.has_value() ? booked : waiting)++;
+        }
+    });
+
+    EXPECT_EQ(booked.load(), seats);
+    EXPECT_EQ(waiting.load(), threads * perThread - seats);
+    std::set<int> seatsSold, ticketIds;
+    for (const auto &ticket : ticketService->getAllTickets()) {
+        seatsSold.insert(ticket.getSeat());
+        ticketIds.insert(ticket.getId());
+    }
+    EXPECT_EQ(seatsSold.size(), (size_t)seats);
+    EXPECT_EQ(ticketIds.size(), (size_t)seats);
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), seats);
+    EXPECT_EQ(stored.getSeatAllocator()->getWaitingListSize(), threads * perThread - seats);
+}
+
+TEST_F(ConcurrencyTest, TrainsBookInParallel) {
+    const int trains = 8, seats = 25;
+    vector<int> trainIds;
+    for (int t = 0; t < trains; t++)
+        trainIds.push_back(trainService->createTrain("Train " + std::to_string(t), seats).getTrainId());
+    vector<int> passengers = makePassengers(seats);
+
+    runThreads(trains, [&](int t) {
+        for (int p : passengers)
+            ticketService->bookTicket(trainIds[t], p);
+    });
+
+    EXPECT_EQ(ticketService->getAllTickets().size(), (size_t)(trains * seats));
+    for (int id : trainIds)
+        EXPECT_FALSE(trainService->getTrain(id).hasAvailableSeats());
+}
+
+TEST_F(ConcurrencyTest, CancelSucceedsOnce) {
+    Train train = trainService->createTrain("Express", 4);
+    vector<int> passengers = makePassengers(1);
+    Ticket ticket = ticketService->bookTicket(train.getTrainId(), passengers[0]).value();
+
+    std::atomic<int> succeeded{0}, failed{0};
+    runThreads(8, [&](int) {
+        try {
+            ticketService->cancelTicket(ticket.getId());
+            succeeded++;
+        } catch (const std::runtime_error &) {
+            failed++;
+        }
+    });
+    EXPECT_EQ(succeeded.load(), 1);
+    EXPECT_EQ(failed.load(), 7);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAvailableSeatCount(), 4);
+}
+
+TEST_F(ConcurrencyTest, FindOrCreateIsAtomic) {
+    std::vector<int> ids(8);
+    runThreads(8, [&](int t) {
+        ids[t] = passengerService->find_or_create_passenger("Alice").getId();
+    });
+    for (int id : ids)
+        EXPECT_EQ(id, ids[0]);
+    EXPECT_EQ(passengerService->getAllPassengers().size(), 1);
+}
+
+TEST_F(ConcurrencyTest, ConcurrentIdsAreUnique) {
+    runThreads(8, [&](int t) {
+        for (int i = 0; i < 50; i++)
+            passengerService->createPassenger("T" + std::to_string(t) + " N" + std::to_string(i));
+    });
+    std::set<int> ids;
+    for (const auto &p : passengerService->getAllPassengers())
+        ids.insert(p.getId());
+    EXPECT_EQ(ids.size(), 400u);
+}
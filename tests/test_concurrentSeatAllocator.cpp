@@ -0,0 +1,333 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <vector>
+#include "models/ConcurrentSeatAllocator.h"
+#include "structures/mpscQueue.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class ConcurrentSeatAllocatorTest : public ::testing::Test {
+protected:
+    template <typename Fn>
+    static void runThreads(int threads, Fn fn) {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++)
+            pool.emplace_back(fn, t);
+        for (auto &th : pool)
+            th.join();
+    }
+};
+
+// ===================== MPSC queue =====================
+
+TEST_F(ConcurrentSeatAllocatorTest, MpscQueueKeepsPerProducerOrder) {
+    MpscQueue<int> q;
+    runThreads(4, [&](int t) {
+        for (int i = 0; i < 1000; i++)
+            q.push(t * 10000 + i);
+    });
+    EXPECT_EQ(q.size(), 4000);
+    int last[4] = {-1, -1, -1, -1}, value, popped = 0;
+    while (q.tryPop(value)) {
+        int producer = value / 10000;
+        EXPECT_GT(value % 10000, last[producer]);
+        last[producer] = value % 10000;
+        popped++;
+    }
+    EXPECT_EQ(popped, 4000);
+    EXPECT_TRUE(q.empty());
+}
+
+// ===================== single thread =====================
+
+TEST_F(ConcurrentSeatAllocatorTest, AllocatesEverySeatOnce) {
+    ConcurrentSeatAllocator allocator(70); // spans two words
+    std::set<int> seats;
+    for (int p = 1; p <= 70; p++) {
+        int seat = allocator.allocateSeat(p);
+        EXPECT_GE(seat, 1);
+        EXPECT_LE(seat, 70);
+        EXPECT_EQ(allocator.getSeatOwner(seat), p);
+        seats.insert(seat);
+    }
+    EXPECT_EQ(seats.size(), 70u);
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 0);
+    EXPECT_EQ(allocator.allocateSeat(71), -1);
+    EXPECT_EQ(allocator.getWaitingListSize(), 1);
+}
+
+TEST_F(ConcurrentSeatAllocatorTest, FreeAndDrainSeatsWaitingPassengersInOrder) {
+    ConcurrentSeatAllocator allocator(2);
+    int a = allocator.allocateSeat(1);
+    allocator.allocateSeat(2);
+    EXPECT_EQ(allocator.allocateSeat(3), -1);
+    EXPECT_EQ(allocator.allocateSeat(4), -1);
+
+    EXPECT_EQ(allocator.freeSeat(a), 1);
+    EXPECT_TRUE(allocator.isSeatFree(a));
+    std::vector<std::pair<int, int>> seated;
+    EXPECT_EQ(allocator.drainWaitingList([&](int p, int s) { seated.push_back({p, s}); }), 1);
+    ASSERT_EQ(seated.size(), 1u);
+    EXPECT_EQ(seated[0].first, 3);
+    EXPECT_EQ(seated[0].second, a);
+    EXPECT_EQ(allocator.getWaitingListSize(), 1);
+    EXPECT_EQ(allocator.drainWaitingList(), 0); // still full
+}
+
+TEST_F(ConcurrentSeatAllocatorTest, StartsFromFreeBitmapAndClaimsGivenSeats) {
+    Bitset free(6); // seats 1 - 5
+    free.setRange(1, 5);
+    free.reset(2);
+    ConcurrentSeatAllocator allocator(free);
+    EXPECT_EQ(allocator.getTotalSeats(), 5);
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 4);
+    EXPECT_EQ(allocator.getSeatOwner(2), -1);
+    EXPECT_FALSE(allocator.claimSeat(2, 7));
+    EXPECT_TRUE(allocator.claimSeat(4, 7));
+    EXPECT_EQ(allocator.getSeatOwner(4), 7);
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 3);
+    for (int p = 1; p <= 3; p++)
+        EXPECT_NE(allocator.tryAllocateSeat(p), -1);
+    EXPECT_EQ(allocator.tryAllocateSeat(9), -1);
+    EXPECT_EQ(allocator.getWaitingListSize(), 0); // try does not queue
+    EXPECT_EQ(allocator.freeSeat(2), -1);
+}
+
+TEST_F(ConcurrentSeatAllocatorTest, InvalidFreesThrow) {
+    ConcurrentSeatAllocator allocator(4);
+    EXPECT_THROW(allocator.freeSeat(0), std::invalid_argument);
+    EXPECT_THROW(allocator.freeSeat(5), std::invalid_argument);
+    EXPECT_THROW(allocator.freeSeat(2), std::out_of_range);
+    EXPECT_THROW(allocator.allocateSeat(0), std::invalid_argument);
+}
+
+// ===================== stress =====================
+
+// every successful claim must see the seat empty in a shadow occupancy table ,
+// and every free must return the passenger that claimed it
+TEST_F(ConcurrentSeatAllocatorTest, StressNoSeatHeldTwice) {
+    const int seats = 128, threads = 8, rounds = 20000;
+    ConcurrentSeatAllocator allocator(seats);
+    std::vector<std::atomic<int>> occupancy(seats + 1);
+    std::atomic<int> violations{0}, waitlisted{0};
+
+    runThreads(threads, [&](int t) {
+        std::vector<std::pair<int, int>> mine;
+        for (int i = 0; i < rounds; i++) {
+            int passenger = t * rounds + i + 1;
+            int seat = allocator.allocateSeat(passenger);
+            if (seat < 0) {
+                waitlisted++;
+                continue;
+            }
+            if (occupancy[seat].fetch_add(1) != 0)
+                violations++;
+            mine.push_back({seat, passenger});
+            if (mine.size() > 12 || i % 3 == 0) { // keep the train near full
+                auto [s, p] = mine.front();
+                mine.erase(mine.begin());
+                occupancy[s].fetch_sub(1);
+                if (allocator.freeSeat(s) != p)
+                    violations++;
+            }
+        }
+        for (auto [s, p] : mine) {
+            occupancy[s].fetch_sub(1);
+            if (allocator.freeSeat(s) != p)
+                violations++;
+        }
+    });
+
+    EXPECT_EQ(violations.load(), 0);
+    EXPECT_EQ(allocator.getAvailableSeatCount(), seats);
+    for (int s = 1; s <= seats; s++)
+        EXPECT_TRUE(allocator.isSeatFree(s));
+    EXPECT_EQ(allocator.getWaitingListSize(), waitlisted.load());
+    EXPECT_EQ(allocator.drainWaitingList(), std::min(seats, waitlisted.load()));
+}
+
+// the outcome must match some sequential order : exactly `seats` winners ,
+// everyone else queued , and a later drain seats the queue in full
+TEST_F(ConcurrentSeatAllocatorTest, SaleOpenRushIsLinearizable) {
+    const int seats = 100, threads = 8, perThread = 50;
+    ConcurrentSeatAllocator allocator(seats);
+    std::vector<std::vector<int>> won(threads);
+
+    runThreads(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++) {
+            int seat = allocator.allocateSeat(t * perThread + i + 1);
+            if (seat > 0)
+                won[t].push_back(seat);
+        }
+    });
+
+    std::set<int> seatsSold;
+    size_t winners = 0;
+    for (auto &w : won) {
+        winners += w.size();
+        seatsSold.insert(w.begin(), w.end());
+    }
+    EXPECT_EQ(winners, (size_t)seats);
+    EXPECT_EQ(seatsSold.size(), (size_t)seats);
+    EXPECT_EQ(allocator.getWaitingListSize(), threads * perThread - seats);
+
+    // concurrent frees racing with concurrent drains
+    runThreads(4, [&](int t) {
+        for (int s = t + 1; s <= seats; s += 4) {
+            allocator.freeSeat(s);
+            allocator.drainWaitingList();
+        }
+    });
+    allocator.drainWaitingList();
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 0);
+    EXPECT_EQ(allocator.getWaitingListSize(), threads * perThread - 2 * seats);
+}
+
+// ===================== TicketService in SeatClaims mode =====================
+
+class SeatClaimsBookingTest : public ConcurrentSeatAllocatorTest {
+protected:
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService{&trainRepo};
+    PassengerService passengerService{&passengerRepo};
+    TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+
+    void SetUp() override {
+        ticketService.setConcurrencyMode(ConcurrencyMode::SeatClaims);
+    }
+
+    std::vector<int> makePassengers(int count) {
+        std::vector<int> ids;
+        for (int i = 0; i < count; i++)
+            ids.push_back(passengerService.createPassenger("P" + std::to_string(i)).getId());
+        return ids;
+    }
+
+    // every booked ticket owns its seat in the train and no seat is sold twice
+    void expectTicketsMatchTrain(int trainId, int travelDate) {
+        Train train = trainService.getTrain(trainId);
+        SeatAllocator *inventory = train.findSeatAllocator(travelDate);
+        ASSERT_NE(inventory, nullptr);
+        std::set<int> seats;
+        int bookedCount = 0;
+        for (const Ticket &ticket : ticketRepo.getAllTickets()) {
+            if (ticket.getStatus() != booked || ticket.getTrainId() != trainId)
+                continue;
+            bookedCount++;
+            EXPECT_TRUE(seats.insert(ticket.getSeat()).second) << "seat " << ticket.getSeat();
+            EXPECT_EQ(inventory->getSeatOwner(ticket.getSeat()), ticket.getPassenger().getId());
+        }
+        EXPECT_EQ(inventory->getAllocatedSeatCount(), bookedCount);
+    }
+};
+
+TEST_F(SeatClaimsBookingTest, SaleOpenRushSellsEverySeatOnce) {
+    const int seats = 100, threads = 8, perThread = 50;
+    int trainId = trainService.createTrain("Hot", seats).getTrainId();
+    std::vector<int> passengers = makePassengers(threads * perThread);
+    std::atomic<int> sold{0}, waitlisted{0};
+
+    runThreads(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++) {
+            if (ticketService.bookTicket(trainId, passengers[t * perThread + i]).has_value())
+                sold++;
+            else
+                waitlisted++;
+        }
+    });
+
+    EXPECT_EQ(sold.load(), seats);
+    EXPECT_EQ(waitlisted.load(), threads * perThread - seats);
+    EXPECT_EQ(trainService.getTrain(trainId).getSeatAllocator()->getWaitingListSize(), threads * perThread - seats);
+    expectTicketsMatchTrain(trainId, 0);
+}
+
+// preference bookings and holds take seats on the locked path behind the claims' back
+TEST_F(SeatClaimsBookingTest, LockedPathsAndClaimsNeverShareASeat) {
+    const int seats = 60;
+    int trainId = trainService.createTrain("Hot", seats).getTrainId();
+    std::vector<int> passengers = makePassengers(90);
+    SeatRequest window;
+    window.preferences = SEAT_WINDOW;
+    std::atomic<int> held{0};
+
+    runThreads(6, [&](int t) {
+        for (int i = t; i < 90; i += 6) {
+            try {
+                if (t == 0)
+                    ticketService.bookTicket(trainId, passengers[i], window);
+                else if (t == 1) {
+                    ticketService.holdSeat(trainId, passengers[i], 600);
+                    held++;
+                }
+                else
+                    ticketService.bookTicket(trainId, passengers[i]);
+            } catch (const std::exception &) {
+                // a hold on a full train
+            }
+        }
+    });
+
+    Train train = trainService.getTrain(trainId);
+    SeatAllocator *inventory = train.getSeatAllocator();
+    EXPECT_EQ(inventory->getHeldSeatCount(), held.load());
+    EXPECT_EQ(inventory->getAvailableSeatCount(), 0);
+    expectTicketsMatchTrain(trainId, 0);
+}
+
+TEST_F(SeatClaimsBookingTest, CancelledSeatIsClaimedAgain) {
+    int trainId = trainService.createTrain("Hot", 3).getTrainId();
+    std::vector<int> passengers = makePassengers(4);
+    std::vector<Ticket> tickets;
+    for (int i = 0; i < 3; i++)
+        tickets.push_back(ticketService.bookTicket(trainId, passengers[i], SeatRequest{}, 20261020).value());
+
+    ticketService.cancelTicket(tickets[1].getId());
+    auto again = ticketService.bookTicket(trainId, passengers[3], SeatRequest{}, 20261020);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(again->getSeat(), tickets[1].getSeat());
+    expectTicketsMatchTrain(trainId, 20261020);
+}
+
+TEST_F(SeatClaimsBookingTest, RefusedClaimGivesItsSeatBack) {
+    int trainId = trainService.createTrain("Hot", 2).getTrainId();
+    std::vector<int> passengers = makePassengers(2);
+    ASSERT_TRUE(ticketService.bookTicket(trainId, passengers[0]).has_value());
+    EXPECT_THROW(ticketService.bookTicket(trainId, passengers[0]), std::runtime_error);
+    EXPECT_THROW(ticketService.bookTicket(trainId, 9999), std::out_of_range);
+    EXPECT_THROW(ticketService.bookTicket(9999, passengers[1]), std::out_of_range);
+
+    auto second = ticketService.bookTicket(trainId, passengers[1]);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(trainService.getTrain(trainId).getSeatAllocator()->getAvailableSeatCount(), 0);
+    expectTicketsMatchTrain(trainId, 0);
+}
+
+// the claims were built for 10 seats , the train shrank to 5 under them
+TEST_F(SeatClaimsBookingTest, ClaimsPastAShrunkTrainAreRebuilt) {
+    int trainId = trainService.createTrain("Hot", 10).getTrainId();
+    std::vector<int> passengers = makePassengers(8);
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(ticketService.bookTicket(trainId, passengers[i]).has_value());
+    trainService.updateTrain(trainId, "", 5);
+
+    EXPECT_FALSE(ticketService.bookTicket(trainId, passengers[5]).has_value()); // waitlisted , not "Invalid seat number."
+    EXPECT_FALSE(ticketService.bookTicket(trainId, passengers[6]).has_value());
+    trainService.addSeats(trainId, 1);
+    EXPECT_TRUE(ticketService.bookTicket(trainId, passengers[7]).has_value());
+    expectTicketsMatchTrain(trainId, 0);
+}
+
+TEST_F(SeatClaimsBookingTest, ParsesModeNames) {
+    EXPECT_EQ(parseConcurrencyMode("claims"), ConcurrencyMode::SeatClaims);
+    EXPECT_EQ(parseConcurrencyMode(" Optimistic "), ConcurrencyMode::Optimistic);
+    EXPECT_THROW(parseConcurrencyMode("spin"), std::invalid_argument);
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "models/SeatAllocator.h"
+#include "structures/bitset.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class DefragmentationTest : public ::testing::Test {
+protected:
+    SeatRequest flexible;
+
+    void SetUp() override {
+        flexible.flexible = true;
+    }
+    void TearDown() override {}
+
+    // every seat booked flexibly , then the given seats cancelled
+    SeatAllocator scattered(int seats, std::initializer_list<int> cancelled) {
+        SeatAllocator allocator(seats);
+        for (int p = 1; p <= seats; p++)
+            allocator.allocateSeat(p, flexible);
+        for (int seat : cancelled)
+            allocator.freeSeat(seat);
+        return allocator;
+    }
+};
+
+// ===================== Bitset runs =====================
+
+TEST_F(DefragmentationTest, Bitset_LongestRun) {
+    Bitset bits(200);
+    bits.setRange(3, 5);
+    bits.setRange(60, 140);
+    bits.set(150);
+    size_t start = 0;
+    EXPECT_EQ(bits.longestRunIn(0, 199, &start), 81);
+    EXPECT_EQ(start, 60);
+    EXPECT_EQ(bits.longestRunIn(0, 100, &start), 41);
+    EXPECT_EQ(bits.longestRunIn(6, 59, &start), 0);
+    EXPECT_EQ(start, Bitset::npos);
+}
+
+TEST_F(DefragmentationTest, Bitset_FindLastAndFirstClear) {
+    Bitset bits(130);
+    bits.setRange(0, 129);
+    EXPECT_EQ(bits.findFirstClearIn(0, 129), Bitset::npos);
+    bits.reset(70);
+    EXPECT_EQ(bits.findFirstClearIn(10, 129), 70);
+    EXPECT_EQ(bits.findLastIn(0, 70), 69);
+    EXPECT_EQ(bits.findLastIn(70, 70), Bitset::npos);
+}
+
+// ===================== Allocator =====================
+
+TEST_F(DefragmentationTest, CompactsFlexibleSeatsToTheFront) {
+    SeatAllocator allocator = scattered(8, {2, 4, 6});
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 1);
+
+    DefragReport report = allocator.defragment(100, true);
+    EXPECT_TRUE(report.finished);
+    EXPECT_EQ(report.largestBlockBefore, 1);
+    EXPECT_EQ(report.largestBlockAfter, 3);
+    ASSERT_EQ(report.moves.size(), 2);
+    EXPECT_EQ(report.moves[0].fromSeat, 8);
+    EXPECT_EQ(report.moves[0].toSeat, 2);
+    EXPECT_EQ(report.moves[0].passengerId, 8);
+    EXPECT_TRUE(allocator.isSeatFree(8));
+    EXPECT_FALSE(allocator.isSeatFree(2));
+
+    // the moved passenger can cancel from the new seat
+    EXPECT_NO_THROW(allocator.freeSeat(2));
+}
+
+TEST_F(DefragmentationTest, FixedBookingsStayPut) {
+    SeatAllocator allocator(8);
+    for (int p = 1; p <= 8; p++)
+        allocator.allocateSeat(p, p == 8 ? flexible : SeatRequest{});
+    allocator.freeSeat(2);
+    allocator.freeSeat(4);
+
+    DefragReport report = allocator.defragment(100, true);
+    ASSERT_EQ(report.moves.size(), 1); // only seat 8 may move
+    EXPECT_EQ(report.moves[0].toSeat, 2);
+    EXPECT_FALSE(allocator.isSeatMovable(7));
+}
+
+TEST_F(DefragmentationTest, ProposalLeavesInventoryUntouched) {
+    SeatAllocator allocator = scattered(8, {2, 4, 6});
+    DefragReport proposal = allocator.defragment(100, false);
+    EXPECT_EQ(proposal.moves.size(), 2);
+    EXPECT_EQ(proposal.largestBlockAfter, 3);
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 1);
+    EXPECT_TRUE(allocator.isSeatFree(2));
+
+    // applying afterwards gives the same moves
+    DefragReport applied = allocator.defragment(100, true);
+    ASSERT_EQ(applied.moves.size(), 2);
+    EXPECT_EQ(applied.moves[1].fromSeat, proposal.moves[1].fromSeat);
+}
+
+TEST_F(DefragmentationTest, SlicesResumeFromCursor) {
+    SeatAllocator allocator = scattered(8, {2, 4, 6});
+    DefragReport first = allocator.defragment(1, true);
+    EXPECT_EQ(first.moves.size(), 1);
+    EXPECT_FALSE(first.finished);
+    DefragReport second = allocator.defragment(1, true);
+    ASSERT_EQ(second.moves.size(), 1);
+    EXPECT_EQ(second.moves[0].fromSeat, 7);
+    EXPECT_EQ(allocator.defragment(10, true).moves.size(), 0);
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 3);
+}
+
+TEST_F(DefragmentationTest, HoldsAreMovedWithTheirRecord) {
+    SeatAllocator allocator(4);
+    allocator.allocateSeat(1);
+    allocator.allocateSeat(2);
+    allocator.holdSeat(9, 3, 5000);
+    allocator.holdSeat(10, 4, 5000);
+    allocator.freeSeat(2);
+
+    DefragReport report = allocator.defragment(10, true);
+    ASSERT_EQ(report.moves.size(), 1);
+    EXPECT_EQ(report.moves[0].holdId, 10);
+    EXPECT_EQ(allocator.getHold(10).seatNumber, 2);
+    EXPECT_EQ(allocator.confirmHold(10), 2);
+}
+
+TEST_F(DefragmentationTest, MovesStayInsideEachCoach) {
+    SeatAllocator allocator(vector<CoachSpec>{{"first", 4}, {"second", 4}});
+    for (int p = 1; p <= 8; p++)
+        allocator.allocateSeat(p, flexible);
+    allocator.freeSeat(1);
+    allocator.freeSeat(6);
+
+    DefragReport report = allocator.defragment(100, true);
+    ASSERT_EQ(report.moves.size(), 2);
+    EXPECT_EQ(report.moves[0].fromSeat, 4);
+    EXPECT_EQ(report.moves[0].toSeat, 1);
+    EXPECT_EQ(report.moves[1].fromSeat, 8);
+    EXPECT_EQ(report.moves[1].toSeat, 6);
+    EXPECT_EQ(allocator.getClassAvailableSeatCount("first"), 1);
+}
+
+// ===================== TicketService =====================
+
+TEST_F(DefragmentationTest, TicketsFollowTheirSeat) {
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+
+    Train train = trainService.createTrain("Express", 4);
+    vector<Ticket> tickets;
+    const char *names[] = {"Alice", "Bob", "Carol", "Dave"};
+    for (const char *name : names)
+    {
+        Passenger p = passengerService.createPassenger(name);
+        tickets.push_back(ticketService.bookTicket(train.getTrainId(), p.getId(), flexible, 20261020).value());
+    }
+    ticketService.cancelTicket(tickets[1].getId());
+
+    DefragReport report = ticketService.defragmentSeats(train.getTrainId(), 20261020);
+    ASSERT_EQ(report.moves.size(), 1);
+    EXPECT_EQ(ticketService.getTicket(tickets[3].getId()).getSeat(), 2);
+    EXPECT_EQ(report.largestBlockAfter, 1);
+    EXPECT_EQ(ticketService.defragmentSeats(train.getTrainId(), 20261021).moves.size(), 0);
+}
+
+TEST_F(DefragmentationTest, BackgroundSlicesCompactEveryDeparture) {
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+    EXPECT_THROW(ticketService.defragmentInBackground(0), std::invalid_argument);
+
+    Train train = trainService.createTrain("Express", 8);
+    vector<Ticket> tickets;
+    for (int i = 0; i < 8; i++)
+    {
+        Passenger p = passengerService.createPassenger("P" + std::to_string(i));
+        tickets.push_back(ticketService.bookTicket(train.getTrainId(), p.getId(), flexible, i < 4 ? 0 : 20261020).value());
+    }
+    ticketService.cancelTicket(tickets[0].getId()); // seat 1 undated
+    ticketService.cancelTicket(tickets[4].getId()); // seat 1 on the date
+
+    ticketService.defragmentInBackground(1, 1);
+    EXPECT_THROW(ticketService.defragmentInBackground(1), std::logic_error);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto compacted = [&] {
+        Train stored = trainService.getTrain(train.getTrainId());
+        return stored.getSeatAllocator()->isSeatFree(4) && stored.findSeatAllocator(20261020)->isSeatFree(4);
+    };
+    while (!compacted() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(compacted());
+    EXPECT_EQ(ticketService.getTicket(tickets[3].getId()).getSeat(), 1);
+    EXPECT_EQ(ticketService.getTicket(tickets[7].getId()).getSeat(), 1);
+}
+
+TEST_F(DefragmentationTest, CancelledTicketsKeepTheirSeat) {
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+
+    Train train = trainService.createTrain("Express", 4);
+    vector<Ticket> tickets;
+    for (const char *name : {"Alice", "Bob", "Carol"})
+    {
+        Passenger p = passengerService.createPassenger(name);
+        tickets.push_back(ticketService.bookTicket(train.getTrainId(), p.getId(), flexible, 20261020).value());
+    }
+    // Dave's older cancelled ticket for the same date comes first in the repository
+    Passenger dave = passengerService.createPassenger("Dave");
+    Ticket stale(0, 4, train.getTrainId(), dave, 20261020);
+    stale.setStatus(cancelled);
+    ticketRepo.save(stale);
+    Train copy = trainService.getTrain(train.getTrainId());
+    ASSERT_EQ(copy.getSeatAllocator(20261020)->allocateSeat(dave.getId(), flexible), 4);
+    trainService.save(copy);
+    Ticket live(0, 4, train.getTrainId(), dave, 20261020);
+    ticketRepo.save(live);
+    ticketService.cancelTicket(tickets[1].getId());
+
+    DefragReport report = ticketService.defragmentSeats(train.getTrainId(), 20261020);
+    ASSERT_EQ(report.moves.size(), 1);
+    EXPECT_EQ(ticketService.getTicket(live.getId()).getSeat(), 2);
+    EXPECT_EQ(ticketService.getTicket(stale.getId()).getSeat(), 4);
+    EXPECT_EQ(ticketService.getTicket(stale.getId()).getStatus(), cancelled);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "models/Train.h"
+#include "utils/helpers.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "RMSFacade.h"
+
+class DeparturesTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+};
+
+// ===================== Date helpers =====================
+
+TEST_F(DeparturesTest, ParseAndFormatDates) {
+    EXPECT_EQ(parseDate("2026-10-19"), 20261019);
+    EXPECT_EQ(formatDate(20261019), "2026-10-19");
+    EXPECT_TRUE(isValidDate(20240229));
+    EXPECT_FALSE(isValidDate(20250229));
+    EXPECT_THROW(parseDate("2026-13-01"), std::invalid_argument);
+    EXPECT_THROW(parseDate("19/10/2026"), std::invalid_argument);
+}
+
+// ===================== Train =====================
+
+TEST_F(DeparturesTest, DatesAreMaterializedOnFirstUse) {
+    Train train(1, "Express", 10);
+    EXPECT_EQ(train.getDepartureCount(), 0);
+    EXPECT_EQ(train.findSeatAllocator(20261020), nullptr);
+    EXPECT_EQ(train.getAvailableSeatCount(20261020), 10);
+
+    train.getSeatAllocator(20261020)->allocateSeat(7);
+    EXPECT_EQ(train.getDepartureCount(), 1);
+    EXPECT_EQ(train.getAvailableSeatCount(20261020), 9);
+    EXPECT_EQ(train.getSeatAllocator()->getAvailableSeatCount(), 10); // undated untouched
+}
+
+TEST_F(DeparturesTest, NewDateStartsEmptyWithTemplateLayout) {
+    Train train(1, "Express", vector<CoachSpec>{{"first", 4}, {"second", 8}});
+    train.getSeatAllocator()->allocateSeat(1);
+    train.tagSeats(5, 6, SEAT_ACCESSIBLE);
+
+    SeatAllocator *day = train.getSeatAllocator(20261020);
+    EXPECT_EQ(day->getAvailableSeatCount(), 12);
+    EXPECT_EQ(day->getClassAvailableSeatCount("first"), 4);
+    EXPECT_TRUE(day->getSeatAttributes(5) & SEAT_ACCESSIBLE);
+}
+
+TEST_F(DeparturesTest, SeatChangesReachEveryDeparture) {
+    Train train(1, "Express", 10);
+    train.getSeatAllocator(20261020);
+    train.addSeats(5);
+    EXPECT_EQ(train.findSeatAllocator(20261020)->getTotalSeats(), 15);
+    train.tagSeats(15, 15, SEAT_LOWER_BERTH);
+    EXPECT_TRUE(train.findSeatAllocator(20261020)->getSeatAttributes(15) & SEAT_LOWER_BERTH);
+}
+
+TEST_F(DeparturesTest, CopyKeepsDepartures) {
+    Train train(1, "Express", 10);
+    train.getSeatAllocator(20261020)->allocateSeat(7);
+    Train copy(train);
+    EXPECT_EQ(copy.getDepartureCount(), 1);
+    EXPECT_EQ(copy.getAvailableSeatCount(20261020), 9);
+    copy.getSeatAllocator(20261020)->allocateSeat(8);
+    EXPECT_EQ(train.getAvailableSeatCount(20261020), 9); // deep copy
+}
+
+TEST_F(DeparturesTest, EvictDropsPastDatesOnly) {
+    Train train(1, "Express", 10);
+    train.getSeatAllocator(20261018);
+    train.getSeatAllocator(20261019);
+    train.getSeatAllocator(20261025);
+    EXPECT_EQ(train.evictDatesBefore(20261019), 1);
+    vector<int> dates = train.getDepartureDates();
+    ASSERT_EQ(dates.size(), 2);
+    EXPECT_EQ(dates[0], 20261019);
+    EXPECT_EQ(dates[1], 20261025);
+}
+
+TEST_F(DeparturesTest, InvalidDateThrows) {
+    Train train(1, "Express", 10);
+    EXPECT_THROW(train.getSeatAllocator(20261340), std::invalid_argument);
+}
+
+// ===================== TicketService =====================
+
+TEST_F(DeparturesTest, SamePassengerDifferentDates) {
+    Train train = trainService->createTrain("Express", 2);
+    Passenger alice = passengerService->createPassenger("Alice");
+
+    auto first = ticketService->bookTicket(train.getTrainId(), alice.getId(), SeatRequest{}, 20261020);
+    auto second = ticketService->bookTicket(train.getTrainId(), alice.getId(), SeatRequest{}, 20261021);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(first->getTravelDate(), 20261020);
+    EXPECT_EQ(second->getSeat(), 1); // independent inventories
+    EXPECT_THROW(ticketService->bookTicket(train.getTrainId(), alice.getId(), SeatRequest{}, 20261020), std::runtime_error);
+
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getDepartureCount(), 2);
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), 0);
+}
+
+TEST_F(DeparturesTest, CancelPromotesWaitingPassengerOfThatDate) {
+    Train train = trainService->createTrain("Express", 1);
+    Passenger alice = passengerService->createPassenger("Alice");
+    Passenger bob = passengerService->createPassenger("Bob");
+
+    auto ticket = ticketService->bookTicket(train.getTrainId(), alice.getId(), SeatRequest{}, 20261020);
+    EXPECT_FALSE(ticketService->bookTicket(train.getTrainId(), bob.getId(), SeatRequest{}, 20261020).has_value());
+    ASSERT_TRUE(ticketService->bookTicket(train.getTrainId(), bob.getId(), SeatRequest{}, 20261021).has_value());
+
+    ticketService->cancelTicket(ticket->getId());
+    auto promoted = ticketRepo->getTicketByTrainAndPassenger(train.getTrainId(), bob.getId(), 20261020);
+    ASSERT_TRUE(promoted.has_value());
+    EXPECT_EQ(promoted->getSeat(), 1);
+}
+
+TEST_F(DeparturesTest, CancelAfterEvictionThrows) {
+    Train train = trainService->createTrain("Express", 2);
+    Passenger alice = passengerService->createPassenger("Alice");
+
+    auto ticket = ticketService->bookTicket(train.getTrainId(), alice.getId(), SeatRequest{}, 20261020);
+    EXPECT_EQ(trainService->evictDatesBefore(20261021), 1);
+    EXPECT_THROW(ticketService->cancelTicket(ticket->getId()), std::runtime_error);
+    EXPECT_TRUE(ticketService->getTicket(ticket->getId()).getStatus() == booked);
+}
+
+TEST_F(DeparturesTest, HoldOnDate) {
+    Train train = trainService->createTrain("Express", 2);
+    Passenger alice = passengerService->createPassenger("Alice");
+
+    SeatHold hold = ticketService->holdSeat(train.getTrainId(), alice.getId(), 60, SeatRequest{}, 20261020);
+    Ticket ticket = ticketService->confirmHold(hold.holdId);
+    EXPECT_EQ(ticket.getTravelDate(), 20261020);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getAvailableSeatCount(20261020), 1);
+}
+
+// ===================== Facade =====================
+
+TEST_F(DeparturesTest, FacadeParsesTravelDate) {
+    RMSFacade facade(trainService.get(), ticketService.get(), passengerService.get());
+    Train train = facade.addTrain("Express", 4);
+
+    auto ticket = facade.bookTicket(train.getTrainId(), "Alice", SeatRequest{}, "2026-10-20");
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(ticket->getTravelDate(), 20261020);
+    EXPECT_THROW(facade.bookTicket(train.getTrainId(), "Bob", SeatRequest{}, "20-10-2026"), std::invalid_argument);
+    EXPECT_NO_THROW(facade.trainStatus(train.getTrainId(), "2026-10-20"));
+    EXPECT_NO_THROW(facade.trainStatus(train.getTrainId(), "2026-10-21"));
+}
@@ -0,0 +1,323 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "Services/EventBus.h"
+#include "Services/TicketService.h"
+#include "structures/ringBuffer.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+TEST(RingBufferTest, PopsInPushOrderUntilEmpty) {
+    RingBuffer<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+    for (int i = 1; i <= 4; i++)
+        EXPECT_TRUE(ring.tryPush(i));
+    EXPECT_FALSE(ring.tryPush(5)); // full
+    EXPECT_EQ(ring.size(), 4u);
+
+    int value = 0;
+    for (int i = 1; i <= 4; i++) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+
+    // slots are reused on the next lap
+    EXPECT_TRUE(ring.tryPush(6));
+    ASSERT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 6);
+}
+
+TEST(RingBufferTest, RejectsCapacityThatIsNotAPowerOfTwo) {
+    EXPECT_THROW(RingBuffer<int>(0), std::invalid_argument);
+    EXPECT_THROW(RingBuffer<int>(1), std::invalid_argument);
+    EXPECT_THROW(RingBuffer<int>(6), std::invalid_argument);
+    EXPECT_EQ(RingBuffer<int>(8).capacity(), 8u);
+}
+
+TEST(RingBufferTest, ConcurrentProducersLoseNothing) {
+    RingBuffer<int> ring(1024);
+    const int producers = 4, perProducer = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; i++)
+                while (!ring.tryPush(p * perProducer + i))
+                    std::this_thread::yield();
+        });
+
+    std::vector<int> lastSeen(producers, -1);
+    int popped = 0, value = 0;
+    while (popped < producers * perProducer) {
+        if (!ring.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // each producer's values come out in the order it pushed them
+        int producer = value / perProducer;
+        EXPECT_GT(value % perProducer, lastSeen[producer]);
+        lastSeen[producer] = value % perProducer;
+        popped++;
+    }
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+class EventCollector {
+public:
+    std::mutex mutex;
+    std::vector<Event> events;
+
+    EventBus::Subscriber subscriber() {
+        return [this](const Event *batch, size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.insert(events.end(), batch, batch + count);
+        };
+    }
+
+    std::vector<EventType> types() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<EventType> result;
+        for (const auto &event : events)
+            result.push_back(event.type);
+        return result;
+    }
+};
+
+TEST(EventBusTest, DeliversInPublishOrderWithSequences) {
+    EventBus bus;
+    EventCollector first, second;
+    bus.subscribe(first.subscriber());
+    bus.subscribe(second.subscriber());
+
+    for (int i = 1; i <= 100; i++) {
+        Event event;
+        event.type = EventType::TicketBooked;
+        event.ticketId = i;
+        EXPECT_TRUE(bus.publish(event));
+    }
+    bus.flush();
+
+    ASSERT_EQ(first.events.size(), 100u);
+    ASSERT_EQ(second.events.size(), 100u);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(first.events[i].ticketId, i + 1);
+        EXPECT_EQ(first.events[i].sequence, (uint64_t)i + 1);
+        EXPECT_GT(first.events[i].timeMs, 0);
+    }
+    EventBusStats stats = bus.getStats();
+    EXPECT_EQ(stats.published, 100);
+    EXPECT_EQ(stats.delivered, 100);
+    EXPECT_EQ(stats.dropped, 0);
+}
+
+TEST(EventBusTest, DropsAndCountsWhenTheRingIsFull) {
+    EventBusOptions options;
+    options.capacity = 4;
+    EventBus bus(options);
+
+    // a subscriber that blocks keeps the ring from draining
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    std::atomic<bool> entered{false};
+    bus.subscribe([&](const Event *, size_t) {
+        entered = true;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+    bus.publish(Event{});
+    while (!entered)
+        std::this_thread::yield();
+
+    int accepted = 0;
+    for (int i = 0; i < 10; i++)
+        accepted += bus.publish(Event{});
+    EXPECT_EQ(accepted, 4);
+    closed.unlock();
+    bus.flush();
+
+    EventBusStats stats = bus.getStats();
+    EXPECT_EQ(stats.published, 5);
+    EXPECT_EQ(stats.delivered, 5);
+    EXPECT_EQ(stats.dropped, 6);
+}
+
+TEST(EventBusTest, UnsubscribedSubscriberGetsNothingMore) {
+    EventBus bus;
+    EventCollector collector;
+    int id = bus.subscribe(collector.subscriber());
+    bus.publish(Event{});
+    bus.flush();
+    bus.unsubscribe(id);
+    bus.publish(Event{});
+    bus.flush();
+    EXPECT_EQ(collector.events.size(), 1u);
+    EXPECT_THROW(EventBus(EventBusOptions{3}), std::invalid_argument);
+}
+
+class ServiceEventsTest : public ::testing::Test {
+protected:
+    InMemoryTrainRepository trainRepo;
+    InMemoryPassengerRepository passengerRepo;
+    InMemoryTicketRepository ticketRepo;
+    EventBus bus;
+    EventCollector collector;
+    TrainService trainService{&trainRepo};
+    PassengerService passengerService{&passengerRepo};
+    TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+    int trainId = 0;
+
+    void SetUp() override {
+        bus.subscribe(collector.subscriber());
+        trainService.setEventBus(&bus);
+        ticketService.setEventBus(&bus);
+        trainId = trainService.createTrain("Nile Express", 1).getTrainId();
+        for (const char *name : {"Omar", "Sara", "Karim"})
+            passengerService.createPassenger(name);
+    }
+
+    std::vector<Event> events() {
+        bus.flush();
+        return collector.events;
+    }
+};
+
+TEST_F(ServiceEventsTest, BookingCancellationAndPromotion) {
+    int ticketId = ticketService.bookTicket(trainId, 1)->getId();
+    EXPECT_FALSE(ticketService.bookTicket(trainId, 2).has_value()); // waitlisted
+    ticketService.cancelTicket(ticketId);                           // seat goes to passenger 2
+
+    auto all = events();
+    ASSERT_EQ(all.size(), 5u);
+    EXPECT_EQ(all[0].type, EventType::TrainAdded);
+    EXPECT_EQ(all[0].seats, 1);
+
+    EXPECT_EQ(all[1].type, EventType::TicketBooked);
+    EXPECT_EQ(all[1].ticketId, ticketId);
+    EXPECT_EQ(all[1].passengerId, 1);
+    EXPECT_EQ(all[1].seat, 1);
+
+    EXPECT_EQ(all[2].type, EventType::TicketWaitlisted);
+    EXPECT_EQ(all[2].passengerId, 2);
+    EXPECT_EQ(all[2].ticketId, 0);
+
+    EXPECT_EQ(all[3].type, EventType::TicketCancelled);
+    EXPECT_EQ(all[3].ticketId, ticketId);
+    EXPECT_EQ(all[3].seat, 1);
+
+    EXPECT_EQ(all[4].type, EventType::WaitlistPromoted);
+    EXPECT_EQ(all[4].passengerId, 2);
+    EXPECT_EQ(all[4].seat, 1);
+    EXPECT_NE(all[4].ticketId, 0);
+    EXPECT_EQ(ticketService.getTicket(all[4].ticketId).getPassenger().getId(), 2);
+}
+
+// tickets get their ids as they are written under the train lock , the events come out in that order
+TEST_F(ServiceEventsTest, ConcurrentBookingsPublishInCommitOrder) {
+    const int threads = 4, perThread = 50;
+    int busy = trainService.createTrain("Busy", threads * perThread).getTrainId();
+    std::vector<int> passengers;
+    for (int i = 0; i < threads * perThread; i++)
+        passengers.push_back(passengerService.createPassenger("P" + std::to_string(i)).getId());
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back([&, t] {
+            for (int i = 0; i < perThread; i++)
+                ticketService.bookTicket(busy, passengers[t * perThread + i]);
+        });
+    for (auto &thread : pool)
+        thread.join();
+
+    int lastId = 0, booked = 0;
+    for (const Event &event : events()) {
+        if (event.type != EventType::TicketBooked)
+            continue;
+        EXPECT_GT(event.ticketId, lastId);
+        lastId = event.ticketId;
+        booked++;
+    }
+    EXPECT_EQ(booked, threads * perThread);
+}
+
+TEST_F(ServiceEventsTest, AddedSeatsPromoteTheWaitingList) {
+    ticketService.bookTicket(trainId, 1);
+    ticketService.bookTicket(trainId, 2);
+    trainService.addSeats(trainId, 1);
+    for (const auto &waiting : trainService.takeWaitingPassengers(trainId, 1))
+        ticketService.promoteWaitingPassenger(trainId, waiting.second, waiting.first);
+
+    bus.flush();
+    auto types = collector.types();
+    ASSERT_EQ(types.size(), 5u);
+    EXPECT_EQ(types[3], EventType::SeatsAdded);
+    EXPECT_EQ(types[4], EventType::WaitlistPromoted);
+    EXPECT_EQ(collector.events[3].seats, 1);
+
+    trainService.deleteTrain(trainId);
+    EXPECT_EQ(events().back().type, EventType::TrainDeleted);
+}
+
+TEST_F(ServiceEventsTest, HoldLifecycle) {
+    SeatHold hold = ticketService.holdSeat(trainId, 1, 60);
+    ticketService.releaseHold(hold.holdId);
+    SeatHold second = ticketService.holdSeat(trainId, 2, 60);
+    Ticket ticket = ticketService.confirmHold(second.holdId);
+
+    auto all = events();
+    ASSERT_EQ(all.size(), 5u);
+    EXPECT_EQ(all[1].type, EventType::HoldPlaced);
+    EXPECT_EQ(all[1].holdId, hold.holdId);
+    EXPECT_EQ(all[1].seat, hold.seatNumber);
+    EXPECT_EQ(all[2].type, EventType::HoldReleased);
+    EXPECT_EQ(all[3].type, EventType::HoldPlaced);
+    EXPECT_EQ(all[4].type, EventType::HoldConfirmed);
+    EXPECT_EQ(all[4].holdId, second.holdId);
+    EXPECT_EQ(all[4].ticketId, ticket.getId());
+}
+
+TEST(EventLogSinkTest, AppendsJsonLines) {
+    const std::string path = "/tmp/rms_events_" + std::to_string(getpid()) + ".jsonl";
+    std::remove(path.c_str());
+    {
+        EventBus bus;
+        EventLogSink sink(&bus, path);
+        Event booked;
+        booked.type = EventType::TicketBooked;
+        booked.trainId = 3;
+        booked.ticketId = 7;
+        booked.passengerId = 2;
+        booked.seat = 5;
+        booked.travelDate = 20261020;
+        bus.publish(booked);
+        Event added;
+        added.type = EventType::SeatsAdded;
+        added.trainId = 3;
+        added.seats = 10;
+        bus.publish(added);
+        EXPECT_EQ(sink.getError(), "");
+    }
+
+    std::ifstream in(path);
+    std::string first, second, extra;
+    ASSERT_TRUE(std::getline(in, first));
+    ASSERT_TRUE(std::getline(in, second));
+    EXPECT_FALSE(std::getline(in, extra));
+    EXPECT_EQ(first.rfind("{\"type\":\"TicketBooked\",\"seq\":1,\"time\":", 0), 0u);
+    EXPECT_NE(first.find(",\"train_id\":3,\"date\":20261020,\"ticket_id\":7,\"passenger_id\":2,\"seat\":5}"), std::string::npos);
+    EXPECT_EQ(second.rfind("{\"type\":\"SeatsAdded\",\"seq\":2,", 0), 0u);
+    EXPECT_NE(second.find(",\"train_id\":3,\"seats\":10}"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(EventLogSinkTest, ReportsAFileItCannotOpen) {
+    EventBus bus;
+    EventLogSink sink(&bus, "/nonexistent-dir/events.jsonl");
+    bus.publish(Event{});
+    EXPECT_NE(sink.getError().find("Cannot open event log"), std::string::npos);
+}
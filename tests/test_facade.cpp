@@ -58,6 +58,7 @@ TEST_F(RMSFacadeTest, AddTrain_Success) {
 TEST_F(RMSFacadeTest, AddTrain_Invalid) {
     EXPECT_THROW(facade->addTrain("", 20), std::invalid_argument);
     EXPECT_THROW(facade->addTrain("   ", 20), std::invalid_argument);
+    EXPECT_THROW(facade->addTrain("Express!", 20), std::invalid_argument); // the rule BulkImporter applies
     EXPECT_THROW(facade->addTrain("Express", 0), std::invalid_argument);
     EXPECT_THROW(facade->addTrain("Express", -5), std::invalid_argument);
 }
@@ -111,6 +112,19 @@ TEST_F(RMSFacadeTest, GetTrainAvailability) {
     EXPECT_FALSE(facade->getTrainAvailability(train.getTrainId()));
 }
 
+TEST_F(RMSFacadeTest, BookTicket_WithSeatPreferences) {
+    Train train = facade->addTrain("Test", 20);
+    facade->tagSeats(train.getTrainId(), 9, 12, SEAT_LOWER_BERTH);
+
+    SeatRequest request;
+    request.preferences = SEAT_WINDOW | SEAT_LOWER_BERTH;
+    auto ticket = facade->bookTicket(train.getTrainId(), "John", request);
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(ticket->getSeat(), 9);
+
+    EXPECT_THROW(facade->tagSeats(train.getTrainId(), 1, 2, 0), std::invalid_argument);
+}
+
 // ===================== Passenger Operations =====================
 
 TEST_F(RMSFacadeTest, AddPassenger_SuccessAndInvalid) {
@@ -199,3 +213,40 @@ TEST_F(RMSFacadeTest, UpdateTrainExpandsCapacityAndFulfillsWaitingList) {
     for (const auto& t : tickets) if (t.getStatus() == booked) bookedCount++;
     EXPECT_GE(bookedCount, 4); // 2 waiting passengers booked after expansion
 }
+
+TEST_F(RMSFacadeTest, UpdateTrainKeepsEveryPromotedSeat) {
+    Train train = facade->addTrain("Test", 1);
+    facade->bookTicket(train.getTrainId(), "Passenger1");
+    facade->bookTicket(train.getTrainId(), "Waiting1");
+    facade->bookTicket(train.getTrainId(), "Waiting2");
+    facade->bookTicket(train.getTrainId(), "Waiting3");
+
+    Train updated = facade->updateTrain(train.getTrainId(), "Test", 3);
+
+    // the seats of the promoted passengers survive in the saved train
+    Train stored = trainService->getTrain(train.getTrainId());
+    SeatAllocator* allocator = stored.getSeatAllocator();
+    EXPECT_EQ(allocator->getAllocatedSeatCount(), 3);
+    EXPECT_EQ(allocator->getWaitingListSize(), 1);
+    EXPECT_EQ(updated.getSeatAllocator()->getAllocatedSeatCount(), 3);
+}
+
+TEST_F(RMSFacadeTest, UpdateTrainPromotesTheWaitingListOfEveryDeparture) {
+    Train train = facade->addTrain("Test", 1);
+    facade->bookTicket(train.getTrainId(), "Passenger1", SeatRequest{}, "2026-12-01");
+    EXPECT_FALSE(facade->bookTicket(train.getTrainId(), "Waiting1", SeatRequest{}, "2026-12-01").has_value());
+    facade->bookTicket(train.getTrainId(), "Passenger2");
+    EXPECT_FALSE(facade->bookTicket(train.getTrainId(), "Waiting2").has_value());
+
+    facade->updateTrain(train.getTrainId(), "Test", 2);
+
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), 2);
+    EXPECT_EQ(stored.findSeatAllocator(20261201)->getAllocatedSeatCount(), 2);
+    EXPECT_EQ(stored.findSeatAllocator(20261201)->getWaitingListSize(), 0);
+    int waitingId = passengerRepo->findPassengerByName("Waiting1")->getId();
+    bool promoted = false;
+    for (const auto& t : facade->listTickets())
+        promoted |= t.getPassenger().getId() == waitingId && t.getTravelDate() == 20261201 && t.getStatus() == booked;
+    EXPECT_TRUE(promoted); // booked on the date the passenger waited for
+}
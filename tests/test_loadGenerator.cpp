@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "LoadGenerator.h"
+#include "StartupManager.h"
+
+class LoadGeneratorTest : public ::testing::Test {
+protected:
+    StartupManager manager;
+    RMSFacade *facade = nullptr;
+    LoadOptions options;
+
+    void SetUp() override {
+        manager.setWorkerThreads(1);
+        facade = manager.buildFacade();
+        options.threads = 3;
+        options.durationMs = 150;
+        options.warmupMs = 20;
+        options.trains = 5;
+        options.seatsPerTrain = 40;
+        options.passengers = 60;
+    }
+};
+
+TEST_F(LoadGeneratorTest, ZipfFavoursLowRanks) {
+    ZipfDistribution zipf(10, 1.0);
+    std::mt19937_64 rng(1);
+    std::vector<int> hits(11, 0);
+    const int draws = 200000;
+    for (int i = 0; i < draws; i++) {
+        int k = zipf(rng);
+        ASSERT_GE(k, 1);
+        ASSERT_LE(k, 10);
+        hits[k]++;
+    }
+    // P(1) = 1 / H(10) ~ 0.341 , P(10) ~ 0.034
+    EXPECT_NEAR(hits[1] / (double)draws, 0.341, 0.01);
+    EXPECT_NEAR(hits[10] / (double)draws, 0.034, 0.005);
+
+    ZipfDistribution uniform(4, 0.0);
+    std::vector<int> flat(5, 0);
+    for (int i = 0; i < 40000; i++)
+        flat[uniform(rng)]++;
+    for (int k = 1; k <= 4; k++)
+        EXPECT_NEAR(flat[k] / 40000.0, 0.25, 0.02);
+    EXPECT_THROW(ZipfDistribution(0, 1.0), std::invalid_argument);
+}
+
+TEST_F(LoadGeneratorTest, HistogramPercentilesWithinBucketError) {
+    LatencyHistogram histogram;
+    for (long long ns = 1; ns <= 100000; ns++)
+        histogram.record(ns * 10); // 10 ns .. 1 ms , uniform
+    EXPECT_EQ(histogram.count(), 100000);
+    EXPECT_EQ(histogram.max(), 1000000);
+    EXPECT_NEAR(histogram.percentile(0.50), 500000, 500000 * 0.04);
+    EXPECT_NEAR(histogram.percentile(0.99), 990000, 990000 * 0.04);
+    EXPECT_NEAR(histogram.percentile(0.999), 999000, 999000 * 0.04);
+    EXPECT_EQ(histogram.percentile(1.0), 1000000);
+
+    LatencyHistogram small, other;
+    small.record(5);
+    other.record(40);
+    small.merge(other);
+    EXPECT_EQ(small.percentile(0.5), 5); // exact below 64 ns
+    EXPECT_EQ(small.percentile(1.0), 40);
+    EXPECT_EQ(LatencyHistogram().percentile(0.99), 0);
+}
+
+TEST_F(LoadGeneratorTest, ClosedLoopRunsEveryOperation) {
+    LoadFixture fixture = prepareLoad(*facade, options);
+    ASSERT_EQ(fixture.trainIds.size(), 5u);
+    ASSERT_EQ(fixture.passengerNames.size(), 60u);
+
+    LoadReport report = runClosedLoop(*facade, fixture, options);
+    EXPECT_GE(report.elapsedMs, 150);
+    EXPECT_GT(report.completed, 0);
+    EXPECT_GT(report.throughput(), 0);
+    long long sum = 0;
+    for (const auto &op : report.ops) {
+        sum += op.completed;
+        EXPECT_LE(op.p50Us, op.p99Us);
+        EXPECT_LE(op.p99Us, op.p999Us);
+        EXPECT_LE(op.p999Us, op.maxUs);
+    }
+    EXPECT_EQ(sum, report.completed);
+    EXPECT_GT(report.ops[(int)LoadOp::Book].completed, 0);
+    EXPECT_GT(report.ops[(int)LoadOp::Lookup].completed, 0);
+    EXPECT_EQ(report.ops[(int)LoadOp::Lookup].failed, 0);
+
+    // 200 seats and 60 passengers : no ticket is ever sold twice
+    for (int id : fixture.trainIds) {
+        Train train = facade->getTrain(id);
+        EXPECT_LE(train.getSeatAllocator()->getAllocatedSeatCount(), 40);
+    }
+}
+
+TEST_F(LoadGeneratorTest, MixRestrictsOperations) {
+    options.mix = LoadMix{0, 0, 1, 0};
+    LoadFixture fixture = prepareLoad(*facade, options);
+    LoadReport report = runClosedLoop(*facade, fixture, options);
+    EXPECT_EQ(report.ops[(int)LoadOp::Lookup].completed, report.completed);
+    EXPECT_EQ(report.ops[(int)LoadOp::Book].completed, 0);
+
+    options.mix = LoadMix{0, 0, 0, 0};
+    EXPECT_THROW(runClosedLoop(*facade, fixture, options), std::invalid_argument);
+    options.mix = LoadMix{};
+    options.threads = 0;
+    EXPECT_THROW(runClosedLoop(*facade, fixture, options), std::invalid_argument);
+}
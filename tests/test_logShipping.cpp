@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Repo/LogShipper.h"
+#include "Repo/LogReplica.h"
+#include "Repo/DurableTrainRepository.h"
+#include "Repo/DurableTicketRepository.h"
+#include "Repo/DurablePassengerRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/ReadOnlyTrainRepository.h"
+#include "StartupManager.h"
+
+class LogShippingTest : public ::testing::Test {
+protected:
+    std::string walPath, socketPath, filePath;
+
+    // the primary : durable repositories on a write-ahead log
+    std::unique_ptr<WriteAheadLog> wal;
+    std::unique_ptr<DurableTrainRepository> trains;
+    std::unique_ptr<DurableTicketRepository> tickets;
+    std::unique_ptr<DurablePassengerRepository> passengers;
+    std::unique_ptr<LogShipper> shipper;
+
+    // the replica's own repositories
+    InMemoryTrainRepository replicaTrains;
+    InMemoryTicketRepository replicaTickets;
+    InMemoryPassengerRepository replicaPassengers;
+    std::unique_ptr<LogReplica> replica;
+
+    void SetUp() override {
+        static int counter = 0;
+        std::string base = "/tmp/rms_ship_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+        walPath = base + ".log";
+        socketPath = base + ".sock";
+        filePath = base + ".ship";
+        std::remove(walPath.c_str());
+        std::remove(filePath.c_str());
+        WalOptions written; // a commit returns once its batch is written and shipped , no fsync
+        written.durability = Durability::Written;
+        wal = std::make_unique<WriteAheadLog>(walPath, written);
+        trains = std::make_unique<DurableTrainRepository>(std::make_unique<InMemoryTrainRepository>(), wal.get());
+        tickets = std::make_unique<DurableTicketRepository>(std::make_unique<InMemoryTicketRepository>(), wal.get());
+        passengers = std::make_unique<DurablePassengerRepository>(std::make_unique<InMemoryPassengerRepository>(), wal.get());
+    }
+
+    void TearDown() override {
+        replica.reset();
+        shipper.reset();
+        std::remove(walPath.c_str());
+        std::remove(filePath.c_str());
+    }
+
+    void ship(const ShippingOptions &options = ShippingOptions{}) {
+        shipper = std::make_unique<LogShipper>(wal.get(), trains.get(), tickets.get(), passengers.get(),
+                                               options.toFile ? filePath : socketPath, options);
+    }
+
+    void follow(bool fromFile = false) {
+        ReplicaOptions options;
+        options.fromFile = fromFile;
+        options.retryMs = 5;
+        replica = std::make_unique<LogReplica>(&replicaTrains, &replicaTickets, &replicaPassengers,
+                                               fromFile ? filePath : socketPath, options);
+    }
+
+    // every commit so far is flushed and shipped , wait for the replica to apply it
+    bool caughtUp() {
+        return replica->waitForPosition(shipper->position(), 5000);
+    }
+
+    Train addTrain(const std::string &name) {
+        Train train(0, name, 10);
+        trains->save(train);
+        return train;
+    }
+};
+
+TEST_F(LogShippingTest, ReplicaStartsFromTheRowsThenFollowsTheLog) {
+    Train before = addTrain("Before");
+    Passenger omar(0, "Omar");
+    passengers->save(omar);
+    Ticket ticket(0, 1, before.getTrainId(), omar);
+    tickets->save(ticket);
+    ship();
+    follow();
+    ASSERT_TRUE(replica->waitUntilReady(5000));
+    ASSERT_TRUE(caughtUp());
+    EXPECT_EQ(replicaTrains.getTrainById(before.getTrainId())->getTrainName(), "Before");
+    EXPECT_EQ(replicaTickets.getTicketById(ticket.getId())->getPassenger().getName(), "Omar");
+
+    Train after = addTrain("After");
+    before.setTrainName("Before 2");
+    trains->save(before);
+    ASSERT_TRUE(tickets->deleteTicket(ticket.getId()));
+    passengers->clear();
+    ASSERT_TRUE(caughtUp());
+    EXPECT_EQ(replicaTrains.getAllTrains().size(), 2u);
+    EXPECT_EQ(replicaTrains.getTrainById(before.getTrainId())->getTrainName(), "Before 2");
+    EXPECT_TRUE(replicaTrains.getTrainById(after.getTrainId()).has_value());
+    EXPECT_FALSE(replicaTickets.getTicketById(ticket.getId()).has_value());
+    EXPECT_EQ(replicaPassengers.getAllPassengers().size(), 0u);
+
+    ReplicaStats stats = replica->getStats();
+    EXPECT_TRUE(stats.connected);
+    EXPECT_TRUE(stats.ready);
+    EXPECT_EQ(stats.snapshots, 1);
+    EXPECT_GE(stats.records, 7); // three snapshot rows , four changes
+    EXPECT_EQ(stats.behindBytes(), 0u);
+    EXPECT_GE(stats.maxLagMs, stats.lagMs);
+    EXPECT_EQ(shipper->getStats().replicas, 1);
+}
+
+TEST_F(LogShippingTest, HeartbeatsKeepAnIdleReplicaFresh) {
+    ShippingOptions options;
+    options.heartbeatMs = 5;
+    ship(options);
+    follow();
+    ASSERT_TRUE(replica->waitUntilReady(5000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ReplicaStats stats = replica->getStats();
+    EXPECT_GT(stats.messages, 3);
+    EXPECT_LT(stats.stalenessMs, 1000);
+}
+
+TEST_F(LogShippingTest, ReplicaFollowsAFile) {
+    addTrain("Filed");
+    ShippingOptions options;
+    options.toFile = true;
+    ship(options);
+    follow(true);
+    ASSERT_TRUE(replica->waitUntilReady(5000));
+    Train next = addTrain("Appended");
+    ASSERT_TRUE(caughtUp());
+    EXPECT_EQ(replicaTrains.getAllTrains().size(), 2u);
+    EXPECT_EQ(replicaTrains.getTrainById(next.getTrainId())->getTrainName(), "Appended");
+}
+
+TEST_F(LogShippingTest, ReplicaStartsOverWhenThePrimaryComesBack) {
+    Train kept = addTrain("Kept"), dropped = addTrain("Dropped");
+    ship();
+    follow();
+    ASSERT_TRUE(replica->waitUntilReady(5000));
+    ASSERT_TRUE(caughtUp());
+    EXPECT_EQ(replicaTrains.getAllTrains().size(), 2u);
+
+    shipper.reset(); // the primary goes away , changes it makes meanwhile are not shipped
+    ASSERT_TRUE(trains->deleteTrain(dropped.getTrainId()));
+    kept.setTrainName("Kept 2");
+    trains->save(kept);
+    ship();
+    // positions start over with the new primary , wait for the replica to notice it first
+    for (int i = 0; i < 1000 && replica->getStats().snapshots < 2; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(caughtUp());
+    EXPECT_EQ(replicaTrains.getAllTrains().size(), 1u); // the new snapshot did not have it
+    EXPECT_EQ(replicaTrains.getTrainById(kept.getTrainId())->getTrainName(), "Kept 2");
+    ReplicaStats stats = replica->getStats();
+    EXPECT_GE(stats.connects, 2);
+    EXPECT_EQ(stats.snapshots, 2);
+}
+
+TEST_F(LogShippingTest, ReplicaThatStopsReadingIsCutOff) {
+    ShippingOptions options;
+    options.maxBufferBytes = 64 << 10;
+    ship(options);
+    // connects and never reads
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", socketPath.c_str());
+    ASSERT_EQ(::connect(fd, (sockaddr *)&address, sizeof(address)), 0);
+    for (int i = 0; i < 200 && shipper->getStats().connects == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    for (int i = 0; i < 200 && shipper->getStats().dropped == 0; i++)
+        for (int j = 0; j < 100; j++)
+            addTrain("Flood " + std::string(200, 'x'));
+    EXPECT_EQ(shipper->getStats().dropped, 1);
+    EXPECT_EQ(shipper->getStats().replicas, 0);
+    ::close(fd);
+}
+
+TEST_F(LogShippingTest, ReplicaRefusesWrites) {
+    auto inner = std::make_unique<InMemoryTrainRepository>();
+    Train train(0, "Replicated", 5);
+    inner->save(train);
+    ReadOnlyTrainRepository readOnly(std::move(inner));
+    EXPECT_EQ(readOnly.getAllTrains().size(), 1u);
+    EXPECT_TRUE(readOnly.getTrainById(train.getTrainId()).has_value());
+    EXPECT_THROW(readOnly.save(train), std::logic_error);
+    EXPECT_THROW(readOnly.deleteTrain(train.getTrainId()), std::logic_error);
+    EXPECT_THROW(readOnly.clear(), std::logic_error);
+}
+
+// the harness : a primary process booking through its facade and a replica process (this one)
+// following it over the socket
+struct PrimaryReport {
+    long long tickets;
+    long long trainId;
+    long long ticketId;
+    unsigned long long position;
+};
+
+static int runPrimary(const std::string &walPath, const std::string &socketPath, int report, int commands) {
+    StartupManager manager;
+    manager.useWriteAheadLog(walPath);
+    manager.useLogShipping(socketPath);
+    RMSFacade *facade = manager.buildFacade();
+    int trainId = facade->addTrain("Replicated Express", 10).getTrainId();
+    int ticketId = facade->bookTicket(trainId, "Omar")->getId();
+    facade->bookTicket(trainId, "Sara");
+    PrimaryReport state{(long long)facade->listTickets().size(), trainId, ticketId, manager.getLogShipper()->position()};
+    if (::write(report, &state, sizeof(state)) != sizeof(state))
+        return 1;
+    char go;
+    if (::read(commands, &go, 1) != 1)
+        return 2;
+    facade->cancelTicket(ticketId);
+    facade->bookTicket(trainId, "Ali");
+    state = {(long long)facade->listTickets().size(), trainId, ticketId, manager.getLogShipper()->position()};
+    if (::write(report, &state, sizeof(state)) != sizeof(state))
+        return 3;
+    return ::read(commands, &go, 1) == 1 ? 0 : 4; // stays up until the replica has checked
+}
+
+TEST_F(LogShippingTest, PrimaryAndReplicaProcesses) {
+    std::string primaryWal = walPath + ".primary";
+    std::remove(primaryWal.c_str());
+    int toParent[2], toChild[2];
+    ASSERT_EQ(::pipe(toParent), 0);
+    ASSERT_EQ(::pipe(toChild), 0);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        ::close(toParent[0]);
+        ::close(toChild[1]);
+        _exit(runPrimary(primaryWal, socketPath, toParent[1], toChild[0]));
+    }
+    ::close(toParent[1]);
+    ::close(toChild[0]);
+
+    {
+        StartupManager manager;
+        ReplicaOptions options;
+        options.retryMs = 5;
+        manager.useReplicaOf(socketPath, options);
+        RMSFacade *facade = manager.buildFacade();
+        LogReplica *replica = manager.getLogReplica();
+
+        PrimaryReport state{};
+        ASSERT_EQ(::read(toParent[0], &state, sizeof(state)), (ssize_t)sizeof(state));
+        ASSERT_TRUE(replica->waitForPosition(state.position, 5000));
+        EXPECT_EQ((long long)facade->listTickets().size(), state.tickets);
+        EXPECT_EQ(facade->listTrains().size(), 6u); // the primary's mock data and its train
+        EXPECT_EQ(facade->getTrain((int)state.trainId).getSeatAllocator()->getAllocatedSeatCount(), 2);
+        EXPECT_ANY_THROW(facade->addTrain("Not here", 5));
+        EXPECT_ANY_THROW(facade->bookTicket((int)state.trainId, "Omar"));
+
+        char go = 1;
+        ASSERT_EQ(::write(toChild[1], &go, 1), 1);
+        ASSERT_EQ(::read(toParent[0], &state, sizeof(state)), (ssize_t)sizeof(state));
+        ASSERT_TRUE(replica->waitForPosition(state.position, 5000));
+        EXPECT_EQ((long long)facade->listTickets().size(), state.tickets);
+        EXPECT_EQ(facade->getTicket((int)state.ticketId).getStatus(), cancelled);
+        EXPECT_EQ(facade->getTrain((int)state.trainId).getSeatAllocator()->getAllocatedSeatCount(), 2);
+        ReplicaStats stats = replica->getStats();
+        EXPECT_TRUE(stats.connected);
+        EXPECT_EQ(stats.behindBytes(), 0u);
+        EXPECT_GT(stats.records, 0);
+        ASSERT_EQ(::write(toChild[1], &go, 1), 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    ::close(toParent[0]);
+    ::close(toChild[1]);
+    std::remove(primaryWal.c_str());
+}
+
+TEST_F(LogShippingTest, OptionsAreChecked) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useLogShipping(socketPath), std::logic_error); // no write-ahead log
+    EXPECT_THROW(manager.useReplicaOf(""), std::invalid_argument);
+    manager.useReplicaOf(socketPath);
+    EXPECT_THROW(manager.useWriteAheadLog(walPath), std::logic_error);
+    EXPECT_THROW(manager.useCache(), std::logic_error);
+    EXPECT_THROW(manager.useSqlite(walPath + ".db"), std::logic_error);
+
+    StartupManager primary;
+    primary.useWriteAheadLog(walPath + ".other");
+    ShippingOptions bad;
+    bad.heartbeatMs = 0;
+    EXPECT_THROW(primary.useLogShipping(socketPath, bad), std::invalid_argument);
+    EXPECT_THROW(primary.useReplicaOf(socketPath), std::logic_error);
+    EXPECT_THROW(LogShipper(nullptr, nullptr, nullptr, nullptr, socketPath), std::invalid_argument);
+    std::remove((walPath + ".other").c_str());
+}
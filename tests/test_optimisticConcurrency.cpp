@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <set>
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "utils/OptimisticRetry.h"
+
+class OptimisticConcurrencyTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+        ticketService->setConcurrencyMode(ConcurrencyMode::Optimistic);
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+
+    vector<int> makePassengers(int count) {
+        vector<int> ids;
+        for (int i = 0; i < count; i++)
+            ids.push_back(passengerService->createPassenger("P" + std::to_string(i)).getId());
+        return ids;
+    }
+
+    template <typename Fn>
+    static void runThreads(int threads, Fn fn) {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++)
+            pool.emplace_back(fn, t);
+        for (auto &th : pool)
+            th.join();
+    }
+};
+
+// ===================== Versioned repositories =====================
+
+TEST_F(OptimisticConcurrencyTest, SaveBumpsVersion) {
+    Train train(0, "Express", 10);
+    EXPECT_EQ(train.getVersion(), 0);
+    trainRepo->save(train);
+    EXPECT_EQ(train.getVersion(), 1);
+    trainRepo->save(train);
+    EXPECT_EQ(train.getVersion(), 2);
+    EXPECT_EQ(trainRepo->getTrainById(train.getTrainId())->getVersion(), 2);
+}
+
+TEST_F(OptimisticConcurrencyTest, StaleTrainCopyIsRejected) {
+    Train train(0, "Express", 10);
+    trainRepo->save(train);
+    Train first = trainRepo->getTrainById(train.getTrainId()).value();
+    Train second = trainRepo->getTrainById(train.getTrainId()).value();
+
+    first.getSeatAllocator()->allocateSeat(1);
+    EXPECT_TRUE(trainRepo->compareAndSave(first));
+    second.getSeatAllocator()->allocateSeat(2);
+    EXPECT_FALSE(trainRepo->compareAndSave(second)); // would have lost passenger 1
+    EXPECT_EQ(second.getVersion(), 1);                // untouched on failure
+
+    Train stored = trainRepo->getTrainById(train.getTrainId()).value();
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), 1);
+    EXPECT_EQ(stored.getVersion(), 2);
+}
+
+TEST_F(OptimisticConcurrencyTest, PassengerAndTicketCompareAndSave) {
+    Passenger passenger(0, "Alice");
+    EXPECT_TRUE(passengerRepo->compareAndSave(passenger)); // new record , version 0 expected
+    Passenger stale = passengerRepo->getPassenger(passenger.getId()).value();
+    passenger.setName("Alicia");
+    EXPECT_TRUE(passengerRepo->compareAndSave(passenger));
+    stale.setName("Ally");
+    EXPECT_FALSE(passengerRepo->compareAndSave(stale));
+    EXPECT_EQ(passengerRepo->getPassenger(passenger.getId())->getName(), "Alicia");
+
+    Ticket ticket(0, 3, 1, passenger);
+    ticketRepo->save(ticket);
+    Ticket copy = ticketRepo->getTicketById(ticket.getId()).value();
+    ticket.setStatus(cancelled);
+    EXPECT_TRUE(ticketRepo->compareAndSave(ticket));
+    copy.setSeat(4);
+    EXPECT_FALSE(ticketRepo->compareAndSave(copy));
+    EXPECT_EQ(ticketRepo->getTicketById(ticket.getId())->getStatus(), cancelled);
+}
+
+// ===================== Retry helper =====================
+
+TEST_F(OptimisticConcurrencyTest, RetryRepeatsOnlyOnConflict) {
+    RetryStats stats;
+    int calls = 0;
+    int result = retryOnConflict([&] {
+        if (++calls < 3)
+            throw ConcurrencyConflict("lost");
+        return 7;
+    }, 5, &stats);
+    EXPECT_EQ(result, 7);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(stats.conflicts.load(), 2);
+    EXPECT_EQ(stats.commits.load(), 1);
+
+    calls = 0;
+    EXPECT_THROW(retryOnConflict([&] { calls++; throw std::runtime_error("real error"); }), std::runtime_error);
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_THROW(retryOnConflict([&] { throw ConcurrencyConflict("always"); }, 3), ConcurrencyConflict);
+}
+
+TEST_F(OptimisticConcurrencyTest, ServiceSaveOfStaleTrainThrowsConflict) {
+    Train train = trainService->createTrain("Express", 5);
+    Train stale = trainService->getTrain(train.getTrainId());
+    trainService->addSeats(train.getTrainId(), 2);
+    EXPECT_THROW(trainService->save(stale), ConcurrencyConflict);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getTotalSeats(), 7);
+}
+
+// ===================== Optimistic booking =====================
+
+TEST_F(OptimisticConcurrencyTest, BookAndCancelWithoutLocks) {
+    Train train = trainService->createTrain("Express", 1);
+    vector<int> passengers = makePassengers(2);
+    auto ticket = ticketService->bookTicket(train.getTrainId(), passengers[0]);
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_FALSE(ticketService->bookTicket(train.getTrainId(), passengers[1]).has_value());
+
+    ticketService->cancelTicket(ticket->getId());
+    auto promoted = ticketRepo->getTicketByTrainAndPassenger(train.getTrainId(), passengers[1]);
+    ASSERT_TRUE(promoted.has_value());
+    EXPECT_EQ(promoted->getSeat(), ticket->getSeat());
+    EXPECT_THROW(ticketService->cancelTicket(ticket->getId()), std::runtime_error);
+    EXPECT_EQ(ticketService->getRetryStats().conflicts.load(), 0);
+}
+
+TEST_F(OptimisticConcurrencyTest, CancellingTwiceLeavesTheTrainAlone) {
+    Train train = trainService->createTrain("Express", 2);
+    vector<int> passengers = makePassengers(1);
+    Ticket ticket = ticketService->bookTicket(train.getTrainId(), passengers[0]).value();
+    ticketService->cancelTicket(ticket.getId());
+    long long version = trainService->getTrain(train.getTrainId()).getVersion();
+    long long attempts = ticketService->getRetryStats().commits.load() + ticketService->getRetryStats().conflicts.load();
+
+    EXPECT_THROW(ticketService->cancelTicket(ticket.getId()), std::runtime_error);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getVersion(), version);
+    EXPECT_EQ(ticketService->getRetryStats().commits.load() + ticketService->getRetryStats().conflicts.load(), attempts);
+}
+
+TEST_F(OptimisticConcurrencyTest, RacingBookingsNeverLoseAnUpdate) {
+    const int seats = 30, threads = 8, perThread = 6;
+    Train train = trainService->createTrain("Express", seats);
+    vector<int> passengers = makePassengers(threads * perThread);
+
+    std::atomic<int> booked{0};
+    runThreads(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++)
+            if (ticketService->bookTicket(train.getTrainId(), passengers[t * perThread + i]).has_value())
+                booked++;
+    });
+
+    EXPECT_EQ(booked.load(), seats);
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getSeatAllocator()->getAllocatedSeatCount(), seats);
+    EXPECT_EQ(stored.getSeatAllocator()->getWaitingListSize(), threads * perThread - seats);
+    std::set<int> seatsSold;
+    for (const auto &ticket : ticketService->getAllTickets())
+        seatsSold.insert(ticket.getSeat());
+    EXPECT_EQ(seatsSold.size(), (size_t)seats);
+    EXPECT_EQ(ticketService->getRetryStats().commits.load(), threads * perThread);
+}
+
+TEST_F(OptimisticConcurrencyTest, RacingCancelsFreeTheSeatOnce) {
+    Train train = trainService->createTrain("Express", 1);
+    vector<int> passengers = makePassengers(3);
+    Ticket ticket = ticketService->bookTicket(train.getTrainId(), passengers[0]).value();
+    ticketService->bookTicket(train.getTrainId(), passengers[1]); // waiting
+    ticketService->bookTicket(train.getTrainId(), passengers[2]); // waiting
+
+    std::atomic<int> succeeded{0};
+    runThreads(6, [&](int) {
+        try {
+            ticketService->cancelTicket(ticket.getId());
+            succeeded++;
+        } catch (const std::runtime_error &) {
+        }
+    });
+    EXPECT_EQ(succeeded.load(), 1);
+    // exactly one waiting passenger promoted , the second still waits
+    Train stored = trainService->getTrain(train.getTrainId());
+    EXPECT_EQ(stored.getSeatAllocator()->getSeatOwner(ticket.getSeat()), passengers[1]);
+    EXPECT_EQ(stored.getSeatAllocator()->getWaitingListSize(), 1);
+}
+
+TEST_F(OptimisticConcurrencyTest, LockedWritersRetryAgainstOptimisticOnes) {
+    Train train = trainService->createTrain("Express", 50);
+    vector<int> passengers = makePassengers(40);
+
+    std::thread tagger([&] {
+        for (int i = 0; i < 40; i++)
+            trainService->tagSeats(train.getTrainId(), 1, 10, SEAT_ACCESSIBLE);
+    });
+    for (int p : passengers)
+        ticketService->bookTicket(train.getTrainId(), p);
+    tagger.join();
+
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAllocatedSeatCount(), 40);
+}
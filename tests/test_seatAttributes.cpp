@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "models/SeatAllocator.h"
+#include "models/SeatAttributes.h"
+#include "structures/bitset.h"
+#include "utils/BinaryCodec.h"
+
+class SeatAttributesTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// ===================== Bitset =====================
+
+TEST_F(SeatAttributesTest, Bitset_SetResetAndFind) {
+    Bitset bits(200);
+    EXPECT_EQ(bits.findFirst(), Bitset::npos);
+    bits.set(3);
+    bits.set(130);
+    EXPECT_TRUE(bits.test(3));
+    EXPECT_EQ(bits.findFirst(), 3);
+    EXPECT_EQ(bits.findNext(4), 130);
+    EXPECT_EQ(bits.findLast(), 130);
+    EXPECT_EQ(bits.count(), 2);
+    bits.reset(3);
+    EXPECT_EQ(bits.findFirst(), 130);
+}
+
+TEST_F(SeatAttributesTest, Bitset_RangesAcrossWords) {
+    Bitset bits(300);
+    bits.setRange(60, 140);
+    EXPECT_EQ(bits.count(), 81);
+    bits.resetRange(64, 127);
+    EXPECT_EQ(bits.count(), 17);
+    EXPECT_EQ(bits.findFirstIn(61, 200), 61);
+    EXPECT_EQ(bits.findFirstIn(64, 127), Bitset::npos);
+}
+
+TEST_F(SeatAttributesTest, Bitset_FindFirstOfAllIntersects) {
+    Bitset a(256), b(256), c(256);
+    a.setRange(0, 255);
+    b.set(10);
+    b.set(200);
+    c.set(200);
+    const Bitset *sets[] = {&a, &b, &c};
+    EXPECT_EQ(Bitset::findFirstOfAll(sets, 3, 0, 255), 200);
+    EXPECT_EQ(Bitset::findFirstOfAll(sets, 2, 0, 255), 10);
+    EXPECT_EQ(Bitset::findFirstOfAll(sets, 3, 0, 199), Bitset::npos);
+}
+
+TEST_F(SeatAttributesTest, Bitset_ShrinkDropsHighBits) {
+    Bitset bits(100);
+    bits.setRange(0, 99);
+    bits.resize(70);
+    EXPECT_EQ(bits.count(), 70);
+    bits.resize(100);
+    EXPECT_EQ(bits.count(), 70);
+}
+
+// ===================== Attribute parsing =====================
+
+TEST_F(SeatAttributesTest, ParseAttributes) {
+    EXPECT_EQ(parseSeatAttributes("window, lower"), SEAT_WINDOW | SEAT_LOWER_BERTH);
+    EXPECT_EQ(parseSeatAttributes(""), 0u);
+    EXPECT_THROW(parseSeatAttributes("balcony"), std::invalid_argument);
+    EXPECT_EQ(seatAttributesToString(SEAT_AISLE | SEAT_ACCESSIBLE), "aisle,accessible");
+}
+
+// ===================== Default pattern =====================
+
+TEST_F(SeatAttributesTest, DefaultPatternWindowAisleDoor) {
+    SeatAllocator allocator(12);
+    EXPECT_EQ(allocator.getSeatAttributes(1), SEAT_WINDOW | SEAT_NEAR_DOOR);
+    EXPECT_EQ(allocator.getSeatAttributes(2), SEAT_AISLE | SEAT_NEAR_DOOR);
+    EXPECT_EQ(allocator.getSeatAttributes(5), SEAT_WINDOW);
+    EXPECT_EQ(allocator.getSeatAttributes(6), SEAT_AISLE);
+    EXPECT_EQ(allocator.getSeatAttributes(12), SEAT_WINDOW | SEAT_NEAR_DOOR);
+}
+
+TEST_F(SeatAttributesTest, GrowMovesTheDoorRow) {
+    SeatAllocator allocator(12);
+    allocator.addSeats(8);
+    EXPECT_EQ(allocator.getSeatAttributes(12), SEAT_WINDOW);
+    EXPECT_EQ(allocator.getSeatAttributes(20), SEAT_WINDOW | SEAT_NEAR_DOOR);
+}
+
+TEST_F(SeatAttributesTest, GrowKeepsExplicitTags) {
+    SeatAllocator allocator(12);
+    allocator.tagSeats(9, 12, SEAT_NEAR_DOOR);
+    allocator.untagSeats(1, 1, SEAT_WINDOW);
+    allocator.addSeats(8);
+    EXPECT_TRUE(allocator.getSeatAttributes(12) & SEAT_NEAR_DOOR);
+    EXPECT_FALSE(allocator.getSeatAttributes(1) & SEAT_WINDOW);
+    EXPECT_EQ(allocator.getSeatAttributes(20), SEAT_WINDOW | SEAT_NEAR_DOOR);
+
+    // the explicit tags survive an encode / decode and the next grow
+    ByteWriter out;
+    allocator.encode(out);
+    std::string bytes = out.take();
+    ByteReader in(bytes);
+    auto copy = SeatAllocator::decode(in);
+    copy->addSeats(4);
+    EXPECT_TRUE(copy->getSeatAttributes(12) & SEAT_NEAR_DOOR);
+    EXPECT_FALSE(copy->getSeatAttributes(1) & SEAT_WINDOW);
+    EXPECT_EQ(copy->getSeatAttributes(20), SEAT_WINDOW);
+}
+
+// ===================== Preference allocation =====================
+
+TEST_F(SeatAttributesTest, ExactMatchTakesLowestMatchingSeat) {
+    SeatAllocator allocator(40);
+    allocator.tagSeats(17, 24, SEAT_LOWER_BERTH);
+
+    SeatRequest request;
+    request.preferences = SEAT_WINDOW | SEAT_LOWER_BERTH;
+    EXPECT_EQ(allocator.allocateSeat(1, request), 17);
+    EXPECT_EQ(allocator.allocateSeat(2, request), 20);
+    EXPECT_EQ(allocator.allocateSeat(3, request), 21);
+}
+
+TEST_F(SeatAttributesTest, FallbackPrefersMoreMatchedAttributes) {
+    SeatAllocator allocator(40);
+    allocator.tagSeats(30, 30, SEAT_LOWER_BERTH); // aisle seat
+
+    SeatRequest request;
+    request.preferences = SEAT_WINDOW | SEAT_LOWER_BERTH | SEAT_ACCESSIBLE;
+    // no seat has all three , seat 30 matches lower only , seat 1 matches window only :
+    // both match one attribute so the lowest seat wins
+    EXPECT_EQ(allocator.allocateSeat(1, request), 1);
+
+    allocator.tagSeats(33, 33, SEAT_LOWER_BERTH); // window + lower
+    EXPECT_EQ(allocator.allocateSeat(2, request), 33);
+}
+
+TEST_F(SeatAttributesTest, FallbackToAnyFreeSeat) {
+    SeatAllocator allocator(4);
+    SeatRequest request;
+    request.preferences = SEAT_ACCESSIBLE;
+    EXPECT_EQ(allocator.allocateSeat(1, request), 1);
+}
+
+TEST_F(SeatAttributesTest, PreferencesStayInsideClassAndCoach) {
+    SeatAllocator allocator(vector<CoachSpec>{{"second", 8}, {"first", 8}});
+    allocator.tagSeats(1, 16, SEAT_ACCESSIBLE);
+
+    SeatRequest first;
+    first.seatClass = "first";
+    first.preferences = SEAT_ACCESSIBLE | SEAT_AISLE;
+    EXPECT_EQ(allocator.allocateSeat(1, first), 10);
+
+    SeatRequest coach;
+    coach.coach = 1;
+    coach.preferences = SEAT_WINDOW;
+    EXPECT_EQ(allocator.allocateSeat(2, coach), 1);
+    EXPECT_EQ(allocator.allocateSeat(3, coach), 4);
+}
+
+TEST_F(SeatAttributesTest, AllocatedSeatsAreSkipped) {
+    SeatAllocator allocator(8);
+    SeatRequest request;
+    request.preferences = SEAT_WINDOW;
+    EXPECT_EQ(allocator.allocateSeat(1, request), 1);
+    EXPECT_EQ(allocator.allocateSeat(2, request), 4);
+    allocator.freeSeat(1);
+    EXPECT_TRUE(allocator.isSeatFree(1));
+    EXPECT_EQ(allocator.allocateSeat(3, request), 1);
+}
+
+TEST_F(SeatAttributesTest, InvalidTagRangeThrows) {
+    SeatAllocator allocator(8);
+    EXPECT_THROW(allocator.tagSeats(0, 3, SEAT_WINDOW), std::invalid_argument);
+    EXPECT_THROW(allocator.tagSeats(5, 9, SEAT_WINDOW), std::invalid_argument);
+}
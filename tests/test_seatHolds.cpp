@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "models/SeatAllocator.h"
+#include "Services/HoldScheduler.h"
+#include "Services/TicketService.h"
+#include "Services/TrainService.h"
+#include "Services/PassengerService.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+
+class SeatHoldsTest : public ::testing::Test {
+protected:
+    std::unique_ptr<InMemoryTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryTrainRepository> trainRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+    long long now = 1000000;
+
+    void SetUp() override {
+        ticketRepo = std::make_unique<InMemoryTicketRepository>();
+        trainRepo = std::make_unique<InMemoryTrainRepository>();
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+        ticketService->setClock([this]() { return now; });
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+};
+
+// ===================== Allocator =====================
+
+TEST_F(SeatHoldsTest, HeldSeatIsNeitherFreeNorAllocated) {
+    SeatAllocator allocator(4);
+    int seat = allocator.holdSeat(1, 10, 5000);
+    EXPECT_FALSE(allocator.isSeatFree(seat));
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 3);
+    EXPECT_EQ(allocator.getAllocatedSeatCount(), 0);
+    EXPECT_EQ(allocator.getHeldSeatCount(), 1);
+    EXPECT_THROW(allocator.allocateSeat(10), std::runtime_error);
+    EXPECT_THROW(allocator.freeSeat(seat), std::out_of_range);
+}
+
+TEST_F(SeatHoldsTest, ConfirmTurnsHoldIntoAllocation) {
+    SeatAllocator allocator(4);
+    int seat = allocator.holdSeat(1, 10, 5000);
+    EXPECT_EQ(allocator.confirmHold(1), seat);
+    EXPECT_FALSE(allocator.hasHold(1));
+    EXPECT_EQ(allocator.getAllocatedSeatCount(), 1);
+    EXPECT_THROW(allocator.confirmHold(1), std::out_of_range);
+}
+
+TEST_F(SeatHoldsTest, ReleaseReturnsSeatOrPromotesWaitlist) {
+    SeatAllocator allocator(1);
+    int seat = allocator.holdSeat(1, 10, 5000);
+    EXPECT_EQ(allocator.releaseHold(1), 0);
+    EXPECT_TRUE(allocator.isSeatFree(seat));
+
+    allocator.holdSeat(2, 10, 5000);
+    EXPECT_EQ(allocator.allocateSeat(20), -1); // waitlisted
+    EXPECT_EQ(allocator.releaseHold(2), 20);
+}
+
+TEST_F(SeatHoldsTest, HoldOnFullTrainThrows) {
+    SeatAllocator allocator(1);
+    allocator.allocateSeat(10);
+    EXPECT_THROW(allocator.holdSeat(1, 20, 5000), std::runtime_error);
+    EXPECT_EQ(allocator.getWaitingListSize(), 0);
+}
+
+TEST_F(SeatHoldsTest, HoldsSurviveCopy) {
+    SeatAllocator allocator(4);
+    allocator.holdSeat(7, 10, 5000);
+    SeatAllocator copy(allocator);
+    EXPECT_TRUE(copy.hasHold(7));
+    EXPECT_EQ(copy.getHold(7).expiresAt, 5000);
+}
+
+// ===================== Scheduler =====================
+
+TEST_F(SeatHoldsTest, SchedulerPopsDueTimersInOrder) {
+    HoldScheduler scheduler;
+    scheduler.schedule(1, 1, 300);
+    scheduler.schedule(2, 1, 100);
+    scheduler.schedule(3, 2, 200);
+    EXPECT_EQ(scheduler.nextExpiry(), 100);
+
+    auto due = scheduler.popDue(250, 10);
+    ASSERT_EQ(due.size(), 2u);
+    EXPECT_EQ(due[0].holdId, 2);
+    EXPECT_EQ(due[1].holdId, 3);
+    EXPECT_EQ(scheduler.size(), 1u);
+}
+
+TEST_F(SeatHoldsTest, SchedulerRespectsBatchSize) {
+    HoldScheduler scheduler;
+    for (int i = 1; i <= 5; i++)
+        scheduler.schedule(i, 1, i);
+    EXPECT_EQ(scheduler.popDue(10, 2).size(), 2u);
+    EXPECT_EQ(scheduler.popDue(10, 10).size(), 3u);
+    EXPECT_TRUE(scheduler.empty());
+    EXPECT_EQ(scheduler.nextExpiry(), -1);
+}
+
+// ===================== TicketService =====================
+
+TEST_F(SeatHoldsTest, HoldThenConfirmBooksTicket) {
+    Train train = trainService->createTrain("Express", 4);
+    Passenger passenger = passengerService->createPassenger("Alice");
+
+    SeatHold hold = ticketService->holdSeat(train.getTrainId(), passenger.getId(), 300);
+    EXPECT_EQ(hold.expiresAt, now + 300000);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAvailableSeatCount(), 3);
+
+    now += 1000;
+    Ticket ticket = ticketService->confirmHold(hold.holdId);
+    EXPECT_EQ(ticket.getSeat(), hold.seatNumber);
+    EXPECT_EQ(ticket.getPassenger().getId(), passenger.getId());
+    EXPECT_EQ(ticketService->getActiveHoldCount(), 0);
+
+    // the stale timer fires later and is ignored
+    now += 600000;
+    EXPECT_EQ(ticketService->expireHolds(), 0);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAllocatedSeatCount(), 1);
+}
+
+TEST_F(SeatHoldsTest, ExpiredHoldCannotBeConfirmed) {
+    Train train = trainService->createTrain("Express", 4);
+    Passenger passenger = passengerService->createPassenger("Alice");
+
+    SeatHold hold = ticketService->holdSeat(train.getTrainId(), passenger.getId(), 60);
+    now += 60000;
+    EXPECT_THROW(ticketService->confirmHold(hold.holdId), std::runtime_error);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAvailableSeatCount(), 4);
+    EXPECT_THROW(ticketService->confirmHold(hold.holdId), std::out_of_range);
+}
+
+TEST_F(SeatHoldsTest, ExpireHoldsReleasesLapsedHoldsOnly) {
+    Train express = trainService->createTrain("Express", 4);
+    Train local = trainService->createTrain("Local", 4);
+    Passenger alice = passengerService->createPassenger("Alice");
+    Passenger bob = passengerService->createPassenger("Bob");
+    Passenger carol = passengerService->createPassenger("Carol");
+
+    ticketService->holdSeat(express.getTrainId(), alice.getId(), 60);
+    ticketService->holdSeat(local.getTrainId(), bob.getId(), 60);
+    ticketService->holdSeat(express.getTrainId(), carol.getId(), 600);
+
+    now += 120000;
+    EXPECT_EQ(ticketService->expireHolds(), 2);
+    EXPECT_EQ(ticketService->getActiveHoldCount(), 1);
+    EXPECT_EQ(trainService->getTrain(express.getTrainId()).getSeatAllocator()->getHeldSeatCount(), 1);
+    EXPECT_EQ(trainService->getTrain(local.getTrainId()).getSeatAllocator()->getHeldSeatCount(), 0);
+}
+
+TEST_F(SeatHoldsTest, ExpiryPromotesWaitingPassenger) {
+    Train train = trainService->createTrain("Express", 1);
+    Passenger alice = passengerService->createPassenger("Alice");
+    Passenger bob = passengerService->createPassenger("Bob");
+
+    ticketService->holdSeat(train.getTrainId(), alice.getId(), 60);
+    EXPECT_FALSE(ticketService->bookTicket(train.getTrainId(), bob.getId()).has_value());
+
+    now += 60000;
+    EXPECT_EQ(ticketService->expireHolds(), 1);
+    auto ticket = ticketRepo->getTicketByTrainAndPassenger(train.getTrainId(), bob.getId());
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(ticket->getSeat(), 1);
+}
+
+TEST_F(SeatHoldsTest, BackgroundExpiryReleasesAtTheDeadline) {
+    ticketService->setClock([] {
+        using namespace std::chrono;
+        return (long long)duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    });
+    ticketService->expireHoldsInBackground();
+    EXPECT_THROW(ticketService->expireHoldsInBackground(), std::logic_error);
+    Train train = trainService->createTrain("Express", 1);
+    Passenger alice = passengerService->createPassenger("Alice");
+    Passenger bob = passengerService->createPassenger("Bob");
+
+    ticketService->holdSeat(train.getTrainId(), alice.getId(), 1);
+    EXPECT_FALSE(ticketService->bookTicket(train.getTrainId(), bob.getId()).has_value());
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (ticketService->getActiveHoldCount() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(ticketService->getActiveHoldCount(), 0);
+    // the released seat went to the waiting passenger , nobody called expireHolds
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!ticketRepo->getTicketByTrainAndPassenger(train.getTrainId(), bob.getId()).has_value() &&
+           std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(ticketRepo->getTicketByTrainAndPassenger(train.getTrainId(), bob.getId()).has_value());
+}
+
+TEST_F(SeatHoldsTest, ReleaseHoldFreesSeat) {
+    Train train = trainService->createTrain("Express", 2);
+    Passenger alice = passengerService->createPassenger("Alice");
+
+    SeatHold hold = ticketService->holdSeat(train.getTrainId(), alice.getId(), 60);
+    ticketService->releaseHold(hold.holdId);
+    EXPECT_EQ(trainService->getTrain(train.getTrainId()).getSeatAllocator()->getAvailableSeatCount(), 2);
+    EXPECT_THROW(ticketService->releaseHold(hold.holdId), std::out_of_range);
+}
+
+TEST_F(SeatHoldsTest, HoldRejectsBadInput) {
+    Train train = trainService->createTrain("Express", 2);
+    Passenger alice = passengerService->createPassenger("Alice");
+
+    EXPECT_THROW(ticketService->holdSeat(train.getTrainId(), alice.getId(), 0), std::invalid_argument);
+    EXPECT_THROW(ticketService->holdSeat(999, alice.getId(), 60), std::out_of_range);
+    ticketService->bookTicket(train.getTrainId(), alice.getId());
+    EXPECT_THROW(ticketService->holdSeat(train.getTrainId(), alice.getId(), 60), std::runtime_error);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "models/SeatLayout.h"
+#include "models/SeatAllocator.h"
+#include "models/Train.h"
+#include "structures/fenwickTree.h"
+
+class SeatLayoutTest : public ::testing::Test {
+protected:
+    // coach 1 sleeper(10) , coach 2-3 first(5 each) , coach 4 sleeper(10)
+    vector<CoachSpec> mixed = {{"sleeper", 10}, {"first", 5}, {"first", 5}, {"sleeper", 10}};
+};
+
+// ===================== Fenwick Tree =====================
+
+TEST_F(SeatLayoutTest, Fenwick_PrefixSumsAndLowerBound) {
+    FenwickTree<int> tree(5);
+    tree.add(0, 0);
+    tree.add(2, 3);
+    tree.add(4, 1);
+    EXPECT_EQ(tree.prefixSum(1), 0);
+    EXPECT_EQ(tree.prefixSum(2), 3);
+    EXPECT_EQ(tree.total(), 4);
+    EXPECT_EQ(tree.lowerBound(1), 2);
+    EXPECT_EQ(tree.lowerBound(4), 4);
+    EXPECT_EQ(tree.lowerBound(5), 5); // not reachable
+}
+
+// ===================== Layout =====================
+
+TEST_F(SeatLayoutTest, DefaultLayoutIsSingleGeneralCoach) {
+    SeatLayout layout(12);
+    EXPECT_EQ(layout.getCoachCount(), 1);
+    EXPECT_EQ(layout.getClassCount(), 1);
+    EXPECT_EQ(layout.getClassFreeSeats(SeatLayout::DEFAULT_CLASS), 12);
+}
+
+TEST_F(SeatLayoutTest, CoachesNumberSeatsContiguously) {
+    SeatLayout layout(mixed);
+    EXPECT_EQ(layout.getTotalSeats(), 30);
+    EXPECT_EQ(layout.getCoach(2).firstSeat, 11);
+    EXPECT_EQ(layout.getCoach(4).firstSeat, 21);
+    EXPECT_EQ(layout.coachOf(1), 1);
+    EXPECT_EQ(layout.coachOf(15), 2);
+    EXPECT_EQ(layout.coachOf(16), 3);
+    EXPECT_EQ(layout.coachOf(30), 4);
+    EXPECT_EQ(layout.classOf(25), "sleeper");
+}
+
+TEST_F(SeatLayoutTest, ClassTotalsGroupNonAdjacentCoaches) {
+    SeatLayout layout(mixed);
+    EXPECT_EQ(layout.getClassCount(), 2);
+    EXPECT_EQ(layout.getClassTotalSeats("sleeper"), 20);
+    EXPECT_EQ(layout.getClassTotalSeats("FIRST"), 10);
+}
+
+TEST_F(SeatLayoutTest, UnknownClassThrows) {
+    SeatLayout layout(mixed);
+    EXPECT_THROW(layout.getClassFreeSeats("second"), std::invalid_argument);
+    EXPECT_THROW(layout.findCoach({"second", 0}), std::invalid_argument);
+}
+
+TEST_F(SeatLayoutTest, InvalidSpecsThrow) {
+    EXPECT_THROW(SeatLayout(vector<CoachSpec>{}), std::invalid_argument);
+    EXPECT_THROW(SeatLayout(vector<CoachSpec>{{"first", 0}}), std::invalid_argument);
+    EXPECT_THROW(SeatLayout(vector<CoachSpec>{{"", 5}}), std::invalid_argument);
+}
+
+TEST_F(SeatLayoutTest, FindCoachSkipsFullCoaches) {
+    SeatLayout layout(mixed);
+    for (int seat = 11; seat <= 15; seat++)
+        layout.markAllocated(seat);
+    EXPECT_EQ(layout.getClassFreeSeats("first"), 5);
+    EXPECT_EQ(layout.findCoach({"first", 0})->number, 3);
+    EXPECT_EQ(layout.findCoach({"", 2}), nullptr);
+
+    layout.markFree(12);
+    EXPECT_EQ(layout.findCoach({"first", 0})->number, 2);
+}
+
+TEST_F(SeatLayoutTest, CoachOutsideClassThrows) {
+    SeatLayout layout(mixed);
+    EXPECT_THROW(layout.findCoach({"first", 1}), std::invalid_argument);
+    EXPECT_THROW(layout.findCoach({"", 9}), std::out_of_range);
+}
+
+TEST_F(SeatLayoutTest, GrowAndShrinkTail) {
+    SeatLayout layout(mixed);
+    layout.grow(5);
+    EXPECT_EQ(layout.getCoach(4).seatCount, 15);
+    EXPECT_EQ(layout.getClassTotalSeats("sleeper"), 25);
+
+    layout.shrink(20); // drops coach 4 (15 seats) and coach 3 (5 seats)
+    EXPECT_EQ(layout.getCoachCount(), 2);
+    EXPECT_EQ(layout.getTotalSeats(), 15);
+    EXPECT_EQ(layout.getClassTotalSeats("sleeper"), 10);
+    EXPECT_EQ(layout.getClassTotalSeats("first"), 5);
+
+    layout.shrink(2);
+    EXPECT_EQ(layout.getCoach(2).seatCount, 3);
+    EXPECT_EQ(layout.getClassFreeSeats("first"), 3);
+}
+
+// ===================== Allocator integration =====================
+
+TEST_F(SeatLayoutTest, AllocateInClass) {
+    SeatAllocator allocator(mixed);
+    EXPECT_EQ(allocator.allocateSeat(1, {"first", 0}), 11);
+    EXPECT_EQ(allocator.allocateSeat(2, {"sleeper", 0}), 1);
+    EXPECT_EQ(allocator.allocateSeat(3, {"", 4}), 21);
+    EXPECT_EQ(allocator.getClassAvailableSeatCount("first"), 9);
+    EXPECT_EQ(allocator.getClassAvailableSeatCount("sleeper"), 18);
+    EXPECT_EQ(allocator.getAvailableSeatCount(), 27);
+}
+
+TEST_F(SeatLayoutTest, FullClassThrowsWhileTrainHasSeats) {
+    SeatAllocator allocator(vector<CoachSpec>{{"first", 1}, {"second", 2}});
+    allocator.allocateSeat(1, {"first", 0});
+    EXPECT_THROW(allocator.allocateSeat(2, {"first", 0}), std::runtime_error);
+    EXPECT_EQ(allocator.getWaitingListSize(), 0);
+}
+
+TEST_F(SeatLayoutTest, FullTrainStillWaitlists) {
+    SeatAllocator allocator(vector<CoachSpec>{{"first", 1}});
+    allocator.allocateSeat(1, {"first", 0});
+    EXPECT_EQ(allocator.allocateSeat(2, {"first", 0}), -1);
+    EXPECT_EQ(allocator.getWaitingListSize(), 1);
+}
+
+TEST_F(SeatLayoutTest, FreedSeatReturnsToItsClass) {
+    SeatAllocator allocator(mixed);
+    int seat = allocator.allocateSeat(1, {"first", 0});
+    allocator.freeSeat(seat);
+    EXPECT_EQ(allocator.getClassAvailableSeatCount("first"), 10);
+    // a class request may take a seat sitting in the cancelled stack
+    EXPECT_EQ(allocator.allocateSeat(2, {"first", 0}), seat);
+    // the stale stack entry must not be handed out twice
+    EXPECT_EQ(allocator.allocateSeat(3), 1);
+    EXPECT_EQ(allocator.getAllocatedSeatCount(), 2);
+}
+
+TEST_F(SeatLayoutTest, ShrinkRefusesAllocatedTail) {
+    SeatAllocator allocator(5);
+    for (int p = 1; p <= 5; p++)
+        allocator.allocateSeat(p);
+    allocator.freeSeat(1);
+    EXPECT_THROW(allocator.changeTotalSeats(4), std::runtime_error);
+}
+
+TEST_F(SeatLayoutTest, LayoutChangeRequiresEmptyTrain) {
+    SeatAllocator allocator(5);
+    allocator.allocateSeat(1);
+    EXPECT_THROW(allocator.setLayout(mixed), std::runtime_error);
+}
+
+TEST_F(SeatLayoutTest, TrainWithCoaches) {
+    Train train(1, "Sleeper Express", mixed);
+    EXPECT_EQ(train.getTotalSeats(), 30);
+    EXPECT_EQ(train.getClassAvailability("sleeper"), 20);
+
+    train.setCoachLayout({{"second", 40}});
+    EXPECT_EQ(train.getTotalSeats(), 40);
+    EXPECT_EQ(train.getClassAvailability("second"), 40);
+
+    Train copy(train);
+    copy.getSeatAllocator()->allocateSeat(7, {"second", 1});
+    EXPECT_EQ(train.getClassAvailability("second"), 40);
+    EXPECT_EQ(copy.getClassAvailability("second"), 39);
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <map>
+#include <thread>
+#include "RMSFacade.h"
+#include "Repo/RepositoryShards.h"
+#include "Repo/ShardedTrainRepository.h"
+#include "Repo/ShardedTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Services/BookingPipeline.h"
+#include "StartupManager.h"
+
+class ShardedRepositoryTest : public ::testing::Test {
+protected:
+    RepositoryShards shards{4};
+    std::unique_ptr<ShardedTrainRepository> trainRepo;
+    std::unique_ptr<ShardedTicketRepository> ticketRepo;
+    std::unique_ptr<InMemoryPassengerRepository> passengerRepo;
+
+    std::unique_ptr<TrainService> trainService;
+    std::unique_ptr<PassengerService> passengerService;
+    std::unique_ptr<TicketService> ticketService;
+
+    void SetUp() override {
+        trainRepo = std::make_unique<ShardedTrainRepository>(&shards);
+        ticketRepo = std::make_unique<ShardedTicketRepository>(&shards);
+        passengerRepo = std::make_unique<InMemoryPassengerRepository>();
+
+        trainService = std::make_unique<TrainService>(trainRepo.get());
+        passengerService = std::make_unique<PassengerService>(passengerRepo.get());
+        ticketService = std::make_unique<TicketService>(
+                ticketRepo.get(),
+                trainService.get(),
+                passengerService.get()
+        );
+    }
+
+    void TearDown() override {
+        ticketRepo->clear();
+        trainRepo->clear();
+        passengerRepo->clear();
+    }
+
+    vector<int> makePassengers(int count) {
+        vector<int> ids;
+        for (int i = 0; i < count; i++)
+            ids.push_back(passengerService->createPassenger("P" + std::to_string(i)).getId());
+        return ids;
+    }
+};
+
+// ===================== placement =====================
+
+TEST_F(ShardedRepositoryTest, TrainsSpreadAcrossShards) {
+    for (int t = 0; t < 8; t++)
+        trainService->createTrain("T" + std::to_string(t), 2);
+    for (int s = 0; s < shards.count(); s++)
+        EXPECT_EQ(shards.shard(s).trains.getAllTrains().size(), 2u);
+
+    auto all = trainRepo->getAllTrains();
+    ASSERT_EQ(all.size(), 8u);
+    for (size_t i = 0; i < all.size(); i++)
+        EXPECT_EQ(all[i].getTrainId(), (int)i + 1);
+}
+
+TEST_F(ShardedRepositoryTest, TicketsLiveNextToTheirTrain) {
+    vector<int> passengers = makePassengers(3);
+    std::vector<int> trainIds;
+    for (int t = 0; t < 6; t++)
+        trainIds.push_back(trainService->createTrain("T" + std::to_string(t), 5).getTrainId());
+
+    for (int id : trainIds)
+        for (int p : passengers) {
+            auto ticket = ticketService->bookTicket(id, p);
+            ASSERT_TRUE(ticket.has_value());
+            int home = shards.shardOf(id);
+            EXPECT_EQ(shards.homeOfTicket(ticket->getId()), home); // the id leads back to the shard
+            EXPECT_TRUE(shards.shard(home).tickets.getTicketById(ticket->getId()).has_value());
+        }
+
+    auto all = ticketRepo->getAllTickets();
+    ASSERT_EQ(all.size(), 18u);
+    std::set<int> ids;
+    for (size_t i = 0; i < all.size(); i++) {
+        ids.insert(all[i].getId());
+        if (i > 0) {
+            EXPECT_LT(all[i - 1].getId(), all[i].getId());
+        }
+    }
+    EXPECT_EQ(ids.size(), 18u);
+}
+
+TEST_F(ShardedRepositoryTest, PagesMergeShardsInIdOrder) {
+    for (int t = 0; t < 23; t++)
+        trainService->createTrain("T" + std::to_string(t), 1);
+    std::vector<int> seen;
+    int after = 0;
+    while (true) {
+        auto page = trainRepo->getTrainsPage(after, 5);
+        for (auto &train : page)
+            seen.push_back(train.getTrainId());
+        if (page.size() < 5)
+            break;
+        after = page[page.size() - 1].getTrainId();
+    }
+    ASSERT_EQ(seen.size(), 23u);
+    for (int i = 0; i < 23; i++)
+        EXPECT_EQ(seen[i], i + 1);
+}
+
+// ===================== ids chosen by the caller =====================
+
+TEST_F(ShardedRepositoryTest, CallerChosenIdsAreFoundAndNeverReused) {
+    Passenger p(1, "Omar");
+    Ticket chosen(6, 1, 1, p); // id 6 is handed out by shard 1 , train 1 lives in shard 1 too
+    Ticket stray(7, 2, 1, p);  // id 7 belongs to shard 2 , the ticket goes to train 1's shard
+    ticketRepo->save(chosen);
+    ticketRepo->save(stray);
+
+    ASSERT_TRUE(ticketRepo->getTicketById(7).has_value());
+    EXPECT_EQ(ticketRepo->getTicketById(7)->getSeat(), 2);
+
+    for (int i = 0; i < 20; i++) {
+        Ticket fresh(0, 3, 1 + i % 4, p);
+        ticketRepo->save(fresh);
+        EXPECT_NE(fresh.getId(), 6);
+        EXPECT_NE(fresh.getId(), 7);
+    }
+    EXPECT_EQ(ticketRepo->getAllTickets().size(), 22u);
+    EXPECT_TRUE(ticketRepo->deleteTicket(7));
+    EXPECT_FALSE(ticketRepo->getTicketById(7).has_value());
+    EXPECT_FALSE(ticketRepo->deleteTicket(7));
+}
+
+TEST_F(ShardedRepositoryTest, TicketCannotChangeShard) {
+    Passenger p(1, "Omar");
+    Ticket t(0, 1, 1, p);
+    ticketRepo->save(t);
+    Ticket moved(t.getId(), 1, 2, p); // same id , train of another shard
+    EXPECT_THROW(ticketRepo->save(moved), std::invalid_argument);
+}
+
+TEST_F(ShardedRepositoryTest, VersionsStillGuardWrites) {
+    Train train = trainService->createTrain("Express", 2);
+    Train first = trainService->getTrain(train.getTrainId());
+    Train second = trainService->getTrain(train.getTrainId());
+    EXPECT_TRUE(trainRepo->compareAndSave(first));
+    EXPECT_FALSE(trainRepo->compareAndSave(second));
+
+    Passenger p(1, "Omar");
+    Ticket t(0, 1, train.getTrainId(), p);
+    ticketRepo->save(t);
+    Ticket stale = t;
+    EXPECT_TRUE(ticketRepo->compareAndSave(t));
+    EXPECT_FALSE(ticketRepo->compareAndSave(stale));
+}
+
+// ===================== cross-shard lookups =====================
+
+TEST_F(ShardedRepositoryTest, PassengerLookupMergesShards) {
+    vector<int> passengers = makePassengers(2);
+    for (int t = 0; t < 8; t++)
+        trainService->createTrain("T" + std::to_string(t), 4);
+    for (int id = 1; id <= 8; id++)
+        ticketService->bookTicket(id, passengers[id % 2]);
+
+    auto tickets = ticketService->getTicketsByPassenger(passengers[0]);
+    ASSERT_EQ(tickets.size(), 4u);
+    for (size_t i = 0; i < tickets.size(); i++) {
+        EXPECT_EQ(tickets[i].getTrainId() % 2, 0);
+        if (i > 0) {
+            EXPECT_LT(tickets[i - 1].getId(), tickets[i].getId());
+        }
+    }
+}
+
+TEST_F(ShardedRepositoryTest, FacadeWorksOverShards) {
+    RMSFacade facade(trainService.get(), ticketService.get(), passengerService.get());
+    Train a = facade.addTrain("Alex", 1);
+    Train b = facade.addTrain("Cairo", 2);
+    auto ticket = facade.bookTicket(a.getTrainId(), "omar");
+    ASSERT_TRUE(ticket.has_value());
+    facade.bookTicket(b.getTrainId(), "omar");
+    EXPECT_FALSE(facade.bookTicket(a.getTrainId(), "sara").has_value());
+
+    facade.cancelTicket(ticket->getId()); // sara is promoted on the same shard
+    int booked = 0;
+    for (const auto &t : facade.listTickets())
+        if (t.getStatus() == ::booked)
+            booked++;
+    EXPECT_EQ(booked, 2);
+
+    Passenger omar = passengerService->find_or_create_passenger("omar");
+    facade.updatePassenger(omar.getId(), "omar2");
+    for (const auto &t : ticketService->getTicketsByPassenger(omar.getId()))
+        EXPECT_EQ(t.getPassenger().getName(), "omar2");
+}
+
+// ===================== thread per shard =====================
+
+TEST_F(ShardedRepositoryTest, ConcurrentBookingsAcrossShards) {
+    const int trains = 8, seats = 50;
+    for (int t = 0; t < trains; t++)
+        trainService->createTrain("T" + std::to_string(t), seats);
+    vector<int> passengers = makePassengers(seats);
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t <= trains; t++)
+        threads.emplace_back([&, t] {
+            for (int p : passengers)
+                ticketService->bookTicket(t, p);
+        });
+    for (auto &th : threads)
+        th.join();
+
+    EXPECT_EQ(ticketRepo->getAllTickets().size(), (size_t)trains * seats);
+    for (int t = 1; t <= trains; t++)
+        EXPECT_EQ(trainService->getTrain(t).getSeatAllocator()->getAllocatedSeatCount(), seats);
+}
+
+TEST_F(ShardedRepositoryTest, PipelinePinsOneWorkerPerShard) {
+    const int trains = 8, seats = 20;
+    for (int t = 0; t < trains; t++)
+        trainService->createTrain("T" + std::to_string(t), seats);
+    vector<int> passengers = makePassengers(seats);
+
+    BookingPipelineOptions options;
+    options.workers = shards.count();
+    options.shardOf = [this](int trainId) { return shards.shardOf(trainId); };
+    BookingPipeline pipeline(ticketService.get(), options);
+
+    std::mutex seenMutex;
+    std::map<int, std::set<std::thread::id>> threadsPerShard;
+    for (int p : passengers)
+        for (int t = 1; t <= trains; t++) {
+            BookingRequest r;
+            r.trainId = t;
+            r.passengerId = p;
+            pipeline.submit(r, [&, t](const std::optional<Ticket> &ticket, std::exception_ptr error) {
+                EXPECT_TRUE(ticket.has_value());
+                EXPECT_FALSE(error);
+                std::lock_guard<std::mutex> guard(seenMutex);
+                threadsPerShard[shards.shardOf(t)].insert(std::this_thread::get_id());
+            });
+        }
+    pipeline.shutdown();
+
+    EXPECT_EQ(pipeline.getStats().completed, trains * seats);
+    std::set<std::thread::id> all;
+    for (auto &[shard, ids] : threadsPerShard) {
+        EXPECT_EQ(ids.size(), 1u) << "shard " << shard;
+        all.insert(ids.begin(), ids.end());
+    }
+    EXPECT_EQ(all.size(), (size_t)shards.count()); // and every shard had its own worker
+}
+
+TEST_F(ShardedRepositoryTest, InvalidShardCountThrows) {
+    EXPECT_THROW(RepositoryShards(0), std::invalid_argument);
+    EXPECT_THROW(ShardedTrainRepository(nullptr), std::invalid_argument);
+}
+
+TEST_F(ShardedRepositoryTest, StartupManagerBuildsOnShards) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useShardedRepositories(0), std::invalid_argument);
+    manager.useShardedRepositories(4);
+    EXPECT_THROW(manager.useSqlite("unused.db"), std::logic_error);
+    EXPECT_THROW(manager.useWriteAheadLog("unused.wal"), std::logic_error);
+
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 5u); // the mock data
+    auto ticket = facade->bookTicket(3, "Ali");
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(facade->getTicket(ticket->getId()).getTrainId(), 3);
+    EXPECT_THROW(manager.useShardedRepositories(2), std::logic_error);
+}
+
+TEST_F(ShardedRepositoryTest, ClearAnnouncesOnce) {
+    trainService->createTrain("Express", 2);
+    testing::internal::CaptureStdout();
+    ticketRepo->clear();
+    trainRepo->clear();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "All tickets destroyed\nAll trains destroyed\n");
+}
@@ -0,0 +1,387 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <sys/wait.h>
+#include <csignal>
+#include <unistd.h>
+#include "utils/BinaryCodec.h"
+#include "Repo/SharedSegment.h"
+#include "Repo/SharedTrainRepository.h"
+#include "Repo/SharedTicketRepository.h"
+#include "Repo/SharedPassengerRepository.h"
+#include "Services/TicketService.h"
+#include "StartupManager.h"
+
+class SharedMemoryRepositoryTest : public ::testing::Test {
+protected:
+    std::string name;
+    SharedSegmentOptions options;
+
+    void SetUp() override {
+        static int counter = 0;
+        name = "/rms_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+        options.maxTrains = 64;
+        options.maxTickets = 4096;
+        options.maxPassengers = 1024;
+        options.heapBytes = 8u << 20;
+        SharedSegment::remove(name);
+    }
+
+    void TearDown() override {
+        SharedSegment::remove(name);
+    }
+
+    template <class T>
+    static T roundTrip(const T &value) {
+        ByteWriter out;
+        value.encode(out);
+        ByteReader in(out.data());
+        T decoded = T::decode(in);
+        EXPECT_TRUE(in.done());
+        return decoded;
+    }
+};
+
+// ===================== codec =====================
+
+TEST_F(SharedMemoryRepositoryTest, TrainRoundTripKeepsEveryInventory) {
+    Train train(7, "Coded", vector<CoachSpec>{{"First", 8}, {"Economy", 16}});
+    SeatAllocator *seats = train.getSeatAllocator();
+    seats->tagSeats(3, 4, SEAT_LOWER_BERTH);
+    for (int p = 1; p <= 6; p++)
+        seats->allocateSeat(p);
+    seats->freeSeat(2);
+    seats->holdSeat(9, 50, 123456, SeatRequest{"Economy", 0, 0, true});
+    train.getSeatAllocator(20260301)->allocateSeat(99, SeatRequest{"First"});
+    train.setVersion(12);
+
+    Train copy = roundTrip(train);
+    EXPECT_EQ(copy.getTrainId(), 7);
+    EXPECT_EQ(copy.getTrainName(), "Coded");
+    EXPECT_EQ(copy.getVersion(), 12);
+    SeatAllocator *copied = copy.getSeatAllocator();
+    EXPECT_EQ(copied->getAllocatedSeatCount(), seats->getAllocatedSeatCount());
+    EXPECT_EQ(copied->getHeldSeatCount(), 1);
+    EXPECT_EQ(copied->getClassAvailableSeatCount("economy"), seats->getClassAvailableSeatCount("economy"));
+    for (int seat = 1; seat <= 24; seat++) {
+        EXPECT_EQ(copied->getSeatOwner(seat), seats->getSeatOwner(seat)) << "seat " << seat;
+        EXPECT_EQ(copied->getSeatAttributes(seat), seats->getSeatAttributes(seat)) << "seat " << seat;
+        EXPECT_EQ(copied->isSeatMovable(seat), seats->isSeatMovable(seat)) << "seat " << seat;
+    }
+    EXPECT_EQ(copied->getHold(9).expiresAt, 123456);
+    EXPECT_EQ(copy.getDepartureDates().size(), 1u);
+    EXPECT_EQ(copy.findSeatAllocator(20260301)->getAllocatedSeatCount(), 1);
+
+    // the cancelled seat is reused first on both , the hold can be confirmed on the copy
+    EXPECT_EQ(copied->allocateSeat(70), seats->allocateSeat(70));
+    EXPECT_EQ(copied->confirmHold(9), seats->confirmHold(9));
+    EXPECT_THROW(copied->allocateSeat(1), std::runtime_error); // still knows passenger 1
+}
+
+TEST_F(SharedMemoryRepositoryTest, WaitingListAndTicketRoundTrip) {
+    SeatAllocator seats(2);
+    for (int p = 1; p <= 5; p++)
+        seats.allocateSeat(p);
+    ByteWriter out;
+    seats.encode(out);
+    ByteReader in(out.data());
+    auto copy = SeatAllocator::decode(in);
+    EXPECT_EQ(copy->getWaitingListSize(), 3);
+    EXPECT_EQ(copy->getWaitingList().front(), 3);
+
+    Ticket ticket(5, 2, 3, Passenger(4, "Sara"), 20260102);
+    ticket.setStatus(cancelled);
+    Ticket decoded = roundTrip(ticket);
+    EXPECT_EQ(decoded.getId(), 5);
+    EXPECT_EQ(decoded.getSeat(), 2);
+    EXPECT_EQ(decoded.getTravelDate(), 20260102);
+    EXPECT_EQ(decoded.getStatus(), cancelled);
+    EXPECT_EQ(decoded.getPassenger().getName(), "Sara");
+
+    std::string truncated = out.data().substr(0, out.size() / 2);
+    ByteReader broken(truncated);
+    EXPECT_THROW(SeatAllocator::decode(broken), std::runtime_error);
+}
+
+// ===================== segment and repositories =====================
+
+TEST_F(SharedMemoryRepositoryTest, SecondMappingSeesTheFirstOnesWrites) {
+    SharedSegment first(name, options);
+    SharedSegment second(name);
+    EXPECT_TRUE(first.isCreator());
+    EXPECT_FALSE(second.isCreator());
+    EXPECT_EQ(second.capacity(SharedTable::Trains), 64); // the creator's sizes
+
+    SharedTrainRepository writer(&first);
+    SharedTrainRepository reader(&second);
+    Train train(0, "Nile", 20);
+    writer.save(train);
+    EXPECT_EQ(train.getTrainId(), 1);
+
+    auto seen = reader.getTrainById(1);
+    ASSERT_TRUE(seen.has_value());
+    EXPECT_EQ(seen->getTrainName(), "Nile");
+    EXPECT_EQ(seen->getVersion(), 1);
+
+    // both read version 1 , only the first compareAndSave lands
+    Train a = *reader.getTrainById(1), b = *writer.getTrainById(1);
+    a.getSeatAllocator()->allocateSeat(1);
+    b.getSeatAllocator()->allocateSeat(2);
+    EXPECT_TRUE(reader.compareAndSave(a));
+    EXPECT_FALSE(writer.compareAndSave(b));
+    EXPECT_EQ(writer.getTrainById(1)->getSeatAllocator()->getSeatOwner(1), 1);
+
+    Train other(0, "Delta", 5);
+    reader.save(other);
+    EXPECT_EQ(other.getTrainId(), 2);
+    EXPECT_EQ(writer.getAllTrains().size(), 2u);
+    EXPECT_EQ(writer.getTrainsPage(1, 10).size(), 1u);
+    EXPECT_TRUE(writer.deleteTrain(1));
+    EXPECT_FALSE(reader.getTrainById(1).has_value());
+}
+
+TEST_F(SharedMemoryRepositoryTest, TicketIndexFollowsSavesAndDeletes) {
+    SharedSegment segment(name, options);
+    SharedTicketRepository repo(&segment);
+    Passenger omar(1, "Omar"), sara(2, "Sara");
+
+    Ticket undated(0, 1, 10, omar), dated(0, 2, 10, omar, 20260105), other(0, 3, 11, sara);
+    repo.save(dated);
+    repo.save(undated);
+    repo.save(other);
+    EXPECT_EQ(repo.getTicketByTrainAndPassenger(10, 1)->getId(), 1); // lowest id first
+    EXPECT_EQ(repo.getTicketByTrainAndPassenger(10, 1, 0)->getId(), 2);
+    EXPECT_EQ(repo.getTicketByTrainAndPassenger(10, 1, 20260105)->getSeat(), 2);
+    EXPECT_FALSE(repo.getTicketByTrainAndPassenger(10, 2).has_value());
+    EXPECT_EQ(repo.getTicketsByPassenger(1).size(), 2u);
+
+    // the ticket passes to another passenger , the index moves with it
+    Ticket moved = *repo.getTicketById(2);
+    moved.setPassenger(sara);
+    EXPECT_TRUE(repo.compareAndSave(moved));
+    EXPECT_FALSE(repo.getTicketByTrainAndPassenger(10, 1, 0).has_value());
+    EXPECT_EQ(repo.getTicketByTrainAndPassenger(10, 2)->getId(), 2);
+    Ticket stale = *repo.getTicketById(2);
+    stale.setVersion(1);
+    EXPECT_FALSE(repo.compareAndSave(stale));
+
+    EXPECT_TRUE(repo.deleteTicket(1));
+    EXPECT_FALSE(repo.getTicketByTrainAndPassenger(10, 1).has_value());
+    EXPECT_EQ(repo.snapshot().size(), 2u);
+
+    vector<Ticket> batch;
+    batch.push_back(Ticket(0, 4, 12, omar));
+    batch.push_back(Ticket(0, 5, 12, sara));
+    repo.saveAll(batch);
+    EXPECT_EQ(batch[1].getId(), 5);
+    EXPECT_EQ(repo.getTicketsPage(3, 10).size(), 2u);
+
+    repo.clear();
+    EXPECT_TRUE(repo.getAllTickets().empty());
+    Ticket again(0, 1, 10, omar);
+    repo.save(again);
+    EXPECT_EQ(again.getId(), 1);
+}
+
+TEST_F(SharedMemoryRepositoryTest, PassengerIdsComeFromTheSegment) {
+    SharedSegment first(name, options), second(name);
+    SharedPassengerRepository a(&first), b(&second);
+    Passenger omar(0, "Omar"), sara(0, "Sara");
+    a.save(omar);
+    b.save(sara);
+    EXPECT_EQ(omar.getId(), 1);
+    EXPECT_EQ(sara.getId(), 2);
+    EXPECT_EQ(a.getAllPassengers().size(), 2u);
+    EXPECT_EQ(a.getPassenger(2)->getName(), "Sara");
+    EXPECT_TRUE(b.deletePassenger(1));
+    EXPECT_FALSE(a.getPassenger(1).has_value());
+}
+
+TEST_F(SharedMemoryRepositoryTest, CapacityLimitsThrow) {
+    options.maxTrains = 2;
+    options.heapBytes = 4096;
+    SharedSegment segment(name, options);
+    SharedTrainRepository repo(&segment);
+    Train small(0, "A", 5);
+    repo.save(small);
+    Train big(0, "B", 100000);
+    EXPECT_THROW(repo.save(big), std::length_error); // record larger than the heap
+    Train far(9, "C", 5);
+    EXPECT_THROW(repo.save(far), std::length_error); // id outside the table
+    EXPECT_TRUE(repo.getTrainById(1).has_value());
+    EXPECT_THROW(SharedSegment("", options), std::runtime_error);
+}
+
+// ===================== several processes =====================
+
+// each child maps the segment on its own and books through the real services
+static int bookInChild(const std::string &name, int child, int children, int passengers) {
+    try {
+        SharedSegment segment(name);
+        SharedTrainRepository trains(&segment);
+        SharedTicketRepository tickets(&segment);
+        SharedPassengerRepository people(&segment);
+        TrainService trainService(&trains);
+        PassengerService passengerService(&people);
+        TicketService ticketService(&tickets, &trainService, &passengerService);
+        for (int p = 1 + child; p <= passengers; p += children)
+            ticketService.bookTicket(1, p);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+TEST_F(SharedMemoryRepositoryTest, ForkedProcessesNeverSellASeatTwice) {
+    const int seats = 60, passengers = 240, children = 4;
+    SharedSegment segment(name, options);
+    SharedTrainRepository trains(&segment);
+    SharedTicketRepository tickets(&segment);
+    SharedPassengerRepository people(&segment);
+    Train train(0, "Contended", seats);
+    trains.save(train);
+    for (int p = 0; p < passengers; p++) {
+        Passenger passenger(0, "P" + std::to_string(p));
+        people.save(passenger);
+    }
+
+    std::vector<pid_t> pids;
+    for (int c = 0; c < children; c++) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0)
+            _exit(bookInChild(name, c, children, passengers));
+        pids.push_back(pid);
+    }
+    for (pid_t pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    Train result = *trains.getTrainById(1);
+    SeatAllocator *allocator = result.getSeatAllocator();
+    EXPECT_EQ(allocator->getAllocatedSeatCount(), seats);
+    EXPECT_EQ(allocator->getWaitingListSize(), passengers - seats);
+
+    std::set<int> soldSeats, ticketPassengers;
+    auto all = tickets.getAllTickets();
+    EXPECT_EQ((int)all.size(), seats);
+    for (const auto &ticket : all) {
+        EXPECT_TRUE(soldSeats.insert(ticket.getSeat()).second) << "seat " << ticket.getSeat() << " sold twice";
+        EXPECT_TRUE(ticketPassengers.insert(ticket.getPassenger().getId()).second);
+        EXPECT_EQ(allocator->getSeatOwner(ticket.getSeat()), ticket.getPassenger().getId());
+    }
+}
+
+TEST_F(SharedMemoryRepositoryTest, LockHeldByADeadProcessIsRecovered) {
+    SharedSegment segment(name, options);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        SharedSegment mine(name);
+        auto guard = mine.lock();
+        _exit(0); // dies holding the lock
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    SharedTrainRepository repo(&segment);
+    Train train(0, "After", 5);
+    repo.save(train);
+    EXPECT_TRUE(repo.getTrainById(1).has_value());
+}
+
+// rewrites , moves and deletes tickets until it is killed , the lock held nearly all the time
+static void churnTickets(const std::string &name) {
+    SharedSegment mine(name);
+    SharedTicketRepository tickets(&mine);
+    for (int i = 0;; i++) {
+        int id = 1 + i % 300;
+        if (i % 7 == 0) {
+            tickets.deleteTicket(id);
+            continue;
+        }
+        // names of different lengths land in different block classes
+        Passenger passenger(1 + i % 40, std::string(1 + i % 90, 'p'));
+        Ticket ticket(id, 1 + i % 50, 1 + i % 3, passenger);
+        tickets.save(ticket);
+    }
+}
+
+TEST_F(SharedMemoryRepositoryTest, HolderKilledMidWriteIsRepaired) {
+    SharedSegment segment(name, options);
+    SharedTicketRepository tickets(&segment);
+    for (int round = 0; round < 12; round++) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            churnTickets(name);
+            _exit(0);
+        }
+        usleep(2000 + round * 700);
+        kill(pid, SIGKILL);
+        int status = 0;
+        waitpid(pid, &status, 0);
+
+        // every record decodes and both indexes agree with the table
+        auto all = tickets.getAllTickets();
+        for (const auto &ticket : all) {
+            int passengerId = ticket.getPassenger().getId();
+            auto first = tickets.getTicketByTrainAndPassenger(ticket.getTrainId(), passengerId);
+            ASSERT_TRUE(first.has_value()) << "round " << round << " ticket " << ticket.getId();
+            EXPECT_EQ(first->getTrainId(), ticket.getTrainId());
+            bool listed = false;
+            for (const auto &mine : tickets.getTicketsByPassenger(passengerId))
+                listed = listed || mine.getId() == ticket.getId();
+            EXPECT_TRUE(listed) << "round " << round << " ticket " << ticket.getId();
+        }
+        size_t byPassenger = 0;
+        for (int p = 1; p <= 40; p++)
+            byPassenger += tickets.getTicketsByPassenger(p).size();
+        EXPECT_EQ(byPassenger, all.size());
+
+        // and the heap still hands out space
+        Ticket after(0, 1, 9, Passenger(41, "After"));
+        tickets.save(after);
+        EXPECT_EQ(tickets.getTicketById(after.getId())->getTrainId(), 9);
+        tickets.deleteTicket(after.getId());
+    }
+    EXPECT_GT(segment.getRecoveries(), 0); // some kills landed while the lock was held
+}
+
+TEST_F(SharedMemoryRepositoryTest, DamageThatCannotBeRepairedPoisonsTheSegment) {
+    SharedSegment segment(name, options);
+    SharedTrainRepository trains(&segment);
+    Train train(0, "Express", 5);
+    trains.save(train);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        SharedSegment mine(name);
+        auto guard = mine.lock();
+        mine.slot(SharedTable::Trains, 1)->blob += 3; // points into the middle of its block
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    EXPECT_THROW(trains.getTrainById(1), std::runtime_error);
+    EXPECT_THROW(trains.getTrainById(1), std::runtime_error); // and stays refused
+}
+
+TEST_F(SharedMemoryRepositoryTest, StartupManagersShareOneInventory) {
+    StartupManager first, second;
+    first.useSharedMemory(name, options);
+    second.useSharedMemory(name, options);
+    RMSFacade *a = first.buildFacade();
+    RMSFacade *b = second.buildFacade(); // joins , does not seed again
+    EXPECT_EQ(b->listTrains().size(), 5u);
+    EXPECT_EQ(b->listTickets().size(), 11u);
+
+    a->addPassenger("Hana");
+    auto ticket = b->bookTicket(3, "Hana");
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(a->getTicket(ticket->getId()).getPassenger().getName(), "Hana");
+    EXPECT_THROW(StartupManager().useSharedMemory(""), std::invalid_argument);
+}
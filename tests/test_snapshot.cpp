@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include "structures/persistentMap.h"
+#include "RMSFacade.h"
+#include "Repo/Snapshot.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/RepositoryShards.h"
+#include "Repo/ShardedTicketRepository.h"
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    InMemoryTicketRepository ticketRepo;
+    InMemoryTrainRepository trainRepo;
+    Passenger passenger{1, "Omar"};
+
+    void TearDown() override {
+        ticketRepo.clear();
+        trainRepo.clear();
+    }
+
+    static std::vector<int> keysOf(const PersistentMap<int, int> &map) {
+        std::vector<int> keys;
+        for (auto it = map.begin(); !it.done(); ++it)
+            keys.push_back(it.key());
+        return keys;
+    }
+};
+
+// ===================== PersistentMap =====================
+
+TEST_F(SnapshotTest, PersistentMapMatchesStdMap) {
+    PersistentMap<int, int> map;
+    std::map<int, int> reference;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 5000; i++) {
+        int key = rng() % 1000;
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+        } else {
+            map.insert(key, i);
+            reference[key] = i;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto it = map.begin();
+    for (const auto &[key, value] : reference) {
+        ASSERT_FALSE(it.done());
+        EXPECT_EQ(it.key(), key);
+        EXPECT_EQ(it.value(), value);
+        ++it;
+    }
+    EXPECT_TRUE(it.done());
+    EXPECT_EQ(map.find(1001), nullptr);
+}
+
+TEST_F(SnapshotTest, CopiesAreFrozenVersions) {
+    PersistentMap<int, int> map;
+    for (int i = 1; i <= 100; i++)
+        map.insert(i, i);
+    PersistentMap<int, int> frozen = map;
+
+    map.insert(50, -1);
+    map.erase(10);
+    map.insert(101, 101);
+
+    EXPECT_EQ(frozen.size(), 100u);
+    EXPECT_EQ(*frozen.find(50), 50);
+    EXPECT_NE(frozen.find(10), nullptr);
+    EXPECT_EQ(frozen.find(101), nullptr);
+    EXPECT_EQ(*map.find(50), -1);
+    EXPECT_EQ(map.size(), 100u);
+}
+
+TEST_F(SnapshotTest, LowerBoundStartsAtTheFirstKeyNotBelow) {
+    PersistentMap<int, int> map;
+    for (int i = 0; i < 50; i++)
+        map.insert(i * 2, i);
+    auto it = map.lowerBound(31);
+    ASSERT_FALSE(it.done());
+    EXPECT_EQ(it.key(), 32);
+    EXPECT_TRUE(map.lowerBound(99).done());
+    EXPECT_EQ(keysOf(map).size(), 50u);
+}
+
+TEST_F(SnapshotTest, SequentialInsertsStayBalanced) {
+    PersistentMap<int, int> map;
+    for (int i = 0; i < 50000; i++) // a degenerate tree would overflow the recursive insert
+        map.insert(i, i);
+    EXPECT_EQ(map.size(), 50000u);
+    for (int i = 0; i < 50000; i += 2)
+        map.erase(i);
+    EXPECT_EQ(map.size(), 25000u);
+    EXPECT_EQ(map.lowerBound(1000).key(), 1001);
+}
+
+// ===================== repository snapshots =====================
+
+TEST_F(SnapshotTest, TicketSnapshotIgnoresLaterWrites) {
+    std::vector<Ticket> saved;
+    for (int i = 0; i < 10; i++) {
+        Ticket t(0, i + 1, 100, passenger);
+        ticketRepo.save(t);
+        saved.push_back(t);
+    }
+    Snapshot<Ticket> snap = ticketRepo.snapshot();
+
+    Ticket extra(0, 11, 100, passenger);
+    ticketRepo.save(extra);
+    ticketRepo.deleteTicket(saved[0].getId());
+    saved[1].setStatus(cancelled);
+    ticketRepo.save(saved[1]);
+
+    EXPECT_EQ(snap.size(), 10u);
+    ASSERT_NE(snap.find(saved[0].getId()), nullptr);
+    EXPECT_EQ(snap.find(saved[1].getId())->getStatus(), booked);
+    EXPECT_EQ(snap.find(extra.getId()), nullptr);
+    EXPECT_EQ(ticketRepo.snapshot().size(), 10u);
+    EXPECT_EQ(ticketRepo.getTicketById(saved[1].getId())->getStatus(), cancelled);
+}
+
+TEST_F(SnapshotTest, TrainSnapshotKeepsTheOldVersion) {
+    Train train(0, "Express", 4);
+    trainRepo.save(train);
+    Snapshot<Train> snap = trainRepo.snapshot();
+    train.addSeats(6);
+    trainRepo.save(train);
+    trainRepo.deleteTrain(train.getTrainId());
+
+    ASSERT_NE(snap.find(train.getTrainId()), nullptr);
+    EXPECT_EQ(snap.find(train.getTrainId())->getTotalSeats(), 4);
+    EXPECT_EQ(trainRepo.snapshot().size(), 0u);
+}
+
+TEST_F(SnapshotTest, PagesAndListingsComeFromSnapshots) {
+    for (int i = 0; i < 25; i++) {
+        Ticket t(0, i + 1, 100, passenger);
+        ticketRepo.save(t);
+    }
+    auto page = ticketRepo.getTicketsPage(20, 10);
+    ASSERT_EQ(page.size(), 5u);
+    EXPECT_EQ(page[0].getId(), 21);
+    EXPECT_EQ(ticketRepo.getAllTickets().size(), 25u);
+    EXPECT_EQ(ticketRepo.snapshot().page(0, 0).size(), 0u);
+}
+
+TEST_F(SnapshotTest, ShardedSnapshotMergesInIdOrder) {
+    RepositoryShards shards(4);
+    ShardedTicketRepository sharded(&shards);
+    for (int i = 0; i < 40; i++) {
+        Ticket t(0, 1, 1 + i % 7, passenger);
+        sharded.save(t);
+    }
+    Snapshot<Ticket> snap = sharded.snapshot();
+    EXPECT_EQ(snap.size(), 40u);
+    int previous = 0, seen = 0;
+    snap.forEach([&](const Ticket &t) {
+        EXPECT_GT(t.getId(), previous);
+        previous = t.getId();
+        seen++;
+    });
+    EXPECT_EQ(seen, 40);
+    sharded.clear();
+}
+
+TEST_F(SnapshotTest, ReportCountsOneFrozenView) {
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+    RMSFacade facade(&trainService, &ticketService, &passengerService);
+
+    Train a = facade.addTrain("Alex", 3);
+    Train b = facade.addTrain("Cairo", 3);
+    auto first = facade.bookTicket(a.getTrainId(), "omar");
+    facade.bookTicket(a.getTrainId(), "sara");
+    facade.bookTicket(b.getTrainId(), "ali");
+    facade.cancelTicket(first->getId());
+
+    TicketReport report = facade.ticketReport();
+    EXPECT_EQ(report.total, 3);
+    EXPECT_EQ(report.booked, 2);
+    EXPECT_EQ(report.cancelled, 1);
+    EXPECT_EQ(report.trains, 2);
+    passengerRepo.clear();
+}
+
+// ===================== readers beside writers =====================
+
+TEST_F(SnapshotTest, ScansNeverSeeTornState) {
+    const int writes = 3000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < writes; i++) {
+            Ticket t(0, i + 1, 100 + i % 5, passenger);
+            ticketRepo.save(t);
+            if (i % 3 == 0) {
+                t.setStatus(cancelled);
+                ticketRepo.save(t);
+            }
+        }
+        done = true;
+    });
+
+    size_t lastSize = 0;
+    int scans = 0;
+    while (!done || scans == 0) {
+        Snapshot<Ticket> snap = ticketRepo.snapshot();
+        size_t walked = 0;
+        int previous = 0;
+        snap.forEach([&](const Ticket &t) {
+            EXPECT_GT(t.getId(), previous);
+            EXPECT_EQ(t.getSeat(), t.getId()); // every record whole
+            previous = t.getId();
+            walked++;
+        });
+        EXPECT_EQ(walked, snap.size());
+        EXPECT_GE(walked, lastSize); // only inserts , a later snapshot never has fewer
+        EXPECT_EQ((int)walked, previous); // ids 1..n , no gap inside a snapshot
+        lastSize = walked;
+        scans++;
+    }
+    writer.join();
+    EXPECT_EQ(ticketRepo.snapshot().size(), (size_t)writes);
+}
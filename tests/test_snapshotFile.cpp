@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "Repo/SnapshotFile.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "StartupManager.h"
+
+class SnapshotFileTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        static int counter = 0;
+        path = "/tmp/rms_snapshot_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".snap";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(SnapshotFileTest, RestoresTrainsPassengersAndTickets) {
+    int trainId, cancelledId;
+    vector<Ticket> before;
+    {
+        StartupManager manager;
+        RMSFacade *facade = manager.buildFacade();
+        trainId = facade->addTrain("Snapshot Express", 1).getTrainId();
+        facade->bookTicket(trainId, "Omar");
+        facade->bookTicket(trainId, "Sara"); // waitlisted
+        cancelledId = facade->bookTicket(1, "Karim")->getId();
+        facade->cancelTicket(cancelledId);
+        before = facade->listTickets();
+        SnapshotFileStats stats = manager.saveSnapshot(path).get();
+        EXPECT_EQ(stats.trains, 6);
+        EXPECT_EQ(stats.tickets, (long long)before.size());
+        EXPECT_GT(stats.bytes, 0);
+    }
+
+    StartupManager manager;
+    manager.useSnapshot(path);
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 6u); // no mock data on top
+    EXPECT_EQ(facade->listPassengers().size(), 10u);
+    auto after = facade->listTickets();
+    ASSERT_EQ(after.size(), before.size());
+    for (size_t i = 0; i < after.size(); i++) {
+        EXPECT_EQ(after[i].getId(), before[i].getId());
+        EXPECT_EQ(after[i].getSeat(), before[i].getSeat());
+        EXPECT_EQ(after[i].getTrainId(), before[i].getTrainId());
+        EXPECT_EQ(after[i].getStatus(), before[i].getStatus());
+        EXPECT_EQ(after[i].getPassenger().getName(), before[i].getPassenger().getName());
+    }
+    EXPECT_EQ(facade->getTicket(cancelledId).getStatus(), cancelled);
+
+    Train train = facade->getTrain(trainId);
+    EXPECT_EQ(train.getTrainName(), "Snapshot Express");
+    EXPECT_EQ(train.getSeatAllocator()->getAllocatedSeatCount(), 1);
+    EXPECT_EQ(train.getSeatAllocator()->getWaitingListSize(), 1);
+    EXPECT_GT(facade->addTrain("Next", 5).getTrainId(), trainId); // ids carry on
+}
+
+TEST_F(SnapshotFileTest, RecordsAreReadInPlace) {
+    InMemoryTrainRepository trains;
+    InMemoryPassengerRepository passengers;
+    InMemoryTicketRepository tickets;
+    Train train(0, "Mapped", 4);
+    trains.save(train);
+    Passenger nour(0, "Nour");
+    passengers.save(nour);
+    Ticket ticket(0, 3, train.getTrainId(), nour);
+    tickets.save(ticket);
+    Ticket orphan(0, 4, train.getTrainId(), Passenger(77, "Gone Away")); // passenger no longer stored
+    tickets.save(orphan);
+    writeSnapshotFile(path, trains.snapshot(), passengers.getAllPassengers(), tickets.snapshot());
+
+    MappedSnapshot mapped(path);
+    EXPECT_EQ(mapped.getFormatVersion(), SNAPSHOT_FORMAT_VERSION);
+    ASSERT_EQ(mapped.ticketCount(), 2u);
+    const SnapshotTicketRecord &record = mapped.ticketRecord(0);
+    EXPECT_EQ(record.id, ticket.getId());
+    EXPECT_EQ(record.seat, 3);
+    EXPECT_EQ(record.passengerId, nour.getId());
+    EXPECT_EQ(mapped.string(record.nameOffset, record.nameLength), "Nour");
+    EXPECT_EQ(mapped.passengerRecord(0).nameOffset, record.nameOffset); // one copy of the name
+    EXPECT_EQ(mapped.ticket(1).getPassenger().getName(), "Gone Away");
+    EXPECT_EQ(mapped.train(0).getTrainName(), "Mapped");
+    EXPECT_THROW(mapped.ticketRecord(2), std::out_of_range);
+    EXPECT_THROW(mapped.string(0, 1 << 20), std::runtime_error);
+}
+
+TEST_F(SnapshotFileTest, LaterWritesAreNotInTheFile) {
+    StartupManager manager;
+    RMSFacade *facade = manager.buildFacade();
+    size_t tickets = facade->listTickets().size();
+    auto pending = manager.saveSnapshot(path);
+    facade->bookTicket(2, "Ali"); // while the file is written
+    pending.get();
+    EXPECT_EQ(MappedSnapshot(path).ticketCount(), tickets);
+}
+
+TEST_F(SnapshotFileTest, RejectsDamagedFiles) {
+    EXPECT_THROW(MappedSnapshot("/tmp/rms_no_such_snapshot"), std::runtime_error);
+    {
+        std::ofstream out(path);
+        out << std::string(512, 'x');
+    }
+    EXPECT_THROW(MappedSnapshot m(path), std::runtime_error);
+
+    {
+        StartupManager manager;
+        manager.buildFacade();
+        manager.saveSnapshot(path).get();
+    }
+    long long size;
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(8);
+        uint32_t version = SNAPSHOT_FORMAT_VERSION + 1;
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        file.seekg(0, std::ios::end);
+        size = (long long)file.tellg();
+    }
+    EXPECT_THROW(MappedSnapshot m(path), std::runtime_error);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(8);
+        uint32_t version = SNAPSHOT_FORMAT_VERSION;
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+    EXPECT_NO_THROW(MappedSnapshot m(path));
+    ASSERT_EQ(truncate(path.c_str(), size - 16), 0);
+    EXPECT_THROW(MappedSnapshot m(path), std::runtime_error);
+}
+
+TEST_F(SnapshotFileTest, MissingFileFallsBackToMockData) {
+    StartupManager manager;
+    manager.useSnapshot(path);
+    EXPECT_THROW(manager.useWriteAheadLog("/tmp/unused.log"), std::logic_error);
+    EXPECT_THROW(manager.saveSnapshot(path), std::logic_error);
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 5u);
+    EXPECT_THROW(manager.useSnapshot(path), std::logic_error);
+}
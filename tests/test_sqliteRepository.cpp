@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "Repo/SqliteDatabase.h"
+#include "Repo/SqliteTrainRepository.h"
+#include "Repo/SqliteTicketRepository.h"
+#include "Repo/SqlitePassengerRepository.h"
+#include "Services/TicketService.h"
+#include "StartupManager.h"
+
+class SqliteRepositoryTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        static int counter = 0;
+        path = "/tmp/rms_sqlite_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".db";
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const char *suffix : {"", "-wal", "-shm"})
+            std::remove((path + suffix).c_str());
+    }
+};
+
+TEST_F(SqliteRepositoryTest, TrainsKeepTheirInventoryAndVersion) {
+    SqliteDatabase database(path);
+    SqliteTrainRepository trains(&database);
+    Train a(0, "Nile Express", 10), b(0, "Delta Local", 4);
+    trains.save(a);
+    trains.save(b);
+    EXPECT_EQ(a.getTrainId(), 1);
+    EXPECT_EQ(b.getTrainId(), 2);
+    EXPECT_EQ(a.getVersion(), 1);
+
+    a.getSeatAllocator()->allocateSeat(7);
+    a.getSeatAllocator(20261020)->allocateSeat(8);
+    trains.save(a);
+    EXPECT_EQ(a.getVersion(), 2);
+
+    auto stored = trains.getTrainById(a.getTrainId());
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_EQ(stored->getTrainName(), "Nile Express");
+    EXPECT_EQ(stored->getVersion(), 2);
+    EXPECT_EQ(stored->getSeatAllocator()->getAllocatedSeatCount(), 1);
+    ASSERT_NE(stored->findSeatAllocator(20261020), nullptr);
+    EXPECT_EQ(stored->findSeatAllocator(20261020)->getAllocatedSeatCount(), 1);
+
+    EXPECT_EQ(trains.getAllTrains().size(), 2u);
+    auto page = trains.getTrainsPage(1, 10);
+    ASSERT_EQ(page.size(), 1u);
+    EXPECT_EQ(page[0].getTrainId(), 2);
+    EXPECT_EQ(trains.snapshot().size(), 2u);
+
+    EXPECT_TRUE(trains.deleteTrain(b.getTrainId()));
+    EXPECT_FALSE(trains.deleteTrain(b.getTrainId()));
+    EXPECT_FALSE(trains.getTrainById(b.getTrainId()).has_value());
+    Train c(0, "Canal Night", 6);
+    trains.save(c);
+    EXPECT_EQ(c.getTrainId(), 3); // the id of the deleted highest train is not handed out again
+}
+
+TEST_F(SqliteRepositoryTest, CompareAndSaveRejectsStaleCopies) {
+    SqliteDatabase database(path);
+    SqliteTrainRepository trains(&database);
+    Train train(0, "Nile Express", 10);
+    ASSERT_TRUE(trains.compareAndSave(train));
+    EXPECT_EQ(train.getVersion(), 1);
+
+    Train stale = *trains.getTrainById(train.getTrainId());
+    train.setTrainName("Nile Express II");
+    ASSERT_TRUE(trains.compareAndSave(train));
+    stale.setTrainName("Lost Update");
+    EXPECT_FALSE(trains.compareAndSave(stale));
+    EXPECT_EQ(stale.getVersion(), 1); // left as it was
+    EXPECT_EQ(trains.getTrainById(train.getTrainId())->getTrainName(), "Nile Express II");
+
+    // a copy that was never saved cannot take an id that exists
+    Train twin(train.getTrainId(), "Twin", 10);
+    EXPECT_FALSE(trains.compareAndSave(twin));
+}
+
+TEST_F(SqliteRepositoryTest, PassengersAreFoundByNameIgnoringCase) {
+    SqliteDatabase database(path);
+    SqlitePassengerRepository passengers(&database);
+    Passenger omar(0, "Omar"), sara(0, "Sara Ali"), second(0, "omar");
+    passengers.save(omar);
+    passengers.save(sara);
+    passengers.save(second);
+
+    auto found = passengers.findPassengerByName("SARA ALI");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->getId(), sara.getId());
+    EXPECT_EQ(passengers.findPassengerByName("OMAR")->getId(), omar.getId()); // the lowest id
+    EXPECT_FALSE(passengers.findPassengerByName("Karim").has_value());
+
+    sara.setName("Sara Omar");
+    ASSERT_TRUE(passengers.compareAndSave(sara));
+    EXPECT_EQ(passengers.getPassenger(sara.getId())->getVersion(), 2);
+    EXPECT_FALSE(passengers.findPassengerByName("Sara Ali").has_value());
+    EXPECT_TRUE(passengers.deletePassenger(omar.getId()));
+    EXPECT_EQ(passengers.findPassengerByName("omar")->getId(), second.getId());
+    EXPECT_EQ(passengers.getAllPassengers().size(), 2u);
+
+    EXPECT_TRUE(passengers.deletePassenger(second.getId()));
+    Passenger karim(0, "Karim");
+    passengers.save(karim);
+    EXPECT_EQ(karim.getId(), 4); // nor the id of the deleted highest passenger
+}
+
+TEST_F(SqliteRepositoryTest, TicketLookupsAndBatches) {
+    SqliteDatabase database(path);
+    SqliteTicketRepository tickets(&database);
+    Passenger omar(1, "Omar"), sara(2, "Sara");
+
+    vector<Ticket> batch;
+    batch.push_back(Ticket(0, 1, 1, omar));
+    batch.push_back(Ticket(0, 2, 1, sara));
+    batch.push_back(Ticket(0, 1, 2, omar, 20261020));
+    tickets.saveAll(batch);
+    EXPECT_EQ(batch[0].getId(), 1);
+    EXPECT_EQ(batch[2].getId(), 3);
+    EXPECT_EQ(batch[2].getVersion(), 1);
+
+    EXPECT_EQ(tickets.getTicketByTrainAndPassenger(1, 2)->getId(), 2);
+    EXPECT_EQ(tickets.getTicketByTrainAndPassenger(2, 1, 20261020)->getSeat(), 1);
+    EXPECT_FALSE(tickets.getTicketByTrainAndPassenger(2, 1, 20261021).has_value());
+    EXPECT_FALSE(tickets.getTicketByTrainAndPassenger(2, 2).has_value());
+    auto omars = tickets.getTicketsByPassenger(1);
+    ASSERT_EQ(omars.size(), 2u);
+    EXPECT_EQ(omars[0].getId(), 1);
+    EXPECT_EQ(omars[1].getTravelDate(), 20261020);
+
+    Ticket ticket = *tickets.getTicketById(2);
+    EXPECT_EQ(ticket.getPassenger().getName(), "Sara");
+    ticket.setStatus(cancelled);
+    ASSERT_TRUE(tickets.compareAndSave(ticket));
+    Ticket stale = *tickets.getTicketById(2);
+    tickets.save(ticket);
+    EXPECT_FALSE(tickets.compareAndSave(stale));
+    EXPECT_EQ(tickets.getTicketById(2)->getStatus(), cancelled);
+    EXPECT_EQ(tickets.getTicketById(2)->getVersion(), 3);
+
+    EXPECT_EQ(tickets.getTicketsPage(1, 1)[0].getId(), 2);
+    Snapshot<Ticket> snapshot = tickets.snapshot();
+    EXPECT_EQ(snapshot.size(), 3u);
+    ASSERT_NE(snapshot.find(3), nullptr);
+    EXPECT_EQ(snapshot.find(3)->getTravelDate(), 20261020);
+    EXPECT_TRUE(tickets.deleteTicket(1));
+    EXPECT_EQ(tickets.getAllTickets().size(), 2u);
+
+    EXPECT_TRUE(tickets.deleteTicket(3));
+    Ticket next(0, 3, 2, omar);
+    tickets.save(next);
+    EXPECT_EQ(next.getId(), 4); // the id of the deleted highest ticket is not handed out again
+}
+
+TEST_F(SqliteRepositoryTest, ServicesBookAndCancelThroughTheDatabase) {
+    SqliteDatabase database(path);
+    SqliteTrainRepository trainRepo(&database);
+    SqliteTicketRepository ticketRepo(&database);
+    SqlitePassengerRepository passengerRepo(&database);
+    TrainService trainService(&trainRepo);
+    PassengerService passengerService(&passengerRepo);
+    TicketService ticketService(&ticketRepo, &trainService, &passengerService);
+
+    int trainId = trainService.createTrain("Nile Express", 1).getTrainId();
+    int omar = passengerService.find_or_create_passenger("Omar").getId();
+    int sara = passengerService.find_or_create_passenger("Sara").getId();
+    EXPECT_EQ(passengerService.find_or_create_passenger("OMAR").getId(), omar);
+
+    int ticketId = ticketService.bookTicket(trainId, omar)->getId();
+    EXPECT_FALSE(ticketService.bookTicket(trainId, sara).has_value()); // waitlisted
+    ticketService.cancelTicket(ticketId);                              // seat goes to Sara
+    auto promoted = ticketRepo.getTicketByTrainAndPassenger(trainId, sara);
+    ASSERT_TRUE(promoted.has_value());
+    EXPECT_EQ(promoted->getStatus(), booked);
+    EXPECT_EQ(trainService.getTrain(trainId).getSeatAllocator()->getWaitingListSize(), 0);
+}
+
+TEST_F(SqliteRepositoryTest, StartupManagerReopensTheDatabase) {
+    int trainId, ticketId;
+    size_t tickets;
+    {
+        StartupManager manager;
+        manager.useSqlite(path);
+        RMSFacade *facade = manager.buildFacade(); // mock data goes into the empty database
+        trainId = facade->addTrain("Sqlite Express", 5).getTrainId();
+        ticketId = facade->bookTicket(trainId, "Omar")->getId();
+        facade->bookTicket(trainId, "Sara");
+        facade->cancelTicket(ticketId);
+        tickets = facade->listTickets().size();
+    }
+    StartupManager manager;
+    manager.useSqlite(path);
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 6u); // the mock data is not loaded twice
+    EXPECT_EQ(facade->listTickets().size(), tickets);
+    EXPECT_EQ(facade->getTicket(ticketId).getStatus(), cancelled);
+    EXPECT_EQ(facade->getTrain(trainId).getSeatAllocator()->getAllocatedSeatCount(), 1);
+    EXPECT_GT(facade->addTrain("Next", 5).getTrainId(), trainId);
+
+    StartupManager other;
+    EXPECT_THROW(other.useSqlite(""), std::invalid_argument);
+    other.useSqlite(path);
+    EXPECT_THROW(other.useWriteAheadLog(path + ".wal"), std::logic_error);
+    EXPECT_THROW(other.useSnapshot(path + ".snap"), std::logic_error);
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
 #include "StartupManager.h"
 #include "RMSFacade.h"
 
@@ -389,4 +391,30 @@ TEST_F(StartupManagerTest, MockPassengersHaveTickets) {
     }
 
     EXPECT_FALSE(passengerIdsWithTickets.empty());
-}
\ No newline at end of file
+}
+TEST_F(StartupManagerTest, HoldExpiryRunsInTheBackground) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useHoldExpiry(0), std::invalid_argument);
+    manager.useHoldExpiry();
+    RMSFacade* facade = manager.buildFacade();
+    EXPECT_THROW(manager.useHoldExpiry(), std::logic_error);
+
+    int trainId = facade->addTrain("Hold Express", 2).getTrainId();
+    facade->holdSeat(trainId, "Omar", 1);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (facade->getTrain(trainId).getSeatAllocator()->getHeldSeatCount() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(facade->getTrain(trainId).getSeatAllocator()->getHeldSeatCount(), 0);
+}
+
+TEST_F(StartupManagerTest, DefragmentationIsOptIn) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useDefragmentation(0), std::invalid_argument);
+    EXPECT_THROW(manager.useDefragmentation(10, 0), std::invalid_argument);
+    manager.useDefragmentation(1, 16);
+    RMSFacade* facade = manager.buildFacade();
+    EXPECT_THROW(manager.useDefragmentation(10), std::logic_error);
+    facade->addTrain("Defrag Express", 4); // the slices run while the facade is used
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(facade->listTrains().empty());
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Repo/TicketArchive.h"
+#include "Repo/TieredTicketRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "structures/bloomFilter.h"
+#include "utils/BinaryCodec.h"
+#include "StartupManager.h"
+
+class TicketArchiveTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        static int counter = 0;
+        path = "/tmp/rms_archive_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".arc";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    static Ticket ticket(int id, int trainId, int passengerId, int travelDate = 0, Status status = booked) {
+        Ticket t(id, id % 50 + 1, trainId, Passenger(passengerId, "Passenger " + std::to_string(passengerId)), travelDate);
+        t.setStatus(status);
+        t.setVersion(id % 7 + 1);
+        return t;
+    }
+
+    static long long fileSize(const std::string &file) {
+        struct stat info{};
+        return ::stat(file.c_str(), &info) == 0 ? (long long)info.st_size : -1;
+    }
+};
+
+TEST_F(TicketArchiveTest, VarintsRoundTrip) {
+    ByteWriter out;
+    const long long values[] = {0, 1, -1, 127, 128, -64, -65, 20261019, INT32_MIN, INT64_MAX, INT64_MIN};
+    for (long long v : values)
+        out.putSignedVarint(v);
+    out.putVarint(UINT64_MAX);
+    out.putVarint(300);
+    EXPECT_LT(out.size(), sizeof(values) + 16);
+
+    ByteReader in(out.data());
+    for (long long v : values)
+        EXPECT_EQ(in.getSignedVarint(), v);
+    EXPECT_EQ(in.getVarint(), UINT64_MAX);
+    EXPECT_EQ(in.getVarint(), 300u);
+    EXPECT_TRUE(in.done());
+    EXPECT_THROW(in.getVarint(), std::runtime_error);
+}
+
+TEST_F(TicketArchiveTest, BloomFilterHasNoFalseNegatives) {
+    BloomFilter bloom(10000);
+    for (int id = 1; id <= 10000; id++)
+        bloom.add((uint64_t)id * 3);
+    int falsePositives = 0;
+    for (int id = 1; id <= 10000; id++) {
+        EXPECT_TRUE(bloom.mightContain((uint64_t)id * 3));
+        falsePositives += bloom.mightContain((uint64_t)id * 3 + 1);
+    }
+    EXPECT_LT(falsePositives, 300); // about 1 % at 10 bits per key
+    EXPECT_EQ(bloom.count(), 10000u);
+}
+
+TEST_F(TicketArchiveTest, FindsEveryArchivedTicket) {
+    TicketArchive archive(path);
+    vector<Ticket> batch;
+    for (int id = 500; id >= 1; id--) // out of order , the segment sorts them
+        batch.push_back(ticket(id * 2, id % 13 + 1, id % 40 + 1, id % 3 ? 20250101 + id % 28 : 0, id % 2 ? cancelled : booked));
+    EXPECT_GT(archive.append(batch), 0u);
+    EXPECT_EQ(archive.append(vector<Ticket>()), 0u);
+    EXPECT_EQ(archive.size(), 500u);
+    EXPECT_EQ(archive.maxId(), 1000);
+
+    for (int id = 1; id <= 500; id++) {
+        auto found = archive.find(id * 2);
+        ASSERT_TRUE(found.has_value()) << id;
+        Ticket expected = ticket(id * 2, id % 13 + 1, id % 40 + 1, id % 3 ? 20250101 + id % 28 : 0, id % 2 ? cancelled : booked);
+        EXPECT_EQ(found->getTrainId(), expected.getTrainId());
+        EXPECT_EQ(found->getPassenger().getId(), expected.getPassenger().getId());
+        EXPECT_EQ(found->getPassenger().getName(), expected.getPassenger().getName());
+        EXPECT_EQ(found->getSeat(), expected.getSeat());
+        EXPECT_EQ(found->getTravelDate(), expected.getTravelDate());
+        EXPECT_EQ(found->getStatus(), expected.getStatus());
+        EXPECT_EQ(found->getVersion(), expected.getVersion());
+    }
+    for (int id = 1; id <= 1000; id += 2)
+        EXPECT_FALSE(archive.find(id).has_value());
+    EXPECT_FALSE(archive.find(5000).has_value());
+
+    ArchiveStats stats = archive.getStats();
+    EXPECT_EQ(stats.tickets, 500);
+    EXPECT_EQ(stats.segments, 1);
+    EXPECT_LT(stats.bytes * 2, stats.rawBytes); // deltas and varints , names once
+    EXPECT_EQ(stats.lookups, 1001);
+    EXPECT_GT(stats.bloomRejects, 450);
+
+    size_t visited = 0;
+    archive.forEach([&](const Ticket &t) {
+        visited++;
+        EXPECT_EQ(t.getId() % 2, 0);
+    });
+    EXPECT_EQ(visited, 500u);
+}
+
+TEST_F(TicketArchiveTest, ReopeningCutsATornTail) {
+    {
+        TicketArchive archive(path);
+        vector<Ticket> first, second;
+        first.push_back(ticket(1, 1, 1));
+        second.push_back(ticket(2, 1, 2, 0, cancelled));
+        second.push_back(ticket(1, 1, 1, 0, cancelled)); // a newer copy of 1
+        archive.append(first);
+        archive.append(second);
+    }
+    long long intact = fileSize(path);
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "torn segment", 12), 12);
+    ::close(fd);
+
+    TicketArchive archive(path);
+    EXPECT_EQ(fileSize(path), intact);
+    EXPECT_EQ(archive.size(), 3u);
+    EXPECT_EQ(archive.getStats().segments, 2);
+    EXPECT_EQ(archive.find(1)->getStatus(), cancelled); // the newest segment wins
+    EXPECT_EQ(archive.find(2)->getPassenger().getName(), "Passenger 2");
+
+    vector<Ticket> third;
+    third.push_back(ticket(3, 2, 3));
+    archive.append(third);
+    EXPECT_EQ(archive.find(3)->getTrainId(), 2);
+    archive.clear();
+    EXPECT_EQ(archive.size(), 0u);
+    EXPECT_FALSE(archive.find(1).has_value());
+
+    std::string other = path + ".not";
+    FILE *file = std::fopen(other.c_str(), "w");
+    std::fputs("not an archive", file);
+    std::fclose(file);
+    EXPECT_THROW(TicketArchive{other}, std::runtime_error);
+    std::remove(other.c_str());
+}
+
+TEST_F(TicketArchiveTest, TieredRepositoryMovesColdTickets) {
+    TicketArchive archive(path);
+    auto inner = std::make_unique<InMemoryTicketRepository>();
+    InMemoryTicketRepository *live = inner.get();
+    TieredTicketRepository tickets(std::move(inner), &archive);
+    Passenger omar(1, "Omar"), sara(2, "Sara");
+
+    Ticket upcoming(0, 1, 1, omar, 20990101), departed(0, 2, 1, sara, 20200101), dropped(0, 3, 2, omar), undated(0, 4, 2, sara);
+    tickets.save(upcoming);
+    tickets.save(departed);
+    tickets.save(dropped);
+    tickets.save(undated);
+    dropped.setStatus(cancelled);
+    tickets.save(dropped);
+
+    EXPECT_EQ(tickets.archiveTickets(20261019), 2u);
+    EXPECT_EQ(archive.size(), 2u);
+    EXPECT_EQ(tickets.getAllTickets().size(), 2u);
+    EXPECT_FALSE(live->getTicketById(dropped.getId()).has_value());
+    auto archived = tickets.getTicketByTrainAndPassenger(2, omar.getId()); // found in the archive
+    ASSERT_TRUE(archived.has_value());
+    EXPECT_EQ(archived->getStatus(), cancelled);
+    EXPECT_EQ(tickets.getTicketByTrainAndPassenger(1, sara.getId(), 20200101)->getId(), departed.getId());
+    EXPECT_FALSE(tickets.getTicketByTrainAndPassenger(1, sara.getId(), 20200102).has_value());
+    auto omars = tickets.getTicketsByPassenger(omar.getId()); // both tiers , id order
+    ASSERT_EQ(omars.size(), 2u);
+    EXPECT_EQ(omars[0].getId(), upcoming.getId());
+    EXPECT_EQ(omars[1].getId(), dropped.getId());
+
+    auto cold = tickets.getTicketById(dropped.getId());
+    ASSERT_TRUE(cold.has_value());
+    EXPECT_EQ(cold->getStatus(), cancelled);
+    EXPECT_EQ(cold->getVersion(), 2);
+    EXPECT_EQ(tickets.getTicketById(departed.getId())->getTravelDate(), 20200101);
+    EXPECT_FALSE(tickets.getTicketById(99).has_value());
+    EXPECT_EQ(tickets.archiveTickets(20261019), 0u);
+    EXPECT_FALSE(tickets.deleteTicket(departed.getId())); // history
+
+    // a live tier rebuilt without them never hands their ids out again
+    TieredTicketRepository rebuilt(std::make_unique<InMemoryTicketRepository>(), &archive);
+    Ticket next(0, 1, 3, omar);
+    rebuilt.save(next);
+    EXPECT_GT(next.getId(), dropped.getId()); // the highest archived id
+    EXPECT_EQ(rebuilt.getTicketById(departed.getId())->getSeat(), 2);
+    EXPECT_EQ(rebuilt.getTicketsByPassenger(sara.getId()).size(), 1u); // the index is rebuilt from the file
+    EXPECT_THROW(TieredTicketRepository(nullptr, &archive), std::invalid_argument);
+}
+
+TEST_F(TicketArchiveTest, StartupManagerArchivesThroughTheFacade) {
+    StartupManager manager;
+    manager.useTicketArchive(path);
+    RMSFacade *facade = manager.buildFacade();
+    int trainId = facade->addTrain("Archive Express", 5).getTrainId();
+    int ticketId = facade->bookTicket(trainId, "Omar")->getId();
+    facade->cancelTicket(ticketId);
+    size_t live = facade->listTickets().size();
+
+    EXPECT_EQ(manager.archiveTickets(), 1u);
+    EXPECT_EQ(facade->listTickets().size(), live - 1);
+    EXPECT_EQ(facade->getTicket(ticketId).getStatus(), cancelled);
+    EXPECT_TRUE(facade->bookTicket(trainId, "Omar").has_value()); // a cancelled ticket does not block
+    EXPECT_EQ(manager.getTicketArchive()->size(), 1u);
+
+    int omarId = facade->getTicket(ticketId).getPassenger().getId();
+    facade->updatePassenger(omarId, "Omar Ali");
+    EXPECT_EQ(facade->getTicket(ticketId).getPassenger().getName(), "Omar Ali"); // archived , renamed too
+
+    // a departed ticket moved to the archive can not be cancelled any more , and says so
+    int departedId = facade->bookTicket(trainId, "Sara", SeatRequest{}, "2020-01-01")->getId();
+    EXPECT_EQ(manager.archiveTickets(), 2u); // the renamed copy went live , it moves back too
+    EXPECT_THROW(facade->cancelTicket(departedId), std::logic_error);
+    EXPECT_EQ(facade->getTicket(departedId).getStatus(), booked);
+
+    StartupManager timed;
+    timed.useTicketArchive(path + ".timed", 5);
+    RMSFacade *timedFacade = timed.buildFacade();
+    int timedTrain = timedFacade->addTrain("Timer Express", 5).getTrainId();
+    int timedTicket = timedFacade->bookTicket(timedTrain, "Sara")->getId();
+    timedFacade->cancelTicket(timedTicket);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!timed.getTicketArchive()->find(timedTicket) && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_TRUE(timed.getTicketArchive()->find(timedTicket).has_value()); // archived by the timer
+    std::remove((path + ".timed").c_str());
+    EXPECT_THROW(StartupManager().useTicketArchive(path, -1), std::invalid_argument);
+
+    StartupManager plain;
+    plain.buildFacade();
+    EXPECT_THROW(plain.archiveTickets(), std::logic_error);
+    StartupManager shared;
+    shared.useSharedMemory("/rms_archive_test");
+    EXPECT_THROW(shared.useTicketArchive(path), std::logic_error);
+    StartupManager sqlite;
+    sqlite.useTicketArchive(path);
+    EXPECT_THROW(sqlite.useSqlite(path + ".db"), std::logic_error);
+    EXPECT_THROW(sqlite.useTicketArchive(""), std::invalid_argument);
+}
@@ -71,6 +71,19 @@ TEST_F(TicketServiceTest, BookTicket_DuplicateBooking) {
     EXPECT_THROW(ticketService->bookTicket(train.getTrainId(), passenger.getId()), std::runtime_error);
 }
 
+TEST_F(TicketServiceTest, BookTicket_AfterCancelling) {
+    Train train = trainService->createTrain("Express", 10);
+    Passenger passenger = passengerService->createPassenger("John");
+
+    auto first = ticketService->bookTicket(train.getTrainId(), passenger.getId());
+    ticketService->cancelTicket(first->getId());
+    auto second = ticketService->bookTicket(train.getTrainId(), passenger.getId()); // the cancelled one does not count
+    ASSERT_TRUE(second.has_value());
+    EXPECT_NE(second->getId(), first->getId());
+    // the index still answers with the cancelled ticket first , the booked one behind it blocks
+    EXPECT_THROW(ticketService->bookTicket(train.getTrainId(), passenger.getId()), std::runtime_error);
+}
+
 TEST_F(TicketServiceTest, BookTicket_FullTrainReturnsNullopt) {
     Train train = trainService->createTrain("Express", 2);
     Passenger p1 = passengerService->createPassenger("John");
@@ -84,6 +97,25 @@ TEST_F(TicketServiceTest, BookTicket_FullTrainReturnsNullopt) {
     EXPECT_FALSE(ticket.has_value());
 }
 
+TEST_F(TicketServiceTest, BookTicket_InRequestedClass) {
+    Train train = trainService->createTrain("Express", 10);
+    trainService->setCoachLayout(train.getTrainId(), {{"second", 6}, {"first", 4}});
+    Passenger passenger = passengerService->createPassenger("John");
+
+    auto ticket = ticketService->bookTicket(train.getTrainId(), passenger.getId(), {"first", 0});
+
+    ASSERT_TRUE(ticket.has_value());
+    EXPECT_EQ(ticket->getSeat(), 7);
+    EXPECT_EQ(trainService->getClassAvailability(train.getTrainId(), "first"), 3);
+    EXPECT_EQ(trainService->getClassAvailability(train.getTrainId(), "second"), 6);
+
+    // each departure counts its own seats , an untouched one has the whole class free
+    ASSERT_TRUE(ticketService->bookTicket(train.getTrainId(), passenger.getId(), {"first", 0}, 20261201).has_value());
+    EXPECT_EQ(trainService->getClassAvailability(train.getTrainId(), "first", 20261201), 3);
+    EXPECT_EQ(trainService->getClassAvailability(train.getTrainId(), "first", 20261202), 4);
+    EXPECT_EQ(trainService->getClassAvailability(train.getTrainId(), "first"), 3);
+}
+
 // ===================== Cancel Ticket Tests =====================
 
 TEST_F(TicketServiceTest, CancelTicket_Success) {
@@ -86,4 +86,22 @@ TEST_F(TicketRepositoryTest, GetAllTickets) {
 
     auto all = repo.getAllTickets();
     EXPECT_EQ(all.size(), 2);
-}
\ No newline at end of file
+}
+TEST_F(TicketRepositoryTest, GetTicketsByPassenger_FollowsEveryTrain) {
+    Passenger other(2, "Jane");
+    Ticket a(0, 1, 101, testPassenger), b(0, 2, 102, other), c(0, 3, 103, testPassenger);
+    repo.save(a);
+    repo.save(b);
+    repo.save(c);
+
+    auto mine = repo.getTicketsByPassenger(testPassenger.getId());
+    ASSERT_EQ(mine.size(), 2u);
+    EXPECT_EQ(mine[0].getId(), a.getId());
+    EXPECT_EQ(mine[1].getId(), c.getId());
+
+    c.setPassenger(other); // moved to another passenger , the index follows
+    repo.save(c);
+    repo.deleteTicket(a.getId());
+    EXPECT_TRUE(repo.getTicketsByPassenger(testPassenger.getId()).empty());
+    EXPECT_EQ(repo.getTicketsByPassenger(other.getId()).size(), 2u);
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "utils/WorkStealingPool.h"
+#include "structures/persistentMap.h"
+#include "Repo/Snapshot.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "Repo/InMemoryPassengerRepository.h"
+#include "Repo/RepositoryShards.h"
+#include "Repo/ShardedTicketRepository.h"
+#include "Services/TicketService.h"
+#include "StartupManager.h"
+
+class WorkStealingPoolTest : public ::testing::Test {
+protected:
+    WorkStealingPool pool{4};
+};
+
+// ===================== pool =====================
+
+TEST_F(WorkStealingPoolTest, ThreadCountDefaultsToHardware) {
+    WorkStealingPool defaulted;
+    EXPECT_GE(defaulted.getThreadCount(), 1);
+    EXPECT_EQ(pool.getThreadCount(), 4);
+    EXPECT_THROW(WorkStealingPool(-1), std::invalid_argument);
+}
+
+TEST_F(WorkStealingPoolTest, ParallelForVisitsEveryIndexOnce) {
+    const size_t n = 100000;
+    std::vector<std::atomic<int>> hits(n);
+    pool.parallelFor(0, n, 64, [&](size_t lo, size_t hi) {
+        EXPECT_LE(hi - lo, 64u);
+        for (size_t i = lo; i < hi; i++)
+            hits[i]++;
+    });
+    for (size_t i = 0; i < n; i++)
+        ASSERT_EQ(hits[i].load(), 1) << "index " << i;
+    EXPECT_GT(pool.getStats().executed, 0);
+}
+
+TEST_F(WorkStealingPoolTest, EmptyRangeRunsNothing) {
+    bool ran = false;
+    pool.parallelFor(5, 5, 1, [&](size_t, size_t) { ran = true; });
+    EXPECT_FALSE(ran);
+    EXPECT_EQ(pool.parallelReduce(0, 0, 8, 42, [](size_t, size_t) { return 1; },
+                                  [](int a, int b) { return a + b; }), 42);
+}
+
+TEST_F(WorkStealingPoolTest, ParallelReduceSumsAndKeepsBlockOrder) {
+    long long sum = pool.parallelReduce(0, 1000001, 1000, 0LL, [](size_t lo, size_t hi) {
+        long long s = 0;
+        for (size_t i = lo; i < hi; i++)
+            s += (long long)i;
+        return s;
+    }, [](long long a, long long b) { return a + b; });
+    EXPECT_EQ(sum, 1000000LL * 1000001LL / 2);
+
+    // non commutative combine : blocks are folded left to right
+    std::vector<int> order = pool.parallelReduce(0, 100, 10, std::vector<int>{}, [](size_t lo, size_t) {
+        return std::vector<int>{(int)lo};
+    }, [](std::vector<int> a, std::vector<int> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+    });
+    std::vector<int> expected;
+    for (int lo = 0; lo < 100; lo += 10)
+        expected.push_back(lo);
+    EXPECT_EQ(order, expected);
+}
+
+TEST_F(WorkStealingPoolTest, ExceptionIsRethrownAfterEveryPieceFinished) {
+    std::atomic<int> pieces{0}, finished{0};
+    EXPECT_THROW(pool.parallelFor(0, 1000, 10, [&](size_t lo, size_t hi) {
+        pieces++;
+        if (lo <= 500 && 500 < hi)
+            throw std::runtime_error("bad block");
+        finished++;
+    }), std::runtime_error);
+    EXPECT_GE(pieces.load(), 100);
+    EXPECT_EQ(finished.load(), pieces.load() - 1);
+}
+
+TEST_F(WorkStealingPoolTest, NestedParallelForDoesNotDeadlock) {
+    WorkStealingPool small(2);
+    std::atomic<long long> total{0};
+    small.parallelFor(0, 16, 1, [&](size_t, size_t) {
+        small.parallelFor(0, 1000, 10, [&](size_t lo, size_t hi) { total += (long long)(hi - lo); });
+    });
+    EXPECT_EQ(total.load(), 16000);
+}
+
+TEST_F(WorkStealingPoolTest, SubmittedTasksRunAndThrowsAreContained) {
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; i++)
+        pool.submit([&, i] {
+            ran++;
+            if (i % 10 == 0)
+                throw std::runtime_error("ignored");
+        });
+    while (ran.load() < 100)
+        std::this_thread::yield();
+    pool.parallelFor(0, 100, 1, [](size_t, size_t) {}); // pool still works
+    EXPECT_EQ(ran.load(), 100);
+}
+
+// ===================== parallel scans =====================
+
+TEST_F(WorkStealingPoolTest, PersistentMapAtWalksFromAnyPosition) {
+    PersistentMap<int, int> map;
+    for (int i = 0; i < 1000; i++)
+        map.insert(i * 3, i);
+    for (size_t pos : {0ul, 1ul, 499ul, 999ul}) {
+        auto it = map.at(pos);
+        ASSERT_FALSE(it.done());
+        EXPECT_EQ(it.key(), (int)pos * 3);
+        ++it;
+        EXPECT_EQ(it.done(), pos == 999);
+    }
+    EXPECT_TRUE(map.at(1000).done());
+}
+
+TEST_F(WorkStealingPoolTest, SnapshotReduceCoversEveryShardOnce) {
+    RepositoryShards shards(3);
+    ShardedTicketRepository repo(&shards);
+    Passenger passenger(1, "Omar");
+    long long expected = 0;
+    for (int i = 0; i < 5000; i++) {
+        Ticket t(0, i % 50 + 1, i % 7 + 1, passenger);
+        repo.save(t);
+        expected += t.getId();
+    }
+    Snapshot<Ticket> snapshot = repo.snapshot();
+    long long sum = snapshot.reduce(pool, 0LL, [](long long acc, const Ticket &t) { return acc + t.getId(); },
+                                    [](long long a, long long b) { return a + b; }, 100);
+    EXPECT_EQ(sum, expected);
+}
+
+// ===================== services =====================
+
+class WorkStealingServiceTest : public ::testing::Test {
+protected:
+    InMemoryTrainRepository trainRepo;
+    InMemoryTicketRepository ticketRepo;
+    InMemoryPassengerRepository passengerRepo;
+    TrainService trainService{&trainRepo};
+    PassengerService passengerService{&passengerRepo};
+    TicketService ticketService{&ticketRepo, &trainService, &passengerService};
+    WorkStealingPool pool{4};
+
+    void TearDown() override {
+        trainRepo.clear();
+        ticketRepo.clear();
+        passengerRepo.clear();
+    }
+};
+
+TEST_F(WorkStealingServiceTest, ParallelReportsMatchSequential) {
+    for (int t = 0; t < 20; t++)
+        trainService.createTrain("T" + std::to_string(t), 30);
+    for (int p = 0; p < 200; p++)
+        passengerService.createPassenger("P" + std::to_string(p));
+    for (int p = 1; p <= 200; p++)
+        ticketService.bookTicket(p % 20 + 1, p);
+    ticketService.cancelTicket(1);
+
+    TicketReport sequential = ticketService.getTicketReport();
+    auto occupancy = trainService.getOccupancyReport();
+    ticketService.setThreadPool(&pool);
+    trainService.setThreadPool(&pool);
+    TicketReport parallel = ticketService.getTicketReport();
+    auto parallelOccupancy = trainService.getOccupancyReport();
+
+    EXPECT_EQ(parallel.total, sequential.total);
+    EXPECT_EQ(parallel.booked, sequential.booked);
+    EXPECT_EQ(parallel.cancelled, 1);
+    EXPECT_EQ(parallel.trains, 20);
+    ASSERT_EQ(parallelOccupancy.size(), 20u);
+    for (size_t i = 0; i < occupancy.size(); i++) {
+        EXPECT_EQ(parallelOccupancy[i].trainId, (int)i + 1);
+        EXPECT_EQ(parallelOccupancy[i].allocatedSeats, occupancy[i].allocatedSeats);
+    }
+    EXPECT_EQ(parallelOccupancy[1].allocatedSeats, 9); // train 2 : passengers 1 , 21 , ... 181 , less cancelled ticket 1
+}
+
+TEST_F(WorkStealingServiceTest, BookBulkSpreadsTrainsAndKeepsRequestOrder) {
+    for (int t = 0; t < 8; t++)
+        trainService.createTrain("T" + std::to_string(t), 50);
+    for (int p = 0; p < 400; p++)
+        passengerService.createPassenger("P" + std::to_string(p));
+    ticketService.setThreadPool(&pool);
+
+    std::vector<BookingRequest> requests;
+    auto booking = [](int trainId, int passengerId) {
+        BookingRequest r;
+        r.trainId = trainId;
+        r.passengerId = passengerId;
+        return r;
+    };
+    for (int p = 1; p <= 400; p++)
+        requests.push_back(booking(p % 8 + 1, p));
+    requests.push_back(booking(99, 1)); // no such train
+    auto outcomes = ticketService.bookBulk(requests);
+
+    ASSERT_EQ(outcomes.size(), requests.size());
+    for (size_t i = 0; i + 1 < requests.size(); i++) {
+        ASSERT_TRUE(outcomes[i].ticket.has_value()) << "request " << i;
+        EXPECT_EQ(outcomes[i].ticket->getTrainId(), requests[i].trainId);
+        EXPECT_EQ(outcomes[i].ticket->getPassenger().getId(), requests[i].passengerId);
+    }
+    EXPECT_TRUE(outcomes.back().error);
+    for (int t = 1; t <= 8; t++)
+        EXPECT_EQ(trainService.getTrain(t).getSeatAllocator()->getAllocatedSeatCount(), 50);
+}
+
+TEST(WorkStealingStartupTest, StartupManagerSetsThreadCount) {
+    StartupManager manager;
+    manager.setWorkerThreads(3);
+    RMSFacade *facade = manager.buildFacade();
+    ASSERT_NE(manager.getWorkerPool(), nullptr);
+    EXPECT_EQ(manager.getWorkerPool()->getThreadCount(), 3);
+    EXPECT_EQ(facade->occupancyReport().size(), 5u);
+    EXPECT_EQ(facade->ticketReport().total, 11);
+    EXPECT_THROW(manager.setWorkerThreads(2), std::logic_error);
+    EXPECT_THROW(StartupManager().setWorkerThreads(-1), std::invalid_argument);
+}
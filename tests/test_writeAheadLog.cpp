@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Repo/WriteAheadLog.h"
+#include "Repo/DurableTicketRepository.h"
+#include "Repo/DurableTrainRepository.h"
+#include "Repo/InMemoryTicketRepository.h"
+#include "Repo/InMemoryTrainRepository.h"
+#include "StartupManager.h"
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        static int counter = 0;
+        path = "/tmp/rms_wal_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".log";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    std::vector<WalRecord> readBack() {
+        WriteAheadLog log(path);
+        std::vector<WalRecord> records;
+        log.replay([&](const WalRecord &record) { records.push_back(record); });
+        return records;
+    }
+
+    long long fileSize() {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return (long long)in.tellg();
+    }
+};
+
+TEST_F(WriteAheadLogTest, ReplaysRecordsInOrder) {
+    {
+        WriteAheadLog log(path);
+        EXPECT_EQ(log.replay([](const WalRecord &) { FAIL(); }), 0u);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, "first"));
+        log.commit(log.append(WalTable::Tickets, WalOp::Delete, "second"));
+        log.commit(log.append(WalTable::Passengers, WalOp::Clear, ""));
+        WalStats stats = log.getStats();
+        EXPECT_EQ(stats.records, 3);
+        EXPECT_GE(stats.syncs, 3); // Synced : every commit waited for its own fsync
+    }
+    auto records = readBack();
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].table, WalTable::Trains);
+    EXPECT_EQ(records[0].op, WalOp::Put);
+    EXPECT_EQ(records[0].body, "first");
+    EXPECT_EQ(records[1].table, WalTable::Tickets);
+    EXPECT_EQ(records[1].op, WalOp::Delete);
+    EXPECT_EQ(records[1].body, "second");
+    EXPECT_EQ(records[2].op, WalOp::Clear);
+    EXPECT_EQ(records[2].body, "");
+}
+
+TEST_F(WriteAheadLogTest, TornTailIsCutOnReplay) {
+    {
+        WriteAheadLog log(path);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, std::string(100, 'a')));
+        log.commit(log.append(WalTable::Trains, WalOp::Put, std::string(100, 'b')));
+    }
+    long long intact = fileSize();
+    // a crash in the middle of the next write : its frame is there , half of its payload is not
+    {
+        WriteAheadLog log(path);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, std::string(100, 'c')));
+    }
+    ASSERT_EQ(truncate(path.c_str(), intact + 40), 0);
+
+    {
+        WriteAheadLog log(path);
+        std::vector<std::string> bodies;
+        EXPECT_EQ(log.replay([&](const WalRecord &record) { bodies.push_back(record.body); }), 2u);
+        EXPECT_EQ(bodies.back(), std::string(100, 'b'));
+        EXPECT_EQ(fileSize(), intact);
+        log.commit(log.append(WalTable::Trains, WalOp::Put, "after"));
+    }
+    auto records = readBack();
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[2].body, "after");
+}
+
+TEST_F(WriteAheadLogTest, CorruptRecordStopsReplay) {
+    {
+        WriteAheadLog log(path);
+        log.append(WalTable::Trains, WalOp::Put, "good");
+        log.append(WalTable::Trains, WalOp::Put, "flipped");
+        log.sync();
+    }
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-3, std::ios::end);
+        file.put('X');
+    }
+    auto records = readBack();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].body, "good");
+}
+
+TEST_F(WriteAheadLogTest, RejectsForeignFilesAndBadOptions) {
+    {
+        std::ofstream out(path);
+        out << "not a log at all";
+    }
+    EXPECT_THROW(WriteAheadLog log(path), std::runtime_error);
+    WalOptions options;
+    options.flushIntervalMs = 0;
+    EXPECT_THROW(WriteAheadLog log("/tmp/unused.log", options), std::invalid_argument);
+    EXPECT_THROW(WriteAheadLog log("/nonexistent/dir/x.log"), std::runtime_error);
+}
+
+TEST_F(WriteAheadLogTest, ConcurrentCommitsShareSyncs) {
+    const int threads = 8, perThread = 50;
+    {
+        WriteAheadLog log(path);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < perThread; i++)
+                    log.commit(log.append(WalTable::Tickets, WalOp::Put, std::to_string(t * perThread + i)));
+            });
+        for (auto &worker : workers)
+            worker.join();
+        WalStats stats = log.getStats();
+        EXPECT_EQ(stats.records, threads * perThread);
+        EXPECT_LE(stats.syncs, stats.records);
+        EXPECT_LE(stats.writes, stats.records);
+    }
+    EXPECT_EQ(readBack().size(), (size_t)(threads * perThread));
+}
+
+TEST_F(WriteAheadLogTest, BufferedCommitsReachTheFileOnClose) {
+    WalOptions options;
+    options.durability = Durability::Buffered;
+    options.flushIntervalMs = 60000; // only the destructor flushes
+    {
+        WriteAheadLog log(path, options);
+        for (int i = 0; i < 100; i++)
+            log.commit(log.append(WalTable::Passengers, WalOp::Put, std::to_string(i)));
+        EXPECT_EQ(log.getStats().writes, 0); // nobody waited , nothing written yet
+    }
+    auto records = readBack();
+    ASSERT_EQ(records.size(), 100u);
+    EXPECT_EQ(records[99].body, "99");
+}
+
+TEST_F(WriteAheadLogTest, DurableRepositoryReplaysVersionsAndDeletes) {
+    long long version;
+    {
+        WriteAheadLog log(path);
+        DurableTrainRepository trains(std::make_unique<InMemoryTrainRepository>(), &log);
+        Train a(0, "A", 10), b(0, "B", 10);
+        trains.save(a);
+        trains.save(b);
+        a.setTrainName("A2");
+        ASSERT_TRUE(trains.compareAndSave(a));
+        Train stale = *trains.getTrainById(b.getTrainId());
+        trains.save(b);
+        EXPECT_FALSE(trains.compareAndSave(stale)); // not logged
+        EXPECT_TRUE(trains.deleteTrain(b.getTrainId()));
+        version = a.getVersion();
+    }
+    WriteAheadLog log(path);
+    DurableTrainRepository trains(std::make_unique<InMemoryTrainRepository>(), &log);
+    EXPECT_EQ(log.replay([&](const WalRecord &record) { trains.apply(record); }), 5u);
+    auto all = trains.getAllTrains();
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].getTrainName(), "A2");
+    EXPECT_EQ(all[0].getVersion(), version);
+}
+
+TEST_F(WriteAheadLogTest, FailedLogLeavesTheRepositoryAsItWas) {
+    WriteAheadLog log(path);
+    DurableTrainRepository trains(std::make_unique<InMemoryTrainRepository>(), &log);
+    DurableTicketRepository tickets(std::make_unique<InMemoryTicketRepository>(), &log);
+    Train a(0, "A", 10);
+    trains.save(a);
+    Ticket kept(0, 1, a.getTrainId(), Passenger(1, "omar"));
+    tickets.save(kept);
+
+    // the flusher treats a throwing shipper like a failed write : the log is dead from here on
+    log.setShipper([](const std::string &) { throw std::runtime_error("disk gone"); });
+
+    Train renamed = a;
+    renamed.setTrainName("A2");
+    EXPECT_THROW(trains.save(renamed), std::runtime_error); // the commit fails
+    EXPECT_EQ(renamed.getVersion(), a.getVersion());
+    EXPECT_EQ(trains.getTrainById(a.getTrainId())->getTrainName(), "A");
+
+    Train fresh(0, "B", 10);
+    EXPECT_THROW(trains.save(fresh), std::runtime_error); // the append fails
+    EXPECT_EQ(fresh.getTrainId(), 0);
+    EXPECT_EQ(trains.getAllTrains().size(), 1u);
+    EXPECT_FALSE(trains.compareAndSave(renamed)); // undoing moved the version on , reread
+    renamed = *trains.getTrainById(a.getTrainId());
+    renamed.setTrainName("A2");
+    EXPECT_THROW(trains.compareAndSave(renamed), std::runtime_error);
+    EXPECT_EQ(trains.getTrainById(a.getTrainId())->getTrainName(), "A");
+    EXPECT_THROW(trains.deleteTrain(a.getTrainId()), std::runtime_error);
+    EXPECT_TRUE(trains.getTrainById(a.getTrainId()).has_value());
+    EXPECT_THROW(trains.clear(), std::runtime_error);
+    EXPECT_EQ(trains.getAllTrains().size(), 1u);
+
+    vector<Ticket> batch;
+    batch.push_back(Ticket(0, 2, a.getTrainId(), Passenger(2, "ali")));
+    batch.push_back(kept);
+    batch[1].setSeat(3);
+    EXPECT_THROW(tickets.saveAll(batch), std::runtime_error);
+    EXPECT_EQ(batch[0].getId(), 0);
+    auto all = tickets.getAllTickets();
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].getSeat(), 1);
+    EXPECT_THROW(tickets.clear(), std::runtime_error);
+    EXPECT_EQ(tickets.getAllTickets().size(), 1u);
+}
+
+TEST_F(WriteAheadLogTest, StartupManagerRebuildsFromTheLog) {
+    int ticketId, trainId;
+    size_t tickets, passengers;
+    {
+        StartupManager manager;
+        manager.useWriteAheadLog(path);
+        RMSFacade *facade = manager.buildFacade(); // mock data goes into the empty log
+        trainId = facade->addTrain("Durable Express", 5).getTrainId();
+        ticketId = facade->bookTicket(trainId, "Omar")->getId();
+        facade->bookTicket(trainId, "Sara");
+        facade->cancelTicket(ticketId);
+        tickets = facade->listTickets().size();
+        passengers = facade->listPassengers().size();
+    }
+    StartupManager manager;
+    manager.useWriteAheadLog(path);
+    RMSFacade *facade = manager.buildFacade();
+    EXPECT_EQ(facade->listTrains().size(), 6u); // the mock data is not loaded twice
+    EXPECT_EQ(facade->listTickets().size(), tickets);
+    EXPECT_EQ(facade->listPassengers().size(), passengers);
+    EXPECT_EQ(facade->getTicket(ticketId).getStatus(), cancelled);
+    EXPECT_EQ(facade->getTrain(trainId).getSeatAllocator()->getAllocatedSeatCount(), 1);
+    // the ids carry on from the log
+    EXPECT_GT(facade->addTrain("Next", 5).getTrainId(), trainId);
+    EXPECT_GT(facade->bookTicket(trainId, "Ali")->getId(), ticketId);
+}
+
+TEST_F(WriteAheadLogTest, StartupManagerOptionsAreChecked) {
+    StartupManager manager;
+    EXPECT_THROW(manager.useWriteAheadLog(""), std::invalid_argument);
+    manager.useWriteAheadLog(path);
+    EXPECT_THROW(manager.useSharedMemory("/rms_unused"), std::logic_error);
+    manager.buildFacade();
+    EXPECT_NE(manager.getWriteAheadLog(), nullptr);
+    EXPECT_THROW(manager.useWriteAheadLog(path), std::logic_error);
+}